@@ -30,6 +30,40 @@ endif()
 
 find_package( OpenSSL 1.1.1 REQUIRED )
 
+#-------------------------------------------------------------------------------
+# With kernel TLS, OpenSSL flags the writes of TLS control records to the
+# socket BIO with two controls that are not in its public API. Their numbers
+# are reserved in a comment of the public header; XrdHttp needs them to send
+# those records through the link. Without them it encrypts in user space.
+#-------------------------------------------------------------------------------
+set(CMAKE_REQUIRED_INCLUDES ${OPENSSL_INCLUDE_DIR})
+check_cxx_source_compiles(
+"
+  #include <openssl/ssl.h>
+  #if !defined(SSL_OP_ENABLE_KTLS) || defined(OPENSSL_NO_KTLS)
+  #error OpenSSL built without kernel TLS
+  #endif
+  int main() { return (int)sizeof( BIO_get_ktls_send( (BIO *)0 ) ) - 1; }
+"
+  HAVE_OPENSSL_KTLS )
+unset(CMAKE_REQUIRED_INCLUDES)
+
+if( HAVE_OPENSSL_KTLS )
+  file( STRINGS ${OPENSSL_INCLUDE_DIR}/openssl/bio.h KTLS_CTRL_MSG_SET
+        REGEX "define[ \t]+BIO_CTRL_SET_KTLS(_TX)?_SEND_CTRL_MSG[ \t]+[0-9]+" )
+  file( STRINGS ${OPENSSL_INCLUDE_DIR}/openssl/bio.h KTLS_CTRL_MSG_CLR
+        REGEX "define[ \t]+BIO_CTRL_CLEAR_KTLS(_TX)?_CTRL_MSG[ \t]+[0-9]+" )
+  if( KTLS_CTRL_MSG_SET AND KTLS_CTRL_MSG_CLR )
+    string( REGEX REPLACE ".*[ \t]([0-9]+).*" "\\1" KTLS_CTRL_MSG_SET "${KTLS_CTRL_MSG_SET}" )
+    string( REGEX REPLACE ".*[ \t]([0-9]+).*" "\\1" KTLS_CTRL_MSG_CLR "${KTLS_CTRL_MSG_CLR}" )
+    message( STATUS "OpenSSL kernel TLS control record controls: ${KTLS_CTRL_MSG_SET} ${KTLS_CTRL_MSG_CLR}" )
+    add_definitions( -DXRDHTTP_KTLS_CTRL_MSG_SET=${KTLS_CTRL_MSG_SET}
+                     -DXRDHTTP_KTLS_CTRL_MSG_CLR=${KTLS_CTRL_MSG_CLR} )
+  else()
+    message( STATUS "OpenSSL kernel TLS control record controls not found, XrdHttp will not use kernel TLS" )
+  endif()
+endif()
+
 if( ENABLE_KRB5 )
   if( FORCE_ENABLED )
     find_package( Kerberos5 REQUIRED )
@@ -55,6 +89,27 @@ if( ENABLE_XRDEC )
   endif()
   if( ISAL_FOUND )
     set(BUILD_XRDEC TRUE)
+
+    #---------------------------------------------------------------------------
+    # XrdEc writes the parity straight into the stripe buffers, rather than
+    # into scratch buffers that are then copied, with isa-l 2.30 or newer
+    #---------------------------------------------------------------------------
+    set(CMAKE_REQUIRED_INCLUDES ${ISAL_INCLUDE_DIRS})
+    check_cxx_source_compiles(
+"
+  #include <isa-l.h>
+
+  #if !defined(ISAL_MAJOR_VERSION) || !defined(ISAL_MINOR_VERSION)
+  #error isa-l version unknown
+  #elif ISAL_MAJOR_VERSION < 2 || ( ISAL_MAJOR_VERSION == 2 && ISAL_MINOR_VERSION < 30 )
+  #error isa-l older than 2.30
+  #endif
+
+  int main() { return 0; }
+"
+      HAVE_XRDEC_INPLACE_ENCODE )
+    unset(CMAKE_REQUIRED_INCLUDES)
+    compiler_define_if_found( HAVE_XRDEC_INPLACE_ENCODE XRDEC_INPLACE_ENCODE )
   else()
     set(BUILD_XRDEC FALSE)
   endif()
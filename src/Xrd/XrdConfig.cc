@@ -1745,7 +1745,7 @@ int XrdConfig::xmaxfd(XrdSysError *eDest, XrdOucStream &Config)
                                          [kaparms parms] [cache <ct>] [[no]dnr]
                                          [routes <rtype> [use <ifn1>,<ifn2>]]
                                          [[no]rpipa] [[no]dyndns]
-                                         [udprefresh <sec>]
+                                         [udprefresh <sec>] [[no]edgepoll]
 
              <rtype>: split | common | local
 
@@ -1760,6 +1760,8 @@ int XrdConfig::xmaxfd(XrdSysError *eDest, XrdOucStream &Config)
              [no]dyndns This network does [not] use a dynamic DNS.
              udprefresh Refreshes udp sendto addresses should they change
                         This only works for connected udp sockets.
+             [no]edgepoll do [not] use edge-triggered polling, avoiding a
+                        system call to re-arm a link after each request.
 
    Output: 0 upon success or !0 upon failure.
 */
@@ -1769,6 +1771,7 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
     char *val;
     int  i, n, V_keep = -1, V_nodnr = 0, V_istls = 0, V_blen = -1, V_ct = -1;
     int   V_assumev4 = -1, v_rpip = -1, V_dyndns = -1, V_udpref = -1;
+    int   V_edge = -1;
     long long llp;
     struct netopts {const char *opname; int hasarg; int opval;
                            int *oploc;  const char *etxt;}
@@ -1783,6 +1786,8 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
         {"dnr",        0, 0, &V_nodnr,  "option"},
         {"nodnr",      0, 1, &V_nodnr,  "option"},
         {"dyndns",     0, 1, &V_dyndns, "option"},
+        {"edgepoll",   0, 1, &V_edge,   "option"},
+        {"noedgepoll", 0, 0, &V_edge,   "option"},
         {"nodyndns",   0, 0, &V_dyndns, "option"},
         {"routes",     3, 1, 0,         "routes"},
         {"rpipa",      0, 1, &v_rpip,   "rpipa"},
@@ -1870,6 +1875,8 @@ int XrdConfig::xnet(XrdSysError *eDest, XrdOucStream &Config)
 
      if (V_udpref >= 0)
          XrdNetSocketCFG::udpRefr = (V_udpref < 1800 ? 1800 : V_udpref);
+
+     if (V_edge >= 0) XrdPoll::EdgeTrig = (V_edge != 0);
      return 0;
 }
 
@@ -2242,6 +2249,7 @@ int XrdConfig::xrep(XrdSysError *eDest, XrdOucStream &Config)
 
    Purpose:  To parse directive: sched [mint <mint>] [maxt <maxt>] [avlt <at>]
                                        [idle <idle>] [stksz <qnt>] [core <cv>]
+                                       [queues {<nq> | cpu}]
 
              <mint>   is the minimum number of threads that we need. Once
                       this number of threads is created, it does not decrease.
@@ -2258,6 +2266,10 @@ int XrdConfig::xrep(XrdSysError *eDest, XrdOucStream &Config)
              <idle>   The time (in time spec) between checks for underused
                       threads. Those found will be terminated. Default is 780.
              <qnt>    The thread stack size in bytes or K, M, or G.
+             <nq>     The number of run queues. Each worker is assigned to a
+                      queue and steals work from other queues when its own
+                      queue is empty. Specifying cpu uses one queue per
+                      online cpu. The default is 1 (i.e. a single queue).
 
    Output: 0 upon success or 1 upon failure.
 */
@@ -2267,7 +2279,7 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
     char *val;
     long long lpp;
     int  i, ppp = 0;
-    int  V_mint = -1, V_maxt = -1, V_idle = -1, V_avlt = -1;
+    int  V_mint = -1, V_maxt = -1, V_idle = -1, V_avlt = -1, V_rque = -1;
     struct schedopts {const char *opname; int minv; int *oploc;
                       const char *opmsg;} scopts[] =
        {
@@ -2276,7 +2288,8 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
         {"maxt",       1, &V_maxt, "sched maxt"},
         {"avlt",       1, &V_avlt, "sched avlt"},
         {"core",       1,       0, "sched core"},
-        {"idle",       0, &V_idle, "sched idle"}
+        {"idle",       0, &V_idle, "sched idle"},
+        {"queues",     1, &V_rque, "sched queues"}
        };
     int numopts = sizeof(scopts)/sizeof(struct schedopts);
 
@@ -2309,6 +2322,15 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
                             XrdSysThread::setStackSize((size_t)lpp);
                             break;
                            }
+                   else if (*scopts[i].opname == 'q')
+                           {if (!strcmp("cpu", val))
+                               {if ((ppp = sysconf(_SC_NPROCESSORS_ONLN)) < 1)
+                                   ppp = 1;
+                               }
+                               else if (XrdOuca2x::a2i(*eDest, scopts[i].opmsg,
+                                                val, &ppp, scopts[i].minv,
+                                                1024)) return 1;
+                           }
                    else if (XrdOuca2x::a2i(*eDest, scopts[i].opmsg, val,
                                      &ppp,scopts[i].minv)) return 1;
                    *scopts[i].oploc = ppp;
@@ -2335,6 +2357,7 @@ int XrdConfig::xsched(XrdSysError *eDest, XrdOucStream &Config)
 // Establish scheduler options
 //
    Sched.setParms(V_mint, V_maxt, V_avlt, V_idle);
+   if (V_rque > 0) Sched.setQueues(V_rque);
    return 0;
 }
 
@@ -2440,6 +2463,8 @@ int XrdConfig::xtcpmon(XrdSysError *eDest, XrdOucStream &Config)
              <opts>   options:
                       [no]detail       do [not] print TLS library msgs
                       hsto <sec>       handshake timeout (default 10).
+                      [no]ktls         do [not] let the kernel encrypt sent
+                                       data so sendfile works with TLS.
 
    Output: 0 upon success or 1 upon failure.
 */
@@ -2469,6 +2494,8 @@ int XrdConfig::xtls(XrdSysError *eDest, XrdOucStream &Config)
 
 do {     if (!strcmp(val,   "detail")) SSLmsgs = true;
     else if (!strcmp(val, "nodetail")) SSLmsgs = false;
+    else if (!strcmp(val,   "ktls"))   tlsOpts |=  XrdTlsContext::ktlsON;
+    else if (!strcmp(val, "noktls"))   tlsOpts &= ~XrdTlsContext::ktlsON;
     else if (!strcmp(val, "hsto" ))
             {if (!(val = Config.GetWord()))
                 {eDest->Emsg("Config", "tls hsto value not specified");
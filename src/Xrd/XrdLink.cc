@@ -233,6 +233,12 @@ XrdTlsPeerCerts *XrdLink::getPeerCerts()
 
 XrdProtocol *XrdLink::getProtocol() {return linkXQ.getProtocol();}
   
+/******************************************************************************/
+/*                               h a s K T L S                                */
+/******************************************************************************/
+
+bool XrdLink::hasKTLS() {return isTLS && linkXQ.kTLS();}
+  
 /******************************************************************************/
 /*                                  H o l d                                   */
 /******************************************************************************/
@@ -365,6 +371,15 @@ int XrdLink::Send(const sfVec *sfP, int sfN)
    else       return linkXQ.Send    (sfP, sfN);
 }
 
+/******************************************************************************/
+
+int XrdLink::Send(const char *Buff, int Blen,
+                  int (*sendFn)(void *sendArg, const char *Buff, int Blen),
+                  void *sendArg)
+{
+   return linkXQ.Send(Buff, Blen, sendFn, sendArg);
+}
+
 /******************************************************************************/
 /*                             S e r i a l i z e                              */
 /******************************************************************************/
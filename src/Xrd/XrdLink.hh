@@ -391,6 +391,27 @@ typedef XrdOucSFVec sfVec;
 
 int             Send(const sfVec *sdP, int sdn); // Iff sfOK is true
 
+//-----------------------------------------------------------------------------
+//! Send data on a link with a caller supplied function. The function is
+//! called with the link's write lock held, so the data is serialized and
+//! counted like any other data sent on the link. This is meant for data that
+//! must be written by other means, e.g. the TLS control records that OpenSSL
+//! writes itself when the kernel encrypts (kTLS). It fails with EBUSY when
+//! earlier data is still queued for a nonblocking link.
+//!
+//! @param  buff    pointer to buffer to send.
+//! @param  blen    length of buffer.
+//! @param  sendFn  the function that writes the buffer. It returns the
+//!                 number of bytes written or a value <= 0 upon failure.
+//! @param  sendArg the first argument passed to sendFn.
+//!
+//! @return the value returned by sendFn or -1 if it could not be called.
+//-----------------------------------------------------------------------------
+
+int             Send(const char *buff, int blen,
+                     int (*sendFn)(void *sendArg, const char *buff, int blen),
+                     void *sendArg);
+
 //-----------------------------------------------------------------------------
 //! Wait for all outstanding requests to be completed on the link.
 //-----------------------------------------------------------------------------
@@ -562,6 +583,16 @@ bool            hasBridge() const {return isBridged;}
 
 bool            hasTLS() const {return isTLS;}
 
+//-----------------------------------------------------------------------------
+//! Determine if the kernel encrypts data sent on this TLS link (kTLS). When
+//! true, Send(sfVec) transmits file data without copying it to user space.
+//!
+//! @return true    this link uses TLS and kernel TLS is active for sending.
+//! @return false   this link does not use TLS or encrypts in user space.
+//-----------------------------------------------------------------------------
+
+bool            hasKTLS();
+
 //-----------------------------------------------------------------------------
 //! Return TLS protocol version being used.
 //!
@@ -817,6 +817,31 @@ do{retc = sendfilev(LinkInfo.FD, vecSFP, sfN, &xframt);
 #endif
 }
 
+/******************************************************************************/
+
+int XrdLinkXeq::Send(const char *Buff, int Blen,
+                     int (*sendFn)(void *sendArg, const char *Buff, int Blen),
+                     void *sendArg)
+{
+   int retc;
+
+// Get a lock. Data queued for a nonblocking link must go out first.
+//
+   wrMutex.Lock();
+   if (sendQ && sendQ->Backlog())
+      {wrMutex.UnLock();
+       errno = EBUSY;
+       return -1;
+      }
+
+// Have the caller write the data and count what was written
+//
+   isIdle = 0;
+   if ((retc = sendFn(sendArg, Buff, Blen)) > 0) AtomicAdd(BytesOut, retc);
+   wrMutex.UnLock();
+   return retc;
+}
+
 /******************************************************************************/
 /* Protected:                   s e n d D a t a                               */
 /******************************************************************************/
@@ -1399,10 +1424,16 @@ int XrdLinkXeq::TLS_Send(const sfVec *sfP, int sfN)
    ssize_t totamt = 0;
    char myBuff[65536];
 
+   isIdle = 0;
+
+// When the kernel does the encryption (kTLS) the file data can be sent as is.
+//
+   if (tlsIO.KTLSSend()) return TLS_SendFile(sfP, sfN);
+
 // Convert the sendfile to a regular send. The conversion is not particularly
-// fast and caller are advised to avoid using sendfile on TLS connections.
+// fast and caller are advised to avoid using sendfile on TLS connections
+// unless kernel TLS is in use.
 //
-   isIdle = 0;
    for (int i = 0; i < sfN; sfP++, i++)
        {if (!(bytes = sfP->sendsz)) continue;
         totamt += bytes;
@@ -1428,6 +1459,44 @@ int XrdLinkXeq::TLS_Send(const sfVec *sfP, int sfN)
    return totamt;
 }
 
+/******************************************************************************/
+/* Protected:               T L S _ S e n d F i l e                           */
+/******************************************************************************/
+
+int XrdLinkXeq::TLS_SendFile(const sfVec *sfP, int sfN)
+{
+   XrdTls::RC retc;
+   off_t offset;
+   ssize_t totamt = 0;
+   int bytes, byteswritten;
+
+// Send each segment; memory segments go through the TLS socket as usual
+// and file segments are handed to the kernel which encrypts them in place.
+// The caller must hold the write mutex.
+//
+   for (int i = 0; i < sfN; sfP++, i++)
+       {if (!(bytes = sfP->sendsz)) continue;
+        if (sfP->fdnum < 0)
+           {if (!TLS_Write(sfP->buffer, bytes)) return -1;
+            totamt += bytes;
+            continue;
+           }
+        offset = sfP->offset;
+        while(bytes > 0)
+             {retc = tlsIO.SendFile(sfP->fdnum, offset, bytes, byteswritten);
+              if (retc != XrdTls::TLS_AOK) return TLS_Error("sendfile to", retc);
+              if (!byteswritten) return SFError(EPIPE);
+              offset += byteswritten; bytes -= byteswritten;
+              totamt += byteswritten;
+             }
+       }
+
+// We are done
+//
+   AtomicAdd(BytesOut, totamt);
+   return totamt;
+}
+
 /******************************************************************************/
 /* Protected:                  T L S _ W r i t e                              */
 /******************************************************************************/
@@ -1453,6 +1522,15 @@ bool XrdLinkXeq::TLS_Write(const char *Buff, int Blen)
    return true;
 }
 
+/******************************************************************************/
+/*                                 k T L S                                    */
+/******************************************************************************/
+
+bool XrdLinkXeq::kTLS()
+{
+   return tlsIO.KTLSSend();
+}
+
 /******************************************************************************/
 /*                                v e r T L S                                 */
 /******************************************************************************/
@@ -101,6 +101,9 @@ int           Send(const char *buff, int blen);
 int           Send(const struct iovec *iov, int iocnt, int bytes=0);
 
 int           Send(const sfVec *sdP, int sdn); // Iff sfOK > 0
+int           Send(const char *buff, int blen,
+                   int (*sendFn)(void *sendArg, const char *buff, int blen),
+                   void *sendArg);
 
 void          setID(const char *userid, int procid);
 
@@ -138,6 +141,8 @@ int           TLS_Send(const sfVec *sfP, int sfN);
 
 const char   *verTLS();
 
+bool          kTLS();
+
 bool          RegisterCloseRequestCb(XrdProtocol *pp, bool (*cb)(void*),
                                      void* cbarg);
 
@@ -155,6 +160,7 @@ int    sendData(const char *Buff, int Blen);
 int    SendIOV(const struct iovec *iov, int iocnt, int bytes);
 int    SFError(int rc);
 int    TLS_Error(const char *act, XrdTls::RC rc);
+int    TLS_SendFile(const sfVec *sfP, int sfN);
 bool   TLS_Write(const char *Buff, int Blen);
 
 static const char   *TraceID;
@@ -80,6 +80,8 @@ int           Stats(char *buff, int blen, int do_sync=0) {return 0;}
 
        XrdSysMutex  XrdPoll::doingAttach;
 
+       bool         XrdPoll::EdgeTrig = false;
+
        const char *XrdPoll::TraceID = "Poll";
 
 namespace XrdGlobal
@@ -86,6 +86,11 @@ static  int   Stats(char *buff, int blen, int do_sync=0);
 //
 static     XrdPoll   *Pollers[XRD_NUMPOLLERS];
 
+// Use edge-triggered dispatch when the implementation supports it. This must
+// be set before Setup() is called.
+//
+static     bool       EdgeTrig;
+
            XrdPoll();
 virtual   ~XrdPoll() {}
 
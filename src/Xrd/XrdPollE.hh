@@ -50,7 +50,7 @@ public:
             XrdPollE(struct epoll_event *ptab, int numfd, int pfd, int wfd)
                     : WaitFdSem(0), WaitFdSem2(0)
                       {PollTab = ptab; PollMax = numfd; PollDfd = pfd;
-                       WaitFd = wfd;
+                       WaitFd = wfd; edgeMode = EdgeTrig;
                       }
 
            ~XrdPollE();
@@ -62,6 +62,8 @@ const  char *x2Text(unsigned int evf, char *buff);
 
 private:
 int  AddWaitFd();
+int  EnableET(XrdPollInfo &pInfo);
+bool etClaim(XrdPollInfo &pInfo);
 void HandleWaitFd(const unsigned int events);
 void remFD(XrdPollInfo &pInfo, unsigned int events);
 void Wait4Poller();
@@ -74,10 +76,19 @@ void Wait4Poller();
    static const int ePollEvents = EPOLLIN  | EPOLLHUP | EPOLLPRI | EPOLLERR |
                                   EPOLLRDHUP | ePollOneShot;
 
+// In edge-triggered mode a link stays in the poll set for its lifetime and
+// enabling or disabling it only changes its etState, which holds these bits.
+//
+   static const int ePollEdge   = EPOLLIN  | EPOLLHUP | EPOLLPRI | EPOLLERR |
+                                  EPOLLRDHUP | EPOLLET;
+   static const char etEnabled  = 0x01;  // Link may be dispatched
+   static const char etPending  = 0x02;  // Event arrived while disabled
+
 struct epoll_event *PollTab;
        int          PollDfd;
        int          PollMax;
        int          WaitFd;
+       bool         edgeMode;
 // The two semaphores are used by Wait4Poller/HandleWaitFd to ensure that
 // epoll_wait has completed at least one loop. This is used to protect a
 // Link's XrdPollInfo from potentially being referenced after link reset.
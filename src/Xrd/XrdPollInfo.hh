@@ -44,12 +44,13 @@ XrdPoll       *Poller;      // -> Poller object associated with this object
 int            FD;          // Associated target file descriptor number
 bool           inQ;         // True -> in a PollPoll event queue
 bool           isEnabled;   // True -> interrupts are enabled
-char           rsv[2];      // Reserved for future flags
+char           etState;     // Edge-triggered state, used only by PollE
+char           rsv[1];      // Reserved for future flags
 
 void           Zorch() {Next      = 0;     PollEnt  = 0;
                         Poller    = 0;     FD       = -1;
                         isEnabled = false; inQ      = false;
-                        rsv[0]    = 0;     rsv[1]   = 0;
+                        etState   = 0;     rsv[0]   = 0;
                        }
 
                XrdPollInfo(XrdLink &lnk) : Link(lnk) {Zorch();}
@@ -27,10 +27,12 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <atomic>
 #include <cerrno>
 #include <fcntl.h>
 #include <signal.h>
 #include <cstdio>
+#include <cstdlib>
 #include <sys/resource.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -42,6 +44,7 @@
 #include "Xrd/XrdJob.hh"
 #include "Xrd/XrdScheduler.hh"
 #include "XrdOuc/XrdOucTrace.hh"    // For ABI compatibility only!
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysLogger.hh"
 
@@ -54,6 +57,12 @@
 
        const char   *XrdScheduler::TraceID = "Sched";
 
+// Each worker thread remembers the run queue it was assigned to so that jobs
+// it schedules stay local and so it knows where to look first for work.
+//
+static thread_local XrdScheduler *rqOwner = 0;
+static thread_local int           rqHome  = 0;
+
 /******************************************************************************/
 /*                         L o c a l   C l a s s e s                          */
 /******************************************************************************/
@@ -67,6 +76,44 @@ class XrdSchedulerPID
                         {next = prev; pid = newpid;}
      ~XrdSchedulerPID() {}
      };
+
+// A run queue is a simple job list with its own lock. Queues are cache line
+// aligned so that workers hammering different queues do not share lines.
+//
+class alignas(64) XrdSchedulerRQ
+     {public:
+
+      void    Add(int num, XrdJob *jfirst, XrdJob *jlast)
+                 {jlast->NextJob = 0;
+                  qMutex.Lock();
+                  if (First) Last->NextJob = jfirst;
+                     else    First         = jfirst;
+                  Last = jlast;
+                  Depth += num;
+                  if (Depth > maxDepth) maxDepth = Depth;
+                  qMutex.UnLock();
+                 }
+
+      XrdJob *Get()
+                 {XrdJob *jp;
+                  qMutex.Lock();
+                  if ((jp = First))
+                     {if (!(First = jp->NextJob)) Last = 0;
+                      Depth--;
+                     }
+                  qMutex.UnLock();
+                  return jp;
+                 }
+
+      XrdSysMutex  qMutex;
+      XrdJob      *First;
+      XrdJob      *Last;
+      int          Depth;
+      int          maxDepth;
+
+      XrdSchedulerRQ() : First(0), Last(0), Depth(0), maxDepth(0) {}
+     ~XrdSchedulerRQ() {}
+     };
   
 /******************************************************************************/
 /*            E x t e r n a l   T h r e a d   I n t e r f a c e s             */
@@ -331,11 +378,28 @@ void XrdScheduler::Run()
    int waiting;
    XrdJob *jp;
 
+// If we are using multiple run queues, assign this worker to one of them
+//
+   if (num_RunQ)
+      {int qnum;
+       AtomicFAdd(qnum, nxt_RunQ, 1);
+       rqOwner = this;
+       rqHome  = static_cast<unsigned int>(qnum) % num_RunQ;
+      }
+
 // Wait for work then do it (an endless task for a worker thread)
 //
    do {do {DispatchMutex.Lock();          idl_Workers++;DispatchMutex.UnLock();
            WorkAvail.Wait();
            DispatchMutex.Lock();waiting = --idl_Workers;DispatchMutex.UnLock();
+           if (num_RunQ)
+              {if (!(jp = runqJob(rqHome)))
+                  {SchedMutex.Lock();
+                   if (layOff(waiting)) return;
+                   SchedMutex.UnLock();
+                  }
+               continue;
+              }
            SchedMutex.Lock();
            if ((jp = WorkFirst))
               {if (!(WorkFirst = jp->NextJob)) WorkLast = 0;
@@ -343,15 +407,7 @@ void XrdScheduler::Run()
                   else XrdLog->Emsg("Scheduler","Job queue count underflow!");
               } else {
                num_JobsinQ = 0;
-               if (num_Layoffs > 0)
-                  {num_Layoffs--;
-                   if (waiting)
-                      {num_TDestroy++; num_Workers--;
-                       TRACE(SCHED, "terminating thread; workers=" <<num_Workers);
-                       SchedMutex.UnLock();
-                       return;
-                      }
-                  }
+               if (layOff(waiting)) return;
               }
            SchedMutex.UnLock();
           } while(!jp);
@@ -372,6 +428,10 @@ void XrdScheduler::Run()
   
 void XrdScheduler::Schedule(XrdJob *jp)
 {
+// When we have multiple run queues we avoid the scheduler lock altogether
+//
+   if (num_RunQ) {Schedule(1, jp, jp); return;}
+
 // Lock down our data area
 //
    SchedMutex.Lock();
@@ -404,6 +464,26 @@ void XrdScheduler::Schedule(XrdJob *jp)
 void XrdScheduler::Schedule(int numjobs, XrdJob *jfirst, XrdJob *jlast)
 {
 
+// When we have multiple run queues place the jobs on the queue of the calling
+// worker, if any, or spread them round-robin. The job count must be updated
+// before we post the semaphore as workers use it to decide whether to rescan.
+//
+   if (num_RunQ)
+      {int inQ;
+       RunQ[runqPick()].Add(numjobs, jfirst, jlast);
+       AtomicAdd(num_Jobs, numjobs);
+       AtomicFAdd(inQ, num_JobsinQ, numjobs);
+       inQ += numjobs;
+       // No lock protects the high water mark here, so raise it atomically
+       {std::atomic_ref<int> maxQ(max_QLength);
+        int mxQ = maxQ.load(std::memory_order_relaxed);
+        while(inQ > mxQ
+          && !maxQ.compare_exchange_weak(mxQ, inQ, std::memory_order_relaxed)) {}
+       }
+       while(numjobs--) WorkAvail.Post();
+       return;
+      }
+
 // Lock down our data area
 //
    SchedMutex.Lock();
@@ -541,6 +621,36 @@ void XrdScheduler::setNproc(const bool limlower)
 #endif
 }
 
+/******************************************************************************/
+/*                             s e t Q u e u e s                              */
+/******************************************************************************/
+
+void XrdScheduler::setQueues(int numq)
+{
+   XrdJob *jp;
+
+// Multiple run queues can only be established once and before any workers
+// have been started. One queue is the same as the classic shared queue.
+//
+   SchedMutex.Lock();
+   if (num_RunQ || num_Workers || numq < 2)
+      {SchedMutex.UnLock();
+       return;
+      }
+
+// Allocate the queues and move over anything that may have been scheduled.
+//
+   RunQ = new XrdSchedulerRQ[numq];
+   if ((jp = WorkFirst))
+      {RunQ[0].Add(num_JobsinQ, jp, WorkLast);
+       WorkFirst = WorkLast = 0;
+      }
+   num_RunQ = numq;
+   SchedMutex.UnLock();
+
+   TRACE(SCHED, "Using " <<numq <<" run queues");
+}
+
 /******************************************************************************/
 /*                              s e t P a r m s                               */
 /******************************************************************************/
@@ -628,16 +738,22 @@ void XrdScheduler::Start() // Serialized one time call!
 int XrdScheduler::Stats(char *buff, int blen, int do_sync)
 {
     int cnt_Jobs, cnt_JobsinQ, xam_QLength, cnt_Workers, cnt_idl;
-    int cnt_TCreate, cnt_TDestroy, cnt_Limited;
+    int cnt_TCreate, cnt_TDestroy, cnt_Limited, cnt_Steals, cnt_Depth;
     static const char statfmt[] = "<stats id=\"sched\"><jobs>%d</jobs>"
                 "<inq>%d</inq><maxinq>%d</maxinq>"
                 "<threads>%d</threads><idle>%d</idle>"
                 "<tcr>%d</tcr><tde>%d</tde>"
                 "<tlimr>%d</tlimr></stats>";
+    static const char rqsfmt[]  = "<stats id=\"sched\"><jobs>%d</jobs>"
+                "<inq>%d</inq><maxinq>%d</maxinq>"
+                "<threads>%d</threads><idle>%d</idle>"
+                "<tcr>%d</tcr><tde>%d</tde>"
+                "<tlimr>%d</tlimr><runq>%d</runq><steals>%d</steals>"
+                "<maxqd>%d</maxqd></stats>";
 
 // If only length wanted, do so
 //
-   if (!buff) return sizeof(statfmt) + 16*8;
+   if (!buff) return sizeof(rqsfmt) + 16*11;
 
 // Get values protected by the Dispatch lock (avoid lock if no sync needed)
 //
@@ -651,17 +767,32 @@ int XrdScheduler::Stats(char *buff, int blen, int do_sync)
    cnt_Workers = num_Workers;
    cnt_Jobs    = num_Jobs;
    cnt_JobsinQ = num_JobsinQ;
-   xam_QLength = max_QLength;
+   xam_QLength = std::atomic_ref<int>(max_QLength).load(std::memory_order_relaxed);
    cnt_TCreate = num_TCreate;
    cnt_TDestroy= num_TDestroy;
    cnt_Limited = num_Limited;
    if (do_sync) SchedMutex.UnLock();
 
-// Format the stats and return them
+// Format the stats and return them if we have a single shared queue
 //
-   return snprintf(buff, blen, statfmt, cnt_Jobs, cnt_JobsinQ, xam_QLength,
+   if (!num_RunQ)
+      return snprintf(buff, blen, statfmt, cnt_Jobs, cnt_JobsinQ, xam_QLength,
+                      cnt_Workers, cnt_idl, cnt_TCreate, cnt_TDestroy,
+                      cnt_Limited);
+
+// Otherwise, add the run queue statistics. We report the deepest queue ever
+// seen as an indication of how well work is being spread over the queues.
+//
+   cnt_Steals = AtomicGet(num_Steals);
+   cnt_Depth  = 0;
+   for (int i = 0; i < num_RunQ; i++)
+       {if (do_sync) RunQ[i].qMutex.Lock();
+        if (RunQ[i].maxDepth > cnt_Depth) cnt_Depth = RunQ[i].maxDepth;
+        if (do_sync) RunQ[i].qMutex.UnLock();
+       }
+   return snprintf(buff, blen, rqsfmt, cnt_Jobs, cnt_JobsinQ, xam_QLength,
                    cnt_Workers, cnt_idl, cnt_TCreate, cnt_TDestroy,
-                   cnt_Limited);
+                   cnt_Limited, num_RunQ, cnt_Steals, cnt_Depth);
 }
 
 /******************************************************************************/
@@ -754,10 +885,78 @@ void XrdScheduler::Init(int minw, int maxw, int maxi)
    num_TDestroy=  0;
    num_Layoffs =  0;
    num_Limited =  0;
+   num_Steals  =  0;
    firstPID    =  0;
+   RunQ        =  0;
+   num_RunQ    =  0;
+   nxt_RunQ    =  0;
    WorkFirst = WorkLast = TimerQueue = 0;
 }
 
+/******************************************************************************/
+/*                                l a y O f f                                 */
+/******************************************************************************/
+
+// Called with SchedMutex held when a worker found no work. Returns true with
+// the mutex released if the calling worker must terminate.
+//
+bool XrdScheduler::layOff(int waiting)
+{
+   if (num_Layoffs > 0)
+      {num_Layoffs--;
+       if (waiting)
+          {num_TDestroy++; num_Workers--;
+           TRACE(SCHED, "terminating thread; workers=" <<num_Workers);
+           SchedMutex.UnLock();
+           return true;
+          }
+      }
+   return false;
+}
+
+/******************************************************************************/
+/*                               r u n q J o b                                */
+/******************************************************************************/
+
+// Obtain a job from the worker's own run queue or, failing that, steal one
+// from another queue. Since jobs are counted before the semaphore is posted,
+// a worker may miss a job that was added to a queue it already looked at. So,
+// we keep looking as long as jobs are queued and no layoff is pending.
+//
+XrdJob *XrdScheduler::runqJob(int qhome)
+{
+   XrdJob *jp;
+   int qnum;
+
+   do {for (int i = 0; i < num_RunQ; i++)
+           {qnum = (qhome + i) % num_RunQ;
+            if ((jp = RunQ[qnum].Get()))
+               {AtomicDec(num_JobsinQ);
+                if (i) AtomicInc(num_Steals);
+                return jp;
+               }
+           }
+      } while(AtomicGet(num_JobsinQ) > 0 && AtomicGet(num_Layoffs) <= 0);
+
+   return 0;
+}
+
+/******************************************************************************/
+/*                              r u n q P i c k                               */
+/******************************************************************************/
+
+// Workers schedule onto their own queue to keep follow-on work local while
+// all other threads (e.g. pollers) spread their jobs over all of the queues.
+//
+int XrdScheduler::runqPick()
+{
+   int qnum;
+
+   if (rqOwner == this) return rqHome;
+   AtomicFAdd(qnum, nxt_RunQ, 1);
+   return static_cast<unsigned int>(qnum) % num_RunQ;
+}
+
 /******************************************************************************/
 /*                             t r a c e E x i t                              */
 /******************************************************************************/
@@ -37,6 +37,7 @@
 
 class XrdOucTrace;
 class XrdSchedulerPID;
+class XrdSchedulerRQ;
 class XrdSysError;
 class XrdSysTrace;
 
@@ -68,6 +69,8 @@ void          Schedule(XrdJob *jp, time_t atime);
 
 void          setParms(int minw, int maxw, int avlt, int maxi, int once=0);
 
+void          setQueues(int numq);
+
 void          Start();
 
 int           Stats(char *buff, int blen, int do_sync=0);
@@ -83,6 +86,7 @@ int        num_TDestroy;// Number of threads destroyed
 int        num_Jobs;    // Number of jobs scheduled
 int        max_QLength; // Longest queue length we had
 int        num_Limited; // Number of times max was reached
+int        num_Steals;  // Number of jobs taken from another run queue
 
 // This is the preferred constructor
 //
@@ -123,6 +127,10 @@ XrdJob                *WorkLast;
 XrdSysSemaphore        WorkAvail;
 XrdSysMutex            SchedMutex; // Protects private area
 
+XrdSchedulerRQ        *RunQ;       // Per-worker run queues when not null
+int                    num_RunQ;   // Number of run queues
+int                    nxt_RunQ;   // Next queue for round-robin assignment
+
 XrdJob                *TimerQueue; // Pending work
 XrdSysCondVar          TimerRings;
 XrdSysMutex            TimerMutex; // Protects scheduler area
@@ -133,7 +141,10 @@ XrdSysMutex            ReaperMutex;
 void Boot(XrdSysError *eP, XrdSysTrace *tP, int minw, int maxw, int maxi);
 void hireWorker(int dotrace=1);
 void Init(int minw, int maxw, int maxi);
+bool layOff(int waiting);
 void Monitor();
+XrdJob *runqJob(int qhome);
+int  runqPick();
 void traceExit(pid_t pid, int status);
 static const char *TraceID;
 };
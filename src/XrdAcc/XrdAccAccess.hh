@@ -34,7 +34,7 @@
 #include "XrdAcc/XrdAccAuthorize.hh"
 #include "XrdAcc/XrdAccCapability.hh"
 #include "XrdSec/XrdSecEntity.hh"
-#include "XrdOuc/XrdOucHash.hh"
+#include "XrdOuc/XrdOucFlatHash.hh"
 #include "XrdSys/XrdSysXSLock.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 
@@ -83,14 +83,14 @@ struct XrdAccAccess_ID
        };
 
 struct XrdAccAccess_Tables
-       {XrdOucHash<XrdAccCapability> *G_Hash;  // Groups
-        XrdOucHash<XrdAccCapability> *H_Hash;  // Hosts
-        XrdOucHash<XrdAccCapability> *N_Hash;  // Netgroups
-        XrdOucHash<XrdAccCapability> *O_Hash;  // Organizations
-        XrdOucHash<XrdAccCapability> *R_Hash;  // Roles
-        XrdOucHash<XrdAccAccess_ID>  *S_Hash;  // Sets
-        XrdOucHash<XrdAccCapability> *T_Hash;  // Templates
-        XrdOucHash<XrdAccCapability> *U_Hash;  // Users
+       {XrdOucFlatHash<XrdAccCapability> *G_Hash;  // Groups
+        XrdOucFlatHash<XrdAccCapability> *H_Hash;  // Hosts
+        XrdOucFlatHash<XrdAccCapability> *N_Hash;  // Netgroups
+        XrdOucFlatHash<XrdAccCapability> *O_Hash;  // Organizations
+        XrdOucFlatHash<XrdAccCapability> *R_Hash;  // Roles
+        XrdOucFlatHash<XrdAccAccess_ID>  *S_Hash;  // Sets
+        XrdOucFlatHash<XrdAccCapability> *T_Hash;  // Templates
+        XrdOucFlatHash<XrdAccCapability> *U_Hash;  // Users
                   XrdAccCapName     *D_List;  // Domains
                   XrdAccCapName     *E_List;  // Domains (end of list)
                   XrdAccCapability  *X_List;  // Fungable capbailities
@@ -100,7 +100,7 @@ XrdAccGroups::XrdAccGroups()
 char *XrdAccGroups::AddName(const XrdAccGroupType gtype, const char *name)
 {
    char *np;
-   XrdOucHash<char> *hp;
+   XrdOucFlatHash<char> *hp;
 
 // Prepare to add a group name
 //
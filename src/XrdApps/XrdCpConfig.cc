@@ -107,6 +107,7 @@ struct option XrdCpConfig::opVec[] =         // For getopt_long()
       {OPT_TYPE "silent",         0, 0, XrdCpConfig::OpSilent},
       {OPT_TYPE "sources",        1, 0, XrdCpConfig::OpSources},
       {OPT_TYPE "streams",        1, 0, XrdCpConfig::OpStreams},
+      {OPT_TYPE "stripes",        1, 0, XrdCpConfig::OpStripes},
       {OPT_TYPE "tlsmetalink",    0, 0, XrdCpConfig::OpTlsMLF},
       {OPT_TYPE "tlsnodata",      0, 0, XrdCpConfig::OpTlsNoData},
       {OPT_TYPE "tpc",            1, 0, XrdCpConfig::OpTpc},
@@ -145,6 +146,7 @@ XrdCpConfig::XrdCpConfig(const char *pgm)
    Dlvl     = 0;
    nSrcs    = 1;
    nStrm    = 0;
+   nStripes = 1;
    Retry    =-1;
    RetryPolicy = "force";
    Verbose  = 0;
@@ -284,6 +286,9 @@ do{while(optind < Argc && Legacy(optind)) {}
           case OpStreams:       OpSpec |= DoStreams;
                                 if (!a2i(optarg, &nStrm, 1, 15)) Usage(22);
                                 break;
+          case OpStripes:       OpSpec |= DoStripes;
+                                if (!a2i(optarg, &nStripes, 1, 15)) Usage(22);
+                                break;
           case OpTlsNoData:     OpSpec |= DoTlsNoData;
                                 break;
           case OpTlsMLF:        OpSpec |= DoTlsMLF;
@@ -348,6 +353,11 @@ do{while(optind < Argc && Legacy(optind)) {}
    if (OpSpec & DoTpc &&  nSrcs > 1)
       UMSG("Third party copy requires a single source.");
 
+// Stripes and multiple sources are two ways of splitting the same file
+//
+   if (OpSpec & DoSources && OpSpec & DoStripes && nStripes > 1)
+      UMSG("Stripes cannot be combined with multiple sources.");
+
 // Check for conflicts with ZIP archive
 //
    if( OpSpec & DoZip & DoCksrc )
@@ -932,7 +942,7 @@ void XrdCpConfig::Usage(int rc)
    "         [--parallel <n>] [--posc] [--proxy <host>:<port>]\n"
    "         [--recursive] [--retry <n>] [--retry-policy <force|continue>]\n"
    "         [--rm-bad-cksum] [--server] [--silent] [--sources <n>]\n"
-   "         [--streams <n>] [--tlsmetalink] [--tlsnodata]\n"
+   "         [--streams <n>] [--stripes <n>] [--tlsmetalink] [--tlsnodata]\n"
    "         [--tpc [delegate] {first|only}] [--verbose] [--version]\n"
    "         [--xattr] [--xrate <rate>] [--xrate-threshold <rate>]\n"
    "         [--zip <file>] [--zip-append] [--zip-mtln-cksum]\n";
@@ -984,6 +994,9 @@ void XrdCpConfig::Usage(int rc)
    "-s | --silent                 produces no output other than error messages\n"
    "-y | --sources <n>            uses up to the number of sources specified in parallel\n"
    "-S | --streams <n>            copies using the specified number of TCP connections\n"
+   "     --stripes <n>            reads a remote source file in n stripes, each reading\n"
+   "                              its own ranges; unless --streams is given as many TCP\n"
+   "                              connections are used\n"
    "     --tlsmetalink            convert [x]root to [x]roots protocol in metalinks\n"
    "-E | --tlsnodata              in case of [x]roots protocol, encrypt only the control\n"
    "                              stream and leave the data streams unencrypted\n"
@@ -74,6 +74,7 @@ struct defVar
              int    Dlvl;           // Debug level                 (0 to 3)
              int    nSrcs;          // Number of sources wanted    (dflt 1)
              int    nStrm;          // Number of streams wanted    (dflt 1)
+             int    nStripes;       // Number of stripes wanted    (dflt 1)
              int    Retry;          // Max times to retry failed copy job
         std::string RetryPolicy;    // retry policy (to force or to continue)
              int    Verbose;        // True if --verbose specified
@@ -203,6 +204,9 @@ static const uint64_t    DoRetryPolicy     = 0x0000000400000000LL; // --retry-po
 static const uint64_t    OpZipAppend       = 0x13;
 static const uint64_t    DoZipAppend       = 0x0000000800000000LL; // --zip-append
 
+static const uint64_t    OpStripes         = 0x14;
+static const uint64_t    DoStripes         = 0x0000001000000000LL; // --stripes
+
 // Call Config with the parameters passed to main() to fill out this object. If
 // the method returns then no errors have been found. Otherwise, it exits.
 // The following options may be passed (largely to support legacy stuff):
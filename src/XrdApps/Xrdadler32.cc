@@ -46,12 +46,11 @@
 #if defined(__linux__) || defined(__GNU__) || (defined(__FreeBSD_kernel__) && defined(__GLIBC__))
   #include <sys/xattr.h>
 #endif
-#include <zlib.h>
-
 #include "XrdPosix/XrdPosixXrootd.hh"
 #include "XrdPosix/XrdPosixXrootdPath.hh"
 #include "XrdOuc/XrdOucString.hh"
 
+#include "XrdCks/XrdCksCalcadler32.hh"
 #include "XrdCks/XrdCksXAttr.hh"
 #include "XrdOuc/XrdOucXAttr.hh"
 
@@ -165,8 +164,7 @@ int main(int argc, char *argv[])
     const char attr[] = "user.checksum.adler32";
     struct stat stbuf;
     int fd, len, rc;
-    uLong adler;
-    adler = adler32(0L, Z_NULL, 0);
+    unsigned long adler = 1;
 
     if (argc == 2 && ! strcmp(argv[1], "-h"))
     {
@@ -209,7 +207,7 @@ int main(int argc, char *argv[])
             strcpy(path, "-");
         }
         while ( (len = read(fd, buf, N)) > 0 )
-            adler = adler32(adler, (const Bytef*)buf, len);
+            adler = XrdCksCalcadler32::Calc32(adler, buf, len);
 
         if (fd != STDIN_FILENO) 
         {   /* try saving adler32 to attribute before close() */
@@ -241,8 +239,7 @@ int main(int argc, char *argv[])
             off_t totbytes = 0;
             while ( totbytes < stbuf.st_size && (len = XrdPosixXrootd::Read(fd, buf, N)) > 0 )
             {
-                adler = adler32(adler, 
-                                (const Bytef*)buf, 
+                adler = XrdCksCalcadler32::Calc32(adler, buf,
                                 (len < (stbuf.st_size - totbytes)? len : stbuf.st_size - totbytes ));
                 totbytes += len;
             }
@@ -0,0 +1,364 @@
+/******************************************************************************/
+/*                                                                            */
+/*                 X r d C k s C a l c a d l e r 3 2 . c c                    */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstring>
+
+#include "XrdCks/XrdCksCalcadler32.hh"
+
+/* The scalar implementation of adler32 was derived from zlib and is
+                   * Copyright (C) 1995-1998 Mark Adler
+   Below are the zlib license terms for this implementation.
+*/
+
+/* zlib.h -- interface of the 'zlib' general purpose compression library
+  version 1.1.4, March 11th, 2002
+
+  Copyright (C) 1995-2002 Jean-loup Gailly and Mark Adler
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+
+  Jean-loup Gailly        Mark Adler
+  jloup@gzip.org          madler@alumni.caltech.edu
+
+
+  The data format used by the zlib library is described by RFCs (Request for
+  Comments) 1950 to 1952 in the files ftp://ds.internic.net/rfc/rfc1950.txt
+  (zlib format), rfc1951.txt (deflate format) and rfc1952.txt (gzip format).
+*/
+
+/* The vector kernels compute the adler32 sums over blocks of B bytes. For a
+   block b[0..B-1] starting with sums s1 and s2 the new sums are:
+
+       s1' = s1 + sum(b[i])
+       s2' = s2 + B*s1 + sum((B-i)*b[i])
+
+   The weighted sum is done with multiply-add instructions and the plain sum
+   with sum-of-absolute-differences against zero. The B*s1 terms are deferred
+   by accumulating the running s1 once per block and multiplying at the end.
+   Blocks are processed in runs short enough that no 32 bit lane overflows
+   before the sums are reduced modulo AdlerBase (the zlib NMAX constraint).
+*/
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define XRDCKS_ADLER_X86 1
+#include <immintrin.h>
+#endif
+
+/******************************************************************************/
+/*                         L o c a l   D e f i n e s                          */
+/******************************************************************************/
+
+namespace
+{
+const uint32_t AdlerBase = 0xFFF1;
+const size_t   AdlerNMax = 5552;
+
+/* NMAX is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 */
+
+#define DO1(buf)  {s1 += *buf++; s2 += s1;}
+#define DO2(buf)  DO1(buf); DO1(buf);
+#define DO4(buf)  DO2(buf); DO2(buf);
+#define DO8(buf)  DO4(buf); DO4(buf);
+#define DO16(buf) DO8(buf); DO8(buf);
+
+/******************************************************************************/
+/*                         S c a l a r   K e r n e l                          */
+/******************************************************************************/
+
+uint32_t adlerScalar(uint32_t s1, uint32_t s2, const unsigned char *buff,
+                     size_t blen)
+{
+   size_t k;
+
+   while(blen > 0)
+        {k = (blen < AdlerNMax ? blen : AdlerNMax);
+         blen -= k;
+         while(k >= 16) {DO16(buff); k -= 16;}
+         if (k != 0) do {DO1(buff);} while (--k);
+         s1 %= AdlerBase; s2 %= AdlerBase;
+        }
+   return (s2 << 16) | s1;
+}
+
+#ifdef XRDCKS_ADLER_X86
+/******************************************************************************/
+/*                         S S S E 3   K e r n e l                            */
+/******************************************************************************/
+
+__attribute__((target("ssse3")))
+uint32_t adlerSSSE3(uint32_t s1, uint32_t s2, const unsigned char *buff,
+                    size_t blen)
+{
+   const size_t bSize = 32;
+   size_t n, blocks = blen / bSize;
+
+   const __m128i tap1 = _mm_setr_epi8(32,31,30,29,28,27,26,25,
+                                      24,23,22,21,20,19,18,17);
+   const __m128i tap2 = _mm_setr_epi8(16,15,14,13,12,11,10, 9,
+                                       8, 7, 6, 5, 4, 3, 2, 1);
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i ones = _mm_set1_epi16(1);
+
+   blen -= blocks * bSize;
+   while(blocks)
+        {n = AdlerNMax / bSize;
+         if (n > blocks) n = blocks;
+         blocks -= n;
+
+         __m128i v_ps = _mm_set_epi32(0, 0, 0, (int)(s1 * n));
+         __m128i v_s2 = _mm_set_epi32(0, 0, 0, (int)s2);
+         __m128i v_s1 = _mm_setzero_si128();
+
+         do {const __m128i b1 = _mm_loadu_si128((const __m128i *)buff);
+             const __m128i b2 = _mm_loadu_si128((const __m128i *)(buff+16));
+             v_ps = _mm_add_epi32(v_ps, v_s1);
+             v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(b1, zero));
+             v_s2 = _mm_add_epi32(v_s2,
+                       _mm_madd_epi16(_mm_maddubs_epi16(b1, tap1), ones));
+             v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(b2, zero));
+             v_s2 = _mm_add_epi32(v_s2,
+                       _mm_madd_epi16(_mm_maddubs_epi16(b2, tap2), ones));
+             buff += bSize;
+            } while(--n);
+
+         v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+         v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(2,3,0,1)));
+         v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1,0,3,2)));
+         s1  += (uint32_t)_mm_cvtsi128_si32(v_s1);
+         v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2,3,0,1)));
+         v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1,0,3,2)));
+         s2   = (uint32_t)_mm_cvtsi128_si32(v_s2);
+         s1 %= AdlerBase; s2 %= AdlerBase;
+        }
+
+   return adlerScalar(s1, s2, buff, blen);
+}
+
+/******************************************************************************/
+/*                          A V X 2   K e r n e l                             */
+/******************************************************************************/
+
+__attribute__((target("avx2")))
+uint32_t adlerAVX2(uint32_t s1, uint32_t s2, const unsigned char *buff,
+                   size_t blen)
+{
+   const size_t bSize = 64;
+   size_t n, blocks = blen / bSize;
+
+   const __m256i tap1 = _mm256_setr_epi8(64,63,62,61,60,59,58,57,
+                                         56,55,54,53,52,51,50,49,
+                                         48,47,46,45,44,43,42,41,
+                                         40,39,38,37,36,35,34,33);
+   const __m256i tap2 = _mm256_setr_epi8(32,31,30,29,28,27,26,25,
+                                         24,23,22,21,20,19,18,17,
+                                         16,15,14,13,12,11,10, 9,
+                                          8, 7, 6, 5, 4, 3, 2, 1);
+   const __m256i zero = _mm256_setzero_si256();
+   const __m256i ones = _mm256_set1_epi16(1);
+
+   blen -= blocks * bSize;
+   while(blocks)
+        {n = AdlerNMax / bSize;
+         if (n > blocks) n = blocks;
+         blocks -= n;
+
+         __m256i v_ps = _mm256_setr_epi32((int)(s1 * n), 0, 0, 0, 0, 0, 0, 0);
+         __m256i v_s2 = _mm256_setr_epi32((int)s2,       0, 0, 0, 0, 0, 0, 0);
+         __m256i v_s1 = _mm256_setzero_si256();
+
+         do {const __m256i b1 = _mm256_loadu_si256((const __m256i *)buff);
+             const __m256i b2 = _mm256_loadu_si256((const __m256i *)(buff+32));
+             v_ps = _mm256_add_epi32(v_ps, v_s1);
+             v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(b1, zero));
+             v_s2 = _mm256_add_epi32(v_s2,
+                       _mm256_madd_epi16(_mm256_maddubs_epi16(b1, tap1), ones));
+             v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(b2, zero));
+             v_s2 = _mm256_add_epi32(v_s2,
+                       _mm256_madd_epi16(_mm256_maddubs_epi16(b2, tap2), ones));
+             buff += bSize;
+            } while(--n);
+
+         v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 6));
+
+         __m128i h1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1),
+                                    _mm256_extracti128_si256(v_s1, 1));
+         __m128i h2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2),
+                                    _mm256_extracti128_si256(v_s2, 1));
+         h1 = _mm_add_epi32(h1, _mm_shuffle_epi32(h1, _MM_SHUFFLE(2,3,0,1)));
+         h1 = _mm_add_epi32(h1, _mm_shuffle_epi32(h1, _MM_SHUFFLE(1,0,3,2)));
+         h2 = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, _MM_SHUFFLE(2,3,0,1)));
+         h2 = _mm_add_epi32(h2, _mm_shuffle_epi32(h2, _MM_SHUFFLE(1,0,3,2)));
+         s1 += (uint32_t)_mm_cvtsi128_si32(h1);
+         s2  = (uint32_t)_mm_cvtsi128_si32(h2);
+         s1 %= AdlerBase; s2 %= AdlerBase;
+        }
+
+   return adlerScalar(s1, s2, buff, blen);
+}
+
+/******************************************************************************/
+/*                       A V X - 5 1 2   K e r n e l                          */
+/******************************************************************************/
+
+// Horizontal sum of the 32-bit lanes. This goes through memory because the
+// reduction intrinsics draw spurious uninitialized warnings from some gcc's.
+//
+__attribute__((target("avx512f,avx512bw")))
+inline uint32_t adlerSum512(__m512i v)
+{
+   alignas(64) uint32_t lane[16];
+   uint32_t sum = 0;
+
+   _mm512_store_si512((void *)lane, v);
+   for (int i = 0; i < 16; i++) sum += lane[i];
+   return sum;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+uint32_t adlerAVX512(uint32_t s1, uint32_t s2, const unsigned char *buff,
+                     size_t blen)
+{
+   const size_t bSize = 64;
+   size_t n, blocks = blen / bSize;
+
+   const __m512i tap  = _mm512_set_epi8( 1, 2, 3, 4, 5, 6, 7, 8,
+                                         9,10,11,12,13,14,15,16,
+                                        17,18,19,20,21,22,23,24,
+                                        25,26,27,28,29,30,31,32,
+                                        33,34,35,36,37,38,39,40,
+                                        41,42,43,44,45,46,47,48,
+                                        49,50,51,52,53,54,55,56,
+                                        57,58,59,60,61,62,63,64);
+   const __m512i zero = _mm512_setzero_si512();
+   const __m512i ones = _mm512_set1_epi16(1);
+
+   blen -= blocks * bSize;
+   while(blocks)
+        {n = AdlerNMax / bSize;
+         if (n > blocks) n = blocks;
+         blocks -= n;
+
+         __m512i v_ps = _mm512_setzero_si512();
+         __m512i v_s2 = _mm512_setzero_si512();
+         __m512i v_s1 = _mm512_setzero_si512();
+         uint32_t ps0 = (uint32_t)(s1 * n);
+
+         do {const __m512i b = _mm512_loadu_si512((const void *)buff);
+             v_ps = _mm512_add_epi32(v_ps, v_s1);
+             v_s1 = _mm512_add_epi32(v_s1, _mm512_sad_epu8(b, zero));
+             v_s2 = _mm512_add_epi32(v_s2,
+                       _mm512_madd_epi16(_mm512_maddubs_epi16(b, tap), ones));
+             buff += bSize;
+            } while(--n);
+
+         s2  += ((adlerSum512(v_ps) + ps0) << 6) + adlerSum512(v_s2);
+         s1  += adlerSum512(v_s1);
+         s1 %= AdlerBase; s2 %= AdlerBase;
+        }
+
+   return adlerScalar(s1, s2, buff, blen);
+}
+#endif
+
+/******************************************************************************/
+/*                          D i s p a t c h i n g                             */
+/******************************************************************************/
+
+typedef uint32_t (*adlerFunc)(uint32_t, uint32_t, const unsigned char *, size_t);
+
+struct adlerKernel {const char *name; adlerFunc func;};
+
+adlerKernel adlerSelect()
+{
+#ifdef XRDCKS_ADLER_X86
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx512bw")) return {"avx512", adlerAVX512};
+   if (__builtin_cpu_supports("avx2"))     return {"avx2",   adlerAVX2};
+   if (__builtin_cpu_supports("ssse3"))    return {"ssse3",  adlerSSSE3};
+#endif
+   return {"scalar", adlerScalar};
+}
+
+// The selection is done on first use so that it is valid even when we are
+// called during static initialization.
+//
+const adlerKernel &adlerBest()
+{
+   static const adlerKernel theKernel = adlerSelect();
+   return theKernel;
+}
+}
+
+/******************************************************************************/
+/*                                C a l c 3 2                                 */
+/******************************************************************************/
+
+uint32_t XrdCksCalcadler32::Calc32(uint32_t adler, const void *buff,
+                                   size_t blen, const char *kernel)
+{
+   const unsigned char *bP = (const unsigned char *)buff;
+   uint32_t s1 = adler & 0xffff, s2 = adler >> 16;
+
+// Use the best kernel unless a specific one was requested. Short buffers are
+// not worth setting up the vector registers for.
+//
+   if (!kernel)
+      {if (blen < 64) return adlerScalar(s1, s2, bP, blen);
+       return adlerBest().func(s1, s2, bP, blen);
+      }
+
+   if (!strcmp(kernel, "scalar")) return adlerScalar(s1, s2, bP, blen);
+#ifdef XRDCKS_ADLER_X86
+   __builtin_cpu_init();
+   if (!strcmp(kernel, "ssse3")  && __builtin_cpu_supports("ssse3"))
+      return adlerSSSE3(s1, s2, bP, blen);
+   if (!strcmp(kernel, "avx2")   && __builtin_cpu_supports("avx2"))
+      return adlerAVX2(s1, s2, bP, blen);
+   if (!strcmp(kernel, "avx512") && __builtin_cpu_supports("avx512bw"))
+      return adlerAVX512(s1, s2, bP, blen);
+#endif
+   return adlerBest().func(s1, s2, bP, blen);
+}
+
+/******************************************************************************/
+/*                                K e r n e l                                 */
+/******************************************************************************/
+
+const char *XrdCksCalcadler32::Kernel() {return adlerBest().name;}
@@ -37,46 +37,9 @@
 #include "XrdCks/XrdCksCalc.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 
-/* The following implementation of adler32 was derived from zlib and is
-                   * Copyright (C) 1995-1998 Mark Adler
-   Below are the zlib license terms for this implementation.
+/* The adler32 kernels are derived from zlib. The scalar kernel carries the
+   zlib license terms, see XrdCksCalcadler32.cc.
 */
-  
-/* zlib.h -- interface of the 'zlib' general purpose compression library
-  version 1.1.4, March 11th, 2002
-
-  Copyright (C) 1995-2002 Jean-loup Gailly and Mark Adler
-
-  This software is provided 'as-is', without any express or implied
-  warranty.  In no event will the authors be held liable for any damages
-  arising from the use of this software.
-
-  Permission is granted to anyone to use this software for any purpose,
-  including commercial applications, and to alter it and redistribute it
-  freely, subject to the following restrictions:
-
-  1. The origin of this software must not be misrepresented; you must not
-     claim that you wrote the original software. If you use this software
-     in a product, an acknowledgment in the product documentation would be
-     appreciated but is not required.
-  2. Altered source versions must be plainly marked as such, and must not be
-     misrepresented as being the original software.
-  3. This notice may not be removed or altered from any source distribution.
-
-  Jean-loup Gailly        Mark Adler
-  jloup@gzip.org          madler@alumni.caltech.edu
-
-
-  The data format used by the zlib library is described by RFCs (Request for
-  Comments) 1950 to 1952 in the files ftp://ds.internic.net/rfc/rfc1950.txt
-  (zlib format), rfc1951.txt (deflate format) and rfc1952.txt (gzip format).
-*/
-
-#define DO1(buf)  {unSum1 += *buf++; unSum2 += unSum1;}
-#define DO2(buf)  DO1(buf); DO1(buf);
-#define DO4(buf)  DO2(buf); DO2(buf);
-#define DO8(buf)  DO4(buf); DO4(buf);
-#define DO16(buf) DO8(buf); DO8(buf);
 
 class XrdCksCalcadler32 : public XrdCksCalc
 {
@@ -95,29 +58,41 @@ void        Init() {unSum1 = AdlerStart; unSum2 = 0;}
 XrdCksCalc *New() {return (XrdCksCalc *)new XrdCksCalcadler32;}
 
 void        Update(const char *Buff, int BLen)
-                  {int k;
-                   unsigned char *buff = (unsigned char *)Buff;
-                   while(BLen > 0)
-                        {k = (BLen < AdlerNMax ? BLen : AdlerNMax);
-                         BLen -= k;
-                         while(k >= 16) {DO16(buff); k -= 16;}
-                         if (k != 0) do {DO1(buff);} while (--k);
-                         unSum1 %= AdlerBase; unSum2 %= AdlerBase;
-                        }
+                  {if (BLen <= 0) return;
+                   uint32_t adler = Calc32((unSum2 << 16) | unSum1, Buff, BLen);
+                   unSum1 = adler & 0xffff; unSum2 = adler >> 16;
                   }
 
 const char *Type(int &csSize) {csSize = sizeof(AdlerValue); return "adler32";}
 
+//-----------------------------------------------------------------------------
+//! Update an adler32 checksum using the fastest kernel this cpu supports.
+//!
+//! @param  adler  - The running checksum, use 1 for the initial value.
+//! @param  buff   - Pointer to the data.
+//! @param  blen   - The number of bytes in buff.
+//! @param  kernel - When not nil, the name of the kernel to use (one of
+//!                  scalar, ssse3, avx2, or avx512). The best available
+//!                  kernel is used if the cpu does not support it.
+//!
+//! @return The updated checksum.
+//-----------------------------------------------------------------------------
+
+static uint32_t    Calc32(uint32_t adler, const void *buff, size_t blen,
+                          const char *kernel=0);
+
+//-----------------------------------------------------------------------------
+//! Return the name of the kernel selected for this cpu.
+//-----------------------------------------------------------------------------
+
+static const char *Kernel();
+
             XrdCksCalcadler32() {Init();}
 virtual    ~XrdCksCalcadler32() {}
 
 private:
 
-static const unsigned int AdlerBase  = 0xFFF1;
 static const unsigned int AdlerStart = 0x0001;
-static const          int AdlerNMax  = 5552;
-
-/* NMAX is the largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 */
 
              unsigned int AdlerValue;
              unsigned int unSum1;
@@ -28,6 +28,8 @@
 #include "XrdSys/XrdSysE2T.hh"
 
 #include <memory>
+#include <algorithm>
+#include <sys/uio.h>
 
 namespace XrdCl
 {
@@ -60,7 +62,8 @@ namespace XrdCl
                                                     chdata( chdata ),
                                                     outmsg( nullptr ),
                                                     outmsgsize( 0 ),
-                                                    outhandler( nullptr )
+                                                    outhandler( nullptr ),
+                                                    nbsent( 0 )
       {
       }
 
@@ -74,6 +77,7 @@ namespace XrdCl
         outmsgsize = 0;;
         outhandler = nullptr;
         outsign.reset();
+        nbsent     = 0;
       }
 
       //------------------------------------------------------------------------
@@ -95,7 +99,14 @@ namespace XrdCl
               toBeSent = strm.OnReadyToWrite( substrmnb );
               outmsg = toBeSent.first;
               outhandler = toBeSent.second;
-              if( !outmsg ) return XRootDStatus( stOK, suAlreadyDone );
+              if( !outmsg )
+              {
+                //--------------------------------------------------------------
+                // Nothing more to write, push out what the cork held back
+                //--------------------------------------------------------------
+                if( nbsent ) return Flash();
+                return XRootDStatus( stOK, suAlreadyDone );
+              }
 
               outmsg->SetCursor( 0 );
               outmsgsize = outmsg->GetSize();
@@ -118,33 +129,15 @@ namespace XrdCl
               continue;
             }
             //------------------------------------------------------------------
-            // First write the signature (if there is one)
+            // First write the signature (if there is one) together with the
+            // request itself
             //------------------------------------------------------------------
             case WriteSign:
             {
-              //----------------------------------------------------------------
-              // If there is a signature for the request send it over the socket
-              //----------------------------------------------------------------
-              if( outsign )
-              {
-                XRootDStatus st = socket.Send( *outsign, strmname );
-                if( !st.IsOK() || st.code == suRetry ) return st;
-              }
-              //----------------------------------------------------------------
-              // The next step is to write the signature
-              //----------------------------------------------------------------
-              writestage = WriteRequest;
-              continue;
-            }
-            //------------------------------------------------------------------
-            // Then write the request itself
-            //------------------------------------------------------------------
-            case WriteRequest:
-            {
-              XRootDStatus st = socket.Send( *outmsg, strmname );
+              XRootDStatus st = SendRequest();
               if( !st.IsOK() || st.code == suRetry ) return st;
               //----------------------------------------------------------------
-              // The next step is to write the signature
+              // The next step is to write the raw data
               //----------------------------------------------------------------
               writestage = WriteRawData;
               continue;
@@ -174,19 +167,25 @@ namespace XrdCl
             //------------------------------------------------------------------
             case WriteDone:
             {
-              XRootDStatus st = socket.Flash();
-              if( !st.IsOK() )
-              {
-                log->Error( AsyncSockMsg, "[%s] Unable to flash the socket: %s",
-                            strmname.c_str(), XrdSysE2T( st.errNo ) );
-                return st;
-              }
-
               log->Dump( AsyncSockMsg, "[%s] Successfully sent message: %s (%p).",
                          strmname.c_str(), outmsg->GetObfuscatedDescription().c_str(), (void*)outmsg );
 
               strm.OnMessageSent( substrmnb, outmsg, outmsgsize );
-              return XRootDStatus();
+
+              //----------------------------------------------------------------
+              // The socket stays corked while we carry on with the next
+              // queued message, so that small requests written one after
+              // another share TCP segments, up to the point we let others
+              // have a go (each message is still a send of its own)
+              //----------------------------------------------------------------
+              ++nbsent;
+              if( nbsent >= MaxCorked ) return Flash();
+              writestage = WriteStart;
+              outmsg     = nullptr;
+              outmsgsize = 0;
+              outhandler = nullptr;
+              outsign.reset();
+              continue;
             }
           }
           // just in case ...
@@ -200,14 +199,81 @@ namespace XrdCl
 
     private:
 
+      //------------------------------------------------------------------------
+      //! Write the signature (if any) and the request with a single gathering
+      //! send
+      //------------------------------------------------------------------------
+      XRootDStatus SendRequest()
+      {
+        while( true )
+        {
+          iovec    iov[2];
+          Message *msgs[2];
+          int      cnt = 0;
+          if( outsign && outsign->GetCursor() < outsign->GetSize() )
+            msgs[cnt++] = outsign.get();
+          if( outmsg->GetCursor() < outmsg->GetSize() )
+            msgs[cnt++] = outmsg;
+          if( !cnt ) break;
+          for( int i = 0; i < cnt; ++i )
+          {
+            iov[i].iov_base = msgs[i]->GetBufferAtCursor();
+            iov[i].iov_len  = msgs[i]->GetSize() - msgs[i]->GetCursor();
+          }
+
+          int wrtcnt = 0;
+          XRootDStatus st = socket.Send( iov, cnt, wrtcnt );
+          if( !st.IsOK() )
+          {
+            outmsg->SetCursor( 0 );
+            if( outsign ) outsign->SetCursor( 0 );
+            return st;
+          }
+          if( st.code == suRetry ) return st;
+
+          for( int i = 0; i < cnt && wrtcnt > 0; ++i )
+          {
+            uint32_t len = std::min<uint32_t>( wrtcnt, iov[i].iov_len );
+            msgs[i]->AdvanceCursor( len );
+            wrtcnt -= len;
+          }
+        }
+
+        Log *log = DefaultEnv::GetLog();
+        log->Dump( AsyncSockMsg, "[%s] Wrote a message: %s (%p), %d bytes",
+                   strmname.c_str(), outmsg->GetObfuscatedDescription().c_str(),
+                   (void*)outmsg, outmsg->GetSize() );
+        return XRootDStatus();
+      }
+
+      //------------------------------------------------------------------------
+      //! Uncork the socket so that everything written so far goes out
+      //------------------------------------------------------------------------
+      XRootDStatus Flash()
+      {
+        nbsent = 0;
+        XRootDStatus st = socket.Flash();
+        if( !st.IsOK() )
+        {
+          Log *log = DefaultEnv::GetLog();
+          log->Error( AsyncSockMsg, "[%s] Unable to flash the socket: %s",
+                      strmname.c_str(), XrdSysE2T( st.errNo ) );
+        }
+        return st;
+      }
+
+      //------------------------------------------------------------------------
+      //! Maximum number of messages written before the socket is flashed
+      //------------------------------------------------------------------------
+      static const int MaxCorked = 16;
+
       //------------------------------------------------------------------------
       //! Stages of reading out a response from the socket
       //------------------------------------------------------------------------
       enum Stage
       {
         WriteStart,   //< the next step is to initialize the read
-        WriteSign,    //< the next step is to write the signature
-        WriteRequest, //< the next step is to write the request
+        WriteSign,    //< the next step is to write the signature and request
         WriteRawData, //< the next step is to write the raw data
         WriteDone     //< the next step is to finalize the write
       };
@@ -234,6 +300,7 @@ namespace XrdCl
       uint32_t                  outmsgsize;
       MsgHandler               *outhandler;
       std::unique_ptr<Message>  outsign;
+      int                       nbsent; //< messages written since last flash
   };
 
 }
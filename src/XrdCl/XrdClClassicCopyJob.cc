@@ -1407,9 +1407,15 @@ namespace
     public:
       //------------------------------------------------------------------------
       //! Constructor
+      //!
+      //! @param striped if true the file is read in nbSrc stripes from the
+      //!                source URL itself rather than from its replicas
+      //! @param ordered if true the chunks are returned in file order
       //------------------------------------------------------------------------
-      XRootDSourceXCp( const XrdCl::URL* url, uint32_t chunkSize, uint16_t parallelChunks, int32_t nbSrc, uint64_t blockSize ):
-        pXCpCtx( 0 ), pUrl( url ), pChunkSize( chunkSize ), pParallelChunks( parallelChunks ), pNbSrc( nbSrc ), pBlockSize( blockSize )
+      XRootDSourceXCp( const XrdCl::URL* url, uint32_t chunkSize, uint16_t parallelChunks, int32_t nbSrc, uint64_t blockSize,
+                       bool striped = false, bool ordered = false ):
+        pXCpCtx( 0 ), pUrl( url ), pChunkSize( chunkSize ), pParallelChunks( parallelChunks ), pNbSrc( nbSrc ), pBlockSize( blockSize ),
+        pStriped( striped ), pOrdered( ordered )
       {
       }
 
@@ -1427,7 +1433,16 @@ namespace
         XrdCl::Log *log = XrdCl::DefaultEnv::GetLog();
         int64_t fileSize = -1;
 
-        if( pUrl->IsMetalink() )
+        if( pStriped )
+        {
+          //--------------------------------------------------------------------
+          // Every stripe opens the file on its own, the reads of the stripes
+          // are spread over the substreams of the channel. The second half
+          // of the list lets a stripe reopen the file once after an error.
+          //--------------------------------------------------------------------
+          pReplicas.assign( 2 * pNbSrc, pUrl->GetURL() );
+        }
+        else if( pUrl->IsMetalink() )
         {
           XrdCl::RedirectorRegistry &registry = XrdCl::RedirectorRegistry::Instance();
           XrdCl::VirtualRedirector *redirector = registry.Get( *pUrl );
@@ -1461,7 +1476,7 @@ namespace
         }
         log->Debug( XrdCl::UtilityMsg, "%s", ss.str().c_str() );
 
-        pXCpCtx = new XrdCl::XCpCtx( pReplicas, pBlockSize, pNbSrc, pChunkSize, pParallelChunks, fileSize );
+        pXCpCtx = new XrdCl::XCpCtx( pReplicas, pBlockSize, pNbSrc, pChunkSize, pParallelChunks, fileSize, pOrdered );
 
         return pXCpCtx->Initialize();
       }
@@ -1508,6 +1523,9 @@ namespace
       virtual XrdCl::XRootDStatus GetCheckSum( std::string &checkSum,
                                                std::string &checkSumType )
       {
+        if( pStriped )
+          return XrdCl::Utils::GetRemoteCheckSum( checkSum, checkSumType, *pUrl );
+
         if( pUrl->IsMetalink() )
         {
           XrdCl::RedirectorRegistry &registry   = XrdCl::RedirectorRegistry::Instance();
@@ -1551,6 +1569,30 @@ namespace
         return st;
       }
 
+      //------------------------------------------------------------------------
+      //! Get the data received from every source as "<host> <bytes> <usec>",
+      //! where usec is the time from the start of the source to its last
+      //! chunk
+      //------------------------------------------------------------------------
+      std::vector<std::string> GetSrcStats()
+      {
+        std::vector<std::string> ret;
+        if( !pXCpCtx ) return ret;
+
+        std::vector<XrdCl::XCpCtx::SrcStats> stats = pXCpCtx->GetSrcStats();
+        for( size_t i = 0; i < stats.size(); ++i )
+        {
+          using namespace std::chrono;
+          if( stats[i].host.empty() ) continue; // never got the file open
+          long long usec = stats[i].bytes ?
+              duration_cast<microseconds>( stats[i].last - stats[i].start ).count() : 0;
+          std::ostringstream o;
+          o << stats[i].host << " " << stats[i].bytes << " " << usec;
+          ret.push_back( o.str() );
+        }
+        return ret;
+      }
+
     private:
 
 
@@ -1561,6 +1603,8 @@ namespace
       uint16_t                  pParallelChunks;
       int32_t                   pNbSrc;
       uint64_t                  pBlockSize;
+      bool                      pStriped;
+      bool                      pOrdered;
   };
 
   //----------------------------------------------------------------------------
@@ -2441,6 +2485,7 @@ namespace XrdCl
     bool        posc, force, coerce, makeDir, dynamicSource, zip, xcp, preserveXAttr,
                 rmOnBadCksum, continue_, zipappend, doserver;
     int32_t     nbXcpSources;
+    uint16_t    nbStripes;
     long long   xRate;
     long long   xRateThreshold;
     time_t      cpTimeout;
@@ -2468,6 +2513,7 @@ namespace XrdCl
     pProperties->Get( "zipAppend",       zipappend );
     pProperties->Get( "addcksums",       addcksums );
     pProperties->Get( "doServer",        doserver );
+    pProperties->Get( "stripes",         nbStripes );
 
     if( zip )
       pProperties->Get( "zipSource",     zipSource );
@@ -2512,9 +2558,33 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     // Initialize the source and the destination
     //--------------------------------------------------------------------------
+    //--------------------------------------------------------------------------
+    // A single remote file may be read in stripes, each stripe being a source
+    // of an extreme copy reading the same URL. The stripes get small blocks,
+    // so a fast stripe simply takes more of them.
+    //--------------------------------------------------------------------------
+    bool striped = nbStripes > 1 && !xcp && !zip && !dynamicSource && !continue_ &&
+                   !GetSource().IsLocalFile() && !GetSource().IsMetalink() &&
+                   GetSource().GetProtocol() != "stdio";
+
+    //--------------------------------------------------------------------------
+    // The chunks of an extreme copy arrive out of order, stdout and the
+    // checksum of a local target need them in order.
+    //--------------------------------------------------------------------------
+    bool ordered = GetTarget().GetProtocol() == "stdio" ||
+                   ( GetTarget().IsLocalFile() && !checkSumType.empty() );
+
     std::unique_ptr<Source> src;
+    XRootDSourceXCp *xcpSrc = 0;
     if( xcp )
-      src.reset( new XRootDSourceXCp( &GetSource(), chunkSize, parallelChunks, nbXcpSources, blockSize ) );
+      src.reset( xcpSrc = new XRootDSourceXCp( &GetSource(), chunkSize, parallelChunks, nbXcpSources, blockSize,
+                                               false, ordered ) );
+    else if( striped )
+    {
+      log->Debug( UtilityMsg, "Reading %s in %d stripes", GetSource().GetObfuscatedURL().c_str(), nbStripes );
+      src.reset( xcpSrc = new XRootDSourceXCp( &GetSource(), chunkSize, parallelChunks, nbStripes,
+                                               uint64_t( chunkSize ) * parallelChunks, true, ordered ) );
+    }
     else if( zip ) // TODO make zip work for xcp
       src.reset( new XRootDSourceZip( zipSource, &GetSource(), chunkSize, parallelChunks,
                                       checkSumType, addcksums , doserver) );
@@ -2708,6 +2778,8 @@ namespace XrdCl
       return SetResult( stError, errDataError );
     }
     pResults->Set( "size", total_processed );
+    if( xcpSrc )
+      pResults->Set( "sourceStats", xcpSrc->GetSrcStats() );
 
     //--------------------------------------------------------------------------
     // Finalize the destination
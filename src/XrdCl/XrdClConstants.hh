@@ -96,6 +96,7 @@ namespace XrdCl
   const int DefaultRetryWrtAtLBLimit       = 3;
   const int DefaultCpRetry                 = 0;
   const int DefaultCpUsePgWrtRd            = 1;
+  const int DefaultCpStripes               = 1;
 
   const char * const DefaultPollerPreference   = "built-in";
   const char * const DefaultNetworkStack       = "IPAuto";
@@ -161,7 +162,8 @@ namespace XrdCl
       { to_lower( "ZipMtlnCksum" ),            DefaultZipMtlnCksum },
       { to_lower( "IPNoShuffle" ),             DefaultIPNoShuffle },
       { to_lower( "WantTlsOnNoPgrw" ),         DefaultWantTlsOnNoPgrw },
-      { to_lower( "RetryWrtAtLBLimit" ),       DefaultRetryWrtAtLBLimit }
+      { to_lower( "RetryWrtAtLBLimit" ),       DefaultRetryWrtAtLBLimit },
+      { to_lower( "CpStripes" ),               DefaultCpStripes }
     };
 
   static std::unordered_map<std::string, std::string> theDefaultStrs
@@ -40,6 +40,7 @@
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <sstream>
 
 //------------------------------------------------------------------------------
 // Progress notifier
@@ -52,7 +53,7 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
     //--------------------------------------------------------------------------
     ProgressDisplay(): pPrevious(0), pPrintProgressBar(true),
       pPrintSourceCheckSum(false), pPrintTargetCheckSum(false),
-      pPrintAdditionalCheckSum(false)
+      pPrintAdditionalCheckSum(false), pPrintSourceStats(false)
     {}
 
     //--------------------------------------------------------------------------
@@ -139,6 +140,13 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
           PrintCheckSum( d.source, cks, size );
       }
 
+      if( pPrintSourceStats )
+      {
+        std::vector<std::string> stats;
+        results->Get( "sourceStats", stats );
+        PrintSourceStats( stats );
+      }
+
       pOngoingJobs.erase(it);
     }
 
@@ -275,6 +283,29 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
       std::cerr << std::endl;
     }
 
+    //--------------------------------------------------------------------------
+    //! Print the throughput of every stripe / source, each entry of stats
+    //! is "<host> <bytes> <usec>"
+    //--------------------------------------------------------------------------
+    void PrintSourceStats( const std::vector<std::string> &stats )
+    {
+      for( size_t i = 0; i < stats.size(); ++i )
+      {
+        std::istringstream in( stats[i] );
+        std::string host;
+        uint64_t    bytes = 0, usec = 0;
+        if( !( in >> host >> bytes >> usec ) ) continue;
+
+        uint64_t speed = usec ? bytes * 1000000 / usec : bytes;
+        std::ostringstream o;
+        o << "[" << i << "] " << host << " ";
+        o << XrdCl::Utils::BytesToString( bytes ) << "B in ";
+        o << std::fixed << std::setprecision( 2 ) << usec / 1e6 << "s ";
+        o << "[" << XrdCl::Utils::BytesToString( speed ) << "B/s]";
+        std::cerr << o.str() << std::endl;
+      }
+    }
+
     //--------------------------------------------------------------------------
     // Printing flags
     //--------------------------------------------------------------------------
@@ -282,6 +313,7 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
     void PrintSourceCheckSum( bool print ) { pPrintSourceCheckSum = print; }
     void PrintTargetCheckSum( bool print ) { pPrintTargetCheckSum = print; }
     void PrintAdditionalCheckSum( bool print ) { pPrintAdditionalCheckSum = print; }
+    void PrintSourceStats( bool print )    { pPrintSourceStats    = print; }
 
   private:
     struct JobData
@@ -300,6 +332,7 @@ class ProgressDisplay: public XrdCl::CopyProgressHandler
     bool                        pPrintSourceCheckSum;
     bool                        pPrintTargetCheckSum;
     bool                        pPrintAdditionalCheckSum;
+    bool                        pPrintSourceStats;
     std::map<uint32_t, JobData> pOngoingJobs;
     XrdSysRecMutex              pMutex;
 };
@@ -615,6 +648,16 @@ int main( int argc, char **argv )
     xcp       = true;
   }
 
+  //----------------------------------------------------------------------------
+  // Striped copy
+  //----------------------------------------------------------------------------
+  int nbStripes = 1;
+  if( config.Want( XrdCpConfig::DoStripes ) )
+    nbStripes = config.nStripes;
+
+  if( ( xcp || nbStripes > 1 ) && !config.Want( XrdCpConfig::DoSilent ) )
+    progress.PrintSourceStats( true );
+
   //----------------------------------------------------------------------------
   // Environment settings
   //----------------------------------------------------------------------------
@@ -627,6 +670,8 @@ int main( int argc, char **argv )
 
   if( config.nStrm != 0 )
     env->PutInt( "SubStreamsPerChannel", config.nStrm + 1 /*stands for the control stream*/ );
+  else if( nbStripes > 1 )
+    env->PutInt( "SubStreamsPerChannel", nbStripes + 1 /*one data stream per stripe*/ );
 
   if( config.Retry != -1 )
   {
@@ -899,6 +944,7 @@ int main( int argc, char **argv )
     properties.Set( "zipAppend",       zipappend              );
     properties.Set( "addcksums",       config.AddCksVal       );
     properties.Set( "doServer",        doserver               );
+    properties.Set( "stripes",         nbStripes              );
 
     if( zip )
       properties.Set( "zipSource",     zipFile                );
@@ -316,6 +316,13 @@ namespace XrdCl
       p.Set( "xcpBlockSize", val );
     }
 
+    if( !p.HasProperty( "stripes" ) )
+    {
+      int val = DefaultCpStripes;
+      env->GetInt( "CpStripes", val );
+      p.Set( "stripes", val );
+    }
+
     if( !p.HasProperty( "initTimeout" ) )
     {
       int val = DefaultCPInitTimeout;
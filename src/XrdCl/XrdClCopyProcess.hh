@@ -149,6 +149,9 @@ namespace XrdCl
       //! tpcTimeout     [time_t]   - time limit for the actual copy to finish
       //! dynamicSource  [bool]     - support for the case where the size source
       //!                             file may change during reading process
+      //! stripes        [uint16_t] - number of stripes a single remote source
+      //!                             file is read in, each stripe reading its
+      //!                             own ranges (1 means no striping)
       //!
       //! Configuration job - this is a job that that is supposed to configure
       //! the copy process as a whole instead of adding a copy job:
@@ -163,6 +166,8 @@ namespace XrdCl
       //! status         [XRootDStatus] - status of the copy operation
       //! sources        [vector<string>] - all sources used
       //! realTarget     [string]   - the actual disk server target
+      //! sourceStats    [vector<string>] - for striped and extreme copies, per
+      //!                             source "<host> <bytes> <usec>"
       //------------------------------------------------------------------------
       XRootDStatus AddJob( const PropertyList &properties,
                            PropertyList       *results );
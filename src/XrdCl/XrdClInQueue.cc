@@ -25,6 +25,7 @@
 #include "XrdCl/XrdClConstants.hh"
 
 #include <arpa/inet.h>              // for network unmarshalling stuff
+#include <algorithm>
 
 namespace XrdCl
 {
@@ -48,6 +49,91 @@ namespace XrdCl
     return false;
   }
 
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  InQueue::InQueue() : pWheelTime( ::time(0) )
+  {
+    for( uint32_t i = 0; i < NbChunks; ++i )
+      pChunks[i] = nullptr;
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  InQueue::~InQueue()
+  {
+    for( uint32_t i = 0; i < NbChunks; ++i )
+      delete [] pChunks[i];
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the table entry for a SID
+  //----------------------------------------------------------------------------
+  InQueue::Slot *InQueue::GetSlot( uint16_t sid, bool create )
+  {
+    Slot *&chunk = pChunks[sid / ChunkSize];
+    if( !chunk )
+    {
+      if( !create ) return nullptr;
+      chunk = new Slot[ChunkSize];
+      for( uint32_t i = 0; i < ChunkSize; ++i )
+        chunk[i] = Slot{ nullptr, 0, 0 };
+    }
+    return &chunk[sid % ChunkSize];
+  }
+
+  //----------------------------------------------------------------------------
+  // Put the handler in the table
+  //----------------------------------------------------------------------------
+  void InQueue::SetHandler( uint16_t sid, MsgHandler *handler, time_t expires )
+  {
+    Slot *slot = GetSlot( sid, true );
+    slot->handler = handler;
+    slot->expires = 0;
+    ++slot->gen;
+    if( expires ) SetExpiration( sid, *slot, expires );
+  }
+
+  //----------------------------------------------------------------------------
+  // Set the expiration of the handler in a slot and arm the timer
+  //----------------------------------------------------------------------------
+  void InQueue::SetExpiration( uint16_t sid, Slot &slot, time_t expires )
+  {
+    slot.expires = expires;
+    if( !expires ) return;
+    //--------------------------------------------------------------------------
+    // Whatever is due already goes off with the next tick
+    //--------------------------------------------------------------------------
+    time_t t = std::max( expires, pWheelTime + 1 );
+    pWheel[t % WheelSize].emplace_back( sid, slot.gen );
+  }
+
+  //----------------------------------------------------------------------------
+  // Remove the handler from a slot, this also disarms its timer
+  //----------------------------------------------------------------------------
+  void InQueue::ClearSlot( Slot &slot )
+  {
+    slot.handler = nullptr;
+    slot.expires = 0;
+    ++slot.gen;
+  }
+
+  //----------------------------------------------------------------------------
+  // Call f( sid, slot ) for every slot holding a handler
+  //----------------------------------------------------------------------------
+  template<typename Func>
+  void InQueue::ForEachHandler( Func f )
+  {
+    for( uint32_t c = 0; c < NbChunks; ++c )
+    {
+      if( !pChunks[c] ) continue;
+      for( uint32_t i = 0; i < ChunkSize; ++i )
+        if( pChunks[c][i].handler )
+          f( uint16_t( c * ChunkSize + i ), pChunks[c][i] );
+    }
+  }
+
   //----------------------------------------------------------------------------
   // Add a listener that should be notified about incoming messages
   //----------------------------------------------------------------------------
@@ -55,8 +141,7 @@ namespace XrdCl
   {
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-
-    pHandlers[handlerSid] = HandlerAndExpire( handler, 0 );
+    SetHandler( handlerSid, handler, 0 );
   }
 
   //----------------------------------------------------------------------------
@@ -78,26 +163,26 @@ namespace XrdCl
     }
 
     XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.find(msgSid);
+    Slot *slot = GetSlot( msgSid, false );
 
-    if (it != pHandlers.end())
+    if( slot && slot->handler )
     {
       Log *log = DefaultEnv::GetLog();
-      handler = it->second.first;
+      handler = slot->handler;
       act     = handler->Examine( msg );
-      if( it->second.second == 0 ) {
-        it->second.second = handler->GetExpiration();
+      if( slot->expires == 0 ) {
+        SetExpiration( msgSid, *slot, handler->GetExpiration() );
         log->Debug( ExDbgMsg, "[handler: %p] Assigned expiration %lld.",
-                    (void*)handler, (long long)it->second.second );
+                    (void*)handler, (long long)slot->expires );
       }
-      exp     = it->second.second;
+      exp     = slot->expires;
       log->Debug( ExDbgMsg, "[msg: %p] Assigned MsgHandler: %p.",
                   (void*)msg.get(), (void*)handler );
 
 
       if( act & MsgHandler::RemoveHandler )
       {
-        pHandlers.erase( it );
+        ClearSlot( *slot );
         log->Debug( ExDbgMsg, "[handler: %p] Removed MsgHandler: %p from the in-queue.",
                     (void*)handler, (void*)handler );
       }
@@ -120,7 +205,7 @@ namespace XrdCl
   {
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers[handlerSid] = HandlerAndExpire( handler, expires );
+    SetHandler( handlerSid, handler, expires );
   }
 
   //----------------------------------------------------------------------------
@@ -130,7 +215,8 @@ namespace XrdCl
   {
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    pHandlers.erase(handlerSid);
+    Slot *slot = GetSlot( handlerSid, false );
+    if( slot ) ClearSlot( *slot );
     Log *log = DefaultEnv::GetLog();
     log->Debug( ExDbgMsg, "[handler: %p] Removed MsgHandler: %p from the in-queue.",
                 (void*)handler, (void*)handler );
@@ -143,21 +229,13 @@ namespace XrdCl
   void InQueue::ReportStreamEvent( MsgHandler::StreamEvent event,
 				   XRootDStatus                    status )
   {
-    uint8_t action = 0;
     XrdSysMutexHelper scopedLock( pMutex );
-    for( HandlerMap::iterator it = pHandlers.begin(); it != pHandlers.end(); )
+    ForEachHandler( [&]( uint16_t, Slot &slot )
     {
-      action = it->second.first->OnStreamEvent( event, status );
-
+      uint8_t action = slot.handler->OnStreamEvent( event, status );
       if( action & MsgHandler::RemoveHandler )
-      {
-        auto next = it; ++next;
-        pHandlers.erase( it );
-        it = next;
-      }
-      else
-        ++it;
-    }
+        ClearSlot( slot );
+    } );
   }
 
   //----------------------------------------------------------------------------
@@ -169,20 +247,49 @@ namespace XrdCl
       now = ::time(0);
 
     XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.begin();
-    while( it != pHandlers.end() )
+    if( now <= pWheelTime ) return;
+
+    //--------------------------------------------------------------------------
+    // Collect the timers of all the seconds since the last tick, if it was
+    // more than a full turn of the wheel ago every bucket is due
+    //--------------------------------------------------------------------------
+    time_t first = pWheelTime + 1;
+    if( now - first >= time_t( WheelSize ) )
+      first = now - WheelSize + 1;
+    pWheelTime = now;
+
+    std::vector<TimerEntry> due;
+    for( time_t t = first; t <= now; ++t )
     {
-      if( it->second.second && it->second.second <= now )
+      std::vector<TimerEntry> &bucket = pWheel[t % WheelSize];
+      due.insert( due.end(), bucket.begin(), bucket.end() );
+      bucket.clear();
+    }
+
+    for( const TimerEntry &entry : due )
+    {
+      Slot *slot = GetSlot( entry.first, false );
+      if( !slot || slot->gen != entry.second || !slot->handler || !slot->expires )
+        continue;
+
+      //------------------------------------------------------------------------
+      // Not there yet, it's been on the wheel for more than one turn
+      //------------------------------------------------------------------------
+      if( slot->expires > now )
       {
-        uint8_t act = it->second.first->OnStreamEvent( MsgHandler::Timeout,
-                                         Status( stError, errOperationExpired ) );
-        auto next = it; ++next;
-        if( act & MsgHandler::RemoveHandler )
-          pHandlers.erase( it );
-        it = next;
+        pWheel[slot->expires % WheelSize].push_back( entry );
+        continue;
       }
-      else
-        ++it;
+
+      uint8_t act = slot->handler->OnStreamEvent( MsgHandler::Timeout,
+                                                  Status( stError, errOperationExpired ) );
+      if( act & MsgHandler::RemoveHandler )
+        ClearSlot( *slot );
+      //------------------------------------------------------------------------
+      // The handler stays, so it will be notified again with the next tick
+      //------------------------------------------------------------------------
+      else if( slot->gen == entry.second )
+        pWheel[( now + 1 ) % WheelSize].push_back( entry );
     }
   }
 
@@ -193,16 +300,16 @@ namespace XrdCl
   {
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.find( handlerSid );
-    if( it != pHandlers.end() )
+    Slot *slot = GetSlot( handlerSid, false );
+    if( slot && slot->handler )
     {
-      if( it->second.second == 0 )
+      if( slot->expires == 0 )
       {
-        it->second.second   = handler->GetExpiration();
+        SetExpiration( handlerSid, *slot, handler->GetExpiration() );
 
         Log *log = DefaultEnv::GetLog();
         log->Debug( ExDbgMsg, "[handler: %p] Assigned expiration %lld.",
-                    (void*)handler, (long long)it->second.second );
+                    (void*)handler, (long long)slot->expires );
 
       }
     }
@@ -216,9 +323,9 @@ namespace XrdCl
   {
     uint16_t handlerSid = handler->GetSid();
     XrdSysMutexHelper scopedLock( pMutex );
-    HandlerMap::iterator it = pHandlers.find( handlerSid );
-    if( it == pHandlers.end() ) return false;
-    if( it->second.second == 0 ) return true;
+    Slot *slot = GetSlot( handlerSid, false );
+    if( !slot || !slot->handler ) return false;
+    if( slot->expires == 0 ) return true;
     return false;
   }
 
@@ -20,9 +20,9 @@
 #define __XRD_CL_IN_QUEUE_HH__
 
 #include <XrdSys/XrdSysPthread.hh>
-#include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 #include "XrdCl/XrdClXRootDResponses.hh"
 #include "XrdCl/XrdClPostMasterInterfaces.hh"
 
@@ -32,10 +32,23 @@ namespace XrdCl
 
   //----------------------------------------------------------------------------
   //! A synchronize queue for incoming data
+  //!
+  //! The handlers are kept in a table indexed directly by the SID of their
+  //! request and expire through a timer wheel with one second buckets.
   //----------------------------------------------------------------------------
   class InQueue
   {
     public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      InQueue();
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~InQueue();
+
       //------------------------------------------------------------------------
       //! Add a listener that should be notified about incoming messages.
       //! Freshly added handlers have no expire time set and will not trigger
@@ -113,10 +126,58 @@ namespace XrdCl
       //------------------------------------------------------------------------
       bool DiscardMessage(Message& msg, uint16_t& sid) const;
 
-      typedef std::pair<MsgHandler *, time_t> HandlerAndExpire;
-      typedef std::map<uint16_t, HandlerAndExpire> HandlerMap;
-      HandlerMap pHandlers;
-      XrdSysRecMutex pMutex;
+      //------------------------------------------------------------------------
+      //! Entry of the handler table
+      //------------------------------------------------------------------------
+      struct Slot
+      {
+        MsgHandler *handler;
+        time_t      expires;
+        uint32_t    gen;     //< bumped every time a handler is put in the slot
+      };
+
+      //------------------------------------------------------------------------
+      //! Entry of the timer wheel, stale if the generation doesn't match
+      //------------------------------------------------------------------------
+      typedef std::pair<uint16_t, uint32_t> TimerEntry;
+
+      static const uint32_t ChunkSize = 1024;
+      static const uint32_t NbChunks  = 0x10000 / ChunkSize;
+      static const uint32_t WheelSize = 256;
+
+      //------------------------------------------------------------------------
+      //! Get the table entry for a SID
+      //!
+      //! @param create : allocate the chunk of the table if necessary
+      //! @return       : the entry, null if it doesn't exist
+      //------------------------------------------------------------------------
+      Slot *GetSlot( uint16_t sid, bool create );
+
+      //------------------------------------------------------------------------
+      //! Put the handler in the table, replacing whatever was there before
+      //------------------------------------------------------------------------
+      void SetHandler( uint16_t sid, MsgHandler *handler, time_t expires );
+
+      //------------------------------------------------------------------------
+      //! Set the expiration of the handler in a slot and arm the timer
+      //------------------------------------------------------------------------
+      void SetExpiration( uint16_t sid, Slot &slot, time_t expires );
+
+      //------------------------------------------------------------------------
+      //! Remove the handler from a slot
+      //------------------------------------------------------------------------
+      void ClearSlot( Slot &slot );
+
+      //------------------------------------------------------------------------
+      //! Call f( sid, slot ) for every slot holding a handler
+      //------------------------------------------------------------------------
+      template<typename Func>
+      void ForEachHandler( Func f );
+
+      Slot                    *pChunks[NbChunks];
+      std::vector<TimerEntry>  pWheel[WheelSize];
+      time_t                   pWheelTime; //< expirations up to this one are done
+      XrdSysRecMutex           pMutex;
   };
 }
 
@@ -18,7 +18,7 @@
 
 #include "XrdCl/XrdClSIDManager.hh"
 
-#include <algorithm>
+#include <cstring>
 
 namespace XrdCl
 {
@@ -31,34 +31,123 @@ namespace XrdCl
     return *instance;
   }
   //----------------------------------------------------------------------------
-  // Allocate a SID
-  //---------------------------------------------------------------------------
-  Status SIDManager::AllocateSID( uint8_t sid[2] )
+  // Constructor
+  //----------------------------------------------------------------------------
+  SIDManager::SIDManager(): pFreeHead( 0 ), pSIDCeiling( 1 ), pNbAllocated( 0 ),
+                            pNbTimedOut( 0 ), pRefCount( 0 )
+  {
+    for( uint32_t i = 0; i < NbChunks; ++i )
+      pChunks[i].store( nullptr, std::memory_order_relaxed );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  SIDManager::~SIDManager()
+  {
+    for( uint32_t i = 0; i < NbChunks; ++i )
+      delete [] pChunks[i].load( std::memory_order_relaxed );
+  }
+
+  //----------------------------------------------------------------------------
+  // Push a SID onto the free stack
+  //----------------------------------------------------------------------------
+  void SIDManager::PushFree( uint16_t sid )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
+    Slot     &slot = GetSlot( sid );
+    uint64_t  head = pFreeHead.load( std::memory_order_relaxed );
+    uint64_t  newhead;
+    do
+    {
+      slot.next.store( uint16_t( head ), std::memory_order_relaxed );
+      newhead = ( ( ( head >> 16 ) + 1 ) << 16 ) | sid;
+    }
+    while( !pFreeHead.compare_exchange_weak( head, newhead,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Pop a SID from the free stack
+  //----------------------------------------------------------------------------
+  uint16_t SIDManager::PopFree()
+  {
+    uint64_t head = pFreeHead.load( std::memory_order_acquire );
+    uint64_t newhead;
+    do
+    {
+      uint16_t sid = uint16_t( head );
+      if( !sid ) return 0;
+      //------------------------------------------------------------------------
+      // The slot may be popped and pushed again by someone else in the
+      // meantime, in which case the counter makes the exchange fail
+      //------------------------------------------------------------------------
+      uint16_t next = GetSlot( sid ).next.load( std::memory_order_relaxed );
+      newhead = ( ( ( head >> 16 ) + 1 ) << 16 ) | next;
+    }
+    while( !pFreeHead.compare_exchange_weak( head, newhead,
+                                             std::memory_order_acquire,
+                                             std::memory_order_acquire ) );
+    return uint16_t( head );
+  }
 
-    uint16_t allocSID = 1;
+  //----------------------------------------------------------------------------
+  // Take a SID that has never been used before
+  //----------------------------------------------------------------------------
+  uint16_t SIDManager::NewSID()
+  {
+    uint32_t sid = pSIDCeiling.load( std::memory_order_relaxed );
+    do
+    {
+      if( sid >= 0xffff ) return 0;
+    }
+    while( !pSIDCeiling.compare_exchange_weak( sid, sid + 1,
+                                               std::memory_order_relaxed ) );
 
     //--------------------------------------------------------------------------
-    // Get a SID from the list of free SIDs if it's not empty
+    // Make sure the chunk of the table holding the SID exists
     //--------------------------------------------------------------------------
-    if( !pFreeSIDs.empty() )
+    std::atomic<Slot*> &chunk = pChunks[sid / ChunkSize];
+    if( !chunk.load( std::memory_order_acquire ) )
     {
-      allocSID = pFreeSIDs.front();
-      pFreeSIDs.pop_front();
+      Slot *slots = new Slot[ChunkSize];
+      for( uint32_t i = 0; i < ChunkSize; ++i )
+      {
+        slots[i].allocTime.store( 0, std::memory_order_relaxed );
+        slots[i].next.store( 0, std::memory_order_relaxed );
+        slots[i].state.store( Free, std::memory_order_relaxed );
+      }
+      Slot *expected = nullptr;
+      if( !chunk.compare_exchange_strong( expected, slots,
+                                          std::memory_order_acq_rel ) )
+        delete [] slots;
     }
+    return uint16_t( sid );
+  }
+
+  //----------------------------------------------------------------------------
+  // Allocate a SID
+  //---------------------------------------------------------------------------
+  Status SIDManager::AllocateSID( uint8_t sid[2] )
+  {
     //--------------------------------------------------------------------------
-    // Allocate a new SID if possible
+    // Get a SID from the stack of free SIDs if it's not empty, otherwise
+    // allocate a new SID if possible
     //--------------------------------------------------------------------------
-    else
+    uint16_t allocSID = PopFree();
+    if( !allocSID )
     {
-      if( pSIDCeiling == 0xffff )
+      allocSID = NewSID();
+      if( !allocSID )
         return Status( stError, errNoMoreFreeSIDs );
-      allocSID = pSIDCeiling++;
     }
 
+    Slot &slot = GetSlot( allocSID );
+    slot.allocTime.store( time(0), std::memory_order_relaxed );
+    slot.state.store( Allocated, std::memory_order_relaxed );
+    pNbAllocated.fetch_add( 1, std::memory_order_relaxed );
+
     memcpy( sid, &allocSID, 2 );
-    pAllocTime[allocSID] = time(0);
     return Status();
   }
 
@@ -67,11 +156,17 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   void SIDManager::ReleaseSID( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t relSID = 0;
     memcpy( &relSID, sid, 2 );
-    pFreeSIDs.push_back( relSID );
-    pAllocTime.erase( relSID );
+    Slot *slot = FindSlot( relSID );
+    if( !slot ) return;
+    uint8_t state = Allocated;
+    if( !slot->state.compare_exchange_strong( state, Free,
+                                             std::memory_order_relaxed ) )
+      return;
+    slot->allocTime.store( 0, std::memory_order_relaxed );
+    pNbAllocated.fetch_sub( 1, std::memory_order_relaxed );
+    PushFree( relSID );
   }
 
   //----------------------------------------------------------------------------
@@ -79,11 +174,17 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   void SIDManager::TimeOutSID( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    pTimeOutSIDs.insert( tiSID );
-    pAllocTime.erase( tiSID );
+    Slot *slot = FindSlot( tiSID );
+    if( !slot ) return;
+    uint8_t state = Allocated;
+    if( !slot->state.compare_exchange_strong( state, TimedOut,
+                                             std::memory_order_relaxed ) )
+      return;
+    slot->allocTime.store( 0, std::memory_order_relaxed );
+    pNbAllocated.fetch_sub( 1, std::memory_order_relaxed );
+    pNbTimedOut.fetch_add( 1, std::memory_order_relaxed );
   }
 
   //----------------------------------------------------------------------------
@@ -91,12 +192,15 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   bool SIDManager::IsAnySIDOldAs( const time_t tlim ) const
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-    return std::any_of( pAllocTime.begin(), pAllocTime.end(),
-                        [tlim](const auto& p)
+    uint32_t ceiling = pSIDCeiling.load( std::memory_order_relaxed );
+    for( uint32_t sid = 1; sid < ceiling; ++sid )
     {
-      return p.second <= tlim;
-    } );
+      Slot *slot = FindSlot( uint16_t( sid ) );
+      if( !slot || slot->state.load( std::memory_order_relaxed ) != Allocated ) continue;
+      time_t t = slot->allocTime.load( std::memory_order_relaxed );
+      if( t && t <= tlim ) return true;
+    }
+    return false;
   }
 
   //----------------------------------------------------------------------------
@@ -104,13 +208,10 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   bool SIDManager::IsTimedOut( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    std::set<uint16_t>::iterator it = pTimeOutSIDs.find( tiSID );
-    if( it != pTimeOutSIDs.end() )
-      return true;
-    return false;
+    Slot *slot = FindSlot( tiSID );
+    return slot && slot->state.load( std::memory_order_relaxed ) == TimedOut;
   }
 
   //----------------------------------------------------------------------------
@@ -118,11 +219,16 @@ namespace XrdCl
   //-----------------------------------------------------------------------------
   void SIDManager::ReleaseTimedOut( uint8_t sid[2] )
   {
-    XrdSysMutexHelper scopedLock( pMutex );
     uint16_t tiSID = 0;
     memcpy( &tiSID, sid, 2 );
-    pTimeOutSIDs.erase( tiSID );
-    pFreeSIDs.push_back( tiSID );
+    Slot *slot = FindSlot( tiSID );
+    if( !slot ) return;
+    uint8_t state = TimedOut;
+    if( !slot->state.compare_exchange_strong( state, Free,
+                                             std::memory_order_relaxed ) )
+      return;
+    pNbTimedOut.fetch_sub( 1, std::memory_order_relaxed );
+    PushFree( tiSID );
   }
 
   //------------------------------------------------------------------------
@@ -130,11 +236,19 @@ namespace XrdCl
   //------------------------------------------------------------------------
   void SIDManager::ReleaseAllTimedOut()
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-    std::set<uint16_t>::iterator it;
-    for( it = pTimeOutSIDs.begin(); it != pTimeOutSIDs.end(); ++it )
-      pFreeSIDs.push_back( *it );
-    pTimeOutSIDs.clear();
+    if( !pNbTimedOut.load( std::memory_order_relaxed ) ) return;
+    uint32_t ceiling = pSIDCeiling.load( std::memory_order_relaxed );
+    for( uint32_t sid = 1; sid < ceiling; ++sid )
+    {
+      Slot *slot = FindSlot( uint16_t( sid ) );
+      if( !slot ) continue;
+      uint8_t state = TimedOut;
+      if( !slot->state.compare_exchange_strong( state, Free,
+                                               std::memory_order_relaxed ) )
+        continue;
+      pNbTimedOut.fetch_sub( 1, std::memory_order_relaxed );
+      PushFree( uint16_t( sid ) );
+    }
   }
 
   //----------------------------------------------------------------------------
@@ -142,8 +256,7 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   uint16_t SIDManager::GetNumberOfAllocatedSIDs() const
   {
-    XrdSysMutexHelper scopedLock( pMutex );
-    return pSIDCeiling - pFreeSIDs.size() - pTimeOutSIDs.size() - 1;
+    return pNbAllocated.load( std::memory_order_relaxed );
   }
 
   //----------------------------------------------------------------------------
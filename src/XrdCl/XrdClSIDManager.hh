@@ -19,8 +19,7 @@
 #ifndef __XRD_CL_SID_MANAGER_HH__
 #define __XRD_CL_SID_MANAGER_HH__
 
-#include <list>
-#include <set>
+#include <atomic>
 #include <memory>
 #include <unordered_map>
 #include <string>
@@ -38,6 +37,11 @@ namespace XrdCl
 
   //----------------------------------------------------------------------------
   //! Handle XRootD stream IDs
+  //!
+  //! The SIDs live in a table indexed by the SID itself, the free ones are
+  //! linked into a lock-free stack. The table is allocated in chunks as the
+  //! SIDs are handed out for the first time, so that channels that never
+  //! have many requests in flight stay small.
   //----------------------------------------------------------------------------
   class SIDManager
   {
@@ -48,7 +52,7 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Constructor
       //------------------------------------------------------------------------
-      SIDManager(): pSIDCeiling(1), pRefCount(0) { }
+      SIDManager();
 
 #if __cplusplus < 201103L
     //------------------------------------------------------------------------
@@ -61,7 +65,7 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Destructor
       //------------------------------------------------------------------------
-      ~SIDManager() { }
+      ~SIDManager();
 
     public:
 
@@ -108,8 +112,7 @@ namespace XrdCl
       //------------------------------------------------------------------------
       uint32_t NumberOfTimedOutSIDs() const
       {
-        XrdSysMutexHelper scopedLock( pMutex );
-        return pTimeOutSIDs.size();
+        return pNbTimedOut.load( std::memory_order_relaxed );
       }
 
       //------------------------------------------------------------------------
@@ -118,12 +121,74 @@ namespace XrdCl
       uint16_t GetNumberOfAllocatedSIDs() const;
 
     private:
-      std::unordered_map<uint16_t, time_t> pAllocTime;
-      std::list<uint16_t>  pFreeSIDs;
-      std::set<uint16_t>   pTimeOutSIDs;
-      uint16_t             pSIDCeiling;
-      mutable XrdSysMutex  pMutex;
-      mutable size_t       pRefCount;
+
+      //------------------------------------------------------------------------
+      //! State of a SID
+      //------------------------------------------------------------------------
+      enum SIDState : uint8_t
+      {
+        Free      = 0,
+        Allocated = 1,
+        TimedOut  = 2
+      };
+
+      //------------------------------------------------------------------------
+      //! An entry in the SID table
+      //------------------------------------------------------------------------
+      struct Slot
+      {
+        std::atomic<time_t>   allocTime; //< 0 unless allocated
+        std::atomic<uint16_t> next;      //< next free SID, 0 terminates
+        std::atomic<uint8_t>  state;
+      };
+
+      static const uint32_t ChunkSize = 1024;
+      static const uint32_t NbChunks  = 0x10000 / ChunkSize;
+
+      //------------------------------------------------------------------------
+      //! Get the table entry of a SID, it has to have been handed out before
+      //------------------------------------------------------------------------
+      inline Slot& GetSlot( uint16_t sid ) const
+      {
+        return pChunks[sid / ChunkSize].load( std::memory_order_acquire )[sid % ChunkSize];
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the table entry of a SID, null if it has never been handed out
+      //------------------------------------------------------------------------
+      inline Slot* FindSlot( uint16_t sid ) const
+      {
+        if( !sid ) return nullptr;
+        Slot *chunk = pChunks[sid / ChunkSize].load( std::memory_order_acquire );
+        return chunk ? &chunk[sid % ChunkSize] : nullptr;
+      }
+
+      //------------------------------------------------------------------------
+      //! Push a SID onto the free stack
+      //------------------------------------------------------------------------
+      void PushFree( uint16_t sid );
+
+      //------------------------------------------------------------------------
+      //! Pop a SID from the free stack, 0 if the stack is empty
+      //------------------------------------------------------------------------
+      uint16_t PopFree();
+
+      //------------------------------------------------------------------------
+      //! Take a SID that has never been used before, 0 if there are no more
+      //------------------------------------------------------------------------
+      uint16_t NewSID();
+
+      //------------------------------------------------------------------------
+      //! Top of the free stack: the SID in the low 16 bits and a counter,
+      //! bumped with every change to avoid ABA, in the high ones
+      //------------------------------------------------------------------------
+      alignas(64) std::atomic<uint64_t> pFreeHead;
+      alignas(64) std::atomic<uint32_t> pSIDCeiling;
+      std::atomic<uint32_t>             pNbAllocated;
+      std::atomic<uint32_t>             pNbTimedOut;
+      std::atomic<Slot*>                pChunks[NbChunks];
+      mutable XrdSysMutex               pMutex;
+      mutable size_t                    pRefCount;
   };
 
   //----------------------------------------------------------------------------
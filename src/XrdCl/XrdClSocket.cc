@@ -478,6 +478,40 @@ namespace XrdCl
     return XRootDStatus();
   }
 
+  //------------------------------------------------------------------------
+  // Gathering, SIGPIPE free send of several buffers in one system call
+  //------------------------------------------------------------------------
+  XRootDStatus Socket::Send( const iovec *iov, int iovcnt, int &bytesWritten )
+  {
+    //--------------------------------------------------------------------------
+    // Partial TLS writes have to be retried with the very same buffer, so
+    // in this case we take the buffers one by one
+    //--------------------------------------------------------------------------
+    if( pTls )
+    {
+      if( iovcnt <= 0 ) return XRootDStatus();
+      return pTls->Send( (const char*)iov[0].iov_base, iov[0].iov_len, bytesWritten );
+    }
+
+    if( iovcnt > MaxIOV ) iovcnt = MaxIOV;
+
+#if defined(__linux__) || defined(__GNU__) || (defined(__FreeBSD_kernel__) && defined(__GLIBC__))
+    msghdr msg;
+    memset( &msg, 0, sizeof( msg ) );
+    msg.msg_iov    = const_cast<iovec*>( iov );
+    msg.msg_iovlen = iovcnt;
+    ssize_t status = ::sendmsg( pSocket, &msg, MSG_NOSIGNAL );
+#else
+    ssize_t status = ::writev( pSocket, iov, iovcnt );
+#endif
+
+    if( status <= 0 )
+      return ClassifyErrno( errno );
+
+    bytesWritten = status;
+    return XRootDStatus();
+  }
+
   //------------------------------------------------------------------------
   //! Write data from a kernel buffer to the socket
   //!
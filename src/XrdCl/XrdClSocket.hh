@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <string>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <memory>
 
 #include "XrdCl/XrdClXRootDResponses.hh"
@@ -166,6 +167,20 @@ namespace XrdCl
       //------------------------------------------------------------------------
       virtual XRootDStatus Send( const char *buffer, size_t size, int &bytesWritten );
 
+      //------------------------------------------------------------------------
+      //! Gathering, SIGPIPE free send of several buffers in one system call
+      //!
+      //! @param iov          : the buffers to be written
+      //! @param iovcnt       : number of buffers, at most MaxIOV are used
+      //! @param bytesWritten : the amount of data actually written
+      //------------------------------------------------------------------------
+      virtual XRootDStatus Send( const iovec *iov, int iovcnt, int &bytesWritten );
+
+      //------------------------------------------------------------------------
+      //! Maximum number of buffers passed to the kernel in a single send
+      //------------------------------------------------------------------------
+      static const int MaxIOV = 1024;
+
       //------------------------------------------------------------------------
       //! Write data from a kernel buffer to the socket
       //!
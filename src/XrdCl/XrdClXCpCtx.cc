@@ -33,11 +33,12 @@
 namespace XrdCl
 {
 
-XCpCtx::XCpCtx( const std::vector<std::string> &urls, uint64_t blockSize, uint8_t parallelSrc, uint64_t chunkSize, uint64_t parallelChunks, int64_t fileSize ) :
+XCpCtx::XCpCtx( const std::vector<std::string> &urls, uint64_t blockSize, uint8_t parallelSrc, uint64_t chunkSize, uint64_t parallelChunks, int64_t fileSize, bool ordered ) :
       pUrls( std::deque<std::string>( urls.begin(), urls.end() ) ), pBlockSize( blockSize ),
       pParallelSrc( parallelSrc ), pChunkSize( chunkSize ), pParallelChunks( parallelChunks ),
-      pOffset( 0 ), pFileSize( -1 ), pFileSizeCV( 0 ), pDataReceived( 0 ), pDone( false ),
-      pDoneCV( 0 ), pRefCount( 1 ), pDeleteCV( 0 ), pDelete( false )
+      pOffset( 0 ), pFileSize( -1 ), pFileSizeCV( 0 ), pDataReceived( 0 ), pOrdered( ordered ),
+      pNextOffset( 0 ), pMaxAhead( 0 ), pWindowFull( false ), pDone( false ), pDoneCV( 0 ),
+      pRefCount( 1 ), pDeleteCV( 0 ), pDelete( false )
 {
   SetFileSize( fileSize );
 }
@@ -52,6 +53,10 @@ XCpCtx::~XCpCtx()
     if( chunk )
       XCpSrc::DeleteChunk( chunk );
   }
+
+  std::map<uint64_t, PageInfo*>::iterator itr;
+  for( itr = pReorder.begin() ; itr != pReorder.end() ; ++itr )
+    XCpSrc::DeleteChunk( itr->second );
 }
 
 bool XCpCtx::GetNextUrl( std::string & url )
@@ -92,13 +97,43 @@ void XCpCtx::PutChunk( PageInfo* chunk )
   pSink.Put( chunk );
 }
 
+void XCpCtx::Account( size_t srcIdx, const std::string &host, uint64_t bytes )
+{
+  XrdSysMutexHelper lck( pMtx );
+  if( srcIdx >= pSrcStats.size() ) return;
+  SrcStats &stats = pSrcStats[srcIdx];
+  stats.host = host;
+  if( bytes )
+  {
+    stats.bytes += bytes;
+    stats.last   = std::chrono::steady_clock::now();
+  }
+}
+
+std::vector<XCpCtx::SrcStats> XCpCtx::GetSrcStats()
+{
+  XrdSysMutexHelper lck( pMtx );
+  return pSrcStats;
+}
+
 std::pair<uint64_t, uint64_t> XCpCtx::GetBlock()
 {
   XrdSysMutexHelper lck( pMtx );
 
+  // in ordered mode the consumer can only take the chunks in sequence,
+  // everything a source reads ahead of it has to be kept in memory, so
+  // make the source help out the slow ones instead (see XCpSrc::Steal);
+  // the whole block has to fit, so that no more than pMaxAhead bytes are
+  // ever waiting for their turn
   uint64_t blkSize = pBlockSize, offset = pOffset;
   if( pOffset + blkSize > uint64_t( pFileSize ) )
     blkSize = pFileSize - pOffset;
+
+  if( pMaxAhead && blkSize && pOffset + blkSize > pNextOffset + pMaxAhead )
+  {
+    pWindowFull = true;
+    return std::make_pair( pOffset, 0 );
+  }
   pOffset += blkSize;
 
   return std::make_pair( offset, blkSize );
@@ -118,14 +153,19 @@ void XCpCtx::SetFileSize( int64_t size )
 
     if( pBlockSize < pChunkSize )
       pBlockSize = pChunkSize;
+
+    if( pOrdered )
+      pMaxAhead = pBlockSize * pParallelSrc;
   }
 }
 
 XRootDStatus XCpCtx::Initialize()
 {
+  pSrcStats.resize( pParallelSrc );
   for( uint8_t i = 0; i < pParallelSrc; ++i )
   {
-    XCpSrc *src = new XCpSrc( pChunkSize, pParallelChunks, pFileSize, this );
+    pSrcStats[i].start = std::chrono::steady_clock::now();
+    XCpSrc *src = new XCpSrc( pChunkSize, pParallelChunks, pFileSize, this, i );
     pSources.push_back( src );
   }
 
@@ -155,6 +195,14 @@ XRootDStatus XCpCtx::Initialize()
 
 XRootDStatus XCpCtx::GetChunk( XrdCl::PageInfo &ci )
 {
+  // a chunk that arrived out of order might be due now
+  if( !pReorder.empty() && pReorder.begin()->first == pNextOffset )
+  {
+    PageInfo *chunk = pReorder.begin()->second;
+    pReorder.erase( pReorder.begin() );
+    return Deliver( chunk, ci );
+  }
+
   // if we received all the data we are done here
   if( pDataReceived == uint64_t( pFileSize ) )
   {
@@ -176,15 +224,34 @@ XRootDStatus XCpCtx::GetChunk( XrdCl::PageInfo &ci )
   PageInfo *chunk = pSink.Get();
   if( chunk )
   {
-    pDataReceived += chunk->GetLength();
-    ci = std::move( *chunk );
-    delete chunk;
-    return XRootDStatus( stOK, suContinue );
+    if( pOrdered && chunk->GetOffset() != pNextOffset )
+    {
+      PageInfo *&slot = pReorder[chunk->GetOffset()];
+      if( slot ) XCpSrc::DeleteChunk( chunk ); // we already have it
+      else slot = chunk;
+      return XRootDStatus( stOK, suRetry );
+    }
+    return Deliver( chunk, ci );
   }
 
   return XRootDStatus( stOK, suRetry );
 }
 
+XRootDStatus XCpCtx::Deliver( PageInfo *chunk, PageInfo &ci )
+{
+  pDataReceived += chunk->GetLength();
+  if( pOrdered )
+  {
+    pNextOffset += chunk->GetLength();
+    // wake up the sources that were refused a block
+    if( pWindowFull.exchange( false ) )
+      NotifyIdleSrc();
+  }
+  ci = std::move( *chunk );
+  delete chunk;
+  return XRootDStatus( stOK, suContinue );
+}
+
 void XCpCtx::NotifyIdleSrc()
 {
   pDoneCV.Broadcast();
@@ -195,7 +262,7 @@ bool XCpCtx::AllDone()
   XrdSysCondVarHelper lck( pDoneCV );
 
   if( !pDone )
-    pDoneCV.Wait( 60 );
+    pDoneCV.Wait( pOrdered ? 1 : 60 );
 
   return pDone;
 }
@@ -29,8 +29,13 @@
 #include "XrdCl/XrdClXRootDResponses.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <map>
+
+class XCpCtxTest;
 
 namespace XrdCl
 {
@@ -39,8 +44,23 @@ class XCpSrc;
 
 class XCpCtx
 {
+    friend class ::XCpCtxTest;
+
   public:
 
+    /**
+     * Data received by a single source
+     */
+    struct SrcStats
+    {
+      SrcStats() : bytes( 0 ) { }
+
+      std::string                           host;  //!< the host the data came from
+      uint64_t                              bytes; //!< bytes received
+      std::chrono::steady_clock::time_point start; //!< when the source was started
+      std::chrono::steady_clock::time_point last;  //!< when the last chunk arrived
+    };
+
     /**
      * Constructor
      *
@@ -52,8 +72,12 @@ class XCpCtx
      * @param fileSize       : the file size if specified in the metalink file
      *                         (-1 indicates that the file size is not known and
      *                         a stat should be done)
+     * @param ordered        : if true GetChunk returns the chunks in file order,
+     *                         and sources are not given blocks further than
+     *                         parallelSrc blocks ahead of the last chunk
+     *                         returned
      */
-    XCpCtx( const std::vector<std::string> &urls, uint64_t blockSize, uint8_t parallelSrc, uint64_t chunkSize, uint64_t parallelChunks, int64_t fileSize );
+    XCpCtx( const std::vector<std::string> &urls, uint64_t blockSize, uint8_t parallelSrc, uint64_t chunkSize, uint64_t parallelChunks, int64_t fileSize, bool ordered = false );
 
     /**
      * Decrements the reference count and then waits for it to reach
@@ -134,10 +158,26 @@ class XCpCtx
      */
     void PutChunk( PageInfo* chunk );
 
+    /**
+     * Account for data received by a source
+     *
+     * @param srcIdx : index of the source
+     * @param host   : the host the data came from
+     * @param bytes  : number of bytes received
+     */
+    void Account( size_t srcIdx, const std::string &host, uint64_t bytes );
+
+    /**
+     * Get the statistics of all the sources
+     */
+    std::vector<SrcStats> GetSrcStats();
+
     /**
      * Get next block that has to be transferred
      *
-     * @return : pair of offset and block size
+     * @return : pair of offset and block size, the size is 0 if there
+     *           are no blocks left or, in ordered mode, if the block
+     *           would be too far ahead of the data returned so far
      */
     std::pair<uint64_t, uint64_t> GetBlock();
 
@@ -210,7 +250,8 @@ class XCpCtx
     /**
      * Returns true if all chunks have been transferred,
      * otherwise blocks until NotifyIdleSrc is called,
-     * or a 1 minute timeout occurs.
+     * or a 1 minute timeout occurs (1 second in ordered
+     * mode).
      *
      * @return : true is all chunks have been transferred,
      *           false otherwise.
@@ -230,6 +271,14 @@ class XCpCtx
 
   private:
 
+    /**
+     * Hand a chunk from the sink over to the caller
+     *
+     * @param chunk : the chunk, deleted afterwards
+     * @param ci    : the output parameter
+     */
+    XRootDStatus Deliver( PageInfo *chunk, PageInfo &ci );
+
     /**
      * Returns the number of active sources
      *
@@ -306,6 +355,38 @@ class XCpCtx
      */
     uint64_t                   pDataReceived;
 
+    /**
+     * True if the chunks have to be returned in file order
+     */
+    bool                       pOrdered;
+
+    /**
+     * In ordered mode, the offset of the next chunk to be returned
+     */
+    std::atomic<uint64_t>      pNextOffset;
+
+    /**
+     * In ordered mode, how far ahead of pNextOffset blocks may be
+     * handed out
+     */
+    uint64_t                   pMaxAhead;
+
+    /**
+     * True if a source has been refused a block because it would
+     * have been too far ahead
+     */
+    std::atomic<bool>          pWindowFull;
+
+    /**
+     * In ordered mode, chunks that arrived ahead of pNextOffset
+     */
+    std::map<uint64_t, PageInfo*> pReorder;
+
+    /**
+     * Per source statistics, guarded by pMtx
+     */
+    std::vector<SrcStats>      pSrcStats;
+
     /**
      * A flag, true if all chunks have been received and we are done,
      * false otherwise
@@ -107,9 +107,9 @@ class ChunkHandler: public ResponseHandler
 };
 
 
-XCpSrc::XCpSrc( uint32_t chunkSize, uint8_t parallel, int64_t fileSize, XCpCtx *ctx ) :
+XCpSrc::XCpSrc( uint32_t chunkSize, uint8_t parallel, int64_t fileSize, XCpCtx *ctx, size_t index ) :
   pChunkSize( chunkSize ), pParallel( parallel ), pFileSize( fileSize ), pThread(),
-  pCtx( ctx->Self() ), pFile( 0 ), pCurrentOffset( 0 ), pBlkEnd( 0 ), pDataTransfered( 0 ), pRefCount( 1 ),
+  pCtx( ctx->Self() ), pIndex( index ), pFile( 0 ), pCurrentOffset( 0 ), pBlkEnd( 0 ), pDataTransfered( 0 ), pRefCount( 1 ),
   pRunning( false ), pStartTime( 0 ), pTransferTime( 0 ), pUsePgRead( false )
 {
 }
@@ -282,6 +282,8 @@ XRootDStatus XCpSrc::Initialize()
   }
   while( !st.IsOK() );
 
+  SetDataServer();
+
   std::pair<uint64_t, uint64_t> p = pCtx->GetBlock();
   pCurrentOffset = p.first;
   pBlkEnd        = p.second + p.first;
@@ -333,6 +335,8 @@ XRootDStatus XCpSrc::Recover()
   }
   while( !st.IsOK() );
 
+  SetDataServer();
+
   pRecovered.insert( pOngoing.begin(), pOngoing.end() );
   pOngoing.clear();
 
@@ -443,6 +447,7 @@ void XCpSrc::ReportResponse( XRootDStatus *status, PageInfo *chunk, File *handle
     }
   }
 
+  std::string dataServer = pDataServer;
   lck.UnLock();
 
   if( status ) pReports.Put( status );
@@ -456,6 +461,7 @@ void XCpSrc::ReportResponse( XRootDStatus *status, PageInfo *chunk, File *handle
   if( chunk )
   {
     pDataTransfered += chunk->GetLength();
+    pCtx->Account( pIndex, dataServer, chunk->GetLength() );
     pCtx->PutChunk( chunk );
   }
 }
@@ -593,6 +599,19 @@ XRootDStatus XCpSrc::GetWork()
   return XRootDStatus( stError, errInvalidOp );
 }
 
+void XCpSrc::SetDataServer()
+{
+  std::string datasrv;
+  if( !pFile->GetProperty( "DataServer", datasrv ) || datasrv.empty() )
+    datasrv = URL( pUrl ).GetHostId();
+
+  XrdSysMutexHelper lck( pMtx );
+  pDataServer = datasrv;
+  lck.UnLock();
+
+  pCtx->Account( pIndex, datasrv, 0 );
+}
+
 uint64_t XCpSrc::TransferRate()
 {
   time_t duration = pTransferTime + time( 0 ) - pStartTime;
@@ -31,6 +31,8 @@
 
 #include <atomic>
 
+class XCpCtxTest;
+
 namespace XrdCl
 {
 
@@ -39,6 +41,7 @@ class XCpCtx;
 class XCpSrc
 {
     friend class ChunkHandler;
+    friend class ::XCpCtxTest;
 
   public:
 
@@ -51,8 +54,9 @@ class XCpSrc
      *                    should be set to -1 if not available, in this case
      *                    a stat will be performed during initialization
      * @param ctx       : Extreme Copy context
+     * @param index     : index of the source, used for accounting
      */
-    XCpSrc( uint32_t chunkSize, uint8_t parallel, int64_t fileSize, XCpCtx *ctx );
+    XCpSrc( uint32_t chunkSize, uint8_t parallel, int64_t fileSize, XCpCtx *ctx, size_t index = 0 );
 
     /**
      * Creates new thread with XCpSrc::Run as the start routine.
@@ -239,6 +243,12 @@ class XCpSrc
       obj = 0;
     }
 
+    /**
+     * Remember the data server the file has been opened at,
+     * for accounting.
+     */
+    void SetDataServer();
+
     /**
      * Check if two file object point to the same URL.
      *
@@ -291,11 +301,21 @@ class XCpSrc
      */
     XCpCtx                       *pCtx;
 
+    /**
+     * Index of the source, used for accounting.
+     */
+    size_t                        pIndex;
+
     /**
      * Source URL.
      */
     std::string                   pUrl;
 
+    /**
+     * The data server we are reading from (guarded by pMtx).
+     */
+    std::string                   pDataServer;
+
     /**
      * Handle to the file.
      */
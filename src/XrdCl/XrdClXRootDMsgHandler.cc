@@ -74,6 +74,12 @@ namespace
     private:
       XrdCl::XRootDMsgHandler *pHandler;
   };
+
+  //----------------------------------------------------------------------------
+  // Most buffers gathered into a single send of a message body, the iovec
+  // array lives on the stack; 64 still cover 32 pages of a PgWrite
+  //----------------------------------------------------------------------------
+  const int MaxBodyIOV = 64;
 }
 
 namespace XrdCl
@@ -1046,78 +1052,135 @@ namespace XrdCl
       if( pglen > btsLeft ) pglen = btsLeft;
       char*    pgbuf   = static_cast<char*>( chunk.buffer ) + pAsyncOffset;
 
+      //------------------------------------------------------------------------
+      // The digests of the pages to come, in network byte order
+      //------------------------------------------------------------------------
+      if( pPgWrtCksumNet.size() != pCrc32cDigests.size() )
+      {
+        pPgWrtCksumNet.resize( pCrc32cDigests.size() );
+        for( size_t i = 0; i < pCrc32cDigests.size(); ++i )
+          pPgWrtCksumNet[i] = htonl( pCrc32cDigests[i] );
+      }
+
       while( btsLeft > 0 )
       {
-        // first write the crc32c digest
-        while( pPgWrtCksumBuff.GetCursor() < sizeof( uint32_t ) )
+        //----------------------------------------------------------------------
+        // Gather the rest of the current crc32c digest and page followed by
+        // as many further digest/page pairs as we can pass in one go
+        //----------------------------------------------------------------------
+        iovec iov[MaxBodyIOV];
+        int   iovcnt = 0;
+        if( pPgWrtCksumBuff.GetCursor() < sizeof( uint32_t ) )
         {
-          uint32_t dgstlen = sizeof( uint32_t ) - pPgWrtCksumBuff.GetCursor();
-          char*    dgstbuf = pPgWrtCksumBuff.GetBufferAtCursor();
-          int btswrt = 0;
-          Status st = socket->Send( dgstbuf, dgstlen, btswrt );
-          if( !st.IsOK() ) return st;
-          bytesWritten += btswrt;
-          pPgWrtCksumBuff.AdvanceCursor( btswrt );
-          if( st.code == suRetry ) return st;
+          iov[iovcnt].iov_base = pPgWrtCksumBuff.GetBufferAtCursor();
+          iov[iovcnt].iov_len  = sizeof( uint32_t ) - pPgWrtCksumBuff.GetCursor();
+          ++iovcnt;
         }
-        // then write the raw data (one page)
+        iov[iovcnt].iov_base = pgbuf;
+        iov[iovcnt].iov_len  = pglen;
+        ++iovcnt;
+        char     *nxtbuf = pgbuf + pglen;
+        uint32_t  nxtlen = btsLeft - pglen;
+        for( size_t pg = pPgWrtCurrentPageNb + 1;
+             nxtlen > 0 && pg < nbpgs && iovcnt + 2 <= MaxBodyIOV; ++pg )
+        {
+          uint32_t len = std::min<uint32_t>( nxtlen, XrdSys::PageSize );
+          iov[iovcnt].iov_base = &pPgWrtCksumNet[pg];
+          iov[iovcnt].iov_len  = sizeof( uint32_t );
+          ++iovcnt;
+          iov[iovcnt].iov_base = nxtbuf;
+          iov[iovcnt].iov_len  = len;
+          ++iovcnt;
+          nxtbuf += len;
+          nxtlen -= len;
+        }
+
         int btswrt = 0;
-        Status st = socket->Send( pgbuf, pglen, btswrt );
+        Status st = socket->Send( iov, iovcnt, btswrt );
         if( !st.IsOK() ) return st;
-        pgbuf        += btswrt;
-        pglen        -= btswrt;
-        btsLeft      -= btswrt;
         bytesWritten += btswrt;
-        pAsyncOffset += btswrt; // update the offset to the raw data
-        if( st.code == suRetry ) return st;
-        // if we managed to write all the data ...
-        if( pglen == 0 )
+
+        //----------------------------------------------------------------------
+        // Account for what has been written, digests and pages alike
+        //----------------------------------------------------------------------
+        while( btswrt > 0 )
         {
-          // move to the next page
-          ++pPgWrtCurrentPageNb;
-          if( pPgWrtCurrentPageNb < nbpgs )
+          if( pPgWrtCksumBuff.GetCursor() < sizeof( uint32_t ) )
           {
-            // set the digest buffer
-            pPgWrtCksumBuff.SetCursor( 0 );
-            uint32_t digest = htonl( pCrc32cDigests[pPgWrtCurrentPageNb] );
-            memcpy( pPgWrtCksumBuff.GetBuffer(), &digest, sizeof( uint32_t ) );
+            uint32_t len = std::min<uint32_t>( btswrt, sizeof( uint32_t ) - pPgWrtCksumBuff.GetCursor() );
+            pPgWrtCksumBuff.AdvanceCursor( len );
+            btswrt -= len;
+            continue;
           }
-          // set the page length
-          pglen = XrdSys::PageSize;
-          if( pglen > btsLeft ) pglen = btsLeft;
-          // reset offset in the current page
-          pPgWrtCurrentPageOffset = 0;
+          uint32_t len = std::min<uint32_t>( btswrt, pglen );
+          pgbuf        += len;
+          pglen        -= len;
+          btsLeft      -= len;
+          pAsyncOffset += len;
+          btswrt       -= len;
+          // if we managed to write all the data ...
+          if( pglen == 0 )
+          {
+            // move to the next page
+            ++pPgWrtCurrentPageNb;
+            if( pPgWrtCurrentPageNb < nbpgs )
+            {
+              // set the digest buffer
+              pPgWrtCksumBuff.SetCursor( 0 );
+              memcpy( pPgWrtCksumBuff.GetBuffer(), &pPgWrtCksumNet[pPgWrtCurrentPageNb], sizeof( uint32_t ) );
+            }
+            // set the page length
+            pglen = XrdSys::PageSize;
+            if( pglen > btsLeft ) pglen = btsLeft;
+            // reset offset in the current page
+            pPgWrtCurrentPageOffset = 0;
+          }
+          else
+            // otherwise just adjust the offset in the current page
+            pPgWrtCurrentPageOffset += len;
         }
-        else
-          // otherwise just adjust the offset in the current page
-          pPgWrtCurrentPageOffset += btswrt;
-
+        if( st.code == suRetry ) return st;
       }
     }
     else if( !pChunkList->empty() )
     {
       size_t size = pChunkList->size();
-      for( size_t i = pAsyncChunkIndex ; i < size; ++i )
+      while( pAsyncChunkIndex < size )
       {
-        char     *buffer          = (char*)(*pChunkList)[i].buffer;
-        uint32_t  size            = (*pChunkList)[i].length;
-        size_t    leftToBeWritten = size - pAsyncOffset;
-
-        while( leftToBeWritten )
+        //----------------------------------------------------------------------
+        // Send the remaining chunks straight from the user buffers, as many
+        // of them as we can in a single call
+        //----------------------------------------------------------------------
+        iovec iov[MaxBodyIOV];
+        int   iovcnt = 0;
+        for( size_t i = pAsyncChunkIndex; i < size && iovcnt < MaxBodyIOV; ++i )
         {
-          int btswrt = 0;
-          Status st = socket->Send( buffer + pAsyncOffset, leftToBeWritten, btswrt );
-          bytesWritten += btswrt;
-          if( !st.IsOK() || st.code == suRetry ) return st;
-          pAsyncOffset    += btswrt;
-          leftToBeWritten -= btswrt;
+          uint32_t offset = ( i == pAsyncChunkIndex ? pAsyncOffset : 0 );
+          iov[iovcnt].iov_base = (char*)(*pChunkList)[i].buffer + offset;
+          iov[iovcnt].iov_len  = (*pChunkList)[i].length - offset;
+          ++iovcnt;
         }
+
+        int btswrt = 0;
+        Status st = socket->Send( iov, iovcnt, btswrt );
+        if( !st.IsOK() ) return st;
+        bytesWritten += btswrt;
+
         //----------------------------------------------------------------------
-        // Remember that we have moved to the next chunk, also clear the offset
-        // within the buffer as we are going to move to a new one
+        // Remember where we are, i.e. the chunk and the offset within it
         //----------------------------------------------------------------------
-        ++pAsyncChunkIndex;
-        pAsyncOffset = 0;
+        for( int i = 0; i < iovcnt; ++i )
+        {
+          if( size_t( btswrt ) < iov[i].iov_len )
+          {
+            pAsyncOffset += btswrt;
+            break;
+          }
+          btswrt -= iov[i].iov_len;
+          ++pAsyncChunkIndex;
+          pAsyncOffset = 0;
+        }
+        if( st.code == suRetry ) return st;
       }
     }
     else
@@ -663,6 +663,7 @@ namespace XrdCl
       std::unique_ptr<AsyncRawReaderIntfc>   pBodyReader;
 
       Buffer                                 pPgWrtCksumBuff;
+      std::vector<uint32_t>                  pPgWrtCksumNet;
       uint32_t                               pPgWrtCurrentPageOffset;
       uint32_t                               pPgWrtCurrentPageNb;
 
@@ -445,7 +445,7 @@ File::Close(XrdCl::ResponseHandler *handler,
         m_asize = 0;
         auto handler_wrapper = new PutResponseHandler(new CloseCreateHandler(handler));
         m_put_handler.store(handler_wrapper, std::memory_order_release);
-        m_put_op.reset(new XrdClHttp::CurlPutOp(
+        SetPutOp(std::make_shared<XrdClHttp::CurlPutOp>(
             handler_wrapper, m_default_put_handler, m_url, nullptr, 0, ts, m_logger,
             GetConnCallout(), &m_default_header_callout
         ));
@@ -846,7 +846,7 @@ File::Write(uint64_t                offset,
             m_logger->Warning(kLogXrdClHttp, "Cannot start PUT operation at non-zero offset");
             return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidArgs, 0, "HTTP uploads must start at offset 0");
         }
-        m_put_op.reset(new XrdClHttp::CurlPutOp(
+        SetPutOp(std::make_shared<XrdClHttp::CurlPutOp>(
             handler_wrapper, m_default_put_handler, url, static_cast<const char*>(buffer), size, ts, m_logger,
             GetConnCallout(), &m_default_header_callout
         ));
@@ -903,7 +903,7 @@ File::Write(uint64_t                offset,
             delete handler_wrapper;
             return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidArgs, 0, "HTTP uploads must start at offset 0");
         }
-        m_put_op.reset(new XrdClHttp::CurlPutOp(
+        SetPutOp(std::make_shared<XrdClHttp::CurlPutOp>(
             handler_wrapper, m_default_put_handler, url, std::move(buffer), ts, m_logger,
             GetConnCallout(), &m_default_header_callout
         ));
@@ -981,6 +981,14 @@ File::IsOpen() const
     return m_is_opened;
 }
 
+void
+File::SetPutOp(std::shared_ptr<XrdClHttp::CurlPutOp> op)
+{
+    // GetProperty() looks at the operation under the properties lock.
+    std::unique_lock lock(m_properties_mutex);
+    m_put_op = std::move(op);
+}
+
 bool
 File::GetProperty(const std::string &name,
                         std::string &value) const
@@ -996,6 +1004,13 @@ File::GetProperty(const std::string &name,
     }
 
     std::shared_lock lock(m_properties_mutex);
+    // After an upload, the ETag of the new object supersedes the one
+    // recorded at open.
+    if (name == "ETag" && m_put_op && !m_put_op->GetETag().empty()) {
+        value = m_put_op->GetETag();
+        return true;
+    }
+
     if (name == "LastURL") {
         value = m_last_url;
         return true;
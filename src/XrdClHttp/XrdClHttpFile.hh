@@ -169,6 +169,10 @@ private:
     // Must be called with the m_properties_mutex held for write.
     void CalculateCurrentURL(const std::string &value) const;
 
+    // Install a new put operation; takes m_properties_mutex as GetProperty()
+    // reports the ETag of the operation.
+    void SetPutOp(std::shared_ptr<XrdClHttp::CurlPutOp> op);
+
     bool m_is_opened{false};
     std::atomic<bool> m_full_download{false}; // Whether the file was in "full download mode" when opened.
 
@@ -204,7 +208,8 @@ private:
     //
     // This shared pointer is also copied to the queue and kept
     // by the curl worker thread.  We will need to refer to the
-    // operation later to continue the write.
+    // operation later to continue the write.  Replaced under
+    // m_properties_mutex (see SetPutOp()).
     std::shared_ptr<XrdClHttp::CurlPutOp> m_put_op;
 
     // A response handler for PUT operations that ensures multiple writes are serialized.
@@ -23,6 +23,8 @@
 #include "XrdClHttpOps.hh"
 #include "XrdClHttpResponses.hh"
 
+#include <sstream>
+
 using namespace XrdClHttp;
 
 Filesystem::Filesystem(const std::string &url, std::shared_ptr<HandlerQueue> queue, XrdCl::Log *log)
@@ -93,6 +95,13 @@ bool
 Filesystem::GetProperty(const std::string &name,
                         std::string       &value) const
 {
+    if (name == "XrdClHttpPost") {
+        std::stringstream ss;
+        ss << std::hex << reinterpret_cast<long long>(static_cast<const Post*>(this));
+        value = ss.str();
+        return true;
+    }
+
     std::shared_lock lock(m_properties_mutex);
 
     const auto p = m_properties.find(name);
@@ -225,6 +234,33 @@ XrdCl::XRootDStatus Filesystem::Query(XrdCl::QueryCode::Code  queryCode,
     return XrdCl::XRootDStatus();
 }
 
+XrdCl::XRootDStatus
+Filesystem::DoPost(const std::string      &path,
+                   const std::string      &body,
+                   XrdCl::ResponseHandler *handler,
+                   time_t                  timeout)
+{
+    auto ts = XrdClHttp::Factory::GetHeaderTimeoutWithDefault(timeout);
+
+    auto url = GetCurrentURL(path);
+    m_logger->Debug(kLogXrdClHttp, "Filesystem::DoPost to %s (%zu byte body)", url.c_str(), body.size());
+
+    std::unique_ptr<CurlPostOp> postOp(
+        new CurlPostOp(
+            handler, url, std::string(body), ts, m_logger, SendResponseInfo(),
+            GetConnCallout(), m_header_callout.load(std::memory_order_acquire)
+        )
+    );
+    try {
+        m_queue->Produce(std::move(postOp));
+    } catch (...) {
+        m_logger->Warning(kLogXrdClHttp, "Failed to add filesystem post op to queue");
+        return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errOSError);
+    }
+
+    return XrdCl::XRootDStatus();
+}
+
 XrdCl::XRootDStatus
 Filesystem::Rm(const std::string      &path,
                XrdCl::ResponseHandler *handler,
@@ -23,6 +23,7 @@
 
 #include "XrdClHttpConnectionCallout.hh"
 #include "XrdClHttpHeaderCallout.hh"
+#include "XrdClHttpPost.hh"
 
 #include <XrdCl/XrdClFileSystem.hh>
 #include <XrdCl/XrdClLog.hh>
@@ -45,7 +46,7 @@ namespace XrdClHttp {
 
 class HandlerQueue;
 
-class Filesystem final : public XrdCl::FileSystemPlugIn {
+class Filesystem final : public XrdCl::FileSystemPlugIn, public Post {
 public:
     Filesystem(const std::string &, std::shared_ptr<HandlerQueue> queue, XrdCl::Log *log);
 
@@ -85,11 +86,19 @@ public:
                                      XrdCl::ResponseHandler *handler,
                                      time_t                  timeout) override;
 
+    // Supported query codes are Checksum and XAttr.
     virtual XrdCl::XRootDStatus Query(XrdCl::QueryCode::Code  queryCode,
                                       const XrdCl::Buffer     &arg,
                                       XrdCl::ResponseHandler  *handler,
                                       time_t                   timeout) override;
 
+    // Send a POST to `path`; see XrdClHttpPost.hh.  Reached by other plugins
+    // through the `XrdClHttpPost` property.
+    virtual XrdCl::XRootDStatus DoPost(const std::string      &path,
+                                       const std::string      &body,
+                                       XrdCl::ResponseHandler *handler,
+                                       time_t                  timeout) override;
+
 private:
     // Return a function pointer to the connection callout
     // Returns nullptr if this file isn't using the callout
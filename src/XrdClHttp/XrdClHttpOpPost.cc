@@ -0,0 +1,101 @@
+/******************************************************************************/
+/* Copyright (C) 2025, Pelican Project, Morgridge Institute for Research      */
+/*                                                                            */
+/* This file is part of the XrdClHttp client plugin for XRootD.               */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+
+#include "XrdClHttpOps.hh"
+#include "XrdClHttpResponses.hh"
+
+#include <XrdCl/XrdClLog.hh>
+#include <XrdCl/XrdClXRootDResponses.hh>
+
+using namespace XrdClHttp;
+
+CurlPostOp::CurlPostOp(XrdCl::ResponseHandler *handler, const std::string &url, std::string &&body,
+    struct timespec timeout, XrdCl::Log *logger, bool response_info,
+    CreateConnCalloutType callout, HeaderCallout *header_callout) :
+    CurlOperation(handler, url, timeout, logger, callout, header_callout),
+    m_response_info(response_info),
+    m_body(std::move(body))
+{}
+
+bool
+CurlPostOp::Setup(CURL *curl, CurlWorker &worker)
+{
+    if (!CurlOperation::Setup(curl, worker)) return false;
+    curl_easy_setopt(m_curl.get(), CURLOPT_POST, 1L);
+    curl_easy_setopt(m_curl.get(), CURLOPT_POSTFIELDS, m_body.data());
+    curl_easy_setopt(m_curl.get(), CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(m_body.size()));
+    curl_easy_setopt(m_curl.get(), CURLOPT_WRITEFUNCTION, CurlPostOp::WriteCallback);
+    curl_easy_setopt(m_curl.get(), CURLOPT_WRITEDATA, this);
+    // Otherwise libcurl labels the body as a submitted form.
+    m_headers_list.emplace_back("Content-Type", "application/octet-stream");
+
+    return true;
+}
+
+void
+CurlPostOp::ReleaseHandle()
+{
+    if (m_curl == nullptr) return;
+    curl_easy_setopt(m_curl.get(), CURLOPT_WRITEFUNCTION, nullptr);
+    curl_easy_setopt(m_curl.get(), CURLOPT_WRITEDATA, nullptr);
+    curl_easy_setopt(m_curl.get(), CURLOPT_POSTFIELDS, nullptr);
+    curl_easy_setopt(m_curl.get(), CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(-1));
+    // Switch the reused handle back to the default GET request.
+    curl_easy_setopt(m_curl.get(), CURLOPT_HTTPGET, 1L);
+    curl_easy_setopt(m_curl.get(), CURLOPT_HTTPHEADER, nullptr);
+    CurlOperation::ReleaseHandle();
+}
+
+size_t
+CurlPostOp::WriteCallback(char *buffer, size_t size, size_t nitems, void *this_ptr)
+{
+    auto me = static_cast<CurlPostOp*>(this_ptr);
+    if (size * nitems + me->m_response.size() > 10'000'000) {
+        return me->FailCallback(kXR_ServerError, "Response too large for POST operation");
+    }
+    me->UpdateBytes(size * nitems);
+    me->m_response.append(buffer, size * nitems);
+    return size * nitems;
+}
+
+void
+CurlPostOp::Success()
+{
+    SetDone(false);
+    m_logger->Debug(kLogXrdClHttp, "CurlPostOp::Success");
+    if (m_handler == nullptr) {return;}
+
+    XrdCl::Buffer *buf;
+    if (m_response_info) {
+        auto info = new XrdClHttp::QueryResponse();
+        info->SetResponseInfo(MoveResponseInfo());
+        buf = info;
+    } else {
+        buf = new XrdCl::Buffer();
+    }
+    buf->FromString(m_response);
+    auto obj = new XrdCl::AnyObject();
+    obj->Set(buf);
+
+    auto handle = m_handler;
+    m_handler = nullptr;
+    handle->HandleResponse(new XrdCl::XRootDStatus(), obj);
+}
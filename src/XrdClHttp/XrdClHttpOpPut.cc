@@ -119,6 +119,7 @@ CurlPutOp::Success()
         m_logger->Warning(kLogXrdClHttp, "Put operation succeeded with no callback handler");
         return;
     }
+    m_etag = m_headers.GetETag();
     auto status = new XrdCl::XRootDStatus();
     auto handle = m_handler;
     m_handler = nullptr;
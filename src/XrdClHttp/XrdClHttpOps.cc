@@ -259,6 +259,8 @@ CurlOperation::GetVerbString(CurlOperation::HttpVerb verb)
         return "MKCOL";
     case HttpVerb::OPTIONS:
         return "OPTIONS";
+    case HttpVerb::POST:
+        return "POST";
     case HttpVerb::PROPFIND:
         return "PROPFIND";
     case HttpVerb::PUT:
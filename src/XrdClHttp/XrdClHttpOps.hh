@@ -64,6 +64,7 @@ public:
         GET,
         MKCOL,
         OPTIONS,
+        POST,
         PROPFIND,
         PUT,
         Count
@@ -902,6 +903,10 @@ public:
 
     virtual HttpVerb GetVerb() const override {return HttpVerb::PUT;}
 
+    // The ETag the server returned for the uploaded object; empty until
+    // the operation has succeeded.
+    const std::string &GetETag() const {return m_etag;}
+
 private:
 
     // Callback function for libcurl when it would like to read data from m_data
@@ -933,6 +938,42 @@ private:
     off_t m_object_size{-1};
 
     bool m_final{false};
+
+    // ETag from the response headers, recorded on success
+    std::string m_etag;
+};
+
+// Operation issuing a POST request with an in-memory body.
+//
+// The response body is handed back to the caller as a XrdCl::Buffer; this
+// is meant for small control requests (such as those starting or finishing
+// a S3 multipart upload), not for bulk data.
+class CurlPostOp final : public CurlOperation {
+public:
+    CurlPostOp(XrdCl::ResponseHandler *handler, const std::string &url, std::string &&body,
+        struct timespec timeout, XrdCl::Log *logger, bool response_info,
+        CreateConnCalloutType callout, HeaderCallout *header_callout);
+
+    virtual ~CurlPostOp() {}
+
+    bool Setup(CURL *curl, CurlWorker &) override;
+    void Success() override;
+    void ReleaseHandle() override;
+
+    virtual HttpVerb GetVerb() const override {return HttpVerb::POST;}
+
+private:
+    // Callback for writing the response body to the internal buffer.
+    static size_t WriteCallback(char *buffer, size_t size, size_t nitems, void *this_ptr);
+
+    // Indicate whether the operation should use the extended "response info" object in response
+    const bool m_response_info{false};
+
+    // Request body; must outlive the transfer as libcurl does not copy it.
+    std::string m_body;
+
+    // Response body from the POST request.
+    std::string m_response;
 };
 
 } // namespace XrdClHttp
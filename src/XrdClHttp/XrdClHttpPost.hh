@@ -0,0 +1,39 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Morgridge Institute for Research
+ *
+ ***************************************************************/
+
+#ifndef XRDCLHTTP_POST_HH
+#define XRDCLHTTP_POST_HH
+
+#include <XrdCl/XrdClXRootDResponses.hh>
+
+#include <ctime>
+#include <string>
+
+namespace XrdClHttp {
+
+// The XrdCl API has no request that maps onto an HTTP POST, so it is offered
+// to other plugins (e.g. XrdClS3 for its multipart uploads) as an internal
+// call on the HTTP filesystem.
+//
+// Reading the property `XrdClHttpPost` of an `XrdCl::FileSystem` backed by
+// the HTTP plugin gives the serialized hex value of a pointer to this
+// interface; it is valid for as long as that `XrdCl::FileSystem` object.
+class Post {
+public:
+    virtual ~Post() noexcept = default;
+
+    // Send a POST with `body` to `path` (which may carry a query string),
+    // relative to the filesystem URL.  On success, the response body is
+    // handed to `handler` as a XrdCl::Buffer.
+    virtual XrdCl::XRootDStatus DoPost(const std::string      &path,
+                                       const std::string      &body,
+                                       XrdCl::ResponseHandler *handler,
+                                       time_t                  timeout) = 0;
+};
+
+}
+
+#endif // XRDCLHTTP_POST_HH
@@ -29,6 +29,9 @@
 
 #include <fcntl.h>
 
+#include <algorithm>
+#include <charconv>
+
 XrdVERSIONINFO(XrdClGetPlugIn, XrdClGetPlugIn)
 
 using namespace XrdClS3;
@@ -42,6 +45,9 @@ std::string Factory::m_service = "s3";
 std::string Factory::m_region = "";
 std::string Factory::m_url_style = "path";
 std::string Factory::m_mkdir_sentinel;
+uint64_t Factory::m_part_size = Factory::kDefaultPartSize;
+unsigned Factory::m_parallelism = 4;
+uint64_t Factory::m_read_split_size = 8 * 1024 * 1024;
 Factory::Credentials Factory::m_default_creds;
 std::unordered_map<std::string, Factory::Credentials> Factory::m_bucket_location_map;
 std::unordered_map<std::string, std::pair<Factory::Credentials, std::chrono::steady_clock::time_point>> Factory::m_bucket_auth_map;
@@ -194,6 +200,24 @@ void SetDefault(XrdCl::Env *env, const std::string &optName, const std::string &
     }
 }
 
+// Like SetDefault but for a non-negative integer option; an unparseable value
+// keeps the default.
+void SetDefaultInt(XrdCl::Env *env, XrdCl::Log *log, const std::string &optName, const std::string &envName, uint64_t &value, uint64_t def) {
+    std::string val;
+    SetDefault(env, optName, envName, val, "");
+    value = def;
+    if (val.empty()) {
+        return;
+    }
+    uint64_t parsed;
+    auto ec = std::from_chars(val.c_str(), val.c_str() + val.size(), parsed);
+    if (ec.ec != std::errc() || ec.ptr != val.c_str() + val.size()) {
+        log->Warning(kLogXrdClS3, "Ignoring invalid value for %s: %s", optName.c_str(), val.c_str());
+        return;
+    }
+    value = parsed;
+}
+
 // Trim the left side of a string_view for space
 std::string_view ltrim_view(const std::string_view input_view) {
     for (size_t idx = 0; idx < input_view.size(); idx++) {
@@ -357,6 +381,21 @@ Factory::InitS3Config()
     SetDefault(env, "XrdClS3Endpoint", "XRDCLS3_ENDPOINT", m_endpoint, "");
     SetDefault(env, "XrdClS3UrlStyle", "XRDCLS3_URLSTYLE", m_url_style, "path");
     SetDefault(env, "XrdClS3Region", "XRDCLS3_REGION", m_region, "");
+
+    // Uploads larger than a part are sent as S3 multipart uploads (0 disables);
+    // parts other than the last one must be at least 5MB.
+    SetDefaultInt(env, m_log, "XrdClS3PartSize", "XRDCLS3_PARTSIZE", m_part_size, kDefaultPartSize);
+    if (m_part_size && m_part_size < kMinPartSize) {
+        m_log->Warning(kLogXrdClS3, "Part size %llu is below the S3 minimum; using %llu",
+            static_cast<unsigned long long>(m_part_size), static_cast<unsigned long long>(kMinPartSize));
+        m_part_size = kMinPartSize;
+    }
+    // Number of parts uploaded, or ranges downloaded, at once for a single file.
+    uint64_t parallelism;
+    SetDefaultInt(env, m_log, "XrdClS3Parallelism", "XRDCLS3_PARALLELISM", parallelism, 4);
+    m_parallelism = std::max<uint64_t>(1, std::min<uint64_t>(parallelism, 64));
+    // Reads of at least twice this size are split into parallel ranged GETs (0 disables).
+    SetDefaultInt(env, m_log, "XrdClS3ReadSplitSize", "XRDCLS3_READSPLITSIZE", m_read_split_size, 8 * 1024 * 1024);
     std::string access_key;
     SetDefault(env, "XrdClS3AccessKeyLocation", "XRDCLS3_ACCESSKEYLOCATION", access_key, "");
     std::string secret_key;
@@ -80,12 +80,27 @@ public:
 
     static const std::string &GetMkdirSentinel() {return m_mkdir_sentinel;}
 
+    // Size of the parts of a multipart upload; 0 if multipart uploads are disabled.
+    static uint64_t GetPartSize() {return m_part_size;}
+
+    // Maximum number of concurrent part uploads or ranged reads per file.
+    static unsigned GetParallelism() {return m_parallelism;}
+
+    // Minimum size of each piece when splitting a large read; 0 if reads are never split.
+    static uint64_t GetReadSplitSize() {return m_read_split_size;}
+
+    static constexpr uint64_t kMinPartSize = 5 * 1024 * 1024;
+    static constexpr uint64_t kDefaultPartSize = 16 * 1024 * 1024;
+
     // Setters for the S3 endpoint, service, region, and URL style.
     // Intended to be used for testing or configuration purposes.
     static void SetEndpoint(const std::string &endpoint) { m_endpoint = endpoint; }
     static void SetService(const std::string &service) { m_service = service; }
     static void SetRegion(const std::string &region) { m_region = region; }
     static void SetUrlStyle(const std::string &url_style) { m_url_style = url_style; }
+    static void SetPartSize(uint64_t part_size) { m_part_size = part_size; }
+    static void SetParallelism(unsigned parallelism) { m_parallelism = parallelism ? parallelism : 1; }
+    static void SetReadSplitSize(uint64_t split_size) { m_read_split_size = split_size; }
     static void SetDefaultCredentials(const std::string &access_key, const std::string &secret_key) {
         m_default_creds.m_accesskey = access_key;
         m_default_creds.m_secretkey = secret_key;
@@ -124,6 +139,11 @@ private:
     // it; this static variable controls the name.
     static std::string m_mkdir_sentinel;
 
+    // Multipart upload and parallel read tuning; see the getters above.
+    static uint64_t m_part_size;
+    static unsigned m_parallelism;
+    static uint64_t m_read_split_size;
+
     // Struct describing S3 credentials
     struct Credentials {
         std::string m_accesskey;
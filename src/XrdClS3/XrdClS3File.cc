@@ -20,8 +20,14 @@
 
 #include "XrdClS3Factory.hh"
 #include "XrdClS3File.hh"
+#include "XrdClS3MultipartUpload.hh"
 
 #include <XrdCl/XrdClLog.hh>
+#include <XrdCl/XrdClURL.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 
 using namespace XrdClS3;
 
@@ -80,6 +86,95 @@ private:
     XrdCl::ResponseHandler *m_handler;
 };
 
+// Collects the pieces of a read split into parallel ranged GETs and answers
+// the caller once all of them are back.
+class SplitReadHandler {
+public:
+    SplitReadHandler(uint64_t offset, char *buffer, size_t pieces, XrdCl::ResponseHandler *handler)
+        : m_offset(offset),
+          m_buffer(buffer),
+          m_lengths(pieces),
+          m_remaining(pieces),
+          m_handler(handler)
+    {}
+
+    // Handler for piece `idx`, starting at `offset` and asking for `size` bytes.
+    class PieceHandler : public XrdCl::ResponseHandler {
+    public:
+        PieceHandler(SplitReadHandler &parent, size_t idx, uint32_t size)
+            : m_parent(parent), m_idx(idx), m_size(size)
+        {}
+
+        virtual void HandleResponse(XrdCl::XRootDStatus *status, XrdCl::AnyObject *response) override {
+            std::unique_ptr<PieceHandler> owner(this);
+            std::unique_ptr<XrdCl::XRootDStatus> st(status);
+            std::unique_ptr<XrdCl::AnyObject> resp(response);
+
+            uint32_t length = 0;
+            if (st && st->IsOK() && resp) {
+                XrdCl::ChunkInfo *ci = nullptr;
+                resp->Get(ci);
+                if (ci) length = ci->GetLength();
+            }
+            m_parent.PieceDone(m_idx, m_size, length, st ? *st : XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInternal));
+        }
+
+    private:
+        SplitReadHandler &m_parent;
+        const size_t m_idx;
+        const uint32_t m_size;
+    };
+
+    void PieceDone(size_t idx, uint32_t size, uint32_t length, const XrdCl::XRootDStatus &status) {
+        {
+            std::unique_lock lock(m_mutex);
+            if (!status.IsOK() && m_status.IsOK()) {
+                m_status = status;
+            }
+            // A short piece ends the data; anything after it is not returned.
+            m_lengths[idx] = std::make_pair(length, length == size);
+        }
+        if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Finish();
+        }
+    }
+
+private:
+    void Finish() {
+        std::unique_ptr<SplitReadHandler> owner(this);
+        if (!m_status.IsOK()) {
+            if (m_handler) m_handler->HandleResponse(new XrdCl::XRootDStatus(m_status), nullptr);
+            return;
+        }
+        uint32_t total = 0;
+        for (const auto &[length, full] : m_lengths) {
+            total += length;
+            if (!full) break;
+        }
+        if (m_handler) {
+            auto obj = new XrdCl::AnyObject();
+            obj->Set(new XrdCl::ChunkInfo(m_offset, total, m_buffer));
+            m_handler->HandleResponse(new XrdCl::XRootDStatus{}, obj);
+        }
+    }
+
+    const uint64_t m_offset;
+    char *m_buffer;
+    std::mutex m_mutex;
+    XrdCl::XRootDStatus m_status;
+    std::vector<std::pair<uint32_t, bool>> m_lengths;
+    std::atomic<size_t> m_remaining;
+    XrdCl::ResponseHandler *m_handler;
+};
+
+// The object of a multipart upload only exists once the upload is completed
+// on close; until then there is nothing to read or stat.
+XrdCl::XRootDStatus
+MultipartNotSupported(const char *op) {
+    return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errNotSupported, 0,
+        std::string("Cannot ") + op + " an object while its multipart upload is in progress");
+}
+
 } // namespace
 
 File::File(XrdCl::Log *log) :
@@ -94,6 +189,15 @@ XrdCl::XRootDStatus
 File::Close(XrdCl::ResponseHandler *handler,
             time_t                  timeout)
 {
+    if (m_upload) {
+        if (!m_is_opened) {
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp);
+        }
+        std::unique_ptr<CloseResponseHandler> close_handler(new CloseResponseHandler(&m_is_opened, handler));
+        auto st = m_upload->Close(close_handler.get(), timeout);
+        if (st.IsOK()) close_handler.release();
+        return st;
+    }
     return m_wrapped_file->Close(new CloseResponseHandler(&m_is_opened, handler), timeout);
 }
 
@@ -107,6 +211,10 @@ bool
 File::GetProperty(const std::string &name,
                   std::string &value) const
 {
+    // The object being uploaded does not exist yet, so it has no properties.
+    if (m_upload) {
+        return false;
+    }
     std::unique_lock lock(m_properties_mutex);
     const auto p = m_properties.find(name);
     if (p == std::end(m_properties)) {
@@ -184,6 +292,38 @@ File::Open(const std::string      &url,
         return st;
     }
 
+    // Objects known to fit in one part keep the plain streaming PUT.  Any
+    // of the write flags opens for upload; xrdcp uses Update with New or Delete.
+    m_upload.reset();
+    auto part_size = Factory::GetPartSize();
+    const auto write_flags = XrdCl::OpenFlags::Write | XrdCl::OpenFlags::Update |
+                             XrdCl::OpenFlags::New | XrdCl::OpenFlags::Delete;
+    if ((flags & write_flags) && part_size) {
+        XrdCl::URL parsed_url;
+        long long asize = -1;
+        if (parsed_url.FromString(url)) {
+            auto iter = parsed_url.GetParams().find("oss.asize");
+            if (iter != parsed_url.GetParams().end()) {
+                const auto &val = iter->second;
+                auto ec = std::from_chars(val.c_str(), val.c_str() + val.size(), asize);
+                if (ec.ec != std::errc() || ec.ptr != val.c_str() + val.size()) asize = -1;
+            }
+        }
+        if (asize < 0 || static_cast<uint64_t>(asize) > part_size) {
+            m_logger->Debug(kLogXrdClS3, "Opening %s for multipart upload", https_url.c_str());
+            m_upload = std::make_shared<MultipartUpload>(https_url.substr(0, https_url.find('?')), m_logger);
+            m_open_flags = flags;
+            std::unique_ptr<OpenResponseHandler> open_handler(new OpenResponseHandler(&m_is_opened, handler));
+            auto st = m_upload->Open(flags & XrdCl::OpenFlags::New, open_handler.get(), timeout);
+            if (st.IsOK()) {
+                open_handler.release();
+            } else {
+                m_upload.reset();
+            }
+            return st;
+        }
+    }
+
     return fs->Open(https_url, flags, mode, new OpenResponseHandler(&m_is_opened, handler), timeout);
 }
 
@@ -194,6 +334,9 @@ File::PgRead(uint64_t                offset,
              XrdCl::ResponseHandler *handler,
              time_t                  timeout)
 {
+    if (m_upload) {
+        return MultipartNotSupported("read");
+    }
     return m_wrapped_file->PgRead(offset, size, buffer, handler, timeout);
 }
 
@@ -204,8 +347,46 @@ File::Read(uint64_t                offset,
            XrdCl::ResponseHandler *handler,
            time_t                  timeout)
 {
-
-    return m_wrapped_file->Read(offset, size, buffer, handler, timeout);
+    if (m_upload) {
+        return MultipartNotSupported("read");
+    }
+    // Large reads are split into ranged GETs run in parallel by the curl
+    // workers, as a single stream rarely fills the path to an object store.
+    auto split_size = Factory::GetReadSplitSize();
+    auto parallelism = Factory::GetParallelism();
+    std::string length_str;
+    uint64_t length;
+    if (!split_size || parallelism < 2 || size < 2 * split_size ||
+        !m_wrapped_file->GetProperty("ContentLength", length_str) ||
+        std::from_chars(length_str.c_str(), length_str.c_str() + length_str.size(), length).ec != std::errc() ||
+        offset >= length)
+    {
+        return m_wrapped_file->Read(offset, size, buffer, handler, timeout);
+    }
+    // Pieces past the end of the object would only fail.
+    uint32_t to_read = std::min<uint64_t>(size, length - offset);
+    size_t pieces = std::min<uint64_t>(parallelism, to_read / split_size);
+    if (pieces < 2) {
+        return m_wrapped_file->Read(offset, size, buffer, handler, timeout);
+    }
+    uint32_t piece_size = (to_read + pieces - 1) / pieces;
+    pieces = (to_read + piece_size - 1) / piece_size;
+    m_logger->Debug(kLogXrdClS3, "Splitting read of %u bytes at offset %llu into %zu pieces",
+        to_read, static_cast<unsigned long long>(offset), pieces);
+
+    auto collector = new SplitReadHandler(offset, static_cast<char *>(buffer), pieces, handler);
+    for (size_t idx = 0; idx < pieces; idx++) {
+        uint32_t piece_off = idx * piece_size;
+        uint32_t piece_len = std::min(piece_size, to_read - piece_off);
+        std::unique_ptr<SplitReadHandler::PieceHandler> piece(new SplitReadHandler::PieceHandler(*collector, idx, piece_len));
+        auto st = m_wrapped_file->Read(offset + piece_off, piece_len, static_cast<char *>(buffer) + piece_off, piece.get(), timeout);
+        if (st.IsOK()) {
+            piece.release();
+        } else {
+            collector->PieceDone(idx, piece_len, 0, st);
+        }
+    }
+    return XrdCl::XRootDStatus{};
 }
 
 bool
@@ -222,6 +403,9 @@ File::Stat(bool                    force,
            XrdCl::ResponseHandler *handler,
            time_t                  timeout)
 {
+    if (m_upload) {
+        return MultipartNotSupported("stat");
+    }
     return m_wrapped_file->Stat(force, handler, timeout);
 }
 
@@ -231,6 +415,9 @@ File::VectorRead(const XrdCl::ChunkList &chunks,
                  XrdCl::ResponseHandler *handler,
                  time_t                  timeout )
 {
+    if (m_upload) {
+        return MultipartNotSupported("read");
+    }
     return m_wrapped_file->VectorRead(chunks, buffer, handler, timeout);
 }
 
@@ -241,6 +428,9 @@ File::Write(uint64_t            offset,
             XrdCl::ResponseHandler *handler,
             time_t                  timeout)
 {
+    if (m_upload) {
+        return m_upload->Write(offset, size, buffer, handler, timeout);
+    }
     return m_wrapped_file->Write(offset, size, buffer, handler, timeout);
 }
 
@@ -250,6 +440,10 @@ File::Write(uint64_t             offset,
             XrdCl::ResponseHandler  *handler,
             time_t                   timeout)
 {
+    if (m_upload) {
+        // The data is copied before the call returns.
+        return m_upload->Write(offset, buffer.GetSize(), buffer.GetBuffer(), handler, timeout);
+    }
     return m_wrapped_file->Write(offset, std::move(buffer), handler, timeout);
 }
 
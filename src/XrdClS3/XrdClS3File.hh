@@ -33,6 +33,8 @@ class Log;
 
 namespace XrdClS3 {
 
+class MultipartUpload;
+
 class File final : public XrdCl::FilePlugIn {
 public:
     File(XrdCl::Log *log);
@@ -101,6 +103,11 @@ private:
 
     std::unique_ptr<XrdCl::File> m_wrapped_file;
 
+    // Set when the file is opened for writing an object that may not fit in
+    // a single part; writes then go through the multipart upload rather than
+    // the wrapped file, which is never opened.
+    std::shared_ptr<MultipartUpload> m_upload;
+
     // Given a path, provide the corresponding HTTP file handle.
     std::tuple<XrdCl::XRootDStatus, std::string, XrdCl::File*> GetFileHandle(const std::string &url);
 
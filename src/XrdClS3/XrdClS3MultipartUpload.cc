@@ -0,0 +1,625 @@
+/******************************************************************************/
+/* Copyright (C) 2025, Pelican Project, Morgridge Institute for Research      */
+/*                                                                            */
+/* This file is part of the XrdClS3 client plugin for XRootD.                 */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+
+#include "XrdClS3Factory.hh"
+#include "XrdClS3MultipartUpload.hh"
+
+#include <XrdCl/XrdClFile.hh>
+#include <XrdCl/XrdClFileSystem.hh>
+#include <XrdCl/XrdClLog.hh>
+
+#include <tinyxml.h>
+
+#include <algorithm>
+#include <sstream>
+
+using namespace XrdClS3;
+
+namespace {
+
+// Return the text of the first `name` child of `elem`, or an empty string.
+std::string ChildText(TiXmlElement *elem, const char *name) {
+    auto child = elem ? elem->FirstChildElement(name) : nullptr;
+    return (child && child->GetText()) ? child->GetText() : "";
+}
+
+// Parse a S3 response body.  S3 may report errors with a 200 status and an
+// <Error> document, so the root element is checked against `expected`.
+XrdCl::XRootDStatus ParseResponse(XrdCl::AnyObject *response, const char *expected, TiXmlDocument &doc) {
+    XrdCl::Buffer *buf = nullptr;
+    if (response) response->Get(buf);
+    if (!buf) {
+        return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidResponse, 0, "No response body from S3 service");
+    }
+    auto body = buf->ToString();
+    doc.Parse(body.c_str());
+    auto root = doc.RootElement();
+    if (!root) {
+        return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidResponse, 0, "Unable to parse S3 response");
+    }
+    if (!strcmp(root->Value(), "Error")) {
+        return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errErrorResponse, kXR_ServerError,
+            ChildText(root, "Code") + ": " + ChildText(root, "Message"));
+    }
+    if (strcmp(root->Value(), expected)) {
+        return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidResponse, 0,
+            std::string("Unexpected S3 response element ") + root->Value());
+    }
+    return XrdCl::XRootDStatus{};
+}
+
+} // namespace
+
+// Sends one part: open a HTTP file handle, PUT the data, close it and hand
+// the ETag back to the upload.
+class MultipartUpload::PartHandler : public XrdCl::ResponseHandler {
+public:
+    PartHandler(std::shared_ptr<MultipartUpload> upload, Part &&part, const std::string &upload_id, time_t timeout)
+        : m_upload(upload), m_part(std::move(part)), m_upload_id(upload_id), m_timeout(timeout)
+    {}
+
+    virtual ~PartHandler() noexcept = default;
+
+    XrdCl::XRootDStatus Start() {
+        // The size is known up front, so the PUT carries a Content-Length.
+        auto url = m_upload->m_url + "?oss.asize=" + std::to_string(m_part.m_data.size());
+        m_file.reset(new XrdCl::File());
+        // Force creation of the plugin object so the header callout can be set before the open.
+        auto st = m_file->Open(url, XrdCl::OpenFlags::Compress, XrdCl::Access::None, nullptr, time_t(0));
+        if (!st.IsOK()) {
+            return st;
+        }
+        std::stringstream ss;
+        ss << std::hex << reinterpret_cast<long long>(&m_upload->m_header_callout);
+        if (!m_file->SetProperty("XrdClHttpHeaderCallout", ss.str())) {
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidAddr, 0, "Failed to setup header callout");
+        }
+        return m_file->Open(url, XrdCl::OpenFlags::Write, XrdCl::Access::None, this, m_timeout);
+    }
+
+    virtual void HandleResponse(XrdCl::XRootDStatus *status_raw, XrdCl::AnyObject *response_raw) override {
+        std::unique_ptr<PartHandler> self(this);
+        std::unique_ptr<XrdCl::XRootDStatus> status(status_raw);
+        std::unique_ptr<XrdCl::AnyObject> response(response_raw);
+
+        XrdCl::XRootDStatus st;
+        switch (m_stage) {
+        case Stage::Open:
+            if (!status->IsOK()) {
+                Done(*status);
+                return;
+            }
+            // The open probes the plain object; only the upload itself targets the part.
+            if (m_part.m_number) {
+                m_file->SetProperty("XrdClHttpQueryParam",
+                    "partNumber=" + std::to_string(m_part.m_number) + "&uploadId=" + m_upload_id);
+            }
+            if (m_part.m_data.empty()) {
+                m_stage = Stage::Close;
+                st = m_file->Close(this, m_timeout);
+            } else {
+                m_stage = Stage::Write;
+                st = m_file->Write(0, m_part.m_data.size(), m_part.m_data.data(), this, m_timeout);
+            }
+            break;
+        case Stage::Write:
+            m_write_status = *status;
+            if (status->IsOK()) {
+                m_file->GetProperty("ETag", m_etag);
+            }
+            m_stage = Stage::Close;
+            st = m_file->Close(this, m_timeout);
+            break;
+        case Stage::Close:
+            if (!m_write_status.IsOK()) {
+                Done(m_write_status);
+            } else if (!status->IsOK()) {
+                Done(*status);
+            } else if (m_part.m_number && m_etag.empty()) {
+                Done(XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidResponse, 0,
+                    "S3 service returned no ETag for part " + std::to_string(m_part.m_number)));
+            } else {
+                Done(XrdCl::XRootDStatus{});
+            }
+            return;
+        }
+        if (st.IsOK()) {
+            self.release();
+        } else {
+            Done(m_write_status.IsOK() ? st : m_write_status);
+        }
+    }
+
+private:
+    void Done(const XrdCl::XRootDStatus &status) {
+        m_part.m_data = std::vector<char>();
+        m_upload->PartDone(m_part.m_number, status, m_etag);
+    }
+
+    enum class Stage {Open, Write, Close};
+
+    std::shared_ptr<MultipartUpload> m_upload;
+    Part m_part;
+    const std::string m_upload_id;
+    const time_t m_timeout;
+    Stage m_stage{Stage::Open};
+    std::unique_ptr<XrdCl::File> m_file;
+    XrdCl::XRootDStatus m_write_status;
+    std::string m_etag;
+};
+
+// Turns the HEAD of the object into the result of the open: a missing object
+// is what a new upload expects, an existing one is only refused for New.
+class MultipartUpload::OpenHandler : public XrdCl::ResponseHandler {
+public:
+    OpenHandler(std::shared_ptr<MultipartUpload> upload, bool exclusive, XrdCl::ResponseHandler *handler)
+        : m_upload(upload), m_exclusive(exclusive), m_handler(handler)
+    {}
+
+    virtual void HandleResponse(XrdCl::XRootDStatus *status_raw, XrdCl::AnyObject *response_raw) override {
+        std::unique_ptr<OpenHandler> self(this);
+        std::unique_ptr<XrdCl::XRootDStatus> status(status_raw);
+        std::unique_ptr<XrdCl::AnyObject> response(response_raw);
+
+        XrdCl::XRootDStatus st;
+        if (status->IsOK()) {
+            if (m_exclusive) {
+                st = XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errErrorResponse, kXR_ItExists,
+                    "Object already exists");
+            }
+        } else if (status->code != XrdCl::errErrorResponse || status->errNo != kXR_NotFound) {
+            st = *status;
+        }
+        if (!st.IsOK()) {
+            m_upload->m_logger->Error(kLogXrdClS3, "Cannot open %s for multipart upload: %s",
+                m_upload->m_url.c_str(), st.ToString().c_str());
+        }
+        if (m_handler) m_handler->HandleResponse(new XrdCl::XRootDStatus(st), nullptr);
+    }
+
+private:
+    std::shared_ptr<MultipartUpload> m_upload;
+    const bool m_exclusive;
+    XrdCl::ResponseHandler *m_handler;
+};
+
+class MultipartUpload::CreateHandler : public XrdCl::ResponseHandler {
+public:
+    CreateHandler(std::shared_ptr<MultipartUpload> upload) : m_upload(upload) {}
+
+    virtual void HandleResponse(XrdCl::XRootDStatus *status_raw, XrdCl::AnyObject *response_raw) override {
+        std::unique_ptr<CreateHandler> self(this);
+        std::unique_ptr<XrdCl::XRootDStatus> status(status_raw);
+        std::unique_ptr<XrdCl::AnyObject> response(response_raw);
+
+        if (!status->IsOK()) {
+            m_upload->CreateDone(*status, "");
+            return;
+        }
+        TiXmlDocument doc;
+        auto st = ParseResponse(response.get(), "InitiateMultipartUploadResult", doc);
+        std::string upload_id;
+        if (st.IsOK()) {
+            upload_id = ChildText(doc.RootElement(), "UploadId");
+            if (upload_id.empty()) {
+                st = XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidResponse, 0, "S3 service returned no upload ID");
+            }
+        }
+        m_upload->CreateDone(st, upload_id);
+    }
+
+private:
+    std::shared_ptr<MultipartUpload> m_upload;
+};
+
+class MultipartUpload::CompleteHandler : public XrdCl::ResponseHandler {
+public:
+    CompleteHandler(std::shared_ptr<MultipartUpload> upload) : m_upload(upload) {}
+
+    virtual void HandleResponse(XrdCl::XRootDStatus *status_raw, XrdCl::AnyObject *response_raw) override {
+        std::unique_ptr<CompleteHandler> self(this);
+        std::unique_ptr<XrdCl::XRootDStatus> status(status_raw);
+        std::unique_ptr<XrdCl::AnyObject> response(response_raw);
+
+        XrdCl::XRootDStatus st = *status;
+        if (st.IsOK()) {
+            TiXmlDocument doc;
+            st = ParseResponse(response.get(), "CompleteMultipartUploadResult", doc);
+        }
+        if (st.IsOK()) {
+            m_upload->FinishClose(st);
+            return;
+        }
+        m_upload->m_logger->Error(kLogXrdClS3, "Failed to complete multipart upload of %s: %s",
+            m_upload->m_url.c_str(), st.ToString().c_str());
+        {
+            std::unique_lock lock(m_upload->m_mutex);
+            m_upload->m_status = st;
+            m_upload->m_finishing = false;
+        }
+        m_upload->MaybeFinish();
+    }
+
+private:
+    std::shared_ptr<MultipartUpload> m_upload;
+};
+
+class MultipartUpload::AbortHandler : public XrdCl::ResponseHandler {
+public:
+    AbortHandler(std::shared_ptr<MultipartUpload> upload, const XrdCl::XRootDStatus &status)
+        : m_upload(upload), m_status(status)
+    {}
+
+    virtual void HandleResponse(XrdCl::XRootDStatus *status_raw, XrdCl::AnyObject *response_raw) override {
+        std::unique_ptr<AbortHandler> self(this);
+        std::unique_ptr<XrdCl::XRootDStatus> status(status_raw);
+        std::unique_ptr<XrdCl::AnyObject> response(response_raw);
+
+        if (!status->IsOK()) {
+            m_upload->m_logger->Warning(kLogXrdClS3, "Failed to abort multipart upload of %s: %s",
+                m_upload->m_url.c_str(), status->ToString().c_str());
+        }
+        m_upload->FinishClose(m_status);
+    }
+
+private:
+    std::shared_ptr<MultipartUpload> m_upload;
+    const XrdCl::XRootDStatus m_status;
+};
+
+MultipartUpload::MultipartUpload(const std::string &url, XrdCl::Log *log) :
+    m_url(url),
+    m_logger(log),
+    m_part_size(Factory::GetPartSize()),
+    m_parallelism(Factory::GetParallelism())
+{
+    auto loc = m_url.find('/', 8); // strlen("https://") -> 8
+    m_path = (loc == std::string::npos) ? "/" : m_url.substr(loc);
+
+    XrdCl::URL fs_url;
+    fs_url.FromString(m_url);
+    m_fs.reset(new XrdCl::FileSystem(fs_url));
+    std::stringstream ss;
+    ss << std::hex << reinterpret_cast<long long>(&m_header_callout);
+    if (!m_fs->SetProperty("XrdClHttpHeaderCallout", ss.str())) {
+        m_logger->Error(kLogXrdClS3, "Failed to setup header callout for multipart upload of %s", m_url.c_str());
+    }
+}
+
+MultipartUpload::~MultipartUpload() noexcept {}
+
+XrdCl::XRootDStatus
+MultipartUpload::Open(bool exclusive, XrdCl::ResponseHandler *handler, time_t timeout)
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_timeout = timeout;
+    }
+    std::unique_ptr<OpenHandler> open_handler(new OpenHandler(shared_from_this(), exclusive, handler));
+    auto st = m_fs->Stat(m_path, open_handler.get(), timeout);
+    if (st.IsOK()) open_handler.release();
+    return st;
+}
+
+XrdCl::XRootDStatus
+MultipartUpload::Write(uint64_t offset, uint32_t size, const void *buffer,
+                       XrdCl::ResponseHandler *handler, time_t timeout)
+{
+    bool wait;
+    {
+        std::unique_lock lock(m_mutex);
+        if (!m_status.IsOK()) {
+            return m_status;
+        }
+        if (m_closing) {
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp, 0, "Cannot write to a closed file");
+        }
+        if (offset != m_offset) {
+            m_logger->Warning(kLogXrdClS3, "Requested write offset at %llu does not match current offset at %llu",
+                static_cast<unsigned long long>(offset), static_cast<unsigned long long>(m_offset));
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidArgs, 0, "S3 uploads must be written sequentially");
+        }
+        m_timeout = timeout;
+
+        auto data = static_cast<const char *>(buffer);
+        uint64_t left = size;
+        while (left) {
+            if (m_current.empty()) {
+                m_current.reserve(m_part_size);
+            }
+            auto count = std::min<uint64_t>(left, m_part_size - m_current.size());
+            m_current.insert(m_current.end(), data, data + count);
+            data += count;
+            left -= count;
+            if (m_current.size() == m_part_size) {
+                m_ready.push_back({m_next_part++, std::move(m_current)});
+                m_current = std::vector<char>();
+            }
+        }
+        m_offset += size;
+
+        Schedule();
+        // Hold the acknowledgement back while full parts wait for a slot.
+        wait = !m_ready.empty();
+        if (wait && handler) {
+            m_blocked_writes.push_back(handler);
+        }
+    }
+    RunPending();
+    if (!wait && handler) {
+        handler->HandleResponse(new XrdCl::XRootDStatus{}, nullptr);
+    }
+    return XrdCl::XRootDStatus{};
+}
+
+XrdCl::XRootDStatus
+MultipartUpload::Close(XrdCl::ResponseHandler *handler, time_t timeout)
+{
+    {
+        std::unique_lock lock(m_mutex);
+        if (m_closing) {
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp, 0, "File is already closed");
+        }
+        m_closing = true;
+        m_close_handler = handler;
+        m_timeout = timeout;
+        if (m_status.IsOK()) {
+            if (m_upload_id.empty() && !m_creating && m_ready.empty()) {
+                // The object never filled a part; upload it with a single PUT.
+                m_start_parts.push_back({0, std::move(m_current)});
+                m_inflight++;
+            } else if (!m_current.empty()) {
+                m_ready.push_back({m_next_part++, std::move(m_current)});
+            }
+            m_current = std::vector<char>();
+            Schedule();
+        }
+    }
+    RunPending();
+    MaybeFinish();
+    return XrdCl::XRootDStatus{};
+}
+
+void
+MultipartUpload::Schedule()
+{
+    if (!m_status.IsOK()) {
+        return;
+    }
+    if (m_upload_id.empty()) {
+        if (!m_creating && !m_ready.empty()) {
+            m_creating = true;
+            m_start_create = true;
+        }
+        return;
+    }
+    while (m_inflight < m_parallelism && !m_ready.empty()) {
+        m_start_parts.push_back(std::move(m_ready.front()));
+        m_ready.pop_front();
+        m_inflight++;
+    }
+}
+
+void
+MultipartUpload::RunPending()
+{
+    bool start_create;
+    std::vector<Part> parts;
+    std::vector<XrdCl::ResponseHandler *> handlers;
+    XrdCl::XRootDStatus status;
+    {
+        std::unique_lock lock(m_mutex);
+        start_create = m_start_create;
+        m_start_create = false;
+        parts.swap(m_start_parts);
+        if (!m_status.IsOK() || m_ready.empty()) {
+            handlers.swap(m_blocked_writes);
+            status = m_status;
+        }
+    }
+
+    if (start_create) {
+        m_logger->Debug(kLogXrdClS3, "Starting multipart upload of %s", m_url.c_str());
+        std::unique_ptr<CreateHandler> handler(new CreateHandler(shared_from_this()));
+        auto st = Post("uploads", "", handler.get());
+        if (st.IsOK()) {
+            handler.release();
+        } else {
+            CreateDone(st, "");
+        }
+    }
+    for (auto &part : parts) {
+        StartPart(std::move(part));
+    }
+    for (auto handler : handlers) {
+        handler->HandleResponse(new XrdCl::XRootDStatus(status), nullptr);
+    }
+}
+
+void
+MultipartUpload::StartPart(Part &&part)
+{
+    auto number = part.m_number;
+    std::string upload_id;
+    time_t timeout;
+    {
+        std::unique_lock lock(m_mutex);
+        upload_id = m_upload_id;
+        timeout = m_timeout;
+    }
+    m_logger->Debug(kLogXrdClS3, "Uploading part %u (%zu bytes) of %s", number, part.m_data.size(), m_url.c_str());
+    std::unique_ptr<PartHandler> handler(new PartHandler(shared_from_this(), std::move(part), upload_id, timeout));
+    auto st = handler->Start();
+    if (st.IsOK()) {
+        handler.release();
+    } else {
+        handler.reset();
+        PartDone(number, st, "");
+    }
+}
+
+void
+MultipartUpload::PartDone(unsigned number, const XrdCl::XRootDStatus &status, const std::string &etag)
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_inflight--;
+        if (!status.IsOK()) {
+            m_logger->Error(kLogXrdClS3, "Failed to upload part %u of %s: %s", number, m_url.c_str(), status.ToString().c_str());
+            SetFailed(status);
+        } else {
+            if (number) {
+                m_etags[number] = etag;
+            }
+            Schedule();
+        }
+    }
+    RunPending();
+    MaybeFinish();
+}
+
+void
+MultipartUpload::CreateDone(const XrdCl::XRootDStatus &status, const std::string &upload_id)
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_creating = false;
+        if (!status.IsOK()) {
+            m_logger->Error(kLogXrdClS3, "Failed to start multipart upload of %s: %s", m_url.c_str(), status.ToString().c_str());
+            SetFailed(status);
+        } else {
+            m_upload_id = upload_id;
+            Schedule();
+        }
+    }
+    RunPending();
+    MaybeFinish();
+}
+
+void
+MultipartUpload::SetFailed(const XrdCl::XRootDStatus &status)
+{
+    if (m_status.IsOK()) {
+        m_status = status;
+    }
+    // Nothing queued will be sent any more.
+    m_ready.clear();
+    m_current = std::vector<char>();
+}
+
+void
+MultipartUpload::MaybeFinish()
+{
+    XrdCl::XRootDStatus status;
+    std::string upload_id;
+    std::string body;
+    {
+        std::unique_lock lock(m_mutex);
+        if (!m_closing || m_finishing || m_inflight || m_creating || !m_start_parts.empty()) {
+            return;
+        }
+        if (m_status.IsOK() && !m_ready.empty()) {
+            return;
+        }
+        m_finishing = true;
+        status = m_status;
+        upload_id = m_upload_id;
+        if (status.IsOK() && !upload_id.empty()) {
+            body = "<CompleteMultipartUpload xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">";
+            for (const auto &[number, etag] : m_etags) {
+                body += "<Part><PartNumber>" + std::to_string(number) + "</PartNumber><ETag>\"" + etag + "\"</ETag></Part>";
+            }
+            body += "</CompleteMultipartUpload>";
+        }
+    }
+
+    if (upload_id.empty()) {
+        FinishClose(status);
+        return;
+    }
+    if (status.IsOK()) {
+        m_logger->Debug(kLogXrdClS3, "Completing multipart upload of %s", m_url.c_str());
+        std::unique_ptr<CompleteHandler> handler(new CompleteHandler(shared_from_this()));
+        auto st = Post("uploadId=" + upload_id, body, handler.get());
+        if (st.IsOK()) {
+            handler.release();
+            return;
+        }
+        status = st;
+    }
+
+    m_logger->Debug(kLogXrdClS3, "Aborting multipart upload of %s", m_url.c_str());
+    std::unique_ptr<AbortHandler> handler(new AbortHandler(shared_from_this(), status));
+    auto st = m_fs->Rm(m_path + "?uploadId=" + upload_id, handler.get(), m_timeout);
+    if (st.IsOK()) {
+        handler.release();
+    } else {
+        FinishClose(status);
+    }
+}
+
+void
+MultipartUpload::FinishClose(const XrdCl::XRootDStatus &status)
+{
+    XrdCl::ResponseHandler *handler;
+    {
+        std::unique_lock lock(m_mutex);
+        handler = m_close_handler;
+        m_close_handler = nullptr;
+    }
+    if (handler) {
+        handler->HandleResponse(new XrdCl::XRootDStatus(status), nullptr);
+    }
+}
+
+XrdCl::XRootDStatus
+MultipartUpload::Post(const std::string &query, const std::string &body, XrdCl::ResponseHandler *handler)
+{
+    std::string pointer_str;
+    long long pointer = 0;
+    if (m_fs->GetProperty("XrdClHttpPost", pointer_str)) {
+        try {
+            pointer = std::stoll(pointer_str, nullptr, 16);
+        } catch (...) {
+            pointer = 0;
+        }
+    }
+    if (!pointer) {
+        return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errNotSupported, 0, "HTTP plugin does not support POST");
+    }
+    return reinterpret_cast<XrdClHttp::Post*>(pointer)->DoPost(m_path + "?" + query, body, handler, m_timeout);
+}
+
+std::shared_ptr<XrdClHttp::HeaderCallout::HeaderList>
+MultipartUpload::S3HeaderCallout::GetHeaders(const std::string &verb,
+                                             const std::string &url,
+                                             const XrdClHttp::HeaderCallout::HeaderList &headers)
+{
+    std::string auth_token, err_msg;
+    std::shared_ptr<HeaderList> header_list(new HeaderList(headers));
+    if (Factory::GenerateV4Signature(url, verb, *header_list, auth_token, err_msg)) {
+        header_list->emplace_back("Authorization", auth_token);
+    } else {
+        m_parent.m_logger->Error(kLogXrdClS3, "Failed to generate V4 signature: %s", err_msg.c_str());
+        return nullptr;
+    }
+    return header_list;
+}
@@ -0,0 +1,169 @@
+/******************************************************************************/
+/* Copyright (C) 2025, Pelican Project, Morgridge Institute for Research      */
+/*                                                                            */
+/* This file is part of the XrdClS3 client plugin for XRootD.                 */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#ifndef XRDCLS3_S3MULTIPARTUPLOAD_HH
+#define XRDCLS3_S3MULTIPARTUPLOAD_HH
+
+#include "../XrdClHttp/XrdClHttpHeaderCallout.hh"
+#include "../XrdClHttp/XrdClHttpPost.hh"
+
+#include <XrdCl/XrdClXRootDResponses.hh>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace XrdCl {
+
+class FileSystem;
+class Log;
+
+}
+
+namespace XrdClS3 {
+
+// Uploads an object as a S3 multipart upload.
+//
+// Sequential writes are copied into part-sized buffers.  Nothing is sent until
+// the first part fills up; an object smaller than a part is uploaded with a
+// single PUT when closed.  Otherwise, the multipart upload is created and each
+// full part is sent as its own PUT through the XrdClHttp worker pool, with up
+// to Factory::GetParallelism() parts in flight.  Writes are acknowledged once
+// their data is buffered, unless parts are queued waiting for an upload slot,
+// which bounds the memory used to about (parallelism + 2) parts.
+//
+// Open checks the object with a HEAD request, so that credentials and bucket
+// are verified before any data is accepted and an existing object is refused
+// when the caller asked for exclusive creation.
+//
+// Close sends the last part and posts the list of part ETags to complete the
+// object.  After any failure the upload is aborted so the service discards the
+// parts already stored.
+class MultipartUpload : public std::enable_shared_from_this<MultipartUpload> {
+public:
+    // - url: HTTPS URL of the object, without a query string.
+    MultipartUpload(const std::string &url, XrdCl::Log *log);
+
+    virtual ~MultipartUpload() noexcept;
+
+    // Probe the object; the handler gets an error if it cannot be written or,
+    // with `exclusive`, if it already exists.
+    XrdCl::XRootDStatus Open(bool exclusive, XrdCl::ResponseHandler *handler, time_t timeout);
+
+    XrdCl::XRootDStatus Write(uint64_t offset, uint32_t size, const void *buffer,
+                              XrdCl::ResponseHandler *handler, time_t timeout);
+
+    XrdCl::XRootDStatus Close(XrdCl::ResponseHandler *handler, time_t timeout);
+
+private:
+    struct Part {
+        unsigned m_number{0}; // S3 part number; 0 for a plain PUT of the whole object.
+        std::vector<char> m_data;
+    };
+
+    class PartHandler;
+    class OpenHandler;
+    class CreateHandler;
+    class CompleteHandler;
+    class AbortHandler;
+
+    // Start whatever the current state allows: creating the upload or sending
+    // queued parts.  Called with m_mutex held; the operations themselves are
+    // started by RunPending() once the lock is released.
+    void Schedule();
+
+    // Start the operations picked by Schedule().
+    void RunPending();
+
+    // Start sending a single part.
+    void StartPart(Part &&part);
+
+    void PartDone(unsigned number, const XrdCl::XRootDStatus &status, const std::string &etag);
+    void CreateDone(const XrdCl::XRootDStatus &status, const std::string &upload_id);
+
+    // Record the first failure and drop the queued data; waiting write
+    // handlers are failed by the next RunPending().  Called with m_mutex held.
+    void SetFailed(const XrdCl::XRootDStatus &status);
+
+    // Complete or abort the upload once the object is closed and no part is in flight.
+    void MaybeFinish();
+
+    // Invoke the close handler with the given status.
+    void FinishClose(const XrdCl::XRootDStatus &status);
+
+    // Send a POST with `body` to the object URL plus `query`.
+    XrdCl::XRootDStatus Post(const std::string &query, const std::string &body, XrdCl::ResponseHandler *handler);
+
+    const std::string m_url;
+    // Path (and bucket, for path-style URLs) of the object within the endpoint.
+    std::string m_path;
+    XrdCl::Log *m_logger{nullptr};
+    const uint64_t m_part_size;
+    const unsigned m_parallelism;
+
+    std::mutex m_mutex;
+    uint64_t m_offset{0};
+    time_t m_timeout{0};
+    std::vector<char> m_current;
+    unsigned m_next_part{1};
+    std::deque<Part> m_ready;
+    unsigned m_inflight{0};
+    bool m_creating{false};
+    std::string m_upload_id;
+    std::map<unsigned, std::string> m_etags;
+    XrdCl::XRootDStatus m_status;
+    bool m_closing{false};
+    bool m_finishing{false};
+    XrdCl::ResponseHandler *m_close_handler{nullptr};
+    std::vector<XrdCl::ResponseHandler *> m_blocked_writes;
+
+    // Work picked by Schedule() for RunPending().
+    bool m_start_create{false};
+    std::vector<Part> m_start_parts;
+
+    // Filesystem handle used for the POST and DELETE requests of the upload.
+    std::unique_ptr<XrdCl::FileSystem> m_fs;
+
+    // Signs the requests of this upload; owned here rather than by the File
+    // so that in-flight parts never outlive it.
+    class S3HeaderCallout : public XrdClHttp::HeaderCallout {
+    public:
+        S3HeaderCallout(MultipartUpload &upload) : m_parent(upload)
+        {}
+
+        virtual ~S3HeaderCallout() noexcept = default;
+
+        virtual std::shared_ptr<HeaderList> GetHeaders(const std::string &verb,
+                                                       const std::string &url,
+                                                       const HeaderList &headers) override;
+
+    private:
+        MultipartUpload &m_parent;
+    };
+
+    S3HeaderCallout m_header_callout{*this};
+};
+
+} // namespace XrdClS3
+
+#endif // XRDCLS3_S3MULTIPARTUPLOAD_HH
@@ -28,7 +28,9 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
   
+#include <cerrno>
 #include <cstdio>
+#include <cstdlib>
 #include <sys/types.h>
 
 #include "XrdCms/XrdCmsCache.hh"
@@ -116,18 +118,19 @@ void *XrdCmsStartTickTock(void *carg)
   
 int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
 {
+   Shard &sP = getShard(Sel.Path);
    XrdCmsKeyItem *iP;
    SMask_t xmask;
    int isrw = (Sel.Opts & XrdCmsSelect::Write), isnew = 0;
 
 // Serialize processing
 //
-   myMutex.Lock();
+   sP.Mutex.Lock();
 
 // Check for fast path processing
 //
    if (  !(iP = Sel.Path.TODRef) || !(iP->Key.Equiv(Sel.Path)))
-      if ((iP = Sel.Path.TODRef = CTable.Find(Sel.Path)))
+      if ((iP = Sel.Path.TODRef = sP.Table.Find(Sel.Path)))
          Sel.Path.Ref = iP->Key.Ref;
 
 // Add/Modify the entry
@@ -138,7 +141,7 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
            iP->Loc.lifeline = nilTMO + iP->Loc.deadline;
            iP->Loc.hfvec = 0; iP->Loc.pfvec = 0; iP->Loc.qfvec = 0;
            iP->Loc.TOD_B = BClock;
-           iP->Key.TOD = Tock;
+           iP->Key.TOD = sP.Tock;
           } else {
            xmask = iP->Loc.pfvec;
            if (Sel.Opts & XrdCmsSelect::Pending) iP->Loc.pfvec |= mask;
@@ -155,8 +158,9 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
                      }
           }
       } else if (!(Sel.Opts & XrdCmsSelect::Advisory))
-                {Sel.Path.TOD = Tock;
-                 if ((iP = CTable.Add(Sel.Path)))
+                {if (maxLive && sP.Table.Live() >= maxLive) Trim(sP);
+                 Sel.Path.TOD = sP.Tock;
+                 if ((iP = sP.Table.Add(Sel.Path)))
                     {iP->Loc.pfvec    = (Sel.Opts&XrdCmsSelect::Pending?mask:0);
                      iP->Loc.hfvec    = mask;
                      iP->Loc.TOD_B    = BClock;
@@ -170,7 +174,7 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
 
 // All done
 //
-   myMutex.UnLock();
+   sP.Mutex.UnLock();
    return isnew;
 }
   
@@ -190,29 +194,30 @@ int XrdCmsCache::AddFile(XrdCmsSelect &Sel, SMask_t mask)
   
 int XrdCmsCache::DelFile(XrdCmsSelect &Sel, SMask_t mask)
 {
+   Shard &sP = getShard(Sel.Path);
    XrdCmsKeyItem *iP;
    int gone4good;
 
 // Lock the hash table
 //
-   myMutex.Lock();
+   sP.Mutex.Lock();
 
 // Look up the entry and remove server
 //
-   if ((iP = CTable.Find(Sel.Path)))
+   if ((iP = sP.Table.Find(Sel.Path)))
       {iP->Loc.hfvec &= ~mask;
        iP->Loc.pfvec &= ~mask;
        if ((gone4good = (iP->Loc.hfvec == 0)))
           {if (nilTMO) iP->Loc.lifeline = nilTMO + time(0);
            if (!(Sel.Opts & XrdCmsSelect::Advisory)
-           &&  XrdCmsKeyItem::Unload(iP) && !CTable.Recycle(iP))
+           &&  sP.Table.Unload(iP) && !sP.Table.Recycle(iP))
               Say.Emsg("DelFile", "Delete failed for", iP->Key.Val);
           }
       } else gone4good = 0;
 
 // All done
 //
-   myMutex.UnLock();
+   sP.Mutex.UnLock();
    return gone4good;
 }
   
@@ -231,19 +236,25 @@ int XrdCmsCache::DelFile(XrdCmsSelect &Sel, SMask_t mask)
   
 int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
 {
+   Shard &sP = getShard(Sel.Path);
    XrdCmsKeyItem *iP;
    SMask_t bVec;
    int retc;
 
 // Lock the hash table
 //
-   myMutex.Lock();
+   sP.Mutex.Lock();
 
-// Look up the entry and return location information
+// Look up the entry and return location information. The bounce vector is
+// only computed, under the server lock, when some server bounced since.
 //
-   if ((iP = CTable.Find(Sel.Path)))
-      {if ((bVec = (iP->Loc.TOD_B < BClock 
-                 ? getBVec(iP->Key.TOD, iP->Loc.TOD_B) & mask : 0)))
+   if ((iP = sP.Table.Find(Sel.Path)))
+      {if (iP->Loc.TOD_B < BClock)
+          {bMutex.Lock();
+           bVec = getBVec(iP->Key.TOD, iP->Loc.TOD_B) & mask;
+           bMutex.UnLock();
+          } else bVec = 0;
+       if (bVec)
           {iP->Loc.hfvec &= ~bVec; 
            iP->Loc.pfvec &= ~bVec;
            iP->Loc.qfvec &= ~mask;
@@ -264,9 +275,14 @@ int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
        Sel.Path.Ref    = iP->Key.Ref;
       } else retc = 0;
 
+// Count the lookup
+//
+   if (retc) sP.Hits++;
+      else   sP.Miss++;
+
 // All done
 //
-   myMutex.UnLock();
+   sP.Mutex.UnLock();
    Sel.Path.TODRef = iP;
    return retc;
 }
@@ -278,11 +294,12 @@ int  XrdCmsCache::GetFile(XrdCmsSelect &Sel, SMask_t mask)
 int XrdCmsCache::UnkFile(XrdCmsSelect &Sel, SMask_t mask)
 {
    EPNAME("UnkFile");
+   Shard &sP = getShard(Sel.Path);
    XrdCmsKeyItem *iP;
 
 // Make sure we have the proper information. If so, lock the hash table
 //
-   myMutex.Lock();
+   sP.Mutex.Lock();
 
 // Look up the entry and if valid update the unqueried vector. Note that
 // this method may only be called after GetFile() or AddFile() for a new entry
@@ -294,7 +311,7 @@ int XrdCmsCache::UnkFile(XrdCmsSelect &Sel, SMask_t mask)
 
 // Return result
 //
-   myMutex.UnLock();
+   sP.Mutex.UnLock();
    DEBUG("rc=" <<(iP ? 1 : 0) <<" path=" <<Sel.Path.Val);
    return (iP ? 1 : 0);
 }
@@ -313,7 +330,8 @@ int XrdCmsCache::WT4File(XrdCmsSelect &Sel, SMask_t mask)
 // Make sure we have the proper information. If so, lock the hash table
 //
    if (!Sel.InfoP) return DLTime;
-   myMutex.Lock();
+   Shard &sP = getShard(Sel.Path);
+   sP.Mutex.Lock();
 
 // Look up the entry and if valid add it to the callback queue. Note that
 // this method may only be called after GetFile() or AddFile() for a new entry
@@ -328,7 +346,7 @@ int XrdCmsCache::WT4File(XrdCmsSelect &Sel, SMask_t mask)
 
 // Return result
 //
-   myMutex.UnLock();
+   sP.Mutex.UnLock();
    DEBUG("rc=" <<retc <<" path=" <<Sel.Path.Val);
    return retc;
 }
@@ -345,11 +363,11 @@ void XrdCmsCache::Bounce(SMask_t smask, int SNum)
 
 // Simply indicate that this server bounced
 //
-   myMutex.Lock();
+   bMutex.Lock();
    Bounced[SNum] = ++BClock;
    okVec |= smask;
    if (SNum > vecHi) vecHi = SNum;
-   myMutex.UnLock();
+   bMutex.UnLock();
 }
 
 /******************************************************************************/
@@ -366,20 +384,21 @@ void XrdCmsCache::Drop(SMask_t smask, int SNum, int xHi)
 
 // Remove the node from the list of valid nodes
 //
-   myMutex.Lock();
+   bMutex.Lock();
    Bounced[SNum] = 0;
    okVec &= nmask;
    vecHi = xHi;
-   myMutex.UnLock();
+   if (nodeName[SNum]) {free(nodeName[SNum]); nodeName[SNum] = 0;}
+   bMutex.UnLock();
 }
 
 /******************************************************************************/
 /* public                           I n i t                                   */
 /******************************************************************************/
   
-int XrdCmsCache::Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold)
+int XrdCmsCache::Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold,
+                      int fxMax, const char *fxSnap)
 {
-   XrdCmsKeyItem *iP;
    pthread_t tid;
 
 // Indicate whether we are a shared-everything setup as this changes how we
@@ -401,6 +420,19 @@ int XrdCmsCache::Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold
        nilTMO = static_cast<unsigned int>(nxHold);
       }
 
+// Set the per shard limit on the number of paths, if any
+//
+   if (fxMax > 0 && !(maxLive = fxMax/nShards)) maxLive = 1;
+
+// Load the locations saved by our previous incarnation. They are kept for one
+// full hold period as they would have aged out by then.
+//
+   if (fxSnap)
+      {snapPath = strdup(fxSnap);
+       warmTTL  = XrdCmsKeyItem::TickRate;
+       WarmLoad();
+      }
+
 // Start the clock thread
 //
    if (XrdSysThread::Run(&tid, XrdCmsStartTickTock, (void *)this,
@@ -411,9 +443,7 @@ int XrdCmsCache::Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold
 
 // Get the first reserve of cache items
 //
-   iP = XrdCmsKeyItem::Alloc(0);
-   XrdCmsKeyItem::Unload((unsigned int)0);
-   iP->Recycle();
+   XrdCmsKeyItem::Replenish();
 
 // All done
 //
@@ -426,17 +456,51 @@ int XrdCmsCache::Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold
 
 void *XrdCmsCache::TickTock()
 {
-   XrdCmsKeyItem *iP;
+   XrdCmsKeyItem *iP, *xP, *xList;
+   unsigned int Tock = 0;
+   long long Hits, Miss, Evict;
+   int Live;
+   char msgBuff[160];
 
-// Simply adjust the clock and trim old entries
+// Simply adjust the clock and trim old entries, one shard at a time. Every
+// so often save the known locations and report the cache statistics.
 //
    do {XrdSysTimer::Snooze(Tick);
-       myMutex.Lock();
        Tock = (Tock+1) & XrdCmsKeyItem::TickMask;
+       bMutex.Lock();
        Bhistory[Tock].Start = Bhistory[Tock].End = 0;
-       iP = XrdCmsKeyItem::Unload(Tock);
-       myMutex.UnLock();
-       if (iP) Sched->Schedule((XrdJob *)new XrdCmsCacheJob(iP));
+       bMutex.UnLock();
+       Hits = Miss = Evict = 0; Live = 0; xList = 0;
+       for (int i = 0; i < nShards; i++)
+           {Shards[i].Mutex.Lock();
+            Shards[i].Tock = Tock;
+            iP = Shards[i].Table.Unload(Tock);
+            Hits  += Shards[i].Hits;
+            Miss  += Shards[i].Miss;
+            Evict += Shards[i].Evict;
+            Live  += Shards[i].Table.Live();
+            Shards[i].Mutex.UnLock();
+            if ((xP = iP))
+               {while(xP->Key.TODRef) xP = xP->Key.TODRef;
+                xP->Key.TODRef = xList; xList = iP;
+               }
+           }
+       if (xList) Sched->Schedule((XrdJob *)new XrdCmsCacheJob(xList));
+
+       if (snapPath && !(Tock & 7)) Snapshot();
+
+       if (warmTTL && !--warmTTL)
+          {wMutex.Lock();
+           warmPaths.clear(); warmPaths.shrink_to_fit();
+           warmNodes.clear();
+           wMutex.UnLock();
+          }
+
+       if (!Tock)
+          {snprintf(msgBuff, sizeof(msgBuff), "%d paths; %lld hits %lld misses "
+                    "%lld evicted", Live, Hits, Miss, Evict);
+           Say.Emsg("Cache", msgBuff);
+          }
       } while(1);
 
 // Keep compiler happy
@@ -444,6 +508,33 @@ void *XrdCmsCache::TickTock()
    return (void *)0;
 }
 
+/******************************************************************************/
+/* public                           W a r m                                   */
+/******************************************************************************/
+  
+void XrdCmsCache::Warm(SMask_t smask, int SNum, const char *sName)
+{
+   std::unordered_map<std::string, std::vector<int>>::iterator it;
+
+// Record the name of this server for future snapshots
+//
+   bMutex.Lock();
+   if (nodeName[SNum]) free(nodeName[SNum]);
+   nodeName[SNum] = strdup(sName);
+   bMutex.UnLock();
+
+// Add whatever locations the snapshot held for this server. This is done only
+// once as subsequent logins must be discovered the usual way.
+//
+   wMutex.Lock();
+   if ((it = warmNodes.find(sName)) != warmNodes.end())
+      {for (int i : it->second) Preload(warmPaths[i].c_str(), smask);
+       Say.Emsg("Cache", sName, "locations preloaded from", snapPath);
+       warmNodes.erase(it);
+      }
+   wMutex.UnLock();
+}
+
 /******************************************************************************/
 /*                       P r i v a t e   M e t h o d s                        */
 /******************************************************************************/
@@ -527,12 +618,56 @@ SMask_t XrdCmsCache::getBVec(unsigned int TODa, unsigned int &TODb)
    return BVec;
 }
 
+/******************************************************************************/
+/*                               P r e l o a d                                */
+/******************************************************************************/
+  
+// Preloaded locations are considered complete as far as the server is
+// concerned. They are dated after the server's bounce so they stay valid. As
+// each server bounces before it is warmed, an entry preloaded for another
+// server first has the bounces since it was last dated applied, as GetFile()
+// would do, except for the server being preloaded.
+
+void XrdCmsCache::Preload(const char *path, SMask_t smask)
+{
+   XrdCmsKey Key((char *)path, strlen(path));
+   Shard &sP = getShard(Key);
+   XrdCmsKeyItem *iP;
+   SMask_t bVec;
+
+   sP.Mutex.Lock();
+   if (!(iP = sP.Table.Find(Key)))
+      {if (maxLive && sP.Table.Live() >= maxLive) Trim(sP);
+       Key.TOD = sP.Tock;
+       if (!(iP = sP.Table.Add(Key))) {sP.Mutex.UnLock(); return;}
+       iP->Loc.hfvec    = 0;
+       iP->Loc.pfvec    = 0;
+       iP->Loc.qfvec    = 0;
+       iP->Loc.TOD_B    = BClock;
+       iP->Loc.deadline = 0;
+       iP->Loc.lifeline = 0;
+      }
+   else if (iP->Loc.TOD_B < BClock)
+      {bMutex.Lock();
+       bVec = getBVec(iP->Key.TOD, iP->Loc.TOD_B) & ~smask;
+       bMutex.UnLock();
+       iP->Loc.hfvec &= ~bVec;
+       iP->Loc.pfvec &= ~bVec;
+       iP->Loc.qfvec |=  bVec;
+      }
+   iP->Loc.TOD_B  = BClock;
+   iP->Loc.hfvec |=  smask;
+   iP->Loc.qfvec &= ~smask;
+   sP.Mutex.UnLock();
+}
+
 /******************************************************************************/
 /*                               R e c y c l e                                */
 /******************************************************************************/
   
 void XrdCmsCache::Recycle(XrdCmsKeyItem *theList)
 {
+   Shard *sP;
    XrdCmsKeyItem *iP;
    char msgBuff[100];
    int numNull, numHave, numFree, numRecycled = 0;
@@ -543,24 +678,19 @@ void XrdCmsCache::Recycle(XrdCmsKeyItem *theList)
         {theList = iP->Key.TODRef;
          if (iP->Loc.roPend) RRQ.Del(iP->Loc.roPend, iP);
          if (iP->Loc.rwPend) RRQ.Del(iP->Loc.rwPend, iP);
-         myMutex.Lock(); CTable.Recycle(iP); myMutex.UnLock();
+         sP = &Shards[iP->Loc.HashSave >> 24 & (nShards-1)];
+         sP->Mutex.Lock(); sP->Table.Recycle(iP); sP->Mutex.UnLock();
          numRecycled++;
         }
 
 // See if we have enough items in reserve
 //
-   myMutex.Lock();
    XrdCmsKeyItem::Stats(numHave, numFree, numNull);
    if (numFree < XrdCmsKeyItem::minFree)
-      {myMutex.UnLock();
-       if (!(numNull /= 4)) numNull = 1;
+      {if (!(numNull /= 4)) numNull = 1;
        numHave += XrdCmsKeyItem::minAlloc * numNull;
-       while(numNull--)
-            {myMutex.Lock();
-             numFree = XrdCmsKeyItem::Replenish();
-             myMutex.UnLock();
-            }
-      } else myMutex.UnLock();
+       while(numNull--) numFree = XrdCmsKeyItem::Replenish();
+      }
 
 // Log the stats
 //
@@ -568,3 +698,158 @@ void XrdCmsCache::Recycle(XrdCmsKeyItem *theList)
            numRecycled, numHave, numFree);
    Say.Emsg("Recycle", msgBuff);
 }
+
+/******************************************************************************/
+/*                              S n a p s h o t                               */
+/******************************************************************************/
+
+namespace
+{
+struct SnapArg {std::string Buff; SMask_t Known;};
+
+void SnapItem(XrdCmsKeyItem *iP, void *Arg)
+{
+   SnapArg *sArg = (SnapArg *)Arg;
+   SMask_t hVec = iP->Loc.hfvec & ~iP->Loc.pfvec & sArg->Known;
+   char hBuff[24];
+
+// Only save settled locations of servers whose name we know
+//
+   if (!hVec || iP->Loc.deadline || strchr(iP->Key.Val, '\n')) return;
+   snprintf(hBuff, sizeof(hBuff), "p %llx ", hVec);
+   sArg->Buff += hBuff;
+   sArg->Buff += iP->Key.Val;
+   sArg->Buff += '\n';
+}
+}
+
+// The snapshot is written to a temporary file that replaces the previous one
+// once complete. Each shard is copied to memory under its lock and written
+// after the lock is released.
+
+void XrdCmsCache::Snapshot()
+{
+   SnapArg sArg;
+   std::string tmpPath(snapPath);
+   FILE *fp;
+   char nBuff[16];
+   bool isOK;
+
+// Create the temporary file
+//
+   tmpPath += ".tmp";
+   if (!(fp = fopen(tmpPath.c_str(), "w")))
+      {Say.Emsg("Cache", errno, "create snapshot", tmpPath.c_str());
+       return;
+      }
+
+// Record the servers we know about
+//
+   sArg.Known = 0;
+   sArg.Buff  = "#xrdcms-fxsnap 1\n";
+   bMutex.Lock();
+   for (int i = 0; i < STMax; i++)
+       if (nodeName[i])
+          {snprintf(nBuff, sizeof(nBuff), "n %d ", i);
+           sArg.Buff += nBuff;
+           sArg.Buff += nodeName[i];
+           sArg.Buff += '\n';
+           sArg.Known |= 1ULL << i;
+          }
+   bMutex.UnLock();
+
+// Save the locations of each shard
+//
+   isOK = true;
+   for (int i = 0; i < nShards && isOK; i++)
+       {Shards[i].Mutex.Lock();
+        Shards[i].Table.Apply(SnapItem, &sArg);
+        Shards[i].Mutex.UnLock();
+        isOK = fwrite(sArg.Buff.data(), 1, sArg.Buff.size(), fp)
+               == sArg.Buff.size();
+        sArg.Buff.clear();
+       }
+
+// Replace the previous snapshot
+//
+   if (fclose(fp) || !isOK)
+      {Say.Emsg("Cache", errno, "write snapshot", tmpPath.c_str());
+       unlink(tmpPath.c_str());
+      } else if (rename(tmpPath.c_str(), snapPath))
+                Say.Emsg("Cache", errno, "replace snapshot", snapPath);
+}
+
+/******************************************************************************/
+/*                                  T r i m                                   */
+/******************************************************************************/
+
+// Called with the shard locked when it is full. The oldest paths are unloaded
+// early, in the same way as when they age out.
+
+void XrdCmsCache::Trim(Shard &sP)
+{
+   XrdCmsKeyItem *iP, *xP;
+   int n = 0;
+
+   for (unsigned int i = 1; i <= XrdCmsKeyItem::TickRate; i++)
+       if ((iP = sP.Table.Unload((sP.Tock + i) & XrdCmsKeyItem::TickMask)))
+          {for (xP = iP; xP; xP = xP->Key.TODRef) n++;
+           Sched->Schedule((XrdJob *)new XrdCmsCacheJob(iP));
+           break;
+          }
+   sP.Evict += n;
+}
+
+/******************************************************************************/
+/*                              W a r m L o a d                               */
+/******************************************************************************/
+
+// Snapshot lines are "n <slot> <name>" for each server followed by
+// "p <slot mask> <path>" for each path.
+
+void XrdCmsCache::WarmLoad()
+{
+   std::string sName[STMax];
+   SMask_t hVec;
+   FILE *fp;
+   char *line = 0, *eP, mBuff[80];
+   size_t lsz = 0;
+   ssize_t n;
+   long slot;
+   int numP = 0;
+
+// Open the snapshot, it need not exist
+//
+   if (!(fp = fopen(snapPath, "r")))
+      {if (errno != ENOENT) Say.Emsg("Cache", errno, "open snapshot", snapPath);
+       return;
+      }
+
+// Read the servers and then the paths
+//
+   while((n = getline(&line, &lsz, fp)) > 0)
+        {if (line[n-1] == '\n') line[--n] = 0;
+         if (n < 4 || line[1] != ' ') continue;
+         if (*line == 'n')
+            {slot = strtol(line+2, &eP, 10);
+             if (slot >= 0 && slot < STMax && *eP == ' ') sName[slot] = eP+1;
+            }
+         else if (*line == 'p')
+            {hVec = strtoull(line+2, &eP, 16);
+             if (*eP != ' ' || eP[1] != '/') continue;
+             warmPaths.emplace_back(eP+1);
+             for (int i = 0; hVec; i++, hVec >>= 1)
+                 if ((hVec & 1) && !sName[i].empty())
+                    warmNodes[sName[i]].push_back(numP);
+             numP++;
+            }
+        }
+   free(line);
+   fclose(fp);
+
+// Document what we loaded
+//
+   snprintf(mBuff, sizeof(mBuff), "%d paths for %d servers loaded from",
+            numP, static_cast<int>(warmNodes.size()));
+   Say.Emsg("Cache", mBuff, snapPath);
+}
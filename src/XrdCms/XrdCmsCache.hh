@@ -31,6 +31,9 @@
 /******************************************************************************/
 
 #include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
   
 #include "Xrd/XrdJob.hh"
 #include "Xrd/XrdScheduler.hh"
@@ -40,7 +43,14 @@
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdCms/XrdCmsSelect.hh"
 #include "XrdCms/XrdCmsTypes.hh"
-  
+#include "XrdSys/XrdSysRAtomic.hh"
+
+// The location cache is split into shards by path hash. Each shard has its own
+// lock, table and aging clock so that lookups of different paths and the
+// periodic aging do not serialize on a single lock. Information about servers
+// (bounces and valid servers) is shared by all shards and has its own lock,
+// which may be obtained while holding a shard lock but not the reverse.
+//
 class XrdCmsCache
 {
 public:
@@ -74,41 +84,75 @@ void        Bounce(SMask_t smask, int SNum);
 
 void        Drop(SMask_t mask, int SNum, int xHi);
 
-int         Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold);
+// Init() starts the cache. When fxMax is not zero, the number of cached paths
+//        is limited to about that many by evicting the oldest ones early. When
+//        fxSnap is given, the known locations are periodically saved there
+//        and the ones saved by the previous instance are loaded for Warm().
+//
+int         Init(int fxHold, int fxDelay, int fxQuery, int seFS, int nxHold,
+                 int fxMax=0, const char *fxSnap=0);
 
 void       *TickTock();
 
+// Warm() records the name of the server in slot SNum when it logs in and
+//        adds the locations that the loaded snapshot held for that server.
+//
+void        Warm(SMask_t smask, int SNum, const char *sName);
+
 static const int min_nxTime = 60;
 
-            XrdCmsCache() : okVec(0), Tick(8*60*60), Tock(0), BClock(0), 
+            XrdCmsCache() : okVec(0), Tick(8*60*60), BClock(0),
                             nilTMO(0),
                             DLTime(5), QDelay(5), Bhits(0), Bmiss(0), vecHi(-1),
-                            isDFS(0)
+                            isDFS(0), maxLive(0), snapPath(0), warmTTL(0)
                           {memset(Bounced,  0, sizeof(Bounced));
                            memset(Bhistory, 0, sizeof(Bhistory));
+                           memset(nodeName, 0, sizeof(nodeName));
                           }
            ~XrdCmsCache() {}   // Never gets deleted
 
 private:
 
+static const int nShards = 16;  // Must be a power of 2 of at most 256
+
+struct Shard
+      {XrdSysMutex   Mutex;
+       XrdCmsNash    Table;
+       unsigned int  Tock;     // Aging clock of this shard
+       long long     Hits;     // Lookups that found the path
+       long long     Miss;     // Lookups that did not
+       long long     Evict;    // Paths removed early to stay within maxLive
+
+                     Shard() : Table(1597, 2584), Tock(0),
+                               Hits(0), Miss(0), Evict(0) {}
+      };
+
 void          Add2Q(XrdCmsRRQInfo *Info, XrdCmsKeyItem *cp, int selOpts);
 void          Dispatch(XrdCmsSelect &Sel, XrdCmsKeyItem *cinfo,
                        short roQ, short rwQ);
 SMask_t       getBVec(unsigned int todA, unsigned int &todB);
+Shard        &getShard(XrdCmsKey &Key)
+                       {if (!Key.Hash) Key.setHash();
+                        return Shards[Key.Hash >> 24 & (nShards-1)];
+                       }
+void          Preload(const char *path, SMask_t smask);
 void          Recycle(XrdCmsKeyItem *theList);
+void          Snapshot();
+void          Trim(Shard &sP);
+void          WarmLoad();
 
 struct  {SMask_t      Vec;
          unsigned int Start;
          unsigned int End;
         }             Bhistory[XrdCmsKeyItem::TickRate];
 
-XrdSysMutex   myMutex;
-XrdCmsNash    CTable;
+Shard         Shards[nShards];
+XrdSysMutex   bMutex;           // Protects the following server information
 unsigned int  Bounced[STMax];
-SMask_t       okVec;
+RAtomic_ullong okVec;
 unsigned int  Tick;
-unsigned int  Tock;
-unsigned int  BClock;
+RAtomic_uint  BClock;
+char         *nodeName[STMax];  // Server names for snapshots
          int  nilTMO;
          int  DLTime;
          int  QDelay;
@@ -116,6 +160,16 @@ unsigned int  BClock;
          int  Bmiss;
          int  vecHi;
          int  isDFS;
+         int  maxLive;          // Per shard limit on the number of paths
+const    char *snapPath;
+
+// Locations loaded from the snapshot waiting for their server to log in. They
+// are dropped once they would have aged out of the cache anyway.
+//
+XrdSysMutex   wMutex;
+std::vector<std::string> warmPaths;
+std::unordered_map<std::string, std::vector<int>> warmNodes;
+unsigned int  warmTTL;
 };
 
 namespace XrdCms
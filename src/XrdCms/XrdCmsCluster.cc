@@ -119,6 +119,9 @@ XrdCmsCluster::XrdCmsCluster()
      SelTcnt = 0;
      peerHost  = 0;
      peerMask  = ~peerHost;
+     for (int i = 0; i < STMax; i++) {SelM.Load[i] = 0; SelM.Mass[i] = 0;}
+     SelM.Ovld = 0;
+     SelM.Full = 0;
 }
 
 /******************************************************************************/
@@ -234,6 +237,7 @@ XrdCmsNode *XrdCmsCluster::Add(XrdLink *lp, int port, int Status, int sport,
    nP->isPeer    = 0 != (Status & CMS_isPeer);
    nP->isBad    |= XrdCmsNode::isDisabled;
    nP->subsPort  = sport;
+   Publish(nP);
 
 // If this is an actual non-hidden node, count it
 //
@@ -745,6 +749,30 @@ void *XrdCmsCluster::MonRefs()
    return (void *)0;
 }
 
+/******************************************************************************/
+/*                               P u b l i s h                                */
+/******************************************************************************/
+
+// Only a node that occupies its slot is published; alternates are published
+// when they replace the primary. Each slot has a single writer, the node's
+// protocol thread, so relaxed stores suffice for the readers under STMutex.
+
+void XrdCmsCluster::Publish(XrdCmsNode *nP)
+{
+   int     Slot = nP->NodeID;
+   SMask_t nBit = nP->NodeMask;
+
+   if (Slot < 0 || Slot >= STMax || !(NodeTab[Slot] == nP)) return;
+
+   SelM.Load[Slot] = nP->myLoad;
+   SelM.Mass[Slot] = nP->myMass;
+
+   if (nP->myLoad > Config.MaxLoad)       SelM.Ovld |=  nBit;
+      else                                SelM.Ovld &= ~nBit;
+   if (nP->DiskFree < nP->DiskMinF)       SelM.Full |=  nBit;
+      else                                SelM.Full &= ~nBit;
+}
+
 /******************************************************************************/
 /*                                R e m o v e                                 */
 /******************************************************************************/
@@ -861,6 +889,7 @@ void XrdCmsCluster::Remove(const char *reason, XrdCmsNode *theNode, int immed)
    && (altNode = theNode->cidP->RemNode(theNode)))
       {if (altNode->isBound) NodeCnt++;
        NodeTab[NodeID] = altNode;
+       Publish(altNode);
        if (Config.asManager())
           CmsState.Update(XrdCmsState::Counts,
                           altNode->isBad & XrdCmsNode::isSuspend ? 0 :  1,
@@ -1724,6 +1753,13 @@ int XrdCmsCluster::SelNode(XrdCmsSelect &Sel, SMask_t pmask, SMask_t amask)
 /*                              R e f C o u n t                               */
 /******************************************************************************/
 
+// The Selbyxxx methods only visit the slots whose bit is set in the mask, in
+// ascending order just like a full scan of NodeTab would.
+//
+#define ForEachSlot(i, mask) \
+        for (SMask_t sVec = mask; sVec && ((i = __builtin_ctzll(sVec)) <= STHi);\
+             sVec &= (sVec - 1))
+
 // This snippet of code occurrs often enough so that we make it a macro as we
 // want to execute this inline.
 //
@@ -1748,11 +1784,12 @@ XrdCmsNode *XrdCmsCluster::SelbyCost(SMask_t mask, XrdCmsSelector &selR)
 {
     XrdCmsNode *np, *sp = 0;
     bool Multi = false;
+    int i;
 
 // Scan for a node (sp points to the selected one)
 //
    selR.Reset(); SelTcnt++;
-   for (int i = 0; i <= STHi; i++)
+   ForEachSlot(i, mask)
        if ((np = NodeTab[i]) && (np->NodeMask & mask))
           {if (!(selR.needNet &  np->hasNet))    {selR.xNoNet= true; continue;}
            selR.nPick++;
@@ -1793,34 +1830,41 @@ XrdCmsNode *XrdCmsCluster::SelbyLoad(SMask_t mask, XrdCmsSelector &selR)
 {
     XrdCmsNode *np, *sp = 0;
     bool Multi = false, reqSS = (selR.needSpace & XrdCmsNode::allowsSS) != 0;
+    SMask_t ovld = SelM.Ovld, full = SelM.Full, nBit;
+    int i, s = -1;
 
-// Scan for a node (preset possible, suspended, overloaded, full, and dead)
+// Scan for a node (preset possible, suspended, overloaded, full, and dead).
+// Load and space are taken from the published metrics, s is sp's slot.
 //
    selR.Reset(); SelTcnt++;
-   for (int i = 0; i <= STHi; i++)
+   ForEachSlot(i, mask)
        if ((np = NodeTab[i]) && (np->NodeMask & mask))
-          {if (!(selR.needNet & np->hasNet))      {selR.xNoNet= true; continue;}
+          {nBit = np->NodeMask;
+           if (!(selR.needNet & np->hasNet))      {selR.xNoNet= true; continue;}
            selR.nPick++;
            if (np->isOffline)                     {selR.xOff  = true; continue;}
            if (np->isBad)                         {selR.xSusp = true; continue;}
-           if (np->myLoad > Config.MaxLoad)       {selR.xOvld = true; continue;}
-           if (selR.needSpace && (np->DiskFree < np->DiskMinF
-                                  || (reqSS && np->isNoStage)))
+           if (ovld & nBit)                       {selR.xOvld = true; continue;}
+           if (selR.needSpace && ((full & nBit) || (reqSS && np->isNoStage)))
               {selR.xFull = true; continue;}
-           if (!sp) sp = np;
+           if (!sp) {sp = np; s = i;}
               else{if (selR.needSpace)
-                      {if (abs(sp->myMass - np->myMass) <= Config.P_fuzz)
-                          {if (sp->RefW > (np->RefW+Config.DiskLinger)) sp=np;}
-                          else if (sp->myMass > np->myMass)             sp=np;
+                      {if (abs(SelM.Mass[s] - SelM.Mass[i]) <= Config.P_fuzz)
+                          {if (sp->RefW > (np->RefW+Config.DiskLinger))
+                              {sp = np; s = i;}
+                          }
+                          else if (SelM.Mass[s] > SelM.Mass[i])
+                                  {sp = np; s = i;}
                       } else {
-                       if (abs(sp->myLoad - np->myLoad) <= Config.P_fuzz)
+                       if (abs(SelM.Load[s] - SelM.Load[i]) <= Config.P_fuzz)
                           {if (selR.selPack)
-                              {if (--selR.selPack)                      sp=np;
+                              {if (--selR.selPack)         {sp = np; s = i;}
                                   else break;
                               }
-                              else if (sp->RefR > np->RefR)             sp=np;
+                              else if (sp->RefR > np->RefR) {sp = np; s = i;}
                           }
-                          else if (sp->myLoad > np->myLoad)             sp=np;
+                          else if (SelM.Load[s] > SelM.Load[i])
+                                  {sp = np; s = i;}
                       }
                    Multi = true;
                   }
@@ -1846,6 +1890,8 @@ XrdCmsNode *XrdCmsCluster::SelbyLoadR(SMask_t mask, XrdCmsSelector &selR)
 
   XrdCmsNode *np = nullptr, *sp = nullptr;
   bool reqSS = (selR.needSpace & XrdCmsNode::allowsSS) != 0;
+  SMask_t ovld = SelM.Ovld, full = SelM.Full, pass = 0;
+  int i;
 
   // Scan for a node (preset possible, suspended, overloaded, full, and dead)
 
@@ -1854,9 +1900,7 @@ XrdCmsNode *XrdCmsCluster::SelbyLoadR(SMask_t mask, XrdCmsSelector &selR)
 
   int totWeight = 0;
 
-  for (int i = 0; i <= STHi; ++i) {
-    NodeWeight[i] = 0; // make node unselectable first
-
+  ForEachSlot(i, mask) {
     if (!((np = NodeTab[i]) && (np->NodeMask & mask)))
       continue;
 
@@ -1866,24 +1910,27 @@ XrdCmsNode *XrdCmsCluster::SelbyLoadR(SMask_t mask, XrdCmsSelector &selR)
 
     if (np->isOffline)                { selR.xOff  = true; continue; }
     if (np->isBad)                    { selR.xSusp = true; continue; }
-    if (np->myLoad > Config.MaxLoad)  { selR.xOvld = true; continue; }
+    if (ovld & np->NodeMask)          { selR.xOvld = true; continue; }
 
     if (selR.needSpace) {
-      if (np->DiskFree < np->DiskMinF || (reqSS && np->isNoStage)) {
+      if ((full & np->NodeMask) || (reqSS && np->isNoStage)) {
         selR.xFull = true;
         continue;
       }
     }
 
     // If node passes filters, give it a weight
-    totWeight += Config.P_fuzz + (100 - np->myLoad);
+    totWeight += Config.P_fuzz + (100 - SelM.Load[i]);
     NodeWeight[i] = totWeight;
+    pass |= np->NodeMask;
   }
 
   std::uniform_int_distribution<int> distr(1, totWeight);
   int selected = distr(generator);
 
-  for (int i = 0; i <= STHi; ++i) {
+  // Only the nodes that passed the filters have a valid weight
+
+  ForEachSlot(i, pass) {
     if (NodeWeight[i] < selected)
       continue;
 
@@ -1904,17 +1951,19 @@ XrdCmsNode *XrdCmsCluster::SelbyRef(SMask_t mask, XrdCmsSelector &selR)
 {
     XrdCmsNode *np, *sp = 0;
     bool Multi = false, reqSS = (selR.needSpace & XrdCmsNode::allowsSS) != 0;
+    SMask_t full = SelM.Full;
+    int i;
 
 // Scan for a node (sp points to the selected one)
 //
    selR.Reset(); SelTcnt++;
-   for (int i = 0; i <= STHi; i++)
+   ForEachSlot(i, mask)
        if ((np = NodeTab[i]) && (np->NodeMask & mask))
           {if (!(selR.needNet & np->hasNet))    {selR.xNoNet= true; continue;}
            selR.nPick++;
            if (np->isOffline)                   {selR.xOff  = true; continue;}
            if (np->isBad)                       {selR.xSusp = true; continue;}
-           if (selR.needSpace && (np->DiskFree < np->DiskMinF
+           if (selR.needSpace && ((full & np->NodeMask)
                                   || (reqSS && np->isNoStage)))
               {selR.xFull = true; continue;}
            if (!sp) sp = np;
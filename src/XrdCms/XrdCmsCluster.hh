@@ -173,6 +173,11 @@ void           *MonRefs();
 //
 long long       Refs() {return SelWtot+SelRtot;}
 
+// Called when a node reports its load or space so that node selection uses
+// the new figures. The STMutex need not be held.
+//
+void            Publish(XrdCmsNode *nP);
+
 // Called to remove a node from the cluster
 //
 void            Remove(XrdCmsNode *theNode);
@@ -248,6 +253,17 @@ XrdCmsNode   *NodeTab[STMax];   // Current  set of nodes
 int           NodeWeight[STMax]; // Current set of load balancing weights
 
 int           STHi;             // NodeTab high watermark
+
+// The load figures used by node selection are kept here by slot so that the
+// Selbyxxx methods need not touch each node to filter and compare them. They
+// are only written by Publish() using the single writer principle per slot.
+//
+struct SelMetrics
+      {RAtomic_int    Load[STMax]; // Node's overall load
+       RAtomic_int    Mass[STMax]; // Node's load including space utilization
+       RAtomic_ullong Ovld;        // Nodes whose load exceeds the maximum
+       RAtomic_ullong Full;        // Nodes with less than the minimum free space
+      }           SelM;
 int           Reserved;
 RAtomic_llong SelWtot;          // Total number of r/w selections (successful)
 RAtomic_llong SelRtot;          // Total number of r/o selections (successful)
@@ -435,7 +435,8 @@ int XrdCmsConfig::Configure2()
 //
    if (QryDelay < 0) QryDelay = LUPDelay;
    if (isManager) 
-      NoGo = !Cache.Init(cachelife,LUPDelay,QryDelay,baseFS.isDFS(),emptylife);
+      NoGo = !Cache.Init(cachelife,LUPDelay,QryDelay,baseFS.isDFS(),emptylife,
+                         cachemax, cachesnap);
 
 // Issue warning if the adminpath resides in /tmp
 //
@@ -794,6 +795,8 @@ void XrdCmsConfig::ConfigDefaults(void)
    Police   = 0;
    cachelife= 8*60*60;
    emptylife= 0;
+   cachemax = 0;
+   cachesnap= 0;
    pendplife=   60*60*24*7;
    DiskLinger=0;
    ProgCH   = 0;
@@ -1895,9 +1898,14 @@ int XrdCmsConfig::xfsxq(XrdSysError *eDest, XrdOucStream &CFile)
 
 /* Function: xfxhld
 
-   Purpose:  To parse the directive: fxhold [noloc <nls>] <sec>
+   Purpose:  To parse the directive: fxhold [noloc <nls>] [limit <num>]
+                                            [snap <path>] <sec>
 
              <nls>  number of seconds (or M, H, etc) to cache file non-existence
+             <num>  maximum number of paths to cache, older ones are dropped
+                    early to stay within it. The default is no limit.
+             <path> file where the known file locations are periodically saved
+                    and from where they are reloaded upon a restart.
              <sec>  number of seconds (or M, H, etc) to cache file     existence
 
    Type: Manager only, dynamic.
@@ -1924,6 +1932,23 @@ int XrdCmsConfig::xfxhld(XrdSysError *eDest, XrdOucStream &CFile)
         if (!(val = CFile.GetWord())) return 0;
        }
 
+    if (!strcmp(val, "limit"))
+       {if (!(val = CFile.GetWord()))
+           {eDest->Emsg("Config","fxhold limit value not specified."); return 1;}
+        if (XrdOuca2x::a2i(*eDest, "fxhold limit value", val, &ct, 0))
+           return 1;
+        cachemax = ct;
+        if (!(val = CFile.GetWord())) return 0;
+       }
+
+    if (!strcmp(val, "snap"))
+       {if (!(val = CFile.GetWord()) || *val != '/')
+           {eDest->Emsg("Config","fxhold snap path not specified."); return 1;}
+        if (cachesnap) free(cachesnap);
+        cachesnap = strdup(val);
+        if (!(val = CFile.GetWord())) return 0;
+       }
+
     if (XrdOuca2x::a2tm(*eDest, "fxhold value", val, &ct, 60)) return 1;
 
     cachelife = ct;
@@ -276,6 +276,8 @@ char             *perfpgm;
 int               perfint;
 int               cachelife;
 int               emptylife;
+int               cachemax;
+char             *cachesnap;
 int               pendplife;
 int               FSlim;
 };
@@ -58,7 +58,7 @@ void XrdCmsKey::setHash()
 /*                           S t a t i c   D a t a                            */
 /******************************************************************************/
   
-XrdCmsKeyItem *XrdCmsKeyItem::TockTable[TickRate] = {0};
+XrdSysMutex    XrdCmsKeyItem::FreeMutex;
 XrdCmsKeyItem *XrdCmsKeyItem::Free    = 0;
 int            XrdCmsKeyItem::numFree = 0;
 int            XrdCmsKeyItem::numHave = 0;
@@ -68,25 +68,25 @@ int            XrdCmsKeyItem::numNull = 0;
 /* static public                   A l l o c                                  */
 /******************************************************************************/
   
-XrdCmsKeyItem *XrdCmsKeyItem::Alloc(unsigned int theTock)
+XrdCmsKeyItem *XrdCmsKeyItem::Alloc()
 {
   XrdCmsKeyItem *kP;
 
-// Try to allocate an existing item or replenish the list
+// Try to allocate an existing item or replenish the list. The caller links
+// the item into the aging list of its table.
 //
+   FreeMutex.Lock();
    do {if ((kP = Free))
           {Free = kP->Next;
            numFree--;
-           theTock &= TickMask;
-           kP->Key.TOD    = theTock;
-           kP->Key.TODRef = TockTable[theTock];
-           TockTable[theTock] = kP;
+           FreeMutex.UnLock();
            if (!(kP->Key.Ref++)) kP->Key.Ref = 1;
             kP->Loc.roPend = kP->Loc.rwPend = 0;
            return kP;
           }
        numNull++;
-       } while(Replenish());
+       } while(Refill());
+   FreeMutex.UnLock();
 
 // We failed
 //
@@ -109,28 +109,35 @@ void XrdCmsKeyItem::Recycle()
 
 // Put entry on the free list
 //
+   FreeMutex.Lock();
    Next = Free; Free = this;
    numFree++;
+   FreeMutex.UnLock();
 }
 
 /******************************************************************************/
-/* public                         R e l o a d                                 */
+/* static public               R e p l e n i s h                              */
 /******************************************************************************/
-  
-void XrdCmsKeyItem::Reload()
+
+int XrdCmsKeyItem::Replenish()
 {
-   Key.TOD &= static_cast<unsigned char>(TickMask);
-   Key.TODRef = TockTable[Key.TOD];
-   TockTable[Key.TOD] = this;
+   int n;
+
+   FreeMutex.Lock();
+   n = Refill();
+   FreeMutex.UnLock();
+   return n;
 }
 
 /******************************************************************************/
-/* static public               R e p l e n i s h                              */
+/* static private                   R e f i l l                               */
 /******************************************************************************/
 
-int XrdCmsKeyItem::Replenish()
+// The FreeMutex must be held by the caller.
+
+int XrdCmsKeyItem::Refill()
 {
-   EPNAME("Replenish");
+   EPNAME("Refill");
    XrdCmsKeyItem *kP;
    int i;
 
@@ -158,53 +165,10 @@ int XrdCmsKeyItem::Replenish()
 
 void XrdCmsKeyItem::Stats(int &isAlloc, int &isFree, int &wasNull)
 {
-
+   FreeMutex.Lock();
    isAlloc  = numHave;
    isFree   = numFree;
    wasNull  = numNull;
    numNull  = 0;
-}
-
-/******************************************************************************/
-/* static public                  U n l o a d                                 */
-/******************************************************************************/
-  
-XrdCmsKeyItem *XrdCmsKeyItem::Unload(unsigned int theTock)
-{
-   XrdCmsKeyItem myItem, *nP, *pP = &myItem;
-
-// Remove all entries from the indicated list. If any entries have been
-// reassigned to a different list, move them to the right list. Otherwise,
-// make the entry unfindable by clearing the hash code. Since item recycling
-// requires knowing the hash code, we save it elsewhere in the object.
-//
-   theTock &= TickMask;
-   myItem.Key.TODRef = TockTable[theTock]; TockTable[theTock] = 0;
-   while((nP = pP->Key.TODRef))
-         if (nP->Key.TOD == theTock) 
-            {nP->Loc.HashSave = nP->Key.Hash; nP->Key.Hash = 0; pP = nP;}
-            else {pP->Key.TODRef = nP->Key.TODRef;
-                  nP->Key.TODRef = TockTable[nP->Key.TOD];
-                  TockTable[nP->Key.TOD] = nP;
-                 }
-   return myItem.Key.TODRef;
-}
-
-/******************************************************************************/
-  
-XrdCmsKeyItem *XrdCmsKeyItem::Unload(XrdCmsKeyItem *theItem)
-{
-   XrdCmsKeyItem *kP, *pP = 0;
-   unsigned int theTock = theItem->Key.TOD & TickMask;
-
-// Remove the entry from the right list
-//
-   kP = TockTable[theTock];
-   while(kP && kP != theItem) {pP = kP; kP = kP->Key.TODRef;}
-   if (kP)
-      {if (pP) pP->Key.TODRef     = kP->Key.TODRef;
-          else TockTable[theTock] = kP->Key.TODRef;
-       kP->Loc.HashSave = kP->Key.Hash; kP->Key.Hash = 0;
-      }
-   return kP;
+   FreeMutex.UnLock();
 }
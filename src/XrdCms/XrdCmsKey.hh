@@ -33,6 +33,7 @@
 #include <cstring>
 
 #include "XrdCms/XrdCmsTypes.hh"
+#include "XrdSys/XrdSysPthread.hh"
 
 /******************************************************************************/
 /*                       C l a s s   X r d C m s K e y                        */
@@ -120,7 +121,9 @@ XrdCmsKeyLoc&  operator=(const XrdCmsKeyLoc &rhs)
   
 // The XrdCmsKeyItem object marries the XrdCmsKey and XrdCmsKeyLoc objects in
 // the key cache. It is only used by logical manipulator, XrdCmsCache, which
-// always front-ends the physical manipulator, XrdCmsNash.
+// always front-ends the physical manipulator, XrdCmsNash. The free list is
+// shared by all of the cache shards and has its own lock; the lists used to
+// age items belong to the XrdCmsNash table holding the item.
 //
 class XrdCmsKeyItem
 {
@@ -130,20 +133,14 @@ public:
        XrdCmsKey      Key;
        XrdCmsKeyItem *Next;
 
-static XrdCmsKeyItem *Alloc(unsigned int theTock);
+static XrdCmsKeyItem *Alloc();
 
        void           Recycle();
 
-       void           Reload();
-
 static int            Replenish();
 
 static void           Stats(int &isAlloc, int &isFree, int &wasEmpty);
 
-static XrdCmsKeyItem *Unload(unsigned int   theTock);
-
-static XrdCmsKeyItem *Unload(XrdCmsKeyItem *theItem);
-
        XrdCmsKeyItem() {}  // Warning see the constructor!
       ~XrdCmsKeyItem() {}  // These are usually never deleted
 
@@ -154,7 +151,9 @@ static const          int minFree  = 1024;
 
 private:
 
-static XrdCmsKeyItem *TockTable[TickRate];
+static int            Refill();
+
+static XrdSysMutex    FreeMutex;
 static XrdCmsKeyItem *Free;
 static int            numFree;
 static int            numHave;
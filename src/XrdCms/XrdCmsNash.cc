@@ -42,6 +42,8 @@ XrdCmsNash::XrdCmsNash(int psize, int csize)
      nashtablesize = csize;
      Threshold     = (csize * LoadMax) / 100;
      nashnum       = 0;
+     nashlive      = 0;
+     memset((void *)TockTable, 0, sizeof(TockTable));
      nashtable     = (XrdCmsKeyItem **)
                      malloc( (size_t)(csize*sizeof(XrdCmsKeyItem *)) );
      memset((void *)nashtable, 0, (size_t)(csize*sizeof(XrdCmsKeyItem *)));
@@ -58,7 +60,7 @@ XrdCmsKeyItem *XrdCmsNash::Add(XrdCmsKey &Key)
 
 // Allocate the entry
 //
-   if (!(hip = XrdCmsKeyItem::Alloc(Key.TOD))) return (XrdCmsKeyItem *)0;
+   if (!(hip = XrdCmsKeyItem::Alloc())) return (XrdCmsKeyItem *)0;
 
 // Check if we should expand the table
 //
@@ -69,6 +71,13 @@ XrdCmsKeyItem *XrdCmsNash::Add(XrdCmsKey &Key)
    if (!Key.Hash) Key.setHash();
    hip->Key = Key;
 
+// Add the entry to the aging list for its tock
+//
+   hip->Key.TOD    = Key.TOD & XrdCmsKeyItem::TickMask;
+   hip->Key.TODRef = TockTable[hip->Key.TOD];
+   TockTable[hip->Key.TOD] = hip;
+   nashlive++;
+
 // Add the entry to the table
 //
    kent = Key.Hash % nashtablesize;
@@ -76,6 +85,21 @@ XrdCmsKeyItem *XrdCmsNash::Add(XrdCmsKey &Key)
    nashtable[kent] = hip;
    return hip;
 }
+
+/******************************************************************************/
+/* public                          A p p l y                                  */
+/******************************************************************************/
+  
+// Calls func for every item in the table that can still be found.
+
+void XrdCmsNash::Apply(void (*func)(XrdCmsKeyItem *, void *), void *Arg)
+{
+   XrdCmsKeyItem *nip;
+
+   for (int i = 0; i < nashtablesize; i++)
+       for (nip = nashtable[i]; nip; nip = nip->Next)
+           if (nip->Key.Hash) func(nip, Arg);
+}
   
 /******************************************************************************/
 /* private                        E x p a n d                                 */
@@ -177,3 +201,50 @@ int XrdCmsNash::Recycle(XrdCmsKeyItem *rip)
       }
    return nip != 0;
 }
+
+/******************************************************************************/
+/* public                          U n l o a d                                */
+/******************************************************************************/
+  
+XrdCmsKeyItem *XrdCmsNash::Unload(unsigned int theTock)
+{
+   XrdCmsKeyItem myItem, *nP, *pP = &myItem;
+
+// Remove all entries from the indicated list. If any entries have been
+// reassigned to a different list, move them to the right list. Otherwise,
+// make the entry unfindable by clearing the hash code. Since item recycling
+// requires knowing the hash code, we save it elsewhere in the object.
+//
+   theTock &= XrdCmsKeyItem::TickMask;
+   myItem.Key.TODRef = TockTable[theTock]; TockTable[theTock] = 0;
+   while((nP = pP->Key.TODRef))
+         if (nP->Key.TOD == theTock) 
+            {nP->Loc.HashSave = nP->Key.Hash; nP->Key.Hash = 0; pP = nP;
+             nashlive--;
+            }
+            else {pP->Key.TODRef = nP->Key.TODRef;
+                  nP->Key.TODRef = TockTable[nP->Key.TOD];
+                  TockTable[nP->Key.TOD] = nP;
+                 }
+   return myItem.Key.TODRef;
+}
+
+/******************************************************************************/
+  
+XrdCmsKeyItem *XrdCmsNash::Unload(XrdCmsKeyItem *theItem)
+{
+   XrdCmsKeyItem *kP, *pP = 0;
+   unsigned int theTock = theItem->Key.TOD & XrdCmsKeyItem::TickMask;
+
+// Remove the entry from the right list
+//
+   kP = TockTable[theTock];
+   while(kP && kP != theItem) {pP = kP; kP = kP->Key.TODRef;}
+   if (kP)
+      {if (pP) pP->Key.TODRef     = kP->Key.TODRef;
+          else TockTable[theTock] = kP->Key.TODRef;
+       kP->Loc.HashSave = kP->Key.Hash; kP->Key.Hash = 0;
+       nashlive--;
+      }
+   return kP;
+}
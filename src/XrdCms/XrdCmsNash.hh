@@ -37,10 +37,21 @@ class XrdCmsNash
 public:
 XrdCmsKeyItem *Add(XrdCmsKey &Key);
 
+void           Apply(void (*func)(XrdCmsKeyItem *, void *), void *Arg);
+
 XrdCmsKeyItem *Find(XrdCmsKey &Key);
 
+int            Live() {return nashlive;}
+
 int            Recycle(XrdCmsKeyItem *rip);
 
+// Unload() makes all items added at the given tock, or the given item,
+// unfindable and returns them chained via Key.TODRef for later Recycle().
+//
+XrdCmsKeyItem *Unload(unsigned int   theTock);
+
+XrdCmsKeyItem *Unload(XrdCmsKeyItem *theItem);
+
 // When allocateing a new nash, specify the required starting size. Make
 // sure that the previous number is the correct Fibonocci antecedent. The
 // series is simply n[j] = n[j-1] + n[j-2].
@@ -55,9 +66,11 @@ static const int LoadMax = 80;
 void               Expand();
 
 XrdCmsKeyItem  **nashtable;
+XrdCmsKeyItem   *TockTable[XrdCmsKeyItem::TickRate];
 int              prevtablesize;
 int              nashtablesize;
 int              nashnum;
+int              nashlive;
 int              Threshold;
 };
 #endif
@@ -289,6 +289,7 @@ const char *XrdCmsNode::do_Avail(XrdCmsRRData &Arg)
 //
    DiskFree = Arg.dskFree;
    DiskUtil = static_cast<int>(Arg.dskUtil);
+   Cluster.Publish(this);
 
 // Do some debugging
 //
@@ -478,6 +479,7 @@ const char *XrdCmsNode::do_Load(XrdCmsRRData &Arg)
    myMass = Meter.calcLoad(myLoad, pdsk);
    DiskFree = Arg.dskFree;
    DiskUtil = pdsk;
+   Cluster.Publish(this);
 
 // Do some debugging
 //
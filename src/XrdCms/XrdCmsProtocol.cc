@@ -755,6 +755,7 @@ XrdCmsRouting *XrdCmsProtocol::Admit()
    myNode->DiskFree  = Data.fSpace;
    myNode->DiskNums  = Data.fsNum;
    myNode->DiskUtil  = Data.fsUtil;
+   Cluster.Publish(myNode);
    Meter.setVirtUpdt();
 
 // Check for any configuration changes and then process all of the paths.
@@ -794,6 +795,16 @@ XrdCmsRouting *XrdCmsProtocol::Admit()
    if (Config.asManager()) {Manager->Reset(); myNode->SyncSpace();}
    myNode->isBad &= ~XrdCmsNode::isDisabled;
 
+// Preload the file locations this node had before we were restarted, if any.
+// This must follow the cache bounce in ConfigCheck() to stick.
+//
+   if (Config.asManager())
+      {char nBuff[320];
+       int  nInst;
+       snprintf(nBuff, sizeof(nBuff), "%s:%d", myNode->Name(), Data.dPort);
+       Cache.Warm(myNode->Mask(), myNode->ID(nInst), nBuff);
+      }
+
 // At this point we can switch to nonblocking sendq for this node
 //
    if (Config.nbSQ && (Config.nbSQ > 1 || !myNode->inDomain()))
@@ -76,6 +76,11 @@ namespace XrdEc
 
       bool enable_plugins;
 
+      //! number of blocks erasure coded together in a single thread-pool job
+      size_t encode_batch;
+      //! maximum number of blocks per writer that are queued for encoding
+      size_t encode_queue;
+
     private:
 
       std::unordered_map<std::string, RedundancyProvider> redundancies;
@@ -84,7 +89,7 @@ namespace XrdEc
       //-----------------------------------------------------------------------
       //! Constructor
       //-----------------------------------------------------------------------
-      Config() : enable_plugins( true )
+      Config() : enable_plugins( true ), encode_batch( 4 ), encode_queue( 32 )
       {
       }
 
@@ -150,11 +150,25 @@ static int gf_gen_decode_matrix(
 
 RedundancyProvider::RedundancyProvider( const ObjCfg &objcfg ) :
     objcfg( objcfg ),
-    encode_matrix( objcfg.nbchunks * objcfg.nbdata )
+    encode_matrix( objcfg.nbchunks * objcfg.nbdata ),
+    encode_pattern( objcfg.nbchunks, 0 )
 {
   // k = data
   // m = data + parity
   gf_gen_cauchy1_matrix( encode_matrix.data(), static_cast<int>( objcfg.nbchunks ), static_cast<int>( objcfg.nbdata ) );
+
+  /* The first k rows of the encode matrix are the identity, so the parity is
+     given directly by the remaining rows. Prepare the tables once, writes
+     then never need to look them up in the cache. */
+  std::fill( encode_pattern.begin() + objcfg.nbdata, encode_pattern.end(), '\1' );
+  encode_table.nErrors = objcfg.nbparity;
+  encode_table.blockIndices.resize( objcfg.nbdata );
+  for( uint8_t i = 0; i < objcfg.nbdata; ++i )
+    encode_table.blockIndices[i] = i;
+  encode_table.table.resize( objcfg.nbdata * objcfg.nbparity * 32 );
+  if( objcfg.nbparity )
+    ec_init_tables( static_cast<int>( objcfg.nbdata ), static_cast<int>( objcfg.nbparity ),
+                    &encode_matrix[objcfg.nbdata * objcfg.nbdata], encode_table.table.data() );
 }
 
 
@@ -170,7 +184,15 @@ std::string RedundancyProvider::getErrorPattern( stripes_t &stripes ) const
 
 RedundancyProvider::CodingTable& RedundancyProvider::getCodingTable( const std::string& pattern )
 {
-  std::lock_guard<std::mutex> lock(mutex);
+  if( pattern == encode_pattern ) return encode_table;
+
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto itr = cache.find( pattern );
+    if( itr != cache.end() ) return itr->second;
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex);
 
   /* If decode matrix is not already cached we have to construct it. */
   if( !cache.count(pattern) )
@@ -230,50 +252,91 @@ void RedundancyProvider::replication( stripes_t &stripes )
   }
 }
 
-void RedundancyProvider::compute( stripes_t &stripes )
+void RedundancyProvider::encodeStripe( stripes_t &stripes, const std::string &pattern,
+                                       const CodingTable &dd )
 {
-  /* throws if stripe is not recoverable */
-  std::string pattern = getErrorPattern( stripes );
-
-  /* nothing to do if there are no parity blocks. */
-  if ( !objcfg.nbparity ) return;
-
-  /* in case of a single data block use replication */
-  if ( objcfg.nbdata == 1 )
-    return replication( stripes );
-
-  /* normal operation: erasure coding */
-  CodingTable& dd = getCodingTable(pattern);
+  if( !dd.nErrors ) return;
 
   unsigned char* inbuf[objcfg.nbdata];
   for( uint8_t i = 0; i < objcfg.nbdata; i++ )
     inbuf[i] = reinterpret_cast<unsigned char*>( stripes[dd.blockIndices[i]].buffer );
 
-  std::vector<unsigned char> memory( dd.nErrors * objcfg.chunksize );
-
+  /* The rows of the coding table follow the order of the missing blocks in
+     the pattern, so with a recent enough isa-l (see the configure check) the
+     blocks are computed in place rather than copied from scratch buffers. */
   unsigned char* outbuf[dd.nErrors];
-  for (int i = 0; i < dd.nErrors; i++)
+#ifdef XRDEC_INPLACE_ENCODE
+  int e = 0;
+  for( size_t i = 0; i < objcfg.nbchunks; i++ )
   {
-    outbuf[i] = &memory[i * objcfg.chunksize];
+    if( pattern[i] )
+      outbuf[e++] = reinterpret_cast<unsigned char*>( stripes[i].buffer );
   }
+#else
+  std::vector<unsigned char> memory( dd.nErrors * objcfg.chunksize );
+  for( int i = 0; i < dd.nErrors; i++ )
+    outbuf[i] = &memory[i * objcfg.chunksize];
+#endif
 
   ec_encode_data(
       static_cast<int>( objcfg.chunksize ), // Length of each block of data (vector) of source or destination data.
       static_cast<int>( objcfg.nbdata ),     // The number of vector sources in the generator matrix for coding.
       dd.nErrors,     // The number of output vectors to concurrently encode/decode.
-      dd.table.data(), // Pointer to array of input tables
+      const_cast<unsigned char*>( dd.table.data() ), // Pointer to array of input tables
       inbuf,          // Array of pointers to source input buffers
       outbuf          // Array of pointers to coded output buffers
   );
 
+#ifndef XRDEC_INPLACE_ENCODE
   int e = 0;
-  for (size_t i = 0; i < objcfg.nbchunks; i++)
+  for( size_t i = 0; i < objcfg.nbchunks; i++ )
   {
     if( pattern[i] )
+      memcpy( stripes[i].buffer, outbuf[e++], objcfg.chunksize );
+  }
+#endif
+}
+
+void RedundancyProvider::compute( stripes_t &stripes )
+{
+  /* throws if stripe is not recoverable */
+  std::string pattern = getErrorPattern( stripes );
+
+  /* nothing to do if there are no parity blocks. */
+  if ( !objcfg.nbparity ) return;
+
+  /* in case of a single data block use replication */
+  if ( objcfg.nbdata == 1 )
+    return replication( stripes );
+
+  /* normal operation: erasure coding */
+  encodeStripe( stripes, pattern, getCodingTable( pattern ) );
+}
+
+void RedundancyProvider::compute( std::vector<stripes_t*> &batch )
+{
+  /* nothing to do if there are no parity blocks. */
+  if ( !objcfg.nbparity ) return;
+
+  std::string  pattern;
+  CodingTable *dd = nullptr;
+  for( stripes_t *stripes : batch )
+  {
+    /* in case of a single data block use replication */
+    if ( objcfg.nbdata == 1 )
+    {
+      replication( *stripes );
+      continue;
+    }
+
+    /* throws if stripe is not recoverable */
+    std::string p = getErrorPattern( *stripes );
+    if( !dd || p != pattern )
     {
-      memcpy( stripes[i].buffer, outbuf[e], objcfg.chunksize );
-      e++;
+      pattern = std::move( p );
+      dd = &getCodingTable( pattern );
     }
+    encodeStripe( *stripes, pattern, *dd );
   }
 }
 
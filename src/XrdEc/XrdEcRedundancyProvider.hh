@@ -30,6 +30,7 @@
 #include <string>
 #include <unordered_map>
 #include <mutex>
+#include <shared_mutex>
 
 namespace XrdEc
 {
@@ -50,6 +51,15 @@ namespace XrdEc
     //--------------------------------------------------------------------------
     void compute( stripes_t &stripes );
 
+    //--------------------------------------------------------------------------
+    //! Compute all missing data and parity blocks in several stripes, e.g. the
+    //! consecutive blocks of a file. Consecutive stripes with the same error
+    //! pattern share a single coding table lookup.
+    //!
+    //! @param batch stripes to complete, @see compute( stripes_t& )
+    //--------------------------------------------------------------------------
+    void compute( std::vector<stripes_t*> &batch );
+
     //--------------------------------------------------------------------------
     //! Constructor.
     //! Stripe parameters (number of data and parity blocks) are constant per
@@ -95,6 +105,17 @@ namespace XrdEc
         const std::string& pattern
     );
 
+    //--------------------------------------------------------------------------
+    //! Compute the missing blocks of a single stripe straight into their
+    //! buffers.
+    //!
+    //! @param stripes the stripe
+    //! @param pattern its error pattern
+    //! @param dd      the coding table for the error pattern
+    //--------------------------------------------------------------------------
+    void encodeStripe( stripes_t &stripes, const std::string &pattern,
+                       const CodingTable &dd );
+
   private:
 
     void replication( stripes_t &stripes );
@@ -103,10 +124,14 @@ namespace XrdEc
 
     //! the encoding matrix, required to compute any decode matrix
     std::vector<unsigned char> encode_matrix;
+    //! error pattern of a stripe with all the parity blocks missing
+    std::string encode_pattern;
+    //! coding table for encode_pattern, used for every write
+    CodingTable encode_table;
     //! a cache of previously used coding tables
     std::unordered_map<std::string, CodingTable> cache;
-    //! concurrency control
-    std::mutex mutex;
+    //! concurrency control, lookups in the cache are shared
+    std::shared_mutex mutex;
   };
 
 }
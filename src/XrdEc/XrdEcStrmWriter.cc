@@ -117,6 +117,7 @@ namespace XrdEc
     // Take care of the left-over data ...
     //-------------------------------------------------------------------------
     if( wrtbuff && !wrtbuff->Empty() ) EnqueueBuff( std::move( wrtbuff ) );
+    FlushBuffs();
     //-------------------------------------------------------------------------
     // Let the global status handle the close
     //-------------------------------------------------------------------------
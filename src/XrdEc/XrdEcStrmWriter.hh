@@ -40,6 +40,8 @@
 #include <vector>
 #include <thread>
 #include <iterator>
+#include <mutex>
+#include <condition_variable>
 
 #include <sys/stat.h>
 
@@ -211,22 +213,59 @@ namespace XrdEc
       };
 
       //-----------------------------------------------------------------------
-      //! Enqueue the write buffer for calculating parity and crc32c
+      //! Enqueue the write buffer for calculating parity and crc32c, full
+      //! buffers are collected and erasure coded in batches
       //!
       //! @param wrtbuff : the write buffer
       //-----------------------------------------------------------------------
       inline void EnqueueBuff( std::unique_ptr<WrtBuff> wrtbuff )
       {
+        pending.emplace_back( std::move( wrtbuff ) );
+        if( pending.size() >= Config::Instance().encode_batch )
+          FlushBuffs();
+      }
+
+      //-----------------------------------------------------------------------
+      //! Submit all the pending write buffers for calculating parity and
+      //! crc32c in a single thread-pool job. Blocks if there are already
+      //! too many buffers waiting to be erasure coded.
+      //-----------------------------------------------------------------------
+      inline void FlushBuffs()
+      {
+        if( pending.empty() ) return;
+
+        struct batch_t
+        {
+          std::vector<WrtBuff*>               buffs;
+          std::vector<std::promise<WrtBuff*>> prms;
+        };
         // the routine to be called in the thread-pool
         // - does erasure coding
         // - calculates crc32cs
-        static auto prepare_buff = []( WrtBuff *wrtbuff )
+        static auto prepare_batch = []( std::shared_ptr<batch_t> batch )
         {
-          std::unique_ptr<WrtBuff> ptr( wrtbuff );
-          ptr->Encode();
-          return ptr.release();
+          WrtBuff::Encode( batch->buffs.data(), batch->buffs.size() );
+          for( size_t i = 0; i < batch->buffs.size(); ++i )
+            batch->prms[i].set_value( batch->buffs[i] );
         };
-        buffers.enqueue( ThreadPool::Instance().Execute( prepare_buff, wrtbuff.release() ) );
+
+        // don't let the encoding fall too far behind
+        {
+          std::unique_lock<std::mutex> lck( queue_mtx );
+          size_t limit = Config::Instance().encode_queue;
+          queue_cv.wait( lck, [this, limit]{ return queued == 0 || queued + pending.size() <= limit; } );
+          queued += pending.size();
+        }
+
+        auto batch = std::make_shared<batch_t>();
+        batch->prms.resize( pending.size() );
+        for( size_t i = 0; i < pending.size(); ++i )
+        {
+          batch->buffs.push_back( pending[i].release() );
+          buffers.enqueue( batch->prms[i].get_future() );
+        }
+        pending.clear();
+        ThreadPool::Instance().Execute( prepare_batch, std::move( batch ) );
       }
 
       //-----------------------------------------------------------------------
@@ -238,6 +277,9 @@ namespace XrdEc
       {
         std::future<WrtBuff*> ftr = buffers.dequeue();
         std::unique_ptr<WrtBuff> result( ftr.get() );
+        std::unique_lock<std::mutex> lck( queue_mtx );
+        --queued;
+        queue_cv.notify_all();
         return result;
       }
 
@@ -286,6 +328,11 @@ namespace XrdEc
       std::vector<std::shared_ptr<XrdCl::ZipArchive>>  dataarchs;          //< ZIP archives with data
       std::vector<std::shared_ptr<XrdCl::File>>        metadataarchs;      //< ZIP archives with metadata
       std::vector<std::vector<char>>                   cdbuffs;            //< buffers with CDs
+      std::vector<std::unique_ptr<WrtBuff>>            pending;            //< full buffers waiting to be submitted
+                                                                           //< for erasure coding as a batch
+      std::mutex                                       queue_mtx;          //< protects queued
+      std::condition_variable                          queue_cv;           //< signaled when a buffer leaves the queue
+      size_t                                           queued = 0;         //< number of buffers being erasure coded
       buff_queue                                       buffers;            //< queue of buffer for writing
                                                                            //< (waiting to be erasure coded)
       std::atomic<bool>                                writer_thread_stop; //< true if the writer thread should be stopped,
@@ -256,20 +256,42 @@ namespace XrdEc
       //-----------------------------------------------------------------------
       inline void Encode()
       {
-        // first calculate the parity
-        uint8_t i ;
-        for( i = 0; i < objcfg.nbchunks; ++i )
-          stripes.emplace_back( wrtbuff.GetBuffer( i * objcfg.chunksize ), i < objcfg.nbdata );
-        Config &cfg = Config::Instance();
-        cfg.GetRedundancy( objcfg ).compute( stripes );
-        // then calculate the checksums
-        cksums.reserve( objcfg.nbchunks );
-        for( uint8_t strpnb = 0; strpnb < objcfg.nbchunks; ++strpnb )
+        WrtBuff *self = this;
+        Encode( &self, 1 );
+      }
+      //-----------------------------------------------------------------------
+      //! Calculate the parity and the crc32cs for several buffers of the
+      //! same data object, all the stripes are erasure coded in one go. The
+      //! crc32cs of the data stripes are calculated in the thread-pool while
+      //! the parity is being computed.
+      //!
+      //! @param buffs : the buffers
+      //! @param count : number of buffers
+      //-----------------------------------------------------------------------
+      static void Encode( WrtBuff **buffs, size_t count )
+      {
+        if( !count ) return;
+        const ObjCfg &objcfg = buffs[0]->objcfg;
+        std::vector<stripes_t*> batch;
+        batch.reserve( count );
+        // first schedule the checksums of the data stripes
+        for( size_t b = 0; b < count; ++b )
         {
-          size_t chunksize = GetStrpSize( strpnb );
-          std::future<uint32_t> ftr = ThreadPool::Instance().Execute( objcfg.digest, 0, stripes[strpnb].buffer, chunksize );
-          cksums.emplace_back( std::move( ftr ) );
+          WrtBuff &wb = *buffs[b];
+          for( uint8_t i = 0; i < objcfg.nbchunks; ++i )
+            wb.stripes.emplace_back( wb.wrtbuff.GetBuffer( i * objcfg.chunksize ), i < objcfg.nbdata );
+          wb.cksums.reserve( objcfg.nbchunks );
+          for( uint8_t strpnb = 0; strpnb < objcfg.nbdata; ++strpnb )
+            wb.Checksum( strpnb );
+          batch.push_back( &wb.stripes );
         }
+        // then calculate the parity
+        Config &cfg = Config::Instance();
+        cfg.GetRedundancy( objcfg ).compute( batch );
+        // and finally the checksums of the parity stripes
+        for( size_t b = 0; b < count; ++b )
+          for( uint8_t strpnb = objcfg.nbdata; strpnb < objcfg.nbchunks; ++strpnb )
+            buffs[b]->Checksum( strpnb );
       }
       //-----------------------------------------------------------------------
       //! Calculate the crc32c for given data stripe
@@ -284,6 +306,18 @@ namespace XrdEc
 
     private:
 
+      //-----------------------------------------------------------------------
+      //! Schedule the crc32c calculation of the given stripe
+      //!
+      //! @param strpnb : number of the stripe
+      //-----------------------------------------------------------------------
+      inline void Checksum( uint8_t strpnb )
+      {
+        size_t chunksize = GetStrpSize( strpnb );
+        std::future<uint32_t> ftr = ThreadPool::Instance().Execute( objcfg.digest, 0, stripes[strpnb].buffer, chunksize );
+        cksums.emplace_back( std::move( ftr ) );
+      }
+
       ObjCfg                             objcfg;  //< configuration for the data object
       XrdCl::Buffer                      wrtbuff; //< the buffer for the data
       stripes_t                          stripes; //< data stripes
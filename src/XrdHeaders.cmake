@@ -190,6 +190,7 @@ if( NOT XRDCL_ONLY )
     XrdOss/XrdOssApi.hh
     XrdOss/XrdOssConfig.hh
     XrdOss/XrdOssError.hh
+    XrdOss/XrdOssUring.hh
 
     XrdCrypto/XrdCryptoX509.hh
     XrdCrypto/XrdCryptoX509Chain.hh
@@ -0,0 +1,752 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2025 by European Organization for Nuclear Research (CERN)
+// File Date: Oct 2025
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdHttpH2Session.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+namespace {
+
+const char     preface[]     = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+const size_t   prefaceLen    = sizeof(preface) - 1;
+const uint32_t frameHdrLen   = 9;
+const uint32_t maxFrame      = 16384;    // SETTINGS_MAX_FRAME_SIZE default
+const size_t   maxHdrBlock   = 65536;
+const int64_t  maxWindow     = 0x7fffffff;
+const size_t   flushSize     = 65536;
+
+enum {
+  fDATA = 0, fHEADERS = 1, fPRIORITY = 2, fRST_STREAM = 3, fSETTINGS = 4,
+  fPUSH_PROMISE = 5, fPING = 6, fGOAWAY = 7, fWINDOW_UPDATE = 8,
+  fCONTINUATION = 9
+};
+
+enum {
+  flEND_STREAM = 0x1, flACK = 0x1, flEND_HEADERS = 0x4, flPADDED = 0x8,
+  flPRIORITY = 0x20
+};
+
+enum {
+  eNO_ERROR = 0, ePROTOCOL_ERROR = 1, eINTERNAL_ERROR = 2,
+  eFLOW_CONTROL_ERROR = 3, eSTREAM_CLOSED = 5, eFRAME_SIZE_ERROR = 6,
+  eREFUSED_STREAM = 7, eCOMPRESSION_ERROR = 9, eENHANCE_YOUR_CALM = 11
+};
+
+enum {
+  sHEADER_TABLE_SIZE = 1, sENABLE_PUSH = 2, sMAX_CONCURRENT_STREAMS = 3,
+  sINITIAL_WINDOW_SIZE = 4, sMAX_FRAME_SIZE = 5
+};
+
+uint32_t get32(const uint8_t *p) {
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+         (uint32_t(p[2]) << 8) | p[3];
+}
+
+void put32(std::string &s, uint32_t v) {
+  s += static_cast<char>(v >> 24);
+  s += static_cast<char>(v >> 16);
+  s += static_cast<char>(v >> 8);
+  s += static_cast<char>(v);
+}
+
+void putSetting(std::string &s, uint16_t id, uint32_t v) {
+  s += static_cast<char>(id >> 8);
+  s += static_cast<char>(id);
+  put32(s, v);
+}
+
+std::string trim(const std::string &s) {
+  size_t b = s.find_first_not_of(" \t");
+  if (b == std::string::npos) return "";
+  size_t e = s.find_last_not_of(" \t");
+  return s.substr(b, e - b + 1);
+}
+
+// HTTP/1.1 only headers that have no place in HTTP/2 (RFC 9113 8.2.2)
+bool connectionSpecific(const std::string &name) {
+  return name == "connection" || name == "keep-alive" ||
+         name == "proxy-connection" || name == "transfer-encoding" ||
+         name == "upgrade";
+}
+
+// Field content that could not be passed on in an HTTP/1.1 header line
+bool badField(const std::string &s) {
+  for (unsigned char c : s)
+    if (c == '\r' || c == '\n' || c == '\0') return true;
+  return false;
+}
+
+// Parse "Name: value\r\n" lines into lower case names and trimmed values.
+void parseLines(const std::string &txt, size_t pos, XrdHttpHpack::HeaderList &hdrs,
+                long long &clen, bool &chunked) {
+  while (pos < txt.size()) {
+    size_t eol = txt.find('\n', pos);
+    if (eol == std::string::npos) eol = txt.size();
+    std::string line = txt.substr(pos, eol - pos);
+    pos = eol + 1;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    size_t colon = line.find(':');
+    if (colon == std::string::npos || colon == 0) continue;
+    std::string name = trim(line.substr(0, colon));
+    std::string value = trim(line.substr(colon + 1));
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    if (name == "content-length") clen = atoll(value.c_str());
+    if (name == "transfer-encoding") chunked = strcasestr(value.c_str(), "chunked");
+    if (connectionSpecific(name)) continue;
+    hdrs.emplace_back(name, value);
+  }
+}
+
+} // namespace
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdHttpH2Session::XrdHttpH2Session(RecvFunc recv, SendFunc send,
+                                   uint32_t maxStreams)
+  : recv_(std::move(recv)), send_(std::move(send)), maxStreams_(maxStreams),
+    hdrStream_(0), hdrEndStream_(false), cur_(0), lastId_(0),
+    preface_(false), settings_(false), failed_(false),
+    connSendWindow_(65535), connRecvWindow_(65535), connConsumed_(0),
+    peerInitialWindow_(65535), peerMaxFrame_(maxFrame) {}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+
+int XrdHttpH2Session::Start() {
+  std::string s;
+  putSetting(s, sMAX_CONCURRENT_STREAMS, maxStreams_);
+  putSetting(s, sINITIAL_WINDOW_SIZE, INITIAL_WINDOW);
+  queueFrame(fSETTINGS, 0, 0, s.data(), s.size());
+  queueWindowUpdate(0, CONNECTION_WINDOW - connRecvWindow_);
+  connRecvWindow_ = CONNECTION_WINDOW;
+  return flush();
+}
+
+/******************************************************************************/
+/*                                 I n p u t                                  */
+/******************************************************************************/
+
+int XrdHttpH2Session::pump(bool wait) {
+  if (failed_) return -1;
+  char buff[16384];
+  int n = recv_(buff, sizeof(buff), wait);
+  if (n < 0) {
+    failed_ = true;
+    if (err_.empty()) err_ = "connection read failed";
+    return -1;
+  }
+  if (n == 0) return 0;
+  inBuf_.append(buff, n);
+  if (processInput() < 0) return -1;
+  return flush() < 0 ? -1 : n;
+}
+
+int XrdHttpH2Session::processInput() {
+  size_t pos = 0;
+
+  if (!preface_) {
+    size_t n = std::min(inBuf_.size(), prefaceLen);
+    if (memcmp(inBuf_.data(), preface, n))
+      return fail(ePROTOCOL_ERROR, "invalid connection preface");
+    if (n < prefaceLen) return 0;
+    preface_ = true;
+    pos = prefaceLen;
+  }
+
+  while (inBuf_.size() - pos >= frameHdrLen) {
+    const uint8_t *h = reinterpret_cast<const uint8_t *>(inBuf_.data()) + pos;
+    uint32_t len = (uint32_t(h[0]) << 16) | (uint32_t(h[1]) << 8) | h[2];
+    uint8_t type = h[3], flags = h[4];
+    uint32_t id = get32(h + 5) & 0x7fffffff;
+
+    if (len > maxFrame) return fail(eFRAME_SIZE_ERROR, "frame too large");
+    if (inBuf_.size() - pos - frameHdrLen < len) break;
+
+    if (!settings_ && type != fSETTINGS)
+      return fail(ePROTOCOL_ERROR, "preface not followed by SETTINGS");
+    if (hdrStream_ && (type != fCONTINUATION || id != hdrStream_))
+      return fail(ePROTOCOL_ERROR, "header block interrupted");
+
+    if (handleFrame(type, flags, id, h + frameHdrLen, len) < 0) return -1;
+    pos += frameHdrLen + len;
+  }
+  inBuf_.erase(0, pos);
+  return 0;
+}
+
+int XrdHttpH2Session::handleFrame(uint8_t type, uint8_t flags, uint32_t id,
+                                  const uint8_t *p, uint32_t len) {
+  switch (type) {
+  case fDATA:
+    return handleData(flags, id, p, len);
+
+  case fHEADERS:
+    return handleHeaders(flags, id, p, len);
+
+  case fCONTINUATION:
+    if (!hdrStream_) return fail(ePROTOCOL_ERROR, "unexpected CONTINUATION");
+    if (hdrBlock_.size() + len > maxHdrBlock)
+      return fail(eENHANCE_YOUR_CALM, "header block too large");
+    hdrBlock_.append(reinterpret_cast<const char *>(p), len);
+    if (flags & flEND_HEADERS) {
+      uint32_t sid = hdrStream_;
+      hdrStream_ = 0;
+      return handleHeaderBlock(sid, hdrEndStream_);
+    }
+    return 0;
+
+  case fPRIORITY:
+    if (!id) return fail(ePROTOCOL_ERROR, "PRIORITY on stream 0");
+    if (len != 5) return fail(eFRAME_SIZE_ERROR, "bad PRIORITY frame");
+    return 0;
+
+  case fRST_STREAM:
+    if (!id || id > lastId_) return fail(ePROTOCOL_ERROR, "RST_STREAM on idle stream");
+    if (len != 4) return fail(eFRAME_SIZE_ERROR, "bad RST_STREAM frame");
+    {
+      auto it = streams_.find(id);
+      if (it == streams_.end()) return 0;
+      it->second.reset = true;
+      // The current stream stays until its request is done with
+      if (id != cur_) dropStream(id);
+    }
+    return 0;
+
+  case fSETTINGS:
+    if (id) return fail(ePROTOCOL_ERROR, "SETTINGS on a stream");
+    return handleSettings(flags, p, len);
+
+  case fPUSH_PROMISE:
+    return fail(ePROTOCOL_ERROR, "PUSH_PROMISE from client");
+
+  case fPING:
+    if (id) return fail(ePROTOCOL_ERROR, "PING on a stream");
+    if (len != 8) return fail(eFRAME_SIZE_ERROR, "bad PING frame");
+    if (!(flags & flACK))
+      queueFrame(fPING, flACK, 0, reinterpret_cast<const char *>(p), len);
+    return 0;
+
+  case fGOAWAY:
+    // The client opens no more streams; those it has are still served.
+    if (id) return fail(ePROTOCOL_ERROR, "GOAWAY on a stream");
+    return 0;
+
+  case fWINDOW_UPDATE:
+    return handleWindowUpdate(id, p, len);
+
+  default:
+    // Unknown frame types are ignored
+    return 0;
+  }
+}
+
+int XrdHttpH2Session::handleData(uint8_t flags, uint32_t id,
+                                 const uint8_t *p, uint32_t len) {
+  if (!id) return fail(ePROTOCOL_ERROR, "DATA on stream 0");
+  if (id > lastId_) return fail(ePROTOCOL_ERROR, "DATA on idle stream");
+
+  uint32_t pad = 0;
+  if (flags & flPADDED) {
+    if (len < 1 || p[0] >= len) return fail(ePROTOCOL_ERROR, "bad padding");
+    pad = p[0] + 1;
+  }
+
+  connRecvWindow_ -= len;
+  if (connRecvWindow_ < 0)
+    return fail(eFLOW_CONTROL_ERROR, "connection window exceeded");
+
+  auto it = streams_.find(id);
+  if (it == streams_.end() || it->second.reset || it->second.inEnded) {
+    // Data of a stream we are done with only counts for the connection
+    if (it != streams_.end() && !it->second.reset) {
+      queueRst(id, eSTREAM_CLOSED);
+      it->second.reset = true;
+    }
+    credit(0, len);
+    return 0;
+  }
+
+  Stream &s = it->second;
+  s.recvWindow -= len;
+  if (s.recvWindow < 0)
+    return fail(eFLOW_CONTROL_ERROR, "stream window exceeded");
+
+  const char *data = reinterpret_cast<const char *>(p) + (pad ? 1 : 0);
+  uint32_t dlen = len - pad;
+  if (dlen) {
+    if (s.chunked) {
+      char hdr[16];
+      snprintf(hdr, sizeof(hdr), "%x\r\n", dlen);
+      s.in += hdr;
+      s.in.append(data, dlen);
+      s.in += "\r\n";
+    } else {
+      s.in.append(data, dlen);
+    }
+  }
+  s.credit += dlen;
+  // Padding is never read, so it is returned right away
+  if (pad) credit(id, pad);
+
+  if (flags & flEND_STREAM) {
+    s.inEnded = true;
+    if (s.chunked) s.in += "0\r\n\r\n";
+  }
+  return 0;
+}
+
+int XrdHttpH2Session::handleHeaders(uint8_t flags, uint32_t id,
+                                    const uint8_t *p, uint32_t len) {
+  if (!id || !(id & 1)) return fail(ePROTOCOL_ERROR, "HEADERS on invalid stream");
+
+  uint32_t skip = 0, pad = 0;
+  if (flags & flPADDED) {
+    if (len < 1) return fail(eFRAME_SIZE_ERROR, "bad HEADERS frame");
+    pad = p[0];
+    skip = 1;
+  }
+  if (flags & flPRIORITY) skip += 5;
+  if (skip + pad > len) return fail(ePROTOCOL_ERROR, "bad padding");
+
+  hdrBlock_.assign(reinterpret_cast<const char *>(p) + skip, len - skip - pad);
+  hdrEndStream_ = flags & flEND_STREAM;
+  if (!(flags & flEND_HEADERS)) {
+    hdrStream_ = id;
+    return 0;
+  }
+  return handleHeaderBlock(id, hdrEndStream_);
+}
+
+int XrdHttpH2Session::handleHeaderBlock(uint32_t id, bool endStream) {
+  XrdHttpHpack::HeaderList hdrs;
+  bool ok = decoder_.Decode(reinterpret_cast<const uint8_t *>(hdrBlock_.data()),
+                            hdrBlock_.size(), hdrs);
+  hdrBlock_.clear();
+  if (!ok) return fail(eCOMPRESSION_ERROR, "header block decoding failed");
+
+  auto it = streams_.find(id);
+  if (it != streams_.end()) {
+    // Trailers end the request; their fields are not passed on
+    Stream &s = it->second;
+    if (s.reset) return 0;
+    if (s.inEnded || !endStream) {
+      queueRst(id, s.inEnded ? eSTREAM_CLOSED : ePROTOCOL_ERROR);
+      s.reset = true;
+      if (id != cur_) dropStream(id);
+      return 0;
+    }
+    s.inEnded = true;
+    if (s.chunked) s.in += "0\r\n\r\n";
+    return 0;
+  }
+  if (id <= lastId_) return fail(eSTREAM_CLOSED, "HEADERS on closed stream");
+  lastId_ = id;
+
+  std::string method, path, authority, fields;
+  bool regular = false, hasHost = false, hasLength = false, malformed = false;
+  std::string cookie;
+
+  for (const auto &h : hdrs) {
+    const std::string &name = h.first, &value = h.second;
+    if (badField(name) || badField(value)) { malformed = true; break; }
+    if (!name.empty() && name[0] == ':') {
+      if (regular) { malformed = true; break; }
+      if (name == ":method") method = value;
+      else if (name == ":path") path = value;
+      else if (name == ":authority") authority = value;
+      else if (name != ":scheme") { malformed = true; break; }
+      continue;
+    }
+    regular = true;
+    if (name.empty() || std::any_of(name.begin(), name.end(),
+                                    [](char c) { return isupper(c) || c == ':'; }) ||
+        connectionSpecific(name)) {
+      malformed = true;
+      break;
+    }
+    if (name == "cookie") {
+      // Cookie crumbs are put back together (RFC 9113 8.2.3)
+      if (!cookie.empty()) cookie += "; ";
+      cookie += value;
+      continue;
+    }
+    if (name == "host") hasHost = true;
+    if (name == "content-length") hasLength = true;
+    fields += name + ": " + value + "\r\n";
+  }
+  if (method.empty() || path.empty() || path.find(' ') != std::string::npos)
+    malformed = true;
+
+  if (malformed) {
+    queueRst(id, ePROTOCOL_ERROR);
+    return 0;
+  }
+  // A stream whose response is complete no longer counts against the limit,
+  // even if XrdHttpProtocol has not moved on to the next one yet
+  uint32_t open = 0;
+  for (auto &e : streams_)
+    if (!e.second.outEnded && !e.second.reset) open++;
+  if (open >= maxStreams_) {
+    queueRst(id, eREFUSED_STREAM);
+    return 0;
+  }
+
+  Stream &s = streams_[id];
+  s.in = method + " " + path + " HTTP/1.1\r\n";
+  if (!hasHost && !authority.empty()) s.in += "host: " + authority + "\r\n";
+  s.in += fields;
+  if (!cookie.empty()) s.in += "cookie: " + cookie + "\r\n";
+  // Without a length the body is passed on chunk encoded, which is what
+  // XrdHttpReq expects for uploads of unknown size
+  s.chunked = !endStream && !hasLength;
+  if (s.chunked) s.in += "transfer-encoding: chunked\r\n";
+  s.in += "\r\n";
+  s.inEnded = endStream;
+  s.recvWindow = INITIAL_WINDOW;
+  s.sendWindow = peerInitialWindow_;
+  return 0;
+}
+
+int XrdHttpH2Session::handleSettings(uint8_t flags, const uint8_t *p, uint32_t len) {
+  if (flags & flACK) {
+    if (len) return fail(eFRAME_SIZE_ERROR, "SETTINGS ACK with payload");
+    return 0;
+  }
+  if (len % 6) return fail(eFRAME_SIZE_ERROR, "bad SETTINGS frame");
+
+  for (uint32_t i = 0; i < len; i += 6) {
+    uint16_t sid = (uint16_t(p[i]) << 8) | p[i + 1];
+    uint32_t val = get32(p + i + 2);
+    switch (sid) {
+    case sENABLE_PUSH:
+      if (val > 1) return fail(ePROTOCOL_ERROR, "bad ENABLE_PUSH");
+      break;
+    case sINITIAL_WINDOW_SIZE:
+      if (val > maxWindow) return fail(eFLOW_CONTROL_ERROR, "bad INITIAL_WINDOW_SIZE");
+      for (auto &e : streams_) {
+        e.second.sendWindow += int64_t(val) - peerInitialWindow_;
+        if (e.second.sendWindow > maxWindow)
+          return fail(eFLOW_CONTROL_ERROR, "stream window overflow");
+      }
+      peerInitialWindow_ = val;
+      break;
+    case sMAX_FRAME_SIZE:
+      if (val < 16384 || val > 16777215) return fail(ePROTOCOL_ERROR, "bad MAX_FRAME_SIZE");
+      peerMaxFrame_ = val;
+      break;
+    default:
+      // The header table size only matters to an encoder using the dynamic
+      // table, ours does not.
+      break;
+    }
+  }
+  settings_ = true;
+  queueFrame(fSETTINGS, flACK, 0);
+  return 0;
+}
+
+int XrdHttpH2Session::handleWindowUpdate(uint32_t id, const uint8_t *p, uint32_t len) {
+  if (len != 4) return fail(eFRAME_SIZE_ERROR, "bad WINDOW_UPDATE frame");
+  int64_t inc = get32(p) & 0x7fffffff;
+  if (!inc) return fail(ePROTOCOL_ERROR, "zero WINDOW_UPDATE");
+
+  if (!id) {
+    connSendWindow_ += inc;
+    if (connSendWindow_ > maxWindow)
+      return fail(eFLOW_CONTROL_ERROR, "connection window overflow");
+    return 0;
+  }
+  if (id > lastId_) return fail(ePROTOCOL_ERROR, "WINDOW_UPDATE on idle stream");
+  auto it = streams_.find(id);
+  if (it == streams_.end()) return 0;
+  it->second.sendWindow += inc;
+  if (it->second.sendWindow > maxWindow)
+    return fail(eFLOW_CONTROL_ERROR, "stream window overflow");
+  return 0;
+}
+
+/******************************************************************************/
+/*                                  R e a d                                   */
+/******************************************************************************/
+
+int XrdHttpH2Session::Read(char *buff, int blen, bool wait) {
+  if (failed_ || pump(false) < 0) return -1;
+
+  Stream *s = current();
+  while (wait && s && s->in.empty() && !s->inEnded && !s->reset) {
+    if (pump(true) < 0) return -1;
+    s = current();
+  }
+  if (!s || s->in.empty() || blen <= 0) return 0;
+
+  int n = std::min<size_t>(blen, s->in.size());
+  memcpy(buff, s->in.data(), n);
+  s->in.erase(0, n);
+
+  // Framing added for chunked bodies makes this a slight overestimate,
+  // which is settled when the stream ends.
+  int64_t c = std::min<int64_t>(n, s->credit);
+  s->credit -= c;
+  credit(cur_, c);
+  return flush() < 0 ? -1 : n;
+}
+
+void XrdHttpH2Session::credit(uint32_t id, int64_t n) {
+  if (n <= 0) n = 0;
+  connConsumed_ += n;
+
+  auto it = id ? streams_.find(id) : streams_.end();
+  if (it != streams_.end()) {
+    Stream &s = it->second;
+    s.consumed += n;
+    if (!s.inEnded && !s.reset && s.consumed >= STREAM_WINDOW / 2) {
+      queueWindowUpdate(id, s.consumed);
+      s.recvWindow += s.consumed;
+      s.consumed = 0;
+    }
+  }
+  if (connConsumed_ >= CONNECTION_WINDOW / 2) {
+    queueWindowUpdate(0, connConsumed_);
+    connRecvWindow_ += connConsumed_;
+    connConsumed_ = 0;
+  }
+}
+
+/******************************************************************************/
+/*                               S t r e a m s                                */
+/******************************************************************************/
+
+XrdHttpH2Session::Stream *XrdHttpH2Session::current() {
+  if (!cur_) return nullptr;
+  auto it = streams_.find(cur_);
+  return it == streams_.end() ? nullptr : &it->second;
+}
+
+bool XrdHttpH2Session::Served() const {
+  auto it = streams_.find(cur_);
+  return it == streams_.end() || it->second.outStarted || it->second.reset;
+}
+
+bool XrdHttpH2Session::Pending() const {
+  auto it = streams_.find(cur_);
+  return !failed_ && it != streams_.end() && !it->second.in.empty();
+}
+
+void XrdHttpH2Session::dropStream(uint32_t id) {
+  auto it = streams_.find(id);
+  if (it == streams_.end()) return;
+  // Whatever the client sent and we did not read is returned to the
+  // connection window.
+  int64_t unread = it->second.credit;
+  streams_.erase(it);
+  credit(0, unread);
+}
+
+bool XrdHttpH2Session::NextStream() {
+  if (cur_) {
+    Stream *s = current();
+    // The response is complete; tell the client to stop sending a request
+    // body we will not read (RFC 9113 8.1).
+    if (s && !s->inEnded && !s->reset) queueRst(cur_, eNO_ERROR);
+    dropStream(cur_);
+    cur_ = 0;
+  }
+
+  for (auto &e : streams_) {
+    if (e.second.reset) continue;
+    cur_ = e.first;
+    Stream &s = e.second;
+    if (!s.inEnded) {
+      queueWindowUpdate(cur_, STREAM_WINDOW - s.recvWindow);
+      s.recvWindow = STREAM_WINDOW;
+    }
+    break;
+  }
+  flush();
+  return cur_ != 0;
+}
+
+/******************************************************************************/
+/*                                O u t p u t                                 */
+/******************************************************************************/
+
+int XrdHttpH2Session::SendHeaders(const std::string &hdr, bool noBody) {
+  if (failed_) return -1;
+  Stream *s = current();
+  if (!s || s->reset || s->outEnded) return 0;
+
+  // "HTTP/1.1 200 OK"
+  int code = 0;
+  size_t sp = hdr.find(' ');
+  if (sp != std::string::npos) code = atoi(hdr.c_str() + sp + 1);
+  if (code < 100 || code > 999) return fail(eINTERNAL_ERROR, "bad response status");
+
+  XrdHttpHpack::HeaderList hdrs;
+  hdrs.emplace_back(":status", std::to_string(code));
+  long long clen = -1;
+  bool chunked = false;
+  size_t eol = hdr.find('\n');
+  if (eol != std::string::npos) parseLines(hdr, eol + 1, hdrs, clen, chunked);
+
+  // Informational responses are followed by the final one
+  if (code < 200) return sendHeaderBlock(cur_, hdrs, false);
+
+  if (chunked) clen = -1;
+  s->outStarted = true;
+  bool end = noBody || code == 204 || code == 304 || clen == 0;
+  s->outLeft = clen;
+  if (end) s->outEnded = true;
+  return sendHeaderBlock(cur_, hdrs, end);
+}
+
+int XrdHttpH2Session::sendHeaderBlock(uint32_t id, const XrdHttpHpack::HeaderList &hdrs,
+                                      bool endStream) {
+  std::string block;
+  XrdHttpHpack::Encode(hdrs, block);
+
+  size_t pos = 0;
+  bool first = true;
+  do {
+    size_t n = std::min<size_t>(block.size() - pos, peerMaxFrame_);
+    bool last = pos + n == block.size();
+    uint8_t flags = (last ? flEND_HEADERS : 0) | (first && endStream ? flEND_STREAM : 0);
+    queueFrame(first ? fHEADERS : fCONTINUATION, flags, id, block.data() + pos, n);
+    pos += n;
+    first = false;
+  } while (pos < block.size());
+  return flush();
+}
+
+int XrdHttpH2Session::SendData(const char *data, long long len) {
+  if (failed_) return -1;
+  Stream *s = current();
+
+  while (len > 0) {
+    // Data for a stream the client reset, or beyond the announced length,
+    // is dropped.
+    if (!s || s->reset || s->outEnded) return flush();
+
+    while (connSendWindow_ <= 0 || s->sendWindow <= 0) {
+      if (flush() < 0 || pump(true) < 0) return -1;
+      if (!(s = current()) || s->reset) return 0;
+    }
+
+    long long n = std::min<long long>({len, (long long)peerMaxFrame_,
+                                       connSendWindow_, s->sendWindow});
+    if (s->outLeft >= 0) n = std::min(n, s->outLeft);
+    bool last = s->outLeft >= 0 && n == s->outLeft;
+
+    queueFrame(fDATA, last ? flEND_STREAM : 0, cur_, data, n);
+    connSendWindow_ -= n;
+    s->sendWindow -= n;
+    if (s->outLeft >= 0) s->outLeft -= n;
+    if (last) s->outEnded = true;
+    data += n;
+    len -= n;
+    if (outBuf_.size() >= flushSize && flush() < 0) return -1;
+  }
+  return flush();
+}
+
+int XrdHttpH2Session::EndStream(const char *trailers) {
+  if (failed_) return -1;
+  Stream *s = current();
+  if (!s || s->reset || s->outEnded) return 0;
+  s->outEnded = true;
+
+  if (trailers && *trailers) {
+    XrdHttpHpack::HeaderList hdrs;
+    long long clen = -1;
+    bool chunked = false;
+    parseLines(trailers, 0, hdrs, clen, chunked);
+    if (!hdrs.empty()) return sendHeaderBlock(cur_, hdrs, true);
+  }
+  queueFrame(fDATA, flEND_STREAM, cur_);
+  return flush();
+}
+
+void XrdHttpH2Session::Abort() {
+  Stream *s = current();
+  if (failed_ || !s || s->reset || s->outEnded) return;
+  queueRst(cur_, eINTERNAL_ERROR);
+  s->reset = true;
+  flush();
+}
+
+/******************************************************************************/
+/*                                F r a m e s                                 */
+/******************************************************************************/
+
+void XrdHttpH2Session::queueFrame(uint8_t type, uint8_t flags, uint32_t id,
+                                  const char *p, uint32_t len) {
+  outBuf_ += static_cast<char>(len >> 16);
+  outBuf_ += static_cast<char>(len >> 8);
+  outBuf_ += static_cast<char>(len);
+  outBuf_ += static_cast<char>(type);
+  outBuf_ += static_cast<char>(flags);
+  put32(outBuf_, id);
+  if (len) outBuf_.append(p, len);
+}
+
+void XrdHttpH2Session::queueRst(uint32_t id, uint32_t code) {
+  std::string s;
+  put32(s, code);
+  queueFrame(fRST_STREAM, 0, id, s.data(), s.size());
+}
+
+void XrdHttpH2Session::queueWindowUpdate(uint32_t id, int64_t inc) {
+  if (inc <= 0) return;
+  std::string s;
+  put32(s, static_cast<uint32_t>(inc));
+  queueFrame(fWINDOW_UPDATE, 0, id, s.data(), s.size());
+}
+
+int XrdHttpH2Session::flush() {
+  if (outBuf_.empty()) return failed_ ? -1 : 0;
+  int rc = send_(outBuf_.data(), outBuf_.size());
+  outBuf_.clear();
+  if (rc < 0) {
+    failed_ = true;
+    if (err_.empty()) err_ = "connection write failed";
+    return -1;
+  }
+  return 0;
+}
+
+int XrdHttpH2Session::fail(uint32_t code, const char *why) {
+  if (failed_) return -1;
+  std::string s;
+  put32(s, lastId_);
+  put32(s, code);
+  queueFrame(fGOAWAY, 0, 0, s.data(), s.size());
+  flush();
+  failed_ = true;
+  err_ = why;
+  return -1;
+}
@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2025 by European Organization for Nuclear Research (CERN)
+// File Date: Oct 2025
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef XROOTD_XRDHTTPH2SESSION_HH
+#define XROOTD_XRDHTTPH2SESSION_HH
+
+#include "XrdHttpHpack.hh"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+/**
+ * Server side of an HTTP/2 connection (RFC 9113).
+ *
+ * The session puts the HTTP/2 framing underneath the HTTP/1.1 request
+ * handling of XrdHttpProtocol, which serves one request at a time. Streams
+ * are therefore not multiplexed: by default the client is allowed a single
+ * open stream (SETTINGS_MAX_CONCURRENT_STREAMS of 1) and has to open more
+ * connections for concurrent requests, so that a slow request never holds
+ * up others queued behind it. With a higher limit the extra streams are
+ * queued and served in the order they were opened. The request of the
+ * stream being served is handed out by Read()
+ * in HTTP/1.1 form (request line, header lines and body, the latter chunk
+ * encoded when the client gave no length), so that XrdHttpReq parses it as
+ * usual. The response goes the other way: the HTTP/1.1 header block built by
+ * XrdHttpProtocol is turned into a HEADERS frame and the body into DATA
+ * frames, honouring the flow control windows of the client.
+ *
+ * Only the stream being served is given a large receive window. Queued
+ * streams can buffer at most the initial window, which bounds the memory a
+ * connection may tie up.
+ */
+class XrdHttpH2Session {
+public:
+
+  /**
+   * Read up to blen bytes from the connection. With wait false, return 0
+   * when nothing can be read without blocking. Return -1 on error.
+   */
+  typedef std::function<int(char *buff, int blen, bool wait)> RecvFunc;
+
+  /// Write all of blen bytes to the connection, return -1 on error.
+  typedef std::function<int(const char *buff, int blen)> SendFunc;
+
+  static constexpr uint32_t MAX_CONCURRENT_STREAMS = 1;
+  static constexpr int64_t  INITIAL_WINDOW         = 65535;
+  static constexpr int64_t  STREAM_WINDOW          = 8*1024*1024;
+  static constexpr int64_t  CONNECTION_WINDOW      = 16*1024*1024;
+
+  XrdHttpH2Session(RecvFunc recv, SendFunc send,
+                   uint32_t maxStreams = MAX_CONCURRENT_STREAMS);
+
+  /// Send the server connection preface. Returns -1 on error.
+  int  Start();
+
+  /**
+   * Copy up to blen bytes of the request of the current stream to buff.
+   * Frames that can be read without blocking are processed first. With wait
+   * true, block until at least one byte is there, the request ends or the
+   * stream is reset.
+   *
+   * @return number of bytes copied, -1 if the connection failed.
+   */
+  int  Read(char *buff, int blen, bool wait);
+
+  /**
+   * Finish the current stream and make the oldest stream with a complete
+   * request header the current one.
+   *
+   * @return false if there is no such stream.
+   */
+  bool NextStream();
+
+  /// True if there is no current stream, or its final response has been
+  /// started or it was reset, i.e. the next request may be taken up.
+  bool Served() const;
+
+  /// True if Read() has data of the current stream to return without
+  /// reading from the connection.
+  bool Pending() const;
+
+  /**
+   * Send the response header of the current stream. hdr is the HTTP/1.1
+   * status line and header lines. Connection specific headers are dropped.
+   * The stream ends here if there is no body, i.e. noBody is set or the
+   * content length is zero; otherwise it ends once Content-Length bytes are
+   * sent or EndStream() is called.
+   */
+  int  SendHeaders(const std::string &hdr, bool noBody);
+
+  /// Send part of the response body of the current stream, blocking for
+  /// window updates of the client as needed.
+  int  SendData(const char *data, long long len);
+
+  /// End the response of the current stream, with the given trailer lines
+  /// ("Name: value\r\n"...) if not null.
+  int  EndStream(const char *trailers);
+
+  /// Reset the current stream if its response is not complete.
+  void Abort();
+
+  /// True once the connection has failed, see ErrText().
+  bool Failed() const { return failed_; }
+
+  const std::string &ErrText() const { return err_; }
+
+  /// Id of the current stream, 0 if none.
+  uint32_t StreamID() const { return cur_; }
+
+private:
+
+  struct Stream {
+    std::string in;             // request in HTTP/1.1 form, not yet read
+    int64_t     credit = 0;     // received DATA bytes not yet read
+    int64_t     consumed = 0;   // read since the last window update
+    int64_t     recvWindow = 0; // bytes the client may still send
+    int64_t     sendWindow = 0;
+    long long   outLeft = -1;   // response body bytes still to send, if known
+    bool        inEnded = false;
+    bool        outStarted = false;
+    bool        chunked = false;
+    bool        reset = false;
+    bool        outEnded = false;
+  };
+
+  int      pump(bool wait);
+  int      processInput();
+  int      handleFrame(uint8_t type, uint8_t flags, uint32_t id,
+                       const uint8_t *p, uint32_t len);
+  int      handleData(uint8_t flags, uint32_t id, const uint8_t *p, uint32_t len);
+  int      handleHeaders(uint8_t flags, uint32_t id, const uint8_t *p, uint32_t len);
+  int      handleSettings(uint8_t flags, const uint8_t *p, uint32_t len);
+  int      handleHeaderBlock(uint32_t id, bool endStream);
+  int      handleWindowUpdate(uint32_t id, const uint8_t *p, uint32_t len);
+
+  Stream  *current();
+  void     credit(uint32_t id, int64_t n);
+  void     dropStream(uint32_t id);
+  int      sendHeaderBlock(uint32_t id, const XrdHttpHpack::HeaderList &hdrs,
+                           bool endStream);
+  void     queueFrame(uint8_t type, uint8_t flags, uint32_t id,
+                      const char *p = nullptr, uint32_t len = 0);
+  void     queueRst(uint32_t id, uint32_t code);
+  void     queueWindowUpdate(uint32_t id, int64_t inc);
+  int      flush();
+  int      fail(uint32_t code, const char *why);
+
+  RecvFunc                  recv_;
+  SendFunc                  send_;
+  XrdHttpHpack::Decoder     decoder_;
+  std::map<uint32_t, Stream> streams_;   // ordered by id, i.e. arrival
+  const uint32_t            maxStreams_;
+
+  std::string               inBuf_;      // received, not yet processed
+  std::string               outBuf_;     // frames not yet sent
+  std::string               hdrBlock_;   // header block being collected
+  uint32_t                  hdrStream_;  // its stream while CONTINUATIONs follow
+  bool                      hdrEndStream_;
+
+  uint32_t                  cur_;        // stream being served
+  uint32_t                  lastId_;     // highest stream opened by the client
+  bool                      preface_;
+  bool                      settings_;
+  bool                      failed_;
+  std::string               err_;
+
+  int64_t                   connSendWindow_;
+  int64_t                   connRecvWindow_;
+  int64_t                   connConsumed_;
+  int64_t                   peerInitialWindow_;
+  uint32_t                  peerMaxFrame_;
+};
+
+#endif
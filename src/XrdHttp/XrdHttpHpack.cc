@@ -0,0 +1,382 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2025 by European Organization for Nuclear Research (CERN)
+// File Date: Oct 2025
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdHttpHpack.hh"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// RFC 7541 Appendix A
+const struct { const char *name; const char *value; } staticTable[] = {
+  {":authority", ""}, {":method", "GET"}, {":method", "POST"},
+  {":path", "/"}, {":path", "/index.html"}, {":scheme", "http"},
+  {":scheme", "https"}, {":status", "200"}, {":status", "204"},
+  {":status", "206"}, {":status", "304"}, {":status", "400"},
+  {":status", "404"}, {":status", "500"}, {"accept-charset", ""},
+  {"accept-encoding", "gzip, deflate"}, {"accept-language", ""},
+  {"accept-ranges", ""}, {"accept", ""}, {"access-control-allow-origin", ""},
+  {"age", ""}, {"allow", ""}, {"authorization", ""}, {"cache-control", ""},
+  {"content-disposition", ""}, {"content-encoding", ""},
+  {"content-language", ""}, {"content-length", ""}, {"content-location", ""},
+  {"content-range", ""}, {"content-type", ""}, {"cookie", ""}, {"date", ""},
+  {"etag", ""}, {"expect", ""}, {"expires", ""}, {"from", ""}, {"host", ""},
+  {"if-match", ""}, {"if-modified-since", ""}, {"if-none-match", ""},
+  {"if-range", ""}, {"if-unmodified-since", ""}, {"last-modified", ""},
+  {"link", ""}, {"location", ""}, {"max-forwards", ""},
+  {"proxy-authenticate", ""}, {"proxy-authorization", ""}, {"range", ""},
+  {"referer", ""}, {"refresh", ""}, {"retry-after", ""}, {"server", ""},
+  {"set-cookie", ""}, {"strict-transport-security", ""},
+  {"transfer-encoding", ""}, {"user-agent", ""}, {"vary", ""}, {"via", ""},
+  {"www-authenticate", ""}
+};
+const size_t staticTableLen = sizeof(staticTable) / sizeof(staticTable[0]);
+
+// RFC 7541 Appendix B, code and length in bits of every octet
+const struct { uint32_t code; int len; } huffTable[256] = {
+  {0x00001ff8, 13}, {0x007fffd8, 23}, {0x0fffffe2, 28}, {0x0fffffe3, 28},
+  {0x0fffffe4, 28}, {0x0fffffe5, 28}, {0x0fffffe6, 28}, {0x0fffffe7, 28},
+  {0x0fffffe8, 28}, {0x00ffffea, 24}, {0x3ffffffc, 30}, {0x0fffffe9, 28},
+  {0x0fffffea, 28}, {0x3ffffffd, 30}, {0x0fffffeb, 28}, {0x0fffffec, 28},
+  {0x0fffffed, 28}, {0x0fffffee, 28}, {0x0fffffef, 28}, {0x0ffffff0, 28},
+  {0x0ffffff1, 28}, {0x0ffffff2, 28}, {0x3ffffffe, 30}, {0x0ffffff3, 28},
+  {0x0ffffff4, 28}, {0x0ffffff5, 28}, {0x0ffffff6, 28}, {0x0ffffff7, 28},
+  {0x0ffffff8, 28}, {0x0ffffff9, 28}, {0x0ffffffa, 28}, {0x0ffffffb, 28},
+  {0x00000014,  6}, {0x000003f8, 10}, {0x000003f9, 10}, {0x00000ffa, 12},
+  {0x00001ff9, 13}, {0x00000015,  6}, {0x000000f8,  8}, {0x000007fa, 11},
+  {0x000003fa, 10}, {0x000003fb, 10}, {0x000000f9,  8}, {0x000007fb, 11},
+  {0x000000fa,  8}, {0x00000016,  6}, {0x00000017,  6}, {0x00000018,  6},
+  {0x00000000,  5}, {0x00000001,  5}, {0x00000002,  5}, {0x00000019,  6},
+  {0x0000001a,  6}, {0x0000001b,  6}, {0x0000001c,  6}, {0x0000001d,  6},
+  {0x0000001e,  6}, {0x0000001f,  6}, {0x0000005c,  7}, {0x000000fb,  8},
+  {0x00007ffc, 15}, {0x00000020,  6}, {0x00000ffb, 12}, {0x000003fc, 10},
+  {0x00001ffa, 13}, {0x00000021,  6}, {0x0000005d,  7}, {0x0000005e,  7},
+  {0x0000005f,  7}, {0x00000060,  7}, {0x00000061,  7}, {0x00000062,  7},
+  {0x00000063,  7}, {0x00000064,  7}, {0x00000065,  7}, {0x00000066,  7},
+  {0x00000067,  7}, {0x00000068,  7}, {0x00000069,  7}, {0x0000006a,  7},
+  {0x0000006b,  7}, {0x0000006c,  7}, {0x0000006d,  7}, {0x0000006e,  7},
+  {0x0000006f,  7}, {0x00000070,  7}, {0x00000071,  7}, {0x00000072,  7},
+  {0x000000fc,  8}, {0x00000073,  7}, {0x000000fd,  8}, {0x00001ffb, 13},
+  {0x0007fff0, 19}, {0x00001ffc, 13}, {0x00003ffc, 14}, {0x00000022,  6},
+  {0x00007ffd, 15}, {0x00000003,  5}, {0x00000023,  6}, {0x00000004,  5},
+  {0x00000024,  6}, {0x00000005,  5}, {0x00000025,  6}, {0x00000026,  6},
+  {0x00000027,  6}, {0x00000006,  5}, {0x00000074,  7}, {0x00000075,  7},
+  {0x00000028,  6}, {0x00000029,  6}, {0x0000002a,  6}, {0x00000007,  5},
+  {0x0000002b,  6}, {0x00000076,  7}, {0x0000002c,  6}, {0x00000008,  5},
+  {0x00000009,  5}, {0x0000002d,  6}, {0x00000077,  7}, {0x00000078,  7},
+  {0x00000079,  7}, {0x0000007a,  7}, {0x0000007b,  7}, {0x00007ffe, 15},
+  {0x000007fc, 11}, {0x00003ffd, 14}, {0x00001ffd, 13}, {0x0ffffffc, 28},
+  {0x000fffe6, 20}, {0x003fffd2, 22}, {0x000fffe7, 20}, {0x000fffe8, 20},
+  {0x003fffd3, 22}, {0x003fffd4, 22}, {0x003fffd5, 22}, {0x007fffd9, 23},
+  {0x003fffd6, 22}, {0x007fffda, 23}, {0x007fffdb, 23}, {0x007fffdc, 23},
+  {0x007fffdd, 23}, {0x007fffde, 23}, {0x00ffffeb, 24}, {0x007fffdf, 23},
+  {0x00ffffec, 24}, {0x00ffffed, 24}, {0x003fffd7, 22}, {0x007fffe0, 23},
+  {0x00ffffee, 24}, {0x007fffe1, 23}, {0x007fffe2, 23}, {0x007fffe3, 23},
+  {0x007fffe4, 23}, {0x001fffdc, 21}, {0x003fffd8, 22}, {0x007fffe5, 23},
+  {0x003fffd9, 22}, {0x007fffe6, 23}, {0x007fffe7, 23}, {0x00ffffef, 24},
+  {0x003fffda, 22}, {0x001fffdd, 21}, {0x000fffe9, 20}, {0x003fffdb, 22},
+  {0x003fffdc, 22}, {0x007fffe8, 23}, {0x007fffe9, 23}, {0x001fffde, 21},
+  {0x007fffea, 23}, {0x003fffdd, 22}, {0x003fffde, 22}, {0x00fffff0, 24},
+  {0x001fffdf, 21}, {0x003fffdf, 22}, {0x007fffeb, 23}, {0x007fffec, 23},
+  {0x001fffe0, 21}, {0x001fffe1, 21}, {0x003fffe0, 22}, {0x001fffe2, 21},
+  {0x007fffed, 23}, {0x003fffe1, 22}, {0x007fffee, 23}, {0x007fffef, 23},
+  {0x000fffea, 20}, {0x003fffe2, 22}, {0x003fffe3, 22}, {0x003fffe4, 22},
+  {0x007ffff0, 23}, {0x003fffe5, 22}, {0x003fffe6, 22}, {0x007ffff1, 23},
+  {0x03ffffe0, 26}, {0x03ffffe1, 26}, {0x000fffeb, 20}, {0x0007fff1, 19},
+  {0x003fffe7, 22}, {0x007ffff2, 23}, {0x003fffe8, 22}, {0x01ffffec, 25},
+  {0x03ffffe2, 26}, {0x03ffffe3, 26}, {0x03ffffe4, 26}, {0x07ffffde, 27},
+  {0x07ffffdf, 27}, {0x03ffffe5, 26}, {0x00fffff1, 24}, {0x01ffffed, 25},
+  {0x0007fff2, 19}, {0x001fffe3, 21}, {0x03ffffe6, 26}, {0x07ffffe0, 27},
+  {0x07ffffe1, 27}, {0x03ffffe7, 26}, {0x07ffffe2, 27}, {0x00fffff2, 24},
+  {0x001fffe4, 21}, {0x001fffe5, 21}, {0x03ffffe8, 26}, {0x03ffffe9, 26},
+  {0x0ffffffd, 28}, {0x07ffffe3, 27}, {0x07ffffe4, 27}, {0x07ffffe5, 27},
+  {0x000fffec, 20}, {0x00fffff3, 24}, {0x000fffed, 20}, {0x001fffe6, 21},
+  {0x003fffe9, 22}, {0x001fffe7, 21}, {0x001fffe8, 21}, {0x007ffff3, 23},
+  {0x003fffea, 22}, {0x003fffeb, 22}, {0x01ffffee, 25}, {0x01ffffef, 25},
+  {0x00fffff4, 24}, {0x00fffff5, 24}, {0x03ffffea, 26}, {0x007ffff4, 23},
+  {0x03ffffeb, 26}, {0x07ffffe6, 27}, {0x03ffffec, 26}, {0x03ffffed, 26},
+  {0x07ffffe7, 27}, {0x07ffffe8, 27}, {0x07ffffe9, 27}, {0x07ffffea, 27},
+  {0x07ffffeb, 27}, {0x0ffffffe, 28}, {0x07ffffec, 27}, {0x07ffffed, 27},
+  {0x07ffffee, 27}, {0x07ffffef, 27}, {0x07fffff0, 27}, {0x03ffffee, 26},
+};
+const uint32_t huffEOS    = 0x3fffffff;
+const int      huffEOSLen = 30;
+
+// Binary decoding tree of the code above. Leaves hold the symbol, 256 being
+// the end-of-string code which must never appear in the data.
+struct HuffTree {
+  struct Node { int16_t child[2]; int16_t sym; };
+  std::vector<Node> nodes;
+
+  HuffTree() {
+    nodes.push_back({{-1, -1}, -1});
+    for (int s = 0; s < 256; s++) add(huffTable[s].code, huffTable[s].len, s);
+    add(huffEOS, huffEOSLen, 256);
+  }
+
+  void add(uint32_t code, int len, int sym) {
+    size_t n = 0;
+    for (int i = len - 1; i >= 0; i--) {
+      int bit = (code >> i) & 1;
+      if (nodes[n].child[bit] < 0) {
+        nodes[n].child[bit] = nodes.size();
+        nodes.push_back({{-1, -1}, -1});
+      }
+      n = nodes[n].child[bit];
+    }
+    nodes[n].sym = sym;
+  }
+};
+
+const HuffTree &huffTree() {
+  static const HuffTree tree;
+  return tree;
+}
+
+// Integer representation with an N bit prefix (RFC 7541 5.1)
+bool decodeInt(const uint8_t *&p, const uint8_t *end, int prefix, uint64_t &val) {
+  if (p >= end) return false;
+  const uint64_t mask = (1u << prefix) - 1;
+  val = *p++ & mask;
+  if (val < mask) return true;
+  for (int shift = 0; shift <= 56; shift += 7) {
+    if (p >= end) return false;
+    uint8_t b = *p++;
+    val += static_cast<uint64_t>(b & 0x7f) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+void encodeInt(std::string &out, uint8_t first, int prefix, uint64_t val) {
+  const uint64_t mask = (1u << prefix) - 1;
+  if (val < mask) {
+    out += static_cast<char>(first | val);
+    return;
+  }
+  out += static_cast<char>(first | mask);
+  val -= mask;
+  while (val >= 0x80) {
+    out += static_cast<char>((val & 0x7f) | 0x80);
+    val >>= 7;
+  }
+  out += static_cast<char>(val);
+}
+
+bool decodeString(const uint8_t *&p, const uint8_t *end, std::string &str) {
+  if (p >= end) return false;
+  bool huff = *p & 0x80;
+  uint64_t len;
+  if (!decodeInt(p, end, 7, len) || len > static_cast<uint64_t>(end - p)) return false;
+  str.clear();
+  if (huff) {
+    if (!XrdHttpHpack::HuffmanDecode(p, len, str)) return false;
+  } else {
+    str.assign(reinterpret_cast<const char *>(p), len);
+  }
+  p += len;
+  return true;
+}
+
+void encodeString(std::string &out, const std::string &str) {
+  size_t hlen = XrdHttpHpack::HuffmanLength(str);
+  if (hlen < str.size()) {
+    encodeInt(out, 0x80, 7, hlen);
+    XrdHttpHpack::HuffmanEncode(str, out);
+  } else {
+    encodeInt(out, 0, 7, str.size());
+    out += str;
+  }
+}
+
+// Table entries are charged their length plus 32 octets (RFC 7541 4.1)
+size_t entrySize(const std::string &name, const std::string &value) {
+  return name.size() + value.size() + 32;
+}
+
+} // namespace
+
+/******************************************************************************/
+/*                              H u f f m a n                                 */
+/******************************************************************************/
+
+bool XrdHttpHpack::HuffmanDecode(const uint8_t *data, size_t len, std::string &out) {
+  const HuffTree &tree = huffTree();
+  size_t n = 0;
+  int depth = 0;       // bits read since the last symbol
+  bool ones = true;    // and whether all of them were ones
+
+  for (size_t i = 0; i < len; i++) {
+    for (int b = 7; b >= 0; b--) {
+      int bit = (data[i] >> b) & 1;
+      int next = tree.nodes[n].child[bit];
+      if (next < 0) return false;
+      n = next;
+      depth++;
+      ones = ones && bit;
+      int sym = tree.nodes[n].sym;
+      if (sym >= 0) {
+        if (sym == 256) return false;
+        out += static_cast<char>(sym);
+        n = 0;
+        depth = 0;
+        ones = true;
+      }
+    }
+  }
+  // Padding is the most significant bits of the EOS code, at most 7 of them
+  return depth < 8 && ones;
+}
+
+size_t XrdHttpHpack::HuffmanLength(const std::string &in) {
+  size_t bits = 0;
+  for (unsigned char c : in) bits += huffTable[c].len;
+  return (bits + 7) / 8;
+}
+
+void XrdHttpHpack::HuffmanEncode(const std::string &in, std::string &out) {
+  uint64_t acc = 0;
+  int nbits = 0;
+  for (unsigned char c : in) {
+    acc = (acc << huffTable[c].len) | huffTable[c].code;
+    nbits += huffTable[c].len;
+    while (nbits >= 8) {
+      nbits -= 8;
+      out += static_cast<char>(acc >> nbits);
+    }
+    acc &= (1ull << nbits) - 1;
+  }
+  if (nbits) out += static_cast<char>((acc << (8 - nbits)) | (0xff >> nbits));
+}
+
+/******************************************************************************/
+/*                                E n c o d e                                 */
+/******************************************************************************/
+
+void XrdHttpHpack::Encode(const HeaderList &hdrs, std::string &out) {
+  for (const auto &h : hdrs) {
+    size_t nameIdx = 0;
+    size_t i;
+    for (i = 0; i < staticTableLen; i++) {
+      if (h.first != staticTable[i].name) continue;
+      if (h.second == staticTable[i].value) break;
+      if (!nameIdx) nameIdx = i + 1;
+    }
+    if (i < staticTableLen) {
+      // Indexed header field
+      encodeInt(out, 0x80, 7, i + 1);
+      continue;
+    }
+    // Literal header field without indexing
+    if (nameIdx) {
+      encodeInt(out, 0x00, 4, nameIdx);
+    } else {
+      out += '\0';
+      encodeString(out, h.first);
+    }
+    encodeString(out, h.second);
+  }
+}
+
+/******************************************************************************/
+/*                               D e c o d e r                                */
+/******************************************************************************/
+
+XrdHttpHpack::Decoder::Decoder(size_t maxTableSize)
+  : tableSize_(0), tableLimit_(maxTableSize), settingsLimit_(maxTableSize) {}
+
+bool XrdHttpHpack::Decoder::lookup(uint64_t idx, std::string &name,
+                                   std::string &value) const {
+  if (idx == 0) return false;
+  if (idx <= staticTableLen) {
+    name = staticTable[idx - 1].name;
+    value = staticTable[idx - 1].value;
+    return true;
+  }
+  idx -= staticTableLen + 1;
+  if (idx >= table_.size()) return false;
+  name = table_[idx].first;
+  value = table_[idx].second;
+  return true;
+}
+
+void XrdHttpHpack::Decoder::evict(size_t limit) {
+  while (tableSize_ > limit && !table_.empty()) {
+    tableSize_ -= entrySize(table_.back().first, table_.back().second);
+    table_.pop_back();
+  }
+}
+
+void XrdHttpHpack::Decoder::insert(const std::string &name, const std::string &value) {
+  size_t sz = entrySize(name, value);
+  // An entry larger than the table empties it and is not added (RFC 7541 4.4)
+  if (sz > tableLimit_) {
+    evict(0);
+    return;
+  }
+  evict(tableLimit_ - sz);
+  table_.emplace_front(name, value);
+  tableSize_ += sz;
+}
+
+bool XrdHttpHpack::Decoder::Decode(const uint8_t *data, size_t len,
+                                   HeaderList &hdrs, size_t maxListSize) {
+  const uint8_t *p = data, *end = data + len;
+  size_t listSize = 0;
+  bool first = true;
+  std::string name, value;
+
+  while (p < end) {
+    uint8_t b = *p;
+    uint64_t idx;
+
+    if (b & 0x80) {
+      // Indexed header field
+      if (!decodeInt(p, end, 7, idx) || !lookup(idx, name, value)) return false;
+    } else if ((b & 0xe0) == 0x20) {
+      // Dynamic table size update, only allowed at the start of a block
+      if (!first || !decodeInt(p, end, 5, idx) || idx > settingsLimit_) return false;
+      tableLimit_ = idx;
+      evict(tableLimit_);
+      continue;
+    } else {
+      // Literal, with incremental indexing (01), without indexing (0000)
+      // or never indexed (0001)
+      bool indexed = (b & 0xc0) == 0x40;
+      if (!decodeInt(p, end, indexed ? 6 : 4, idx)) return false;
+      if (idx) {
+        std::string ignored;
+        if (!lookup(idx, name, ignored)) return false;
+      } else if (!decodeString(p, end, name)) {
+        return false;
+      }
+      if (!decodeString(p, end, value)) return false;
+      if (indexed) insert(name, value);
+    }
+    first = false;
+
+    listSize += entrySize(name, value);
+    if (listSize > maxListSize) return false;
+    hdrs.emplace_back(name, value);
+  }
+  return true;
+}
@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2025 by European Organization for Nuclear Research (CERN)
+// File Date: Oct 2025
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef XROOTD_XRDHTTPHPACK_HH
+#define XROOTD_XRDHTTPHPACK_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * HPACK header compression (RFC 7541) as needed by the HTTP/2 server.
+ *
+ * The decoder implements the whole format, including the dynamic table and
+ * Huffman coded strings. The encoder never adds entries to the dynamic table
+ * of the peer: fields found in the static table are sent by index and all
+ * others as literals, so there is no encoder state to keep.
+ */
+class XrdHttpHpack {
+public:
+
+  typedef std::vector<std::pair<std::string, std::string>> HeaderList;
+
+  /**
+   * Decoding context of one connection. Header blocks must be passed in the
+   * order they were received, as they update the shared dynamic table.
+   */
+  class Decoder {
+  public:
+    /**
+     * @param maxTableSize  SETTINGS_HEADER_TABLE_SIZE announced to the peer,
+     *                      the upper bound for its table size updates.
+     */
+    explicit Decoder(size_t maxTableSize = 4096);
+
+    /**
+     * Decode a complete header block, appending its fields to hdrs.
+     *
+     * @param maxListSize  limit on the decoded size of the block, counted
+     *                     as in SETTINGS_MAX_HEADER_LIST_SIZE.
+     * @return false on a decoding error. The table state is then unknown
+     *         and the connection has to be closed.
+     */
+    bool Decode(const uint8_t *data, size_t len, HeaderList &hdrs,
+                size_t maxListSize = 65536);
+
+    size_t TableSize() const { return tableSize_; }
+
+  private:
+    bool   lookup(uint64_t idx, std::string &name, std::string &value) const;
+    void   insert(const std::string &name, const std::string &value);
+    void   evict(size_t limit);
+
+    std::deque<std::pair<std::string, std::string>> table_; // newest first
+    size_t tableSize_;
+    size_t tableLimit_;       // current limit, as set by the peer
+    size_t settingsLimit_;    // limit announced in our settings
+  };
+
+  /// Append the encoded header block for hdrs to out. Names must be lower case.
+  static void Encode(const HeaderList &hdrs, std::string &out);
+
+  /// Append the decoded form of a Huffman coded string to out.
+  /// Returns false if the input is not a valid code.
+  static bool HuffmanDecode(const uint8_t *data, size_t len, std::string &out);
+
+  /// Append the Huffman coded form of in to out.
+  static void HuffmanEncode(const std::string &in, std::string &out);
+
+  /// Length of the Huffman coded form of in.
+  static size_t HuffmanLength(const std::string &in);
+};
+
+#endif
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2025 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+#include "XrdHttpKTLS.hh"
+#include "Xrd/XrdLink.hh"
+
+#include <cerrno>
+
+// Once the kernel encrypts, OpenSSL writes plain record payloads; those go
+// through the XrdLink so that they are serialized with the other writes on
+// the link, counted and traced. TLS control records (alerts, session tickets,
+// key updates) must carry their record type, which only the socket BIO below
+// knows how to send. OpenSSL flags them with two controls that are not in its
+// public API; their numbers come from the configure time check. The socket
+// BIO writes them with the link's write lock held.
+//
+#if defined(XRDHTTP_KTLS_CTRL_MSG_SET) && defined(XRDHTTP_KTLS_CTRL_MSG_CLR)
+namespace
+{
+struct KTLSBioData
+{
+  XrdLink *lp;
+  bool     ctrlMsg;  // The next write is a control record
+};
+
+int SendCtrlMsg(void *next, const char *data, int datal)
+{
+  return BIO_write(static_cast<BIO *>(next), data, datal);
+}
+
+int BIO_XrdKTLS_write(BIO *bio, const char *data, int datal)
+{
+  KTLSBioData *bd = static_cast<KTLSBioData *>(BIO_get_data(bio));
+  if (!data || !bd) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  if (bd->ctrlMsg) {
+    BIO *next = BIO_next(bio);
+    BIO_clear_retry_flags(bio);
+    int ret = bd->lp->Send(data, datal, SendCtrlMsg, next);
+    if (ret > 0) bd->ctrlMsg = false;
+      else BIO_copy_next_retry(bio);
+    return ret;
+  }
+
+  errno = 0;
+  int ret = bd->lp->Send(data, datal);
+  BIO_clear_retry_flags(bio);
+  if (ret <= 0) {
+    if ((errno == EINTR) || (errno == EINPROGRESS) || (errno == EAGAIN) || (errno == EWOULDBLOCK))
+      BIO_set_retry_write(bio);
+  }
+  return ret;
+}
+
+int BIO_XrdKTLS_create(BIO *bio)
+{
+  BIO_set_init(bio, 0);
+  BIO_set_data(bio, NULL);
+  BIO_set_flags(bio, 0);
+  return 1;
+}
+
+int BIO_XrdKTLS_destroy(BIO *bio)
+{
+  if (bio == NULL) return 0;
+  delete static_cast<KTLSBioData *>(BIO_get_data(bio));
+  BIO_set_data(bio, NULL);
+  BIO_set_init(bio, 0);
+  return 1;
+}
+
+long BIO_XrdKTLS_ctrl(BIO *bio, int cmd, long num, void *ptr)
+{
+  KTLSBioData *bd = static_cast<KTLSBioData *>(BIO_get_data(bio));
+  BIO *next = BIO_next(bio);
+
+  switch (cmd) {
+  case BIO_CTRL_DUP:
+  case BIO_CTRL_FLUSH:
+    return 1;
+  case BIO_CTRL_GET_CLOSE:
+  case BIO_CTRL_SET_CLOSE:
+  case BIO_CTRL_PUSH:
+  case BIO_CTRL_POP:
+    return 0;
+  default:
+    break;
+  }
+
+  if (!next) return 0;
+  if (bd && cmd == XRDHTTP_KTLS_CTRL_MSG_SET) bd->ctrlMsg = true;
+    else if (bd && cmd == XRDHTTP_KTLS_CTRL_MSG_CLR) bd->ctrlMsg = false;
+  return BIO_ctrl(next, cmd, num, ptr);
+}
+
+BIO_METHOD *KTLSBioMethod()
+{
+  static BIO_METHOD *method = []() {
+    BIO_METHOD *m = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_FILTER,
+                                 "xrdhttp-ktls-bio-method");
+    if (m) {
+      BIO_meth_set_write(m, BIO_XrdKTLS_write);
+      BIO_meth_set_create(m, BIO_XrdKTLS_create);
+      BIO_meth_set_destroy(m, BIO_XrdKTLS_destroy);
+      BIO_meth_set_ctrl(m, BIO_XrdKTLS_ctrl);
+    }
+    return m;
+  }();
+  return method;
+}
+}
+
+bool XrdHttpKTLS::Available()
+{
+  return true;
+}
+
+BIO *XrdHttpKTLS::CreateBIO(XrdLink *lp)
+{
+  BIO_METHOD *method = KTLSBioMethod();
+  if (method == NULL)
+    return NULL;
+
+  BIO *sock = BIO_new_socket(lp->FDnum(), BIO_NOCLOSE);
+  if (!sock) return NULL;
+
+  BIO *ret = BIO_new(method);
+  if (!ret) {
+    BIO_free(sock);
+    return NULL;
+  }
+
+  BIO_set_shutdown(ret, 0);
+  BIO_set_data(ret, new KTLSBioData{lp, false});
+  BIO_set_init(ret, 1);
+  return BIO_push(ret, sock);
+}
+
+#else
+
+bool XrdHttpKTLS::Available()
+{
+  return false;
+}
+
+BIO *XrdHttpKTLS::CreateBIO(XrdLink *)
+{
+  return NULL;
+}
+
+#endif
@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------------
+// This file is part of XrdHTTP: A pragmatic implementation of the
+// HTTP/WebDAV protocol for the Xrootd framework
+//
+// Copyright (c) 2025 by European Organization for Nuclear Research (CERN)
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef XROOTD_XRDHTTPKTLS_HH
+#define XROOTD_XRDHTTPKTLS_HH
+
+#include <openssl/bio.h>
+
+class XrdLink;
+
+class XrdHttpKTLS {
+public:
+
+  /**
+   * Tells whether XrdHttp can let the kernel encrypt (kTLS). This needs an
+   * OpenSSL with kTLS whose control record controls were found at configure
+   * time.
+   */
+  static bool Available();
+
+  /**
+   * Creates the write BIO for a https connection that may use kernel TLS.
+   * OpenSSL can only hand the session keys to the kernel through a socket
+   * BIO, so one is chained below the returned BIO. All writes, including the
+   * TLS control records, are serialized with the other writes on the link.
+   *
+   * @param lp the link of the connection
+   * @return the BIO or nullptr if kernel TLS is not available or on failure
+   */
+  static BIO *CreateBIO(XrdLink *lp);
+};
+
+#endif //XROOTD_XRDHTTPKTLS_HH
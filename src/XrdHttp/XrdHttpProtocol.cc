@@ -41,6 +41,7 @@
 #include "XrdHttpUtils.hh"
 #include "XrdHttpSecXtractor.hh"
 #include "XrdHttpExtHandler.hh"
+#include "XrdHttpKTLS.hh"
 
 #include "XrdTls/XrdTls.hh"
 #include "XrdTls/XrdTlsContext.hh"
@@ -57,6 +58,7 @@
 #include <cctype>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <algorithm>
 
 #define XRHTTP_TK_GRACETIME     600
@@ -149,6 +151,7 @@ static const int hsmOn   =  1; // Dual purpose but use a meaningful varname
 int  httpsmode = hsmAuto;
 int  tlsCache  = XrdTlsContext::scOff;
 bool tlsClientAuth = true;
+bool http2 = false;
 bool httpsspec = false;
 bool xrdctxVer = false;
 }
@@ -396,6 +399,26 @@ BIO *XrdHttpProtocol::CreateBIO(XrdLink *lp)
 #define TRACELINK Link
 
 int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
+{
+  int rc = ProcessRequest(lp);
+  if (!h2) return rc;
+
+  // With HTTP/2 a failed request only costs its stream. The requests of
+  // further streams may already sit in the session, where no poll on the
+  // socket would find them, so they are taken up right away.
+  while (true) {
+    if (rc < 0) {
+      if (!H2AbortStream()) return -1;
+      rc = 1;
+    }
+    if (rc == 0) return 0;
+    H2NextStream();
+    if (!h2->Pending() || !BuffAvailable()) return rc;
+    rc = ProcessRequest(Link);
+  }
+}
+
+int XrdHttpProtocol::ProcessRequest(XrdLink *lp)
 {
   int rc = 0;
 
@@ -442,7 +465,19 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
       if (secxtractor)
         secxtractor->InitSSL(ssl, sslcadir);
 
-      SSL_set_bio(ssl, sbio, sbio);
+      // Kernel TLS needs a socket BIO to install the keys in, so use a write
+      // BIO that has one below it; writes themselves still go to the link.
+      // The BIOs are set once as the handshake may take several calls and
+      // the write keys may already be in the kernel by the next one.
+      if (!SSL_get_rbio(ssl)) {
+        BIO *wbio = 0;
+        if (xrdctx->GetParams()->opts & XrdTlsContext::ktlsON)
+          wbio = XrdHttpKTLS::CreateBIO(Link);
+        if (wbio)
+          SSL_set_bio(ssl, sbio, wbio);
+        else
+          SSL_set_bio(ssl, sbio, sbio);
+      }
       //SSL_set_connect_state(ssl);
 
       //SSL_set_fd(ssl, Link->FDnum());
@@ -472,6 +507,11 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
 
       BIO_set_nbio(sbio, 0);
 
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+      ktlssend = BIO_get_ktls_send(SSL_get_wbio(ssl)) != 0;
+      if (ktlssend) TRACEI(DEBUG, " Kernel TLS enabled for sending");
+#endif
+
       strcpy(SecEntity.prot, "https");
 
       // Get the voms string and auth information
@@ -485,6 +525,8 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
       if (TRACING(TRACE_AUTH)) {
         SecEntity.Display(eDest);
       }
+
+      if (!StartH2()) return -1;
     }
 
 
@@ -835,6 +877,92 @@ int XrdHttpProtocol::Process(XrdLink *lp) // We ignore the argument here
   TRACEI(REQ, "Process is exiting rc:" << rc);
   return rc;
 }
+/******************************************************************************/
+/*                               S t a r t H 2                                */
+/******************************************************************************/
+
+bool XrdHttpProtocol::StartH2() {
+  const unsigned char *alpn = 0;
+  unsigned int alen = 0;
+
+  SSL_get0_alpn_selected(ssl, &alpn, &alen);
+  if (alen != 2 || memcmp(alpn, "h2", 2)) return true;
+
+  TRACEI(REQ, " HTTP/2 negotiated");
+
+  // Reads that must not block only go to the socket if it has something
+  auto recv = [this](char *buff, int blen, bool wait) -> int {
+    if (!wait) {
+      int avail = SSL_pending(ssl);
+      if (avail > 0)
+        blen = std::min(blen, avail);
+      else {
+        struct pollfd pfd = {Link->FDnum(), POLLIN, 0};
+        if (poll(&pfd, 1, 0) <= 0) return 0;
+      }
+    }
+    int rlen = SSL_read(ssl, buff, blen);
+    if (rlen <= 0) {
+      ERR_print_errors(sslbio_err);
+      return -1;
+    }
+    return rlen;
+  };
+
+  auto send = [this](const char *buff, int blen) -> int {
+    while (blen > 0) {
+      int r = SSL_write(ssl, buff, blen);
+      if (r <= 0) {
+        ERR_print_errors(sslbio_err);
+        return -1;
+      }
+      buff += r;
+      blen -= r;
+    }
+    return 0;
+  };
+
+  h2 = new XrdHttpH2Session(recv, send);
+  if (h2->Start() < 0) {
+    Link->setEtext("HTTP/2 preface failed");
+    return false;
+  }
+  return true;
+}
+
+/******************************************************************************/
+/*                          H 2 N e x t S t r e a m                           */
+/******************************************************************************/
+
+void XrdHttpProtocol::H2NextStream() {
+  // Wait until the request is done with and the stream got its response
+  if (CurrentReq.request != XrdHttpReq::rtUnset || CurrentReq.headerok ||
+      !h2->Served())
+    return;
+
+  // Whatever the finished request did not read belongs to it
+  if (h2->StreamID()) myBuffStart = myBuffEnd = myBuff->buff;
+  if (h2->NextStream())
+    TRACEI(REQ, " HTTP/2 serving stream " << h2->StreamID());
+}
+
+/******************************************************************************/
+/*                         H 2 A b o r t S t r e a m                          */
+/******************************************************************************/
+
+bool XrdHttpProtocol::H2AbortStream() {
+  if (!h2->Failed()) {
+    TRACEI(REQ, " HTTP/2 resetting stream " << h2->StreamID());
+    h2->Abort();
+    CurrentReq.reset();
+  }
+  if (h2->Failed()) {
+    Link->setEtext(h2->ErrText().c_str());
+    return false;
+  }
+  return true;
+}
+
 /******************************************************************************/
 /*                               R e c y c l e                                */
 /******************************************************************************/
@@ -1004,6 +1132,7 @@ int XrdHttpProtocol::Config(const char *ConfigFN, XrdOucEnv *myEnv) {
       else if TS_Xeq("tlsreuse", xtlsreuse);
       else if TS_Xeq("auth", xauth);
       else if TS_Xeq("tlsclientauth", xtlsclientauth);
+      else if TS_Xeq("http2", xhttp2);
       else if TS_Xeq("maxdelay", xmaxdelay);
       else {
         eDest.Say("Config warning: ignoring unknown directive '", var, "'.");
@@ -1306,7 +1435,26 @@ int XrdHttpProtocol::getDataOneShot(int blen, bool wait) {
   if (!maxread)
     return 2;
 
-  if (ishttps) {
+  if (h2) {
+    H2NextStream();
+
+    if (myBuffEnd - myBuff->buff >= myBuff->bsize) {
+      TRACE(DEBUG, "getDataOneShot Buffer panic");
+      myBuffEnd = myBuff->buff;
+    }
+
+    rlen = h2->Read(myBuffEnd, maxread, wait);
+    if (rlen < 0) {
+      Link->setEtext(h2->ErrText().c_str());
+      return -1;
+    }
+    // The request of the stream ended or the client reset it
+    if (!rlen && wait) {
+      TRACE(REQ, "getDataOneShot HTTP/2 stream " << h2->StreamID() << " has no more data");
+      return -1;
+    }
+
+  } else if (ishttps) {
     int sslavail = maxread;
 
     if (!wait) {
@@ -1507,7 +1655,12 @@ int XrdHttpProtocol::SendData(const char *body, int bodylen) {
 
   if (body && bodylen) {
     TRACE(REQ, "Sending " << bodylen << " bytes");
-    if (ishttps) {
+    if (h2) {
+      r = h2->SendData(body, bodylen) < 0 ? -1 : 1;
+      if (r <= 0) {
+        CurrentReq.monState = XrdHttpMonState::ERR_NET;
+      }
+    } else if (ishttps) {
       r = SSL_write(ssl, body, bodylen);
       if (r <= 0) {
         ERR_print_errors(sslbio_err);
@@ -1525,6 +1678,29 @@ int XrdHttpProtocol::SendData(const char *body, int bodylen) {
   return r <= 0 ? -1 : 0;
 }
 
+/// Send a vector of data to the client. On plain links this is a single
+/// gathering write; TLS and HTTP/2 have to frame each element themselves.
+
+int XrdHttpProtocol::SendData(const struct iovec *iov, int iovcnt, int bodylen) {
+
+  if (!bodylen) return 0;
+
+  if (h2 || ishttps) {
+    for (int i = 0; i < iovcnt; i++) {
+      if (SendData((const char *) iov[i].iov_base, iov[i].iov_len)) return -1;
+    }
+    return 0;
+  }
+
+  TRACE(REQ, "Sending " << bodylen << " bytes in " << iovcnt << " segments");
+  if (Link->Send(iov, iovcnt, bodylen) <= 0) {
+    CurrentReq.monState = XrdHttpMonState::ERR_NET;
+    return -1;
+  }
+
+  return 0;
+}
+
 /******************************************************************************/
 /*                       S t a r t S i m p l e R e s p                        */
 /******************************************************************************/
@@ -1574,6 +1750,13 @@ int XrdHttpProtocol::StartSimpleResp(int code, const char *desc,
 
   const std::string &outhdr = ss.str();
   TRACEI(RSP, "Sending resp: " << code << " header len:" << outhdr.size());
+  if (h2) {
+    if (h2->SendHeaders(outhdr, CurrentReq.request == XrdHttpReq::rtHEAD) < 0) {
+      CurrentReq.monState = XrdHttpMonState::ERR_NET;
+      return -1;
+    }
+    return 0;
+  }
   if (SendData(outhdr.c_str(), outhdr.size()))
    return -1;
 
@@ -1611,18 +1794,33 @@ int XrdHttpProtocol::ChunkResp(const char *body, long long bodylen) {
   long long header_len = (bodylen < 0) ? 0 : content_length;
   int code = CurrentReq.getInitialStatusCode();
   if (code < 200) code = CurrentReq.getHttpStatusCode();
+  int r;
 
-  if (ChunkRespHeader(header_len)) {
-    XrdHttpMon::Record(CurrentReq, code);
-    return -1;
-  }
+  if (h2) {
+    // HTTP/2 frames the body itself; the final chunk just ends the stream,
+    // with the trailer if there is one
+    if (content_length == 0 || bodylen == -1)
+      r = h2->EndStream(bodylen == -1 ? body : nullptr) < 0 ? -1 : 0;
+    else
+      r = SendData(body, content_length);
+    if (r) {
+      CurrentReq.monState = XrdHttpMonState::ERR_NET;
+      XrdHttpMon::Record(CurrentReq, code);
+      return -1;
+    }
+  } else {
+    if (ChunkRespHeader(header_len)) {
+      XrdHttpMon::Record(CurrentReq, code);
+      return -1;
+    }
 
-  if (body && SendData(body, content_length)){
-    XrdHttpMon::Record(CurrentReq, code);
-    return -1;
-  }
+    if (body && SendData(body, content_length)){
+      XrdHttpMon::Record(CurrentReq, code);
+      return -1;
+    }
 
-  int r = ChunkRespFooter();
+    r = ChunkRespFooter();
+  }
 
   if (content_length == 0 || bodylen == -1) { //final chunk
     // If for some reason we encounter issues with both network and the filesystem
@@ -1844,6 +2042,14 @@ bool XrdHttpProtocol::InitTLS() {
     opts |= XrdTlsContext::crlAM;
   }
 
+// Inherit kernel TLS offload from the xrd.tls directive
+//
+   if (xrdctx && (xrdctx->GetParams()->opts & XrdTlsContext::ktlsON))
+      {if (XrdHttpKTLS::Available()) opts |= XrdTlsContext::ktlsON;
+          else eDest.Say("Config warning: kernel TLS not supported by this "
+                         "build; https will encrypt in user space.");
+      }
+
 // Create a new TLS context
 //
    if (sslverifydepth > 255) sslverifydepth = 255;
@@ -1877,6 +2083,13 @@ bool XrdHttpProtocol::InitTLS() {
 // Enable or disable the config in the context
    xrdctx->SetTlsClientAuth(tlsClientAuth);
 
+// Offer HTTP/2 to clients that support it, if so wanted
+//
+   if (http2 && !xrdctx->SetAlpn("h2,http/1.1"))
+      {eDest.Say("Config failure: ", "Unable to enable HTTP/2!");
+       return false;
+      }
+
 // All done
 //
    return true;
@@ -1890,6 +2103,9 @@ void XrdHttpProtocol::Cleanup() {
 
   TRACE(ALL, " Cleanup");
 
+  delete h2;
+  h2 = 0;
+
   if (BPool && myBuff) {
     BuffConsume(BuffUsed());
     BPool->Release(myBuff);
@@ -1988,6 +2204,8 @@ void XrdHttpProtocol::Reset() {
   SecEntity.tident = XrdHttpSecEntityTident;
   ishttps = false;
   ssldone = false;
+  ktlssend = false;
+  h2 = 0;
 
   Bridge = 0;
   ssl = 0;
@@ -3000,6 +3218,44 @@ int XrdHttpProtocol::xtlsclientauth(XrdOucStream &Config) {
   return 1;
 }
 
+/******************************************************************************/
+/*                                 x h t t p 2                                */
+/******************************************************************************/
+
+/* Function: xhttp2
+
+   Purpose:  To parse the directive: http2 {on | off}
+
+             on      offer HTTP/2 to https clients, negotiated with ALPN.
+             off     only speak HTTP/1.1 (the default).
+
+   Notes:    Streams are not multiplexed. Each connection serves one
+             request at a time and tells the client so by allowing a single
+             open stream; concurrent requests take more connections, as with
+             HTTP/1.1 keep-alive. What HTTP/2 brings is header compression
+             and the stream and flow control framing clients expect.
+
+   Output: 0 upon success or 1 upon failure.
+ */
+
+int XrdHttpProtocol::xhttp2(XrdOucStream &Config) {
+  auto val = Config.GetWord();
+  if (!val || !val[0])
+     {eDest.Emsg("Config", "http2 argument not specified"); return 1;}
+
+  if (!strcmp(val, "off"))
+     {http2 = false;
+      return 0;
+     }
+  if (!strcmp(val, "on"))
+     {http2 = true;
+      return 0;
+     }
+
+  eDest.Emsg("config", "invalid http2 parameter -", val);
+  return 1;
+}
+
 int XrdHttpProtocol::xauth(XrdOucStream &Config) {
   char *val = Config.GetWord();
   if(val) {
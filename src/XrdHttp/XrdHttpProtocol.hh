@@ -46,11 +46,13 @@
 #include "XrdNet/XrdNetPMark.hh"
 #include "XrdHttpCors/XrdHttpCors.hh"
 #include "XrdHttpReq.hh"
+#include "XrdHttpH2Session.hh"
 
 #include <chrono>
 #include <cstdlib>
 #include <openssl/ssl.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <unordered_map>
 #include <unordered_set>
@@ -160,6 +162,24 @@ private:
   /// Send some generic data to the client
   int SendData(const char *body, int bodylen);
 
+  /// Send a vector of data to the client, in a single write where possible
+  int SendData(const struct iovec *iov, int iovcnt, int bodylen);
+
+  /// Parse and run the request of the current HTTP/1.1 connection or
+  /// HTTP/2 stream, the body of Process()
+  int ProcessRequest(XrdLink *lp);
+
+  /// Set up the HTTP/2 session if it was negotiated in the TLS handshake
+  bool StartH2();
+
+  /// With HTTP/2, take up the next stream once the request of the current one
+  /// is finished
+  void H2NextStream();
+
+  /// With HTTP/2, reset the current stream after a failed request. Returns
+  /// false if the connection itself failed and has to be closed.
+  bool H2AbortStream();
+
   /// Deallocate resources, in order to reutilize an object of this class
   void Cleanup();
 
@@ -229,6 +249,7 @@ private:
   static int xtlsreuse(XrdOucStream &Config);
   static int xauth(XrdOucStream &Config);
   static int xtlsclientauth(XrdOucStream &Config);
+  static int xhttp2(XrdOucStream &Config);
   static int xmaxdelay(XrdOucStream &Config);
 
   static bool isRequiredXtractor; // If true treat secxtractor errors as fatal
@@ -337,6 +358,13 @@ private:
   /// Flag to tell if the https handshake has finished, in the case of an https
   /// connection being established
   bool ssldone;
+
+  /// True if the kernel encrypts what is sent on the https connection (kTLS),
+  /// so that file data can be sent with sendfile
+  bool ktlssend;
+
+  /// The HTTP/2 session, if the client negotiated h2 with ALPN
+  XrdHttpH2Session *h2;
   static XrdCryptoFactory *myCryptoFactory;
 
 protected:
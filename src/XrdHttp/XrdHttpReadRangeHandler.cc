@@ -197,6 +197,37 @@ int XrdHttpReadRangeHandler::NotifyReadResult
     bool                   &allend
 )
 {
+  size_t skip, used;
+
+  if( NotifyReadResult( ret, urp, start, allend, skip, used ) < 0 )
+    return -1;
+
+  if( skip || used != (size_t)ret )
+  {
+    error_.set( 500, "Range handler read crossing chunk boundary." );
+    return -1;
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+//! Advance internal counters concerning received bytes, which may span
+//! several coalesced user ranges
+//------------------------------------------------------------------------------
+int XrdHttpReadRangeHandler::NotifyReadResult
+(
+    const ssize_t           ret,
+    const UserRange** const urp,
+    bool                   &start,
+    bool                   &allend,
+    size_t                 &skip,
+    size_t                 &used
+)
+{
+  skip = 0;
+  used = 0;
+
   if( error_ )
     return -1;
 
@@ -231,26 +262,36 @@ int XrdHttpReadRangeHandler::NotifyReadResult
     return -1;
   }
 
-  if( urp )
-    *urp = &resolvedUserRanges_[resolvedRangeIdx_];
+  const UserRange &ur = resolvedUserRanges_[resolvedRangeIdx_];
 
-  if( resolvedRangeOff_ == 0 )
-    start = true;
+  if( urp )
+    *urp = &ur;
 
+  //----------------------------------------------------------------------------
+  // The next byte of the user range is expected within the current chunk,
+  // possibly after the gap that separates it from the previous range.
+  //----------------------------------------------------------------------------
   const int   clen  = splitRange_[currSplitRangeIdx_].size;
+  const off_t cpos  = splitRange_[currSplitRangeIdx_].offset + currSplitRangeOff_;
+  const off_t upos  = ur.start + resolvedRangeOff_;
+  const off_t ulen  = ur.end - ur.start + 1;
 
-  const off_t ulen  = resolvedUserRanges_[resolvedRangeIdx_].end
-                        - resolvedUserRanges_[resolvedRangeIdx_].start + 1;
-
-  currSplitRangeOff_ += ret;
-  resolvedRangeOff_  += ret;
-
-  if( currSplitRangeOff_  > clen || resolvedRangeOff_ > ulen )
+  if( upos < cpos || upos - cpos >= clen - currSplitRangeOff_ )
   {
-    error_.set( 500, "Range handler read crossing chunk boundary." );
+    error_.set( 500, "Range handler chunk does not match user range." );
     return -1;
   }
 
+  skip = std::min( (off_t)ret, upos - cpos );
+  used = std::min( { (off_t)ret - (off_t)skip, ulen - resolvedRangeOff_,
+                     (off_t)( clen - currSplitRangeOff_ - skip ) } );
+
+  if( used > 0 && resolvedRangeOff_ == 0 )
+    start = true;
+
+  currSplitRangeOff_ += skip + used;
+  resolvedRangeOff_  += used;
+
   if( currSplitRangeOff_ == clen )
   {
     currSplitRangeOff_ = 0;
@@ -571,8 +612,12 @@ void XrdHttpReadRangeHandler::splitRanges()
   // using kXR_readv. However, if there's a long user range we can we try to
   // proceed by issuing single range requests and thereby using kXR_read.
   //
-  // We don't merge user ranges in a single chunk as we always expect to be
-  // able to notify at boundaries with the output bools of NotifyReadResult.
+  // User ranges that follow each other closely are merged into a single
+  // chunk, as long as it stays within the chunk size limit, so that many
+  // small nearby ranges do not each cost a separate read on the server. The
+  // bytes in between are read as well and dropped when the results are
+  // notified. A range is only merged as a whole, so a chunk always ends at
+  // the end of a range, or of the part of a range that does not fit.
   //----------------------------------------------------------------------------
 
   size_t maxch  = vectorReadMaxChunks_;
@@ -627,11 +672,33 @@ void XrdHttpReadRangeHandler::splitRanges()
     }
     else
     {
-      splitRange_.emplace_back(	nullptr, tmpur.start, l );
+      off_t cend = tmpur.start + l - 1;
+      size_t csz = l;
       rsr            -= l;
       tmpur           = UserRange();
       splitRangeOff_  = 0;
       splitRangeIdx_++;
+
+      //------------------------------------------------------------------------
+      // Merge in following ranges which start shortly after this one.
+      //------------------------------------------------------------------------
+      while( coalesceGap_ > 0 && splitRangeIdx_ < cs )
+      {
+        const UserRange &nr = resolvedUserRanges_[splitRangeIdx_];
+        if( nr.start <= cend || nr.start - cend - 1 > (off_t)coalesceGap_ )
+          break;
+
+        const size_t add = nr.end - cend;
+        if( csz + add > maxchs || add > rsr )
+          break;
+
+        csz  += add;
+        rsr  -= add;
+        cend  = nr.end;
+        splitRangeIdx_++;
+      }
+
+      splitRange_.emplace_back(	nullptr, cend - csz + 1, csz );
     }
     nc++;
   }
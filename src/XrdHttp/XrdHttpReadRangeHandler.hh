@@ -41,30 +41,37 @@ public:
    * READV_MAXCHUNKS                Max length of the XrdHttpIOList vector.
    * READV_MAXCHUNKSIZE             Max length of a XrdOucIOVec2 element.
    * RREQ_MAXSIZE                   Max bytes to issue in a whole readv/read.
+   * READV_COALESCE_GAP             Max number of unwanted bytes between two
+   *                                user ranges for them to be read as one chunk.
    */
   static constexpr size_t READV_MAXCHUNKS    = 512;
   static constexpr size_t READV_MAXCHUNKSIZE = 512*1024;
   static constexpr size_t RREQ_MAXSIZE       = 8*1024*1024;
+  static constexpr size_t READV_COALESCE_GAP = 16*1024;
 
   /**
    * Configuration can give specific values for the max chunk
    * size, number of chunks and maximum overall request size,
-   * to override the defaults.
+   * to override the defaults. The coalescing gap is always used;
+   * zero disables coalescing of user ranges.
    */
   struct Configuration {
-    Configuration() : haveSizes(false) { }
+    Configuration() : haveSizes(false), coalesce_gap(READV_COALESCE_GAP) { }
 
     Configuration(const size_t vectorReadMaxChunkSize,
                   const size_t vectorReadMaxChunks,
-                  const size_t rRequestMaxBytes)  :
+                  const size_t rRequestMaxBytes,
+                  const size_t coalesceGap = READV_COALESCE_GAP)  :
       haveSizes(true), readv_ior_max(vectorReadMaxChunkSize),
-      readv_iov_max(vectorReadMaxChunks), reqs_max(rRequestMaxBytes) { }
+      readv_iov_max(vectorReadMaxChunks), reqs_max(rRequestMaxBytes),
+      coalesce_gap(coalesceGap) { }
     
 
     bool haveSizes;
     size_t readv_ior_max; // max chunk size
     size_t readv_iov_max; // max number of chunks
     size_t reqs_max;      // max bytes in read or readv
+    size_t coalesce_gap;  // max gap between ranges read as one chunk
   };
 
   /**
@@ -115,6 +122,7 @@ public:
     rRequestMaxBytes_       = RREQ_MAXSIZE;
     vectorReadMaxChunkSize_ = READV_MAXCHUNKSIZE;
     vectorReadMaxChunks_    = READV_MAXCHUNKS;
+    coalesceGap_            = conf.coalesce_gap;
 
     if( conf.haveSizes )
     {
@@ -186,6 +194,9 @@ public:
    * should be sent as a read request. Therefore the chunks do not necessarily
    * correspond to the ranges the user requested. The caller issue the requests
    * in the order provided and call NotifyReadResult with the ordered results.
+   * For multi range requests, user ranges that follow each other with a gap of
+   * at most the configured coalescing gap may be read as a single chunk, in
+   * which case the chunk also holds the unwanted bytes between the ranges.
    * @return a reference to a XrdHttpIOList. The object remains owned by the
    *         handler. It may be invalided by a new call to NextReadList() or
    *         reset(). The returned list may be empty, which implies no more
@@ -216,12 +227,33 @@ public:
    *                     received bytes mark the end of all the UserRanges
    * @return 0 upon success, -1 if an error happened.
    * One needs to call the getError() method to return the error.
+   * The received bytes may not cross the end of a user range, nor include
+   * bytes between coalesced ranges; use the variant below for those.
    */
   int           NotifyReadResult(const ssize_t ret,
                                  const UserRange** const urp,
                                  bool &start,
                                  bool &allend);
 
+  /**
+   * As above, but the received bytes may span several user ranges and the
+   * gaps between them. Only the leading part of the bytes that belongs to
+   * one user range is accounted for: the first skip bytes are not part of
+   * any range and are to be dropped, the following used bytes belong to the
+   * range returned via urp. The caller repeats the call with the remaining
+   * ret - skip - used bytes until none are left. start and allend refer to
+   * the used bytes, used may be zero if all the bytes are skipped.
+   * @param skip   output: number of leading bytes to be dropped
+   * @param used   output: number of bytes following those, of the range *urp
+   * @return 0 upon success, -1 if an error happened.
+   */
+  int           NotifyReadResult(const ssize_t ret,
+                                 const UserRange** const urp,
+                                 bool &start,
+                                 bool &allend,
+                                 size_t &skip,
+                                 size_t &used);
+
   /**
    * Parses the Content-Range header value and sets the ranges within the
    * object.
@@ -287,6 +319,7 @@ private:
   size_t vectorReadMaxChunkSize_;
   size_t vectorReadMaxChunks_;
   size_t rRequestMaxBytes_;
+  size_t coalesceGap_;
 };
 
 
@@ -516,7 +516,8 @@ bool XrdHttpReq::Done(XrdXrootd::Bridge::Context & info) {
   int r = PostProcessHTTPReq(true);
   // Beware, we don't have to reset() if the result is 0
   if (r) reset();
-  if (r < 0) return false; 
+  // With HTTP/2 only the stream is given up, not the connection
+  if (r < 0) return prot->h2 && prot->H2AbortStream(); 
   
   
   return true;
@@ -549,7 +550,7 @@ bool XrdHttpReq::Error(XrdXrootd::Bridge::Context &info, //!< the result context
   if ((request == rtGET) && (xrdreq.header.requestid == ntohs(kXR_open)) && (xrderrcode == kXR_isDirectory))
     return true;
   
-  return rc == 0;
+  return rc == 0 || (prot->h2 && prot->H2AbortStream());
 };
 
 bool XrdHttpReq::Redir(XrdXrootd::Bridge::Context &info, //!< the result context
@@ -1208,10 +1209,11 @@ int XrdHttpReq::ProcessHTTPReq() {
             xrdreq.read.offset = htonll(offs);
             xrdreq.read.rlen = htonl(l);
 
-            // If we are using HTTPS or if the client requested trailers, or if the
-            // read concerns a multirange reponse, disable sendfile
+            // If we are using HTTPS without kernel TLS or HTTP/2, or if the client requested
+            // trailers, or if the read concerns a multirange reponse, disable sendfile
             // (in the latter two cases, the extra framing is only done in PostProcessHTTPReq)
-            if (prot->ishttps || (m_transfer_encoding_chunked && m_trailer_headers) ||
+            if ((prot->ishttps && !prot->ktlssend) || prot->h2 ||
+                (m_transfer_encoding_chunked && m_trailer_headers) ||
                 !readRangeHandler.isSingleRange()) {
               if (!prot->Bridge->setSF((kXR_char *) fhandle, false)) {
                 TRACE(REQ, " XrdBridge::SetSF(false) failed.");
@@ -2858,7 +2860,8 @@ int XrdHttpReq::sendReadResponsesMultiRanges(const XrdHttpIOList &received) {
   struct rinfo {
     bool start;
     bool finish;
-    const XrdOucIOVec2 *ci;
+    const char *data;
+    size_t size;
     const XrdHttpReadRangeHandler::UserRange *ur;
     std::string st_header;
     std::string fin_header;
@@ -2866,6 +2869,8 @@ int XrdHttpReq::sendReadResponsesMultiRanges(const XrdHttpIOList &received) {
 
   // report each received byte chunk to the range handler and record the details
   // of original user range it related to and if starts a range or finishes all.
+  // A chunk may hold several coalesced user ranges, in which case it is cut
+  // into the pieces that belong to each and the bytes in between are dropped.
   // also sum the total of the headers and data which need to be sent to the user,
   // in case we need it for chunked transfer encoding
   std::vector<rinfo> rvec;
@@ -2874,37 +2879,52 @@ int XrdHttpReq::sendReadResponsesMultiRanges(const XrdHttpIOList &received) {
   rvec.reserve(received.size());
 
   for(const auto &rcv: received) {
-    rinfo rentry;
-    bool start, finish;
-    const XrdHttpReadRangeHandler::UserRange *ur;
+    const char *data = rcv.data;
+    size_t left = rcv.size;
 
-    if (readRangeHandler.NotifyReadResult(rcv.size, &ur, start, finish) < 0) {
-      return -1;
-    }
-    rentry.ur = ur;
-    rentry.start = start;
-    rentry.finish = finish;
-    rentry.ci = &rcv;
-
-    if (start) {
-      std::string s = buildPartialHdr(ur->start,
-                         ur->end,
-                         filesize,
-                         (char *) "123456");
-
-      rentry.st_header = s;
-      sum_len += s.size();
-    }
+    while (left > 0) {
+      rinfo rentry;
+      bool start, finish;
+      size_t skip, used;
+      const XrdHttpReadRangeHandler::UserRange *ur;
 
-    sum_len += rcv.size;
+      if (readRangeHandler.NotifyReadResult(left, &ur, start, finish, skip, used) < 0) {
+        return -1;
+      }
+      if (skip + used == 0) {
+        return -1;
+      }
+      data += skip;
+      left -= skip + used;
+      if (!used) continue;
+
+      rentry.ur = ur;
+      rentry.start = start;
+      rentry.finish = finish;
+      rentry.data = data;
+      rentry.size = used;
+      data += used;
+
+      if (start) {
+        std::string s = buildPartialHdr(ur->start,
+                           ur->end,
+                           filesize,
+                           (char *) "123456");
+
+        rentry.st_header = s;
+        sum_len += s.size();
+      }
 
-    if (finish) {
-      std::string s = buildPartialHdrEnd((char *) "123456");
-      rentry.fin_header = s;
-      sum_len += s.size();
-    }
+      sum_len += used;
 
-    rvec.push_back(rentry);
+      if (finish) {
+        std::string s = buildPartialHdrEnd((char *) "123456");
+        rentry.fin_header = s;
+        sum_len += s.size();
+      }
+
+      rvec.push_back(std::move(rentry));
+    }
   }
 
 
@@ -2913,28 +2933,29 @@ int XrdHttpReq::sendReadResponsesMultiRanges(const XrdHttpIOList &received) {
     prot->ChunkRespHeader(sum_len);
   }
 
-  // send the user the headers / data
+  // send the user the headers and data of all the parts in one go, so that
+  // many small ranges do not each cost a separate write on the link
+  std::vector<struct iovec> iov;
+  iov.reserve(3 * rvec.size());
+
   for(const auto &rentry: rvec) {
 
-     if (rentry.start) {
-       TRACEI(REQ, "Sending multipart: " << rentry.ur->start << "-" << rentry.ur->end);
-       if (prot->SendData((char *) rentry.st_header.c_str(), rentry.st_header.size())) {
-         return -1;
-       }
+    if (rentry.start) {
+      TRACEI(REQ, "Sending multipart: " << rentry.ur->start << "-" << rentry.ur->end);
+      iov.push_back({(void *) rentry.st_header.data(), rentry.st_header.size()});
     }
 
-    // Send all the data we have
-    if (prot->SendData((char *) rentry.ci->data, rentry.ci->size)) {
-      return -1;
-    }
+    iov.push_back({(void *) rentry.data, rentry.size});
 
     if (rentry.finish) {
-      if (prot->SendData((char *) rentry.fin_header.c_str(), rentry.fin_header.size())) {
-        return -1;
-      }
+      iov.push_back({(void *) rentry.fin_header.data(), rentry.fin_header.size()});
     }
   }
 
+  if (prot->SendData(iov.data(), iov.size(), (int) sum_len)) {
+    return -1;
+  }
+
   // Send chunked encoding footer
   if (m_transfer_encoding_chunked && m_trailer_headers) {
     prot->ChunkRespFooter();
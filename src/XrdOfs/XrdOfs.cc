@@ -2151,6 +2151,12 @@ int XrdOfs::getStats(char *buff, int blen)
 //
   if (!buff) return OfsStats.Report(0,0) + XrdOfsOss->Stats(0,0);
 
+// The handle counts are kept by the handle table shards, collect them now
+//
+   int hanMax, hanNum = XrdOfsHandle::Occupancy(hanMax);
+   OfsStats.Set(OfsStats.Data.numHandles, hanNum);
+   OfsStats.Set(OfsStats.Data.numHanMax,  hanMax);
+
 // Report ofs info followed by the oss info
 //
    n = OfsStats.Report(buff, blen);
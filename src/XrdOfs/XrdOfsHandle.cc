@@ -34,7 +34,6 @@
 #include <sys/types.h>
 
 #include "XrdOfs/XrdOfsHandle.hh"
-#include "XrdOfs/XrdOfsStats.hh"
 #include "XrdOss/XrdOss.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPlatform.hh"
@@ -238,17 +237,13 @@ void *XrdOfsHanXpire(void *pp)
 
 extern XrdSysError OfsEroute;
 
-extern XrdOfsStats OfsStats;
-
 /******************************************************************************/
 /*                        S t a t i c   O b j e c t s                         */
 /******************************************************************************/
   
-XrdSysMutex   XrdOfsHandle::myMutex;
-XrdOfsHanTab  XrdOfsHandle::roTable;
-XrdOfsHanTab  XrdOfsHandle::rwTable;
+XrdOfsHanTab  XrdOfsHandle::roTable[XrdOfsHandle::hanShards];
+XrdOfsHanTab  XrdOfsHandle::rwTable[XrdOfsHandle::hanShards];
 XrdOssDF     *XrdOfsHandle::ossDF = (XrdOssDF *)new XrdOfsHanOss;
-XrdOfsHandle *XrdOfsHandle::Free = 0;
 
 /******************************************************************************/
 /*                    c l a s s   X r d O f s H a n d l e                     */
@@ -260,33 +255,33 @@ XrdOfsHandle *XrdOfsHandle::Free = 0;
 int XrdOfsHandle::Alloc(const char *thePath, int Opts, XrdOfsHandle **Handle)
 {
    XrdOfsHandle *hP;
-   XrdOfsHanTab *theTable = (Opts & opRW ? &rwTable : &roTable);
    XrdOfsHanKey theKey(thePath, (int)strlen(thePath));
+   XrdOfsHanTab &theTable = Table(Opts & opRW, theKey.Hash);
    int          retc;
 
-// Lock the search table and try to find the key. If found, increment the
-// the link count (can only be done with the global lock) then release the
+// Lock the table shard holding the key and try to find it. If found, increment
+// the link count (can only be done with the shard lock) then release the
 // lock and try to lock the handle. It can't escape between lock calls because
 // the link count is positive. If we can't lock the handle then it must be the
 // that a long running operation is occuring. Return the handle to its former
-// state and return a delay. Otherwise, return the handle.
+// state and return a delay. Otherwise, return the handle. Opens of files in
+// other shards proceed in parallel.
 //
-   myMutex.Lock();
-   if ((hP = theTable->Find(theKey)))
-      {hP->Path.Links++; myMutex.UnLock();
+   theTable.Mutex.Lock();
+   if ((hP = theTable.Find(theKey)))
+      {hP->Path.Links++; theTable.Mutex.UnLock();
        if (hP->WaitLock()) {*Handle = hP; return 0;}
-       myMutex.Lock(); hP->Path.Links--; myMutex.UnLock();
+       theTable.Mutex.Lock(); hP->Path.Links--; theTable.Mutex.UnLock();
        return nolokDelay;
       }
 
 // Get a new handle
 //
-   if (!(retc = Alloc(theKey, Opts, Handle))) theTable->Add(*Handle);
-   OfsStats.Add(OfsStats.Data.numHandles);
+   if (!(retc = Alloc(theKey, Opts, Handle, theTable))) theTable.Add(*Handle);
 
 // All done
 //
-   myMutex.UnLock();
+   theTable.Mutex.UnLock();
    return retc;
 }
 
@@ -297,12 +292,13 @@ int XrdOfsHandle::Alloc(const char *thePath, int Opts, XrdOfsHandle **Handle)
 int XrdOfsHandle::Alloc(XrdOfsHandle **Handle)
 {
     XrdOfsHanKey myKey("dummy", 5);
+    XrdOfsHanTab &theTable = Table(0, myKey.Hash);
     int retc;
 
-    myMutex.Lock();
-    if (!(retc = Alloc(myKey, 0, Handle))) 
+    theTable.Mutex.Lock();
+    if (!(retc = Alloc(myKey, 0, Handle, theTable)))
        {(*Handle)->Path.Links = 0; (*Handle)->UnLock();}
-    myMutex.UnLock();
+    theTable.Mutex.UnLock();
     return retc;
 }
 
@@ -310,16 +306,21 @@ int XrdOfsHandle::Alloc(XrdOfsHandle **Handle)
 /* private                      A l l o c   # 3                               */
 /******************************************************************************/
   
-int XrdOfsHandle::Alloc(XrdOfsHanKey theKey, int Opts, XrdOfsHandle **Handle)
+// The table shard must be locked upon entry.
+
+int XrdOfsHandle::Alloc(XrdOfsHanKey theKey, int Opts, XrdOfsHandle **Handle,
+                        XrdOfsHanTab &hTab)
 {
    static const int minAlloc = 4096/sizeof(XrdOfsHandle);
    XrdOfsHandle *hP;
 
-// No handle currently in the table. Get a new one off the free list
+// No handle currently in the table. Get a new one off the shard's free list
 //
-   if (!Free && (hP = new XrdOfsHandle[minAlloc]))
-      {int i = minAlloc; while(i--) {hP->Next = Free; Free = hP; hP++;}}
-   if ((hP = Free)) Free = hP->Next;
+   if (!hTab.Free && (hP = new XrdOfsHandle[minAlloc]))
+      {int i = minAlloc;
+       while(i--) {hP->Next = hTab.Free; hTab.Free = hP; hP++;}
+      }
+   if ((hP = hTab.Free)) hTab.Free = hP->Next;
 
 // Initialize the new handle, if we have one, and add it to the table
 //
@@ -347,14 +348,41 @@ void XrdOfsHandle::Hide(const char *thePath)
 {
    XrdOfsHandle *hP;
    XrdOfsHanKey theKey(thePath, (int)strlen(thePath));
+   XrdOfsHanTab &roTab = Table(0, theKey.Hash);
+   XrdOfsHanTab &rwTab = Table(1, theKey.Hash);
+
+// Lock both shards that may hold the key so that the path disappears from
+// the r/o and r/w tables at the same time. This is the only place where two
+// shard locks are held and they are always taken r/o first. If found, clear
+// the length field to effectively hide the item.
+//
+   roTab.Mutex.Lock();
+   rwTab.Mutex.Lock();
+   if ((hP = roTab.Find(theKey))) hP->Path.Len = 0;
+   if ((hP = rwTab.Find(theKey))) hP->Path.Len = 0;
+   rwTab.Mutex.UnLock();
+   roTab.Mutex.UnLock();
+}
+
+/******************************************************************************/
+/* static public                O c c u p a n c y                             */
+/******************************************************************************/
 
-// Lock the search table and try to find the key in each table. If found,
-// clear the length field to effectively hide the item.
+int XrdOfsHandle::Occupancy(int &maxShard)
+{
+   int n, numAll = 0;
+
+// Add up the handles in each shard and note the fullest one. A large maximum
+// relative to the average means the paths hash poorly.
 //
-   myMutex.Lock();
-   if ((hP = roTable.Find(theKey))) hP->Path.Len = 0;
-   if ((hP = rwTable.Find(theKey))) hP->Path.Len = 0;
-   myMutex.UnLock();
+   maxShard = 0;
+   for (int i = 0; i < hanShards; i++)
+       {roTable[i].Mutex.Lock(); n = roTable[i].Count(); roTable[i].Mutex.UnLock();
+        numAll += n; if (n > maxShard) maxShard = n;
+        rwTable[i].Mutex.Lock(); n = rwTable[i].Count(); rwTable[i].Mutex.UnLock();
+        numAll += n; if (n > maxShard) maxShard = n;
+       }
+   return numAll;
 }
 
 /******************************************************************************/
@@ -373,7 +401,10 @@ int XrdOfsHandle::PoscGet(short &Mode, int Done)
        Mode = Posc->Mode;
        if (Done)
           {pP = Posc; Posc = 0;
-           if (pP->xprP) {myMutex.Lock(); Path.Links--; myMutex.UnLock();}
+           if (pP->xprP)
+              {XrdOfsHanTab &hTab = myTable();
+               hTab.Mutex.Lock(); Path.Links--; hTab.Mutex.UnLock();
+              }
            pP->Recycle();
           }
        return pnum;
@@ -457,30 +488,31 @@ const char *XrdOfsHandle::PoscUsr()
 
 int XrdOfsHandle::Retire(int &retc, long long *retsz, char *buff, int blen)
 {
+   XrdOfsHanTab &hTab = myTable();
    XrdOssDF *mySSI;
    int numLeft;
 
-// Get the global lock as the links field can only be manipulated with it.
+// Get the shard lock as the links field can only be manipulated with it.
 // Decrement the links count and if zero, remove it from the table and
 // place it on the free list. Otherwise, it is still in use.
 //
    retc = 0;
-   myMutex.Lock();
+   hTab.Mutex.Lock();
    if (Path.Links == 1)
       {if (buff) strlcpy(buff, Path.Val, blen);
-       numLeft = 0; OfsStats.Dec(OfsStats.Data.numHandles);
-       if ( (isRW ? rwTable.Remove(this) : roTable.Remove(this)) )
+       numLeft = 0;
+       if (hTab.Remove(this))
          {if (Posc) {Posc->Recycle(); Posc = 0;}
           if (Path.Val) {free((void *)Path.Val); Path.Val = (char *)"";}
           Path.Len = 0; mySSI = ssi; ssi = ossDF;
-          Next = Free; Free = this; UnLock(); myMutex.UnLock();
+          Next = hTab.Free; hTab.Free = this; UnLock(); hTab.Mutex.UnLock();
           if (mySSI && mySSI != ossDF)
              {retc = mySSI->Close(retsz); delete mySSI;}
          } else {
-          UnLock(); myMutex.UnLock();
+          UnLock(); hTab.Mutex.UnLock();
           OfsEroute.Emsg("Retire", "Lost handle to", buff);
         }
-      } else {numLeft = --Path.Links; UnLock(); myMutex.UnLock();}
+      } else {numLeft = --Path.Links; UnLock(); hTab.Mutex.UnLock();}
    return numLeft;
 }
 
@@ -489,20 +521,21 @@ int XrdOfsHandle::Retire(int &retc, long long *retsz, char *buff, int blen)
 int XrdOfsHandle::Retire(XrdOfsHanCB *cbP, int hTime)
 {
    static int allOK = StartXpr(1);
+   XrdOfsHanTab &hTab = myTable();
    XrdOfsHanXpr *xP;
    int retc;
 
 // The handle can only be held by one reference and only if it's a POSC and
 // deferred handling was properly set up.
 //
-   myMutex.Lock();
+   hTab.Mutex.Lock();
    if (!Posc || !allOK)
       {OfsEroute.Emsg("Retire", "ignoring deferred retire of", Path.Val);
-       if (Path.Links != 1 || !Posc || !cbP) myMutex.UnLock();
-          else {myMutex.UnLock(); cbP->Retired(this);}
+       if (Path.Links != 1 || !Posc || !cbP) hTab.Mutex.UnLock();
+          else {hTab.Mutex.UnLock(); cbP->Retired(this);}
        return Retire(retc);
       }
-   myMutex.UnLock();
+   hTab.Mutex.UnLock();
 
 // If this object already has an xpr object (happens for bouncing connections)
 // then reuse that object. Otherwise create a new one and put it on the queue.
@@ -554,14 +587,15 @@ do{xP = XrdOfsHanXpr::Get(); hP = xP->Handle;
             hP->UnLock(); delete xP; continue;
            }
 
-// As the handle is locked we can get the global handle lock to prevent
-// additions and removals of handles as we need a stable reference count to
-// effect the callout, if any. Do so only if the reference count is one (for us)
-// and the handle is active. In all cases, drop the global lock.
+// As the handle is locked we can get its shard lock to prevent additions
+// and removals of references as we need a stable reference count to effect
+// the callout, if any. Do so only if the reference count is one (for us)
+// and the handle is active. In all cases, drop the shard lock.
 //
-   myMutex.Lock();
-   if (hP->Path.Links != 1 || !xP->Call) myMutex.UnLock();
-      else {myMutex.UnLock();
+   XrdOfsHanTab &hTab = hP->myTable();
+   hTab.Mutex.Lock();
+   if (hP->Path.Links != 1 || !xP->Call) hTab.Mutex.UnLock();
+      else {hTab.Mutex.UnLock();
             xP->Call->Retired(hP);
            }
 
@@ -648,7 +682,7 @@ void XrdOfsHanPsc::Recycle()
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
   
-XrdOfsHanTab::XrdOfsHanTab(int psize, int csize)
+XrdOfsHanTab::XrdOfsHanTab(int psize, int csize) : Free(0)
 {
      prevtablesize = psize;
      nashtablesize = csize;
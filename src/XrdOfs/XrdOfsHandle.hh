@@ -84,21 +84,30 @@ inline int           operator!=(const XrdOfsHanKey &oth)
 /******************************************************************************/
 
 class XrdOfsHandle;
-  
-class XrdOfsHanTab
+
+// Each table is one shard of the set of open files. All methods as well as
+// the link counts of the handles in the table are serialized by Mutex. The
+// table also keeps the free handles that are handed out for its paths.
+//
+class alignas(64) XrdOfsHanTab
 {
 public:
 void           Add(XrdOfsHandle *hP);
 
+inline int     Count() {return nashnum;}
+
 XrdOfsHandle  *Find(XrdOfsHanKey &Key);
 
 int            Remove(XrdOfsHandle *rip);
 
+XrdSysMutex    Mutex;
+XrdOfsHandle  *Free;
+
 // When allocateing a new nash, specify the required starting size. Make
 // sure that the previous number is the correct Fibonocci antecedent. The
 // series is simply n[j] = n[j-1] + n[j-2].
 //
-    XrdOfsHanTab(int psize = 987, int size = 1597);
+    XrdOfsHanTab(int psize = 55, int size = 89);
    ~XrdOfsHanTab() {} // Never gets deleted
 
 private:
@@ -143,6 +152,8 @@ static       int    Alloc(                             XrdOfsHandle **Handle);
 
 static       void   Hide(const char *thePath);
 
+static       int    Occupancy(int &maxShard);
+
 inline       int    Inactive() {return (ssi == ossDF);}
 
 inline const char  *Name() {return Path.Val;}
@@ -174,19 +185,24 @@ inline       void   UnLock() {hMutex.UnLock();}
          ~XrdOfsHandle() {int retc; Retire(retc);}
 
 private:
-static int           Alloc(XrdOfsHanKey, int Opts, XrdOfsHandle **Handle);
+static int           Alloc(XrdOfsHanKey, int Opts, XrdOfsHandle **Handle,
+                           XrdOfsHanTab &hTab);
        int           WaitLock(void);
 
+static XrdOfsHanTab &Table(int rw, unsigned int hash)
+                          {return (rw ? rwTable : roTable)[hash >> hanShift];}
+inline XrdOfsHanTab &myTable() {return Table(isRW, Path.Hash);}
+
 static const int     LockTries =   3; // Times to try for a lock
 static const int     LockWait  = 333; // Mills to wait between tries
 static const int     nolokDelay=   3; // Secs to delay client when lock failed
 static const int     nomemDelay=  15; // Secs to delay client when ENOMEM
+static const int     hanShards =  64; // Shards per table (power of two)
+static const int     hanShift  =  26; // 32 - log2(hanShards), top hash bits
 
-static XrdSysMutex   myMutex;
-static XrdOfsHanTab  roTable;    // File handles open r/o
-static XrdOfsHanTab  rwTable;    // File Handles open r/w
+static XrdOfsHanTab  roTable[hanShards]; // File handles open r/o
+static XrdOfsHanTab  rwTable[hanShards]; // File Handles open r/w
 static XrdOssDF     *ossDF;      // Dummy storage sysem
-static XrdOfsHandle *Free;       // List of free handles
 
        XrdSysMutex   hMutex;
        XrdOssDF     *ssi;        // Storage System Interface
@@ -39,11 +39,12 @@ int XrdOfsStats::Report(char *buff, int blen)
 {
     static const char stats1[] = "<stats id=\"ofs\"><role>%s</role>"
            "<opr>%d</opr><opw>%d</opw><opp>%d</opp><ups>%d</ups><han>%d</han>"
+           "<hmx>%d</hmx>"
            "<rdr>%d</rdr><bxq>%d</bxq><rep>%d</rep><err>%d</err><dly>%d</dly>"
            "<sok>%d</sok><ser>%d</ser>"
            "<tpc><grnt>%d</grnt><deny>%d</deny><err>%d</err><exp>%d</exp></tpc>"
            "</stats>";
-    static const int  statsz = sizeof(stats1) + (12*10) + 64;
+    static const int  statsz = sizeof(stats1) + (13*10) + 64;
 
     StatsData myData;
 
@@ -65,6 +66,7 @@ int XrdOfsStats::Report(char *buff, int blen)
 //
    return sprintf(buff, stats1, myRole, myData.numOpenR,   myData.numOpenW,
                     myData.numOpenP,    myData.numUnpsist, myData.numHandles,
+                    myData.numHanMax,
                     myData.numRedirect, myData.numStarted, myData.numReplies,
                     myData.numErrors,   myData.numDelays,
                     myData.numSeventOK, myData.numSeventER,
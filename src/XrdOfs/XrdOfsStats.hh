@@ -44,6 +44,7 @@ int         numOpenW;   // Write
 int         numOpenP;   // Posc
 int         numUnpsist; // Posc
 int         numHandles;
+int         numHanMax;  // Handles in the fullest handle table shard
 int         numRedirect;
 int         numStarted;
 int         numReplies;
@@ -63,6 +64,8 @@ inline void Add(int &Cntr) {sdMutex.Lock(); Cntr++; sdMutex.UnLock();}
 
 inline void Dec(int &Cntr) {sdMutex.Lock(); Cntr--; sdMutex.UnLock();}
 
+inline void Set(int &Cntr, int Val) {sdMutex.Lock(); Cntr = Val; sdMutex.UnLock();}
+
        int  Report(char *Buff, int Blen);
 
        void setRole(const char *theRole) {myRole = theRole;}
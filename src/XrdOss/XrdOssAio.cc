@@ -45,6 +45,7 @@
 
 #include "XrdOss/XrdOssApi.hh"
 #include "XrdOss/XrdOssTrace.hh"
+#include "XrdOss/XrdOssUring.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdSys/XrdSysPthread.hh"
@@ -102,6 +103,14 @@ const int OSS_AIO_WRITE_DONE = SIGRTMAX;
 int XrdOssFile::Fsync(XrdSfsAio *aiop)
 {
 
+// Use io_uring if so configured, falling back when the rings are full
+//
+   if (XrdOssUring::Enabled())
+      {int urc;
+       aiop->TIdent = tident;
+       if ((urc = XrdOssUring::Fsync(aiop, fd)) <= 0) return urc;
+      }
+
 #ifdef _POSIX_ASYNCHRONOUS_IO
    int rc;
 
@@ -154,6 +163,14 @@ int XrdOssFile::Fsync(XrdSfsAio *aiop)
 int XrdOssFile::Read(XrdSfsAio *aiop)
 {
 
+// Use io_uring if so configured, falling back when the rings are full
+//
+   if (XrdOssUring::Enabled())
+      {int urc;
+       aiop->TIdent = tident;
+       if ((urc = XrdOssUring::Read(aiop, fd)) <= 0) return urc;
+      }
+
 #ifdef _POSIX_ASYNCHRONOUS_IO
    EPNAME("AioRead");
    int rc;
@@ -211,6 +228,14 @@ int XrdOssFile::Read(XrdSfsAio *aiop)
   
 int XrdOssFile::Write(XrdSfsAio *aiop)
 {
+
+// Use io_uring if so configured, falling back when the rings are full
+//
+   if (XrdOssUring::Enabled())
+      {int urc;
+       aiop->TIdent = tident;
+       if ((urc = XrdOssUring::Write(aiop, fd)) <= 0) return urc;
+      }
 #ifdef _POSIX_ASYNCHRONOUS_IO
    EPNAME("AioWrite");
    int rc;
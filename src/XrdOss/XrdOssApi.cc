@@ -1011,6 +1011,12 @@ ssize_t XrdOssFile::ReadV(XrdOucIOVec *readV, int n)
    ssize_t rdsz, totBytes = 0;
    int i;
 
+// If io_uring is available, submit all of the segments as a batch. This makes
+// any prereads superfluous. We only fall back should the rings be full.
+//
+   if (XrdOssUring::Enabled() && n > 1 && !cxobj
+   &&  XrdOssUring::ReadV(fd, readV, n, totBytes)) return totBytes;
+
 // For platforms that support fadvise, pre-advise what we will be reading
 //
 #if (defined(__linux__) || (defined(__FreeBSD_kernel__) && defined(__GLIBC__))) && defined(HAVE_ATOMICS)
@@ -38,6 +38,7 @@
 #include "XrdOss/XrdOssConfig.hh"
 #include "XrdOss/XrdOssError.hh"
 #include "XrdOss/XrdOssStatInfo.hh"
+#include "XrdOss/XrdOssUring.hh"
 #include "XrdOuc/XrdOucExport.hh"
 #include "XrdOuc/XrdOucPList.hh"
 #include "XrdOuc/XrdOucStream.hh"
@@ -170,7 +171,8 @@ int       Configure(const char *, XrdSysError &, XrdOucEnv *envP);
 void      Config_Display(XrdSysError &);
 virtual
 int       Create(const char *, const char *, mode_t, XrdOucEnv &, int opts=0);
-uint64_t  Features() {return XRDOSS_HASNAIO|XRDOSS_HASFICL;} // Turn async I/O off for disk and clone aware
+uint64_t  Features() {return (XrdOssUring::Enabled() ? 0 : XRDOSS_HASNAIO)
+                             |XRDOSS_HASFICL;} // Async I/O only via io_uring and clone aware
 int       GenLocalPath(const char *, char *);
 int       GenRemotePath(const char *, char *);
 int       Init(XrdSysLogger *, const char *, XrdOucEnv *envP);
@@ -285,6 +287,8 @@ int               prBytes;   //    preread byte limit
 int               prActive;  //    preread activity count
 short             prDepth;   //    preread depth
 short             prQSize;   //    preread maximum allowed
+int               urRings;   //    io_uring rings (0 -> posix aio)
+int               urDepth;   //    io_uring requests in flight per ring
 
 XrdVersionInfo   *myVersion; //    Compilation version set by constructor
    
@@ -353,6 +357,7 @@ void   ConfigStats(XrdSysError &Eroute);
 void   ConfigStats(dev_t Devnum, char *lP);
 int    ConfigXeq(char *, XrdOucStream &, XrdSysError &);
 void   List_Path(const char *, const char *, unsigned long long, XrdSysError &);
+int    xaio(XrdOucStream &Config, XrdSysError &Eroute);
 int    xalloc(XrdOucStream &Config, XrdSysError &Eroute);
 int    xcache(XrdOucStream &Config, XrdSysError &Eroute);
 int    xcachescan(XrdOucStream &Config, XrdSysError &Eroute);
@@ -248,6 +248,8 @@ XrdOssSys::XrdOssSys()
    prActive      = 0;
    prDepth       = 0;
    prQSize       = 0;
+   urRings       = 0;
+   urDepth       = 0;
    STT_Lib       = 0;
    STT_Parms     = 0;
    STT_Func      = 0;
@@ -382,6 +384,10 @@ int XrdOssSys::Configure(const char *configfn, XrdSysError &Eroute,
 //
    if (!NoGo) NoGo = !AioInit();
 
+// Configure io_uring, if wanted. Failure is not fatal as we can use the rest.
+//
+   if (!NoGo && urRings) XrdOssUring::Init(Eroute, urRings, urDepth);
+
 // Initialize memory mapping setting to speed execution
 //
    if (!NoGo) ConfigMio(Eroute);
@@ -473,6 +479,7 @@ void XrdOssSys::Config_Display(XrdSysError &Eroute)
 
      snprintf(buff, sizeof(buff), "Config effective %s oss configuration:\n"
                                   "       oss.alloc        %lld %d %d\n"
+                                  "       oss.aio          %s\n"
                                   "       oss.spacescan    %d\n"
                                   "       oss.fdlimit      %d %d\n"
                                   "       oss.maxsize      %lld\n"
@@ -486,6 +493,7 @@ void XrdOssSys::Config_Display(XrdSysError &Eroute)
                                   "       oss.xfr          %d deny %d keep %d",
              cloc,
              minalloc, ovhalloc, fuzalloc,
+             (XrdOssUring::Enabled() ? "uring" : "posix"),
              cscanint,
              FDFence, FDLimit, MaxSize,
              XrdOssConfig_Val(N2N_Lib,    namelib),
@@ -1106,6 +1114,7 @@ int XrdOssSys::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute)
     int nosubs;
     XrdOucEnv *myEnv = 0;
 
+   TS_Xeq("aio",           xaio);
    TS_Xeq("alloc",         xalloc);
    TS_Xeq("cache",         xcache);
    TS_Xeq("cachescan",     xcachescan); // Backward compatibility
@@ -1174,6 +1183,64 @@ int XrdOssSys::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute)
    return 0;
 }
 
+/******************************************************************************/
+/*                                  x a i o                                   */
+/******************************************************************************/
+
+/* Function: xaio
+
+   Purpose:  To parse the directive: aio {posix | uring [rings <n>] [qdepth <d>]}
+
+             posix    use POSIX asynchronous I/O, if available (the default).
+             uring    use Linux io_uring for asynchronous reads, writes, and
+                      fsyncs as well as for vector reads. When io_uring is
+                      unavailable, posix is used.
+             <n>      the number of rings to use. Each ring has its own
+                      completion thread. The default is 2, the maximum 64.
+             <d>      the maximum number of requests in flight per ring. The
+                      kernel rounds this up to a power of two. The default is
+                      256, the maximum 4096.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdOssSys::xaio(XrdOucStream &Config, XrdSysError &Eroute)
+{
+    char *val;
+    int rings = 2, depth = 256;
+
+      if (!(val = Config.GetWord()))
+         {Eroute.Emsg("Config", "aio type not specified"); return 1;}
+
+      if (!strcmp(val, "posix")) {urRings = 0; return 0;}
+      if ( strcmp(val, "uring"))
+         {Eroute.Emsg("Config", "invalid aio type -", val); return 1;}
+
+      while((val = Config.GetWord()))
+           {     if (!strcmp(val, "rings"))
+                    {if (!(val = Config.GetWord()))
+                        {Eroute.Emsg("Config","aio rings not specified");
+                         return 1;
+                        }
+                     if (XrdOuca2x::a2i(Eroute,"aio rings",val,&rings,1,64))
+                        return 1;
+                    }
+            else if (!strcmp(val, "qdepth"))
+                    {if (!(val = Config.GetWord()))
+                        {Eroute.Emsg("Config","aio qdepth not specified");
+                         return 1;
+                        }
+                     if (XrdOuca2x::a2i(Eroute,"aio qdepth",val,&depth,1,4096))
+                        return 1;
+                    }
+            else {Eroute.Emsg("Config","invalid aio option -",val); return 1;}
+           }
+
+      urRings = rings;
+      urDepth = depth;
+      return 0;
+}
+
 /******************************************************************************/
 /*                                x a l l o c                                 */
 /******************************************************************************/
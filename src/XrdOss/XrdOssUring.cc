@@ -0,0 +1,589 @@
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d O s s U r i n g . c c                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <unistd.h>
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if !defined(__NR_io_uring_setup) || !defined(IO_URING_OP_SUPPORTED)
+#undef HAVE_IO_URING
+#endif
+#endif
+
+#include "XrdOss/XrdOssUring.hh"
+#include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdSfs/XrdSfsAio.hh"
+#include "XrdSys/XrdSysAtomics.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                               G l o b a l s                                */
+/******************************************************************************/
+
+extern XrdSysError OssEroute;
+
+XrdOssUringRing *XrdOssUring::Rings    = 0;
+int              XrdOssUring::numRings = 0;
+int              XrdOssUring::nxtRing  = 0;
+
+#ifdef HAVE_IO_URING
+/******************************************************************************/
+/*                         L o c a l   C l a s s e s                          */
+/******************************************************************************/
+
+// Each submission carries a tag in the low order bits of its user data so that
+// the reaper knows how to complete it. All tagged objects are 8-byte aligned.
+//
+namespace
+{
+const uint64_t tagRead  = 1;
+const uint64_t tagWrite = 2;
+const uint64_t tagSegm  = 3;
+const uint64_t tagMask  = 7;
+
+// A vector read waits for all of its segments to complete. Segments are
+// completed by the reaper; one that could not be submitted is never queued.
+//
+struct RVWait
+      {XrdSysMutex     rvMutex;
+       XrdSysSemaphore done;
+       ssize_t         totBytes;
+       int             eCode;
+
+       RVWait() : done(0, "oss uring readv"), totBytes(0), eCode(0) {}
+      };
+
+struct alignas(8) RVSegm
+      {RVWait *wP;
+       int     size;
+      };
+
+void Complete(uint64_t udata, int res)
+{
+   void *objP = (void *)(udata & ~tagMask);
+
+   switch(udata & tagMask)
+         {case tagRead:
+               {XrdSfsAio *aiop = (XrdSfsAio *)objP;
+                aiop->Result = res;
+                aiop->doneRead();
+               }
+               break;
+          case tagWrite:
+               {XrdSfsAio *aiop = (XrdSfsAio *)objP;
+                aiop->Result = res;
+                aiop->doneWrite();
+               }
+               break;
+          case tagSegm:
+               {RVSegm *sP = (RVSegm *)objP;
+                RVWait *wP = sP->wP;
+                wP->rvMutex.Lock();
+                if (res < 0) {if (!wP->eCode) wP->eCode = -res;}
+                   else if (res != sP->size)
+                           {if (!wP->eCode) wP->eCode = ESPIPE;}
+                   else wP->totBytes += res;
+                wP->rvMutex.UnLock();
+                wP->done.Post();
+               }
+               break;
+          default: break;
+         }
+}
+
+// A submitter waits until the kernel took its request or the request failed.
+//
+struct SQWait
+      {int  rc;
+       bool done;
+      };
+
+int uringEnter(int fd, unsigned tosub, unsigned minc, unsigned flags)
+{
+   return (int)syscall(__NR_io_uring_enter, fd, tosub, minc, flags, 0, 0);
+}
+}
+
+/******************************************************************************/
+/*                 C l a s s   X r d O s s U r i n g R i n g                  */
+/******************************************************************************/
+
+class XrdOssUringRing
+{
+public:
+
+bool  Init(XrdSysError &eDest, int qdepth);
+
+void *Reap();
+
+int   Submit(int opc, int fd, void *buff, unsigned int blen, off_t offs,
+             uint64_t udata);
+
+      XrdOssUringRing() : sqCond(0, "oss uring submit"), ringFD(-1),
+                          sqTLocal(0), inFlight(0), maxFlight(0),
+                          pending(0), submitting(false) {}
+     ~XrdOssUringRing() {} // Rings are never deleted
+
+private:
+
+void  Entered(int n);
+void  Fail(int eCode);
+
+XrdSysCondVar        sqCond;    // Serializes submission queue updates
+std::deque<SQWait *> sqWaitQ;   // Submitters of entries not yet consumed
+int                  ringFD;
+unsigned int        *sqHead;
+unsigned int        *sqTail;
+unsigned int        *sqMask;
+unsigned int        *sqArray;
+struct io_uring_sqe *sqEnts;
+unsigned int        *cqHead;
+unsigned int        *cqTail;
+unsigned int        *cqMask;
+struct io_uring_cqe *cqEnts;
+unsigned int         sqTLocal;  // Our copy of the submission tail
+int                  inFlight;  // Requests submitted but not yet reaped
+int                  maxFlight;
+int                  pending;   // Requests queued but not yet entered
+bool                 submitting;// A thread is in io_uring_enter()
+};
+
+/******************************************************************************/
+/*                       E x t e r n a l   T h r e a d                        */
+/******************************************************************************/
+
+void *XrdOssUringReap(void *carg)
+{
+   XrdOssUringRing *ringP = (XrdOssUringRing *)carg;
+   return ringP->Reap();
+}
+
+/******************************************************************************/
+/*                               E n t e r e d                                */
+/******************************************************************************/
+
+// Called with sqCond held when the kernel consumed the n oldest entries. Their
+// submitters may now return; the requests complete through the reaper.
+//
+void XrdOssUringRing::Entered(int n)
+{
+   while(n-- > 0 && !sqWaitQ.empty())
+        {SQWait *wP = sqWaitQ.front();
+         sqWaitQ.pop_front();
+         wP->rc = 0; wP->done = true;
+        }
+}
+
+/******************************************************************************/
+/*                                  F a i l                                   */
+/******************************************************************************/
+
+// Called with sqCond held when io_uring_enter() failed for good. Entries the
+// kernel has not consumed are withdrawn and each submitter returns the error;
+// as these requests never reached the kernel they are not completed here.
+//
+void XrdOssUringRing::Fail(int eCode)
+{
+   __atomic_store_n(sqTail, __atomic_load_n(sqHead, __ATOMIC_ACQUIRE),
+                    __ATOMIC_RELEASE);
+   sqTLocal = *sqTail;
+   pending  = 0;
+   AtomicSub(inFlight, (int)sqWaitQ.size());
+
+   while(!sqWaitQ.empty())
+        {SQWait *wP = sqWaitQ.front();
+         sqWaitQ.pop_front();
+         wP->rc = -eCode; wP->done = true;
+        }
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+bool XrdOssUringRing::Init(XrdSysError &eDest, int qdepth)
+{
+   struct io_uring_params uParms;
+   struct io_uring_probe *probe;
+   size_t sqSize, cqSize, prSize;
+   char *sqPtr, *cqPtr;
+   bool isOK;
+
+// Create the ring
+//
+   memset(&uParms, 0, sizeof(uParms));
+   if ((ringFD = (int)syscall(__NR_io_uring_setup, qdepth, &uParms)) < 0)
+      {eDest.Emsg("Uring", errno, "create io_uring");
+       return false;
+      }
+
+// Verify that the kernel supports the operations we need
+//
+   prSize = sizeof(struct io_uring_probe) + 256*sizeof(struct io_uring_probe_op);
+   probe  = (struct io_uring_probe *)calloc(1, prSize);
+   isOK   = syscall(__NR_io_uring_register, ringFD, IORING_REGISTER_PROBE,
+                    probe, 256) == 0
+         && probe->last_op >= IORING_OP_WRITE
+         && (probe->ops[IORING_OP_READ ].flags & IO_URING_OP_SUPPORTED)
+         && (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED)
+         && (probe->ops[IORING_OP_FSYNC].flags & IO_URING_OP_SUPPORTED);
+   free(probe);
+   if (!isOK)
+      {eDest.Emsg("Uring", "io_uring read/write operations not supported.");
+       close(ringFD); ringFD = -1;
+       return false;
+      }
+
+// Map the submission and completion rings (they may share one mapping)
+//
+   sqSize = uParms.sq_off.array + uParms.sq_entries*sizeof(unsigned int);
+   cqSize = uParms.cq_off.cqes  + uParms.cq_entries*sizeof(struct io_uring_cqe);
+   if (uParms.features & IORING_FEAT_SINGLE_MMAP)
+      {if (cqSize > sqSize) sqSize = cqSize;
+       cqSize = sqSize;
+      }
+
+   sqPtr = (char *)mmap(0, sqSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                        ringFD, IORING_OFF_SQ_RING);
+   if (sqPtr == MAP_FAILED)
+      {eDest.Emsg("Uring", errno, "map io_uring submission queue");
+       close(ringFD); ringFD = -1;
+       return false;
+      }
+
+   if (uParms.features & IORING_FEAT_SINGLE_MMAP) cqPtr = sqPtr;
+      else {cqPtr = (char *)mmap(0, cqSize, PROT_READ|PROT_WRITE,
+                                 MAP_SHARED|MAP_POPULATE,
+                                 ringFD, IORING_OFF_CQ_RING);
+            if (cqPtr == MAP_FAILED)
+               {eDest.Emsg("Uring", errno, "map io_uring completion queue");
+                close(ringFD); ringFD = -1;
+                return false;
+               }
+           }
+
+   sqEnts = (struct io_uring_sqe *)mmap(0,
+                          uParms.sq_entries*sizeof(struct io_uring_sqe),
+                          PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                          ringFD, IORING_OFF_SQES);
+   if (sqEnts == MAP_FAILED)
+      {eDest.Emsg("Uring", errno, "map io_uring submission entries");
+       close(ringFD); ringFD = -1;
+       return false;
+      }
+
+   sqHead  = (unsigned int *)(sqPtr + uParms.sq_off.head);
+   sqTail  = (unsigned int *)(sqPtr + uParms.sq_off.tail);
+   sqMask  = (unsigned int *)(sqPtr + uParms.sq_off.ring_mask);
+   sqArray = (unsigned int *)(sqPtr + uParms.sq_off.array);
+   cqHead  = (unsigned int *)(cqPtr + uParms.cq_off.head);
+   cqTail  = (unsigned int *)(cqPtr + uParms.cq_off.tail);
+   cqMask  = (unsigned int *)(cqPtr + uParms.cq_off.ring_mask);
+   cqEnts  = (struct io_uring_cqe *)(cqPtr + uParms.cq_off.cqes);
+
+// We never allow more requests in flight than there are submission entries.
+// As the completion queue is at least as large, it can never overflow.
+//
+   sqTLocal  = *sqTail;
+   maxFlight = uParms.sq_entries;
+   return true;
+}
+
+/******************************************************************************/
+/*                                  R e a p                                   */
+/******************************************************************************/
+
+void *XrdOssUringRing::Reap()
+{
+   unsigned int head, tail;
+   uint64_t udata;
+   int res;
+
+// Wait for completions and hand each one back to its originator
+//
+   do {if (uringEnter(ringFD, 0, 1, IORING_ENTER_GETEVENTS) < 0
+       &&  errno != EINTR && errno != EAGAIN && errno != EBUSY)
+          {OssEroute.Emsg("Uring", errno, "wait for io_uring completions");
+           sleep(1);
+           continue;
+          }
+       head = *cqHead;
+       tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+       while(head != tail)
+            {udata = cqEnts[head & *cqMask].user_data;
+             res   = cqEnts[head & *cqMask].res;
+             head++;
+             __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+             AtomicDec(inFlight);
+             Complete(udata, res);
+            }
+      } while(1);
+
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                                S u b m i t                                 */
+/******************************************************************************/
+
+int XrdOssUringRing::Submit(int opc, int fd, void *buff, unsigned int blen,
+                            off_t offs, uint64_t udata)
+{
+   struct io_uring_sqe *sqe;
+   SQWait myWait = {0, false};
+   unsigned int slot;
+   int n, rc, eCode;
+
+// Make sure the request can be accepted
+//
+   sqCond.Lock();
+   if (AtomicGet(inFlight) >= maxFlight) {sqCond.UnLock(); return 1;}
+   AtomicInc(inFlight);
+
+// Fill out the next submission entry and make it visible to the kernel
+//
+   slot = sqTLocal & *sqMask;
+   sqe  = &sqEnts[slot];
+   memset(sqe, 0, sizeof(struct io_uring_sqe));
+   sqe->opcode    = (unsigned char)opc;
+   sqe->fd        = fd;
+   sqe->addr      = (uint64_t)(uintptr_t)buff;
+   sqe->len       = blen;
+   sqe->off       = (uint64_t)offs;
+   sqe->user_data = udata;
+   sqArray[slot]  = slot;
+   sqTLocal++;
+   __atomic_store_n(sqTail, sqTLocal, __ATOMIC_RELEASE);
+   sqWaitQ.push_back(&myWait);
+   pending++;
+
+// If some other thread is entering the kernel it will submit our request as
+// well and tell us how that went. Otherwise, we become the submitter until
+// nothing remains pending.
+//
+   if (submitting)
+      {while(!myWait.done) sqCond.Wait();
+       sqCond.UnLock();
+       return myWait.rc;
+      }
+   submitting = true;
+
+   do {n = pending; pending = 0;
+       sqCond.UnLock();
+       rc = uringEnter(ringFD, n, 0, 0);
+       eCode = errno;
+       sqCond.Lock();
+       if (rc < 0)
+          {if (eCode == EINTR || eCode == EAGAIN || eCode == EBUSY)
+              pending += n;
+              else {OssEroute.Emsg("Uring", eCode, "submit io_uring requests");
+                    Fail(eCode);
+                   }
+          } else {Entered(rc);
+                  if (rc < n) pending += n - rc;
+                 }
+       sqCond.Broadcast();
+      } while(pending);
+
+   submitting = false;
+   sqCond.UnLock();
+   return myWait.rc;
+}
+#else
+class XrdOssUringRing {};
+#endif
+
+/******************************************************************************/
+/*                                 F s y n c                                  */
+/******************************************************************************/
+
+int XrdOssUring::Fsync(XrdSfsAio *aiop, int fd)
+{
+#ifdef HAVE_IO_URING
+   return Submit(aiop, fd, IORING_OP_FSYNC, (int)tagWrite);
+#else
+   return 1;
+#endif
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+bool XrdOssUring::Init(XrdSysError &eDest, int nrings, int qdepth)
+{
+#ifdef HAVE_IO_URING
+   pthread_t tid;
+   int i, retc;
+
+// Allocate and initialize all of the rings
+//
+   Rings = new XrdOssUringRing[nrings];
+   for (i = 0; i < nrings; i++) if (!Rings[i].Init(eDest, qdepth)) break;
+
+// Start a completion thread for each usable ring
+//
+   nrings = i;
+   for (i = 0; i < nrings; i++)
+       {if ((retc = XrdSysThread::Run(&tid, XrdOssUringReap,
+                                      (void *)&Rings[i], 0, "uring reaper")))
+           {eDest.Emsg("Uring", retc, "create io_uring completion thread");
+            break;
+           }
+       }
+
+// Only rings with a completion thread may be used
+//
+   if (!(numRings = i))
+      {eDest.Emsg("Uring", "Unable to use io_uring; using standard I/O.");
+       return false;
+      }
+   return true;
+#else
+   eDest.Emsg("Uring", "io_uring is not supported on this platform.");
+   return false;
+#endif
+}
+
+/******************************************************************************/
+/*                                  R e a d                                   */
+/******************************************************************************/
+
+int XrdOssUring::Read(XrdSfsAio *aiop, int fd)
+{
+#ifdef HAVE_IO_URING
+   return Submit(aiop, fd, IORING_OP_READ, (int)tagRead);
+#else
+   return 1;
+#endif
+}
+
+/******************************************************************************/
+/*                                 R e a d V                                  */
+/******************************************************************************/
+
+bool XrdOssUring::ReadV(int fd, XrdOucIOVec *readV, int n, ssize_t &totBytes)
+{
+#ifdef HAVE_IO_URING
+   RVWait  rvWait;
+   RVSegm *segs;
+   XrdOssUringRing *ringP;
+   int i, rNum, inQ = 0, rc;
+
+// Pick the ring to be used for all of the segments
+//
+   if (!numRings) return false;
+   AtomicFAdd(rNum, nxtRing, 1);
+   ringP = &Rings[static_cast<unsigned int>(rNum) % numRings];
+   segs  = new RVSegm[n];
+
+// Submit as many segments as the ring will take. When it is full we wait for
+// one of our own segments to complete before trying again. Should the ring be
+// full before we even started, we tell the caller to do this synchronously.
+// Should a submission fail, no further segments are submitted.
+//
+   for (i = 0; i < n; i++)
+       {segs[i].wP   = &rvWait;
+        segs[i].size = readV[i].size;
+        do {rc = ringP->Submit(IORING_OP_READ, fd, readV[i].data,
+                               (unsigned int)readV[i].size,
+                               (off_t)readV[i].offset,
+                               (uint64_t)(uintptr_t)&segs[i] | tagSegm);
+            if (rc > 0)
+               {if (!inQ) {delete [] segs; return false;}
+                rvWait.done.Wait(); inQ--;
+               }
+           } while(rc > 0);
+        if (rc < 0)
+           {rvWait.rvMutex.Lock();
+            if (!rvWait.eCode) rvWait.eCode = -rc;
+            rvWait.rvMutex.UnLock();
+            break;
+           }
+        inQ++;
+       }
+
+// Wait for all remaining segments to complete
+//
+   while(inQ--) rvWait.done.Wait();
+   delete [] segs;
+
+// Return the result
+//
+   totBytes = (rvWait.eCode ? -rvWait.eCode : rvWait.totBytes);
+   return true;
+#else
+   return false;
+#endif
+}
+
+/******************************************************************************/
+/*                                S u b m i t                                 */
+/******************************************************************************/
+
+int XrdOssUring::Submit(XrdSfsAio *aiop, int fd, int opc, int tag)
+{
+#ifdef HAVE_IO_URING
+   int rNum;
+
+// Spread requests over all of the rings. An fsync must not have a buffer and
+// applies to the whole file.
+//
+   if (!numRings) return 1;
+   AtomicFAdd(rNum, nxtRing, 1);
+   XrdOssUringRing &ring = Rings[static_cast<unsigned int>(rNum) % numRings];
+
+   if (opc == IORING_OP_FSYNC)
+      return ring.Submit(opc, fd, 0, 0, 0, (uint64_t)(uintptr_t)aiop | tag);
+
+   return ring.Submit(opc, fd, (void *)aiop->sfsAio.aio_buf,
+                      (unsigned int)aiop->sfsAio.aio_nbytes,
+                      (off_t)aiop->sfsAio.aio_offset,
+                      (uint64_t)(uintptr_t)aiop | tag);
+#else
+   return 1;
+#endif
+}
+
+/******************************************************************************/
+/*                                 W r i t e                                  */
+/******************************************************************************/
+
+int XrdOssUring::Write(XrdSfsAio *aiop, int fd)
+{
+#ifdef HAVE_IO_URING
+   return Submit(aiop, fd, IORING_OP_WRITE, (int)tagWrite);
+#else
+   return 1;
+#endif
+}
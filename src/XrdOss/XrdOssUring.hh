@@ -0,0 +1,107 @@
+#ifndef _XRDOSS_URING_H
+#define _XRDOSS_URING_H
+/******************************************************************************/
+/*                                                                            */
+/*                        X r d O s s U r i n g . h h                         */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <sys/types.h>
+
+class XrdOssUringRing;
+struct XrdOucIOVec;
+class XrdSfsAio;
+class XrdSysError;
+
+//-----------------------------------------------------------------------------
+//! XrdOssUring provides Linux io_uring based file I/O for the default OSS.
+//! Requests are placed on one of a small set of rings. Submissions that arrive
+//! while another thread is entering the kernel are batched into that thread's
+//! io_uring_enter() call. Completions are reaped by one thread per ring and
+//! delivered through the usual XrdSfsAio doneRead()/doneWrite() callbacks.
+//! The interface is stubbed out when io_uring is not available at build time.
+//-----------------------------------------------------------------------------
+
+class XrdOssUring
+{
+public:
+
+//-----------------------------------------------------------------------------
+//! Initialize the rings and start the completion threads.
+//!
+//! @param  eDest   - Where error messages go.
+//! @param  nrings  - The number of rings to create.
+//! @param  qdepth  - The number of requests each ring may have in flight.
+//!
+//! @return true if io_uring is usable, false otherwise.
+//-----------------------------------------------------------------------------
+
+static bool    Init(XrdSysError &eDest, int nrings, int qdepth);
+
+//-----------------------------------------------------------------------------
+//! Indicate whether or not io_uring requests may be issued.
+//-----------------------------------------------------------------------------
+
+static bool    Enabled() {return numRings > 0;}
+
+//-----------------------------------------------------------------------------
+//! Asynchronously read, write, or fsync a file.
+//!
+//! @param  aiop    - The aio request object. Completion is signalled via
+//!                   doneRead() for reads and doneWrite() otherwise.
+//! @param  fd      - The file descriptor to use.
+//!
+//! @return  0 - The request has been queued.
+//! @return >0 - The request was not queued (no ring or ring full).
+//! @return <0 - The request failed, the value is -errno. The aio request is
+//!              not completed, this is left to the caller.
+//-----------------------------------------------------------------------------
+
+static int     Fsync(XrdSfsAio *aiop, int fd);
+static int     Read (XrdSfsAio *aiop, int fd);
+static int     Write(XrdSfsAio *aiop, int fd);
+
+//-----------------------------------------------------------------------------
+//! Read a vector of segments by submitting them as a batch and waiting for
+//! all of them to complete.
+//!
+//! @param  fd      - The file descriptor to use.
+//! @param  readV   - The vector of segments.
+//! @param  n       - The number of elements in readV.
+//! @param  totBytes- Set to the number of bytes read or -errno upon failure.
+//!                   A short read of any segment is reported as -ESPIPE.
+//!
+//! @return true if the request was handled, false if the caller should
+//!         fall back to synchronous reads.
+//-----------------------------------------------------------------------------
+
+static bool    ReadV(int fd, XrdOucIOVec *readV, int n, ssize_t &totBytes);
+
+private:
+
+static int     Submit(XrdSfsAio *aiop, int fd, int opc, int tag);
+
+static XrdOssUringRing *Rings;
+static int              numRings;
+static int              nxtRing;
+};
+#endif
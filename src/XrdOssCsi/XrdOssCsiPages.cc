@@ -168,6 +168,8 @@ void XrdOssCsiPages::TrackedSizeRelease()
 //
 int XrdOssCsiPages::UpdateRange(XrdOssDF *const fd, const void *buff, const off_t offset, const size_t blen, XrdOssCsiRangeGuard &rg)
 {
+   EPNAME("UpdateRange");
+
    if (offset<0)
    {
       return -EINVAL;
@@ -209,6 +211,14 @@ int XrdOssCsiPages::UpdateRange(XrdOssDF *const fd, const void *buff, const off_
       ret = UpdateRangeAligned(buff, offset, blen, sizes);
    }
 
+   // the tags must be in the tag file before the caller writes the data
+   const int wbret = ts_->WriteBack();
+   if (ret>=0 && wbret<0)
+   {
+      TRACE(Warn, "error " << wbret << " while writing back crc32c values for file " << fn_);
+      return wbret;
+   }
+
    return ret;
 }
 
@@ -690,6 +700,8 @@ int XrdOssCsiPages::FetchRange(
 //
 int XrdOssCsiPages::StoreRange(XrdOssDF *const fd, const void *buff, const off_t offset, const size_t blen, uint32_t *csvec, const uint64_t opts, XrdOssCsiRangeGuard &rg)
 {
+   EPNAME("StoreRange");
+
    if (offset<0)
    {
       return -EINVAL;
@@ -753,6 +765,14 @@ int XrdOssCsiPages::StoreRange(XrdOssDF *const fd, const void *buff, const off_t
       ret = StoreRangeAligned(buff,offset,blen,sizes,csvec);
    }
 
+   // the tags must be in the tag file before the caller writes the data
+   const int wbret = ts_->WriteBack();
+   if (ret>=0 && wbret<0)
+   {
+      TRACE(Warn, "error " << wbret << " while writing back crc32c values for file " << fn_);
+      return wbret;
+   }
+
    return ret;
 }
 
@@ -936,4 +956,11 @@ void XrdOssCsiPages::BasicConsistencyCheck(XrdOssDF *fd)
          TRACE(Warn, CRCMismatchError(tag_len, taglp, tag_crc, tagv) << " dp_ext_is_zero=" << dp_ext_is_zero << " (ignoring)");
       }
    }
+
+   // any repaired tag is written now, before further data is written
+   const int wbret = ts_->WriteBack();
+   if (wbret<0)
+   {
+      TRACE(Warn, "error " << wbret << " while writing back crc32c values for file " << fn_);
+   }
 }
@@ -34,6 +34,133 @@
 
 #include <assert.h>
 
+//
+// Treap priorities are a hash of the range's sequence number, which gives the
+// tree an expected logarithmic depth whatever order ranges are added in.
+//
+static uint32_t RangePrio(uint64_t x)
+{
+   x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+   x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL;
+   x ^= x >> 33;
+   return (uint32_t)x;
+}
+
+void XrdOssCsiRanges::AddRange(const off_t start, const off_t end, XrdOssCsiRangeGuard &rg, bool rdonly)
+{
+   std::unique_lock<std::mutex> lck(rmtx_);
+
+   int nblocking = 0;
+   Overlapping(root_, start, end, [&](XrdOssCsiRange_s *o)
+   {
+      if (!(rdonly && o->rdonly))
+      {
+         nblocking++;
+      }
+   });
+
+   XrdOssCsiRange_s *nr = AllocRange();
+   nr->start = start;
+   nr->end = end;
+   nr->rdonly = rdonly;
+   nr->nBlockedBy = nblocking;
+   nr->maxend = end;
+   nr->seq = nextSeq_++;
+   nr->prio = RangePrio(nr->seq);
+   Insert(root_, nr);
+   lck.unlock();
+
+   rg.SetRange(this, nr);
+}
+
+void XrdOssCsiRanges::RemoveRange(XrdOssCsiRange_s *rp)
+{
+   std::lock_guard<std::mutex> guard(rmtx_);
+   Erase(root_, rp);
+
+   Overlapping(root_, rp->start, rp->end, [&](XrdOssCsiRange_s *o)
+   {
+      if (!(rp->rdonly && o->rdonly))
+      {
+         std::unique_lock<std::mutex> l(o->mtx);
+         o->nBlockedBy--;
+         if (o->nBlockedBy == 0)
+         {
+            o->cv.notify_one();
+         }
+      }
+   });
+
+   RecycleRange(rp);
+}
+
+void XrdOssCsiRanges::Insert(XrdOssCsiRange_s *&t, XrdOssCsiRange_s *rp)
+{
+   if (!t)
+   {
+      t = rp;
+      return;
+   }
+
+   if (Before(rp, t))
+   {
+      Insert(t->left, rp);
+      if (t->left->prio > t->prio)
+      {
+         XrdOssCsiRange_s *l = t->left;
+         t->left = l->right;
+         l->right = t;
+         Update(t);
+         t = l;
+      }
+   }
+   else
+   {
+      Insert(t->right, rp);
+      if (t->right->prio > t->prio)
+      {
+         XrdOssCsiRange_s *r = t->right;
+         t->right = r->left;
+         r->left = t;
+         Update(t);
+         t = r;
+      }
+   }
+   Update(t);
+}
+
+void XrdOssCsiRanges::Erase(XrdOssCsiRange_s *&t, XrdOssCsiRange_s *rp)
+{
+   assert(t != NULL);
+
+   if (t == rp)
+   {
+      t = Merge(rp->left, rp->right);
+      rp->left = rp->right = NULL;
+      return;
+   }
+
+   Erase(Before(rp, t) ? t->left : t->right, rp);
+   Update(t);
+}
+
+// every range in a is ordered before every range in b
+XrdOssCsiRange_s *XrdOssCsiRanges::Merge(XrdOssCsiRange_s *a, XrdOssCsiRange_s *b)
+{
+   if (!a) return b;
+   if (!b) return a;
+
+   if (a->prio > b->prio)
+   {
+      a->right = Merge(a->right, b);
+      Update(a);
+      return a;
+   }
+   b->left = Merge(a, b->left);
+   Update(b);
+   return b;
+}
+
 void XrdOssCsiRangeGuard::ReleaseAll()
 {
    if (trackinglenlocked_)
@@ -34,12 +34,13 @@
 #include "XrdSys/XrdSysPthread.hh"
 
 #include <mutex>
-#include <list>
 #include <condition_variable>
 #include <memory>
+#include <cstdint>
 
 // forward decl
 class XrdOssCsiPages;
+class XrdOssCsiTests;
 
 struct XrdOssCsiRange_s
 {
@@ -50,6 +51,13 @@ struct XrdOssCsiRange_s
    std::mutex mtx;
    std::condition_variable cv;
    XrdOssCsiRange_s *next;
+
+   // interval tree linkage, protected by the owning XrdOssCsiRanges::rmtx_
+   XrdOssCsiRange_s *left;
+   XrdOssCsiRange_s *right;
+   off_t maxend;
+   uint64_t seq;
+   uint32_t prio;
 };
 
 class XrdOssCsiRanges;
@@ -96,11 +104,17 @@ private:
    bool trackinglenlocked_;
 };
 
-
+//
+// The page ranges currently locked are kept in an interval tree: a treap
+// ordered by range start (ties broken by arrival order), where each node also
+// records the largest range end in its subtree. Finding the ranges which
+// overlap a new one therefore only visits subtrees that can contain an
+// overlap, rather than every range in flight on the file.
+//
 class XrdOssCsiRanges
 {
 public:
-   XrdOssCsiRanges() : allocList_(NULL) { }
+   XrdOssCsiRanges() : root_(NULL), allocList_(NULL), nextSeq_(0) { }
 
    ~XrdOssCsiRanges()
    {
@@ -115,32 +129,7 @@ public:
    //
    // AddRange: add an inclusive range lock on pages [start, end]
    //
-   void AddRange(const off_t start, const off_t end, XrdOssCsiRangeGuard &rg, bool rdonly)
-   {
-      std::unique_lock<std::mutex> lck(rmtx_);
-    
-      int nblocking = 0;
-      for(auto itr = ranges_.begin(); itr != ranges_.end(); ++itr)
-      {
-         if ((*itr)->start <= end && start <= (*itr)->end)
-         {
-            if (!(rdonly && (*itr)->rdonly))
-            {
-               nblocking++;
-            }
-         }
-      }
-
-      XrdOssCsiRange_s *nr = AllocRange();
-      nr->start = start;
-      nr->end = end;
-      nr->rdonly = rdonly;
-      nr->nBlockedBy = nblocking;
-      ranges_.push_back(nr);
-      lck.unlock();
-
-      rg.SetRange(this, nr);
-   }
+   void AddRange(off_t start, off_t end, XrdOssCsiRangeGuard &rg, bool rdonly);
 
    void Wait(XrdOssCsiRange_s *rp)
    {
@@ -151,54 +140,55 @@ public:
       }
    }
 
-   void RemoveRange(XrdOssCsiRange_s *rp)
-   {
-      std::lock_guard<std::mutex> guard(rmtx_);
-      for(auto itr=ranges_.begin();itr!=ranges_.end();++itr)
-      {
-         if (*itr == rp)
-         {
-            ranges_.erase(itr);
-            break;
-         }
-      }
-
-      for(auto itr=ranges_.begin(); itr != ranges_.end(); ++itr)
-      {
-         if ((*itr)->start <= rp->end && rp->start <= (*itr)->end)
-         {
-            if (!(rp->rdonly && (*itr)->rdonly))
-            {
-               std::unique_lock<std::mutex> l((*itr)->mtx);
-               (*itr)->nBlockedBy--;
-               if ((*itr)->nBlockedBy == 0)
-               {
-                  (*itr)->cv.notify_one();
-               }
-            }
-         }
-     }
-
-     RecycleRange(rp);
-     rp = NULL;
-   }
+   void RemoveRange(XrdOssCsiRange_s *rp);
 
 private:
+   friend class ::XrdOssCsiTests;
+
    std::mutex rmtx_;
-   std::list<XrdOssCsiRange_s *> ranges_;
+   XrdOssCsiRange_s *root_;
    XrdOssCsiRange_s *allocList_;
+   uint64_t nextSeq_;
+
+   // all of the following must be called with rmtx_ locked
+   static bool Before(const XrdOssCsiRange_s *a, const XrdOssCsiRange_s *b)
+   {
+      return a->start < b->start || (a->start == b->start && a->seq < b->seq);
+   }
+
+   static void Update(XrdOssCsiRange_s *t)
+   {
+      t->maxend = t->end;
+      if (t->left && t->left->maxend > t->maxend) t->maxend = t->left->maxend;
+      if (t->right && t->right->maxend > t->maxend) t->maxend = t->right->maxend;
+   }
+
+   static void Insert(XrdOssCsiRange_s *&t, XrdOssCsiRange_s *rp);
+   static void Erase(XrdOssCsiRange_s *&t, XrdOssCsiRange_s *rp);
+   static XrdOssCsiRange_s *Merge(XrdOssCsiRange_s *a, XrdOssCsiRange_s *b);
+
+   template<typename F>
+   static void Overlapping(XrdOssCsiRange_s *t, off_t start, off_t end, F fn)
+   {
+      while(t && t->maxend >= start)
+      {
+         Overlapping(t->left, start, end, fn);
+         if (t->start > end) return;
+         if (start <= t->end) fn(t);
+         t = t->right;
+      }
+   }
 
-   // must be called with rmtx_ locked
    XrdOssCsiRange_s* AllocRange()
    {
       XrdOssCsiRange_s *p;
       if ((p = allocList_)) allocList_ = p->next;
       if (!p) p = new XrdOssCsiRange_s();
       p->next = NULL;
+      p->left = p->right = NULL;
       return p;
    }
 
-   // must be called with rmtx_ locked
    void RecycleRange(XrdOssCsiRange_s* rp)
    {
      rp->next = allocList_;
@@ -45,6 +45,10 @@ public:
    virtual void Flush()=0;
    virtual int Fsync()=0;
 
+   // write out any tags held back by the tagstore. Called before the data
+   // described by the tags is itself written.
+   virtual int WriteBack()=0;
+
    virtual ssize_t WriteTags(const uint32_t *, off_t, size_t)=0;
    virtual ssize_t ReadTags(uint32_t *, off_t, size_t)=0;
 
@@ -35,6 +35,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <algorithm>
 
 extern XrdOucTrace  OssCsiTrace;
 
@@ -48,6 +49,8 @@ int XrdOssCsiTagstoreFile::Open(const char *path, const off_t dsize, const int O
       return ret;
    }
    isOpen = true;
+   cache_.clear();
+   tagfsize_ = 0;
 
    struct guard_s
    {
@@ -134,10 +137,13 @@ int XrdOssCsiTagstoreFile::ResetSizes(const off_t size)
 {
    EPNAME("ResetSizes");
    if (!isOpen) return -EBADF;
+   const int dret = DropCache();
+   if (dret<0) return dret;
    actualsize_ = size;
    struct stat sb;
    const int ssret = fd_->Fstat(&sb);
    if (ssret<0) return ssret;
+   tagfsize_ = sb.st_size;
    const off_t expected_tagfile_size = 20LL + 4*((trackinglen_+XrdSys::PageSize-1)/XrdSys::PageSize);
    // truncate can be relatively slow
    if (expected_tagfile_size < sb.st_size)
@@ -146,6 +152,7 @@ int XrdOssCsiTagstoreFile::ResetSizes(const off_t size)
          ", from current size " << sb.st_size << " for " << fn_);
       const int tret = fd_->Ftruncate(expected_tagfile_size);
       if (tret<0) return tret;
+      tagfsize_ = expected_tagfile_size;
    }
    else if (expected_tagfile_size > sb.st_size)
    {
@@ -157,6 +164,7 @@ int XrdOssCsiTagstoreFile::ResetSizes(const off_t size)
       if (stret<0) return stret;
       const int tret = fd_->Ftruncate(20LL + 4*nb);
       if (tret<0) return tret;
+      tagfsize_ = 20LL + 4*nb;
    }
    return 0;
 }
@@ -164,40 +172,103 @@ int XrdOssCsiTagstoreFile::ResetSizes(const off_t size)
 int XrdOssCsiTagstoreFile::Fsync()
 {
    if (!isOpen) return -EBADF;
+   const int wbret = WriteBack();
+   if (wbret<0) return wbret;
    return fd_->Fsync();
 }
 
 void XrdOssCsiTagstoreFile::Flush()
 {
    if (!isOpen) return;
+   (void)WriteBack();
    fd_->Flush();
 }
 
+int XrdOssCsiTagstoreFile::WriteBack()
+{
+   if (!isOpen) return -EBADF;
+   std::unique_lock<std::mutex> lck(cmtx_);
+   return WriteBackLocked(lck);
+}
+
 int XrdOssCsiTagstoreFile::Close()
 {
    if (!isOpen) return -EBADF;
+   const int wbret = DropCache();
    isOpen = false;
-   return fd_->Close();
+   cache_.clear();
+   const int cret = fd_->Close();
+   if (wbret<0) return wbret;
+   return cret;
 }
 
 ssize_t XrdOssCsiTagstoreFile::WriteTags(const uint32_t *const buf, const off_t off, const size_t n)
 {
    if (!isOpen) return -EBADF;
-   if (machineIsBige_ != fileIsBige_) return WriteTags_swap(buf, off, n);
+   std::unique_lock<std::mutex> lck(cmtx_);
 
-   const ssize_t nwritten = XrdOssCsiTagstoreFile::fullwrite(*fd_, buf, 20LL+4*off, 4*n);
-   if (nwritten<0) return nwritten;
-   return nwritten/4;
+   size_t nwritten = 0;
+   while(nwritten<n)
+   {
+      const off_t foff = 20LL+4*(off+nwritten);
+      const size_t poff = foff % XrdSys::PageSize;
+      const size_t cnt = std::min(n-nwritten, (XrdSys::PageSize-poff)/4);
+
+      // no need to read a page which is about to be overwritten completely
+      int ret = 0;
+      TagPage *const p = GetPage(foff / XrdSys::PageSize, (poff==0 && 4*cnt==XrdSys::PageSize), ret, lck);
+      if (!p) return ret;
+
+      if (machineIsBige_ != fileIsBige_)
+      {
+         for(size_t i=0;i<cnt;i++)
+         {
+            const uint32_t v = bswap_32(buf[nwritten+i]);
+            memcpy(&p->buf[poff+4*i], &v, 4);
+         }
+      }
+      else
+      {
+         memcpy(&p->buf[poff], &buf[nwritten], 4*cnt);
+      }
+      p->dlo = std::min(p->dlo, poff);
+      p->dhi = std::max(p->dhi, poff+4*cnt);
+      tagfsize_ = std::max(tagfsize_, foff+(off_t)(4*cnt));
+      nwritten += cnt;
+   }
+   return n;
 }
 
 ssize_t XrdOssCsiTagstoreFile::ReadTags(uint32_t *const buf, const off_t off, const size_t n)
 {
    if (!isOpen) return -EBADF;
-   if (machineIsBige_ != fileIsBige_) return ReadTags_swap(buf, off, n);
+   std::unique_lock<std::mutex> lck(cmtx_);
+
+   // reading beyond the end of the tagfile is a short read
+   if (20LL+4*(off+(off_t)n) > tagfsize_) return -EDOM;
+
+   size_t nread = 0;
+   while(nread<n)
+   {
+      const off_t foff = 20LL+4*(off+nread);
+      const size_t poff = foff % XrdSys::PageSize;
+      const size_t cnt = std::min(n-nread, (XrdSys::PageSize-poff)/4);
 
-   const ssize_t nread = XrdOssCsiTagstoreFile::fullread(*fd_, buf, 20LL+4*off, 4*n);
-   if (nread<0) return nread;
-   return nread/4;
+      int ret = 0;
+      const TagPage *const p = GetPage(foff / XrdSys::PageSize, false, ret, lck);
+      if (!p) return ret;
+
+      memcpy(&buf[nread], &p->buf[poff], 4*cnt);
+      if (machineIsBige_ != fileIsBige_)
+      {
+         for(size_t i=0;i<cnt;i++)
+         {
+            buf[nread+i] = bswap_32(buf[nread+i]);
+         }
+      }
+      nread += cnt;
+   }
+   return n;
 }
 
 int XrdOssCsiTagstoreFile::Truncate(const off_t size, bool datatoo)
@@ -207,12 +278,18 @@ int XrdOssCsiTagstoreFile::Truncate(const off_t size, bool datatoo)
       return -EBADF;
    }
 
+   // pending tags are written before the length changes, as they would have
+   // been without the cache
+   const int dret = DropCache();
+   if (dret<0) return dret;
+
    // set tag file to correct length for value of size
    const off_t expected_tagfile_size = 20LL + 4*((size+XrdSys::PageSize-1)/XrdSys::PageSize);
    const int tret = fd_->Ftruncate(expected_tagfile_size);
 
    // if failed to set the tagfile length return error before updating header
    if (tret != XrdOssOK) return tret;
+   tagfsize_ = expected_tagfile_size;
 
    // truncating down to zero, so reset to content verified
    if (datatoo && size==0) hflags_ |= XrdOssCsiTagstore::csVer;
@@ -224,44 +301,180 @@ int XrdOssCsiTagstoreFile::Truncate(const off_t size, bool datatoo)
    return 0;
 }
 
-ssize_t XrdOssCsiTagstoreFile::WriteTags_swap(const uint32_t *const buf, const off_t off, const size_t n)
+//
+// GetPage: return the cached copy of page pg of the tagfile, reading it in if
+//          needed unless the caller will overwrite all of it. Must be called
+//          with cmtx_ held via lck, which is released while any I/O is done.
+//
+XrdOssCsiTagstoreFile::TagPage *XrdOssCsiTagstoreFile::GetPage(const off_t pg, const bool whole, int &ret, std::unique_lock<std::mutex> &lck)
 {
-   uint32_t b[1024];
-   const size_t bsz = sizeof(b)/sizeof(uint32_t);
-   size_t towrite = n;
-   size_t nwritten = 0;
-   while(towrite>0)
+   while(true)
    {
-      const size_t bs = std::min(towrite, bsz);
-      for(size_t i=0;i<bs;i++)
+      auto itr = cache_.find(pg);
+      if (itr != cache_.end())
       {
-         b[i] = bswap_32(buf[i+nwritten]);
+         if (!itr->second.busy)
+         {
+            itr->second.used = ++cacheUse_;
+            return &itr->second;
+         }
+         ccv_.wait(lck);
+         continue;
       }
-      const ssize_t wret = XrdOssCsiTagstoreFile::fullwrite(*fd_, b, 20LL+4*(nwritten+off), 4*bs);
+      if (cache_.size() < cachePages_) break;
+
+      // the lock may have been dropped while evicting, so look for pg again
+      const int eret = EvictPage(lck);
+      if (eret<0)
+      {
+         ret = eret;
+         return NULL;
+      }
+      if (eret==0) break;
+   }
+
+   // new pages start out zeroed, as is any part beyond the end of the tagfile
+   TagPage &p = cache_[pg];
+   p.dlo = XrdSys::PageSize;
+   p.dhi = 0;
+   p.used = ++cacheUse_;
+   p.busy = false;
+
+   const off_t pstart = pg*XrdSys::PageSize;
+   if (whole || pstart >= tagfsize_) return &p;
+
+   // the page can not be evicted or dropped while busy, so p stays valid
+   const size_t toread = std::min((off_t)XrdSys::PageSize, tagfsize_-pstart);
+   p.busy = true;
+   cacheBusy_++;
+   lck.unlock();
+
+   ssize_t rret = 0;
+   size_t nread = 0;
+   while(nread<toread)
+   {
+      rret = fd_->Read(&p.buf[nread], pstart+nread, toread-nread);
+      if (rret<=0) break;
+      nread += rret;
+   }
+
+   lck.lock();
+   p.busy = false;
+   cacheBusy_--;
+   ccv_.notify_all();
+   if (rret<0)
+   {
+      cache_.erase(pg);
+      ret = rret;
+      return NULL;
+   }
+   return &p;
+}
+
+//
+// EvictPage: remove the least recently used page which is not busy, first
+//            writing its dirty bytes with cmtx_ released. Returns 1 if a page
+//            was removed, 0 if every page is busy or a negative error.
+//
+int XrdOssCsiTagstoreFile::EvictPage(std::unique_lock<std::mutex> &lck)
+{
+   auto victim = cache_.end();
+   for(auto vi = cache_.begin(); vi != cache_.end(); ++vi)
+   {
+      if (vi->second.busy) continue;
+      if (victim == cache_.end() || vi->second.used < victim->second.used) victim = vi;
+   }
+   if (victim == cache_.end()) return 0;
+
+   TagPage &vp = victim->second;
+   if (vp.dlo < vp.dhi)
+   {
+      const off_t vpg = victim->first;
+      vp.busy = true;
+      cacheBusy_++;
+      lck.unlock();
+
+      const ssize_t wret = fullwrite(*fd_, &vp.buf[vp.dlo], vpg*XrdSys::PageSize + vp.dlo, vp.dhi - vp.dlo);
+
+      lck.lock();
+      vp.busy = false;
+      cacheBusy_--;
+      ccv_.notify_all();
       if (wret<0) return wret;
-      towrite -= wret/4;
-      nwritten += wret/4;
+      cache_.erase(vpg);
+      return 1;
    }
-   return n;
+   cache_.erase(victim);
+   return 1;
 }
 
-ssize_t XrdOssCsiTagstoreFile::ReadTags_swap(uint32_t *const buf, const off_t off, const size_t n)
+//
+// WriteBackLocked: write all dirty bytes, in file order. Dirty ranges which
+//                  continue into the next page are joined into a single write.
+//                  Must be called with cmtx_ held via lck. Waits for pages
+//                  being evicted, so their bytes have also reached the file.
+//
+int XrdOssCsiTagstoreFile::WriteBackLocked(std::unique_lock<std::mutex> &lck)
 {
-   uint32_t b[1024];
-   const size_t bsz = sizeof(b)/sizeof(uint32_t);
-   size_t toread = n;
-   size_t nread = 0;
-   while(toread>0)
+   while(cacheBusy_>0)
+   {
+      ccv_.wait(lck);
+   }
+
+   auto itr = cache_.begin();
+   while(itr != cache_.end())
    {
-      const size_t bs = std::min(toread, bsz);
-      const ssize_t rret = XrdOssCsiTagstoreFile::fullread(*fd_, b, 20LL+4*(nread+off), 4*bs);
-      if (rret<0) return rret;
-      for(size_t i=0;i<bs;i++)
+      TagPage &p = itr->second;
+      if (p.dlo >= p.dhi)
       {
-         buf[i+nread] = bswap_32(b[i]);
+         ++itr;
+         continue;
       }
-      toread -= rret/4;
-      nread += rret/4;
+
+      auto last = itr;
+      auto nxt = std::next(itr);
+      while(last->second.dhi == XrdSys::PageSize && nxt != cache_.end() &&
+            nxt->first == last->first+1 && nxt->second.dlo == 0)
+      {
+         last = nxt;
+         ++nxt;
+      }
+
+      const uint8_t *wp = &p.buf[p.dlo];
+      size_t wlen = p.dhi - p.dlo;
+      if (last != itr)
+      {
+         wbbuf_.clear();
+         for(auto wi = itr; wi != nxt; ++wi)
+         {
+            wbbuf_.insert(wbbuf_.end(), &wi->second.buf[wi->second.dlo], &wi->second.buf[wi->second.dhi]);
+         }
+         wp = wbbuf_.data();
+         wlen = wbbuf_.size();
+      }
+
+      const ssize_t wret = fullwrite(*fd_, wp, itr->first*XrdSys::PageSize + p.dlo, wlen);
+      if (wret<0) return wret;
+
+      for(auto wi = itr; wi != nxt; ++wi)
+      {
+         wi->second.dlo = XrdSys::PageSize;
+         wi->second.dhi = 0;
+      }
+      itr = nxt;
    }
-   return n;
+   return 0;
+}
+
+//
+// DropCache: write back and then forget all cached pages, used when the
+//            tagfile length is about to change.
+//
+int XrdOssCsiTagstoreFile::DropCache()
+{
+   std::unique_lock<std::mutex> lck(cmtx_);
+   const int wbret = WriteBackLocked(lck);
+   if (wbret<0) return wbret;
+   cache_.clear();
+   return 0;
 }
@@ -36,13 +36,16 @@
 #include "XrdOuc/XrdOucCRC.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 
+#include <condition_variable>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 class XrdOssCsiTagstoreFile : public XrdOssCsiTagstore
 {
 public:
-   XrdOssCsiTagstoreFile(const std::string &fn, std::unique_ptr<XrdOssDF> fd, const char *tid) : fn_(fn), fd_(std::move(fd)), trackinglen_(0), isOpen(false), tident_(tid), tident(tident_.c_str()) { }
+   XrdOssCsiTagstoreFile(const std::string &fn, std::unique_ptr<XrdOssDF> fd, const char *tid) : fn_(fn), fd_(std::move(fd)), trackinglen_(0), isOpen(false), tident_(tid), tident(tident_.c_str()), tagfsize_(0), cacheUse_(0), cacheBusy_(0) { }
    virtual ~XrdOssCsiTagstoreFile() { if (isOpen) { (void)Close(); } }
 
    virtual int Open(const char *, off_t, int, XrdOucEnv &) /* override */;
@@ -50,6 +53,7 @@ public:
 
    virtual void Flush() /* override */;
    virtual int Fsync() /* override */;
+   virtual int WriteBack() /* override */;
 
    virtual ssize_t WriteTags(const uint32_t *, off_t, size_t) /* override */;
    virtual ssize_t ReadTags(uint32_t *, off_t, size_t) /* override */;
@@ -146,8 +150,40 @@ private:
    uint8_t header_[20];
    uint32_t hflags_;
 
-   ssize_t WriteTags_swap(const uint32_t *, off_t, size_t);
-   ssize_t ReadTags_swap(uint32_t *, off_t, size_t);
+   //
+   // Recently used pages of the tag file are kept in memory, in the byte order
+   // of the file. Updates only mark the bytes concerned as dirty; they are
+   // written by WriteBack(), which the pages object calls before the data the
+   // tags describe is written, so the tags still reach the file first. Dirty
+   // bytes are also written before any header update or change of the tag
+   // file length, so neither can reach the file ahead of tags set before
+   // them. Dirty ranges of adjacent pages are written with one call.
+   //
+   // A page being read in, or written out on eviction, is marked busy and
+   // cmtx_ is released for the I/O; anyone else needing that page waits on
+   // ccv_ until it is done.
+   //
+   struct TagPage
+   {
+      uint8_t buf[XrdSys::PageSize];
+      size_t dlo;       // dirty bytes are [dlo, dhi), dlo >= dhi if clean
+      size_t dhi;
+      uint64_t used;
+      bool busy;
+   };
+
+   std::mutex cmtx_;
+   std::condition_variable ccv_;
+   std::map<off_t, TagPage> cache_;
+   std::vector<uint8_t> wbbuf_;
+   off_t tagfsize_;     // tag file length, including bytes not yet written
+   uint64_t cacheUse_;
+   int cacheBusy_;      // number of pages in cache_ marked busy
+
+   TagPage *GetPage(off_t, bool, int &, std::unique_lock<std::mutex> &);
+   int EvictPage(std::unique_lock<std::mutex> &);
+   int WriteBackLocked(std::unique_lock<std::mutex> &);
+   int DropCache();
 
    int WriteTrackedTagSize(const off_t size)
    {
@@ -160,6 +196,10 @@ private:
    {
       if (!isOpen) return -EBADF;
 
+      std::unique_lock<std::mutex> lck(cmtx_);
+      const int wbret = WriteBackLocked(lck);
+      if (wbret<0) return wbret;
+
       uint32_t y = cmagic_;
       if (fileIsBige_ != machineIsBige_) y = bswap_32(y);
       memcpy(header_, &y, 4);
@@ -178,10 +218,12 @@ private:
 
       ssize_t wret = fullwrite(*fd_, header_, 0, 20);
       if (wret<0) return wret;
+      if (tagfsize_ < 20) tagfsize_ = 20;
       return 0;
    }
 
    static const uint32_t cmagic_ = 0x30544452U;
+   static const size_t cachePages_ = 16;
 };
 
 #endif
@@ -199,20 +199,10 @@ uint32_t XrdOucCRC::Calc32C(const void* data, size_t count, uint32_t prevcs)
   
 void XrdOucCRC::Calc32C(const void* data, size_t count, uint32_t* csval)
 {
-   int i, numpages = count/XrdSys::PageSize;
-   const uint8_t* dataP = (const uint8_t*)data;
-
-// Calculate the CRC32C for each page
-//
-   for (i = 0; i < numpages; i++)
-       {csval[i] = crc32c(0, dataP, XrdSys::PageSize);
-        count -= XrdSys::PageSize;
-        dataP += XrdSys::PageSize;
-       }
 
-// if there is anything left, calculate that as well
+// Calculate the CRC32C for each page, several pages at a time when possible
 //
-   if (count > 0) csval[i] = crc32c(0, dataP, count);
+   crc32c_pages(data, count, XrdSys::PageSize, csval);
 }
 
 /******************************************************************************/
@@ -236,33 +226,30 @@ bool XrdOucCRC::Ver32C(const void*    data,  size_t    count,
 int  XrdOucCRC::Ver32C(const void*     data,  size_t    count,
                        const uint32_t* csval, uint32_t& valcs)
 {
-   int i, numpages = count/XrdSys::PageSize;
+   static const int pgBatch = 64;
+   uint32_t actualCS[pgBatch];
    const uint8_t* dataP = (const uint8_t*)data;
-   uint32_t actualCS;
+   int pgBase = 0;
 
-// Calculate the CRC32C for each page and make sure it is the same.
-//
-   for (i = 0; i < numpages; i++)
-       {
-        actualCS = crc32c(0, dataP, XrdSys::PageSize);
-        if (csval[i] != actualCS)
-           {valcs = actualCS;
-            return i;
-           }
-        count -= XrdSys::PageSize;
-        dataP += XrdSys::PageSize;
-       }
-
-// if there is anything left, verify that as well
+// Calculate the CRC32C for a batch of pages and make sure they are the same.
+// Batching lets the multi-page kernel run while still stopping at the first
+// batch with a bad page.
 //
-   if (count > 0)
-      {
-       actualCS = crc32c(0, dataP, count);
-       if (csval[i] != actualCS)
-          {valcs = actualCS;
-           return i;
-          }
-      }
+   while(count > 0)
+        {size_t bytes = (count < (size_t)pgBatch*XrdSys::PageSize
+                      ?  count : (size_t)pgBatch*XrdSys::PageSize);
+         int n = bytes/XrdSys::PageSize + (bytes%XrdSys::PageSize != 0);
+         crc32c_pages(dataP, bytes, XrdSys::PageSize, actualCS);
+         for (int i = 0; i < n; i++)
+             {if (csval[pgBase+i] != actualCS[i])
+                 {valcs = actualCS[i];
+                  return pgBase+i;
+                 }
+             }
+         pgBase += n;
+         count  -= bytes;
+         dataP  += bytes;
+        }
 
 // Everything matched.
 //
@@ -274,30 +261,27 @@ int  XrdOucCRC::Ver32C(const void*     data,  size_t    count,
 bool XrdOucCRC::Ver32C(const void*     data,  size_t count,
                        const uint32_t* csval, bool*  valok)
 {
-   int i, numpages = count/XrdSys::PageSize;
+   static const int pgBatch = 64;
+   uint32_t actualCS[pgBatch];
    const uint8_t* dataP = (const uint8_t*)data;
-   uint32_t actualCS;
+   int pgBase = 0;
    bool retval = true;
 
-// Calculate the CRC32C for each page and make sure it is the same.
-//
-   for (i = 0; i < numpages; i++)
-       {
-        actualCS = crc32c(0, dataP, XrdSys::PageSize);
-        if (csval[i] == actualCS) valok[i] = true;
-           else valok[i] = retval = false;
-        count -= XrdSys::PageSize;
-        dataP += XrdSys::PageSize;
-       }
-
-// if there is anything left, verify that as well
+// Calculate the CRC32C for a batch of pages and make sure they are the same.
 //
-   if (count > 0)
-      {
-       actualCS = crc32c(0, dataP, count);
-       if (csval[i] == actualCS) valok[i] = true;
-           else valok[i] = retval = false;
-      }
+   while(count > 0)
+        {size_t bytes = (count < (size_t)pgBatch*XrdSys::PageSize
+                      ?  count : (size_t)pgBatch*XrdSys::PageSize);
+         int n = bytes/XrdSys::PageSize + (bytes%XrdSys::PageSize != 0);
+         crc32c_pages(dataP, bytes, XrdSys::PageSize, actualCS);
+         for (int i = 0; i < n; i++)
+             {if (csval[pgBase+i] == actualCS[i]) valok[pgBase+i] = true;
+                 else valok[pgBase+i] = retval = false;
+             }
+         pgBase += n;
+         count  -= bytes;
+         dataP  += bytes;
+        }
 
 // All done.
 //
@@ -309,27 +293,13 @@ bool XrdOucCRC::Ver32C(const void*     data,  size_t count,
 bool XrdOucCRC::Ver32C(const void*     data,  size_t    count,
                        const uint32_t* csval, uint32_t* valcs)
 {
-   int i, numpages = count/XrdSys::PageSize;
-   const uint8_t* dataP = (const uint8_t*)data;
+   int i, numpages = count/XrdSys::PageSize + (count%XrdSys::PageSize != 0);
    bool retval = true;
 
-// Calculate the CRC32C for each page and make sure it is the same.
-//
-   for (i = 0; i < numpages; i++)
-       {
-        valcs[i] = crc32c(0, dataP, XrdSys::PageSize);
-        if (csval[i] != valcs[i]) retval = false;
-        count -= XrdSys::PageSize;
-        dataP += XrdSys::PageSize;
-       }
-
-// if there is anything left, verify that as well
+// Calculate the CRC32C for each page directly into valcs and compare.
 //
-   if (count > 0)
-      {
-       valcs[i] = crc32c(0, dataP, count);
-       if (csval[i] != valcs[i]) retval = false;
-      }
+   crc32c_pages(data, count, XrdSys::PageSize, valcs);
+   for (i = 0; i < numpages; i++) if (csval[i] != valcs[i]) retval = false;
 
 // All done.
 //
@@ -45,11 +45,19 @@
                      XrdOucCRC32C.hh with corresponding change to include
                      statement herein. Add required casts to allow C++
                      compilation.
+        16 Oct 2026  Cache the SSE 4.2 check. Add crc32c_pages() which computes
+                     the CRC-32C of each page of a buffer, several pages at a
+                     time, using VPCLMULQDQ folding or interleaved crc32
+                     instructions when available.
  */
 
 #include <pthread.h>
 #include "XrdOuc/XrdOucCRC32C.hh"
 
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
 /* CRC-32C (iSCSI) polynomial in reversed bit order. */
 #define POLY 0x82f63b78
 
@@ -247,6 +255,100 @@ static uint32_t crc32c_hw(uint32_t crc, void const *buf, size_t len) {
     return ~crc0;
 }
 
+/* Compute the CRC-32C of three equal sized pages at once.  The pages are
+   independent so the three crc32 instructions in flight need no combining
+   afterwards, unlike crc32c_hw() above.  pgsz must be a multiple of eight. */
+static void crc32c_hw_pages3(unsigned char const *buf, size_t pgsz,
+                             uint32_t *crcs) {
+    uint64_t crc0 = 0xffffffff, crc1 = 0xffffffff, crc2 = 0xffffffff;
+    unsigned char const *next = buf;
+    unsigned char const * const end = buf + pgsz;
+
+    do {
+        __asm__("crc32q\t" "(%3), %0\n\t"
+                "crc32q\t" "(%3,%4), %1\n\t"
+                "crc32q\t" "(%3,%4,2), %2"
+                : "=r"(crc0), "=r"(crc1), "=r"(crc2)
+                : "r"(next), "r"(pgsz), "0"(crc0), "1"(crc1), "2"(crc2));
+        next += 8;
+    } while (next < end);
+    crcs[0] = ~(uint32_t)crc0;
+    crcs[1] = ~(uint32_t)crc1;
+    crcs[2] = ~(uint32_t)crc2;
+}
+
+/* Return x^n modulo the CRC-32C polynomial in reversed bit order. */
+static uint32_t crc32c_xpow(unsigned n) {
+    uint32_t r = 0x80000000;            /* x^0 */
+    while (n--)
+        r = r & 1 ? (r >> 1) ^ POLY : r >> 1;
+    return r;
+}
+
+/* Folding constants for the carry-less multiply page kernel.  A 128-bit block
+   is moved forward by d bits by multiplying its low (earlier) quadword by
+   x^(d+31) and its high quadword by x^(d-33), both modulo POLY.  The odd
+   exponents account for the bit reversal and the 32-bit constant width.  The
+   first pair moves each lane of a 512-bit register over the next 64 bytes.
+   The remaining pairs fold lanes 0, 1, and 2 onto lane 3. */
+static pthread_once_t crc32c_once_fold = PTHREAD_ONCE_INIT;
+static uint64_t crc32c_fold_k[2][8];
+
+static void crc32c_init_fold(void) {
+    static unsigned const dist[4] = {384, 256, 128, 0};
+    for (unsigned n = 0; n < 4; n++) {
+        crc32c_fold_k[0][2*n]   = crc32c_xpow(512 + 31);
+        crc32c_fold_k[0][2*n+1] = crc32c_xpow(512 - 33);
+        if (dist[n]) {
+            crc32c_fold_k[1][2*n]   = crc32c_xpow(dist[n] + 31);
+            crc32c_fold_k[1][2*n+1] = crc32c_xpow(dist[n] - 33);
+        } else
+            crc32c_fold_k[1][2*n] = crc32c_fold_k[1][2*n+1] = 0;
+    }
+}
+
+/* Compute the CRC-32C of four equal sized pages at once by folding each page
+   64 bytes at a time with VPCLMULQDQ.  The four pages keep four independent
+   dependency chains in flight to hide the multiply latency.  What is left
+   after folding is a 128-bit remainder per page whose CRC equals that of the
+   whole page, which two crc32 instructions finish off.  pgsz must be a
+   non-zero multiple of 64. */
+__attribute__((target("avx512f,vpclmulqdq,sse4.2")))
+static void crc32c_fold_pages4(unsigned char const *buf, size_t pgsz,
+                               uint32_t *crcs) {
+    __m512i const kfold = _mm512_loadu_si512((void const *)crc32c_fold_k[0]);
+    __m512i const klast = _mm512_loadu_si512((void const *)crc32c_fold_k[1]);
+    __m512i const init = _mm512_set_epi32(0, 0, 0, 0, 0, 0, 0, 0,
+                                          0, 0, 0, 0, 0, 0, 0, -1);
+    __m512i acc[4];
+
+    for (unsigned n = 0; n < 4; n++)
+        acc[n] = _mm512_xor_si512(
+                     _mm512_loadu_si512((void const *)(buf + n*pgsz)), init);
+
+    for (size_t off = 64; off < pgsz; off += 64) {
+        for (unsigned n = 0; n < 4; n++) {
+            __m512i const d =
+                _mm512_loadu_si512((void const *)(buf + n*pgsz + off));
+            acc[n] = _mm512_ternarylogic_epi64(
+                         _mm512_clmulepi64_epi128(acc[n], kfold, 0x00),
+                         _mm512_clmulepi64_epi128(acc[n], kfold, 0x11),
+                         d, 0x96);
+        }
+    }
+
+    for (unsigned n = 0; n < 4; n++) {
+        __m512i t = _mm512_xor_si512(
+                        _mm512_clmulepi64_epi128(acc[n], klast, 0x00),
+                        _mm512_clmulepi64_epi128(acc[n], klast, 0x11));
+        alignas(64) uint64_t q[8];
+        _mm512_store_si512((void *)q, _mm512_mask_blend_epi64(0xc0, t, acc[n]));
+        uint64_t crc = _mm_crc32_u64(0, q[0] ^ q[2] ^ q[4] ^ q[6]);
+        crc = _mm_crc32_u64(crc, q[1] ^ q[3] ^ q[5] ^ q[7]);
+        crcs[n] = ~(uint32_t)crc;
+    }
+}
+
 /* Check for SSE 4.2.  SSE 4.2 was first supported in Nehalem processors
    introduced in November, 2008.  This does not check for the existence of the
    cpuid instruction itself, which was introduced on the 486SL in 1992, so this
@@ -265,11 +367,58 @@ static uint32_t crc32c_hw(uint32_t crc, void const *buf, size_t len) {
 
 /* Compute a CRC-32C.  If the crc32 instruction is available, use the hardware
    version.  Otherwise, use the software version. */
+static int crc32c_have_sse42(void) {
+    int have;
+
+    SSE42(have);
+    return have;
+}
+
+/* The check is done once as cpuid is slow, particularly in a virtual machine. */
+static int crc32c_sse42(void) {
+    static int const sse42 = crc32c_have_sse42();
+    return sse42;
+}
+
 uint32_t crc32c(uint32_t crc, void const *buf, size_t len) {
-    int sse42;
-    
-    SSE42(sse42);
-    return sse42 ? crc32c_hw(crc, buf, len) : crc32c_sw(crc, buf, len);
+    return crc32c_sse42() ? crc32c_hw(crc, buf, len)
+                          : crc32c_sw(crc, buf, len);
+}
+
+/* Compute the CRC-32C of each page, using the widest multi-page kernel this
+   processor supports for as many whole pages as possible. */
+void crc32c_pages(void const *buf, size_t len, size_t pgsz, uint32_t *crcs) {
+    static bool const fold = (__builtin_cpu_init(),
+                              __builtin_cpu_supports("avx512f") &&
+                              __builtin_cpu_supports("vpclmulqdq") &&
+                              __builtin_cpu_supports("sse4.2"));
+    unsigned char const *next = (unsigned char const *)buf;
+
+    if (pgsz == 0)
+        return;
+    if (fold && pgsz % 64 == 0) {
+        pthread_once(&crc32c_once_fold, crc32c_init_fold);
+        while (len >= 4*pgsz) {
+            crc32c_fold_pages4(next, pgsz, crcs);
+            next += 4*pgsz;
+            len -= 4*pgsz;
+            crcs += 4;
+        }
+    }
+    if (crc32c_sse42() && pgsz % 8 == 0) {
+        while (len >= 3*pgsz) {
+            crc32c_hw_pages3(next, pgsz, crcs);
+            next += 3*pgsz;
+            len -= 3*pgsz;
+            crcs += 3;
+        }
+    }
+    while (len) {
+        size_t const n = len < pgsz ? len : pgsz;
+        *crcs++ = crc32c(0, next, n);
+        next += n;
+        len -= n;
+    }
 }
 
 #else /* !__x86_64__ */
@@ -278,6 +427,19 @@ uint32_t crc32c(uint32_t crc, void const *buf, size_t len) {
     return crc32c_sw(crc, buf, len);
 }
 
+void crc32c_pages(void const *buf, size_t len, size_t pgsz, uint32_t *crcs) {
+    unsigned char const *next = (unsigned char const *)buf;
+
+    if (pgsz == 0)
+        return;
+    while (len) {
+        size_t const n = len < pgsz ? len : pgsz;
+        *crcs++ = crc32c_sw(0, next, n);
+        next += n;
+        len -= n;
+    }
+}
+
 #endif
 
 /* Construct table for software CRC-32C little-endian calculation. */
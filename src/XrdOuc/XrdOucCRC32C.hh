@@ -16,4 +16,10 @@ uint32_t crc32c(uint32_t crc, void const *buf, size_t len);
 // crc32c_sw() is the same, but does not use the hardware instruction, even if
 // available.
 uint32_t crc32c_sw(uint32_t crc, void const *buf, size_t len);
+
+// crc32c_pages() computes the CRC-32C of each pgsz sized page in buf[0..len-1]
+// and stores it in crcs[], which must hold (len+pgsz-1)/pgsz entries.  The last
+// page may be short.  Several pages are checksummed concurrently when the
+// processor allows it, which is much faster than calling crc32c() per page.
+void crc32c_pages(void const *buf, size_t len, size_t pgsz, uint32_t *crcs);
 #endif
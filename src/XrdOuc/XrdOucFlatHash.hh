@@ -0,0 +1,230 @@
+#ifndef __OUC_FLATHASH__
+#define __OUC_FLATHASH__
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d O u c F l a t H a s h . h h                      */
+/*                                                                            */
+/*                    (c) 2026 by the XRootD Collaboration                    */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <sys/types.h>
+
+#include "XrdOuc/XrdOucHash.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                        X r d O u c F l a t H a s h                         */
+/******************************************************************************/
+
+// XrdOucFlatHash is an open addressing replacement for XrdOucHash meant for
+// tables that are looked up far more often than they are changed (e.g. the
+// authorization id tables). It keeps the XrdOucHash interface and options
+// (see XrdOucHash.hh) so that converting a table is a matter of changing its
+// type. The differences are in the layout:
+//
+// 1) Entries live in a single slot array; there is no per-entry allocation
+//    and no chain to follow. Each slot has a one byte control tag holding
+//    seven bits of the key's hash and the tags are probed sixteen at a time
+//    (with SSE2 when available) so most misses never touch a key.
+// 2) The full 64-bit hash is kept in the slot and compared before the key.
+// 3) Keys shorter than sizeof(Slot::inl) are copied into the slot itself
+//    instead of being strdup'd (except when the data is the key).
+// 4) The hash may be computed once with HashKey() and passed to the Find(),
+//    Add() and Del() variants that accept it, avoiding rehashing the same
+//    key when it is looked up in several tables.
+//
+// The table is not thread safe; see XrdOucFlatHashRM below for a variant
+// that allows concurrent lookups.
+
+template<class T>
+class XrdOucFlatHash
+{
+public:
+
+// Add() adds a new item to the hash. Semantics are identical to XrdOucHash.
+//
+T           *Add(const char *KeyVal, T *KeyData, const int LifeTime=0,
+                 XrdOucHash_Options opt=Hash_default)
+                {return Add(KeyVal, HashKey(KeyVal), KeyData, LifeTime, opt);}
+
+T           *Add(const char *KeyVal, unsigned long long KeyHash, T *KeyData,
+                 const int LifeTime=0, XrdOucHash_Options opt=Hash_default);
+
+// Apply() applies the specified function to every item in the hash. The
+//         return value of the function is treated as in XrdOucHash.
+//
+T           *Apply(int (*func)(const char *, T *, void *), void *Arg);
+
+// Del() deletes the item from the hash returning 0 or -ENOENT.
+//
+int          Del(const char *KeyVal, XrdOucHash_Options opt = Hash_default)
+                {return Del(KeyVal, HashKey(KeyVal), opt);}
+
+int          Del(const char *KeyVal, unsigned long long KeyHash,
+                 XrdOucHash_Options opt = Hash_default);
+
+// Find() looks up an entry removing it if it has expired.
+//
+T           *Find(const char *KeyVal, time_t *KeyTime=0)
+                 {return Find(KeyVal, HashKey(KeyVal), KeyTime);}
+
+T           *Find(const char *KeyVal, unsigned long long KeyHash,
+                  time_t *KeyTime=0);
+
+// HashKey() returns the hash value used for a key. Pass klen if known.
+//
+static
+unsigned long long HashKey(const char *KeyVal, int klen=-1);
+
+// Look() is Find() without side effects; an expired entry is simply not
+//        found. It may be used concurrently by any number of threads as
+//        long as no thread is changing the table.
+//
+T           *Look(const char *KeyVal, unsigned long long KeyHash,
+                  time_t *KeyTime=0) const;
+
+// Num() returns the number of items in the hash table
+//
+int          Num() {return hashnum;}
+
+// Purge() deletes all of the entries in the table.
+//
+void         Purge();
+
+// Rep() is simply Add() that allows replacement.
+//
+T           *Rep(const char *KeyVal, T *KeyData, const int LifeTime=0,
+                 XrdOucHash_Options opt=Hash_default)
+                {return Add(KeyVal, KeyData, LifeTime,
+                            (XrdOucHash_Options)(opt | Hash_replace));}
+
+// The initial size is rounded up to a power of two number of slots that can
+// hold that many entries. The table doubles whenever it is 7/8 full.
+//
+             XrdOucFlatHash(int size=64);
+            ~XrdOucFlatHash();
+
+private:
+
+static const int  GroupSize = 16;
+static const signed char ctlEmpty = -128;
+static const signed char ctlGone  = -2;
+
+struct Slot
+      {unsigned long long hash;
+       const char        *key;
+       T                 *data;
+       time_t             time;
+       int                count;
+       int                opts;
+       char               inl[24];   // Inlined short key
+      };
+
+void         Clear(Slot &s);
+void         Expand(int newcap);
+int          Locate(const char *KeyVal, unsigned long long KeyHash) const;
+int          NewSlot(unsigned long long KeyHash) const;
+void         Remove(int ent);
+
+signed char *ctltab;
+Slot        *slottab;
+int          hashcap;     // Number of slots (a power of 2)
+int          hashnum;     // Number of live entries
+int          hashgone;    // Number of deleted (tombstone) slots
+int          hashmax;     // Occupied slot count that triggers expansion
+};
+
+/******************************************************************************/
+/*                      X r d O u c F l a t H a s h R M                       */
+/******************************************************************************/
+
+// XrdOucFlatHashRM is a read-mostly variant of XrdOucFlatHash. Any number of
+// threads may call Find() at the same time; they only exclude threads that
+// are changing the table. Lookups never expire entries (use Apply() or Del()
+// for that), so they never need the write lock.
+
+template<class T>
+class XrdOucFlatHashRM
+{
+public:
+
+T           *Add(const char *KeyVal, T *KeyData, const int LifeTime=0,
+                 XrdOucHash_Options opt=Hash_default)
+                {XrdSysRWLockHelper wLock(&hashLock, false);
+                 return hashTab.Add(KeyVal, KeyData, LifeTime, opt);
+                }
+
+T           *Apply(int (*func)(const char *, T *, void *), void *Arg)
+                  {XrdSysRWLockHelper wLock(&hashLock, false);
+                   return hashTab.Apply(func, Arg);
+                  }
+
+int          Del(const char *KeyVal, XrdOucHash_Options opt = Hash_default)
+                {XrdSysRWLockHelper wLock(&hashLock, false);
+                 return hashTab.Del(KeyVal, opt);
+                }
+
+T           *Find(const char *KeyVal, time_t *KeyTime=0)
+                 {unsigned long long khash = hashTab.HashKey(KeyVal);
+                  XrdSysRWLockHelper rLock(&hashLock);
+                  return hashTab.Look(KeyVal, khash, KeyTime);
+                 }
+
+T           *Find(const char *KeyVal, unsigned long long KeyHash,
+                  time_t *KeyTime=0)
+                 {XrdSysRWLockHelper rLock(&hashLock);
+                  return hashTab.Look(KeyVal, KeyHash, KeyTime);
+                 }
+
+int          Num() {XrdSysRWLockHelper rLock(&hashLock);
+                    return hashTab.Num();
+                   }
+
+void         Purge() {XrdSysRWLockHelper wLock(&hashLock, false);
+                      hashTab.Purge();
+                     }
+
+T           *Rep(const char *KeyVal, T *KeyData, const int LifeTime=0,
+                 XrdOucHash_Options opt=Hash_default)
+                {XrdSysRWLockHelper wLock(&hashLock, false);
+                 return hashTab.Rep(KeyVal, KeyData, LifeTime, opt);
+                }
+
+             XrdOucFlatHashRM(int size=64) : hashTab(size) {}
+            ~XrdOucFlatHashRM() {}
+
+private:
+
+XrdSysRWLock      hashLock;
+XrdOucFlatHash<T> hashTab;
+};
+
+/******************************************************************************/
+/*                 A c t u a l   I m p l e m e n t a t i o n                  */
+/******************************************************************************/
+
+#include "XrdOuc/XrdOucFlatHash.icc"
+#endif
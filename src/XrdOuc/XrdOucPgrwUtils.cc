@@ -80,10 +80,10 @@ void XrdOucPgrwUtils::csCalc(const char* data, off_t offs, size_t count,
    int pgOff = offs & pgPageMask;
    int n = XrdOucPgrwUtils::csNum(offs, count);
 
-// Size the vector to be of correct size
+// Size the vector to be of correct size. Every element is about to be set so
+// there is no need to clear it first.
 //
    csvec.resize(n);
-   csvec.assign(n, 0);
    uint32_t *csval = csvec.data();
 
 // If this is unaligned, the we must compute the checksum of the leading bytes
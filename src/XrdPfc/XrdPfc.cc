@@ -46,6 +46,8 @@
 #include "XrdPfcIOFile.hh"
 #include "XrdPfcIOFileBlock.hh"
 #include "XrdPfcResourceMonitor.hh"
+#include "XrdPfcRamTier.hh"
+#include "XrdPfcSlabAllocator.hh"
 
 extern XrdSysXAttr *XrdSysXAttrActive;
 
@@ -172,7 +174,8 @@ Cache::Cache(XrdSysLogger *logger, XrdOucEnv *env) :
    m_prefetch_enabled(false),
    m_RAM_used(0),
    m_RAM_write_queue(0),
-   m_RAM_std_size(0),
+   m_RAM_allocator(0),
+   m_ram_tier(0),
    m_isClient(false),
    m_active_cond(0)
 {
@@ -338,60 +341,108 @@ long long Cache::WritesSinceLastCall()
 
 char* Cache::RequestRAM(long long size)
 {
-   static const size_t s_block_align = sysconf(_SC_PAGESIZE);
+   if ((m_RAM_used += size) > m_configuration.m_RamAbsAvailable)
+   {
+      m_RAM_used -= size;
+      return 0;
+   }
+
+   char *buf = m_RAM_allocator->Allocate(size);
+   if ( ! buf)
+   {
+      // Report out of mem? Probably should report it at least the first time,
+      // then periodically.
+      m_RAM_used -= size;
+   }
+   return buf;
+}
 
-   bool  std_size = (size == m_configuration.m_bufferSize);
+void Cache::ReleaseRAM(char* buf, long long size)
+{
+   m_RAM_allocator->Release(buf, size);
+   m_RAM_used -= size;
+}
 
-   m_RAM_mutex.Lock();
+void Cache::ReportRAMUsage(bool to_gstream)
+{
+   m_RAM_allocator->Trim();
 
-   long long total = m_RAM_used + size;
+   SlabAllocator::Usage u;
+   m_RAM_allocator->GetUsage(u);
 
-   if (total <= m_configuration.m_RamAbsAvailable)
+   long long write_queue;
    {
-      m_RAM_used = total;
-      if (std_size && m_RAM_std_size > 0)
-      {
-         char *buf = m_RAM_std_blocks.back();
-         m_RAM_std_blocks.pop_back();
-         --m_RAM_std_size;
+      XrdSysMutexHelper lock(&m_RAM_mutex);
+      write_queue = m_RAM_write_queue;
+   }
 
-         m_RAM_mutex.UnLock();
+   Statistics.Lock();
+   Statistics.X.MemUsed   = u.m_in_use;
+   Statistics.X.MemWriteQ = write_queue;
+   Statistics.UnLock();
 
-         return buf;
+   TRACE(Debug, "RAM usage: requested " << u.m_requested << ", in use " << u.m_in_use
+         << ", mapped " << u.m_mapped << ", mapped hwm " << u.m_mapped_hwm
+         << ", fragmentation int " << u.InternalFragmentation() << " ext " << u.ExternalFragmentation());
+
+   if (to_gstream && m_gstream)
+   {
+      char buf[1024];
+      int  len = snprintf(buf, 1024, "{\"event\":\"ram_usage\","
+                          "\"ram_limit\":%lld,\"requested\":%lld,\"in_use\":%lld,\"mapped\":%lld,\"write_q\":%lld,"
+                          "\"requested_hwm\":%lld,\"in_use_hwm\":%lld,\"mapped_hwm\":%lld,"
+                          "\"n_slabs_mapped\":%lld,\"n_slabs_unmapped\":%lld,\"n_numa_nodes\":%d,"
+                          "\"int_frag\":%.4f,\"ext_frag\":%.4f}",
+                          m_configuration.m_RamAbsAvailable, u.m_requested, u.m_in_use, u.m_mapped, write_queue,
+                          u.m_requested_hwm, u.m_in_use_hwm, u.m_mapped_hwm,
+                          u.m_n_slabs_mapped, u.m_n_slabs_unmapped, u.m_n_numa_nodes,
+                          u.InternalFragmentation(), u.ExternalFragmentation()
+      );
+      bool suc = false;
+      if (len < 1024)
+      {
+         suc = m_gstream->Insert(buf, len + 1);
       }
-      else
+      if ( ! suc)
       {
-         m_RAM_mutex.UnLock();
-         char *buf;
-         if (posix_memalign((void**) &buf, s_block_align, (size_t) size))
-         {
-            // Report out of mem? Probably should report it at least the first time,
-            // then periodically.
-            return 0;
-         }
-         return buf;
+         TRACE(Error, "Failed g-stream insertion of ram_usage record, len=" << len);
       }
    }
-   m_RAM_mutex.UnLock();
-   return 0;
+
+   if (m_ram_tier)
+      ReportRAMTierUsage(to_gstream);
 }
 
-void Cache::ReleaseRAM(char* buf, long long size)
+void Cache::ReportRAMTierUsage(bool to_gstream)
 {
-   bool std_size = (size == m_configuration.m_bufferSize);
-   {
-      XrdSysMutexHelper lock(&m_RAM_mutex);
+   RamTier::Usage u;
+   m_ram_tier->GetUsage(u);
 
-      m_RAM_used -= size;
+   TRACE(Debug, "RAM tier: " << u.m_n_blocks << " blocks, " << u.m_bytes << " bytes, hits " << u.m_hits
+         << " misses " << u.m_misses << " ratio " << u.HitRatio() << ", admitted " << u.m_admitted
+         << " rejected " << u.m_rejected << " evicted " << u.m_evicted);
 
-      if (std_size && m_RAM_std_size < m_configuration.m_RamKeepStdBlocks)
+   if (to_gstream && m_gstream)
+   {
+      char buf[1024];
+      int  len = snprintf(buf, 1024, "{\"event\":\"ram_tier\","
+                          "\"size\":%lld,\"bytes\":%lld,\"n_blocks\":%lld,"
+                          "\"hits\":%lld,\"misses\":%lld,\"hit_ratio\":%.4f,\"bytes_hit\":%lld,"
+                          "\"admitted\":%lld,\"rejected\":%lld,\"evicted\":%lld}",
+                          m_configuration.m_RamTierSize, u.m_bytes, u.m_n_blocks,
+                          u.m_hits, u.m_misses, u.HitRatio(), u.m_bytes_hit,
+                          u.m_admitted, u.m_rejected, u.m_evicted
+      );
+      bool suc = false;
+      if (len < 1024)
       {
-         m_RAM_std_blocks.push_back(buf);
-         ++m_RAM_std_size;
-         return;
+         suc = m_gstream->Insert(buf, len + 1);
+      }
+      if ( ! suc)
+      {
+         TRACE(Error, "Failed g-stream insertion of ram_tier record, len=" << len);
       }
    }
-   free(buf);
 }
 
 File* Cache::GetFile(const std::string& path, IO* io, long long off, long long filesize)
@@ -660,13 +711,18 @@ void Cache::dec_ref_cnt(File* f, bool high_debug)
                               "\"lfn\":\"%s\",\"size\":%lld,\"blk_size\":%d,\"n_blks\":%d,\"n_blks_done\":%d,"
                               "\"access_cnt\":%lu,\"attach_t\":%lld,\"detach_t\":%lld,\"remotes\":%s,"
                               "\"b_hit\":%lld,\"b_miss\":%lld,\"b_bypass\":%lld,"
-                              "\"b_todisk\":%lld,\"b_prefetch\":%lld,\"n_cks_errs\":%d}",
+                              "\"b_todisk\":%lld,\"b_prefetch\":%lld,\"n_cks_errs\":%d,"
+                              "\"pf_engine\":\"%s\",\"pf_pattern\":\"%s\","
+                              "\"pf_issued\":%d,\"pf_used\":%d,\"pf_wasted\":%d}",
                               f->GetLocalPath().c_str(), f->GetFileSize(), f->GetBlockSize(),
                               f->GetNBlocks(), f->GetNDownloadedBlocks(),
                               (unsigned long) f->GetAccessCnt(), (long long) as->AttachTime, (long long) as->DetachTime,
                               f->GetRemoteLocations().c_str(),
                               as->BytesHit, as->BytesMissed, as->BytesBypassed,
-                              st.m_BytesWritten, f->GetPrefetchedBytes(), st.m_NCksumErrors
+                              st.m_BytesWritten, f->GetPrefetchedBytes(), st.m_NCksumErrors,
+                              f->GetPrefetchEngineName(), f->GetPrefetchPatternName(),
+                              f->GetPrefetchIssuedCnt(), f->GetPrefetchUsedCnt(),
+                              f->GetPrefetchIssuedCnt() - f->GetPrefetchUsedCnt()
          );
          bool suc = false;
          if (len < 4096)
@@ -764,9 +820,7 @@ void Cache::Prefetch()
 
    while (true)
    {
-      m_RAM_mutex.Lock();
       bool doPrefetch = (m_RAM_used < limit_RAM);
-      m_RAM_mutex.UnLock();
 
       if (doPrefetch)
       {
@@ -44,7 +44,9 @@ namespace XrdPfc
 class File;
 class IO;
 class PurgePin;
+class RamTier;
 class ResourceMonitor;
+class SlabAllocator;
 
 
 template<class MOO>
@@ -110,9 +112,14 @@ struct Configuration
    long long m_bufferSize;              //!< cache block size, default 128 kB
    long long m_RamAbsAvailable;         //!< available from configuration
    int       m_RamKeepStdBlocks;        //!< number of standard-sized blocks kept after release
+   bool      m_RamHugePages;            //!< back RAM block slabs with transparent huge pages
+   bool      m_RamNuma;                 //!< keep RAM block slabs per NUMA node
+   long long m_RamTierSize = 0;         //!< size of RAM tier for hot blocks, 0 to disable
+   bool      m_RamTierTinyLFU = true;   //!< frequency based admission into the RAM tier
    int       m_wqueue_blocks;           //!< maximum number of blocks written per write-queue loop
    int       m_wqueue_threads;          //!< number of threads writing blocks to disk
    int       m_prefetch_max_blocks;     //!< default maximum number of blocks to prefetch per file
+   std::string m_prefetch_engine = "linear"; //!< prefetch engine, linear or adaptive
 
    long long m_cgi_min_bufferSize = 0;          //!< min buffer size allowed in pfc.blocksize
    long long m_cgi_max_bufferSize = 0;          //!< max buffer size allowed in pfc.blocksize
@@ -280,6 +287,17 @@ public:
    char* RequestRAM(long long size);
    void  ReleaseRAM(char* buf, long long size);
 
+   //---------------------------------------------------------------------
+   //! Trim RAM block caches and report usage to cache statistics and, if
+   //! configured, the g-stream. Called periodically from the ResourceMonitor.
+   //---------------------------------------------------------------------
+   void ReportRAMUsage(bool to_gstream);
+
+   //---------------------------------------------------------------------
+   //! Report RAM tier occupancy and hit ratio; called from ReportRAMUsage().
+   //---------------------------------------------------------------------
+   void ReportRAMTierUsage(bool to_gstream);
+
    void RegisterPrefetchFile(File*);
    void DeRegisterPrefetchFile(File*);
 
@@ -289,6 +307,9 @@ public:
 
    XrdOss* GetOss() const { return m_oss; }
 
+   //! RAM tier holding hot blocks that are on disk, or 0 if not configured.
+   RamTier* GetRamTier() const { return m_ram_tier; }
+
    bool IsFileActiveOrPurgeProtected(const std::string&) const;
    void ClearPurgeProtectedSet();
    PurgePin* GetPurgePin() const { return m_purge_pin; }
@@ -348,11 +369,11 @@ private:
    XrdSysCondVar m_prefetch_condVar;        //!< lock for vector of prefetching files
    bool          m_prefetch_enabled;        //!< set to true when prefetching is enabled
 
-   XrdSysMutex m_RAM_mutex;                 //!< lock for allcoation of RAM blocks
-   long long   m_RAM_used;
-   long long   m_RAM_write_queue;
-   std::list<char*> m_RAM_std_blocks;       //!< A list of blocks of standard size, to be reused.
-   int              m_RAM_std_size;
+   XrdSysMutex    m_RAM_mutex;              //!< lock for RAM write queue accounting
+   RAtomic_llong  m_RAM_used;
+   long long      m_RAM_write_queue;
+   SlabAllocator *m_RAM_allocator;          //!< allocator of RAM blocks
+   RamTier       *m_ram_tier;               //!< optional RAM tier for hot on-disk blocks
 
    bool        m_isClient;                  //!< True if running as client
    bool        m_dataXattr = false;         //!< True if xattrs are available on the data space
@@ -3,7 +3,10 @@
 #include "XrdPfcInfo.hh"
 
 #include "XrdPfcResourceMonitor.hh"
+#include "XrdPfcPrefetch.hh"
 #include "XrdPfcPurgePin.hh"
+#include "XrdPfcRamTier.hh"
+#include "XrdPfcSlabAllocator.hh"
 
 #include "XrdOss/XrdOss.hh"
 
@@ -51,6 +54,8 @@ Configuration::Configuration() :
    m_bufferSize(128*1024),
    m_RamAbsAvailable(0),
    m_RamKeepStdBlocks(0),
+   m_RamHugePages(true),
+   m_RamNuma(false),
    m_wqueue_blocks(16),
    m_wqueue_threads(4),
    m_prefetch_max_blocks(10),
@@ -652,6 +657,24 @@ bool Cache::Config(const char *config_filename, const char *parameters, XrdOucEn
    // Setup number of standard-size blocks not released back to the system to 5% of total RAM.
    m_configuration.m_RamKeepStdBlocks = (m_configuration.m_RamAbsAvailable / m_configuration.m_bufferSize + 1) * 5 / 100;
 
+   // RAM blocks are carved out of slabs; the same 5% is kept mapped after release.
+   {
+      SlabAllocator::Config acfg;
+      acfg.m_hugepages  = m_configuration.m_RamHugePages;
+      acfg.m_numa       = m_configuration.m_RamNuma;
+      acfg.m_keep_bytes = m_configuration.m_RamKeepStdBlocks * m_configuration.m_bufferSize;
+      m_RAM_allocator = new SlabAllocator(acfg);
+   }
+
+   // Hot blocks that are on disk can additionally be kept in RAM.
+   if (m_configuration.m_RamTierSize > 0)
+   {
+      RamTier::Config tcfg;
+      tcfg.m_max_bytes = m_configuration.m_RamTierSize;
+      tcfg.m_tinylfu   = m_configuration.m_RamTierTinyLFU;
+      m_ram_tier = new RamTier(tcfg, m_RAM_allocator);
+   }
+
    // Set tracing to debug if this is set in environment
    char* cenv = getenv("XRDDEBUG");
    if (cenv && ! strcmp(cenv,"1") && m_trace->What < 4) m_trace->What = 4;
@@ -686,9 +709,9 @@ bool Cache::Config(const char *config_filename, const char *parameters, XrdOucEn
       loff = snprintf(buff, sizeof(buff), "Config effective %s pfc configuration:\n"
                       "       pfc.cschk %s uvkeep %s\n"
                       "       pfc.blocksize %lldk\n"
-                      "       pfc.prefetch %d\n"
+                      "       pfc.prefetch %d engine %s\n"
                       "       pfc.urlcgi blocksize %s prefetch %s\n"
-                      "       pfc.ram %.fg\n"
+                      "       pfc.ram %.fg%s%s\n"
                       "       pfc.writequeue %d %d\n"
                       "       # Total available disk: %lld\n"
                       "       pfc.diskusage %lld %lld files %lld %lld %lld purgeinterval %d purgecoldfiles %d\n"
@@ -701,9 +724,11 @@ bool Cache::Config(const char *config_filename, const char *parameters, XrdOucEn
                       config_filename,
                       csc[int(m_configuration.m_cs_Chk)], uvk,
                       m_configuration.m_bufferSize >> 10,
-                      m_configuration.m_prefetch_max_blocks,
+                      m_configuration.m_prefetch_max_blocks, m_configuration.m_prefetch_engine.c_str(),
                       urlcgi_blks, urlcgi_npref,
                       ram_gb,
+                      m_configuration.m_RamHugePages ? "" : " nohugepages",
+                      m_configuration.m_RamNuma ? " numa" : "",
                       m_configuration.m_wqueue_blocks, m_configuration.m_wqueue_threads,
                       sP.Total,
                       m_configuration.m_diskUsageLWM, m_configuration.m_diskUsageHWM,
@@ -731,6 +756,12 @@ bool Cache::Config(const char *config_filename, const char *parameters, XrdOucEn
             loff += snprintf(buff + loff, sizeof(buff) - loff, "               %s/*\n", i->c_str());
       }
 
+      if (m_configuration.m_RamTierSize > 0)
+      {
+         loff += snprintf(buff + loff, sizeof(buff) - loff, "       pfc.ramtier %lldm admit %s\n",
+                          m_configuration.m_RamTierSize >> 20, m_configuration.m_RamTierTinyLFU ? "tinylfu" : "all");
+      }
+
       if (m_configuration.m_hdfsmode)
       {
          loff += snprintf(buff + loff, sizeof(buff) - loff, "       pfc.hdfsmode hdfsbsize %lld\n", m_configuration.m_hdfsbsize);
@@ -1005,6 +1036,27 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
       if ( ! prefetch_str2value("Config", cwg.GetWord(), CFG.m_prefetch_max_blocks,
                                 0, CFG.s_max_prefetch_max_blocks))
          return false;
+
+      //  pfc.prefetch n [engine {linear | adaptive}]
+      const char *p = 0;
+      while ((p = cwg.GetWord()) && cwg.HasLast())
+      {
+         if (strcmp(p, "engine") == 0)
+         {
+            std::string engine = cwg.GetWord();
+            if ( ! PrefetchEngine::IsKnown(engine))
+            {
+               m_log.Emsg("Config", "Error: unknown pfc.prefetch engine '", engine.c_str(), "'");
+               return false;
+            }
+            CFG.m_prefetch_engine = engine;
+         }
+         else
+         {
+            m_log.Emsg("Config", "Error: pfc.prefetch stanza contains unknown directive '", p, "'");
+            return false;
+         }
+      }
    }
    else if ( part == "urlcgi" )
    {
@@ -1076,6 +1128,54 @@ bool Cache::ConfigParameters(std::string part, XrdOucStream& config, TmpConfigur
       {
          return false;
       }
+      //  pfc.ram size [nohugepages] [numa]
+      const char *p = 0;
+      while ((p = cwg.GetWord()) && cwg.HasLast())
+      {
+         if (strcmp(p, "nohugepages") == 0)
+         {
+            m_configuration.m_RamHugePages = false;
+         }
+         else if (strcmp(p, "numa") == 0)
+         {
+            m_configuration.m_RamNuma = true;
+         }
+         else
+         {
+            m_log.Emsg("Config", "Error: pfc.ram stanza contains unknown directive '", p, "'");
+            return false;
+         }
+      }
+   }
+   else if ( part == "ramtier" )
+   {
+      //  pfc.ramtier size [admit tinylfu|all]
+      if ( XrdOuca2x::a2sz(m_log, "get RAM tier size", cwg.GetWord(), &m_configuration.m_RamTierSize, 0, 1024ll * 1024 * 1024 * 1024))
+      {
+         return false;
+      }
+      const char *p = 0;
+      while ((p = cwg.GetWord()) && cwg.HasLast())
+      {
+         if (strcmp(p, "admit") == 0)
+         {
+            p = cwg.GetWord();
+            if (p && strcmp(p, "tinylfu") == 0)
+               m_configuration.m_RamTierTinyLFU = true;
+            else if (p && strcmp(p, "all") == 0)
+               m_configuration.m_RamTierTinyLFU = false;
+            else
+            {
+               m_log.Emsg("Config", "Error: pfc.ramtier admit should be tinylfu or all");
+               return false;
+            }
+         }
+         else
+         {
+            m_log.Emsg("Config", "Error: pfc.ramtier stanza contains unknown directive '", p, "'");
+            return false;
+         }
+      }
    }
    else if ( part == "writequeue")
    {
@@ -21,6 +21,8 @@
 #include "XrdPfc.hh"
 #include "XrdPfcResourceMonitor.hh"
 #include "XrdPfcIO.hh"
+#include "XrdPfcPrefetch.hh"
+#include "XrdPfcRamTier.hh"
 #include "XrdPfcTrace.hh"
 
 #include "XProtocol/XProtocol.hh"
@@ -73,7 +75,16 @@ File::File(const std::string& path, long long iOffset, long long iFileSize) :
    m_block_size(0),
    m_num_blocks(0),
    m_resmon_token(-1),
+   m_lf_bytes_hit(0),
+   m_lf_bytes_hit_ram(0),
+   m_lf_prefetch_hit_cnt(0),
+   m_ram_tier_id(RamTier::NewFileId()),
    m_prefetch_state(kOff),
+   m_prefetch_engine(0),
+   m_prefetch_idle(false),
+   m_prefetch_pattern(0),
+   m_remote_latency_us(0),
+   m_prefetch_used_cnt(0),
    m_prefetch_bytes(0),
    m_prefetch_read_cnt(0),
    m_prefetch_hit_cnt(0),
@@ -83,6 +94,9 @@ File::File(const std::string& path, long long iOffset, long long iFileSize) :
 File::~File()
 {
    TRACEF(Debug, "~File() for ");
+   delete m_prefetch_engine;
+   if (RamTier *rt = cache()->GetRamTier())
+      rt->Drop(m_ram_tier_id);
 }
 
 void File::Close()
@@ -135,7 +149,10 @@ void File::Close()
       Cache::ResMon().register_file_close(m_resmon_token, time(0), m_stats);
    }
 
-   TRACEF(Debug, "Close() finished, prefetch score = " <<  m_prefetch_score);
+   TRACEF(Debug, "Close() finished, prefetch score = " <<  m_prefetch_score <<
+          ", engine " << GetPrefetchEngineName() << ", pattern " << GetPrefetchPatternName() <<
+          ", issued " << m_prefetch_read_cnt << ", used " << m_prefetch_used_cnt <<
+          ", wasted " << m_prefetch_read_cnt - m_prefetch_used_cnt);
 }
 
 //------------------------------------------------------------------------------
@@ -187,13 +204,24 @@ void File::check_delta_stats()
 {
    // Called under m_state_cond lock.
    // BytesWritten indirectly trigger an unconditional merge through periodic Sync().
+   merge_lock_free_stats();
    if (m_delta_stats.BytesReadAndWritten() >= m_resmon_report_threshold && ! m_in_shutdown)
       report_and_merge_delta_stats();
 }
 
+void File::merge_lock_free_stats()
+{
+   // Called under m_state_cond lock.
+   long long bytes_hit = m_lf_bytes_hit.exchange(0);
+   if (bytes_hit)
+      m_delta_stats.AddBytesHit(bytes_hit, m_lf_bytes_hit_ram.exchange(0));
+   inc_prefetch_hit_cnt(m_lf_prefetch_hit_cnt.exchange(0));
+}
+
 void File::report_and_merge_delta_stats()
 {
    // Called under m_state_cond lock.
+   merge_lock_free_stats();
    struct stat s;
    m_data_file->Fstat(&s);
    // Do not report st_blocks beyond 4kB round-up over m_file_size. Some FSs report
@@ -273,7 +301,7 @@ bool File::ioActive(IO *io)
          io->m_in_detach = true;
 
          // Check if any IO is still available for prfetching. If not, stop it.
-         if (m_prefetch_state == kOn || m_prefetch_state == kHold)
+         if (m_prefetch_state == kOn || m_prefetch_state == kHold || m_prefetch_state == kIdle)
          {
             if ( ! select_current_io_or_disable_prefetching(false) )
             {
@@ -593,6 +621,8 @@ bool File::Open(XrdOucCacheIO *inputIO)
    m_num_blocks = m_cfi.GetNBlocks();
    m_prefetch_state = (m_cfi.IsComplete()) ? kComplete : kStopped; // Will engage in AddIO().
    m_prefetch_max_blocks_in_flight = pfc_prefetch;
+   m_prefetch_engine = PrefetchEngine::Create(conf.m_prefetch_engine, m_offset / m_block_size, m_num_blocks);
+   m_prefetch_unused.assign((m_num_blocks + 7) / 8, 0);
    if (pfc_prefetch != conf.m_prefetch_max_blocks)
       TRACEF(Debug, tpfx << "pfc.prefetch set to " << pfc_prefetch << " via CGI parameter");
 
@@ -777,6 +807,8 @@ void File::ProcessBlockRequest(Block *b)
       TRACEF(Dump, "ProcessBlockRequest() " << buf);
    }
 
+   b->m_req_time_us = PrefetchEngine::NowUs();
+
    if (b->req_cksum_net())
    {
       b->get_io()->GetInput()->pgRead(*brh, b->get_buff(), b->get_offset(), b->get_req_size(),
@@ -850,6 +882,14 @@ int File::Read(IO *io, char* iUserBuff, long long iUserOff, int iUserSize, ReadR
 
    TRACEF(Dump, "Read() sid: " << Xrd::hex1 << rh->m_seq_id << " size: " << iUserSize);
 
+   XrdOucIOVec readV( { iUserOff, iUserSize, 0, iUserBuff } );
+   int         ret;
+
+   // Shortcut -- all requested blocks are on disk.
+
+   if (ReadLockFree(io, &readV, 1, ret))
+      return ret;
+
    m_state_cond.Lock();
 
    if (m_in_shutdown || io->m_in_detach)
@@ -858,22 +898,6 @@ int File::Read(IO *io, char* iUserBuff, long long iUserOff, int iUserSize, ReadR
       return m_in_shutdown ? -ENOENT : -EBADF;
    }
 
-   // Shortcut -- file is fully downloaded.
-
-   if (m_cfi.IsComplete())
-   {
-      m_state_cond.UnLock();
-      int ret = m_data_file->Read(iUserBuff, iUserOff, iUserSize);
-      if (ret > 0) {
-         XrdSysCondVarHelper _lck(m_state_cond);
-         m_delta_stats.AddBytesHit(ret);
-         check_delta_stats();
-      }
-      return ret;
-   }
-
-   XrdOucIOVec readV( { iUserOff, iUserSize, 0, iUserBuff } );
-
    return ReadOpusCoalescere(io, &readV, 1, rh, "Read() ");
 }
 
@@ -883,6 +907,13 @@ int File::ReadV(IO *io, const XrdOucIOVec *readV, int readVnum, ReadReqRH *rh)
 {
    TRACEF(Dump, "ReadV() for " << readVnum << " chunks.");
 
+   int ret;
+
+   // Shortcut -- all requested blocks are on disk.
+
+   if (ReadLockFree(io, readV, readVnum, ret))
+      return ret;
+
    m_state_cond.Lock();
 
    if (m_in_shutdown || io->m_in_detach)
@@ -891,21 +922,149 @@ int File::ReadV(IO *io, const XrdOucIOVec *readV, int readVnum, ReadReqRH *rh)
       return m_in_shutdown ? -ENOENT : -EBADF;
    }
 
-   // Shortcut -- file is fully downloaded.
+   return ReadOpusCoalescere(io, readV, readVnum, rh, "ReadV() ");
+}
 
-   if (m_cfi.IsComplete())
+//------------------------------------------------------------------------------
+
+bool File::ReadLockFree(IO *io, const XrdOucIOVec *readV, int readVnum, int &retval)
+{
+   // Serve a request whose blocks are all written to disk without taking
+   // m_state_cond. Written bits are only ever set while the file is active,
+   // and they are set after the block data has been written, so a set bit
+   // means the data on disk can be read. Any block that is not yet on disk
+   // (in RAM, in flight, or missing) makes us return false; the caller then
+   // takes the lock and goes through ReadOpusCoalescere().
+   // Hits are accounted in atomics and merged into m_delta_stats under lock.
+
+   if (m_in_shutdown || io->m_in_detach)
    {
-      m_state_cond.UnLock();
-      int ret = m_data_file->ReadV(const_cast<XrdOucIOVec*>(readV), readVnum);
-      if (ret > 0) {
+      retval = m_in_shutdown ? -ENOENT : -EBADF;
+      return true;
+   }
+
+   int prefetch_cnt = 0;
+
+   if ( ! m_cfi.IsComplete())
+   {
+      for (int iov_idx = 0; iov_idx < readVnum; ++iov_idx)
+      {
+         const int idx_first = readV[iov_idx].offset / m_block_size;
+         const int idx_last  = (readV[iov_idx].offset + readV[iov_idx].size - 1) / m_block_size;
+
+         for (int block_idx = idx_first; block_idx <= idx_last; ++block_idx)
+         {
+            if ( ! m_cfi.TestBitWritten(offsetIdx(block_idx)))
+               return false;
+            // Marking the block used is idempotent, a fall back to the
+            // locked path does not count it twice.
+            if (m_cfi.TestBitPrefetch(offsetIdx(block_idx)))
+            {
+               ++prefetch_cnt;
+               note_prefetch_use(block_idx);
+            }
+         }
+      }
+      record_access(readV, readVnum, false);
+   }
+
+   TRACEF(DumpXL, "ReadLockFree() all blocks on disk, n_chunks = " << readVnum);
+
+   long long bytes_ram = 0;
+
+   if (RamTier *rt = cache()->GetRamTier())
+      retval = ReadThroughRamTier(rt, readV, readVnum, bytes_ram);
+   else if (readVnum == 1)
+      retval = m_data_file->Read(readV[0].data, readV[0].offset, readV[0].size);
+   else
+      retval = m_data_file->ReadV(const_cast<XrdOucIOVec*>(readV), readVnum);
+
+   if (retval > 0)
+   {
+      if (prefetch_cnt)
+         m_lf_prefetch_hit_cnt += prefetch_cnt;
+      if (bytes_ram)
+         m_lf_bytes_hit_ram += bytes_ram;
+      if ((m_lf_bytes_hit += retval) >= m_resmon_report_threshold)
+      {
          XrdSysCondVarHelper _lck(m_state_cond);
-         m_delta_stats.AddBytesHit(ret);
          check_delta_stats();
       }
-      return ret;
    }
+   return true;
+}
 
-   return ReadOpusCoalescere(io, readV, readVnum, rh, "ReadV() ");
+//------------------------------------------------------------------------------
+
+int File::ReadThroughRamTier(RamTier *rt, const XrdOucIOVec *readV, int readVnum, long long &bytes_ram)
+{
+   // Serve blocks that are on disk, taking them from the RAM tier when they
+   // are resident there. A block that is missing from the tier but popular
+   // enough to be admitted is read from disk whole and inserted. Everything
+   // else is read from disk as before, coalesced where contiguous.
+   // Called without lock; all blocks covered by readV are on disk.
+
+   std::vector<XrdOucIOVec> iovec_disk;
+   std::vector<char>        blk_buf;
+   int                      iovec_disk_total = 0;
+   int                      bytes_read = 0;
+
+   for (int iov_idx = 0; iov_idx < readVnum; ++iov_idx)
+   {
+      const XrdOucIOVec &iov = readV[iov_idx];
+
+      const int idx_first = iov.offset / m_block_size;
+      const int idx_last  = (iov.offset + iov.size - 1) / m_block_size;
+
+      for (int block_idx = idx_first; block_idx <= idx_last; ++block_idx)
+      {
+         long long off;     // offset in user buffer
+         long long blk_off; // offset in block
+         int       size;    // size to copy
+
+         overlap(block_idx, m_block_size, iov.offset, iov.size, off, blk_off, size);
+
+         if (rt->Read(m_ram_tier_id, block_idx, blk_off, size, iov.data + off))
+         {
+            bytes_ram  += size;
+            bytes_read += size;
+            continue;
+         }
+
+         const long long blk_pos = block_idx * m_block_size;
+         const int       blk_len = RamTier::BlockLen(block_idx, m_block_size, m_offset, m_file_size);
+
+         if (rt->WantAdmit(m_ram_tier_id, block_idx, blk_len))
+         {
+            blk_buf.resize(m_block_size);
+            if (m_data_file->Read(blk_buf.data(), blk_pos, blk_len) == blk_len)
+            {
+               rt->Insert(m_ram_tier_id, block_idx, blk_buf.data(), blk_len);
+               memcpy(iov.data + off, blk_buf.data() + blk_off, size);
+               bytes_read += size;
+               continue;
+            }
+         }
+
+         if ( ! iovec_disk.empty() &&
+              iovec_disk.back().offset + iovec_disk.back().size == blk_pos + blk_off &&
+              iovec_disk.back().data   + iovec_disk.back().size == iov.data + off)
+            iovec_disk.back().size += size;
+         else
+            iovec_disk.push_back( { blk_pos + blk_off, size, 0, iov.data + off } );
+         iovec_disk_total += size;
+      }
+   }
+
+   if ( ! iovec_disk.empty())
+   {
+      int rc = ReadBlocksFromDisk(iovec_disk, iovec_disk_total);
+      if (rc < 0)
+         return rc;
+      bytes_read += rc;
+   }
+
+   return bytes_read;
 }
 
 //------------------------------------------------------------------------------
@@ -977,7 +1136,10 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
                blks_ready[bi->second].emplace_back( ChunkRequest(nullptr, iUserBuff + off, blk_off, size) );
 
                if (bi->second->m_prefetch)
+               {
                   ++prefetch_cnt;
+                  note_prefetch_use(block_idx);
+               }
             }
             else
             {
@@ -1005,7 +1167,10 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
             iovec_disk_total += size;
 
             if (m_cfi.TestBitPrefetch(offsetIdx(block_idx)))
+            {
                ++prefetch_cnt;
+               note_prefetch_use(block_idx);
+            }
 
             lbe = LB_disk;
          }
@@ -1060,6 +1225,8 @@ int File::ReadOpusCoalescere(IO *io, const XrdOucIOVec *readV, int readVnum,
 
    inc_prefetch_hit_cnt(prefetch_cnt);
 
+   record_access(readV, readVnum, true);
+
    m_state_cond.UnLock();
 
    // First, send out remote requests for new blocks.
@@ -1192,7 +1359,15 @@ void File::WriteBlockToDisk(Block* b)
       return;
    }
 
-   const int blk_idx =  (b->m_offset - m_offset) / m_block_size;
+   const int blk_idx = RamTier::BlockIdx(b->m_offset, m_block_size);
+
+   // Offer the block to the RAM tier while we still hold a reference to it.
+   // Readers only look there once the written bit below is set.
+   if (RamTier *rt = cache()->GetRamTier())
+   {
+      if (rt->WantAdmit(m_ram_tier_id, blk_idx, (int) size))
+         rt->Insert(m_ram_tier_id, blk_idx, b->get_buff(), (int) size);
+   }
 
    // Set written bit.
    TRACEF(Dump, "WriteToDisk() success set bit for block " <<  b->m_offset << " size=" <<  size);
@@ -1201,12 +1376,13 @@ void File::WriteBlockToDisk(Block* b)
    {
       XrdSysCondVarHelper _lck(m_state_cond);
 
-      m_cfi.SetBitWritten(blk_idx);
-
+      // Prefetch bit goes first, ReadLockFree() tests it after the written bit.
       if (b->m_prefetch)
       {
          m_cfi.SetBitPrefetch(blk_idx);
       }
+
+      m_cfi.SetBitWritten(blk_idx);
       if (b->req_cksum_net() && ! b->has_cksums() && m_cfi.IsCkSumNet())
       {
          m_cfi.ResetCkSumNet();
@@ -1459,7 +1635,10 @@ void File::ProcessBlockSuccess(Block *b, ChunkRequest &creq)
    --rreq->m_n_chunk_reqs;
 
    if (b->m_prefetch)
+   {
       inc_prefetch_hit_cnt(1);
+      note_prefetch_use(b->m_offset / m_block_size);
+   }
 
    dec_ref_count(b);
 
@@ -1501,6 +1680,12 @@ void File::ProcessBlockResponse(Block *b, int res)
 
    m_state_cond.Lock();
 
+   if (res > 0)
+   {
+      long long lat = PrefetchEngine::NowUs() - b->m_req_time_us;
+      m_remote_latency_us = m_remote_latency_us ? (7 * m_remote_latency_us + lat) / 8 : lat;
+   }
+
    // Deregister block from IO's prefetch count, if needed.
    if (b->m_prefetch)
    {
@@ -1517,7 +1702,7 @@ void File::ProcessBlockResponse(Block *b, int res)
             io->m_allow_prefetching = false;
 
             // Check if any IO is still available for prfetching. If not, stop it.
-            if (m_prefetch_state == kOn || m_prefetch_state == kHold)
+            if (m_prefetch_state == kOn || m_prefetch_state == kHold || m_prefetch_state == kIdle)
             {
                if ( ! select_current_io_or_disable_prefetching(false) )
                {
@@ -1651,9 +1836,8 @@ int File::offsetIdx(int iIdx) const
 
 void File::Prefetch()
 {
-   // Check that block is not on disk and not in RAM.
-   // TODO: Could prefetch several blocks at once!
-   //       blks_max could be an argument
+   // Ask the prefetch engine which blocks to fetch; it is only offered
+   // blocks that are neither on disk nor in RAM.
 
    BlockList_t blks;
 
@@ -1673,43 +1857,55 @@ void File::Prefetch()
       }
 
       // Select block(s) to fetch.
-      for (int f = 0; f < m_num_blocks; ++f)
+      std::vector<int> predicted;
+      int room = std::max(1, m_prefetch_max_blocks_in_flight - (int) m_block_map.size());
+      m_prefetch_engine->Predict(room, m_remote_latency_us, predicted,
+                                 [this](int idx) { return ! m_cfi.TestBitWritten(offsetIdx(idx)) &&
+                                                          m_block_map.find(idx) == m_block_map.end(); });
+
+      for (int f_act : predicted)
       {
-         if ( ! m_cfi.TestBitWritten(f))
+         Block *b = PrepareBlockRequest(f_act, *m_current_io, nullptr, true);
+         if (b)
          {
-            int f_act = f + m_offset / m_block_size;
+            TRACEF(Dump, "Prefetch take block " << f_act);
+            blks.push_back(b);
+            // Note: block ref_cnt not increased, it will be when placed into write queue.
 
-            BlockMap_i bi = m_block_map.find(f_act);
-            if (bi == m_block_map.end())
-            {
-               Block *b = PrepareBlockRequest(f_act, *m_current_io, nullptr, true);
-               if (b)
-               {
-                  TRACEF(Dump, "Prefetch take block " << f_act);
-                  blks.push_back(b);
-                  // Note: block ref_cnt not increased, it will be when placed into write queue.
-
-                  inc_prefetch_read_cnt(1);
-               }
-               else
-               {
-                  // This shouldn't happen as prefetching stops when RAM is 70% full.
-                  TRACEF(Warning, "Prefetch allocation failed for block " << f_act);
-               }
-               break;
-            }
+            inc_prefetch_read_cnt(1);
+            Info::SetBit(m_prefetch_unused.data(), offsetIdx(f_act));
          }
+         else
+         {
+            // This shouldn't happen as prefetching stops when RAM is 70% full.
+            TRACEF(Warning, "Prefetch allocation failed for block " << f_act);
+            break;
+         }
+         if (m_prefetch_state != kOn)
+            break;
       }
 
       if (blks.empty())
       {
-         TRACEF(Debug, "Prefetch file is complete, stopping prefetch.");
-         m_prefetch_state = kComplete;
+         if (m_prefetch_engine->IsPredictive() && ! m_cfi.IsComplete())
+         {
+            TRACEF(Dump, "Prefetch nothing predicted, waiting for further reads.");
+            m_prefetch_state = kIdle;
+            m_prefetch_idle  = true;
+         }
+         else
+         {
+            TRACEF(Debug, "Prefetch file is complete, stopping prefetch.");
+            m_prefetch_state = kComplete;
+         }
          cache()->DeRegisterPrefetchFile(this);
       }
       else
       {
          (*m_current_io)->m_active_prefetches += (int) blks.size();
+         int pattern = m_prefetch_engine->GetPattern();
+         if (pattern != PrefetchEngine::kNone)
+            m_prefetch_pattern = pattern;
       }
    }
 
@@ -1719,6 +1915,70 @@ void File::Prefetch()
    }
 }
 
+//------------------------------------------------------------------------------
+
+void File::record_access(const XrdOucIOVec *readV, int readVnum, bool locked)
+{
+   // Called with m_state_cond held when locked is true, from ReadLockFree() otherwise.
+   // The lock-free path only queues the accesses so that hits never wait
+   // for the prefetch engine; Prefetch() picks them up.
+
+   long long now    = PrefetchEngine::NowUs();
+   bool      resume = false;
+
+   for (int iov_idx = 0; iov_idx < readVnum; ++iov_idx)
+   {
+      const int idx_first = readV[iov_idx].offset / m_block_size;
+      const int idx_last  = (readV[iov_idx].offset + readV[iov_idx].size - 1) / m_block_size;
+
+      if (locked ? m_prefetch_engine->RecordAccess(idx_first, idx_last, now)
+                 : m_prefetch_engine->QueueAccess (idx_first, idx_last, now))
+         resume = true;
+   }
+
+   if (resume && m_prefetch_idle)
+   {
+      if (locked)
+      {
+         resume_idle_prefetch();
+      }
+      else
+      {
+         XrdSysCondVarHelper _lck(m_state_cond);
+         resume_idle_prefetch();
+      }
+   }
+}
+
+void File::resume_idle_prefetch()
+{
+   // Called under m_state_cond lock.
+   m_prefetch_idle = false;
+   if (m_prefetch_state == kIdle)
+   {
+      m_prefetch_state = kOn;
+      cache()->RegisterPrefetchFile(this);
+   }
+}
+
+void File::note_prefetch_use(int blk_idx)
+{
+   int           i    = offsetIdx(blk_idx);
+   unsigned char mask = 1 << (i % 8);
+   if (__atomic_fetch_and(&m_prefetch_unused[i / 8], (unsigned char) ~mask, __ATOMIC_RELAXED) & mask)
+      ++m_prefetch_used_cnt;
+}
+
+const char* File::GetPrefetchEngineName() const
+{
+   return m_prefetch_engine ? m_prefetch_engine->Name() : "none";
+}
+
+const char* File::GetPrefetchPatternName() const
+{
+   return PrefetchEngine::PatternName((PrefetchEngine::Pattern_e) m_prefetch_pattern);
+}
+
 
 //------------------------------------------------------------------------------
 
@@ -24,12 +24,14 @@
 
 #include "XrdOuc/XrdOucCache.hh"
 #include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdSys/XrdSysRAtomic.hh"
 
 #include <functional>
 #include <list>
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 
 class XrdJob;
 struct XrdOucIOVec;
@@ -40,6 +42,8 @@ class File;
 class BlockResponseHandler;
 class DirectResponseHandler;
 class IO;
+class PrefetchEngine;
+class RamTier;
 
 struct ReadVBlockListRAM;
 struct ReadVChunkListRAM;
@@ -121,6 +125,7 @@ public:
    bool                m_req_cksum_net;
    vCkSum_t            m_cksum_vec;
    int                 m_n_cksum_errors;
+   long long           m_req_time_us {0}; // When the remote request was issued.
 
    vChunkRequest_t     m_chunk_reqs;
 
@@ -278,6 +283,10 @@ public:
    int                GetNBlocks()           const { return m_cfi.GetNBlocks(); }
    int                GetNDownloadedBlocks() const { return m_cfi.GetNDownloadedBlocks(); }
    long long          GetPrefetchedBytes()   const { return m_prefetch_bytes; }
+   int                GetPrefetchIssuedCnt() const { return m_prefetch_read_cnt; }
+   int                GetPrefetchUsedCnt()   const { return m_prefetch_used_cnt; }
+   const char*        GetPrefetchEngineName() const;
+   const char*        GetPrefetchPatternName() const;
    const Stats&       RefStats()             const { return m_stats; }
 
    int Fstat(struct stat &sbuff);
@@ -331,15 +340,15 @@ private:
    int  m_non_flushed_cnt;
    bool m_in_sync;
    bool m_detach_time_logged;
-   bool m_in_shutdown;        //!< file is in emergency shutdown due to irrecoverable error or unlink request
+   RAtomic_bool m_in_shutdown; //!< file is in emergency shutdown due to irrecoverable error or unlink request
 
    // Block state and management
 
    typedef std::list<int>        IntList_t;
    typedef IntList_t::iterator   IntList_i;
 
-   typedef std::map<int, Block*> BlockMap_t;
-   typedef BlockMap_t::iterator  BlockMap_i;
+   typedef std::unordered_map<int, Block*> BlockMap_t;
+   typedef BlockMap_t::iterator            BlockMap_i;
 
    BlockMap_t    m_block_map;
    XrdSysCondVar m_state_cond;
@@ -354,7 +363,16 @@ private:
    long long     m_resmon_report_threshold;
    int           m_resmon_token;       //!< token used in communication with the ResourceMonitor
 
+   // Hits served by ReadLockFree() are counted here and folded into
+   // m_delta_stats and the prefetch score the next time the lock is taken.
+   RAtomic_llong m_lf_bytes_hit;
+   RAtomic_llong m_lf_bytes_hit_ram;   //!< part of m_lf_bytes_hit served from the RAM tier
+   RAtomic_int   m_lf_prefetch_hit_cnt;
+
+   long long     m_ram_tier_id;        //!< identifies this file's blocks in the RAM tier
+
    void check_delta_stats();
+   void merge_lock_free_stats();
    void report_and_merge_delta_stats();
 
    std::set<std::string> m_remote_locations; //!< Gathered in AddIO / ioUpdate / ioActive.
@@ -362,10 +380,24 @@ private:
 
    // Prefetch
 
-   enum PrefetchState_e { kOff=-1, kOn, kHold, kStopped, kComplete };
+   // kIdle: a predictive engine has nothing to fetch until the next access.
+   enum PrefetchState_e { kOff=-1, kOn, kHold, kStopped, kComplete, kIdle };
 
    PrefetchState_e m_prefetch_state;
    int             m_prefetch_max_blocks_in_flight;
+   PrefetchEngine *m_prefetch_engine;
+   RAtomic_bool    m_prefetch_idle;     //!< m_prefetch_state == kIdle, for ReadLockFree()
+   int             m_prefetch_pattern;  //!< last pattern blocks were prefetched for
+   long long       m_remote_latency_us; //!< smoothed latency of remote block reads
+
+   // Bits of blocks prefetched during this open that have not been read yet.
+   // Cleared atomically as reads may come from ReadLockFree().
+   std::vector<unsigned char> m_prefetch_unused;
+   RAtomic_int                m_prefetch_used_cnt;
+
+   void record_access(const XrdOucIOVec *readV, int readVnum, bool locked);
+   void resume_idle_prefetch();
+   void note_prefetch_use(int blk_idx);
 
    long long m_prefetch_bytes;
    int   m_prefetch_read_cnt;
@@ -389,6 +421,10 @@ private:
 
    // Read & ReadV
 
+   bool   ReadLockFree(IO *io, const XrdOucIOVec *readV, int readVnum, int &retval);
+
+   int    ReadThroughRamTier(RamTier *rt, const XrdOucIOVec *readV, int readVnum, long long &bytes_ram);
+
    Block* PrepareBlockRequest(int i, IO *io, void *req_id, bool prefetch);
 
    void   ProcessBlockRequest (Block       *b);
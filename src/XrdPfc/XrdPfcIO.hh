@@ -79,7 +79,7 @@ private:
    time_t m_attach_time       {0}; // Set by File::AddIO()
    int    m_active_prefetches {0};
    bool   m_allow_prefetching {true};
-   bool   m_in_detach         {false};
+   RAtomic_bool m_in_detach   {false}; // Also read by File::ReadLockFree()
 
 protected:
    int                m_incomplete_count {0};
@@ -100,6 +100,17 @@ public:
    //------------------------------------------------------------------------
    ~Info();
 
+   //---------------------------------------------------------------------
+   //! Test and set a bit in a state vector atomically. Bits in the written
+   //! and prefetch vectors are only ever set while a file is active, so a
+   //! set bit may be relied upon without holding the file's state lock.
+   //---------------------------------------------------------------------
+   static bool TestBit(const unsigned char *vec, int i)
+   { return (__atomic_load_n(&vec[i/8], __ATOMIC_ACQUIRE) & (1 << (i%8))) != 0; }
+
+   static void SetBit(unsigned char *vec, int i)
+   { __atomic_fetch_or(&vec[i/8], (unsigned char) (1 << (i%8)), __ATOMIC_RELEASE); }
+
    //---------------------------------------------------------------------
    //! Mark block as written to disk
    //---------------------------------------------------------------------
@@ -342,46 +353,39 @@ private:
 
 inline bool Info::TestBitWritten(int i) const
 {
-   const int cn = i/8;
-   assert(cn < GetBitvecSizeInBytes());
+   assert(i/8 < GetBitvecSizeInBytes());
 
-   const int off = i - cn*8;
-   return (m_buff_written[cn] & cfiBIT(off)) != 0;
+   return TestBit(m_buff_written, i);
 }
 
 inline void Info::SetBitWritten(int i)
 {
-   const int cn = i/8;
-   assert(cn < GetBitvecSizeInBytes());
+   assert(i/8 < GetBitvecSizeInBytes());
 
-   const int off = i - cn*8;
-
-   m_buff_written[cn] |= cfiBIT(off);
+   // Called under the file's state lock, but the written vector and the
+   // complete flag are also read by the lock-free hit path in File.
+   SetBit(m_buff_written, i);
 
    if (--m_missingBlocks == 0)
-      m_complete = true;
+      __atomic_store_n(&m_complete, true, __ATOMIC_RELEASE);
 }
 
 inline void Info::SetBitPrefetch(int i)
 {
    if (!m_buff_prefetch) return;
 
-   const int cn = i/8;
-   assert(cn < GetBitvecSizeInBytes());
+   assert(i/8 < GetBitvecSizeInBytes());
 
-   const int off = i - cn*8;
-   m_buff_prefetch[cn] |= cfiBIT(off);
+   SetBit(m_buff_prefetch, i);
 }
 
 inline bool Info::TestBitPrefetch(int i) const
 {
    if (!m_buff_prefetch) return false;
 
-   const int cn = i/8;
-   assert(cn < GetBitvecSizeInBytes());
+   assert(i/8 < GetBitvecSizeInBytes());
 
-   const int off = i - cn*8;
-   return (m_buff_prefetch[cn] & cfiBIT(off)) != 0;
+   return TestBit(m_buff_prefetch, i);
 }
 
 inline void Info::SetBitSynced(int i)
@@ -446,7 +450,7 @@ inline long long Info::GetFileSize() const
 
 inline bool Info::IsComplete() const
 {
-   return m_complete;
+   return __atomic_load_n(&m_complete, __ATOMIC_ACQUIRE);
 }
 
 inline int Info::CountBlocksNotWrittenInRng(int firstIdx, int lastIdx) const
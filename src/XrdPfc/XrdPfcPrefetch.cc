@@ -0,0 +1,374 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by the XRootD Collaboration
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdPfcPrefetch.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+using namespace XrdPfc;
+
+//==============================================================================
+// PrefetchEngine
+//==============================================================================
+
+const char* PrefetchEngine::PatternName(Pattern_e p)
+{
+   switch (p)
+   {
+      case kSequential: return "sequential";
+      case kReverse:    return "reverse";
+      case kStride:     return "stride";
+      case kSparse:     return "sparse";
+      default:          return "none";
+   }
+}
+
+bool PrefetchEngine::IsKnown(const std::string &name)
+{
+   return name == "linear" || name == "adaptive";
+}
+
+PrefetchEngine* PrefetchEngine::Create(const std::string &name, int first_blk, int n_blks)
+{
+   if (name == "adaptive")
+      return new PrefetchAdaptive(first_blk, n_blks);
+   return new PrefetchLinear(first_blk, n_blks);
+}
+
+long long PrefetchEngine::NowUs()
+{
+   using namespace std::chrono;
+   return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+//==============================================================================
+// PrefetchLinear
+//==============================================================================
+
+void PrefetchLinear::Predict(int max_blks, long long, std::vector<int> &blks,
+                             const NeedFunc_t &is_needed)
+{
+   if (max_blks <= 0) return;
+
+   for (int b = m_first_blk; b < m_end_blk; ++b)
+   {
+      if (is_needed(b))
+      {
+         blks.push_back(b);
+         return;
+      }
+   }
+}
+
+//==============================================================================
+// PrefetchAdaptive
+//==============================================================================
+
+namespace
+{
+   // A stream not accessed for this many of its access intervals, and at
+   // least for the minimum time, is considered abandoned.
+   const long long s_stale_ivals  = 16;
+   const long long s_stale_min_us = 1000000;
+
+   const int       s_default_depth = 2;
+
+   bool stride_matches(int d, int stride)
+   {
+      if (stride == 0 || (d > 0) != (stride > 0)) return false;
+      int ad = std::abs(d), as = std::abs(stride);
+      return ad <= 2 * as && 2 * ad >= as;
+   }
+}
+
+PrefetchAdaptive::PrefetchAdaptive(int first_blk, int n_blks) :
+   PrefetchEngine(first_blk, n_blks)
+{
+   for (unsigned i = 0; i < s_ring_size; ++i)
+      m_ring[i].m_seq.store(i, std::memory_order_relaxed);
+}
+
+PrefetchAdaptive::Stream* PrefetchAdaptive::find_stream(int first)
+{
+   Stream *best = nullptr;
+   int     best_dist = s_window + 1;
+
+   for (Stream &s : m_streams)
+   {
+      if ( ! s.m_used || std::abs(first - s.m_first) > s_window) continue;
+
+      int dist = std::abs(first - (s.m_first + s.m_stride));
+      if (dist < best_dist)
+      {
+         best      = &s;
+         best_dist = dist;
+      }
+   }
+   return best;
+}
+
+PrefetchAdaptive::Stream* PrefetchAdaptive::new_stream()
+{
+   Stream *lru = &m_streams[0];
+   for (Stream &s : m_streams)
+   {
+      if ( ! s.m_used) return &s;
+      if (s.m_time_us < lru->m_time_us) lru = &s;
+   }
+   return lru;
+}
+
+void PrefetchAdaptive::publish_trigger(const Stream &s)
+{
+   // The access that has RecordAccess() return true is the first one, in the
+   // stride direction, that leaves at most half of the predicted steps.
+   Trigger &t = m_triggers[&s - m_streams];
+
+   if ( ! s.m_used || s.m_conf < 1 || s.m_stride == 0)
+   {
+      t.m_dir.store(0, std::memory_order_relaxed);
+      return;
+   }
+   int k = std::max(1, s.m_issued - s.m_depth / 2);
+   t.m_blk.store(s.m_first + k * s.m_stride, std::memory_order_relaxed);
+   t.m_dir.store(s.m_stride > 0 ? 1 : -1, std::memory_order_relaxed);
+}
+
+bool PrefetchAdaptive::drain_queue()
+{
+   // Called with m_mutex held, which makes this the only consumer.
+   bool     resume = false;
+   unsigned tail   = m_ring_tail.load(std::memory_order_relaxed);
+
+   for (;;)
+   {
+      Access &a = m_ring[tail & (s_ring_size - 1)];
+      if (a.m_seq.load(std::memory_order_acquire) != tail + 1) break;
+
+      int       first = a.m_first, last = a.m_last;
+      long long t_us  = a.m_time_us;
+      a.m_seq.store(tail + s_ring_size, std::memory_order_release);
+      ++tail;
+
+      if (apply_access(first, last, t_us)) resume = true;
+   }
+   m_ring_tail.store(tail, std::memory_order_relaxed);
+   return resume;
+}
+
+bool PrefetchAdaptive::QueueAccess(int first, int last, long long now_us)
+{
+   unsigned pos = m_ring_head.load(std::memory_order_relaxed);
+   Access  *a;
+
+   for (;;)
+   {
+      a = &m_ring[pos & (s_ring_size - 1)];
+      int diff = (int) (a->m_seq.load(std::memory_order_acquire) - pos);
+      if (diff == 0)
+      {
+         if (m_ring_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            break;
+      }
+      else if (diff < 0)
+      {
+         // Full; drop the access and have the queue drained.
+         return true;
+      }
+      else
+      {
+         pos = m_ring_head.load(std::memory_order_relaxed);
+      }
+   }
+
+   a->m_first   = first;
+   a->m_last    = last;
+   a->m_time_us = now_us;
+   a->m_seq.store(pos + 1, std::memory_order_release);
+
+   for (const Trigger &t : m_triggers)
+   {
+      int dir = t.m_dir.load(std::memory_order_relaxed);
+      if (dir == 0) continue;
+      int d = (first - t.m_blk.load(std::memory_order_relaxed)) * dir;
+      if (d >= 0 && d <= s_window) return true;
+   }
+
+   unsigned queued = pos + 1 - m_ring_tail.load(std::memory_order_relaxed);
+   return queued % (s_ring_size / 4) == 0;
+}
+
+bool PrefetchAdaptive::RecordAccess(int first, int last, long long now_us)
+{
+   XrdSysMutexHelper _lck(m_mutex);
+
+   bool resume = drain_queue();
+   if (apply_access(first, last, now_us)) resume = true;
+   return resume;
+}
+
+bool PrefetchAdaptive::apply_access(int first, int last, long long now_us)
+{
+   // Called with m_mutex held.
+
+   Stream *s = find_stream(first);
+
+   if ( ! s)
+   {
+      s = new_stream();
+      *s = Stream();
+      s->m_first   = first;
+      s->m_last    = last;
+      s->m_time_us = now_us;
+      s->m_used    = true;
+      publish_trigger(*s);
+      return false;
+   }
+
+   int d = first - s->m_first;
+   if (d == 0)
+   {
+      // Re-read of the same place, possibly a longer piece of it.
+      s->m_last = std::max(s->m_last, last);
+      return false;
+   }
+
+   if (stride_matches(d, s->m_stride))
+   {
+      ++s->m_conf;
+   }
+   else
+   {
+      s->m_conf   = 1;
+      s->m_issued = 0;
+   }
+
+   long long ival = now_us - s->m_time_us;
+   s->m_ival_us = s->m_ival_us ? (3 * s->m_ival_us + ival) / 4 : ival;
+
+   // Predictions were made in steps of the old stride ahead of the old
+   // position. Moving on by one step uses up one of them.
+   if (s->m_issued > 0) --s->m_issued;
+
+   s->m_first   = first;
+   s->m_last    = last;
+   s->m_stride  = d;
+   s->m_time_us = now_us;
+   publish_trigger(*s);
+
+   // Ask for a refill once half of the predicted steps are consumed.
+   return s->m_conf >= s_confirmed && s->m_issued <= s->m_depth / 2;
+}
+
+void PrefetchAdaptive::Predict(int max_blks, long long latency_us, std::vector<int> &blks,
+                               const NeedFunc_t &is_needed)
+{
+   XrdSysMutexHelper _lck(m_mutex);
+
+   drain_queue();
+
+   const long long now = NowUs();
+
+   std::vector<Stream*> active;
+   for (Stream &s : m_streams)
+   {
+      if ( ! s.m_used || s.m_conf < s_confirmed) continue;
+      if (now - s.m_time_us > std::max(s_stale_ivals * s.m_ival_us, s_stale_min_us)) continue;
+      active.push_back(&s);
+   }
+   std::sort(active.begin(), active.end(),
+             [](const Stream *a, const Stream *b) { return a->m_time_us > b->m_time_us; });
+
+   const size_t n_start = blks.size();
+
+   for (Stream *s : active)
+   {
+      if (predict_stream(*s, max_blks, latency_us, blks, n_start, is_needed))
+         break;
+   }
+
+   for (Stream *s : active)
+      publish_trigger(*s);
+}
+
+bool PrefetchAdaptive::predict_stream(Stream &s, int max_blks, long long latency_us,
+                                      std::vector<int> &blks, size_t n_start,
+                                      const NeedFunc_t &is_needed)
+{
+   // Called with m_mutex held. Returns true when blks is full.
+
+   // Look far enough ahead to cover one remote round trip at the rate
+   // this stream is consumed.
+   int depth = s_default_depth;
+   if (latency_us > 0 && s.m_ival_us > 0)
+      depth = (int) std::min<long long>(max_blks, latency_us / s.m_ival_us + 1);
+   depth = std::max(depth, 1);
+   s.m_depth = depth;
+
+   for (int k = s.m_issued + 1; k <= depth; ++k)
+   {
+      long long lo = (long long) s.m_first + (long long) k * s.m_stride;
+      long long hi = (long long) s.m_last  + (long long) k * s.m_stride;
+      if (hi < m_first_blk || lo >= m_end_blk)
+      {
+         // Ran off the file, nothing more to predict for this stream.
+         s.m_issued = depth;
+         break;
+      }
+      lo = std::max<long long>(lo, m_first_blk);
+      hi = std::min<long long>(hi, m_end_blk - 1);
+
+      for (int b = (int) lo; b <= (int) hi; ++b)
+      {
+         if ( ! is_needed(b) ||
+              std::find(blks.begin() + n_start, blks.end(), b) != blks.end())
+            continue;
+         blks.push_back(b);
+         if ((int) (blks.size() - n_start) >= max_blks)
+         {
+            // Step k may be incomplete, it will be looked at again.
+            s.m_issued = k - 1;
+            return true;
+         }
+      }
+      s.m_issued = k;
+   }
+   return false;
+}
+
+PrefetchEngine::Pattern_e PrefetchAdaptive::GetPattern() const
+{
+   XrdSysMutexHelper _lck(m_mutex);
+
+   const long long now = NowUs();
+
+   int n_active = 0, stride = 0;
+   for (const Stream &s : m_streams)
+   {
+      if ( ! s.m_used || s.m_conf < s_confirmed) continue;
+      if (now - s.m_time_us > std::max(s_stale_ivals * s.m_ival_us, s_stale_min_us)) continue;
+      ++n_active;
+      stride = s.m_stride;
+   }
+
+   if (n_active == 0) return kNone;
+   if (n_active >  1) return kSparse;
+   if (stride   <  0) return kReverse;
+   return stride == 1 ? kSequential : kStride;
+}
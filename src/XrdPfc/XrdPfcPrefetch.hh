@@ -0,0 +1,204 @@
+#ifndef __XRDPFC_PREFETCH_HH__
+#define __XRDPFC_PREFETCH_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by the XRootD Collaboration
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace XrdPfc
+{
+
+//----------------------------------------------------------------------------
+//! Decides which blocks of a File to prefetch next.
+//!
+//! File reports the block range of every client read with RecordAccess(),
+//! or QueueAccess() on its lock-free hit path, and asks for blocks to fetch
+//! with Predict(), all possibly from several threads. Block indices are the
+//! ones used by File, i.e. counted from the start of the remote file.
+//----------------------------------------------------------------------------
+class PrefetchEngine
+{
+public:
+   enum Pattern_e { kNone, kSequential, kReverse, kStride, kSparse };
+
+   typedef std::function<bool(int)> NeedFunc_t;
+
+   PrefetchEngine(int first_blk, int n_blks) :
+      m_first_blk(first_blk), m_end_blk(first_blk + n_blks) {}
+
+   virtual ~PrefetchEngine() {}
+
+   virtual const char* Name() const = 0;
+
+   //---------------------------------------------------------------------
+   //! Record a client read of blocks [first, last] at time now_us.
+   //!
+   //! @return true when the access makes new blocks predictable, i.e. a
+   //!         stalled prefetch should be resumed.
+   //---------------------------------------------------------------------
+   virtual bool RecordAccess(int first, int last, long long now_us) = 0;
+
+   //---------------------------------------------------------------------
+   //! Same as RecordAccess() but must not block; the access may be taken
+   //! into account only on the next call to Predict() or RecordAccess().
+   //!
+   //! @return true when a stalled prefetch should be resumed. This may be
+   //!         a guess as the access has not been looked at yet.
+   //---------------------------------------------------------------------
+   virtual bool QueueAccess(int first, int last, long long now_us)
+   { return RecordAccess(first, last, now_us); }
+
+   //---------------------------------------------------------------------
+   //! Append up to max_blks blocks to fetch to blks.
+   //!
+   //! @param latency_us  measured latency of remote block reads, 0 if unknown
+   //! @param is_needed   returns true for blocks neither on disk nor in RAM
+   //---------------------------------------------------------------------
+   virtual void Predict(int max_blks, long long latency_us, std::vector<int> &blks,
+                        const NeedFunc_t &is_needed) = 0;
+
+   //! Pattern currently detected.
+   virtual Pattern_e GetPattern() const = 0;
+
+   //! Return true when Predict() only returns blocks following recorded
+   //! accesses, false when it walks the whole file.
+   virtual bool IsPredictive() const = 0;
+
+   static const char* PatternName(Pattern_e p);
+
+   //! Known engine names: "linear" and "adaptive".
+   static bool            IsKnown(const std::string &name);
+   static PrefetchEngine* Create(const std::string &name, int first_blk, int n_blks);
+
+   static long long NowUs();
+
+protected:
+   const int m_first_blk;
+   const int m_end_blk;
+};
+
+//----------------------------------------------------------------------------
+//! Fetches the lowest missing block of the file, one at a time.
+//----------------------------------------------------------------------------
+class PrefetchLinear : public PrefetchEngine
+{
+public:
+   using PrefetchEngine::PrefetchEngine;
+
+   const char* Name() const override { return "linear"; }
+
+   bool RecordAccess(int, int, long long) override { return false; }
+
+   void Predict(int max_blks, long long latency_us, std::vector<int> &blks,
+                const NeedFunc_t &is_needed) override;
+
+   Pattern_e GetPattern()   const override { return kSequential; }
+   bool      IsPredictive() const override { return false; }
+};
+
+//----------------------------------------------------------------------------
+//! Follows a small table of access streams, each advancing by its own
+//! stride. One forward stream with stride one is a sequential read, a
+//! negative stride a reverse one. Several streams active at once are what
+//! ROOT baskets of different branches look like. Only blocks ahead of
+//! confirmed streams are predicted, as far ahead as the remote latency
+//! divided by the time between accesses of the stream.
+//!
+//! Accesses passed to QueueAccess() go to a small lock-free ring and are
+//! applied to the streams by the next Predict() or RecordAccess(). To tell
+//! whether a queued access warrants a resume, every stream publishes the
+//! block whose access would have it ask for more blocks; a full quarter of
+//! the ring also resumes, so that new streams get looked at. Accesses are
+//! dropped when the ring is full.
+//----------------------------------------------------------------------------
+class PrefetchAdaptive : public PrefetchEngine
+{
+public:
+   PrefetchAdaptive(int first_blk, int n_blks);
+
+   const char* Name() const override { return "adaptive"; }
+
+   bool RecordAccess(int first, int last, long long now_us) override;
+
+   bool QueueAccess(int first, int last, long long now_us) override;
+
+   void Predict(int max_blks, long long latency_us, std::vector<int> &blks,
+                const NeedFunc_t &is_needed) override;
+
+   Pattern_e GetPattern()   const override;
+   bool      IsPredictive() const override { return true; }
+
+   static const int s_max_streams = 16;
+   static const int s_window      = 64;  //!< max distance in blocks to join a stream
+   static const int s_confirmed   = 2;   //!< matching steps before a stream is used
+   static const int s_ring_size   = 64;  //!< queued accesses, a power of two
+
+private:
+   struct Stream
+   {
+      int       m_first    {0};    //!< first block of the last access
+      int       m_last     {0};    //!< last block of the last access
+      int       m_stride   {0};
+      int       m_conf     {0};    //!< consecutive accesses matching the stride
+      int       m_issued   {0};    //!< steps ahead of the last access already predicted
+      long long m_time_us  {0};    //!< time of the last access
+      long long m_ival_us  {0};    //!< smoothed time between accesses
+      int       m_depth    {2};    //!< steps ahead predicted on the last call
+      bool      m_used     {false};
+   };
+
+   struct Access
+   {
+      std::atomic<unsigned> m_seq {0};   //!< ring position this slot is ready for
+      int       m_first   {0};
+      int       m_last    {0};
+      long long m_time_us {0};
+   };
+
+   // Block whose access makes a stream ask for more, in its direction.
+   struct Trigger
+   {
+      std::atomic<int> m_blk {0};
+      std::atomic<int> m_dir {0};        //!< 0 when the stream has no trigger
+   };
+
+   mutable XrdSysMutex m_mutex;
+   Stream              m_streams[s_max_streams];
+
+   Access                m_ring[s_ring_size];
+   std::atomic<unsigned> m_ring_head {0};   //!< next slot to fill
+   std::atomic<unsigned> m_ring_tail {0};   //!< next slot to apply, under m_mutex
+   Trigger               m_triggers[s_max_streams];
+
+   Stream* find_stream(int first);
+   Stream* new_stream();
+   bool    apply_access(int first, int last, long long now_us);
+   bool    drain_queue();
+   bool    predict_stream(Stream &s, int max_blks, long long latency_us,
+                          std::vector<int> &blks, size_t n_start,
+                          const NeedFunc_t &is_needed);
+   void    publish_trigger(const Stream &s);
+};
+
+}
+
+#endif
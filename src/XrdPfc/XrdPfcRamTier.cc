@@ -0,0 +1,305 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by the XRootD Collaboration
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdPfcRamTier.hh"
+#include "XrdPfcSlabAllocator.hh"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace XrdPfc;
+
+namespace
+{
+   // Each shard should hold a good number of blocks, otherwise the LRU order
+   // and admission decisions become too coarse.
+   const long long s_min_shard_bytes = 64 * 1024 * 1024;
+   const int       s_max_shards      = 16;
+
+   // Used to size the frequency sketch; blocks are rarely smaller.
+   const long long s_typical_block   = 64 * 1024;
+}
+
+RAtomic_llong RamTier::s_file_id {0};
+
+//------------------------------------------------------------------------------
+
+uint64_t RamTier::Hash(const Key &k)
+{
+   uint64_t h = (uint64_t) k.m_fid * 0x9e3779b97f4a7c15ull ^ (uint32_t) k.m_blk;
+   h ^= h >> 33; h *= 0xff51afd7ed558ccdull;
+   h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ull;
+   h ^= h >> 33;
+   return h;
+}
+
+//==============================================================================
+// Sketch
+//==============================================================================
+
+void RamTier::Sketch::Init(int n_counters)
+{
+   int w = 1024;
+   while (w < n_counters) w <<= 1;
+
+   m_table.assign(4 * w / 16, 0);
+   m_mask         = w - 1;
+   m_n_samples    = 0;
+   m_sample_limit = 10 * w;
+}
+
+void RamTier::Sketch::Increment(uint64_t h)
+{
+   bool added = false;
+   for (int r = 0; r < 4; ++r)
+   {
+      uint64_t idx   = r * (m_mask + 1) + ((h + r * (h >> 32 | 1)) & m_mask);
+      uint64_t &word = m_table[idx >> 4];
+      int       sh   = (idx & 15) << 2;
+      if (((word >> sh) & 0xf) < 15)
+      {
+         word += 1ull << sh;
+         added = true;
+      }
+   }
+   if (added && ++m_n_samples >= m_sample_limit)
+      Age();
+}
+
+int RamTier::Sketch::Estimate(uint64_t h) const
+{
+   int f = 15;
+   for (int r = 0; r < 4; ++r)
+   {
+      uint64_t idx = r * (m_mask + 1) + ((h + r * (h >> 32 | 1)) & m_mask);
+      f = std::min(f, (int) ((m_table[idx >> 4] >> ((idx & 15) << 2)) & 0xf));
+   }
+   return f;
+}
+
+void RamTier::Sketch::Age()
+{
+   // Halve all counters so that the sketch follows changes in popularity.
+   for (uint64_t &word : m_table)
+      word = (word >> 1) & 0x7777777777777777ull;
+   m_n_samples /= 2;
+}
+
+//==============================================================================
+// RamTier
+//==============================================================================
+
+RamTier::RamTier(const Config &cfg, SlabAllocator *alloc) :
+   m_cfg(cfg),
+   m_alloc(alloc)
+{
+   m_n_shards = (int) std::max(1ll, std::min<long long>(s_max_shards, m_cfg.m_max_bytes / s_min_shard_bytes));
+   m_shards   = new Shard[m_n_shards];
+
+   long long shard_bytes = m_cfg.m_max_bytes / m_n_shards;
+   for (int i = 0; i < m_n_shards; ++i)
+   {
+      m_shards[i].m_max_bytes = shard_bytes;
+      m_shards[i].m_sketch.Init((int) std::min(1ll << 24, 4 * (shard_bytes / s_typical_block)));
+   }
+}
+
+RamTier::~RamTier()
+{
+   for (int i = 0; i < m_n_shards; ++i)
+   {
+      for (Entry &e : m_shards[i].m_lru)
+         m_alloc->Release(e.m_buf, e.m_len);
+   }
+   delete [] m_shards;
+}
+
+//------------------------------------------------------------------------------
+
+bool RamTier::admit(Shard &s, uint64_t h, int len)
+{
+   // Called under shard lock.
+   if (len > s.m_max_bytes)             return false;
+   if (s.m_bytes + len <= s.m_max_bytes) return true;
+   if ( ! m_cfg.m_tinylfu)              return true;
+
+   // Admit only blocks that are more popular than the one they would evict.
+   const Entry &victim = s.m_lru.back();
+   return s.m_sketch.Estimate(h) > s.m_sketch.Estimate(Hash(victim.m_key));
+}
+
+void RamTier::link_file(Shard &s, Entry &e)
+{
+   // Called under shard lock.
+   Entry *&head = s.m_files[e.m_key.m_fid];
+   e.m_fprev = nullptr;
+   e.m_fnext = head;
+   if (head) head->m_fprev = &e;
+   head = &e;
+}
+
+void RamTier::unlink_file(Shard &s, Entry &e)
+{
+   // Called under shard lock.
+   if (e.m_fnext) e.m_fnext->m_fprev = e.m_fprev;
+   if (e.m_fprev)
+      e.m_fprev->m_fnext = e.m_fnext;
+   else if (e.m_fnext)
+      s.m_files[e.m_key.m_fid] = e.m_fnext;
+   else
+      s.m_files.erase(e.m_key.m_fid);
+}
+
+void RamTier::evict_lru(Shard &s)
+{
+   // Called under shard lock.
+   Entry &e = s.m_lru.back();
+   unlink_file(s, e);
+   s.m_map.erase(e.m_key);
+   m_alloc->Release(e.m_buf, e.m_len);
+   s.m_bytes -= e.m_len;
+   ++s.m_evicted;
+   s.m_lru.pop_back();
+}
+
+//------------------------------------------------------------------------------
+
+bool RamTier::Read(long long fid, int blk, long long off, int size, char *dst)
+{
+   Key      k { fid, blk };
+   uint64_t h = Hash(k);
+   Shard   &s = shard(h);
+
+   XrdSysMutexHelper _lck(s.m_mutex);
+
+   s.m_sketch.Increment(h);
+
+   auto mi = s.m_map.find(k);
+   if (mi == s.m_map.end() || off + size > mi->second->m_len)
+   {
+      ++s.m_misses;
+      return false;
+   }
+
+   s.m_lru.splice(s.m_lru.begin(), s.m_lru, mi->second);
+   memcpy(dst, mi->second->m_buf + off, size);
+   ++s.m_hits;
+   s.m_bytes_hit += size;
+   return true;
+}
+
+bool RamTier::WantAdmit(long long fid, int blk, int len)
+{
+   Key      k { fid, blk };
+   uint64_t h = Hash(k);
+   Shard   &s = shard(h);
+
+   XrdSysMutexHelper _lck(s.m_mutex);
+
+   if (s.m_map.find(k) != s.m_map.end())
+      return false;
+   if ( ! admit(s, h, len))
+   {
+      ++s.m_rejected;
+      return false;
+   }
+   return true;
+}
+
+bool RamTier::Insert(long long fid, int blk, const char *src, int len)
+{
+   Key      k { fid, blk };
+   uint64_t h = Hash(k);
+   Shard   &s = shard(h);
+
+   if (len <= 0 || len > s.m_max_bytes)
+      return false;
+
+   // Copy outside of the lock; the buffer is given back if we lose a race
+   // or the block is not admitted after all.
+   char *buf = m_alloc->Allocate(len);
+   if ( ! buf)
+      return false;
+   memcpy(buf, src, len);
+
+   XrdSysMutexHelper _lck(s.m_mutex);
+
+   if (s.m_map.find(k) != s.m_map.end() || ! admit(s, h, len))
+   {
+      if (s.m_map.find(k) == s.m_map.end()) ++s.m_rejected;
+      _lck.UnLock();
+      m_alloc->Release(buf, len);
+      return false;
+   }
+
+   while (s.m_bytes + len > s.m_max_bytes)
+      evict_lru(s);
+
+   s.m_lru.push_front(Entry { k, buf, len, nullptr, nullptr });
+   s.m_map[k] = s.m_lru.begin();
+   link_file(s, s.m_lru.front());
+   s.m_bytes += len;
+   ++s.m_admitted;
+   return true;
+}
+
+void RamTier::Drop(long long fid)
+{
+   for (int i = 0; i < m_n_shards; ++i)
+   {
+      Shard &s = m_shards[i];
+      XrdSysMutexHelper _lck(s.m_mutex);
+
+      auto fi = s.m_files.find(fid);
+      if (fi == s.m_files.end()) continue;
+
+      // Walk the file's own chain rather than the whole LRU list.
+      Entry *e = fi->second;
+      s.m_files.erase(fi);
+      while (e)
+      {
+         Entry *next = e->m_fnext;
+         auto   mi   = s.m_map.find(e->m_key);
+         m_alloc->Release(e->m_buf, e->m_len);
+         s.m_bytes -= e->m_len;
+         s.m_lru.erase(mi->second);
+         s.m_map.erase(mi);
+         e = next;
+      }
+   }
+}
+
+//------------------------------------------------------------------------------
+
+void RamTier::GetUsage(Usage &u)
+{
+   u = Usage();
+   for (int i = 0; i < m_n_shards; ++i)
+   {
+      Shard &s = m_shards[i];
+      XrdSysMutexHelper _lck(s.m_mutex);
+
+      u.m_bytes     += s.m_bytes;
+      u.m_n_blocks  += (long long) s.m_map.size();
+      u.m_hits      += s.m_hits;
+      u.m_misses    += s.m_misses;
+      u.m_bytes_hit += s.m_bytes_hit;
+      u.m_admitted  += s.m_admitted;
+      u.m_rejected  += s.m_rejected;
+      u.m_evicted   += s.m_evicted;
+   }
+}
@@ -0,0 +1,178 @@
+#ifndef __XRDPFC_RAMTIER_HH__
+#define __XRDPFC_RAMTIER_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by the XRootD Collaboration
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdSys/XrdSysRAtomic.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace XrdPfc
+{
+
+class SlabAllocator;
+
+//----------------------------------------------------------------------------
+//! Memory-bounded tier of blocks kept in RAM after they have been written to
+//! disk, so that repeated hits on a hot working set do not need a pread().
+//!
+//! Blocks are identified by a file id, unique for the lifetime of a File
+//! object, and a block index. The tier is split into shards, each with its
+//! own lock, LRU list and TinyLFU frequency sketch. A block that does not fit
+//! is only admitted when its estimated access frequency is higher than that
+//! of the LRU block it would evict; this keeps one-off scans from flushing
+//! the working set. Buffers come from the same slab allocator as the RAM
+//! blocks used for transfers.
+//----------------------------------------------------------------------------
+class RamTier
+{
+public:
+   struct Config
+   {
+      long long m_max_bytes {0};     //!< memory limit of the tier
+      bool      m_tinylfu   {true};  //!< frequency based admission, otherwise admit all
+   };
+
+   //! Snapshot of tier counters.
+   struct Usage
+   {
+      long long m_bytes     {0}; //!< bytes in resident blocks
+      long long m_n_blocks  {0}; //!< resident blocks
+      long long m_hits      {0}; //!< lookups served from the tier
+      long long m_misses    {0}; //!< lookups not in the tier
+      long long m_bytes_hit {0}; //!< bytes served from the tier
+      long long m_admitted  {0}; //!< blocks inserted
+      long long m_rejected  {0}; //!< blocks refused by the admission policy
+      long long m_evicted   {0}; //!< blocks evicted to make room
+
+      double HitRatio() const
+      { return m_hits + m_misses > 0 ? (double) m_hits / (m_hits + m_misses) : 0; }
+   };
+
+   RamTier(const Config &cfg, SlabAllocator *alloc);
+   ~RamTier();
+
+   //! Copies size bytes at offset off of the block into dst if the block is
+   //! resident. Every call counts as an access for the admission policy.
+   bool Read(long long fid, int blk, long long off, int size, char *dst);
+
+   //! Tells whether a block of len bytes that is not resident would be
+   //! admitted if loaded now. Does not count as an access; a refusal is
+   //! counted as a rejection.
+   bool WantAdmit(long long fid, int blk, int len);
+
+   //! Stores a copy of a whole block, evicting others if admission allows.
+   bool Insert(long long fid, int blk, const char *src, int len);
+
+   //! Drops all blocks of a file. Each shard chains the blocks of every
+   //! file, so only those are visited.
+   void Drop(long long fid);
+
+   void GetUsage(Usage &u);
+
+   //! Returns a file id that has never been used before.
+   static long long NewFileId() { return ++s_file_id; }
+
+   //! Index of the block at offset off of the remote file. Blocks are keyed
+   //! by this absolute index also for a File caching only a file block.
+   static int BlockIdx(long long off, long long blk_size) { return (int) (off / blk_size); }
+
+   //! Length of block blk of a File caching file_size bytes of the remote
+   //! file starting at offset file_off.
+   static int BlockLen(int blk, long long blk_size, long long file_off, long long file_size)
+   { return (int) std::min(blk_size, file_off + file_size - blk * blk_size); }
+
+private:
+   struct Key
+   {
+      long long m_fid;
+      int       m_blk;
+
+      bool operator==(const Key &k) const { return m_fid == k.m_fid && m_blk == k.m_blk; }
+   };
+
+   struct KeyHash
+   {
+      size_t operator()(const Key &k) const { return (size_t) Hash(k); }
+   };
+
+   struct Entry
+   {
+      Key    m_key;
+      char  *m_buf;
+      int    m_len;
+      Entry *m_fprev;   //!< other blocks of the same file in this shard
+      Entry *m_fnext;
+   };
+
+   typedef std::list<Entry> Lru_t;
+   typedef Lru_t::iterator  Lru_i;
+
+   //! Count-min sketch of 4-bit counters, four rows, halved periodically.
+   class Sketch
+   {
+   public:
+      void     Init(int n_counters);
+      void     Increment(uint64_t h);
+      int      Estimate(uint64_t h) const;
+
+   private:
+      std::vector<uint64_t> m_table;   //!< sixteen 4-bit counters per word
+      uint64_t              m_mask {0};
+      int                   m_n_samples {0};
+      int                   m_sample_limit {0};
+
+      void Age();
+   };
+
+   struct alignas(64) Shard
+   {
+      XrdSysMutex                             m_mutex;
+      Lru_t                                   m_lru;  //!< most recently used first
+      std::unordered_map<Key, Lru_i, KeyHash> m_map;
+      std::unordered_map<long long, Entry*>   m_files; //!< first block of each file
+      Sketch                                  m_sketch;
+      long long                               m_bytes {0};
+      long long                               m_max_bytes {0};
+      long long m_hits {0}, m_misses {0}, m_bytes_hit {0};
+      long long m_admitted {0}, m_rejected {0}, m_evicted {0};
+   };
+
+   Config         m_cfg;
+   SlabAllocator *m_alloc;
+   int            m_n_shards;
+   Shard         *m_shards;
+
+   static RAtomic_llong s_file_id;
+
+   static uint64_t Hash(const Key &k);
+
+   Shard& shard(uint64_t h) { return m_shards[(h >> 32) % m_n_shards]; }
+   bool   admit(Shard &s, uint64_t h, int len);
+   void   evict_lru(Shard &s);
+   void   link_file(Shard &s, Entry &e);
+   void   unlink_file(Shard &s, Entry &e);
+};
+
+}
+
+#endif
@@ -412,6 +412,9 @@ void ResourceMonitor::heart_beat()
       bool do_purge_report     = next_purge_report_time <= now;
       bool do_purge_cold_files = next_purge_cold_files_time <= now;
 
+      // RAM usage goes to cache statistics on every beat, to g-stream with the sshot reports.
+      Cache::GetInstance().ReportRAMUsage(do_sshot_report);
+
       // Update stats in usages if any secondary activity will happen.
       if (do_sshot_report || do_purge_check || do_purge_report || do_purge_cold_files)
       {
@@ -0,0 +1,393 @@
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by the XRootD Collaboration
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdPfcSlabAllocator.hh"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
+using namespace XrdPfc;
+
+namespace
+{
+   // Size classes are 4k apart up to 64k, then four per power of two up to
+   // the largest block size.
+   const int       s_n_small_classes = 16;
+   const long long s_small_limit     = 64 * 1024;
+   const int       s_n_classes       = s_n_small_classes + 4 * (29 - 16);
+
+   // Per-cpu caches only hold blocks up to this size and at most this many
+   // blocks of a class.
+   const long long s_max_cached_size = 8 * 1024 * 1024;
+   const int       s_max_cached_cnt  = 16;
+
+   int count_numa_nodes()
+   {
+#ifdef __linux__
+      FILE *fp = fopen("/sys/devices/system/node/online", "r");
+      if ( ! fp) return 1;
+      int  max_node = 0, n;
+      char sep;
+      while (fscanf(fp, "%d", &n) == 1)
+      {
+         max_node = std::max(max_node, n);
+         if (fscanf(fp, "%c", &sep) != 1) break;
+      }
+      fclose(fp);
+      return std::min(max_node + 1, 64);
+#else
+      return 1;
+#endif
+   }
+}
+
+//------------------------------------------------------------------------------
+
+int SlabAllocator::NumClasses()
+{
+   return s_n_classes;
+}
+
+int SlabAllocator::SizeClass(long long size)
+{
+   if (size <= 0 || size > s_max_class_size) return -1;
+
+   if (size <= s_small_limit)
+      return (int) ((size + s_min_class_size - 1) / s_min_class_size) - 1;
+
+   int       p    = 63 - __builtin_clzll(size - 1);
+   long long step = 1ll << (p - 2);
+   int       idx  = (int) ((size - (1ll << p) + step - 1) >> (p - 2));
+   return s_n_small_classes + (p - 16) * 4 + idx - 1;
+}
+
+long long SlabAllocator::ClassSize(int cls)
+{
+   if (cls < s_n_small_classes)
+      return (cls + 1) * s_min_class_size;
+
+   int p = 16 + (cls - s_n_small_classes) / 4;
+   int i =      (cls - s_n_small_classes) % 4 + 1;
+   return (1ll << p) + i * (1ll << (p - 2));
+}
+
+//------------------------------------------------------------------------------
+
+SlabAllocator::SlabAllocator(const Config &cfg) :
+   m_cfg(cfg),
+   m_n_nodes(cfg.m_numa ? count_numa_nodes() : 1),
+   m_cpu_caches(0)
+{
+   long ncpu = sysconf(_SC_NPROCESSORS_CONF);
+   m_n_cpus  = ncpu > 0 ? (int) ncpu : 1;
+
+   for (int i = 0; i < m_n_nodes * s_n_classes; ++i)
+      m_depots.push_back(new Depot);
+
+   // Bound what the per-cpu caches can hold to a quarter of the keep budget,
+   // so idle cpus do not sit on a large share of the configured RAM.
+   long long cpu_budget = m_cfg.m_keep_bytes / 4 / m_n_cpus;
+   m_cache_cap.resize(s_n_classes, 0);
+   for (int c = 0; c < s_n_classes; ++c)
+   {
+      long long cs = ClassSize(c);
+      if (cs <= s_max_cached_size)
+         m_cache_cap[c] = (int) std::min<long long>(s_max_cached_cnt, cpu_budget / cs);
+   }
+
+   m_cpu_caches = new CpuCache[m_n_cpus];
+   for (int i = 0; i < m_n_cpus; ++i)
+      m_cpu_caches[i].m_blocks.resize(s_n_classes);
+}
+
+SlabAllocator::~SlabAllocator()
+{
+   delete [] m_cpu_caches;
+
+   for (Depot *d : m_depots)
+   {
+      for (auto &it : d->m_slabs)
+      {
+         munmap(it.second->m_base, it.second->m_bytes);
+         delete it.second;
+      }
+      delete d;
+   }
+}
+
+//------------------------------------------------------------------------------
+
+int SlabAllocator::current_cpu(int &node) const
+{
+   node = 0;
+#ifdef __linux__
+   if (m_n_nodes == 1)
+   {
+      // sched_getcpu() is served from the vdso, the raw syscall is not.
+      int cpu = sched_getcpu();
+      return cpu > 0 ? cpu % m_n_cpus : 0;
+   }
+   unsigned int cpu = 0, nd = 0;
+   if (syscall(SYS_getcpu, &cpu, &nd, nullptr) == 0)
+   {
+      if ((int) nd < m_n_nodes) node = nd;
+      return (int) (cpu % m_n_cpus);
+   }
+#endif
+   return 0;
+}
+
+void SlabAllocator::update_hwm(RAtomic_llong &hwm, long long val)
+{
+   long long cur = hwm;
+   while (val > cur && ! hwm.compare_exchange_weak(cur, val)) {}
+}
+
+//------------------------------------------------------------------------------
+
+SlabAllocator::Slab* SlabAllocator::map_slab(int node, int cls)
+{
+   static const long long s_page = sysconf(_SC_PAGESIZE);
+
+   long long cs = ClassSize(cls);
+   int       nb = (int) std::max(1ll, s_slab_size / cs);
+   long long sz = ((nb * cs + s_page - 1) / s_page) * s_page;
+
+   // Over-map by one huge page so the slab can start on a huge page boundary.
+   bool      huge  = m_cfg.m_hugepages && sz >= s_slab_size;
+   long long extra = huge ? s_slab_size : 0;
+
+   char *p = (char*) mmap(0, sz + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (p == MAP_FAILED) return 0;
+
+   if (huge)
+   {
+      char *a = (char*) (((uintptr_t) p + s_slab_size - 1) & ~(uintptr_t) (s_slab_size - 1));
+      char *e = p + sz + extra;
+      if (a > p)      munmap(p, a - p);
+      if (a + sz < e) munmap(a + sz, e - (a + sz));
+      p = a;
+#ifdef MADV_HUGEPAGE
+      madvise(p, sz, MADV_HUGEPAGE);
+#endif
+   }
+
+#if defined(__linux__) && defined(SYS_mbind)
+   if (m_n_nodes > 1)
+   {
+      unsigned long mask = 1ul << node;
+      syscall(SYS_mbind, p, sz, MPOL_PREFERRED, &mask, sizeof(mask) * 8, 0);
+   }
+#endif
+
+   Slab *s = new Slab;
+   s->m_base     = p;
+   s->m_bytes    = sz;
+   s->m_n_blocks = nb;
+
+   update_hwm(m_mapped_hwm, m_mapped += sz);
+   ++m_n_slabs_mapped;
+   return s;
+}
+
+void SlabAllocator::unmap_slab(Slab *s)
+{
+   munmap(s->m_base, s->m_bytes);
+   m_mapped -= s->m_bytes;
+   ++m_n_slabs_unmapped;
+   delete s;
+}
+
+//------------------------------------------------------------------------------
+
+char* SlabAllocator::depot_alloc(int node, int cls)
+{
+   Depot &d = depot(node, cls);
+   long long cs = ClassSize(cls);
+
+   XrdSysMutexHelper lock(&d.m_mutex);
+
+   Slab *s;
+   if (d.m_partial.empty())
+   {
+      if ((s = map_slab(node, cls)) == 0) return 0;
+      d.m_slabs[s->m_base] = s;
+      d.m_partial.insert(s->m_base);
+   }
+   else
+   {
+      // Fill the lowest slab first so the ones above it can drain and be unmapped.
+      s = d.m_slabs[*d.m_partial.begin()];
+      if (s->m_n_used == 0) m_empty_bytes -= s->m_bytes;
+   }
+
+   char *buf;
+   if ( ! s->m_free.empty())
+   {
+      buf = s->m_free.back();
+      s->m_free.pop_back();
+   }
+   else
+   {
+      buf = s->m_base + s->m_n_carved * cs;
+      ++s->m_n_carved;
+   }
+   if (++s->m_n_used == s->m_n_blocks)
+      d.m_partial.erase(s->m_base);
+
+   return buf;
+}
+
+void SlabAllocator::depot_free(char *buf, int cls, int node_hint)
+{
+   // The block normally comes back to the node it was allocated on, but a
+   // per-cpu cache may have moved it; probe the other nodes if needed.
+   for (int i = 0; i < m_n_nodes; ++i)
+   {
+      Depot &d = depot((node_hint + i) % m_n_nodes, cls);
+
+      XrdSysMutexHelper lock(&d.m_mutex);
+
+      auto it = d.m_slabs.upper_bound(buf);
+      if (it == d.m_slabs.begin()) continue;
+      --it;
+      Slab *s = it->second;
+      if (buf >= s->m_base + s->m_bytes) continue;
+
+      if (s->m_n_used == s->m_n_blocks)
+         d.m_partial.insert(s->m_base);
+      s->m_free.push_back(buf);
+
+      if (--s->m_n_used == 0)
+      {
+         if ((m_empty_bytes += s->m_bytes) > m_cfg.m_keep_bytes)
+         {
+            m_empty_bytes -= s->m_bytes;
+            d.m_partial.erase(s->m_base);
+            d.m_slabs.erase(it);
+            unmap_slab(s);
+         }
+         else
+         {
+            // Start from a clean carve so a reused slab hands out blocks in order.
+            s->m_free.clear();
+            s->m_n_carved = 0;
+         }
+      }
+      return;
+   }
+}
+
+//------------------------------------------------------------------------------
+
+char* SlabAllocator::Allocate(long long size)
+{
+   int cls = SizeClass(size);
+   if (cls < 0) return 0;
+
+   long long cs = ClassSize(cls);
+   int  node;
+   int  cpu = current_cpu(node);
+   char *buf = 0;
+
+   if (m_cache_cap[cls] > 0)
+   {
+      CpuCache &cc = m_cpu_caches[cpu];
+      XrdSysMutexHelper lock(&cc.m_mutex);
+      std::vector<char*> &v = cc.m_blocks[cls];
+      if ( ! v.empty())
+      {
+         buf = v.back();
+         v.pop_back();
+      }
+   }
+
+   if ( ! buf && (buf = depot_alloc(node, cls)) == 0)
+      return 0;
+
+   update_hwm(m_requested_hwm, m_requested += size);
+   update_hwm(m_in_use_hwm,    m_in_use    += cs);
+   return buf;
+}
+
+void SlabAllocator::Release(char *buf, long long size)
+{
+   int cls = SizeClass(size);
+   if (cls < 0 || ! buf) return;
+
+   m_requested -= size;
+   m_in_use    -= ClassSize(cls);
+
+   int node;
+   int cpu = current_cpu(node);
+
+   if (m_cache_cap[cls] > 0)
+   {
+      CpuCache &cc = m_cpu_caches[cpu];
+      XrdSysMutexHelper lock(&cc.m_mutex);
+      std::vector<char*> &v = cc.m_blocks[cls];
+      if ((int) v.size() < m_cache_cap[cls])
+      {
+         v.push_back(buf);
+         return;
+      }
+   }
+
+   depot_free(buf, cls, node);
+}
+
+void SlabAllocator::Trim()
+{
+   std::vector<char*> blocks;
+   for (int i = 0; i < m_n_cpus; ++i)
+   {
+      CpuCache &cc = m_cpu_caches[i];
+      for (int c = 0; c < s_n_classes; ++c)
+      {
+         {
+            XrdSysMutexHelper lock(&cc.m_mutex);
+            if (cc.m_blocks[c].empty()) continue;
+            blocks.swap(cc.m_blocks[c]);
+         }
+         for (char *b : blocks)
+            depot_free(b, c, 0);
+         blocks.clear();
+      }
+   }
+}
+
+void SlabAllocator::GetUsage(Usage &u)
+{
+   u.m_requested        = m_requested;
+   u.m_in_use           = m_in_use;
+   u.m_mapped           = m_mapped;
+   u.m_requested_hwm    = m_requested_hwm;
+   u.m_in_use_hwm       = m_in_use_hwm;
+   u.m_mapped_hwm       = m_mapped_hwm;
+   u.m_n_slabs_mapped   = m_n_slabs_mapped;
+   u.m_n_slabs_unmapped = m_n_slabs_unmapped;
+   u.m_n_numa_nodes     = m_n_nodes;
+}
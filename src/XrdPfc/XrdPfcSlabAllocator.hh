@@ -0,0 +1,150 @@
+#ifndef __XRDPFC_SLABALLOCATOR_HH__
+#define __XRDPFC_SLABALLOCATOR_HH__
+//----------------------------------------------------------------------------------
+// Copyright (c) 2026 by the XRootD Collaboration
+//----------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//----------------------------------------------------------------------------------
+
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdSys/XrdSysRAtomic.hh"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace XrdPfc
+{
+
+//----------------------------------------------------------------------------
+//! Allocator for RAM blocks holding data in transit between the remote and
+//! the disk. Requests are rounded up to a size class and carved out of slabs,
+//! large mmap-ed regions aligned to huge pages, so that blocks of the same
+//! size share a few mappings instead of each hitting the system allocator.
+//! Recently released blocks are kept in small per-cpu caches; slabs can also
+//! be kept per NUMA node so a block is served from memory local to the cpu
+//! that asked for it.
+//----------------------------------------------------------------------------
+class SlabAllocator
+{
+public:
+   struct Config
+   {
+      bool      m_hugepages  {true};  //!< madvise slabs for transparent huge pages
+      bool      m_numa       {false}; //!< keep separate slab pools per NUMA node
+      long long m_keep_bytes {0};     //!< free memory kept mapped for reuse
+   };
+
+   //! Snapshot of allocator usage, all in bytes unless noted otherwise.
+   struct Usage
+   {
+      long long m_requested      {0}; //!< sum of sizes asked for by callers
+      long long m_in_use         {0}; //!< sum of size-class sizes handed out
+      long long m_mapped         {0}; //!< memory mapped for slabs
+      long long m_requested_hwm  {0};
+      long long m_in_use_hwm     {0};
+      long long m_mapped_hwm     {0};
+      long long m_n_slabs_mapped   {0}; //!< slabs mapped since start (count)
+      long long m_n_slabs_unmapped {0}; //!< slabs unmapped since start (count)
+      int       m_n_numa_nodes   {1};
+
+      //! Fraction of handed out memory lost to size-class rounding.
+      double InternalFragmentation() const
+      { return m_in_use > 0 ? 1.0 - (double) m_requested / m_in_use : 0; }
+
+      //! Fraction of mapped memory not handed out to callers.
+      double ExternalFragmentation() const
+      { return m_mapped > 0 ? 1.0 - (double) m_in_use / m_mapped : 0; }
+   };
+
+   static const long long s_min_class_size = 4 * 1024;
+   static const long long s_max_class_size = 512 * 1024 * 1024;
+   static const long long s_slab_size      = 2 * 1024 * 1024;
+
+   SlabAllocator(const Config &cfg);
+   ~SlabAllocator();
+
+   //! Returns a page aligned buffer of at least size bytes or 0.
+   char* Allocate(long long size);
+
+   //! Returns a buffer obtained from Allocate(); size must be the one requested.
+   void  Release(char *buf, long long size);
+
+   //! Returns blocks held in per-cpu caches to their slabs so that slabs
+   //! which became empty can be unmapped. Called periodically.
+   void  Trim();
+
+   void  GetUsage(Usage &u);
+
+   static int       SizeClass(long long size);
+   static long long ClassSize(int cls);
+   static int       NumClasses();
+
+private:
+   struct Slab
+   {
+      char  *m_base;
+      long long m_bytes;
+      int    m_n_blocks;
+      int    m_n_used   {0};
+      int    m_n_carved {0};      //!< blocks handed out at least once, carved from the top
+      std::vector<char*> m_free;  //!< returned blocks below m_n_carved
+   };
+
+   //! Slabs of one size class on one NUMA node.
+   struct Depot
+   {
+      XrdSysMutex               m_mutex;
+      std::map<char*, Slab*>    m_slabs;    //!< all slabs, keyed by base address
+      std::set<char*>           m_partial;  //!< slabs with free blocks, lowest first
+   };
+
+   //! Per-cpu cache of recently released blocks.
+   struct alignas(64) CpuCache
+   {
+      XrdSysMutex                       m_mutex;
+      std::vector<std::vector<char*>>   m_blocks; //!< indexed by size class
+   };
+
+   Config                 m_cfg;
+   int                    m_n_nodes;
+   int                    m_n_cpus;
+   std::vector<int>       m_cache_cap;   //!< per-cpu cache capacity per class
+   std::vector<Depot*>    m_depots;      //!< [node * n_classes + class]
+   CpuCache              *m_cpu_caches;
+
+   RAtomic_llong m_requested     {0};
+   RAtomic_llong m_in_use        {0};
+   RAtomic_llong m_mapped        {0};
+   RAtomic_llong m_empty_bytes   {0};  //!< bytes in wholly free slabs kept mapped
+   RAtomic_llong m_requested_hwm {0};
+   RAtomic_llong m_in_use_hwm    {0};
+   RAtomic_llong m_mapped_hwm    {0};
+   RAtomic_llong m_n_slabs_mapped   {0};
+   RAtomic_llong m_n_slabs_unmapped {0};
+
+   int    current_cpu(int &node) const;
+   Depot& depot(int node, int cls) { return *m_depots[node * NumClasses() + cls]; }
+
+   char*  depot_alloc(int node, int cls);
+   void   depot_free(char *buf, int cls, int node_hint);
+   Slab*  map_slab(int node, int cls);
+   void   unmap_slab(Slab *s);
+
+   static void update_hwm(RAtomic_llong &hwm, long long val);
+};
+
+}
+
+#endif
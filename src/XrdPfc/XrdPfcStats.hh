@@ -37,6 +37,7 @@ public:
    int       m_NumIos = 0;          //!< number of IO objects attached during this access
    int       m_Duration = 0;        //!< total duration of all IOs attached
    long long m_BytesHit = 0;        //!< number of bytes served from disk
+   long long m_BytesHitRAM = 0;     //!< part of m_BytesHit served from the RAM tier
    long long m_BytesMissed = 0;     //!< number of bytes served from remote and cached
    long long m_BytesBypassed = 0;   //!< number of bytes served directly through XrdCl
    long long m_BytesWritten = 0;    //!< number of bytes written to disk
@@ -55,6 +56,7 @@ public:
       m_NumIos        (a.m_NumIos       + b.m_NumIos),
       m_Duration      (a.m_Duration      + b.m_Duration),
       m_BytesHit      (a.m_BytesHit      + b.m_BytesHit),
+      m_BytesHitRAM   (a.m_BytesHitRAM   + b.m_BytesHitRAM),
       m_BytesMissed   (a.m_BytesMissed   + b.m_BytesMissed),
       m_BytesBypassed (a.m_BytesBypassed + b.m_BytesBypassed),
       m_BytesWritten  (a.m_BytesWritten  + b.m_BytesWritten),
@@ -67,13 +69,15 @@ public:
    void AddReadStats(const Stats &s)
    {
       m_BytesHit      += s.m_BytesHit;
+      m_BytesHitRAM   += s.m_BytesHitRAM;
       m_BytesMissed   += s.m_BytesMissed;
       m_BytesBypassed += s.m_BytesBypassed;
    }
 
-   void AddBytesHit(long long bh)
+   void AddBytesHit(long long bh, long long bh_ram = 0)
    {
       m_BytesHit      += bh;
+      m_BytesHitRAM   += bh_ram;
    }
 
    void AddWriteStats(long long bytes_written, int n_cks_errs)
@@ -104,11 +108,18 @@ public:
       return BytesRead() + m_BytesWritten;
    }
 
+   //! Fraction of cache hits that were served from the RAM tier.
+   double RAMHitRatio() const
+   {
+      return m_BytesHit > 0 ? (double) m_BytesHitRAM / m_BytesHit : 0;
+   }
+
    void DeltaToReference(const Stats& ref)
    {
       m_NumIos        = ref.m_NumIos        - m_NumIos;
       m_Duration      = ref.m_Duration      - m_Duration;
       m_BytesHit      = ref.m_BytesHit      - m_BytesHit;
+      m_BytesHitRAM   = ref.m_BytesHitRAM   - m_BytesHitRAM;
       m_BytesMissed   = ref.m_BytesMissed   - m_BytesMissed;
       m_BytesBypassed = ref.m_BytesBypassed - m_BytesBypassed;
       m_BytesWritten  = ref.m_BytesWritten  - m_BytesWritten;
@@ -121,6 +132,7 @@ public:
       m_NumIos        += s.m_NumIos;
       m_Duration      += s.m_Duration;
       m_BytesHit      += s.m_BytesHit;
+      m_BytesHitRAM   += s.m_BytesHitRAM;
       m_BytesMissed   += s.m_BytesMissed;
       m_BytesBypassed += s.m_BytesBypassed;
       m_BytesWritten  += s.m_BytesWritten;
@@ -133,6 +145,7 @@ public:
       m_NumIos        = 0;
       m_Duration      = 0;
       m_BytesHit      = 0;
+      m_BytesHitRAM   = 0;
       m_BytesMissed   = 0;
       m_BytesBypassed = 0;
       m_BytesWritten  = 0;
@@ -40,6 +40,9 @@ T   operator=(T v) volatile noexcept
     operator T() volatile noexcept
       {return _m.load(std::memory_order_relaxed);}
 
+    operator T() const noexcept
+      {return _m.load(std::memory_order_relaxed);}
+
 // Post-increment/decrement (i.e. x++)
 //
 T   operator++(int) noexcept
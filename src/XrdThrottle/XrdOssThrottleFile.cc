@@ -43,7 +43,7 @@ public:
     File(std::unique_ptr<XrdOssDF> wrapDF, XrdThrottleManager &throttle, XrdSysError *lP, XrdOucTrace *tP)
         : XrdOssWrapDF(*wrapDF), m_log(lP), m_throttle(throttle), m_trace(tP), m_wrapped(std::move(wrapDF)) {}
 
-virtual ~File() {}
+virtual ~File() {m_throttle.DetachFlow(m_flow);}
 
 virtual int Open(const char *path, int Oflag, mode_t Mode,
     XrdOucEnv &env) override {
@@ -60,6 +60,8 @@ virtual int Open(const char *path, int Oflag, mode_t Mode,
 
     if (rval < 0) {
         m_throttle.CloseFile(m_user);
+    } else {
+        m_flow = m_throttle.AttachFlow(m_user);
     }
 
     return rval;
@@ -67,6 +69,8 @@ virtual int Open(const char *path, int Oflag, mode_t Mode,
 
 virtual int Close(long long *retsz) override {
    m_throttle.CloseFile(m_user);
+   m_throttle.DetachFlow(m_flow);
+   m_flow = nullptr;
    return wrapDF.Close(retsz);
 }
 
@@ -83,13 +87,8 @@ virtual ssize_t pgRead (void* buffer, off_t offset, size_t rdlen,
 }
 
 virtual int pgRead(XrdSfsAio *aioparm, uint64_t opts) override
-{  // We disable all AIO-based reads.
-   aioparm->Result = pgRead((char *)aioparm->sfsAio.aio_buf,
-                                    aioparm->sfsAio.aio_offset,          
-                                    aioparm->sfsAio.aio_nbytes,
-                                    aioparm->cksVec, opts);
-   aioparm->doneRead();
-   return 0;
+{  // AIO-based reads are done synchronously, possibly after being deferred.
+   return DoAio(AioOp::PgRead, aioparm, opts);
 }
 
 virtual ssize_t pgWrite(void* buffer, off_t offset, size_t wrlen,
@@ -101,13 +100,8 @@ virtual ssize_t pgWrite(void* buffer, off_t offset, size_t wrlen,
 }
 
 virtual int pgWrite(XrdSfsAio *aioparm, uint64_t opts) override
-{  // We disable all AIO-based writes.
-   aioparm->Result = this->pgWrite((char *)aioparm->sfsAio.aio_buf,
-                                           aioparm->sfsAio.aio_offset, 
-                                           aioparm->sfsAio.aio_nbytes,
-                                           aioparm->cksVec, opts);
-   aioparm->doneWrite();
-   return 0;
+{  // AIO-based writes are done synchronously, possibly after being deferred.
+   return DoAio(AioOp::PgWrite, aioparm, opts);
 }
 
 virtual ssize_t Read(off_t offset, size_t size) override {
@@ -122,11 +116,7 @@ virtual ssize_t Read(void* buffer, off_t offset, size_t size) override {
 }
 
 virtual int Read(XrdSfsAio *aiop) override {
-    aiop->Result = this->Read((char *)aiop->sfsAio.aio_buf,
-                                   aiop->sfsAio.aio_offset,
-                                   aiop->sfsAio.aio_nbytes);
-    aiop->doneRead();
-    return 0;
+    return DoAio(AioOp::Read, aiop, 0);
 }
 
 virtual ssize_t ReadV(XrdOucIOVec *readV, int rdvcnt) override {
@@ -145,18 +135,75 @@ virtual ssize_t Write(const void* buffer, off_t offset, size_t size) override {
 }
 
 virtual int Write(XrdSfsAio *aiop) override {
-    aiop->Result = this->Write((char *)aiop->sfsAio.aio_buf,
-                                    aiop->sfsAio.aio_offset,
-                                    aiop->sfsAio.aio_nbytes);
-    aiop->doneWrite();
-    return 0;
+    return DoAio(AioOp::Write, aiop, 0);
 }
 
 private:
 
+    enum class AioOp {Read, Write, PgRead, PgWrite};
+
+    static void AioDone(AioOp op, XrdSfsAio *aiop) {
+        if (op == AioOp::Read || op == AioOp::PgRead) aiop->doneRead();
+        else aiop->doneWrite();
+    }
+
+    int DoAio(AioOp op, XrdSfsAio *aiop, uint64_t opts) {
+        if (!m_throttle.CanDefer(m_flow)) {
+            aiop->Result = RunAio(op, aiop, opts, false);
+            AioDone(op, aiop);
+            return 0;
+        }
+        auto isRead = (op == AioOp::Read || op == AioOp::PgRead);
+        auto job = new XrdThrottleShaper::AioJob(m_throttle.Scheduler(), aiop, isRead,
+                                                 [=, this] {return RunAio(op, aiop, opts, true);});
+        if (m_throttle.Defer(aiop->sfsAio.aio_nbytes, 1, m_flow, *job)) job->DoIt();
+        return 0;
+    }
+
+    // Perform an AIO request synchronously; if admitted is true, the
+    // bandwidth and IOPS throttle has already been applied.
+    ssize_t RunAio(AioOp op, XrdSfsAio *aiop, uint64_t opts, bool admitted) {
+        auto buffer = (void *)aiop->sfsAio.aio_buf;
+        auto offset = aiop->sfsAio.aio_offset;
+        auto size = aiop->sfsAio.aio_nbytes;
+        switch (op) {
+        case AioOp::Read:
+            return Run(admitted, size,
+                static_cast<ssize_t (XrdOssDF::*)(void*, off_t, size_t)>(&XrdOssDF::Read),
+                buffer, offset, size);
+        case AioOp::Write:
+            return Run(admitted, size,
+                static_cast<ssize_t (XrdOssDF::*)(const void*, off_t, size_t)>(&XrdOssDF::Write),
+                buffer, offset, size);
+        case AioOp::PgRead:
+            return Run(admitted, size,
+                static_cast<ssize_t (XrdOssDF::*)(void*, off_t, size_t, uint32_t*, uint64_t)>(&XrdOssDF::pgRead),
+                buffer, offset, size, aiop->cksVec, opts);
+        case AioOp::PgWrite:
+            return Run(admitted, size,
+                static_cast<ssize_t (XrdOssDF::*)(void*, off_t, size_t, uint32_t*, uint64_t)>(&XrdOssDF::pgWrite),
+                buffer, offset, size, aiop->cksVec, opts);
+        }
+        return -EINVAL;
+    }
+
+    template <class Fn, class... Args>
+    int Run(bool admitted, size_t len, Fn &&fn, Args &&... args) {
+        if (admitted) return DoIO(std::forward<Fn>(fn), std::forward<Args>(args)...);
+        return DoThrottle(len, 1, std::forward<Fn>(fn), std::forward<Args>(args)...);
+    }
+
     template <class Fn, class... Args>
     int DoThrottle(size_t rdlen, size_t ops, Fn &&fn, Args &&... args) {
-        m_throttle.Apply(rdlen, ops, m_uid);
+        if (!m_throttle.Apply(rdlen, ops, m_flow)) {
+            TRACE(DEBUG, "Throttling in progress");
+            return -EMFILE;
+        }
+        return DoIO(std::forward<Fn>(fn), std::forward<Args>(args)...);
+    }
+
+    template <class Fn, class... Args>
+    int DoIO(Fn &&fn, Args &&... args) {
         bool ok = true;
         XrdThrottleTimer timer = m_throttle.StartIOTimer(m_uid, ok);
         if (!ok) {
@@ -172,6 +219,7 @@ private:
     std::unique_ptr<XrdOssDF> m_wrapped;
     std::string m_user;
     uint16_t m_uid;
+    XrdThrottleShaper::Flow *m_flow{nullptr};
 
     static constexpr char TraceID[] = "XrdThrottleFile";
 };
@@ -193,6 +241,7 @@ public:
             auto gstream = reinterpret_cast<XrdXrootdGStream*>(envP->GetPtr("Throttle.gStream*"));
             m_log->Say("Config", "Throttle g-stream has", gstream ? "" : " NOT", " been configured via xrootd.mongstream directive");
             m_throttle.SetMonitor(gstream);
+            m_throttle.SetScheduler(reinterpret_cast<XrdScheduler*>(envP->GetPtr("XrdScheduler*")));
         }
     }
 
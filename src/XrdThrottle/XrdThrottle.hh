@@ -122,12 +122,21 @@ private:
    virtual
    ~File();
 
+   enum class AioOp {Read, Write, PgRead, PgWrite};
+
+   int
+   DoAio(AioOp op, XrdSfsAio *aioparm, uint64_t opts);
+
+   XrdSfsXferSize
+   RunAio(AioOp op, XrdSfsAio *aioparm, uint64_t opts);
+
    bool m_is_open{false};
    unique_sfs_ptr m_sfs;
    int m_uid; // A unique identifier for this user; has no meaning except for the fairshare.
    std::string m_loadshed;
    std::string m_connection_id; // Identity for the connection; may or may authenticated
    std::string m_user;
+   XrdThrottleShaper::Flow *m_flow{nullptr}; // Node of this file in the bandwidth scheduler
    XrdThrottleManager &m_throttle;
    XrdSysError &m_eroute;
 };
@@ -30,6 +30,7 @@
 #include "XrdThrottle/XrdThrottleConfig.hh"
 #include "XrdThrottle/XrdThrottleTrace.hh"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <fcntl.h>
@@ -69,8 +70,10 @@ Configuration::Configure(const std::string &config_file)
         TS_Xeq("throttle.throttle", xthrottle);
         TS_Xeq("throttle.loadshed", xloadshed);
         TS_Xeq("throttle.max_wait_time", xmaxwait);
+        TS_Xeq("throttle.max_queue_time", xmaxqueue);
         TS_Xeq("throttle.trace", xtrace);
         TS_Xeq("throttle.userconfig", xuserconfig);
+        TS_Xeq("throttle.class", xclass);
         if (NoGo)
         {
             m_log.Emsg("Config", "Throttle configuration failed.");
@@ -131,6 +134,37 @@ Configuration::xmaxconn(XrdOucStream &Config)
     return 0;
 }
 
+/******************************************************************************/
+/*                            x m a x q u e u e                               */
+/******************************************************************************/
+
+/* Function: xmaxqueue
+
+   Purpose:  Parse the directive: throttle.max_queue_time <limit>
+
+             <limit>   maximum time, in seconds, a request may wait for the
+                       data rate and IOPS limits before it fails
+
+   If the directive is not provided, requests wait until they are admitted.
+
+  Output: 0 upon success or !0 upon failure.
+*/
+int
+Configuration::xmaxqueue(XrdOucStream &Config)
+{
+    auto val = Config.GetWord();
+    if (!val || val[0] == '\0')
+       {m_log.Emsg("Config", "Max queue time not specified (must be in seconds)!  Example usage: throttle.max_queue_time 60");
+        return 1;
+       }
+    long long max_queue = -1;
+    if (XrdOuca2x::a2sz(m_log, "max queue time value", val, &max_queue, 1)) return 1;
+
+    m_max_queue = max_queue;
+
+    return 0;
+}
+
 /******************************************************************************/
 /*                            x m a x w a i t                                 */
 /******************************************************************************/
@@ -165,10 +199,15 @@ Configuration::xmaxwait(XrdOucStream &Config)
 
 /* Function: xthrottle
 
-   Purpose:  To parse the directive: throttle [data <drate>] [iops <irate>] [concurrency <climit>] [interval <rint>]
+   Purpose:  To parse the directive: throttle [data <drate>] [iops <irate>] [burst <dburst>]
+                                              [iburst <iburst>] [concurrency <climit>] [interval <rint>]
 
              <drate>    maximum bytes per second through the server.
              <irate>    maximum IOPS per second through the server.
+             <dburst>   bytes that may be used at once above the data rate; defaults
+                        to one second worth.
+             <iburst>   operations that may be used at once above the IOPS rate;
+                        defaults to one second worth.
              <climit>   maximum number of concurrent IO connections.
              <rint>     minimum interval in milliseconds between throttle re-computing.
 
@@ -177,7 +216,7 @@ Configuration::xmaxwait(XrdOucStream &Config)
 int
 Configuration::xthrottle(XrdOucStream &Config)
 {
-    long long drate = -1, irate = -1, rint = 1000, climit = -1;
+    long long drate = -1, irate = -1, dburst = -1, iburst = -1, rint = 1000, climit = -1;
     char *val;
 
     while ((val = Config.GetWord()))
@@ -194,6 +233,18 @@ Configuration::xthrottle(XrdOucStream &Config)
              {m_log.Emsg("Config", "IOPS throttle limit not specified."); return 1;}
           if (XrdOuca2x::a2sz(m_log,"IOPS throttle value",val,&irate,1)) return 1;
        }
+       else if (strcmp("burst", val) == 0)
+       {
+          if (!(val = Config.GetWord()))
+             {m_log.Emsg("Config", "data burst not specified."); return 1;}
+          if (XrdOuca2x::a2sz(m_log,"data burst value",val,&dburst,1)) return 1;
+       }
+       else if (strcmp("iburst", val) == 0)
+       {
+          if (!(val = Config.GetWord()))
+             {m_log.Emsg("Config", "IOPS burst not specified."); return 1;}
+          if (XrdOuca2x::a2sz(m_log,"IOPS burst value",val,&iburst,1)) return 1;
+       }
        else if (strcmp("rint", val) == 0)
        {
           if (!(val = Config.GetWord()))
@@ -214,6 +265,8 @@ Configuration::xthrottle(XrdOucStream &Config)
 
     m_throttle_data_rate = drate;
     m_throttle_iops_rate = irate;
+    m_throttle_data_burst = dburst;
+    m_throttle_iops_burst = iburst;
     m_throttle_concurrency_limit = climit;
     m_throttle_recompute_interval_ms = rint;
 
@@ -377,3 +430,112 @@ int Configuration::xuserconfig(XrdOucStream &Config)
    m_log.Emsg("Config Info: using user config file at '", val, "'.");
    return 0;
 }
+
+/******************************************************************************/
+/*                                x c l a s s                                 */
+/******************************************************************************/
+
+/* Function: xclass
+
+   Purpose:  To parse the directive: class <name> [parent <pname>] [match <pat>[,<pat>...]]
+                                           [weight <w>] [data <drate>] [iops <irate>]
+                                           [burst <dburst>] [iburst <iburst>]
+                                           [userdata <udrate>] [useriops <uirate>]
+                                           [filedata <fdrate>] [fileiops <firate>]
+
+             <name>     name of the class; letters, digits, '_', '-' and '.' only.
+             <pname>    class this one is nested in; must be defined earlier.
+             <pat>      user names placed in this class; a '*' matches any suffix.
+             <w>        share of the parent's capacity relative to the siblings.
+             <drate>    maximum bytes per second for the whole class.
+             <irate>    maximum IOPS for the whole class.
+             <dburst>   data burst of the class; defaults to one second worth.
+             <iburst>   IOPS burst of the class; defaults to one second worth.
+             <udrate>   maximum bytes per second for each user in the class.
+             <uirate>   maximum IOPS for each user in the class.
+             <fdrate>   maximum bytes per second for each open file in the class.
+             <firate>   maximum IOPS for each open file in the class.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+int Configuration::xclass(XrdOucStream &Config)
+{
+    static const struct {const char *name; const char *what; long long ClassConfig::*value;} opts[] =
+    {
+        {"data",     "class data rate",      &ClassConfig::m_data_rate},
+        {"iops",     "class IOPS rate",      &ClassConfig::m_iops_rate},
+        {"burst",    "class data burst",     &ClassConfig::m_data_burst},
+        {"iburst",   "class IOPS burst",     &ClassConfig::m_iops_burst},
+        {"userdata", "per-user data rate",   &ClassConfig::m_user_data_rate},
+        {"useriops", "per-user IOPS rate",   &ClassConfig::m_user_iops_rate},
+        {"filedata", "per-file data rate",   &ClassConfig::m_file_data_rate},
+        {"fileiops", "per-file IOPS rate",   &ClassConfig::m_file_iops_rate},
+    };
+    ClassConfig klass;
+    char *val;
+
+    if (!(val = Config.GetWord()) || !val[0])
+       {m_log.Emsg("Config", "class name not specified."); return 1;}
+    klass.m_name = val;
+    if (klass.m_name.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_-.") != std::string::npos)
+       {m_log.Emsg("Config", "invalid class name", val); return 1;}
+
+    while ((val = Config.GetWord()))
+    {
+       if (strcmp("parent", val) == 0)
+       {
+          if (!(val = Config.GetWord()))
+             {m_log.Emsg("Config", "parent class not specified."); return 1;}
+          klass.m_parent = val;
+          continue;
+       }
+       if (strcmp("match", val) == 0)
+       {
+          if (!(val = Config.GetWord()))
+             {m_log.Emsg("Config", "class match pattern not specified."); return 1;}
+          std::string patterns(val);
+          size_t pos = 0;
+          while (pos <= patterns.size())
+          {
+             auto next = patterns.find(',', pos);
+             if (next == std::string::npos) next = patterns.size();
+             if (next > pos) klass.m_match.emplace_back(patterns.substr(pos, next - pos));
+             pos = next + 1;
+          }
+          continue;
+       }
+       if (strcmp("weight", val) == 0)
+       {
+          if (!(val = Config.GetWord()))
+             {m_log.Emsg("Config", "class weight not specified."); return 1;}
+          if (XrdOuca2x::a2ll(m_log,"class weight",val,&klass.m_weight,1,1000000)) return 1;
+          continue;
+       }
+       size_t idx;
+       for (idx = 0; idx < sizeof(opts)/sizeof(opts[0]); idx++)
+       {
+          if (strcmp(opts[idx].name, val) == 0) break;
+       }
+       if (idx == sizeof(opts)/sizeof(opts[0]))
+       {
+          m_log.Emsg("Config", "Warning - unknown class option specified", val, ".");
+          continue;
+       }
+       if (!(val = Config.GetWord()))
+          {m_log.Emsg("Config", opts[idx].what, "not specified."); return 1;}
+       if (XrdOuca2x::a2sz(m_log,opts[idx].what,val,&(klass.*opts[idx].value),1)) return 1;
+    }
+
+    for (const auto &other : m_classes)
+    {
+       if (other.m_name == klass.m_name)
+          {m_log.Emsg("Config", "class", klass.m_name.c_str(), "defined more than once."); return 1;}
+    }
+    if (!klass.m_parent.empty() &&
+        std::none_of(m_classes.begin(), m_classes.end(),
+                     [&](const ClassConfig &other) {return other.m_name == klass.m_parent;}))
+       {m_log.Emsg("Config", "parent class", klass.m_parent.c_str(), "must be defined first."); return 1;}
+
+    m_classes.emplace_back(std::move(klass));
+    return 0;
+}
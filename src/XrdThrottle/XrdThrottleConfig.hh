@@ -27,6 +27,7 @@
 #define XrdThrottle_Config_hh
 
 #include <string>
+#include <vector>
 
 class XrdOucEnv;
 class XrdOucStream;
@@ -34,6 +35,23 @@ class XrdSysError;
 
 namespace XrdThrottle {
 
+// A traffic class as given by the throttle.class directive.  Rates and bursts
+// are -1 when not set.
+struct ClassConfig {
+    std::string m_name;
+    std::string m_parent;              // Empty for a class directly below the root
+    std::vector<std::string> m_match;  // User name patterns placed in this class
+    long long m_weight{1};
+    long long m_data_rate{-1};
+    long long m_iops_rate{-1};
+    long long m_data_burst{-1};
+    long long m_iops_burst{-1};
+    long long m_user_data_rate{-1};    // Limits for each user of the class
+    long long m_user_iops_rate{-1};
+    long long m_file_data_rate{-1};    // Limits for each file of the class
+    long long m_file_iops_rate{-1};
+};
+
 class Configuration {
 public:
     Configuration(XrdSysError & log, XrdOucEnv *env)
@@ -76,6 +94,11 @@ public:
     // If not set, the default is 30 seconds.
     long long GetMaxWait() const { return m_max_wait; }
 
+    // Get the configuration for the maximum time a request may be queued by
+    // the data rate and IOPS limits before it is failed with EMFILE.
+    // If -1, requests wait until they are admitted.
+    long long GetMaxQueue() const { return m_max_queue; }
+
     // Get the configuration for the throttle concurrency limit.
     // If -1, no limit is set.
     long long GetThrottleConcurrency() const { return m_throttle_concurrency_limit; }
@@ -88,6 +111,17 @@ public:
     // If -1, no limit is set.
     long long GetThrottleIOPSRate() const { return m_throttle_iops_rate; }
 
+    // Get the configuration for the burst allowance of the data rate, in bytes.
+    // If -1, one second worth of the data rate is used.
+    long long GetThrottleDataBurst() const { return m_throttle_data_burst; }
+
+    // Get the configuration for the burst allowance of the IOPS rate.
+    // If -1, one second worth of the IOPS rate is used.
+    long long GetThrottleIOPSBurst() const { return m_throttle_iops_burst; }
+
+    // Get the traffic classes, in the order they were defined.
+    const std::vector<ClassConfig> &GetClasses() const { return m_classes; }
+
     // Get the configuration for the recompute interval, in milliseconds.
     // If not set, the default is 1000 ms.
     long long GetThrottleRecomputeIntervalMS() const { return m_throttle_recompute_interval_ms; }
@@ -101,9 +135,11 @@ public:
     const std::string &GetUserConfigFile() const { return m_user_config_file; }
 
 private:
+    int xclass(XrdOucStream &Config);
     int xloadshed(XrdOucStream &Config);
     int xmaxopen(XrdOucStream &Config);
     int xmaxconn(XrdOucStream &Config);
+    int xmaxqueue(XrdOucStream &Config);
     int xmaxwait(XrdOucStream &Config);
     int xthrottle(XrdOucStream &Config);
     int xtrace(XrdOucStream &Config);
@@ -117,13 +153,17 @@ private:
     long long m_loadshed_port{0};
     long long m_max_conn{-1};
     long long m_max_open{-1};
+    long long m_max_queue{-1};
     long long m_max_wait{30};
     long long m_throttle_concurrency_limit{-1};
     long long m_throttle_data_rate{-1};
     long long m_throttle_iops_rate{-1};
+    long long m_throttle_data_burst{-1};
+    long long m_throttle_iops_burst{-1};
     long long m_throttle_recompute_interval_ms{1000};
     int m_trace_levels{0};
     std::string m_user_config_file;
+    std::vector<ClassConfig> m_classes;
 };
 
 } // namespace XrdThrottle
@@ -17,9 +17,7 @@ using namespace XrdThrottle;
    return SFS_REDIRECT; \
 }
 
-#define DO_THROTTLE(amount) \
-DO_LOADSHED \
-m_throttle.Apply(amount, 1, m_uid); \
+#define DO_TIMER \
 bool ok; \
 auto xtimer = m_throttle.StartIOTimer(m_uid, ok); \
 if (!ok) { \
@@ -27,6 +25,14 @@ if (!ok) { \
    return SFS_ERROR; \
 }
 
+#define DO_THROTTLE(amount) \
+DO_LOADSHED \
+if (!m_throttle.Apply(amount, 1, m_flow)) { \
+   error.setErrInfo(EMFILE, "I/O limit exceeded and wait time hit"); \
+   return SFS_ERROR; \
+} \
+DO_TIMER
+
 
 File::File(const char                     *user,
                  unique_sfs_ptr            sfs,
@@ -49,6 +55,7 @@ File::~File()
    if (m_is_open) {
       m_throttle.CloseFile(m_user);
    }
+   m_throttle.DetachFlow(m_flow);
 }
 
 int
@@ -68,6 +75,7 @@ File::open(const char                *fileName,
    auto retval = m_sfs->open(fileName, openMode, createMode, client, opaque);
    if (retval != SFS_ERROR) {
       m_is_open = true;
+      m_flow = m_throttle.AttachFlow(m_user);
    } else {
       m_throttle.CloseFile(m_user);
    }
@@ -79,6 +87,8 @@ File::close()
 {
    m_is_open = false;
    m_throttle.CloseFile(m_user);
+   m_throttle.DetachFlow(m_flow);
+   m_flow = nullptr;
    return m_sfs->close();
 }
 
@@ -125,13 +135,8 @@ File::pgRead(XrdSfsFileOffset   offset,
 
 XrdSfsXferSize
 File::pgRead(XrdSfsAio *aioparm, uint64_t opts)
-{  // We disable all AIO-based reads.
-   aioparm->Result = this->pgRead((XrdSfsFileOffset)aioparm->sfsAio.aio_offset,
-                                            (char *)aioparm->sfsAio.aio_buf,
-                                    (XrdSfsXferSize)aioparm->sfsAio.aio_nbytes,
-                                                    aioparm->cksVec, opts);
-   aioparm->doneRead();
-   return SFS_OK;
+{  // AIO-based reads are done synchronously, possibly after being deferred.
+   return DoAio(AioOp::PgRead, aioparm, opts);
 }
 
 XrdSfsXferSize
@@ -147,13 +152,8 @@ File::pgWrite(XrdSfsFileOffset   offset,
 
 XrdSfsXferSize
 File::pgWrite(XrdSfsAio *aioparm, uint64_t opts)
-{  // We disable all AIO-based writes.
-   aioparm->Result = this->pgWrite((XrdSfsFileOffset)aioparm->sfsAio.aio_offset,
-                                             (char *)aioparm->sfsAio.aio_buf,
-                                     (XrdSfsXferSize)aioparm->sfsAio.aio_nbytes,
-                                                     aioparm->cksVec, opts);
-   aioparm->doneWrite();
-   return SFS_OK;
+{  // AIO-based writes are done synchronously, possibly after being deferred.
+   return DoAio(AioOp::PgWrite, aioparm, opts);
 }
 
 int
@@ -175,12 +175,8 @@ File::read(XrdSfsFileOffset   fileOffset,
 
 int
 File::read(XrdSfsAio *aioparm)
-{  // We disable all AIO-based reads.
-   aioparm->Result = this->read((XrdSfsFileOffset)aioparm->sfsAio.aio_offset,
-                                          (char *)aioparm->sfsAio.aio_buf,
-                                  (XrdSfsXferSize)aioparm->sfsAio.aio_nbytes);
-   aioparm->doneRead();
-   return SFS_OK;
+{  // AIO-based reads are done synchronously, possibly after being deferred.
+   return DoAio(AioOp::Read, aioparm, 0);
 }
 
 XrdSfsXferSize
@@ -195,13 +191,75 @@ File::write(      XrdSfsFileOffset   fileOffset,
 int
 File::write(XrdSfsAio *aioparm)
 {
-   aioparm->Result = this->write((XrdSfsFileOffset)aioparm->sfsAio.aio_offset,
-                                           (char *)aioparm->sfsAio.aio_buf,
-                                   (XrdSfsXferSize)aioparm->sfsAio.aio_nbytes);
-   aioparm->doneWrite();
+   return DoAio(AioOp::Write, aioparm, 0);
+}
+
+/*
+ * Run an AIO request.  Without a scheduler (or without bandwidth limits) it
+ * is done synchronously by the calling thread, as before.  Otherwise, it is
+ * queued behind the throttle if it cannot proceed right away.
+ */
+int
+File::DoAio(AioOp op, XrdSfsAio *aioparm, uint64_t opts)
+{
+   auto offset = (XrdSfsFileOffset)aioparm->sfsAio.aio_offset;
+   auto buffer = (char *)aioparm->sfsAio.aio_buf;
+   auto size = (XrdSfsXferSize)aioparm->sfsAio.aio_nbytes;
+
+   if (!m_throttle.CanDefer(m_flow))
+   {
+      switch (op)
+      {
+         case AioOp::Read:
+            aioparm->Result = this->read(offset, buffer, size);
+            aioparm->doneRead();
+            break;
+         case AioOp::Write:
+            aioparm->Result = this->write(offset, buffer, size);
+            aioparm->doneWrite();
+            break;
+         case AioOp::PgRead:
+            aioparm->Result = this->pgRead(offset, buffer, size, aioparm->cksVec, opts);
+            aioparm->doneRead();
+            break;
+         case AioOp::PgWrite:
+            aioparm->Result = this->pgWrite(offset, buffer, size, aioparm->cksVec, opts);
+            aioparm->doneWrite();
+            break;
+      }
+      return SFS_OK;
+   }
+
+   auto isRead = (op == AioOp::Read || op == AioOp::PgRead);
+   auto job = new XrdThrottleShaper::AioJob(m_throttle.Scheduler(), aioparm, isRead,
+                                            [=, this] {return RunAio(op, aioparm, opts);});
+   if (m_throttle.Defer(size, 1, m_flow, *job)) job->DoIt();
    return SFS_OK;
 }
 
+/*
+ * Perform an AIO request once the throttle admitted it.  Load-shedding is
+ * checked here as the request may have waited for a while.
+ */
+XrdSfsXferSize
+File::RunAio(AioOp op, XrdSfsAio *aioparm, uint64_t opts)
+{
+   auto offset = (XrdSfsFileOffset)aioparm->sfsAio.aio_offset;
+   auto buffer = (char *)aioparm->sfsAio.aio_buf;
+   auto size = (XrdSfsXferSize)aioparm->sfsAio.aio_nbytes;
+
+   DO_LOADSHED
+   DO_TIMER
+   switch (op)
+   {
+      case AioOp::Read:    return m_sfs->read(offset, buffer, size);
+      case AioOp::Write:   return m_sfs->write(offset, buffer, size);
+      case AioOp::PgRead:  return m_sfs->pgRead(offset, buffer, size, aioparm->cksVec, opts);
+      case AioOp::PgWrite: return m_sfs->pgWrite(offset, buffer, size, aioparm->cksVec, opts);
+   }
+   return SFS_ERROR;
+}
+
 int
 File::sync()
 {
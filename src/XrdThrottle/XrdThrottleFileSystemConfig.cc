@@ -161,6 +161,7 @@ FileSystem::Configure(XrdSysError & log, XrdSfsFileSystem *native_fs, XrdOucEnv
        auto gstream = reinterpret_cast<XrdXrootdGStream*>(envP->GetPtr("Throttle.gStream*"));
        log.Say("Config", "Throttle g-stream has", gstream ? "" : " NOT", " been configured via xrootd.mongstream directive");
        m_throttle.SetMonitor(gstream);
+       m_throttle.SetScheduler(reinterpret_cast<XrdScheduler*>(envP->GetPtr("XrdScheduler*")));
    }
 
    // The Feature function is not a virtual but implemented by the base class to
@@ -1,10 +1,10 @@
 
 #include "XrdThrottleManager.hh"
 
+#include "Xrd/XrdScheduler.hh"
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdSec/XrdSecEntity.hh"
 #include "XrdSec/XrdSecEntityAttr.hh"
-#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysTimer.hh"
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdThrottle/XrdThrottleConfig.hh"
@@ -50,7 +50,7 @@ XrdThrottleManager::XrdThrottleManager(XrdSysError *lP, XrdOucTrace *tP) :
    m_bytes_per_second(-1),
    m_ops_per_second(-1),
    m_concurrency_limit(-1),
-   m_last_round_allocation(100*1024),
+   m_shaper(lP, tP),
    m_loadshed_host(""),
    m_loadshed_port(0),
    m_loadshed_frequency(0)
@@ -67,11 +67,19 @@ XrdThrottleManager::FromConfig(XrdThrottle::Configuration &config)
     if (max_conn != -1) SetMaxConns(max_conn);
     auto max_wait = config.GetMaxWait();
     if (max_wait != -1) SetMaxWait(max_wait);
+    auto max_queue = config.GetMaxQueue();
+    if (max_queue != -1) SetMaxQueue(max_queue);
 
     SetThrottles(config.GetThrottleDataRate(),
        config.GetThrottleIOPSRate(),
        config.GetThrottleConcurrency(),
        static_cast<float>(config.GetThrottleRecomputeIntervalMS())/1000.0);
+    m_shaper.SetRoot(config.GetThrottleDataRate(), config.GetThrottleIOPSRate(),
+       config.GetThrottleDataBurst(), config.GetThrottleIOPSBurst());
+    if (m_shaper.SetClasses(config.GetClasses()))
+    {
+       m_log->Emsg("ThrottleManager", "Failed to set up the throttle classes");
+    }
 
     m_trace->What = config.GetTraceLevels();
 
@@ -100,23 +108,13 @@ void
 XrdThrottleManager::Init()
 {
    TRACE(DEBUG, "Initializing the throttle manager.");
-   // Initialize all our shares to zero.
-   m_primary_bytes_shares.resize(m_max_users);
-   m_secondary_bytes_shares.resize(m_max_users);
-   m_primary_ops_shares.resize(m_max_users);
-   m_secondary_ops_shares.resize(m_max_users);
    for (auto & waiter : m_waiter_info) {
       waiter.m_manager = this;
    }
 
-   // Allocate each user 100KB and 10 ops to bootstrap;
-   for (int i=0; i<m_max_users; i++)
-   {
-      m_primary_bytes_shares[i] = m_last_round_allocation;
-      m_secondary_bytes_shares[i] = 0;
-      m_primary_ops_shares[i] = 10;
-      m_secondary_ops_shares[i] = 0;
-   }
+   // The bandwidth and IOPS scheduler has its own thread to release
+   // deferred requests.
+   m_shaper.Start();
 
    int rc;
    pthread_t tid;
@@ -147,42 +145,6 @@ XrdThrottleManager::GetUserInfo(const XrdSecEntity *client) {
     return std::make_tuple(user, uid);
 }
 
-/*
- * Take as many shares as possible to fulfill the request; update
- * request with current remaining value, or zero if satisfied.
- */
-inline void
-XrdThrottleManager::GetShares(int &shares, int &request)
-{
-   int remaining;
-   AtomicFSub(remaining, shares, request);
-   if (remaining > 0)
-   {
-      request -= (remaining < request) ? remaining : request;
-   }
-}
-
-/*
- * Iterate through all of the secondary shares, attempting 
- * to steal enough to fulfill the request.
- */
-void
-XrdThrottleManager::StealShares(int uid, int &reqsize, int &reqops)
-{
-   if (!reqsize && !reqops) return;
-   TRACE(BANDWIDTH, "Stealing shares to fill request of " << reqsize << " bytes");
-   TRACE(IOPS, "Stealing shares to fill request of " << reqops << " ops.");
-
-   for (int i=uid+1; i % m_max_users == uid; i++)
-   {
-      if (reqsize) GetShares(m_secondary_bytes_shares[i % m_max_users], reqsize);
-      if (reqops)  GetShares(m_secondary_ops_shares[  i % m_max_users], reqops);
-   }
-
-   TRACE(BANDWIDTH, "After stealing shares, " << reqsize << " of request bytes remain.");
-   TRACE(IOPS, "After stealing shares, " << reqops << " of request ops remain.");
-}
-
 /*
  * Increment the number of files held open by a given entity.  Returns false
  * if the user is at the maximum; in this case, the internal counter is not
@@ -336,47 +298,31 @@ XrdThrottleManager::CloseFile(const std::string &entity)
 
 /*
  * Apply the throttle.  If there are no limits set, returns immediately.  Otherwise,
- * this applies the limits as best possible, stalling the thread if necessary.
+ * the request is handed to the scheduler and the thread blocks until it is admitted.
  */
-void
-XrdThrottleManager::Apply(int reqsize, int reqops, int uid)
+bool
+XrdThrottleManager::Apply(int reqsize, int reqops, XrdThrottleShaper::Flow *flow)
 {
-   if (m_bytes_per_second < 0)
-      reqsize = 0;
-   if (m_ops_per_second < 0)
-      reqops = 0;
-   while (reqsize || reqops)
-   {
-      // Subtract the requested out of the shares
-      AtomicBeg(m_compute_var);
-      GetShares(m_primary_bytes_shares[uid], reqsize);
-      if (reqsize)
-      {
-         TRACE(BANDWIDTH, "Using secondary shares; request has " << reqsize << " bytes left.");
-         GetShares(m_secondary_bytes_shares[uid], reqsize);
-         TRACE(BANDWIDTH, "Finished with secondary shares; request has " << reqsize << " bytes left.");
-      }
-      else
-      {
-         TRACE(BANDWIDTH, "Filled byte shares out of primary; " << m_primary_bytes_shares[uid] << " left.");
-      }
-      GetShares(m_primary_ops_shares[uid], reqops);
-      if (reqops)
-      {
-         GetShares(m_secondary_ops_shares[uid], reqops);
-      }
-      StealShares(uid, reqsize, reqops);
-      AtomicEnd(m_compute_var);
+   XrdThrottleShaper::SyncRequest req;
+   if (m_shaper.Submit(flow, reqsize, reqops, req)) return true;
 
-      if (reqsize || reqops)
-      {
-         if (reqsize) TRACE(BANDWIDTH, "Sleeping to wait for throttle fairshare.");
-         if (reqops) TRACE(IOPS, "Sleeping to wait for throttle fairshare.");
-         m_compute_var.Wait();
-         m_loadshed_limit_hit++;
-      }
-   }
+   m_loadshed_limit_hit++;
+   TRACE(BANDWIDTH, "Sleeping to wait for throttle fairshare.");
+   return req.Wait();
+}
+
+/*
+ * Apply the throttle without blocking; if the request cannot proceed now,
+ * it is queued and the caller is notified through the request object.
+ */
+bool
+XrdThrottleManager::Defer(int reqsize, int reqops, XrdThrottleShaper::Flow *flow,
+                          XrdThrottleShaper::Request &req)
+{
+   if (m_shaper.Submit(flow, reqsize, reqops, req)) return true;
 
+   m_loadshed_limit_hit++;
+   return false;
 }
 
 void
@@ -587,70 +533,12 @@ XrdThrottleManager::Recompute()
 }
 
 /*
- * The heart of the manager approach.
- *
- * This routine periodically recomputes the shares of each current user.
- * Each user has a "primary" and a "secondary" share.  At the end of the
- * each time interval, the remaining primary share is moved to secondary.
- * A user can utilize both shares; if both are gone, they must block until
- * the next recompute interval.
- *
- * The secondary share can be "stolen" by any other user; so, if a user
- * is idle or under-utilizing, their share can be used by someone else.
- * However, they can never be completely starved, as no one can steal
- * primary share.
- *
- * In this way, we violate the throttle for an interval, but never starve.
- *
+ * Periodic bookkeeping: report the I/O load and the per-class statistics
+ * of the bandwidth and IOPS scheduler.
  */
 void
 XrdThrottleManager::RecomputeInternal()
 {
-   // Compute total shares for this interval; 
-   float intervals_per_second = 1.0/m_interval_length_seconds;
-   float total_bytes_shares = m_bytes_per_second / intervals_per_second;
-   float total_ops_shares   = m_ops_per_second / intervals_per_second;
-
-   // Compute the number of active users; a user is active if they used
-   // any primary share during the last interval;
-   AtomicBeg(m_compute_var);
-   float active_users = 0;
-   long bytes_used = 0;
-   for (int i=0; i<m_max_users; i++)
-   {
-      int primary = AtomicFAZ(m_primary_bytes_shares[i]);
-      if (primary != m_last_round_allocation)
-      {
-         active_users++;
-         if (primary >= 0)
-            m_secondary_bytes_shares[i] = primary;
-         primary = AtomicFAZ(m_primary_ops_shares[i]);
-         if (primary >= 0)
-             m_secondary_ops_shares[i] = primary;
-         bytes_used += (primary < 0) ? m_last_round_allocation : (m_last_round_allocation-primary);
-      }
-   }
-
-   if (active_users == 0)
-   {
-      active_users++;
-   }
-
-   // Note we allocate the same number of shares to *all* users, not
-   // just the active ones.  If a new user becomes active in the next
-   // interval, we'll go over our bandwidth budget just a bit.
-   m_last_round_allocation = static_cast<int>(total_bytes_shares / active_users);
-   int ops_shares = static_cast<int>(total_ops_shares / active_users);
-   TRACE(BANDWIDTH, "Round byte allocation " << m_last_round_allocation << " ; last round used " << bytes_used << ".");
-   TRACE(IOPS, "Round ops allocation " << ops_shares);
-   for (int i=0; i<m_max_users; i++)
-   {
-      m_primary_bytes_shares[i] = m_last_round_allocation;
-      m_primary_ops_shares[i] = ops_shares;
-   }
-
-   AtomicEnd(m_compute_var);
-
    // Reset the loadshed limit counter.
    int limit_hit = m_loadshed_limit_hit.exchange(0);
    TRACE(DEBUG, "Throttle limit hit " << limit_hit << " times during last interval.");
@@ -680,7 +568,7 @@ XrdThrottleManager::RecomputeInternal()
             TRACE(IOLOAD, "Failed g-stream insertion of throttle_update record (len=" << len << "): " << buf);
         }
    }
-   m_compute_var.Broadcast();
+   m_shaper.Report(m_gstream, m_interval_length_seconds);
 }
 
 /*
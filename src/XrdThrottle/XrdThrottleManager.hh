@@ -9,12 +9,13 @@
  *
  * The XrdThrottleManager is user-aware and provides fairshare.
  *
- * This works by having a separate thread periodically refilling
- * each user's shares.
+ * The bandwidth and IOPS limits are enforced by a hierarchical
+ * token-bucket scheduler (see XrdThrottleShaper) which knows about
+ * the configured traffic classes, users and open files.
  *
- * Note that we do not actually keep close track of users, but rather
- * put them into a hash.  This way, we can pretend there's a constant
- * number of users and use a lock-free algorithm.
+ * For the concurrency limit, we do not actually keep close track of
+ * users, but rather put them into a hash.  This way, we can pretend
+ * there's a constant number of users and use a lock-free algorithm.
  */
 
 #ifndef __XrdThrottleManager_hh_
@@ -40,7 +41,9 @@
 
 #include "XrdSys/XrdSysRAtomic.hh"
 #include "XrdSys/XrdSysPthread.hh"
+#include "XrdThrottle/XrdThrottleShaper.hh"
 
+class XrdScheduler;
 class XrdSecEntity;
 class XrdSysError;
 class XrdOucTrace;
@@ -63,7 +66,29 @@ void        Init();
 bool        OpenFile(const std::string &entity, std::string &open_error_message);
 bool        CloseFile(const std::string &entity);
 
-void        Apply(int reqsize, int reqops, int uid);
+// Apply the bandwidth and IOPS limits to a request on the given file,
+// blocking until it may proceed.  Returns false if the request waited for
+// longer than the maximum queue time, if one is set.
+bool        Apply(int reqsize, int reqops, XrdThrottleShaper::Flow *flow);
+
+// Apply the limits without blocking.  Returns true if the request may
+// proceed right away; otherwise req.Admit() is called once it may (or once
+// it timed out) and the caller must not touch req until then.  The AioJob
+// for asynchronous requests should be given Scheduler().
+bool        Defer(int reqsize, int reqops, XrdThrottleShaper::Flow *flow,
+                  XrdThrottleShaper::Request &req);
+
+// True if asynchronous requests on the file can be deferred via Defer().
+bool        CanDefer(XrdThrottleShaper::Flow *flow) const {return flow && m_sched;}
+
+// The scheduler that runs deferred asynchronous requests.
+XrdScheduler *Scheduler() const {return m_sched;}
+
+// Register a newly opened file of the given user with the scheduler.
+// Returns nullptr if no bandwidth or IOPS limits are configured.
+XrdThrottleShaper::Flow *AttachFlow(const std::string &user) {return m_shaper.Attach(user);}
+
+void        DetachFlow(XrdThrottleShaper::Flow *flow) {m_shaper.Detach(flow);}
 
 void        FromConfig(XrdThrottle::Configuration &config);
 
@@ -87,6 +112,8 @@ void        SetMaxConns(unsigned long max_conns) {m_max_conns = max_conns;}
 
 void        SetMaxWait(unsigned long max_wait) {m_max_wait_time = std::chrono::seconds(max_wait);}
 
+void        SetMaxQueue(unsigned long max_queue) {m_shaper.SetMaxWait(std::chrono::seconds(max_queue));}
+
 // Load per-user limits from configuration file
 // Returns 0 on success, non-zero on failure
 int         LoadUserLimits(const std::string &config_file);
@@ -100,6 +127,8 @@ unsigned long GetUserMaxConn(const std::string &username);
 
 void        SetMonitor(XrdXrootdGStream *gstream) {m_gstream = gstream;}
 
+void        SetScheduler(XrdScheduler *sched) {m_sched = sched;}
+
 //int         Stats(char *buff, int blen, int do_sync=0) {return m_pool.Stats(buff, blen, do_sync);}
 
 // Notify that an I/O operation has started for a given user.
@@ -149,12 +178,6 @@ void ComputeWaiterOrder();
 // to make sure we have a better estimate of the concurrency for each user.
 void UserIOAccounting();
 
-int         WaitForShares();
-
-void        GetShares(int &shares, int &request);
-
-void        StealShares(int uid, int &reqsize, int &reqops);
-
 // Return the timer hash list ID to use for the current request.
 //
 // When on Linux, this will hash across the CPU ID; the goal is to distribute
@@ -175,14 +198,10 @@ float       m_bytes_per_second;
 float       m_ops_per_second;
 int         m_concurrency_limit;
 
-// Maintain the shares
+// Bandwidth and IOPS scheduler
+XrdThrottleShaper m_shaper;
 
 static constexpr int m_max_users = 1024; // Maximum number of users we can have; used for various fixed-size arrays.
-std::vector<int> m_primary_bytes_shares;
-std::vector<int> m_secondary_bytes_shares;
-std::vector<int> m_primary_ops_shares;
-std::vector<int> m_secondary_ops_shares;
-int         m_last_round_allocation;
 
 // Waiter counts for each user
 struct alignas(64) Waiter
@@ -292,6 +311,9 @@ std::chrono::steady_clock::duration m_max_wait_time{std::chrono::seconds(30)};
 // Monitoring handle, if configured
 XrdXrootdGStream* m_gstream{nullptr};
 
+// Scheduler for deferred asynchronous requests, if available
+XrdScheduler* m_sched{nullptr};
+
 static const char *TraceID;
 
 };
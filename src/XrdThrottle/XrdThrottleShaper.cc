@@ -0,0 +1,675 @@
+/******************************************************************************/
+/*                                                                            */
+/* (c) 2026 by the Morgridge Institute for Research                           */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdThrottleShaper.hh"
+
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdThrottle/XrdThrottleConfig.hh"
+#include "XrdXrootd/XrdXrootdGStream.hh"
+
+#define XRD_TRACE m_trace->
+
+#include "XrdThrottle/XrdThrottleTrace.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// A request costs its size plus a nominal 4KB per operation when choosing
+// between siblings, so that a stream of tiny requests still uses its share.
+constexpr double g_op_cost = 4096;
+
+// Throughput is sampled in slots of this length for the histogram.
+constexpr std::chrono::milliseconds g_slot_length{100};
+
+// Bounds for the dispatcher sleep while requests are queued; the upper bound
+// also determines how quickly expired requests are noticed.
+constexpr std::chrono::milliseconds g_min_tick{1};
+constexpr std::chrono::milliseconds g_max_tick{100};
+
+}
+
+const char *
+XrdThrottleShaper::TraceID = "ThrottleShaper";
+
+XrdThrottleShaper::XrdThrottleShaper(XrdSysError *lP, XrdOucTrace *tP) :
+   m_trace(tP),
+   m_log(lP)
+{
+   m_root.m_stats.reset(new Stats());
+   m_root.m_stats->m_counters.m_name = m_root.m_name;
+}
+
+/*
+ * The shaper lives as long as the throttle manager, which is never deleted
+ * while the server runs; the dispatcher thread is only started by Start().
+ */
+XrdThrottleShaper::~XrdThrottleShaper()
+{
+}
+
+/******************************************************************************/
+/*                                B u c k e t                                 */
+/******************************************************************************/
+
+void
+XrdThrottleShaper::Bucket::Set(double rate, double burst)
+{
+   m_rate = rate;
+   m_burst = (burst > 0) ? burst : rate;
+   m_tokens = m_burst;
+   m_last = time_point();
+}
+
+/*
+ * Buckets start full; they are refilled lazily whenever they are looked at.
+ */
+void
+XrdThrottleShaper::Bucket::Refill(time_point now)
+{
+   if (!Limited()) return;
+   if (m_last == time_point()) {
+      m_last = now;
+      return;
+   }
+   if (now <= m_last) return;
+   std::chrono::duration<double> elapsed = now - m_last;
+   m_last = now;
+   m_tokens = std::min(m_burst, m_tokens + elapsed.count() * m_rate);
+}
+
+/******************************************************************************/
+/*                           S y n c R e q u e s t                            */
+/******************************************************************************/
+
+void
+XrdThrottleShaper::SyncRequest::Admit(bool ok)
+{
+   // Notify while holding the lock: the waiter owns this object and may
+   // destroy it as soon as it sees m_done.
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_done = true;
+   m_ok = ok;
+   m_cv.notify_one();
+}
+
+bool
+XrdThrottleShaper::SyncRequest::Wait()
+{
+   std::unique_lock<std::mutex> lock(m_mutex);
+   m_cv.wait(lock, [&] { return m_done; });
+   return m_ok;
+}
+
+/******************************************************************************/
+/*                           C o n f i g u r a t i o n                        */
+/******************************************************************************/
+
+void
+XrdThrottleShaper::SetRoot(double data_rate, double iops_rate,
+                           double data_burst, double iops_burst)
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_root.m_data.Set(data_rate, data_burst);
+   m_root.m_iops.Set(iops_rate, iops_burst);
+   m_active = m_active || m_root.m_data.Limited() || m_root.m_iops.Limited();
+}
+
+int
+XrdThrottleShaper::SetClasses(const std::vector<XrdThrottle::ClassConfig> &classes)
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   std::unordered_map<std::string, Node *> by_name;
+
+   for (const auto &config : classes)
+   {
+      Node *parent = &m_root;
+      if (!config.m_parent.empty()) {
+         auto iter = by_name.find(config.m_parent);
+         if (iter == by_name.end()) {
+            m_log->Emsg("Config", "Throttle class", config.m_name.c_str(),
+                        "refers to an undefined parent class");
+            return 1;
+         }
+         parent = iter->second;
+      }
+      if (by_name.count(config.m_name)) {
+         m_log->Emsg("Config", "Throttle class", config.m_name.c_str(), "defined more than once");
+         return 1;
+      }
+
+      std::unique_ptr<Node> node(new Node(config.m_name, Level::Class));
+      node->m_parent = parent;
+      node->m_weight = static_cast<double>(config.m_weight);
+      node->m_data.Set(config.m_data_rate, config.m_data_burst);
+      node->m_iops.Set(config.m_iops_rate, config.m_iops_burst);
+      node->m_user_data = config.m_user_data_rate;
+      node->m_user_iops = config.m_user_iops_rate;
+      node->m_file_data = config.m_file_data_rate;
+      node->m_file_iops = config.m_file_iops_rate;
+      node->m_stats.reset(new Stats());
+      node->m_stats->m_counters.m_name = config.m_name;
+
+      for (const auto &pattern : config.m_match)
+      {
+         auto wildcard_pos = pattern.find('*');
+         if (pattern == "*") {
+            m_catch_all = node.get();
+         } else if (wildcard_pos != std::string::npos) {
+            m_prefixes.emplace_back(pattern.substr(0, wildcard_pos), node.get());
+         } else {
+            m_exact[pattern] = node.get();
+         }
+      }
+
+      TRACE(DEBUG, "Configured class " << config.m_name << " (parent "
+            << parent->m_name << ", weight " << node->m_weight << ")");
+      by_name[config.m_name] = node.get();
+      m_classes.emplace_back(std::move(node));
+   }
+
+   // Longest prefix first, so the first match is the best one.
+   std::stable_sort(m_prefixes.begin(), m_prefixes.end(),
+                    [](const std::pair<std::string, Node *> &a,
+                       const std::pair<std::string, Node *> &b)
+                    {return a.first.size() > b.first.size();});
+
+   if (!m_classes.empty()) m_active = true;
+   return 0;
+}
+
+void *
+XrdThrottleShaper::DispatcherBootstrap(void *instance)
+{
+   static_cast<XrdThrottleShaper *>(instance)->Dispatcher();
+   return nullptr;
+}
+
+void
+XrdThrottleShaper::Start()
+{
+   if (!m_active || m_started) return;
+
+   int rc;
+   pthread_t tid;
+   if ((rc = XrdSysThread::Run(&tid, XrdThrottleShaper::DispatcherBootstrap, static_cast<void *>(this), 0, "Throttle dispatcher")))
+      m_log->Emsg("ThrottleShaper", rc, "create throttle dispatcher thread");
+   else
+      m_started = true;
+}
+
+/******************************************************************************/
+/*                          A t t a c h / D e t a c h                         */
+/******************************************************************************/
+
+XrdThrottleShaper::Node *
+XrdThrottleShaper::MatchClass(const std::string &user)
+{
+   auto iter = m_exact.find(user);
+   if (iter != m_exact.end()) return iter->second;
+
+   for (const auto &prefix : m_prefixes)
+   {
+      if (user.compare(0, prefix.first.size(), prefix.first) == 0) return prefix.second;
+   }
+
+   return m_catch_all ? m_catch_all : &m_root;
+}
+
+std::string
+XrdThrottleShaper::ClassOf(const std::string &user)
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   auto node = MatchClass(user);
+   return (node == &m_root) ? "" : node->m_name;
+}
+
+XrdThrottleShaper::Flow *
+XrdThrottleShaper::Attach(const std::string &user, time_point now)
+{
+   if (!m_active) return nullptr;
+
+   std::lock_guard<std::mutex> lock(m_mutex);
+   auto klass = MatchClass(user);
+
+   auto &user_node = klass->m_users[user];
+   if (!user_node) {
+      user_node.reset(new Node(user, Level::User));
+      user_node->m_parent = klass;
+      user_node->m_data.Set(klass->m_user_data, -1);
+      user_node->m_iops.Set(klass->m_user_iops, -1);
+      TRACE(DEBUG, "Placing user " << user << " in class " << klass->m_name);
+   }
+   user_node->m_refs++;
+
+   auto flow = new Node(user, Level::File);
+   flow->m_parent = user_node.get();
+   flow->m_data.Set(klass->m_file_data, -1);
+   flow->m_iops.Set(klass->m_file_iops, -1);
+   flow->m_refs = 1;
+   flow->m_data.Refill(now);
+   flow->m_iops.Refill(now);
+
+   // The limits are fixed once configured, so whether anything on the path
+   // can hold a request back is known now.
+   flow->m_unlimited = true;
+   for (Node *node = flow; node; node = node->m_parent)
+   {
+      if (node->m_data.Limited() || node->m_iops.Limited()) flow->m_unlimited = false;
+   }
+   return flow;
+}
+
+void
+XrdThrottleShaper::Detach(Flow *flow)
+{
+   if (!flow) return;
+
+   std::lock_guard<std::mutex> lock(m_mutex);
+   flow->m_refs = 0;
+   Release(flow);
+}
+
+/*
+ * Free a detached file node once its queue is drained, along with its user
+ * node if that was the last file of the user.  Must hold m_mutex.
+ */
+void
+XrdThrottleShaper::Release(Node *flow)
+{
+   if (flow->m_refs || flow->m_backlog) return;
+
+   auto user = flow->m_parent;
+   delete flow;
+
+   if (--user->m_refs == 0 && user->m_backlog == 0) {
+      user->m_parent->m_users.erase(user->m_name);
+   }
+}
+
+/******************************************************************************/
+/*                              S c h e d u l i n g                           */
+/******************************************************************************/
+
+/*
+ * Put a node that just got its first queued request into its parent's
+ * active set.  An idle node may not claim service for the time it was idle,
+ * so its start tag is advanced to the parent's virtual clock.
+ */
+void
+XrdThrottleShaper::Activate(Node *node)
+{
+   auto parent = node->m_parent;
+   node->m_vtime = std::max(node->m_vtime, parent->m_vclock);
+   node->m_active_iter = parent->m_active.emplace(node->m_vtime, node);
+}
+
+/*
+ * Account for a request of the given cost having been served from node;
+ * the node's backlog has already been decremented.
+ */
+void
+XrdThrottleShaper::Serve(Node *node, double cost)
+{
+   auto parent = node->m_parent;
+   parent->m_vclock = node->m_vtime;
+   node->m_vtime += cost / node->m_weight;
+   parent->m_active.erase(node->m_active_iter);
+   if (node->m_backlog) {
+      node->m_active_iter = parent->m_active.emplace(node->m_vtime, node);
+   }
+}
+
+/*
+ * A node is eligible if all of its buckets have a positive balance.  If not,
+ * remember when it will be so the dispatcher does not sleep for too long.
+ */
+bool
+XrdThrottleShaper::Eligible(Node *node, time_point now)
+{
+   node->m_data.Refill(now);
+   node->m_iops.Refill(now);
+   if (node->m_data.Ready() && node->m_iops.Ready()) return true;
+
+   auto delay = std::chrono::duration<double>(std::max(node->m_data.Delay(), node->m_iops.Delay()));
+   auto when = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay);
+   if (when < m_next_wake) m_next_wake = when;
+   return false;
+}
+
+/*
+ * Find the file node whose first request should be served next: descend
+ * through the eligible children with the lowest start tag.
+ */
+XrdThrottleShaper::Node *
+XrdThrottleShaper::Pick(Node *node, time_point now)
+{
+   if (node->m_level == Level::File) return node;
+
+   for (auto &entry : node->m_active)
+   {
+      auto child = entry.second;
+      if (!Eligible(child, now)) continue;
+      if (auto flow = Pick(child, now)) return flow;
+   }
+   return nullptr;
+}
+
+bool
+XrdThrottleShaper::Submit(Flow *flow, long long bytes, int ops, Request &req,
+                          time_point now)
+{
+   if (!flow) return true;
+
+   // Nothing can hold back a request of an unlimited file; count it for the
+   // statistics of its classes and let it go without taking the lock.
+   if (flow->m_unlimited) {
+      for (Node *node = flow->m_parent->m_parent; node; node = node->m_parent)
+      {
+         if (!node->m_stats) continue;
+         node->m_stats->m_free_bytes.fetch_add(bytes, std::memory_order_relaxed);
+         node->m_stats->m_free_ops.fetch_add(ops, std::memory_order_relaxed);
+         node->m_stats->m_free_reqs.fetch_add(1, std::memory_order_relaxed);
+      }
+      return true;
+   }
+
+   req.m_flow = flow;
+   req.m_bytes = bytes;
+   req.m_ops = ops;
+   req.m_queued = now;
+
+   std::vector<Request *> admitted;
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      // Queue the request first and let the regular scheduling pass decide;
+      // when nothing else is waiting this admits it right away.
+      flow->m_queue.push_back(&req);
+      for (Node *node = flow; node != &m_root; node = node->m_parent)
+      {
+         if (node->m_backlog++ == 0) Activate(node);
+      }
+      m_root.m_backlog++;
+
+      DispatchLocked(now, admitted);
+      if (std::find(admitted.begin(), admitted.end(), &req) == admitted.end()) {
+         TRACE(BANDWIDTH, "Deferring request of " << bytes << " bytes for user " << flow->m_name);
+         m_cv.notify_one();
+      }
+   }
+
+   bool self = false;
+   for (auto other : admitted)
+   {
+      if (other == &req) self = true;
+      else other->Admit(true);
+   }
+   return self;
+}
+
+void
+XrdThrottleShaper::DispatchLocked(time_point now, std::vector<Request *> &admitted)
+{
+   m_next_wake = now + g_max_tick;
+
+   while (m_root.m_backlog && Eligible(&m_root, now))
+   {
+      auto flow = Pick(&m_root, now);
+      if (!flow) break;
+
+      auto req = flow->m_queue.front();
+      flow->m_queue.pop_front();
+      double cost = static_cast<double>(req->m_bytes) + g_op_cost * req->m_ops;
+      for (Node *node = flow; node; node = node->m_parent)
+      {
+         node->m_data.Take(static_cast<double>(req->m_bytes));
+         node->m_iops.Take(static_cast<double>(req->m_ops));
+         node->m_backlog--;
+         if (node->m_parent) Serve(node, cost);
+      }
+      Record(flow, *req, now, false);
+      admitted.push_back(req);
+      Release(flow);
+   }
+}
+
+/*
+ * Remove a request from the queue of its file node without serving it.
+ */
+void
+XrdThrottleShaper::Unqueue(Node *flow, Request *req)
+{
+   flow->m_queue.erase(std::find(flow->m_queue.begin(), flow->m_queue.end(), req));
+   for (Node *node = flow; node; node = node->m_parent)
+   {
+      if (--node->m_backlog == 0 && node->m_parent) {
+         node->m_parent->m_active.erase(node->m_active_iter);
+      }
+   }
+}
+
+void
+XrdThrottleShaper::ExpireLocked(time_point now, std::vector<Request *> &expired)
+{
+   if (!m_root.m_backlog) return;
+
+   // Collect the file nodes with queued requests first; expiring requests
+   // modifies the active sets we would be walking.
+   std::vector<Node *> flows, pending{&m_root};
+   while (!pending.empty())
+   {
+      auto node = pending.back();
+      pending.pop_back();
+      if (node->m_level == Level::File) {
+         flows.push_back(node);
+         continue;
+      }
+      for (auto &entry : node->m_active) pending.push_back(entry.second);
+   }
+
+   for (auto flow : flows)
+   {
+      while (!flow->m_queue.empty() && now - flow->m_queue.front()->m_queued > m_max_wait)
+      {
+         auto req = flow->m_queue.front();
+         Unqueue(flow, req);
+         Record(flow, *req, now, true);
+         expired.push_back(req);
+      }
+      Release(flow);
+   }
+}
+
+void
+XrdThrottleShaper::Dispatch(time_point now)
+{
+   std::vector<Request *> admitted, expired;
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      DispatchLocked(now, admitted);
+      if (m_max_wait.count() > 0 && now - m_last_expire >= g_max_tick) {
+         m_last_expire = now;
+         ExpireLocked(now, expired);
+      }
+   }
+   for (auto req : admitted) req->Admit(true);
+   for (auto req : expired) req->Admit(false);
+}
+
+void
+XrdThrottleShaper::Dispatcher()
+{
+   while (1)
+   {
+      {
+         std::unique_lock<std::mutex> lock(m_mutex);
+         if (!m_root.m_backlog) {
+            m_cv.wait(lock);
+         } else {
+            auto now = std::chrono::steady_clock::now();
+            auto wake = std::max(m_next_wake, now + g_min_tick);
+            m_cv.wait_until(lock, std::min(wake, now + g_max_tick));
+         }
+      }
+      Dispatch();
+   }
+}
+
+/******************************************************************************/
+/*                              S t a t i s t i c s                           */
+/******************************************************************************/
+
+int
+XrdThrottleShaper::Log2Bin(double value)
+{
+   if (value < 1) return 0;
+   int bin = 1 + static_cast<int>(std::log2(value));
+   return (bin < m_hist_bins) ? bin : m_hist_bins - 1;
+}
+
+/*
+ * Close the throughput slots that ended before now.  Long idle periods are
+ * added to the first bin in one go.  Requests of unlimited files counted
+ * since the last call are added to the current slot first; they were never
+ * delayed.
+ */
+void
+XrdThrottleShaper::AdvanceSlots(Stats &stats, time_point now)
+{
+   auto free_bytes = stats.m_free_bytes.exchange(0, std::memory_order_relaxed);
+   stats.m_slot_bytes += free_bytes;
+   stats.m_counters.m_bytes += free_bytes;
+   stats.m_counters.m_ops += stats.m_free_ops.exchange(0, std::memory_order_relaxed);
+   stats.m_counters.m_delay[0] += stats.m_free_reqs.exchange(0, std::memory_order_relaxed);
+
+   if (stats.m_slot_start == time_point()) {
+      stats.m_slot_start = now;
+      return;
+   }
+   if (now - stats.m_slot_start < g_slot_length) return;
+
+   std::chrono::duration<double> slot = g_slot_length;
+   double mib_per_sec = static_cast<double>(stats.m_slot_bytes) / slot.count() / (1024.0 * 1024.0);
+   stats.m_counters.m_tput[Log2Bin(mib_per_sec)]++;
+   stats.m_slot_bytes = 0;
+   stats.m_slot_start += g_slot_length;
+
+   auto idle = (now - stats.m_slot_start) / g_slot_length;
+   stats.m_counters.m_tput[0] += static_cast<uint32_t>(idle);
+   stats.m_slot_start += idle * g_slot_length;
+}
+
+/*
+ * Account an admitted or expired request to every class on its path.
+ */
+void
+XrdThrottleShaper::Record(Node *flow, const Request &req, time_point now, bool expired)
+{
+   auto delay = std::chrono::duration<double, std::milli>(now - req.m_queued).count();
+   for (Node *node = flow->m_parent->m_parent; node; node = node->m_parent)
+   {
+      if (!node->m_stats) continue;
+      auto &stats = *node->m_stats;
+      auto &counters = stats.m_counters;
+      if (expired) {
+         counters.m_expired++;
+         continue;
+      }
+      AdvanceSlots(stats, now);
+      stats.m_slot_bytes += req.m_bytes;
+      counters.m_bytes += req.m_bytes;
+      counters.m_ops += req.m_ops;
+      if (delay > 0) counters.m_deferred++;
+      counters.m_delay[Log2Bin(delay)]++;
+   }
+}
+
+void
+XrdThrottleShaper::GetStats(std::vector<ClassStats> &stats, bool reset, time_point now)
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   stats.clear();
+   stats.reserve(m_classes.size() + 1);
+
+   auto collect = [&](Node &node)
+   {
+      AdvanceSlots(*node.m_stats, now);
+      stats.push_back(node.m_stats->m_counters);
+      stats.back().m_queued = node.m_backlog;
+      if (reset) {
+         auto name = std::move(node.m_stats->m_counters.m_name);
+         node.m_stats->m_counters = ClassStats();
+         node.m_stats->m_counters.m_name = std::move(name);
+      }
+   };
+   collect(m_root);
+   for (auto &node : m_classes) collect(*node);
+}
+
+void
+XrdThrottleShaper::Report(XrdXrootdGStream *gstream, double interval)
+{
+   if (!m_active) return;
+
+   std::vector<ClassStats> stats;
+   GetStats(stats, true);
+
+   for (const auto &entry : stats)
+   {
+      if (!entry.m_ops && !entry.m_expired && !entry.m_queued) continue;
+
+      TRACE(BANDWIDTH, "Class " << entry.m_name << ": " << entry.m_bytes << " bytes, "
+            << entry.m_ops << " ops, " << entry.m_deferred << " deferred, "
+            << entry.m_expired << " expired, " << entry.m_queued << " queued");
+      if (!gstream) continue;
+
+      char buf[1024];
+      int len = snprintf(buf, sizeof(buf),
+                         R"({"event":"throttle_class","class":"%s","interval":%.3f,"bytes":%lld,"ops":%lld,)"
+                         R"("deferred":%lld,"expired":%lld,"queued":%u,"tput":[)",
+                         entry.m_name.c_str(), interval, entry.m_bytes, entry.m_ops,
+                         entry.m_deferred, entry.m_expired, entry.m_queued);
+      for (int idx = 0; idx < m_hist_bins && len < static_cast<int>(sizeof(buf)); idx++)
+      {
+         len += snprintf(buf + len, sizeof(buf) - len, "%s%u", idx ? "," : "", entry.m_tput[idx]);
+      }
+      if (len < static_cast<int>(sizeof(buf))) len += snprintf(buf + len, sizeof(buf) - len, R"(],"delay":[)");
+      for (int idx = 0; idx < m_hist_bins && len < static_cast<int>(sizeof(buf)); idx++)
+      {
+         len += snprintf(buf + len, sizeof(buf) - len, "%s%u", idx ? "," : "", entry.m_delay[idx]);
+      }
+      if (len < static_cast<int>(sizeof(buf))) len += snprintf(buf + len, sizeof(buf) - len, "]}");
+
+      auto suc = (len < static_cast<int>(sizeof(buf))) ? gstream->Insert(buf, len + 1) : false;
+      if (!suc)
+      {
+         TRACE(BANDWIDTH, "Failed g-stream insertion of throttle_class record (len=" << len << ")");
+      }
+   }
+}
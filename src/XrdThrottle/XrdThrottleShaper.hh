@@ -0,0 +1,359 @@
+/******************************************************************************/
+/*                                                                            */
+/* (c) 2026 by the Morgridge Institute for Research                           */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+/*
+ * XrdThrottleShaper
+ *
+ * A hierarchical token-bucket scheduler for the data rate and IOPS throttles.
+ *
+ * The scheduling tree has four levels:
+ *
+ *   root (throttle.throttle) -> classes (throttle.class) -> users -> files
+ *
+ * Classes may be nested with the "parent" option, so a VO can be split
+ * further.  User and file nodes are created on demand as files are opened;
+ * a user is placed below the class whose pattern matches their name, or
+ * directly below the root if none does.
+ *
+ * Every node may carry a data and an IOPS bucket; a request may start once
+ * every bucket on its path has a positive balance and is then charged in
+ * full, so requests larger than the burst are allowed to go into debt.  When
+ * more requests are waiting than the buckets allow, siblings are served in
+ * start-time fair queueing order using their weights.
+ *
+ * Requests that cannot start are queued instead of waiting on a condition
+ * variable; the caller supplies a Request object which is notified when the
+ * request is admitted.  Synchronous callers block on a SyncRequest, while
+ * asynchronous ones use an AioJob that hands the work to the scheduler.
+ * A single dispatcher thread refills the buckets and releases queued
+ * requests.  Files whose path through the tree carries no limit at all
+ * bypass the queue and the lock; they are only counted.
+ */
+
+#ifndef __XrdThrottleShaper_hh_
+#define __XrdThrottleShaper_hh_
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Xrd/XrdJob.hh"
+#include "Xrd/XrdScheduler.hh"
+#include "XrdSfs/XrdSfsAio.hh"
+
+class XrdOucTrace;
+class XrdSysError;
+class XrdXrootdGStream;
+
+namespace XrdThrottle {
+   struct ClassConfig;
+}
+
+class XrdThrottleShaper
+{
+
+struct Node;
+
+public:
+
+typedef std::chrono::steady_clock::time_point time_point;
+
+// Opaque handle for an open file; obtained from Attach().
+typedef Node Flow;
+
+// A request that could not be admitted right away.  The owner must keep the
+// object alive until Admit() has been called.
+class Request
+{
+friend class XrdThrottleShaper;
+
+public:
+
+// Called once the request may proceed (ok is true) or, if a maximum queue
+// time was set, when it has waited longer than that (ok is false).  The
+// shaper lock is not held during the call.
+virtual void Admit(bool ok) = 0;
+
+virtual ~Request() {}
+
+private:
+
+Flow       *m_flow{nullptr};
+long long   m_bytes{0};
+int         m_ops{0};
+time_point  m_queued;
+};
+
+// A request for a thread that can do nothing but wait for its turn.
+class SyncRequest final : public Request
+{
+public:
+
+void Admit(bool ok) override;
+
+// Blocks until Admit() has been called and returns its verdict.
+bool Wait();
+
+private:
+
+std::mutex              m_mutex;
+std::condition_variable m_cv;
+bool                    m_done{false};
+bool                    m_ok{false};
+};
+
+// An asynchronous request waiting for its turn.  Once admitted, run() is
+// called on a scheduler thread and its result completes the aio, so that no
+// thread is tied up while the request waits.  The job deletes itself.
+template <class Fn>
+class AioJob final : public XrdJob, public Request
+{
+public:
+
+void Admit(bool ok) override
+     {if (ok) {m_sched->Schedule(this); return;}
+      m_aiop->Result = -EMFILE;
+      Done();
+     }
+
+void DoIt() override {m_aiop->Result = m_run(); Done();}
+
+     AioJob(XrdScheduler *sched, XrdSfsAio *aiop, bool isRead, Fn run)
+           : XrdJob("throttled aio"), m_sched(sched), m_aiop(aiop),
+             m_read(isRead), m_run(std::move(run)) {}
+
+private:
+
+void Done() {if (m_read) m_aiop->doneRead();
+                else     m_aiop->doneWrite();
+             delete this;
+            }
+
+XrdScheduler *m_sched;
+XrdSfsAio    *m_aiop;
+bool          m_read;
+Fn            m_run;
+};
+
+// Number of bins in the throughput and delay histograms.  Bin 0 counts
+// values below one unit, bin i values in [2^(i-1), 2^i) units and the last
+// bin everything larger.
+static constexpr int m_hist_bins = 16;
+
+// Per-class counters since the last call to GetStats(reset=true).
+struct ClassStats
+{
+   std::string m_name;
+   long long   m_bytes{0};     // Bytes admitted
+   long long   m_ops{0};       // Operations admitted
+   long long   m_deferred{0};  // Requests that had to be queued
+   long long   m_expired{0};   // Requests that timed out in the queue
+   unsigned    m_queued{0};    // Requests in the queue right now
+   std::array<uint32_t, m_hist_bins> m_tput{};  // 100ms slots by MiB/s
+   std::array<uint32_t, m_hist_bins> m_delay{}; // Admitted requests by ms
+};
+
+// Set the global limits; a negative rate means no limit and a negative
+// burst one second worth of the rate.
+void        SetRoot(double data_rate, double iops_rate,
+                    double data_burst, double iops_burst);
+
+// Create the configured classes.  Returns 0 on success, non-zero if a class
+// refers to an unknown parent.
+int         SetClasses(const std::vector<XrdThrottle::ClassConfig> &classes);
+
+// Fail requests queued for longer than this; zero (the default) lets them
+// wait for as long as it takes.
+void        SetMaxWait(std::chrono::steady_clock::duration max_wait)
+            {m_max_wait = max_wait;}
+
+// True if any limit is set; otherwise the shaper is never consulted.
+bool        IsActive() const {return m_active;}
+
+// Start the dispatcher thread.
+void        Start();
+
+// Create the file-level node for a new file opened by the given user.
+// Returns nullptr when the shaper is inactive.
+Flow       *Attach(const std::string &user, time_point now=std::chrono::steady_clock::now());
+
+// Release a node created with Attach().  Queued requests are still served.
+void        Detach(Flow *flow);
+
+// Submit a request.  Returns true if it may proceed immediately; otherwise
+// the request is queued and req.Admit() will be called later.
+bool        Submit(Flow *flow, long long bytes, int ops, Request &req,
+                   time_point now=std::chrono::steady_clock::now());
+
+// Admit whatever queued requests the buckets allow and fail the ones that
+// waited too long.  Called by the dispatcher thread; public for testing.
+void        Dispatch(time_point now=std::chrono::steady_clock::now());
+
+// Return the name of the class a user is placed in ("" for the root).
+std::string ClassOf(const std::string &user);
+
+// Fill in the counters of the root (as "all") and of every class.
+void        GetStats(std::vector<ClassStats> &stats, bool reset,
+                     time_point now=std::chrono::steady_clock::now());
+
+// Send the counters of every active class as "throttle_class" events.
+void        Report(XrdXrootdGStream *gstream, double interval);
+
+            XrdThrottleShaper(XrdSysError *lP, XrdOucTrace *tP);
+
+           ~XrdThrottleShaper();
+
+private:
+
+struct Bucket
+{
+   double     m_rate{-1};
+   double     m_burst{0};
+   double     m_tokens{0};
+   time_point m_last;
+
+   bool   Limited() const {return m_rate > 0;}
+   bool   Ready() const {return !Limited() || m_tokens > 0;}
+   double Delay() const {return Ready() ? 0 : -m_tokens / m_rate;}
+   void   Refill(time_point now);
+   void   Set(double rate, double burst);
+   void   Take(double amount) {if (Limited()) m_tokens -= amount;}
+};
+
+struct Stats
+{
+   ClassStats m_counters;
+   time_point m_slot_start;
+   long long  m_slot_bytes{0};
+
+   // Requests of unlimited files, counted without holding m_mutex and
+   // folded into the counters above by AdvanceSlots().
+   std::atomic<long long> m_free_bytes{0};
+   std::atomic<long long> m_free_ops{0};
+   std::atomic<uint32_t>  m_free_reqs{0};
+};
+
+enum class Level {Root, Class, User, File};
+
+typedef std::multimap<double, Node *> ActiveMap;
+
+struct Node
+{
+   std::string m_name;
+   Level       m_level;
+   Node       *m_parent{nullptr};
+   Bucket      m_data;
+   Bucket      m_iops;
+   double      m_weight{1};
+
+   // Start-time fair queueing state.  m_vtime is the start tag of the next
+   // request of this node; m_vclock is the start tag of the child served last.
+   double      m_vtime{0};
+   double      m_vclock{0};
+   ActiveMap   m_active;               // Children with queued requests
+   ActiveMap::iterator m_active_iter;
+   unsigned    m_backlog{0};           // Queued requests in this subtree
+
+   // Limits for the dynamic user and file nodes (root and class nodes only).
+   double      m_user_data{-1};
+   double      m_user_iops{-1};
+   double      m_file_data{-1};
+   double      m_file_iops{-1};
+
+   std::unordered_map<std::string, std::unique_ptr<Node>> m_users;
+   std::unique_ptr<Stats> m_stats;     // Root and class nodes only
+
+   std::deque<Request *> m_queue;      // File nodes only
+   unsigned    m_refs{0};              // Open files (user) or 0/1 (file)
+   bool        m_unlimited{false};     // File nodes: no limit on the path
+
+   Node(const std::string &name, Level level) : m_name(name), m_level(level) {}
+};
+
+static
+void       *DispatcherBootstrap(void *pp);
+
+void        Dispatcher();
+
+void        DispatchLocked(time_point now, std::vector<Request *> &admitted);
+
+void        ExpireLocked(time_point now, std::vector<Request *> &expired);
+
+void        Activate(Node *node);
+
+void        Serve(Node *node, double cost);
+
+bool        Eligible(Node *node, time_point now);
+
+Node       *Pick(Node *node, time_point now);
+
+void        Unqueue(Node *flow, Request *req);
+
+void        Release(Node *flow);
+
+void        Record(Node *flow, const Request &req, time_point now, bool expired);
+
+void        AdvanceSlots(Stats &stats, time_point now);
+
+Node       *MatchClass(const std::string &user);
+
+static int  Log2Bin(double value);
+
+XrdOucTrace *m_trace;
+XrdSysError *m_log;
+
+std::mutex m_mutex;                    // Protects all of the nodes
+std::condition_variable m_cv;          // Wakes the dispatcher
+time_point m_next_wake;                // When the dispatcher should run next
+time_point m_last_expire;              // Last time the queues were checked
+
+Node m_root{"all", Level::Root};
+std::vector<std::unique_ptr<Node>> m_classes;
+
+// Patterns for placing users into classes; same precedence as the
+// per-user limits: exact match > longest wildcard prefix > "*".
+std::unordered_map<std::string, Node *> m_exact;
+std::vector<std::pair<std::string, Node *>> m_prefixes;
+Node *m_catch_all{nullptr};
+
+bool m_active{false};
+bool m_started{false};
+std::chrono::steady_clock::duration m_max_wait{0};
+
+static const char *TraceID;
+
+};
+
+#endif
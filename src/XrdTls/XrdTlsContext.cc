@@ -17,6 +17,7 @@
 //------------------------------------------------------------------------------
 
 #include <cstdio>
+#include <cstring>
 #include <openssl/bio.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
@@ -74,6 +75,8 @@ struct XrdTlsContextImpl
     time_t                        lastCertModTime = 0;
     int                           sessionCacheOpts = -1;
     std::string                   sessionCacheId;
+    std::string                   alpnList;     // as given to SetAlpn()
+    std::string                   alpnProtos;   // in wire format
 };
   
 /******************************************************************************/
@@ -541,6 +544,21 @@ int verifyPeerCB(int aOK, X509_STORE_CTX *x509P) {
    return aOK;
 }
 
+/**
+ *
+ * OpenSSL ALPN select callback; picks the first of our protocols that the
+ * client offers.
+ */
+int alpnSelectCB(SSL *ssl, const unsigned char **out, unsigned char *outlen,
+                 const unsigned char *in, unsigned int inlen, void *arg) {
+   const std::string &protos = static_cast<XrdTlsContextImpl*>(arg)->alpnProtos;
+   if (SSL_select_next_proto((unsigned char **)out, outlen,
+                             (const unsigned char *)protos.data(), protos.size(),
+                             in, inlen) != OPENSSL_NPN_NEGOTIATED)
+      return SSL_TLSEXT_ERR_NOACK;
+   return SSL_TLSEXT_ERR_OK;
+}
+
 }
   
 } // Anonymous namespace end
@@ -731,6 +749,14 @@ XrdTlsContext::XrdTlsContext(const char *cert,  const char *key,
 //
    if (opts & artON) SSL_CTX_set_mode(pImpl->ctx, SSL_MODE_AUTO_RETRY);
 
+// Ask OpenSSL to hand the session keys to the kernel once the handshake is
+// done so that sendfile() can be used on the socket. OpenSSL quietly keeps
+// encrypting in user space should the kernel or the cipher not support it.
+//
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+   if (opts & ktlsON) SSL_CTX_set_options(pImpl->ctx, SSL_OP_ENABLE_KTLS);
+#endif
+
 // If there is no cert then assume this is a generic context for a client
 //
    if (cert == 0)
@@ -815,6 +841,8 @@ XrdTlsContext *XrdTlsContext::Clone(bool full,bool startCRLRefresh)
            //A SessionCache() call was done for the current context, so apply it for this new cloned context
            xtc->SessionCache(pImpl->sessionCacheOpts,pImpl->sessionCacheId.c_str(),pImpl->sessionCacheId.size());
        }
+       if (!pImpl->alpnList.empty())
+          xtc->SetAlpn(pImpl->alpnList.c_str());
        return xtc;
    }
 
@@ -1018,6 +1046,37 @@ int XrdTlsContext::SessionCache(int opts, const char *id, int idlen)
    return opts;
 }
   
+/******************************************************************************/
+/*                               S e t A l p n                                */
+/******************************************************************************/
+
+bool XrdTlsContext::SetAlpn(const char *protos)
+{
+   std::string wire;
+   const char *p = protos;
+
+// Convert the comma separated list to the length prefixed wire format
+//
+   while (*p)
+        {const char *e = strchr(p, ',');
+         size_t n = (e ? e - p : strlen(p));
+         if (!n || n > 255)
+            {XrdTls::Emsg("SetAlpn:", "invalid ALPN protocol list", false);
+             return false;
+            }
+         wire += static_cast<char>(n);
+         wire.append(p, n);
+         p += n + (e ? 1 : 0);
+        }
+
+   if (!pImpl->ctx || wire.empty()) return false;
+
+   pImpl->alpnList   = protos;
+   pImpl->alpnProtos = wire;
+   SSL_CTX_set_alpn_select_cb(pImpl->ctx, alpnSelectCB, pImpl);
+   return true;
+}
+
 /******************************************************************************/
 /*                     S e t C o n t e x t C i p h e r s                      */
 /******************************************************************************/
@@ -140,6 +140,19 @@ static const int scFMax = 0x00007fff; //!< Maximum flush interval in seconds
 
       int       SessionCache(int opts=scNone, const char *id=0, int idlen=0);
 
+//------------------------------------------------------------------------
+//! Set the application protocols a server context accepts (ALPN).
+//!
+//! @param  protos   The comma separated list of protocol names in order of
+//!                  preference (e.g. "h2,http/1.1"). The first one the client
+//!                  also offers is selected. If there is none, the handshake
+//!                  proceeds without a protocol being selected.
+//!
+//! @return True upon success; false if the list is invalid.
+//------------------------------------------------------------------------
+
+bool            SetAlpn(const char *protos);
+
 //------------------------------------------------------------------------
 //! Set allowed ciphers for this context.
 //!
@@ -216,6 +229,9 @@ void            SetDefaultCiphers(const char *ciphers);
 //!                  crlRF   - Initial crl refresh interval in minutes.
 //!                  dnsok   - trust DNS when verifying hostname.
 //!                  hsto    - the handshake timeout value in seconds.
+//!                  ktlsON  - Let the kernel encrypt sent data (kTLS) when
+//!                            the OS, OpenSSL and negotiated cipher allow
+//!                            it; otherwise encryption stays in user space.
 //!                  logVF   - Turn on verification failure logging.
 //!                  nopxy   - Do not allow proxy cert (normally allowed)
 //!                  servr   - This is a server-side context and x509 peer
@@ -256,6 +272,7 @@ static const uint64_t crlAM = 0x0000001000000000; //!< Allow CA validation when
 static const int      crlRS = 16;                 //!< Bits to shift   vdept
 static const uint64_t artON = 0x0000002000000000; //!< Auto retry Handshake
 static const uint64_t clcOF = 0x0000010000000000; //!< Disable client certificate request
+static const uint64_t ktlsON= 0x0000020000000000; //!< Offload encryption to kernel TLS
 
 
 static int ctxIndex;
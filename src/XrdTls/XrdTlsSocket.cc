@@ -103,6 +103,10 @@ extern XrdSysTrace SysTrace;
 /*                                l o c a l s                                 */
 /******************************************************************************/
   
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+#define XRDTLS_KTLS 1
+#endif
+
 namespace
 {
 static const int xVerify = 0x01;   //!< Peer cetrificate is to be verified
@@ -531,6 +535,28 @@ const char *XrdTlsSocket::Init( XrdTlsContext &ctx, int sfd,
    return 0;
 }
 
+/******************************************************************************/
+/*                              K T L S S e n d                               */
+/******************************************************************************/
+
+bool XrdTlsSocket::KTLSSend()
+{
+#ifdef XRDTLS_KTLS
+    XrdSysMutexHelper mHelper;
+
+    //------------------------------------------------------------------------
+    // Serialize call if need be
+    //------------------------------------------------------------------------
+
+    if (pImpl->isSerial) mHelper.Lock(&(pImpl->sslMutex));
+
+    if (pImpl->fatal || !pImpl->ssl) return false;
+    return BIO_get_ktls_send(SSL_get_wbio(pImpl->ssl)) != 0;
+#else
+    return false;
+#endif
+}
+
 /******************************************************************************/
 /*                                  P e e k                                   */
 /******************************************************************************/
@@ -689,6 +715,68 @@ XrdTls::RC XrdTlsSocket::Read( char *buffer, size_t size, int &bytesRead )
     return XrdTls::TLS_SYS_Error;
   }
 
+/******************************************************************************/
+/*                              S e n d F i l e                               */
+/******************************************************************************/
+
+XrdTls::RC XrdTlsSocket::SendFile( int fd, off_t offset, size_t size,
+                                   int &bytesOut )
+{
+#ifdef XRDTLS_KTLS
+    EPNAME("SendFile");
+    XrdSysMutexHelper mHelper;
+    int ssler;
+
+    //------------------------------------------------------------------------
+    // Serialize call if need be
+    //------------------------------------------------------------------------
+
+    if (pImpl->isSerial) mHelper.Lock(&(pImpl->sslMutex));
+
+    //------------------------------------------------------------------------
+    // Return an error if this socket received a fatal error as OpenSSL will
+    // SEGV when called after such an error.
+    //------------------------------------------------------------------------
+
+    if (pImpl->fatal)
+       {DBG_SIO("Failing due to previous error, fatal=" << (int)pImpl->fatal);
+        return (XrdTls::RC)pImpl->fatal;
+       }
+
+    //------------------------------------------------------------------------
+    // The kernel does the encryption, so there must be an established session
+    // whose write side has been handed over to it.
+    //------------------------------------------------------------------------
+
+    if (!BIO_get_ktls_send(SSL_get_wbio(pImpl->ssl)))
+       return XrdTls::TLS_UNK_Error;
+
+ do{ossl_ssize_t rc = SSL_sendfile( pImpl->ssl, fd, offset, size, 0 );
+
+    if (rc > 0)
+      {bytesOut = static_cast<int>(rc);
+       DBG_SIO(rc <<" out of " <<size <<" bytes.");
+       return XrdTls::TLS_AOK;
+      }
+
+    ssler = Diagnose("TLS_SendFile", static_cast<int>(rc), XrdTls::dbgSIO);
+    if (ssler == SSL_ERROR_NONE)
+       {bytesOut = 0;
+        return XrdTls::TLS_AOK;
+       }
+
+    if (ssler != SSL_ERROR_WANT_WRITE || !(pImpl->cAttr & wBlocking))
+       return XrdTls::ssl2RC(ssler);
+
+   } while(Wait4OK(false));
+
+    return XrdTls::TLS_SYS_Error;
+#else
+    (void)fd; (void)offset; (void)size; bytesOut = 0;
+    return XrdTls::TLS_UNK_Error;
+#endif
+}
+
 /******************************************************************************/
 /*                            S e t T r a c e I D                             */
 /******************************************************************************/
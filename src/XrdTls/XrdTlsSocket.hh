@@ -19,6 +19,7 @@
 //------------------------------------------------------------------------------
 
 #include <string>
+#include <sys/types.h>
 
 #include "XrdTls/XrdTls.hh"
 
@@ -165,6 +166,17 @@ XrdTlsPeerCerts *getCerts(bool ver=true);
   const char *Init( XrdTlsContext &ctx, int sfd, RW_Mode rwm, HS_Mode hsm,
                     bool isClient, bool serial=true, const char *tid="" );
 
+//------------------------------------------------------------------------
+//! Check if data written to this connection is encrypted by the kernel
+//! (kTLS). This is only possible after the handshake has completed and the
+//! context was created with the XrdTlsContext::ktlsON option.
+//!
+//! @return true     - SendFile() may be used on this connection.
+//! @return false    - encryption is done in user space.
+//------------------------------------------------------------------------
+
+  bool KTLSSend();
+
 //------------------------------------------------------------------------
 //! Peek at the TLS connection data. If necessary, a handshake will be done.
 //!
@@ -205,6 +217,22 @@ XrdTlsPeerCerts *getCerts(bool ver=true);
 
   XrdTls::RC Read( char *buffer, size_t size, int &bytesRead );
 
+//------------------------------------------------------------------------
+//! Send file data over the TLS connection without copying it to user space.
+//! This only works when KTLSSend() returns true.
+//!
+//! @param  fd         - The file descriptor of the file to send.
+//! @param  offset     - The offset in the file of the first byte to send.
+//! @param  size       - The number of bytes to send.
+//! @param  bytesOut   - Number of bytes actually sent, if successful.
+//!
+//! @return TLS_AOK if the operation was successful; otherwise the appropraite
+//!                 return code indicating the problem. TLS_UNK_Error is
+//!                 returned when kernel TLS is not active.
+//------------------------------------------------------------------------
+
+  XrdTls::RC SendFile( int fd, off_t offset, size_t size, int &bytesOut );
+
 //------------------------------------------------------------------------
 //! Set the trace identifier (used when it's updated).
 //!
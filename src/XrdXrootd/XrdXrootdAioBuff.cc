@@ -69,14 +69,16 @@ static const int  maxKeep =128; // Number of objects to keep sans buffer
 /*                                 A l l o c                                  */
 /******************************************************************************/
   
-XrdXrootdAioBuff *XrdXrootdAioBuff::Alloc(XrdXrootdAioTask* arp)
+XrdXrootdAioBuff *XrdXrootdAioBuff::Alloc(XrdXrootdAioTask* arp, int bsize)
 {
    XrdXrootdAioBuff *aiobuff;
    XrdBuffer *bP;
 
-// Obtain a buffer as we never hold on to them (unlike pgaio)
+// Obtain a buffer as we never hold on to them (unlike pgaio). The size is the
+// aio quantum unless the caller needs a whole readv response frame.
 //
-   if (!(bP = BPool->Obtain(XrdXrootdProtocol::as_segsize))) return 0;
+   if (bsize <= 0) bsize = XrdXrootdProtocol::as_segsize;
+   if (!(bP = BPool->Obtain(bsize))) return 0;
 
 // Obtain a preallocated aio object
 //
@@ -42,7 +42,7 @@ class XrdXrootdAioBuff : public XrdSfsAio
 public:
 
 static
-XrdXrootdAioBuff*       Alloc(XrdXrootdAioTask *arp);
+XrdXrootdAioBuff*       Alloc(XrdXrootdAioTask *arp, int bsize=0);
 
         void            doneRead() override;
 
@@ -41,6 +41,7 @@ class XrdLink;
 class XrdXrootdAioBuff;
 class XrdXrootdNormAio;
 class XrdXrootdPgrwAio;
+class XrdXrootdReadvAio;
 class XrdXrootdFile;
   
 class XrdXrootdAioTask : public XrdJob, public XrdXrootdProtocol::gdCallBack
@@ -90,6 +91,7 @@ static  const char*        TraceID;
 
 union  {XrdXrootdNormAio*  nextNorm;   // Never used in conflicting context!
         XrdXrootdPgrwAio*  nextPgrw;
+        XrdXrootdReadvAio* nextRdv;
         XrdXrootdAioTask*  nextTask;
        };
 
@@ -40,6 +40,7 @@
 #include "XrdOuc/XrdOucStream.hh"
 
 #include "XrdXrootd/XrdXrootdGSReal.hh"
+#include "XrdXrootd/XrdXrootdMonHist.hh"
 #include "XrdXrootd/XrdXrootdMonitor.hh"
 #include "XrdXrootd/XrdXrootdProtocol.hh"
 #include "XrdXrootd/XrdXrootdTpcMon.hh"
@@ -86,6 +87,8 @@ struct XrdXrootdGSReal::GSParms gsObj[] =
                      XrdXrootdGSReal::fmtBin, XrdXrootdGSReal::hdrNorm},
         {"http",     0, XROOTD_MON_HTTP,  0, -1, XROOTD_MON_GSHTP, 0,
                      XrdXrootdGSReal::fmtBin, XrdXrootdGSReal::hdrNorm},
+        {"iohist",   0, XROOTD_MON_IOHST, 0, -1, XROOTD_MON_GSIOH, 0,
+                     XrdXrootdGSReal::fmtBin, XrdXrootdGSReal::hdrNorm},
         {"pfc",      0, XROOTD_MON_PFC,   0, -1, XROOTD_MON_GSPFC, 0,
                      XrdXrootdGSReal::fmtBin, XrdXrootdGSReal::hdrNorm},
         {"TcpMon",   0, XROOTD_MON_TCPMO, 0, -1, XROOTD_MON_GSTCP, 0,
@@ -106,7 +109,8 @@ bool XrdXrootdProtocol::ConfigGStream(XrdOucEnv &myEnv, XrdOucEnv *urEnv)
    XrdXrootdGStream *gs;
    static const int numgs=sizeof(gsObj)/sizeof(struct XrdXrootdGSReal::GSParms);
    char vbuff[64];
-   bool aOK, gXrd[numgs] = {false, false, true, false, true, false, true};
+   bool aOK, gXrd[numgs] = {false, false, true, false, false, true, false,
+                            true};
 
 // For each enabled monitoring provider, allocate a g-stream and put
 // its address in our environment.
@@ -119,6 +123,8 @@ bool XrdXrootdProtocol::ConfigGStream(XrdOucEnv &myEnv, XrdOucEnv *urEnv)
             snprintf(vbuff, sizeof(vbuff), "%s.gStream*", gsObj[i].pin);
             if (!gXrd[i]) myEnv.PutPtr(vbuff, (void *)gs);
                else if (urEnv) urEnv->PutPtr(vbuff, (void *)gs);
+            if (gsObj[i].Mode == XROOTD_MON_IOHST)
+               XrdXrootdMonHist::SetStream(gs, gsObj[i].maxL);
            }
        }
 
@@ -190,13 +196,14 @@ bool XrdXrootdProtocol::ConfigMon(XrdProtocol_Config *pi, XrdOucEnv &xrootdEnv)
 /* Function: xmon
 
    Purpose:  Parse directive: monitor [...] [all] [auth]  [flush [io] <sec>]
-                                      [fstat <sec> [lfn] [ops] [ssq] [xfr <n>]
+                                      [fstat <sec> [hist] [lfn] [ops] [ssq]
+                                                   [xfr <n>]
                                       [{fbuff | fbsz} <sz>] [gbuff <sz>]
                                       [ident {<sec>|off}] [mbuff <sz>]
                                       [rbuff <sz>] [rnums <cnt>] [window <sec>]
                                       [dest [Events] <host:port>]
 
-   Events: [ccm] [files] [fstat] [info] [io] [iov] [pfc] [redir] [tcpmon] [throttle] [user]
+   Events: [ccm] [files] [fstat] [info] [io] [iohist] [iov] [pfc] [redir] [tcpmon] [throttle] [user]
 
          all                enables monitoring for all connections.
          auth               add authentication information to "user".
@@ -204,6 +211,9 @@ bool XrdXrootdProtocol::ConfigMon(XrdProtocol_Config *pi, XrdOucEnv &xrootdEnv)
                             io is given applies only to i/o events.
          fstat  <sec>       produces an "f" stream for open & close events
                             <sec> specifies the flush interval (also see xfr)
+                            hist   - collects request size and offset
+                                     histograms per file and sends them
+                                     every <sec> via the iohist gstream
                             lfn    - adds lfn to the open event
                             ops    - adds the ops record when the file is closed
                             ssq    - computes the sum of squares for the ops rec
@@ -224,6 +234,7 @@ bool XrdXrootdProtocol::ConfigMon(XrdProtocol_Config *pi, XrdOucEnv &xrootdEnv)
          fstats             vectors the "f" stream to the destination
          info               monitors client appid and info requests.
          io                 monitors I/O requests, and files open/close events.
+         iohist             file access pattern histograms (see fstat hist)
          iov                like I/O but also unwinds vector reads.
          pfc                monitor proxy file cache
          redir              monitors request redirections
@@ -285,7 +296,8 @@ int XrdXrootdProtocol::xmon(XrdOucStream &Config)
                    if (XrdOuca2x::a2tm(eDest,"monitor fstat",val,
                                              &MP->monFSint,0)) return 1;
                    while((val = Config.GetWord()))
-                        if (!strcmp("lfn", val)) MP->monFSopt |=  XROOTD_MON_FSLFN;
+                        if (!strcmp("hist",val)) MP->monFSopt |=  XROOTD_MON_FSHST;
+                   else if (!strcmp("lfn", val)) MP->monFSopt |=  XROOTD_MON_FSLFN;
                    else if (!strcmp("ops", val)) MP->monFSopt |=  XROOTD_MON_FSOPS;
                    else if (!strcmp("ssq", val)) MP->monFSopt |=  XROOTD_MON_FSSSQ;
                    else if (!strcmp("xfr", val))
@@ -356,6 +368,7 @@ int XrdXrootdProtocol::xmon(XrdOucStream &Config)
               else if (!strcmp("http", val)) MP->monMode[i] |=  XROOTD_MON_HTTP;
               else if (!strcmp("info", val)) MP->monMode[i] |=  XROOTD_MON_INFO;
               else if (!strcmp("io",   val)) MP->monMode[i] |=  XROOTD_MON_IO;
+              else if (!strcmp("iohist",   val)) MP->monMode[i] |=  XROOTD_MON_IOHST;
               else if (!strcmp("iov",  val)) MP->monMode[i] |= (XROOTD_MON_IO
                                                                |XROOTD_MON_IOV);
               else if (!strcmp("pfc",      val)) MP->monMode[i] |=  XROOTD_MON_PFC;
@@ -453,7 +466,7 @@ char *XrdXrootdProtocol::xmondest(const char *what, char *val)
 
    Purpose:  Parse directive: mongstream <strm> use <opts>
 
-   <strm>:  {all | ccm | http | oss | pfc | tcpmon | tpc}  [<strm>]
+   <strm>:  {all | ccm | http | iohist | oss | pfc | tcpmon | tpc}  [<strm>]
 
    <opts>:  [flust <t>] [maxlen <l>] [send <fmt> [noident] <host:port>]
 
@@ -464,6 +477,7 @@ char *XrdXrootdProtocol::xmondest(const char *what, char *val)
          all                applies options to all gstreams.
          ccm                gstream: cache context management
          http               gstream: HTTP requests
+         iohist             gstream: file access pattern histograms
          pfc                gstream: proxy file cache
          tcpmon             gstream: tcp connection monitoring
          throttle           gstream: monitors I/O activity via the throttle plugin
@@ -489,7 +503,7 @@ int XrdXrootdProtocol::xmongs(XrdOucStream &Config)
 
    int numgs = sizeof(gsObj)/sizeof(struct XrdXrootdGSReal::GSParms);
    int selAll = XROOTD_MON_CCM | XROOTD_MON_HTTP | XROOTD_MON_PFC | XROOTD_MON_TCPMO
-              | XROOTD_MON_THROT | XROOTD_MON_TPC;
+              | XROOTD_MON_THROT | XROOTD_MON_TPC | XROOTD_MON_IOHST;
    int i, selMon = 0, opt = -1, hdr = -1, fmt = -1, flushVal = -1;
    long long maxlVal = -1;
    char *val, *dest = 0;
@@ -30,7 +30,9 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include "XrdOuc/XrdOucIOVec.hh"
 #include "XrdXrootd/XrdXrootdMonData.hh"
+#include "XrdXrootd/XrdXrootdMonHist.hh"
 
 class XrdXrootdFileStats
 {
@@ -49,6 +51,7 @@ struct {double      read;     // sum(read_size[i] **2) i = 1 to Ops.read
         double      rsegs;    // sum(readv_segs[i]**2) i = 1 to Ops.readv
         double      write;    // sum(write_size[i]**2) i = 1 to Ops.write
        }            ssq;
+XrdXrootdMonHist   *Hist;     // Set by mon: access pattern histograms or nil
 
 enum monLevel {monOff = 0, monOn = 1, monOps = 2, monSsq = 3};
 
@@ -60,6 +63,7 @@ enum monLevel {monOff = 0, monOn = 1, monOps = 2, monSsq = 3};
                  ops.rsMin = 0x7fff;
                  ops.rdMin = ops.rvMin = ops.wrMin = 0x7fffffff;
                  ssq.read  = ssq.readv = ssq.write = ssq.rsegs = 0.0;
+                 Hist = 0;
                 };
 
 inline void pgrOps(int rsz, bool isRetry=false)
@@ -99,6 +103,14 @@ inline void rdOps(int rsz)
                      }
                  }
 
+inline void rdHist(long long offs, int rsz)
+                  {if (Hist) Hist->Read(offs, rsz, fSize);}
+
+inline void rvHist(const XrdOucIOVec *rdV, int rdVnum)
+                  {if (Hist) for (int i = 0; i < rdVnum; i++)
+                                 Hist->Read(rdV[i].offset, rdV[i].size, fSize);
+                  }
+
 inline void rvOps(int rsz, int ssz)
                  {if (monLvl)
                      {xfr.readv += rsz; ops.readv++; ops.rsegs += ssz; xfrXeq=1;
@@ -130,6 +142,14 @@ inline void wrOps(int wsz)
                      }
                  }
 
+inline void wrHist(long long offs, int wsz)
+                  {if (Hist) Hist->Write(offs, wsz, fSize);}
+
+inline void wvHist(const XrdOucIOVec *wrV, int wrVnum)
+                  {if (Hist) for (int i = 0; i < wrVnum; i++)
+                                 Hist->Write(wrV[i].offset, wrV[i].size, fSize);
+                  }
+
 inline void wvOps(int wsz, int ssz) {wrOps(wsz);}
 /* !!! When we start reporting detail of writev's we will uncomment this
    !!! For now writev's are treated as single write, not correct but at least
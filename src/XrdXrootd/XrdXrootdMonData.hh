@@ -122,6 +122,7 @@ const kXR_char XROOTD_MON_GSTPC         = 'P'; // TPC Third Party Copy
 const kXR_char XROOTD_MON_GSTHR         = 'R'; // IO activity from the throttle plugin
 const kXR_char XROOTD_MON_GSOSS         = 'O'; // IO activity from a generic OSS plugin
 const kXR_char XROOTD_MON_GSHTP         = 'H'; // Request processing activity from HTTP protocol
+const kXR_char XROOTD_MON_GSIOH         = 'A'; // File access pattern histograms
 
 // The following bits are insert in the low order 4 bits of the MON_REDIRECT
 // entry code to indicate the actual operation that was requestded.
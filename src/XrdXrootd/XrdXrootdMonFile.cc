@@ -37,6 +37,7 @@
 
 #include "XrdXrootd/XrdXrootdMonFile.hh"
 #include "XrdXrootd/XrdXrootdFileStats.hh"
+#include "XrdXrootd/XrdXrootdMonHist.hh"
 
 /******************************************************************************/
 /*                               G l o b a l s                                */
@@ -76,6 +77,7 @@ int                  XrdXrootdMonFile::xfrRem   = 0;
 XrdXrootdMonFileXFR  XrdXrootdMonFile::xfrRec;
 short                XrdXrootdMonFile::crecNLen = 0;
 short                XrdXrootdMonFile::trecNLen = 0;
+char                 XrdXrootdMonFile::fsHST    = 0;
 char                 XrdXrootdMonFile::fsLFN    = 0;
 char                 XrdXrootdMonFile::fsLVL    = 0;
 char                 XrdXrootdMonFile::fsOPS    = 0;
@@ -106,6 +108,14 @@ void XrdXrootdMonFile::Close(XrdXrootdFileStats *fsP, bool isDisc)
        fmMutex.UnLock();
       }
 
+// Send the final histogram deltas as the reporter no longer sees this file
+//
+   if (fsP->Hist)
+      {XrdXrootdMonHist::Report(fsP, true);
+       delete fsP->Hist;
+       fsP->Hist = 0;
+      }
+
 // Insert a close record header (mostly precomputed)
 //
    cRec.Hdr.recType = XrdXrootdMonFileHdr::isClose;
@@ -191,6 +201,7 @@ void XrdXrootdMonFile::Defaults(int intv, int opts, int xfrcnt, int fbsz)
    fsLFN  = (opts &  XROOTD_MON_FSLFN) != 0;
    fsOPS  = (opts & (XROOTD_MON_FSOPS  | XROOTD_MON_FSSSQ)) != 0;
    fsSSQ  = (opts &  XROOTD_MON_FSSSQ) != 0;
+   fsHST  = (opts &  XROOTD_MON_FSHST) != 0;
 
 // Set monitoring level
 //
@@ -229,10 +240,11 @@ void XrdXrootdMonFile::Disc(unsigned int usrID)
 void XrdXrootdMonFile::DoIt()
 {
 
-// First check if we need to report all the I/O stats
+// First check if we need to report all the I/O stats. Histograms are
+// reported every interval.
 //
    xfrRem--;
-   if (!xfrRem) DoXFR();
+   if (!xfrRem || fsHST) DoXFR(!xfrRem);
 
 // Check if we should flush the buffer
 //
@@ -249,14 +261,14 @@ void XrdXrootdMonFile::DoIt()
 /* Private:                        D o X F R                                  */
 /******************************************************************************/
   
-void XrdXrootdMonFile::DoXFR()
+void XrdXrootdMonFile::DoXFR(bool doXfr)
 {
    XrdXrootdFileStats *fsP;
    int keep, i, n, hwm;
 
 // Reset interval counter
 //
-   xfrRem = xfrCnt;
+   if (doXfr) xfrRem = xfrCnt;
 
 // Grab the high watermark once
 //
@@ -273,7 +285,8 @@ void XrdXrootdMonFile::DoXFR()
            {n    = 0;
             keep = XrdXrootdMonFMap::fmHold;
             while((fsP = fmMap[i].Next(n)))
-                 {if (fsP->xfrXeq) DoXFR(fsP);
+                 {if (doXfr && fsP->xfrXeq) DoXFR(fsP);
+                  if (fsP->Hist) XrdXrootdMonHist::Report(fsP);
                   if (!keep--)
                      {fmMutex.UnLock();
                       keep = XrdXrootdMonFMap::fmHold;
@@ -283,6 +296,10 @@ void XrdXrootdMonFile::DoXFR()
            }
         fmMutex.UnLock();
        }
+
+// Send off whatever histograms were batched up
+//
+   if (fsHST) XrdXrootdMonHist::Flush();
 }
 
 /******************************************************************************/
@@ -326,6 +343,10 @@ bool XrdXrootdMonFile::Init()
    XrdXrootdMonFile *mfP;
    int alignment, pagsz = getpagesize();
 
+// Histograms need their g-stream, without it they are not collected
+//
+   if (fsHST && !XrdXrootdMonHist::Init()) fsHST = 0;
+
 // Allocate a socket buffer
 //
    alignment = (fBsz < pagsz ? 1024 : pagsz);
@@ -473,9 +494,9 @@ void XrdXrootdMonFile::Open(XrdXrootdFileStats *fsP, const char *Path,
 //
    if (fsP->FileID == 0) fsP->FileID = XrdXrootdMonitor::GetDictID();
 
-// Add this open to the map table if we are doing I/O stats.
+// Add this open to the map table if we are doing I/O stats or histograms.
 //
-   if (fsXFR)
+   if (fsXFR || fsHST)
       {fmMutex.Lock();
        for (i = 0; i < XrdXrootdMonFMap::mapNum; i++)
            if (fmUse[i] < XrdXrootdMonFMap::fmSize)
@@ -494,6 +515,7 @@ void XrdXrootdMonFile::Open(XrdXrootdFileStats *fsP, const char *Path,
    fsP->MonEnt = (sNum | (i << XrdXrootdMonFMap::fmShft)) & 0xffff;
    fsP->monLvl = fsLVL;
    fsP->xfrXeq = 0;
+   if (fsHST && sNum >= 0) fsP->Hist = new XrdXrootdMonHist;
 
 // Compute the size of this record
 //
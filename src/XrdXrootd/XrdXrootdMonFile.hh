@@ -61,7 +61,7 @@ static void Open(XrdXrootdFileStats *fsP,
 
 private:
 
-static void                 DoXFR();
+static void                 DoXFR(bool doXfr);
 static void                 DoXFR(XrdXrootdFileStats *fsP);
 static void                 Flush();
 static char                *GetSlot(int slotSZ);
@@ -89,6 +89,7 @@ static XrdXrootdMonFileXFR  xfrRec;
 static short                crecNLen;
 static short                trecNLen;
 static char                 fsLFN;
+static char                 fsHST;
 static char                 fsLVL;
 static char                 fsOPS;
 static char                 fsSSQ;
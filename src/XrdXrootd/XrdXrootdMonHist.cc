@@ -0,0 +1,292 @@
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d X r o o t d M o n H i s t . c c                    */
+/*                                                                            */
+/*                    (c) 2026 by the XRootD Collaboration                    */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+
+#include "XrdSys/XrdSysError.hh"
+
+#include "XrdXrootd/XrdXrootdFileStats.hh"
+#include "XrdXrootd/XrdXrootdGStream.hh"
+#include "XrdXrootd/XrdXrootdMonHist.hh"
+
+/******************************************************************************/
+/*                               G l o b a l s                                */
+/******************************************************************************/
+
+namespace XrdXrootdMonInfo
+{
+extern XrdSysError  *eDest;
+}
+
+/******************************************************************************/
+/*                         L o c a l   S t a t i c s                          */
+/******************************************************************************/
+
+namespace
+{
+// Largest possible record: file id, flags, size and for reads as well as
+// writes the ops, seq, both masks and all the bins as 5 byte varints.
+//
+const int recMax = 4 + 1 + 10 + 2*(5 + 5 + 2 + 5*16 + 2 + 5*16);
+
+// Room left in a g-stream buffer for its header and for the json wrapper.
+//
+const int gsHdrRoom  = 512;
+const int jsonRoom   = 128;
+
+char *PutVar(char *bP, unsigned long long val)
+{
+   while(val >= 0x80) {*bP++ = static_cast<char>(val | 0x80); val >>= 7;}
+   *bP++ = static_cast<char>(val);
+   return bP;
+}
+
+int ToB64(const unsigned char *in, int ilen, char *out)
+{
+   static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                             "abcdefghijklmnopqrstuvwxyz0123456789+/";
+   char *oP = out;
+   int i;
+
+   for (i = 0; i+2 < ilen; i += 3)
+       {*oP++ = b64[in[i] >> 2];
+        *oP++ = b64[((in[i] & 0x03) << 4) | (in[i+1] >> 4)];
+        *oP++ = b64[((in[i+1] & 0x0f) << 2) | (in[i+2] >> 6)];
+        *oP++ = b64[in[i+2] & 0x3f];
+       }
+   if (i < ilen)
+      {*oP++ = b64[in[i] >> 2];
+       if (i+1 < ilen)
+          {*oP++ = b64[((in[i] & 0x03) << 4) | (in[i+1] >> 4)];
+           *oP++ = b64[(in[i+1] & 0x0f) << 2];
+          } else {
+           *oP++ = b64[(in[i] & 0x03) << 4];
+           *oP++ = '=';
+          }
+       *oP++ = '=';
+      }
+   return oP - out;
+}
+}
+
+/******************************************************************************/
+/*                        S t a t i c   M e m b e r s                         */
+/******************************************************************************/
+
+XrdSysMutex          XrdXrootdMonHist::hsMutex;
+XrdXrootdGStream    *XrdXrootdMonHist::hsStream = 0;
+char                *XrdXrootdMonHist::rawBuff  = 0;
+char                *XrdXrootdMonHist::zipBuff  = 0;
+char                *XrdXrootdMonHist::lineBuff = 0;
+int                  XrdXrootdMonHist::rawLen   = 0;
+int                  XrdXrootdMonHist::rawMax   = 0;
+int                  XrdXrootdMonHist::zipMax   = 0;
+int                  XrdXrootdMonHist::lineMax  = 0;
+int                  XrdXrootdMonHist::numRecs  = 0;
+
+/******************************************************************************/
+/* Private:                         E m i t                                   */
+/******************************************************************************/
+
+void XrdXrootdMonHist::Emit() // hsMutex must be held
+{
+   uLongf zlen = zipMax;
+   int n;
+
+// Compress the batch. The buffers were sized so that this always fits, but
+// should zlib still fail we simply drop the batch.
+//
+   if (compress2((Bytef *)zipBuff, &zlen, (const Bytef *)rawBuff, rawLen,
+                 Z_DEFAULT_COMPRESSION) == Z_OK)
+      {n = snprintf(lineBuff, jsonRoom, "{\"event\":\"iohist\",\"v\":1,"
+                    "\"nrec\":%d,\"len\":%d,\"zlib\":\"", numRecs, rawLen);
+       n += ToB64((const unsigned char *)zipBuff, static_cast<int>(zlen),
+                  lineBuff+n);
+       lineBuff[n++] = '"'; lineBuff[n++] = '}'; lineBuff[n++] = 0;
+       hsStream->Insert(lineBuff, n);
+      }
+
+// Start a new batch
+//
+   rawLen = numRecs = 0;
+}
+
+/******************************************************************************/
+/* Private:                       E n c o d e                                 */
+/******************************************************************************/
+
+int XrdXrootdMonHist::Encode(char *bP, Bins &rep, const Bins &now)
+{
+   char *sP = bP, *mP;
+   unsigned int cnt, mask;
+
+// Nothing is added when there was no activity since the last report
+//
+   if (now.Ops == rep.Ops) return 0;
+
+// Insert the request and sequential counts
+//
+   bP = PutVar(bP, now.Ops - rep.Ops);
+   bP = PutVar(bP, now.Seq - rep.Seq);
+
+// Insert the size bins that changed, preceded by their mask
+//
+   mP = bP; bP += 2; mask = 0;
+   for (int i = 0; i < szBins; i++)
+       if ((cnt = now.Sz[i] - rep.Sz[i]))
+          {bP = PutVar(bP, cnt); mask |= 1 << i;}
+   mP[0] = static_cast<char>(mask >> 8); mP[1] = static_cast<char>(mask);
+
+// Same for the offset bins
+//
+   mP = bP; bP += 2; mask = 0;
+   for (int i = 0; i < ofBins; i++)
+       if ((cnt = now.Of[i] - rep.Of[i]))
+          {bP = PutVar(bP, cnt); mask |= 1 << i;}
+   mP[0] = static_cast<char>(mask >> 8); mP[1] = static_cast<char>(mask);
+
+// What we have is now reported
+//
+   rep = now;
+   return bP - sP;
+}
+
+/******************************************************************************/
+/*                                 F l u s h                                  */
+/******************************************************************************/
+
+void XrdXrootdMonHist::Flush()
+{
+   XrdSysMutexHelper hsHelp(hsMutex);
+
+// Histograms are sent every fstat interval, just like the f-stream itself
+//
+   if (rawLen)
+      {Emit();
+       hsStream->Flush();
+      }
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+
+bool XrdXrootdMonHist::Init()
+{
+
+// We need a g-stream to send histograms
+//
+   if (!hsStream)
+      {XrdXrootdMonInfo::eDest->Say("Config warning: 'fstat hist' ignored; "
+                                    "iohist gstream not enabled.");
+       return false;
+      }
+
+// The largest record must fit in a batch
+//
+   if (rawMax < recMax)
+      {XrdXrootdMonInfo::eDest->Say("Config warning: 'fstat hist' ignored; "
+                                    "iohist gstream maxlen is too small.");
+       return false;
+      }
+
+// Allocate the buffers
+//
+   rawBuff  = (char *)malloc(rawMax);
+   zipBuff  = (char *)malloc(zipMax);
+   lineBuff = (char *)malloc(lineMax);
+   return rawBuff && zipBuff && lineBuff;
+}
+
+/******************************************************************************/
+/*                                R e p o r t                                 */
+/******************************************************************************/
+
+void XrdXrootdMonHist::Report(XrdXrootdFileStats *fsP, bool isClose)
+{
+   XrdXrootdMonHist *hP = fsP->Hist;
+   Bins  now;
+   char  rec[recMax], *bP, *fP;
+   int   n;
+
+// Insert the file id and reserve room for the flags
+//
+   memcpy(rec, &fsP->FileID, sizeof(fsP->FileID));
+   fP  = rec + sizeof(fsP->FileID);
+  *fP  = (isClose ? 0x04 : 0);
+   bP  = PutVar(fP+1, static_cast<unsigned long long>(fsP->fSize));
+
+// Add whatever changed. We take a snapshot as the counts are being updated
+// while we look at them.
+//
+   now = hP->Now[0];
+   if ((n = Encode(bP, hP->Rep[0], now))) {*fP |= 0x01; bP += n;}
+   now = hP->Now[1];
+   if ((n = Encode(bP, hP->Rep[1], now))) {*fP |= 0x02; bP += n;}
+
+// If nothing happened there is nothing to report unless this is the close of
+// a file that had some I/O.
+//
+   if (!(*fP & 0x03)
+   &&  !(isClose && (hP->Now[0].Ops || hP->Now[1].Ops))) return;
+
+// Add this record to the batch, sending the batch if it's full
+//
+   n = bP - rec;
+   hsMutex.Lock();
+   if (rawLen + n > rawMax) Emit();
+   memcpy(rawBuff+rawLen, rec, n);
+   rawLen += n;
+   numRecs++;
+   hsMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                             S e t S t r e a m                              */
+/******************************************************************************/
+
+void XrdXrootdMonHist::SetStream(XrdXrootdGStream *gs, int maxlen)
+{
+
+// A zero length means the g-stream uses its default buffer size. Records
+// must fit in the buffer alongside the g-stream header.
+//
+   if (maxlen <= 0) maxlen = 32768;
+   if (maxlen > XrdXrootdGStream::MaxDataLen)
+      maxlen = XrdXrootdGStream::MaxDataLen;
+   lineMax = maxlen - gsHdrRoom;
+
+// Size the batch so that even an incompressible one still fits once base64
+// encoded (compressBound() adds a bit over a tenth of a percent).
+//
+   zipMax   = (lineMax - jsonRoom) / 4 * 3;
+   rawMax   = zipMax - (zipMax >> 9) - 16;
+   hsStream = gs;
+}
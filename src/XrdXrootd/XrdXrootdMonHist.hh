@@ -0,0 +1,133 @@
+#ifndef __XRDXROOTDMONHIST__
+#define __XRDXROOTDMONHIST__
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d X r o o t d M o n H i s t . h h                    */
+/*                                                                            */
+/*                    (c) 2026 by the XRootD Collaboration                    */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <cstring>
+
+#include "XProtocol/XPtypes.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdXrootdFileStats;
+class XrdXrootdGStream;
+
+// Access pattern histograms of an open file. They are allocated when the file
+// is opened with "monitor fstat ... hist" in effect and are updated by the
+// thread doing the I/O without any locking, just like the other file stats.
+// Each fstat interval the reporter turns them into deltas, appends a compact
+// binary record per active file to a batch and sends the batch, deflated and
+// base64 encoded, as a single line via the "iohist" g-stream:
+//
+// {"event":"iohist","v":1,"nrec":<n>,"len":<rawlen>,"zlib":"<base64>"}
+//
+// The inflated batch is a sequence of records, all integers are unsigned
+// LEB128 varints unless noted otherwise:
+//
+// <fileid:4 bytes as in the f-stream> <flags:1> <fsize>
+//   [<ops> <seq> <szmask:2 bytes> <count>... <ofmask:2 bytes> <count>...]
+//   [same for writes]
+//
+// flags 0x01 means read data follows, 0x02 write data follows (after the
+// read data, if any) and 0x04 that the file was closed. A mask bit i set
+// means bin i had a non-zero count, the counts follow in bin order. Size bin
+// i holds requests of at most 1K << i bytes, the last one all larger ones.
+// Offset bin i holds requests starting in the i'th sixteenth of the file
+// size at open time (the last one anything beyond); when the file was empty
+// all of them go to bin 0. "seq" counts requests that started where the
+// previous one of the same kind ended.
+
+class XrdXrootdMonHist
+{
+public:
+
+static const int szBins = 16;
+static const int ofBins = 16;
+
+struct Bins {kXR_unt32 Sz[szBins];  // Requests by size
+             kXR_unt32 Of[ofBins];  // Requests by starting offset
+             kXR_unt32 Ops;         // Number of requests
+             kXR_unt32 Seq;         // Requests continuing the previous one
+            };
+
+inline void Read(long long offs, int len, long long fsz)
+                {Add(Now[0], rdNext, offs, len, fsz);}
+
+inline void Write(long long offs, int len, long long fsz)
+                {Add(Now[1], wrNext, offs, len, fsz);}
+
+static void Flush();
+
+static bool Init();
+
+static void Report(XrdXrootdFileStats *fsP, bool isClose=false);
+
+static void SetStream(XrdXrootdGStream *gs, int maxlen);
+
+            XrdXrootdMonHist() : rdNext(0), wrNext(0)
+                               {memset(Now, 0, sizeof(Now));
+                                memset(Rep, 0, sizeof(Rep));
+                               }
+           ~XrdXrootdMonHist() {}
+
+private:
+
+inline void Add(Bins &bins, long long &next, long long offs, int len,
+                long long fsz)
+               {unsigned int n = (len > 0 ? static_cast<unsigned int>(len-1)
+                                           : 0) >> 10;
+                int i = 0;
+                while(n && i < szBins-1) {n >>= 1; i++;}
+                bins.Sz[i]++;
+                if (fsz <= 0 || offs < 0) i = 0;
+                   else if (offs >= fsz) i = ofBins-1;
+                           else i = static_cast<int>(offs*ofBins/fsz);
+                bins.Of[i]++;
+                bins.Ops++;
+                if (offs == next) bins.Seq++;
+                next = offs + len;
+               }
+
+static void Emit();
+static int  Encode(char *bP, Bins &rep, const Bins &now);
+
+static XrdSysMutex       hsMutex;
+static XrdXrootdGStream *hsStream;
+static char             *rawBuff;
+static char             *zipBuff;
+static char             *lineBuff;
+static int               rawLen;
+static int               rawMax;
+static int               zipMax;
+static int               lineMax;
+static int               numRecs;
+
+Bins      Now[2];  // Read and write counts, updated by the I/O thread
+Bins      Rep[2];  // What has been reported so far, used by the reporter
+long long rdNext;
+long long wrNext;
+};
+#endif
@@ -62,12 +62,14 @@
 #define XROOTD_MON_THROT 0x00002000
 #define XROOTD_MON_OSS   0x00004000
 #define XROOTD_MON_HTTP  0x00008000
-#define XROOTD_MON_GSTRM (XROOTD_MON_CCM | XROOTD_MON_PFC | XROOTD_MON_TCPMO | XROOTD_MON_THROT | XROOTD_MON_OSS | XROOTD_MON_HTTP)
+#define XROOTD_MON_IOHST 0x00010000
+#define XROOTD_MON_GSTRM (XROOTD_MON_CCM | XROOTD_MON_PFC | XROOTD_MON_TCPMO | XROOTD_MON_THROT | XROOTD_MON_OSS | XROOTD_MON_HTTP | XROOTD_MON_IOHST)
 
 #define XROOTD_MON_FSLFN    1
 #define XROOTD_MON_FSOPS    2
 #define XROOTD_MON_FSSSQ    4
 #define XROOTD_MON_FSXFR    8
+#define XROOTD_MON_FSHST   16
 
 class XrdScheduler;
 class XrdNetMsg;
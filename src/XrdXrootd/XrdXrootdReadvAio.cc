@@ -0,0 +1,433 @@
+/******************************************************************************/
+/*                                                                            */
+/*                  X r d X r o o t d R e a d v A i o . c c                   */
+/*                                                                            */
+/*                    (c) 2026 by the XRootD Collaboration                    */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "XProtocol/XProtocol.hh"
+#include "Xrd/XrdLink.hh"
+#include "Xrd/XrdScheduler.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysPlatform.hh"
+#include "XrdXrootd/XrdXrootdAioBuff.hh"
+#include "XrdXrootd/XrdXrootdAioFob.hh"
+#include "XrdXrootd/XrdXrootdFile.hh"
+#include "XrdXrootd/XrdXrootdReadvAio.hh"
+#include "XrdXrootd/XrdXrootdTrace.hh"
+
+#define TRACELINK dataLink
+ 
+/******************************************************************************/
+/*                        G l o b a l   S t a t i c s                         */
+/******************************************************************************/
+
+extern XrdSysTrace  XrdXrootdTrace;
+
+namespace XrdXrootd
+{
+extern XrdSysError   eLog;
+extern XrdScheduler *Sched;
+}
+using namespace XrdXrootd;
+  
+/******************************************************************************/
+/*                       S t a t i c   M e m e b e r s                        */
+/******************************************************************************/
+
+const char *XrdXrootdReadvAio::TraceID = "ReadvAio";
+  
+/******************************************************************************/
+/*                         L o c a l   S t a t i c s                          */
+/******************************************************************************/
+
+namespace
+{
+XrdSysMutex        fqMutex;
+XrdXrootdReadvAio *fqFirst = 0;
+int                numFree = 0;
+
+static const int   maxKeep = 64; // Keep in reserve
+static const int   hdrSZ   = sizeof(readahead_list);
+}
+
+/******************************************************************************/
+/*                                 A l l o c                                  */
+/******************************************************************************/
+  
+XrdXrootdReadvAio *XrdXrootdReadvAio::Alloc(XrdXrootdProtocol *protP,
+                                            XrdXrootdResponse &resp,
+                                            XrdXrootdFile     *fP)
+{
+   XrdXrootdReadvAio *reqP;
+
+// Obtain a preallocated aio request object
+//
+   fqMutex.Lock();
+   if ((reqP = fqFirst))
+      {fqFirst = reqP->nextRdv;
+       numFree--;
+      }
+   fqMutex.UnLock();
+
+// If we have no object, create a new one
+//
+   if (!reqP) reqP = new XrdXrootdReadvAio;
+
+// Initialize the object and return it
+//
+   reqP->Init(protP, resp, fP);
+   reqP->nextRdv = 0;
+   return reqP;
+}
+  
+/******************************************************************************/
+/* Private:                      C o p y F 2 L                                */
+/******************************************************************************/
+  
+void XrdXrootdReadvAio::CopyF2L()
+{
+   XrdXrootdAioBuff *aioP;
+   rvGroup *gP;
+   int grpNum = rvGrp.size();
+
+// Keep as many groups being read as we are allowed while sending the ones
+// that have completed in order. Groups may complete out of order.
+//
+do{while(!isDone && grpNext < grpNum
+         && inFlight < XrdXrootdProtocol::as_maxperreq) if (!Issue()) break;
+
+   if (isDone || !(aioP = getBuff(true))) break;
+
+// Step 1: do some tracing
+//
+   gP = &rvGrp[aioP->sfsAio.aio_offset];
+   TRACEP(FSAIO,"aioV end "<<gP->dlen<<'@'<<rvVec[gP->first].offset
+              <<" result="<<aioP->Result
+              <<" D-S="<<isDone<<'-'<<int(Status)<<" inF="<<int(inFlight));
+
+// Step 2: Validate this group. Anything short of the full amount means we
+//         ran past the end of the file which is an error for readv.
+//
+   if (aioP->Result != gP->dlen)
+      {if (aioP->Result < 0) SendFSError(aioP->Result);
+          else SendError(ENODATA, "readv past EOF");
+       aioP->Recycle();
+       gP->aioP = 0;
+       continue;
+      }
+   gP->ready = true;
+
+// Step 3: Send all groups that are now eligible to be sent
+//
+   while(!isDone && grpSend < grpNum && rvGrp[grpSend].ready)
+        Send(&rvGrp[grpSend++]);
+
+  } while(!isDone && grpSend < grpNum);
+
+// If we are here without having sent the final frame, something went wrong
+// and the client must be told.
+//
+   if (!isDone)
+      {char ebuff[80];
+       snprintf(ebuff, sizeof(ebuff), "aio readv failed at segment group %d; "
+                "missing data", grpSend);
+       SendError(ENODEV, ebuff);
+      }
+
+// Cleanup any groups that were read but never sent
+//
+   for (int i = grpSend; i < grpNext; i++)
+       {if (rvGrp[i].ready)
+           {rvGrp[i].aioP->Recycle();
+            rvGrp[i].aioP  = 0;
+            rvGrp[i].ready = false;
+           }
+       }
+
+// If we encountered a fatal link error then cancel any pending aio reads on
+// this link. Otherwise if we have not yet scheduled the next aio, do so.
+//
+   if (aioState & aioDead) dataFile->aioFob->Reset(Protocol);
+      else if (!(aioState & aioSchd)) dataFile->aioFob->Schedule(Protocol);
+
+// Groups still being read are reaped by Drain() or, failing that, in the
+// background by Completed(). Otherwise, recycle.
+//
+   if (!inFlight) Recycle(true);
+      else Recycle(Drain());
+}
+  
+/******************************************************************************/
+/* Private:                      C o p y L 2 F                                */
+/******************************************************************************/
+
+// Readv tasks only copy from the file to the link.
+  
+int XrdXrootdReadvAio::CopyL2F() {return 0;}
+
+bool XrdXrootdReadvAio::CopyL2F(XrdXrootdAioBuff *aioP)
+{
+   aioP->Recycle();
+   return false;
+}
+  
+/******************************************************************************/
+/*                                  D o I t                                   */
+/******************************************************************************/
+
+void XrdXrootdReadvAio::DoIt()
+{
+// Reads run disconnected as they will never read from the link.
+//
+   if (aioState & aioRead) CopyF2L();
+}
+
+/******************************************************************************/
+/* Private:                         I s s u e                                 */
+/******************************************************************************/
+
+bool XrdXrootdReadvAio::Issue()
+{
+   rvGroup *gP = &rvGrp[grpNext];
+   struct readahead_list respHdr;
+   char *buffp;
+
+// Get a buffer large enough for the whole response frame. If we can't get
+// one we will try again when one of the groups in flight comes back.
+//
+   if (!(gP->aioP = XrdXrootdAioBuff::Alloc(this, rvQuantum)))
+      {if (!inFlight) SendError(ENOMEM, "insufficient memory");
+       return false;
+      }
+
+// Lay out the frame: each element's data follows its response header and
+// is read directly into place.
+//
+   buffp = (char *)gP->aioP->sfsAio.aio_buf;
+   memcpy(respHdr.fhandle, &rvFH, sizeof(respHdr.fhandle));
+   for (int i = gP->first; i < gP->first + gP->num; i++)
+       {respHdr.rlen   = htonl(rvVec[i].size);
+        respHdr.offset = htonll(rvVec[i].offset);
+        memcpy(buffp, &respHdr, hdrSZ);
+        rvVec[i].data = buffp + hdrSZ;
+        buffp += rvVec[i].size + hdrSZ;
+       }
+   gP->aioP->sfsAio.aio_offset = grpNext;  // Group index, not a file offset
+   gP->ready = false;
+
+// Hand the group off to be read
+//
+   inFlight++;
+   TRACEP(FSAIO, "aioV beg " <<gP->dlen <<'@' <<rvVec[gP->first].offset
+                 <<" segs=" <<gP->num <<" inF=" <<int(inFlight));
+   grpNext++;
+   Sched->Schedule(gP);
+
+// If all groups are being read, allow the next aio on this path to start
+//
+   if (grpNext >= (int)rvGrp.size())
+      {dataFile->aioFob->Schedule(Protocol);
+       aioState |= aioSchd;
+      }
+   return true;
+}
+
+/******************************************************************************/
+/*                                  R e a d                                   */
+/******************************************************************************/
+
+// Readv tasks are started by ReadV(); this is a logic error.
+
+void XrdXrootdReadvAio::Read(long long offs, int dlen)
+{
+   eLog.Emsg("ReadvAio", "invalid read request for",
+                         dataLink->ID, dataFile->FileKey);
+   aioState |= aioHeld;
+   Recycle(true);
+}
+
+/******************************************************************************/
+/* Private:                     R e a d G r o u p                             */
+/******************************************************************************/
+
+// Runs on a scheduler thread for each group.
+
+void XrdXrootdReadvAio::ReadGroup(rvGroup *gP)
+{
+   XrdXrootdAioBuff *aioP = gP->aioP;
+
+// Read all of the group's elements unless the request has already failed
+//
+   if (isDone) aioP->Result = 0;
+      else aioP->Result = dataFile->XrdSfsp->readv(&rvVec[gP->first], gP->num);
+
+// Tell the request this data is available to be sent to the client
+//
+   Completed(aioP);
+}
+
+/******************************************************************************/
+/*                                 R e a d V                                  */
+/******************************************************************************/
+
+void XrdXrootdReadvAio::ReadV(const XrdOucIOVec *rdVec, int rdVnum,
+                              int quantum)
+{
+   int Qleft = 0;
+
+// Copy the vector and split it into groups just as the synchronous readv
+// does so the client sees the same response frames.
+//
+   rvVec.assign(rdVec, rdVec + rdVnum);
+   rvGrp.clear();
+   rvGrp.reserve(rdVnum);
+   dataLen = 0;
+   for (int i = 0; i < rdVnum; i++)
+       {if (rvGrp.empty() || Qleft < rvVec[i].size + hdrSZ)
+           {rvGrp.emplace_back();
+            rvGroup &g = rvGrp.back();
+            g.reqP  = this;
+            g.aioP  = 0;
+            g.first = i;
+            g.num   = g.dlen = g.rlen = 0;
+            g.ready = false;
+            Qleft   = quantum;
+           }
+        rvGroup &g = rvGrp.back();
+        g.num++;
+        g.dlen += rvVec[i].size;
+        g.rlen += rvVec[i].size + hdrSZ;
+        Qleft  -= rvVec[i].size + hdrSZ;
+        dataLen += rvVec[i].size;
+       }
+
+// Setup the copy from the file to the network
+//
+   grpNext    = grpSend = 0;
+   rvQuantum  = quantum;
+   rvFH       = rdVec[0].info;
+   dataOffset = rdVec[0].offset;
+   highOffset = 0;
+   aioState   = aioRead;
+
+// Reads run disconnected and are self-terminating, so we need to increase the
+// refcount for the link we will be using to prevent it from disapearing.
+// Recycle will decrement it. We always update the file refcount and increase
+// the request count.
+//
+   dataLink->setRef(1);
+   dataFile->Ref(1);
+   Protocol->aioUpdReq(1);
+
+// Schedule ourselves to run this asynchronously and return
+//
+   dataFile->aioFob->Schedule(this);
+}
+  
+/******************************************************************************/
+/*                               R e c y c l e                                */
+/******************************************************************************/
+
+void XrdXrootdReadvAio::Recycle(bool release)
+{
+// Update request count, file and link reference count
+//
+   if (!(aioState & aioHeld))
+      {Protocol->aioUpdReq(-1);
+       if (aioState & aioRead)
+          {dataFile->Ref(-1);
+           dataLink->setRef(-1);
+          }
+       aioState |= aioHeld;
+      }
+
+// Do some tracing
+//
+   TRACEP(FSAIO,"aioV recycle"<<(release ? "" : " hold")
+                <<"; groups="<<rvGrp.size()<<" D-S="<<isDone<<'-'<<int(Status));
+
+// Place the object on the free queue if possible
+//
+   if (release)
+      {fqMutex.Lock();
+       if (numFree >= maxKeep)
+          {fqMutex.UnLock();
+           delete this;
+          } else {
+           nextRdv = fqFirst;
+           fqFirst = this;
+           numFree++;
+           fqMutex.UnLock();
+          }
+      }
+}
+
+/******************************************************************************/
+/* Private:                         S e n d                                   */
+/******************************************************************************/
+
+bool XrdXrootdReadvAio::Send(rvGroup *gP)
+{
+   bool final = (gP == &rvGrp.back());
+   XResponseType code = (final ? kXR_ok : kXR_oksofar);
+   int rc;
+
+// Send the frame and release its buffer
+//
+   rc = Response.Send(code, (void *)gP->aioP->sfsAio.aio_buf, gP->rlen);
+   gP->aioP->Recycle();
+   gP->aioP  = 0;
+   gP->ready = false;
+   dataLen  -= gP->dlen;
+
+// Diagnose any errors
+//
+   if (rc || final)
+      {isDone = true;
+       dataLen = 0;
+       if (rc) aioState |= aioDead;
+      }
+   return rc == 0;
+}
+
+/******************************************************************************/
+/*                                 W r i t e                                  */
+/******************************************************************************/
+
+// Readv tasks never write; this is a logic error.
+
+int XrdXrootdReadvAio::Write(long long offs, int dlen)
+{
+   eLog.Emsg("ReadvAio", "invalid write request for",
+                         dataLink->ID, dataFile->FileKey);
+   aioState |= aioHeld;
+   Recycle(true);
+   return -1;
+}
@@ -0,0 +1,102 @@
+#ifndef __XRDXROOTDREADVAIO_H__
+#define __XRDXROOTDREADVAIO_H__
+/******************************************************************************/
+/*                                                                            */
+/*                  X r d X r o o t d R e a d v A i o . h h                   */
+/*                                                                            */
+/*                    (c) 2026 by the XRootD Collaboration                    */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <vector>
+
+#include "Xrd/XrdJob.hh"
+#include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdXrootd/XrdXrootdAioTask.hh"
+
+class XrdXrootdAioBuff;
+class XrdXrootdFile;
+
+// A readv request is split into segment groups exactly as the synchronous
+// path does it: each group holds as many whole elements (with their response
+// headers) as fit in one transfer unit and becomes one response frame. Up to
+// as_maxperreq groups are read at the same time, each by a scheduler thread
+// calling the file's readv(), while this task sends the completed groups to
+// the client in order. Thus storage reads of later groups overlap the network
+// sends of earlier ones. Only readv requests that refer to a single file are
+// handled here.
+
+class XrdXrootdReadvAio : public XrdXrootdAioTask
+{
+public:
+
+static XrdXrootdReadvAio *Alloc(XrdXrootdProtocol *protP,
+                                XrdXrootdResponse &resp,
+                                XrdXrootdFile     *fP);
+
+       void               DoIt() override;
+
+       void               Read(long long offs, int dlen) override;
+
+       void               ReadV(const XrdOucIOVec *rdVec, int rdVnum,
+                                int quantum);
+
+       void               Recycle(bool release) override;
+
+       int                Write(long long offs, int dlen) override;
+
+private:
+
+struct rvGroup : public XrdJob
+      {XrdXrootdReadvAio *reqP;
+       XrdXrootdAioBuff  *aioP;       // Buffer holding the response frame
+       int                first;      // Index of first element in rvVec
+       int                num;        // Number of elements
+       int                dlen;       // Bytes of data to be read
+       int                rlen;       // Bytes in the frame (data + headers)
+       bool               ready;      // Read completed, waiting to be sent
+
+       void               DoIt() override {reqP->ReadGroup(this);}
+
+                          rvGroup() : XrdJob("readv group") {}
+      };
+
+         XrdXrootdReadvAio() : XrdXrootdAioTask("aio readv request") {}
+virtual ~XrdXrootdReadvAio() {}
+
+       void               CopyF2L() override;
+       int                CopyL2F() override;
+       bool               CopyL2F(XrdXrootdAioBuff *aioP) override;
+       bool               Issue();
+       void               ReadGroup(rvGroup *gP);
+       bool               Send(rvGroup *gP);
+
+static const char        *TraceID;
+
+std::vector<XrdOucIOVec>  rvVec;      // Elements with data -> frame buffers
+std::vector<rvGroup>      rvGrp;      // Segment groups in response order
+       int                grpNext;    // Next group to be read
+       int                grpSend;    // Next group to be sent
+       int                rvQuantum;  // Frame buffer size
+       int                rvFH;       // File handle for the response headers
+};
+#endif
@@ -67,6 +67,7 @@
 #include "XrdXrootd/XrdXrootdPio.hh"
 #include "XrdXrootd/XrdXrootdPrepare.hh"
 #include "XrdXrootd/XrdXrootdProtocol.hh"
+#include "XrdXrootd/XrdXrootdReadvAio.hh"
 #include "XrdXrootd/XrdXrootdRedirPI.hh"
 #include "XrdXrootd/XrdXrootdStats.hh"
 #include "XrdXrootd/XrdXrootdTrace.hh"
@@ -2554,12 +2555,14 @@ int XrdXrootdProtocol::do_Read()
 // Short circuit processing if read length is zero
 //
    if (!IO.IOLen) return Response.Send();
+   IO.File->Stats.rdHist(IO.Offset, IO.IOLen);
 
 // There are many competing ways to accomplish a read. Pick the one we
 // will use and if possible, do a fast dispatch.
 //
         if (IO.File->isMMapped) IO.Mode = XrdXrootd::IOParms::useMMap;
-   else if (IO.File->sfEnabled && !isTLS && IO.IOLen >= as_minsfsz
+   else if (IO.File->sfEnabled && (!isTLS || Link->hasKTLS())
+        &&  IO.IOLen >= as_minsfsz
         &&  IO.Offset+IO.IOLen <= IO.File->Stats.fSize)
            IO.Mode = XrdXrootd::IOParms::useSF;
    else if (IO.File->AsyncMode && IO.IOLen >= as_miniosz
@@ -2789,6 +2792,37 @@ int XrdXrootdProtocol::do_ReadV()
 //
    Quantum = totSZ < maxTransz ? totSZ : maxTransz;
 
+// Use asynchronous I/O if the readv refers to a single file that allows it,
+// it needs more than one response frame, and there are not too many async
+// operations in flight. Reads of later frames then overlap sending earlier
+// ones. Statistics are recorded up front as they are for async reads.
+//
+   if (totSZ > Quantum && totSZ >= as_miniosz
+   &&  linkAioReq < as_maxperlnk && srvrAioOps < as_maxpersrv
+   &&  FTab && (IO.File = FTab->Get(rdVec[0].info)) && IO.File->AsyncMode)
+      {for (i = 1; i < rdVBreak && rdVec[i].info == rdVec[0].info; i++) {}
+       if (i == rdVBreak)
+          {XrdXrootdReadvAio *aioP;
+           rvSeq++;
+           rdVXfr = totSZ - rdVecLen;
+           IO.File->Stats.rvOps(rdVXfr, rdVBreak);
+           IO.File->Stats.rvHist(rdVec, rdVBreak);
+           if (rvMon)
+              {Monitor.Agent->Add_rv(IO.File->Stats.FileID, htonl(rdVXfr),
+                                             htons(rdVBreak), rvSeq, vType);
+               if (ioMon) for (k = 0; k < rdVBreak; k++)
+                   Monitor.Agent->Add_rd(IO.File->Stats.FileID,
+                           htonl(rdVec[k].size), htonll(rdVec[k].offset));
+              }
+           TRACEP(FSIO,"fh=" <<rdVec[0].info <<" aio readV " <<rdVXfr
+                       <<" segs=" <<rdVBreak);
+           aioP = XrdXrootdReadvAio::Alloc(this, Response, IO.File);
+           if (!IO.File->aioFob) IO.File->aioFob = new XrdXrootdAioFob;
+           aioP->ReadV(rdVec, rdVBreak, Quantum);
+           return 0;
+          }
+      }
+
 // Now obtain the right size buffer
 //
    if ((Quantum < halfBSize && Quantum > 1024) || Quantum > argp->bsize)
@@ -2822,6 +2856,7 @@ int XrdXrootdProtocol::do_ReadV()
             if (xfrSZ != rdVAmt) break;
             rdVNum = i - rdVBeg; rdVXfr += rdVAmt;
             IO.File->Stats.rvOps(rdVXfr, rdVNum);
+            IO.File->Stats.rvHist(&rdVec[rdVBeg], rdVNum);
             if (rvMon)
                {Monitor.Agent->Add_rv(IO.File->Stats.FileID, htonl(rdVXfr),
                                               htons(rdVNum), rvSeq, vType);
@@ -3316,6 +3351,7 @@ int XrdXrootdProtocol::do_Write()
 //
    if (!IO.IOLen) return Response.Send();
    IO.File->Stats.wrOps(IO.IOLen); // Optimistically correct
+   IO.File->Stats.wrHist(IO.Offset, IO.IOLen);
 
 // If async write allowed and it is a true write request (e.g. not chkpoint) and
 // current conditions permit async; schedule the write to occur asynchronously
@@ -3551,6 +3587,7 @@ int XrdXrootdProtocol::do_WriteSpan()
       Monitor.Agent->Add_wr(IO.File->Stats.FileID, Request.write.dlen,
                                                   Request.write.offset);
    IO.File->Stats.wrOps(IO.IOLen); // Optimistically correct
+   IO.File->Stats.wrHist(IO.Offset, IO.IOLen);
 
 // Trace this entry
 //
@@ -3748,6 +3785,7 @@ do{if (IO.IOLen > 0)
    if (done || newfile)
       {int monVnum = vNow - wvInfo->vMon;
        IO.File->Stats.wvOps(IO.WVBytes, monVnum);
+       IO.File->Stats.wvHist(&(wvInfo->wrVec[wvInfo->vMon]), monVnum);
 /*!!   if (wvMon)
           {Monitor.Agent->Add_wv(IO.File->Stats.FileID, htonl(IO.WVBytes),
                                  htons(monVNum), wvSeq++, wvInfo->vType);
@@ -158,6 +158,7 @@ int XrdXrootdProtocol::do_PgRead()
 // the checksums which a questionable practice.
 //
    IO.File->Stats.pgrOps(IO.IOLen, (IO.Flags & XrdProto::kXR_pgRetry) != 0);
+   IO.File->Stats.rdHist(IO.Offset, IO.IOLen);
 
 // Use synchronous reads unless async I/O is allowed, the read size is
 // sufficient, and there are not too many async operations in flight.
@@ -406,6 +407,7 @@ int XrdXrootdProtocol::do_PgWrite()
 // the checksums which a questionable practice.
 //
    IO.File->Stats.pgwOps(IO.IOLen, (IO.Flags & XrdProto::kXR_pgRetry) != 0);
+   IO.File->Stats.wrHist(IO.Offset, IO.IOLen);
 
 // If we are monitoring, insert a write entry
 //
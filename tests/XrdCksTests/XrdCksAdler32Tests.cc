@@ -0,0 +1,119 @@
+#undef NDEBUG
+
+#include "XrdCks/XrdCksCalcadler32.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+class XrdCksAdler32Tests : public ::testing::Test {
+protected:
+  void SetUp() override {
+    std::mt19937 gen(1234);
+    data.resize(1024 * 1024 + 128);
+    for (auto &c : data) c = static_cast<unsigned char>(gen());
+  }
+
+  std::vector<unsigned char> data;
+};
+
+static const char *kernels[] = {"scalar", "ssse3", "avx2", "avx512"};
+
+static uint32_t zlibAdler(const unsigned char *buff, size_t blen) {
+  return static_cast<uint32_t>(adler32(1, buff, static_cast<uInt>(blen)));
+}
+
+/*
+ * Every kernel must agree with zlib for all lengths around the vector block
+ * sizes and for unaligned buffers. Kernels the cpu lacks fall back to the
+ * best available one, so this is safe to run everywhere.
+ */
+TEST_F(XrdCksAdler32Tests, KernelsMatchZlib) {
+  for (const char *kernel : kernels) {
+    for (size_t off = 0; off < 64; off += 7) {
+      for (size_t len = 0; len < 600; len++) {
+        const unsigned char *bP = data.data() + off;
+        ASSERT_EQ(XrdCksCalcadler32::Calc32(1, bP, len, kernel),
+                  zlibAdler(bP, len))
+            << "kernel " << kernel << " off " << off << " len " << len;
+      }
+    }
+  }
+}
+
+/*
+ * Long runs exercise the modulo reduction every NMAX bytes.
+ */
+TEST_F(XrdCksAdler32Tests, LargeBuffers) {
+  const size_t sizes[] = {5551, 5552, 5553, 65536, 1024 * 1024 + 127};
+  for (const char *kernel : kernels) {
+    for (size_t len : sizes) {
+      ASSERT_EQ(XrdCksCalcadler32::Calc32(1, data.data() + 1, len, kernel),
+                zlibAdler(data.data() + 1, len))
+          << "kernel " << kernel << " len " << len;
+    }
+  }
+}
+
+/*
+ * A run of 0xff bytes produces the largest intermediate sums.
+ */
+TEST_F(XrdCksAdler32Tests, AllOnes) {
+  std::vector<unsigned char> ones(300000, 0xff);
+  for (const char *kernel : kernels)
+    ASSERT_EQ(XrdCksCalcadler32::Calc32(1, ones.data(), ones.size(), kernel),
+              zlibAdler(ones.data(), ones.size())) << "kernel " << kernel;
+}
+
+/*
+ * Feeding the calculator in odd sized pieces must give the same checksum as
+ * a single update.
+ */
+TEST_F(XrdCksAdler32Tests, IncrementalUpdate) {
+  XrdCksCalcadler32 calc;
+  size_t pos = 0, piece = 1;
+  const size_t total = 200000;
+
+  while (pos < total) {
+    size_t n = std::min(piece, total - pos);
+    calc.Update(reinterpret_cast<const char *>(data.data()) + pos, n);
+    pos += n;
+    piece = piece * 3 + 1;
+  }
+
+  uint32_t result;
+  memcpy(&result, calc.Final(), sizeof(result));
+  ASSERT_EQ(ntohl(result), zlibAdler(data.data(), total));
+  ASSERT_NE(XrdCksCalcadler32::Kernel(), nullptr);
+}
+
+/*
+ * Throughput of each kernel across buffer sizes. This is a benchmark, not a
+ * test, run it with --gtest_also_run_disabled_tests.
+ */
+TEST_F(XrdCksAdler32Tests, DISABLED_Throughput) {
+  const size_t sizes[] = {64, 512, 4096, 65536, 1024 * 1024};
+  const size_t total = 1024UL * 1024 * 1024;
+
+  printf("best kernel: %s\n", XrdCksCalcadler32::Kernel());
+  printf("%-8s %10s %10s\n", "kernel", "size", "GB/s");
+
+  for (const char *kernel : kernels) {
+    for (size_t len : sizes) {
+      uint32_t adler = 1;
+      auto start = std::chrono::steady_clock::now();
+      for (size_t done = 0; done < total; done += len)
+        adler = XrdCksCalcadler32::Calc32(adler, data.data(), len, kernel);
+      std::chrono::duration<double> secs =
+          std::chrono::steady_clock::now() - start;
+      printf("%-8s %10zu %10.2f (%08x)\n", kernel, len,
+             total / secs.count() / 1e9, adler);
+    }
+  }
+}
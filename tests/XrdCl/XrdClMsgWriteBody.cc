@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include "XrdCl/XrdClMessageUtils.hh"
+#include "XrdCl/XrdClSocket.hh"
+#include "XrdCl/XrdClXRootDMsgHandler.hh"
+#include "XrdCl/XrdClXRootDTransport.hh"
+#include "XrdSys/XrdSysPageSize.hh"
+
+#include <arpa/inet.h>
+
+#include <string>
+#include <vector>
+
+using namespace XrdCl;
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Socket taking at most the next quota bytes of a gathering send, or
+  // asking for a retry when the quota is zero
+  //----------------------------------------------------------------------------
+  struct ShortWriteSocket : public Socket
+  {
+    ShortWriteSocket( std::vector<size_t> quotas ) : quotas( quotas ), next( 0 ), maxiov( 0 )
+    {
+    }
+
+    using Socket::Send;
+
+    XRootDStatus Send( const iovec *iov, int iovcnt, int &bytesWritten ) override
+    {
+      maxiov = std::max( maxiov, iovcnt );
+      size_t quota = quotas[next++ % quotas.size()];
+      if( quota == 0 )
+        return XRootDStatus( stOK, suRetry );
+
+      bytesWritten = 0;
+      for( int i = 0; i < iovcnt && quota > 0; ++i )
+      {
+        size_t len = std::min( quota, iov[i].iov_len );
+        out.append( static_cast<const char*>( iov[i].iov_base ), len );
+        bytesWritten += len;
+        quota -= len;
+      }
+      return XRootDStatus();
+    }
+
+    std::vector<size_t> quotas;
+    size_t              next;
+    int                 maxiov;
+    std::string         out;
+  };
+
+  //----------------------------------------------------------------------------
+  // Write the body of a PgWrite of len bytes at offset through a socket taking
+  // the given quotas, and check each page follows its crc32c digest
+  //----------------------------------------------------------------------------
+  void CheckPgWrite( uint64_t offset, uint32_t len, std::vector<size_t> quotas )
+  {
+    Message *msg;
+    ClientPgWriteRequest *req;
+    MessageUtils::CreateRequest( msg, req );
+    req->requestid = htons( kXR_pgwrite );
+    req->offset    = htonll( offset );
+    req->dlen      = len;
+    XRootDTransport::SetDescription( msg );
+
+    std::string data( len, 0 );
+    for( uint32_t i = 0; i < len; ++i )
+      data[i] = char( i * 7 + i / 4096 );
+
+    //--------------------------------------------------------------------------
+    // The digests need not be right, only distinct, to check where they go
+    //--------------------------------------------------------------------------
+    std::string expected;
+    std::vector<uint32_t> digests;
+    uint32_t pos = 0;
+    while( pos < len )
+    {
+      uint32_t pglen = XrdSys::PageSize - ( offset + pos ) % XrdSys::PageSize;
+      if( pglen > len - pos ) pglen = len - pos;
+      uint32_t digest = 0xc0de0000 + digests.size();
+      digests.push_back( digest );
+      uint32_t net = htonl( digest );
+      expected.append( reinterpret_cast<char*>( &net ), sizeof( net ) );
+      expected.append( data, pos, pglen );
+      pos += pglen;
+    }
+
+    URL url( "root://localhost:1094/file" );
+    XRootDMsgHandler handler( msg, nullptr, &url, nullptr, nullptr );
+    ChunkList chunks;
+    chunks.push_back( ChunkInfo( offset, len, &data[0] ) );
+    handler.SetChunkList( &chunks );
+    handler.SetCrc32cDigests( std::move( digests ) );
+
+    ShortWriteSocket sock( quotas );
+    uint64_t total = 0;
+    int      calls = 0;
+    while( true )
+    {
+      ASSERT_LT( ++calls, 1000000 );
+      uint32_t written = 0;
+      XRootDStatus st = handler.WriteMessageBody( &sock, written );
+      ASSERT_TRUE( st.IsOK() );
+      total += written;
+      if( st.code != suRetry ) break;
+    }
+
+    EXPECT_EQ( total, expected.size() );
+    EXPECT_EQ( sock.out.size(), expected.size() );
+    EXPECT_TRUE( sock.out == expected );
+    EXPECT_LE( sock.maxiov, 64 );
+  }
+}
+
+//------------------------------------------------------------------------------
+// Whole pages sent in one go
+//------------------------------------------------------------------------------
+TEST(MsgWriteBodyTest, PgWriteWhole)
+{
+  CheckPgWrite( 0, 8 * XrdSys::PageSize, { 1 << 30 } );
+}
+
+//------------------------------------------------------------------------------
+// Short writes stopping inside digests and pages, with retries in between,
+// for a write that does not start or end on a page boundary
+//------------------------------------------------------------------------------
+TEST(MsgWriteBodyTest, PgWriteShortWrites)
+{
+  CheckPgWrite( 1000, 5 * XrdSys::PageSize + 123, { 1, 2, 0, 3, 4099, 5, 0, 4096, 4100, 7 } );
+  CheckPgWrite( 4095, 2, { 1, 1, 1, 0, 1, 1 } );
+  CheckPgWrite( XrdSys::PageSize, XrdSys::PageSize + 1, { 4100, 0, 1, 4 } );
+}
+
+//------------------------------------------------------------------------------
+// A large write takes several gathering sends, each within the iovec cap
+//------------------------------------------------------------------------------
+TEST(MsgWriteBodyTest, PgWriteLarge)
+{
+  CheckPgWrite( 12345, 1024 * 1024, { 1 << 30, 100000, 0, 3 } );
+}
+
+//------------------------------------------------------------------------------
+// Plain write chunks resume inside the chunk a short write stopped in
+//------------------------------------------------------------------------------
+TEST(MsgWriteBodyTest, WriteChunks)
+{
+  Message *msg;
+  ClientWriteRequest *req;
+  MessageUtils::CreateRequest( msg, req );
+  req->requestid = htons( kXR_write );
+  XRootDTransport::SetDescription( msg );
+
+  std::vector<std::string> bufs;
+  std::string expected;
+  ChunkList chunks;
+  for( int i = 0; i < 100; ++i )
+  {
+    bufs.emplace_back( 1 + i * 37 % 500, char( 'a' + i % 26 ) );
+    expected += bufs.back();
+  }
+  for( auto &b : bufs )
+    chunks.push_back( ChunkInfo( 0, b.size(), &b[0] ) );
+
+  URL url( "root://localhost:1094/file" );
+  XRootDMsgHandler handler( msg, nullptr, &url, nullptr, nullptr );
+  handler.SetChunkList( &chunks );
+
+  ShortWriteSocket sock( { 1, 0, 250, 999, 0, 3 } );
+  while( true )
+  {
+    uint32_t written = 0;
+    XRootDStatus st = handler.WriteMessageBody( &sock, written );
+    ASSERT_TRUE( st.IsOK() );
+    if( st.code != suRetry ) break;
+  }
+  EXPECT_TRUE( sock.out == expected );
+  EXPECT_LE( sock.maxiov, 64 );
+}
@@ -21,6 +21,9 @@
 #include <ctime>
 #include <random>
 #include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
 #include "GTestXrdHelpers.hh"
 #include "Server.hh"
 #include "Utils.hh"
@@ -301,3 +304,103 @@ TEST(SocketTest, TransferTest)
   EXPECT_EQ( sentChecksum, received.second );
   EXPECT_EQ( receivedChecksum, sent.second );
 }
+
+//------------------------------------------------------------------------------
+// Gathering send over a socket with a small send buffer: short writes are
+// resumed from where they stopped and the peer gets every byte in order
+//------------------------------------------------------------------------------
+TEST(SocketTest, GatheringSendResumes)
+{
+  using namespace XrdCl;
+  int fds[2];
+  ASSERT_EQ( socketpair( AF_UNIX, SOCK_STREAM, 0, fds ), 0 );
+  int sndbuf = 4096;
+  ASSERT_EQ( setsockopt( fds[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof( sndbuf ) ), 0 );
+  ASSERT_EQ( fcntl( fds[0], F_SETFL, O_NONBLOCK ), 0 );
+  ASSERT_EQ( fcntl( fds[1], F_SETFL, O_NONBLOCK ), 0 );
+  Socket sock( fds[0], Socket::Connected );
+
+  std::default_random_engine rng( 7 );
+  std::vector<std::string> bufs( 300 );
+  std::string expected;
+  for( auto &b : bufs )
+  {
+    b.resize( 1 + rng() % 3000 );
+    for( auto &c : b ) c = char( rng() );
+    expected += b;
+  }
+
+  std::string received;
+  auto drain = [&]()
+  {
+    char tmp[65536];
+    ssize_t n;
+    while( ( n = ::read( fds[1], tmp, sizeof( tmp ) ) ) > 0 )
+      received.append( tmp, n );
+  };
+
+  size_t idx = 0, off = 0, shortWrites = 0;
+  while( idx < bufs.size() )
+  {
+    std::vector<iovec> iov;
+    for( size_t i = idx; i < bufs.size(); ++i )
+    {
+      size_t o = ( i == idx ? off : 0 );
+      iov.push_back( { &bufs[i][o], bufs[i].size() - o } );
+    }
+    size_t left = 0;
+    for( auto &v : iov ) left += v.iov_len;
+
+    int wrt = 0;
+    XRootDStatus st = sock.Send( iov.data(), iov.size(), wrt );
+    ASSERT_TRUE( st.IsOK() );
+    if( st.code == suRetry )
+    {
+      drain();
+      continue;
+    }
+    ASSERT_GT( wrt, 0 );
+    if( size_t( wrt ) < left ) ++shortWrites;
+
+    // resume in the middle of whichever buffer the write stopped in
+    while( wrt > 0 )
+    {
+      size_t len = std::min<size_t>( wrt, bufs[idx].size() - off );
+      off += len;
+      wrt -= len;
+      if( off == bufs[idx].size() )
+      {
+        ++idx;
+        off = 0;
+      }
+    }
+  }
+  drain();
+  ::close( fds[1] );
+
+  EXPECT_GT( shortWrites, 0u );
+  EXPECT_EQ( received.size(), expected.size() );
+  EXPECT_TRUE( received == expected );
+}
+
+//------------------------------------------------------------------------------
+// No more than MaxIOV buffers are passed on in a single send
+//------------------------------------------------------------------------------
+TEST(SocketTest, GatheringSendCapsIOV)
+{
+  using namespace XrdCl;
+  int fds[2];
+  ASSERT_EQ( socketpair( AF_UNIX, SOCK_STREAM, 0, fds ), 0 );
+  Socket sock( fds[0], Socket::Connected );
+
+  std::vector<char>  data( 2 * Socket::MaxIOV, 'x' );
+  std::vector<iovec> iov( data.size() );
+  for( size_t i = 0; i < data.size(); ++i )
+    iov[i] = { &data[i], 1 };
+
+  int wrt = 0;
+  XRootDStatus st = sock.Send( iov.data(), iov.size(), wrt );
+  EXPECT_TRUE( st.IsOK() );
+  EXPECT_EQ( wrt, int( Socket::MaxIOV ) );
+  ::close( fds[1] );
+}
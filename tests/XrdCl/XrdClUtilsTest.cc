@@ -27,8 +27,14 @@
 #include "GTestXrdHelpers.hh"
 #include "XrdCl/XrdClTaskManager.hh"
 #include "XrdCl/XrdClSIDManager.hh"
+#include "XrdCl/XrdClInQueue.hh"
+#include "XrdCl/XrdClMessage.hh"
 #include "XrdCl/XrdClPropertyList.hh"
 
+#include <set>
+#include <thread>
+#include <vector>
+
 //------------------------------------------------------------------------------
 // Declaration
 //------------------------------------------------------------------------------
@@ -199,6 +205,137 @@ TEST(UtilsTest, SIDManagerTest)
   EXPECT_EQ( manager->NumberOfTimedOutSIDs(), 0u );
 }
 
+//------------------------------------------------------------------------------
+// SID Manager test with many threads and all the SIDs in use
+//------------------------------------------------------------------------------
+TEST(UtilsTest, SIDManagerConcurrentTest)
+{
+  using namespace XrdCl;
+  std::shared_ptr<SIDManager> manager = SIDMgrPool::Instance().GetSIDMgr( "root://fake-concurrent:1094//dir/file" );
+
+  std::vector<std::thread> threads;
+  std::vector<std::vector<uint16_t>> held( 8 );
+  for( int t = 0; t < 8; ++t )
+  {
+    threads.emplace_back( [&, t]() {
+      for( int r = 0; r < 2000; ++r )
+      {
+        uint8_t sid[2];
+        for( int i = 0; i < 8; ++i )
+        {
+          if( !manager->AllocateSID( sid ).IsOK() ) abort();
+          uint16_t s; memcpy( &s, sid, 2 );
+          held[t].push_back( s );
+        }
+        for( int i = 0; i < 7; ++i )
+        {
+          uint16_t s = held[t].back();
+          held[t].pop_back();
+          memcpy( sid, &s, 2 );
+          manager->ReleaseSID( sid );
+        }
+      }
+    } );
+  }
+  for( auto &t : threads ) t.join();
+
+  std::set<uint16_t> all;
+  for( auto &h : held ) all.insert( h.begin(), h.end() );
+  EXPECT_EQ( all.size(), 8u * 2000u );
+  EXPECT_EQ( manager->GetNumberOfAllocatedSIDs(), 8u * 2000u );
+
+  // Use up the rest of the SIDs
+  uint8_t sid[2];
+  while( manager->AllocateSID( sid ).IsOK() ) all.insert( sid[0] | ( sid[1] << 8 ) );
+  EXPECT_EQ( all.size(), 0xfffeu );
+  EXPECT_EQ( all.count( 0 ), 0u );
+
+  for( uint16_t s : all )
+  {
+    memcpy( sid, &s, 2 );
+    manager->ReleaseSID( sid );
+  }
+  EXPECT_EQ( manager->GetNumberOfAllocatedSIDs(), 0u );
+}
+
+//------------------------------------------------------------------------------
+// In-queue test
+//------------------------------------------------------------------------------
+namespace
+{
+  class TestHandler : public XrdCl::MsgHandler
+  {
+    public:
+      TestHandler( uint16_t sid, time_t expires, bool stay = false ) :
+        sid( sid ), expires( expires ), stay( stay ), timeouts( 0 ) { }
+
+      uint16_t Examine( std::shared_ptr<XrdCl::Message>& ) { return RemoveHandler; }
+      uint16_t InspectStatusRsp() { return 0; }
+      uint16_t GetSid() const { return sid; }
+      void OnStatusReady( const XrdCl::Message*, XrdCl::XRootDStatus ) { }
+      time_t GetExpiration() { return expires; }
+
+      uint8_t OnStreamEvent( StreamEvent event, XrdCl::XRootDStatus )
+      {
+        if( event == Timeout ) ++timeouts;
+        return stay ? 0 : RemoveHandler;
+      }
+
+      uint16_t sid;
+      time_t   expires;
+      bool     stay;
+      int      timeouts;
+  };
+}
+
+TEST(UtilsTest, InQueueTimeoutTest)
+{
+  using namespace XrdCl;
+  InQueue queue;
+  time_t now = time( 0 );
+  bool rmMsg = false;
+
+  TestHandler h1( 1, now + 5 ), h2( 2000, now + 1000 ), h3( 3, now + 2, true ), h4( 4, now + 1 );
+  for( TestHandler *h : { &h1, &h2, &h3, &h4 } )
+  {
+    queue.AddMessageHandler( h, rmMsg );
+    EXPECT_TRUE( queue.HasUnsetTimeout( h ) );
+    queue.AssignTimeout( h );
+    EXPECT_FALSE( queue.HasUnsetTimeout( h ) );
+  }
+  queue.RemoveMessageHandler( &h4 );
+  EXPECT_FALSE( queue.HasUnsetTimeout( &h4 ) );
+
+  queue.ReportTimeout( now + 1 );
+  EXPECT_EQ( h4.timeouts, 0 );
+  queue.ReportTimeout( now + 2 );
+  EXPECT_EQ( h3.timeouts, 1 );
+  EXPECT_EQ( h1.timeouts, 0 );
+  queue.ReportTimeout( now + 6 );
+  EXPECT_EQ( h1.timeouts, 1 );
+  EXPECT_EQ( h3.timeouts, 2 );  // not removed, so reported again
+  queue.ReportTimeout( now + 7 );
+  EXPECT_EQ( h1.timeouts, 1 );
+  EXPECT_EQ( h2.timeouts, 0 );
+
+  // more than a full turn of the wheel later
+  queue.ReportTimeout( now + 1001 );
+  EXPECT_EQ( h2.timeouts, 1 );
+  EXPECT_EQ( h1.timeouts, 1 );
+
+  // the handlers are found by SID
+  TestHandler h5( 0x1234, 0 );
+  queue.AddMessageHandler( &h5, rmMsg );
+  std::shared_ptr<Message> msg( new Message( 8 ) );
+  memset( msg->GetBuffer(), 0, 8 );
+  msg->GetBuffer()[0] = 0x34;
+  msg->GetBuffer()[1] = 0x12;
+  time_t   exp = 0;
+  uint16_t act = 0;
+  EXPECT_EQ( queue.GetHandlerForMessage( msg, exp, act ), &h5 );
+  EXPECT_EQ( queue.GetHandlerForMessage( msg, exp, act ), nullptr );
+}
+
 //------------------------------------------------------------------------------
 // Property List test
 //------------------------------------------------------------------------------
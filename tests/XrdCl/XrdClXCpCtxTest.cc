@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include "XrdCl/XrdClXCpCtx.hh"
+#include "XrdCl/XrdClXCpSrc.hh"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace XrdCl;
+
+namespace
+{
+  char Pattern( uint64_t off )
+  {
+    return char( off * 13 + off / 1000 );
+  }
+
+  void CheckChunk( PageInfo &ci )
+  {
+    const char *buf = static_cast<const char*>( ci.GetBuffer() );
+    for( uint32_t i = 0; i < ci.GetLength(); ++i )
+      ASSERT_EQ( buf[i], Pattern( ci.GetOffset() + i ) ) << "at " << ci.GetOffset() + i;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Gives the tests access to the reorder buffer of XCpCtx and lets them stand
+// in for the sources
+//------------------------------------------------------------------------------
+class XCpCtxTest : public ::testing::Test
+{
+  protected:
+
+    static XCpSrc *AddSource( XCpCtx *ctx, size_t idx )
+    {
+      XCpSrc *src = new XCpSrc( 1024, 1, ctx->pFileSize, ctx, idx );
+      src->pRunning = true;
+      XrdSysMutexHelper lck( ctx->pMtx );
+      ctx->pSources.push_back( src );
+      return src;
+    }
+
+    static void RemoveSource( XCpSrc *src )
+    {
+      src->pRunning = false;
+      src->Delete();
+    }
+
+    static uint64_t Reordered( XCpCtx *ctx )
+    {
+      uint64_t bytes = 0;
+      for( auto &c : ctx->pReorder ) bytes += c.second->GetLength();
+      return bytes;
+    }
+
+    static uint64_t MaxAhead( XCpCtx *ctx ) { return ctx->pMaxAhead; }
+    static uint64_t Allocated( XCpCtx *ctx ) { return ctx->pOffset; }
+
+    // true if GetChunk would not block on the sink
+    static bool Ready( XCpCtx *ctx )
+    {
+      if( ctx->pDataReceived == uint64_t( ctx->pFileSize ) ) return true;
+      if( !ctx->pReorder.empty() && ctx->pReorder.begin()->first == ctx->pNextOffset )
+        return true;
+      return !ctx->pSink.IsEmpty();
+    }
+};
+
+//------------------------------------------------------------------------------
+// Sources return the chunks of their blocks in a random order. They are
+// handed out in file order, the reorder buffer never holds more than
+// nbSources blocks, and sources are refused blocks further ahead than that
+//------------------------------------------------------------------------------
+TEST_F(XCpCtxTest, OrderedDelivery)
+{
+  const uint64_t fileSize = 64 * 1024 + 300, chunkSize = 1024, blockSize = 4096;
+  const uint8_t  nbSrc = 4;
+  XCpCtx *ctx = new XCpCtx( {}, blockSize, nbSrc, chunkSize, 1, fileSize, true );
+  ASSERT_EQ( MaxAhead( ctx ), nbSrc * blockSize );
+
+  struct Sim
+  {
+    XCpSrc               *src;
+    std::vector<uint64_t> chunks;
+  };
+  std::vector<Sim> sims( nbSrc );
+  for( size_t i = 0; i < nbSrc; ++i )
+    sims[i].src = AddSource( ctx, i );
+
+  std::mt19937 rng( 42 );
+  uint64_t next = 0, maxReordered = 0;
+  int refused = 0, outOfOrder = 0;
+  bool done = false;
+
+  for( int iter = 0; !done; ++iter )
+  {
+    ASSERT_LT( iter, 100000 );
+
+    // idle sources ask for a block
+    for( auto &s : sims )
+    {
+      if( !s.chunks.empty() ) continue;
+      bool allocatedAll = Allocated( ctx ) >= fileSize;
+      std::pair<uint64_t, uint64_t> blk = ctx->GetBlock();
+      if( blk.second == 0 )
+      {
+        if( !allocatedAll ) ++refused;
+        continue;
+      }
+      EXPECT_LE( blk.first + blk.second, next + MaxAhead( ctx ) );
+      for( uint64_t off = blk.first; off < blk.first + blk.second; off += chunkSize )
+        s.chunks.push_back( off );
+      std::shuffle( s.chunks.begin(), s.chunks.end(), rng );
+    }
+
+    // a random busy source returns one of its chunks
+    std::vector<Sim*> busy;
+    for( auto &s : sims )
+      if( !s.chunks.empty() ) busy.push_back( &s );
+    if( !busy.empty() )
+    {
+      Sim *s = busy[rng() % busy.size()];
+      uint64_t off = s->chunks.back();
+      s->chunks.pop_back();
+      uint32_t len = std::min<uint64_t>( chunkSize, fileSize - off );
+      char *buf = new char[len];
+      for( uint32_t i = 0; i < len; ++i ) buf[i] = Pattern( off + i );
+      if( off != next ) ++outOfOrder;
+      ctx->PutChunk( new PageInfo( off, len, buf ) );
+    }
+    else
+      ASSERT_TRUE( Ready( ctx ) ) << "no source has work and nothing can be delivered";
+
+    // take whatever can be delivered
+    while( Ready( ctx ) )
+    {
+      PageInfo ci;
+      XRootDStatus st = ctx->GetChunk( ci );
+      ASSERT_TRUE( st.IsOK() );
+      ASSERT_LE( Reordered( ctx ), MaxAhead( ctx ) );
+      maxReordered = std::max( maxReordered, Reordered( ctx ) );
+      if( st.code == suDone )
+      {
+        done = true;
+        break;
+      }
+      if( st.code != suContinue ) continue;
+      ASSERT_EQ( ci.GetOffset(), next );
+      CheckChunk( ci );
+      next += ci.GetLength();
+      delete[] static_cast<char*>( ci.GetBuffer() );
+    }
+  }
+
+  EXPECT_EQ( next, fileSize );
+  EXPECT_GT( outOfOrder, 0 );
+  EXPECT_GT( maxReordered, 0u );
+  EXPECT_GT( refused, 0 );
+  EXPECT_EQ( Reordered( ctx ), 0u );
+
+  for( auto &s : sims )
+    RemoveSource( s.src );
+  ctx->Delete();
+}
+
+//------------------------------------------------------------------------------
+// Real sources reading a local file: the data comes out whole and in order
+//------------------------------------------------------------------------------
+TEST_F(XCpCtxTest, OrderedLocalSources)
+{
+  char path[] = "/tmp/xrdcl-xcpctx-XXXXXX";
+  int fd = mkstemp( path );
+  ASSERT_GE( fd, 0 );
+  const uint64_t fileSize = 3 * 1024 * 1024 + 777;
+  std::string data( fileSize, 0 );
+  for( uint64_t i = 0; i < fileSize; ++i ) data[i] = Pattern( i );
+  ASSERT_EQ( write( fd, data.data(), fileSize ), ssize_t( fileSize ) );
+  close( fd );
+
+  const uint8_t nbSrc = 4;
+  std::vector<std::string> urls( 2 * nbSrc, std::string( "file://localhost" ) + path );
+  XCpCtx *ctx = new XCpCtx( urls, 128 * 1024, nbSrc, 16 * 1024, 4, -1, true );
+  ASSERT_TRUE( ctx->Initialize().IsOK() );
+  ASSERT_EQ( ctx->GetSize(), int64_t( fileSize ) );
+
+  uint64_t next = 0;
+  while( true )
+  {
+    PageInfo ci;
+    XRootDStatus st = ctx->GetChunk( ci );
+    ASSERT_TRUE( st.IsOK() ) << st.ToString();
+    ASSERT_LE( Reordered( ctx ), MaxAhead( ctx ) );
+    if( st.code == suDone ) break;
+    if( st.code != suContinue ) continue;
+    ASSERT_EQ( ci.GetOffset(), next );
+    CheckChunk( ci );
+    next += ci.GetLength();
+    delete[] static_cast<char*>( ci.GetBuffer() );
+  }
+  EXPECT_EQ( next, fileSize );
+
+  ctx->Delete();
+  unlink( path );
+}
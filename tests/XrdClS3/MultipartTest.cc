@@ -0,0 +1,132 @@
+/******************************************************************************/
+/* Copyright (C) 2025, Pelican Project, Morgridge Institute for Research      */
+/*                                                                            */
+/* This file is part of the XrdClS3 client plugin for XRootD.                 */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "../XrdClHttpCommon/TransferTest.hh"
+
+#include <XrdCl/XrdClFile.hh>
+#include <XrdCl/XrdClFileSystem.hh>
+
+class S3MultipartFixture : public TransferFixture {};
+
+// An object several parts long (default part size is 16MB) goes through a
+// multipart upload; read it back in chunks and as a single large read, which
+// the plugin splits into parallel ranged GETs.
+TEST_F(S3MultipartFixture, LargeObject)
+{
+    constexpr off_t object_size = 40 * 1024 * 1024 + 12345;
+    constexpr size_t chunk_size = 1024 * 1024;
+    auto url = GetCacheURL() + "/test-bucket/multipart_large";
+    ASSERT_NO_FATAL_FAILURE(WritePattern(url, object_size, 'a', chunk_size));
+
+    XrdCl::File fh;
+    auto rv = fh.Open(url + "?authz=" + GetReadToken(), XrdCl::OpenFlags::Read, XrdCl::Access::Mode(0755), static_cast<time_t>(0));
+    ASSERT_TRUE(rv.IsOK()) << "Failed to open " << url << ": " << rv.ToString();
+
+    std::string buffer(object_size, '\0');
+    uint32_t bytes_read = 0;
+    rv = fh.Read(0, object_size, buffer.data(), bytes_read, static_cast<time_t>(0));
+    ASSERT_TRUE(rv.IsOK()) << "Failed to read " << url << ": " << rv.ToString();
+    ASSERT_EQ(bytes_read, static_cast<uint32_t>(object_size));
+    for (off_t off = 0; off < object_size; off += chunk_size) {
+        auto expected = static_cast<char>('a' + off / chunk_size);
+        auto len = std::min<off_t>(chunk_size, object_size - off);
+        ASSERT_EQ(buffer.substr(off, len), std::string(len, expected)) << "Mismatch in chunk at offset " << off;
+    }
+    rv = fh.Close();
+    ASSERT_TRUE(rv.IsOK());
+}
+
+// Without a size hint, an object that never fills a part is sent as a single PUT.
+TEST_F(S3MultipartFixture, UnknownSizeSmallObject)
+{
+    auto url = GetCacheURL() + "/test-bucket/multipart_small";
+    XrdCl::File fh;
+    auto rv = fh.Open(url + "?authz=" + GetWriteToken(), XrdCl::OpenFlags::Write, XrdCl::Access::Mode(0755), static_cast<time_t>(0));
+    ASSERT_TRUE(rv.IsOK()) << "Failed to open " << url << " for write: " << rv.ToString();
+    std::string data(1000, 'x');
+    rv = fh.Write(0, data.size(), data.data(), static_cast<time_t>(10));
+    ASSERT_TRUE(rv.IsOK()) << "Failed to write " << url << ": " << rv.ToString();
+    rv = fh.Close();
+    ASSERT_TRUE(rv.IsOK()) << "Failed to close " << url << ": " << rv.ToString();
+
+    ASSERT_NO_FATAL_FAILURE(VerifyContents(url, data.size(), 'x', data.size()));
+}
+
+// Opening for a multipart upload probes the object; New refuses one that
+// already exists instead of silently replacing it on close.  The flags are
+// those xrdcp opens its target with, without and with --force.
+TEST_F(S3MultipartFixture, NewRefusesExistingObject)
+{
+    auto url = GetCacheURL() + "/test-bucket/multipart_exists";
+    ASSERT_NO_FATAL_FAILURE(WritePattern(url, 1000, 'a', 1000));
+    ASSERT_NO_FATAL_FAILURE(VerifyContents(url, 1000, 'a', 1000));
+
+    for (auto flags : {XrdCl::OpenFlags::New, XrdCl::OpenFlags::Update | XrdCl::OpenFlags::New}) {
+        XrdCl::File fh;
+        auto rv = fh.Open(url + "?authz=" + GetWriteToken(), flags, XrdCl::Access::Mode(0755), static_cast<time_t>(0));
+        ASSERT_FALSE(rv.IsOK()) << "Opening existing object " << url << " with New succeeded";
+        EXPECT_EQ(rv.code, XrdCl::errErrorResponse);
+        EXPECT_EQ(rv.errNo, static_cast<uint32_t>(kXR_ItExists));
+        EXPECT_FALSE(fh.IsOpen());
+    }
+    ASSERT_NO_FATAL_FAILURE(VerifyContents(url, 1000, 'a', 1000));
+
+    // Without New the object is replaced.
+    XrdCl::File fh;
+    auto rv = fh.Open(url + "?authz=" + GetWriteToken(), XrdCl::OpenFlags::Update | XrdCl::OpenFlags::Delete, XrdCl::Access::Mode(0755), static_cast<time_t>(0));
+    ASSERT_TRUE(rv.IsOK()) << "Failed to open " << url << " for write: " << rv.ToString();
+    std::string data(500, 'b');
+    rv = fh.Write(0, data.size(), data.data(), static_cast<time_t>(10));
+    ASSERT_TRUE(rv.IsOK()) << "Failed to write " << url << ": " << rv.ToString();
+    rv = fh.Close();
+    ASSERT_TRUE(rv.IsOK()) << "Failed to close " << url << ": " << rv.ToString();
+    ASSERT_NO_FATAL_FAILURE(VerifyContents(url, data.size(), 'b', data.size()));
+}
+
+// The object of an upload in progress does not exist yet; reading or
+// stat'ing it through the upload handle is refused.
+TEST_F(S3MultipartFixture, NoReadsDuringUpload)
+{
+    auto url = GetCacheURL() + "/test-bucket/multipart_noread";
+    XrdCl::File fh;
+    auto rv = fh.Open(url + "?authz=" + GetWriteToken(), XrdCl::OpenFlags::Write, XrdCl::Access::Mode(0755), static_cast<time_t>(0));
+    ASSERT_TRUE(rv.IsOK()) << "Failed to open " << url << " for write: " << rv.ToString();
+
+    std::string data(1000, 'y');
+    rv = fh.Write(0, data.size(), data.data(), static_cast<time_t>(10));
+    ASSERT_TRUE(rv.IsOK()) << "Failed to write " << url << ": " << rv.ToString();
+
+    XrdCl::StatInfo *si = nullptr;
+    rv = fh.Stat(true, si, static_cast<time_t>(10));
+    EXPECT_EQ(rv.code, XrdCl::errNotSupported);
+    delete si;
+
+    std::string buffer(data.size(), '\0');
+    uint32_t bytes_read = 0;
+    rv = fh.Read(0, buffer.size(), buffer.data(), bytes_read, static_cast<time_t>(10));
+    EXPECT_EQ(rv.code, XrdCl::errNotSupported);
+
+    std::string value;
+    EXPECT_FALSE(fh.GetProperty("ContentLength", value));
+
+    rv = fh.Close();
+    ASSERT_TRUE(rv.IsOK()) << "Failed to close " << url << ": " << rv.ToString();
+    ASSERT_NO_FATAL_FAILURE(VerifyContents(url, data.size(), 'y', data.size()));
+}
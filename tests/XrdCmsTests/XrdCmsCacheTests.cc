@@ -0,0 +1,80 @@
+#undef NDEBUG
+
+#include "XrdCms/XrdCmsCache.hh"
+#include "XrdCms/XrdCmsRRQ.hh"
+#include "XrdCms/XrdCmsSelect.hh"
+#include "XrdCms/XrdCmsTrace.hh"
+
+#include "XrdSys/XrdSysLogger.hh"
+
+#include "Xrd/XrdScheduler.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+// The cache only reaches the redirect queue and the scheduler for paths that
+// are pending or evicted, neither of which happens here.
+
+namespace XrdCms
+{
+XrdScheduler *Sched = 0;
+XrdCmsRRQ     RRQ;
+}
+
+short XrdCmsRRQ::Add(short, XrdCmsRRQInfo *) { return 0; }
+void  XrdCmsRRQ::Del(short, const void *) { }
+XrdCmsRRQSlot::XrdCmsRRQSlot() { }
+int   XrdCmsRRQ::Ready(int, const void *, SMask_t, SMask_t) { return 0; }
+
+namespace {
+
+// Writes a snapshot saying that `path` was on both servers, srvA in slot 0
+// and srvB in slot 1.
+std::string MakeSnapshot(const char *path) {
+  char tmpl[] = "/tmp/xrdcms-snap-XXXXXX";
+  int fd = mkstemp(tmpl);
+  EXPECT_GE(fd, 0);
+  FILE *fp = fdopen(fd, "w");
+  fprintf(fp, "n 0 srvA\nn 1 srvB\np 3 %s\n", path);
+  fclose(fp);
+  return tmpl;
+}
+
+}
+
+TEST(XrdCmsCache, PreloadAfterBounce) {
+  const char *path = "/data/preloaded";
+  std::string snap = MakeSnapshot(path);
+
+  XrdCms::Say.logger(new XrdSysLogger(STDERR_FILENO, 0));
+
+  // The cache is never deleted and its clock thread runs forever.
+  XrdCmsCache *cache = new XrdCmsCache;
+  ASSERT_EQ(cache->Init(8*60*60, 5, 5, 0, 0, 0, snap.c_str()), 1);
+
+  // Each server bounces as it logs in and only then is warmed, so the entry
+  // preloaded for srvA must not treat srvB's bounce as a loss of srvB.
+  cache->Bounce(1, 0);
+  cache->Warm(1, 0, "srvA");
+  cache->Bounce(2, 1);
+  cache->Warm(2, 1, "srvB");
+
+  XrdCmsSelect Sel(0, (char *)path, strlen(path));
+  EXPECT_EQ(cache->GetFile(Sel, 3), 1);
+  EXPECT_EQ(Sel.Vec.hf, (SMask_t)3);
+  EXPECT_EQ(Sel.Vec.bf, (SMask_t)0);
+
+  // A later bounce of srvA still invalidates its location.
+  cache->Bounce(1, 0);
+  XrdCmsSelect Again(0, (char *)path, strlen(path));
+  EXPECT_EQ(cache->GetFile(Again, 3), -1);
+  EXPECT_EQ(Again.Vec.hf, (SMask_t)2);
+  EXPECT_EQ(Again.Vec.bf, (SMask_t)1);
+
+  unlink(snap.c_str());
+}
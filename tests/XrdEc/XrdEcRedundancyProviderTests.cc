@@ -0,0 +1,188 @@
+#include "XrdEc/XrdEcConfig.hh"
+#include "XrdEc/XrdEcRedundancyProvider.hh"
+#include "XrdEc/XrdEcObjCfg.hh"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace XrdEc;
+
+namespace
+{
+  // A block of nbchunks stripes with its own memory
+  struct Block
+  {
+    Block( const ObjCfg &objcfg ) : objcfg( objcfg ),
+                                    data( objcfg.blksize )
+    {
+      for( size_t i = 0; i < objcfg.nbchunks; ++i )
+        stripes.emplace_back( data.data() + i * objcfg.chunksize, i < objcfg.nbdata );
+    }
+
+    Block( const Block& ) = delete;
+
+    void Fill( std::mt19937 &gen )
+    {
+      for( size_t i = 0; i < objcfg.datasize; ++i ) data[i] = gen();
+    }
+
+    void Erase( size_t strpnb )
+    {
+      memset( stripes[strpnb].buffer, 0, objcfg.chunksize );
+      stripes[strpnb].valid = false;
+    }
+
+    void Validate()
+    {
+      for( auto &s : stripes ) s.valid = true;
+    }
+
+    const ObjCfg      &objcfg;
+    std::vector<char>  data;
+    stripes_t          stripes;
+  };
+}
+
+// Encode, then recover every combination of up to nbparity lost stripes.
+TEST(XrdEcRedundancyProvider, EncodeDecode)
+{
+  ObjCfg objcfg( "test", 4, 2, 4096, true );
+  RedundancyProvider rp( objcfg );
+  std::mt19937 gen( 42 );
+
+  Block blk( objcfg );
+  blk.Fill( gen );
+  rp.compute( blk.stripes );
+  blk.Validate();
+  const std::vector<char> ref = blk.data;
+
+  for( size_t a = 0; a < objcfg.nbchunks; ++a )
+  {
+    for( size_t b = a; b < objcfg.nbchunks; ++b )
+    {
+      blk.Erase( a );
+      blk.Erase( b );
+      rp.compute( blk.stripes );
+      blk.Validate();
+      ASSERT_EQ( blk.data, ref ) << "lost stripes " << a << " and " << b;
+    }
+  }
+}
+
+// A batch gives the same result as stripes computed one by one, also when
+// the error pattern changes within the batch.
+TEST(XrdEcRedundancyProvider, Batch)
+{
+  ObjCfg objcfg( "test", 6, 3, 4096, true );
+  RedundancyProvider rp( objcfg );
+  std::mt19937 gen( 7 );
+
+  const size_t n = 8;
+  std::vector<std::unique_ptr<Block>> single, batched;
+  std::vector<stripes_t*> batch;
+  for( size_t i = 0; i < n; ++i )
+  {
+    single.emplace_back( new Block( objcfg ) );
+    single[i]->Fill( gen );
+    batched.emplace_back( new Block( objcfg ) );
+    memcpy( batched[i]->data.data(), single[i]->data.data(), objcfg.datasize );
+    batch.push_back( &batched[i]->stripes );
+    rp.compute( single[i]->stripes );
+  }
+  rp.compute( batch );
+  for( size_t i = 0; i < n; ++i )
+    ASSERT_EQ( single[i]->data, batched[i]->data );
+
+  for( size_t i = 0; i < n; ++i )
+  {
+    batched[i]->Validate();
+    batched[i]->Erase( i % objcfg.nbchunks );
+    if( i % 2 ) batched[i]->Erase( ( i + 3 ) % objcfg.nbchunks );
+  }
+  rp.compute( batch );
+  for( size_t i = 0; i < n; ++i )
+    ASSERT_EQ( single[i]->data, batched[i]->data );
+}
+
+// Blocks are batched whether or not the parity is written in place.
+TEST(XrdEcRedundancyProvider, EncodeBatchDefault)
+{
+  EXPECT_EQ( Config::Instance().encode_batch, 4u );
+}
+
+// Replication is used for a single data stripe.
+TEST(XrdEcRedundancyProvider, Replication)
+{
+  ObjCfg objcfg( "test", 1, 2, 1024, true );
+  RedundancyProvider rp( objcfg );
+  std::mt19937 gen( 3 );
+
+  Block blk( objcfg );
+  blk.Fill( gen );
+  rp.compute( blk.stripes );
+  for( size_t i = 1; i < objcfg.nbchunks; ++i )
+    ASSERT_EQ( memcmp( blk.stripes[0].buffer, blk.stripes[i].buffer, objcfg.chunksize ), 0 );
+}
+
+// Encode and decode throughput, stripe by stripe and in batches.
+// Run with --gtest_also_run_disabled_tests.
+TEST(XrdEcRedundancyProvider, DISABLED_Throughput)
+{
+  const size_t n = 64, rounds = 8;
+  std::mt19937 gen( 1 );
+
+  printf( "%-6s %8s %8s %8s %12s\n", "k+p", "chunk", "op", "batch", "MB/s" );
+  for( auto kp : { std::make_pair( 4, 2 ), std::make_pair( 8, 4 ), std::make_pair( 10, 4 ) } )
+  {
+    for( uint64_t chunksize : { 64ull * 1024, 1024ull * 1024 } )
+    {
+      ObjCfg objcfg( "test", kp.first, kp.second, chunksize, true );
+      RedundancyProvider rp( objcfg );
+      std::vector<std::unique_ptr<Block>> blks;
+      std::vector<stripes_t*> batch;
+      for( size_t i = 0; i < n; ++i )
+      {
+        blks.emplace_back( new Block( objcfg ) );
+        blks[i]->Fill( gen );
+        batch.push_back( &blks[i]->stripes );
+      }
+
+      for( int decode = 0; decode < 2; ++decode )
+      {
+        for( size_t bsize : { size_t( 1 ), n } )
+        {
+          std::chrono::duration<double> secs( 0 );
+          for( size_t r = 0; r < rounds; ++r )
+          {
+            for( size_t i = 0; i < n; ++i )
+            {
+              for( size_t s = 0; s < objcfg.nbchunks; ++s )
+                blks[i]->stripes[s].valid = s < objcfg.nbdata;
+              if( decode )
+              {
+                blks[i]->Validate();
+                blks[i]->stripes[0].valid = false;
+                blks[i]->stripes[objcfg.nbdata / 2].valid = false;
+              }
+            }
+            auto start = std::chrono::steady_clock::now();
+            if( bsize == 1 )
+              for( size_t i = 0; i < n; ++i ) rp.compute( blks[i]->stripes );
+            else
+              rp.compute( batch );
+            secs += std::chrono::steady_clock::now() - start;
+          }
+          printf( "%2d+%-3d %8llu %8s %8zu %12.1f\n", kp.first, kp.second,
+                  (unsigned long long)( chunksize >> 10 ), decode ? "decode" : "encode", bsize,
+                  double( rounds * n * objcfg.datasize ) / secs.count() / 1e6 );
+        }
+      }
+    }
+  }
+}
@@ -26,6 +26,7 @@
 #include "../XrdCl/GTestXrdHelpers.hh"
 #include <gtest/gtest.h>
 
+#include "XrdEc/XrdEcConfig.hh"
 #include "XrdEc/XrdEcStrmWriter.hh"
 #include "XrdEc/XrdEcReader.hh"
 #include "XrdEc/XrdEcObjCfg.hh"
@@ -179,6 +180,17 @@ class XrdEcTests : public ::testing::Test
       VarlenWriteTest( 77, false );
     }
 
+    //! Write with the given number of blocks erasure coded per job, one is
+    //! what is used if isa-l fails the in place encoding configure check
+    void EncodeBatchWriteTest( size_t batch )
+    {
+      Config &cfg = Config::Instance();
+      size_t encode_batch = cfg.encode_batch;
+      cfg.encode_batch = batch;
+      VarlenWriteTest( 77, true );
+      cfg.encode_batch = encode_batch;
+    }
+
     void Verify()
     {
       ReadVerifyAll();
@@ -294,6 +306,16 @@ TEST_F(XrdEcTests, AlignedWrite2MissingTest)
   AlignedWrite2MissingTest();
 }
 
+TEST_F(XrdEcTests, BlockByBlockEncodeWriteTest)
+{
+  EncodeBatchWriteTest( 1 );
+}
+
+TEST_F(XrdEcTests, BatchEncodeWriteTest)
+{
+  EncodeBatchWriteTest( 3 );
+}
+
 TEST_F(XrdEcTests, AlignedWriteTestIsalCrcNoMt)
 {
   AlignedWriteTestIsalCrcNoMt();
@@ -0,0 +1,418 @@
+#include "XrdHttp/XrdHttpHpack.hh"
+#include "XrdHttp/XrdHttpH2Session.hh"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string unhex(const char *hex) {
+  std::string out;
+  for (const char *p = hex; *p;) {
+    if (*p == ' ') { ++p; continue; }
+    out += static_cast<char>(std::stoi(std::string(p, 2), nullptr, 16));
+    p += 2;
+  }
+  return out;
+}
+
+bool decode(XrdHttpHpack::Decoder &dec, const char *hex,
+            XrdHttpHpack::HeaderList &hdrs) {
+  std::string blk = unhex(hex);
+  hdrs.clear();
+  return dec.Decode(reinterpret_cast<const uint8_t *>(blk.data()), blk.size(), hdrs);
+}
+
+struct Frame {
+  uint8_t     type;
+  uint8_t     flags;
+  uint32_t    id;
+  std::string payload;
+};
+
+std::string frame(uint8_t type, uint8_t flags, uint32_t id, const std::string &p = "") {
+  std::string f;
+  f += static_cast<char>(p.size() >> 16);
+  f += static_cast<char>(p.size() >> 8);
+  f += static_cast<char>(p.size());
+  f += static_cast<char>(type);
+  f += static_cast<char>(flags);
+  f += static_cast<char>(id >> 24);
+  f += static_cast<char>(id >> 16);
+  f += static_cast<char>(id >> 8);
+  f += static_cast<char>(id);
+  return f + p;
+}
+
+std::string u32(uint32_t v) {
+  std::string s;
+  for (int i = 3; i >= 0; --i) s += static_cast<char>(v >> (8 * i));
+  return s;
+}
+
+std::string headers(uint32_t id, const XrdHttpHpack::HeaderList &hdrs, bool end) {
+  std::string blk;
+  XrdHttpHpack::Encode(hdrs, blk);
+  return frame(1, 0x4 | (end ? 0x1 : 0), id, blk);
+}
+
+std::string get(uint32_t id, const char *path) {
+  return headers(id, {{":method", "GET"}, {":scheme", "https"},
+                      {":path", path}, {":authority", "example.org"}}, true);
+}
+
+const std::string preface = std::string("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n") + frame(4, 0, 0);
+
+// A client on the other end of a session: every recv() returns the next
+// segment of input, and everything sent is kept for inspection.
+struct Peer {
+  std::deque<std::string> in;
+  std::string             out;
+
+  XrdHttpH2Session::RecvFunc Recv() {
+    return [this](char *buff, int blen, bool wait) -> int {
+      if (in.empty()) return wait ? -1 : 0;
+      std::string &seg = in.front();
+      int n = std::min<int>(blen, seg.size());
+      seg.copy(buff, n);
+      seg.erase(0, n);
+      if (seg.empty()) in.pop_front();
+      return n;
+    };
+  }
+
+  XrdHttpH2Session::SendFunc Send() {
+    return [this](const char *buff, int blen) -> int {
+      out.append(buff, blen);
+      return 0;
+    };
+  }
+
+  // Take the frames sent so far
+  std::vector<Frame> Frames() {
+    std::vector<Frame> frames;
+    size_t pos = 0;
+    while (out.size() - pos >= 9) {
+      const uint8_t *h = reinterpret_cast<const uint8_t *>(out.data()) + pos;
+      uint32_t len = (h[0] << 16) | (h[1] << 8) | h[2];
+      Frame f{h[3], h[4], ((uint32_t(h[5]) << 24) | (h[6] << 16) | (h[7] << 8) | h[8]) & 0x7fffffffu,
+              out.substr(pos + 9, len)};
+      frames.push_back(f);
+      pos += 9 + len;
+    }
+    out.erase(0, pos);
+    return frames;
+  }
+};
+
+std::string readAll(XrdHttpH2Session &s) {
+  std::string req;
+  char buff[256];
+  int n;
+  while ((n = s.Read(buff, sizeof(buff), false)) > 0) req.append(buff, n);
+  return req;
+}
+
+} // namespace
+
+// RFC 7541 C.4: requests with Huffman coding
+TEST(XrdHttpHpack, RequestExamples) {
+  XrdHttpHpack::Decoder dec;
+  XrdHttpHpack::HeaderList hdrs;
+
+  ASSERT_TRUE(decode(dec, "8286 8441 8cf1 e3c2 e5f2 3a6b a0ab 90f4 ff", hdrs));
+  ASSERT_EQ(hdrs.size(), 4u);
+  EXPECT_EQ(hdrs[0].second, "GET");
+  EXPECT_EQ(hdrs[1].second, "http");
+  EXPECT_EQ(hdrs[2].second, "/");
+  EXPECT_EQ(hdrs[3], std::make_pair(std::string(":authority"), std::string("www.example.com")));
+  EXPECT_EQ(dec.TableSize(), 57u);
+
+  ASSERT_TRUE(decode(dec, "8286 84be 5886 a8eb 1064 9cbf", hdrs));
+  ASSERT_EQ(hdrs.size(), 5u);
+  EXPECT_EQ(hdrs[3].second, "www.example.com");
+  EXPECT_EQ(hdrs[4], std::make_pair(std::string("cache-control"), std::string("no-cache")));
+  EXPECT_EQ(dec.TableSize(), 110u);
+
+  ASSERT_TRUE(decode(dec, "8287 85bf 4088 25a8 49e9 5ba9 7d7f 8925 a849 e95b b8e8 b4bf", hdrs));
+  ASSERT_EQ(hdrs.size(), 5u);
+  EXPECT_EQ(hdrs[1].second, "https");
+  EXPECT_EQ(hdrs[2].second, "/index.html");
+  EXPECT_EQ(hdrs[4], std::make_pair(std::string("custom-key"), std::string("custom-value")));
+  EXPECT_EQ(dec.TableSize(), 164u);
+}
+
+// RFC 7541 C.6: responses with Huffman coding, evicting table entries
+TEST(XrdHttpHpack, ResponseExamples) {
+  XrdHttpHpack::Decoder dec(256);
+  XrdHttpHpack::HeaderList hdrs;
+
+  ASSERT_TRUE(decode(dec, "4882 6402 5885 aec3 771a 4b61 96d0 7abe 9410 54d4 44a8 2005 9504 0b81 66e0 82a6 "
+                          "2d1b ff6e 919d 29ad 1718 63c7 8f0b 97c8 e9ae 82ae 43d3", hdrs));
+  ASSERT_EQ(hdrs.size(), 4u);
+  EXPECT_EQ(hdrs[0].second, "302");
+  EXPECT_EQ(hdrs[2].second, "Mon, 21 Oct 2013 20:13:21 GMT");
+  EXPECT_EQ(hdrs[3].second, "https://www.example.com");
+  EXPECT_EQ(dec.TableSize(), 222u);
+
+  ASSERT_TRUE(decode(dec, "4883 640e ffc1 c0bf", hdrs));
+  ASSERT_EQ(hdrs.size(), 4u);
+  EXPECT_EQ(hdrs[0].second, "307");
+  EXPECT_EQ(hdrs[1].second, "private");
+  EXPECT_EQ(dec.TableSize(), 222u);
+
+  ASSERT_TRUE(decode(dec, "88c1 6196 d07a be94 1054 d444 a820 0595 040b 8166 e084 a62d 1bff c05a 839b d9ab "
+                          "77ad 94e7 821d d7f2 e6c7 b335 dfdf cd5b 3960 d5af 2708 7f36 72c1 ab27 0fb5 291f "
+                          "9587 3160 65c0 03ed 4ee5 b106 3d50 07", hdrs));
+  ASSERT_EQ(hdrs.size(), 6u);
+  EXPECT_EQ(hdrs[0].second, "200");
+  EXPECT_EQ(hdrs[4], std::make_pair(std::string("content-encoding"), std::string("gzip")));
+  EXPECT_EQ(hdrs[5].second, "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1");
+  EXPECT_EQ(dec.TableSize(), 215u);
+}
+
+TEST(XrdHttpHpack, Errors) {
+  XrdHttpHpack::Decoder dec;
+  XrdHttpHpack::HeaderList hdrs;
+
+  EXPECT_FALSE(decode(dec, "80", hdrs));        // index 0
+  EXPECT_FALSE(decode(dec, "be", hdrs));        // beyond an empty dynamic table
+  EXPECT_FALSE(decode(dec, "3fe21f", hdrs));    // table size above the limit
+  EXPECT_FALSE(decode(dec, "8220", hdrs));      // table size update not first
+  EXPECT_FALSE(decode(dec, "0081ff", hdrs));    // Huffman padding of 8 bits
+  EXPECT_FALSE(decode(dec, "4003", hdrs));      // truncated name
+}
+
+TEST(XrdHttpHpack, RoundTrip) {
+  XrdHttpHpack::HeaderList in = {
+    {":status", "200"}, {":status", "206"}, {"content-length", "1048576"},
+    {"content-type", "multipart/byteranges; boundary=123456"},
+    {"x-custom", std::string("\0\x01\xff binary", 10)}, {"etag", ""}};
+  std::string blk;
+  XrdHttpHpack::Encode(in, blk);
+
+  XrdHttpHpack::Decoder dec;
+  XrdHttpHpack::HeaderList out;
+  ASSERT_TRUE(dec.Decode(reinterpret_cast<const uint8_t *>(blk.data()), blk.size(), out));
+  EXPECT_EQ(in, out);
+  // Nothing is added to the table of the peer
+  EXPECT_EQ(dec.TableSize(), 0u);
+
+  std::string all, coded, back;
+  for (int c = 0; c < 256; ++c) all += static_cast<char>(c);
+  XrdHttpHpack::HuffmanEncode(all, coded);
+  EXPECT_EQ(coded.size(), XrdHttpHpack::HuffmanLength(all));
+  ASSERT_TRUE(XrdHttpHpack::HuffmanDecode(reinterpret_cast<const uint8_t *>(coded.data()),
+                                          coded.size(), back));
+  EXPECT_EQ(back, all);
+}
+
+// A request is handed out in HTTP/1.1 form and the response framed.
+TEST(XrdHttpH2Session, SimpleRequest) {
+  Peer peer;
+  XrdHttpH2Session s(peer.Recv(), peer.Send());
+  ASSERT_EQ(s.Start(), 0);
+
+  auto frames = peer.Frames();
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(frames[0].type, 4);   // SETTINGS
+  EXPECT_EQ(frames[1].type, 8);   // WINDOW_UPDATE
+
+  peer.in.push_back(preface + headers(1, {{":method", "GET"}, {":scheme", "https"},
+                                          {":path", "/data/f?a=1"}, {":authority", "example.org"},
+                                          {"cookie", "a=1"}, {"cookie", "b=2"}}, true));
+  EXPECT_EQ(readAll(s), "");
+  ASSERT_TRUE(s.NextStream());
+  EXPECT_EQ(s.StreamID(), 1u);
+  EXPECT_EQ(readAll(s), "GET /data/f?a=1 HTTP/1.1\r\nhost: example.org\r\ncookie: a=1; b=2\r\n\r\n");
+  EXPECT_FALSE(s.Served());
+
+  ASSERT_EQ(s.SendHeaders("HTTP/1.1 200 OK\r\nConnection: Keep-Alive\r\nServer: XRootD\r\n"
+                          "Content-Length: 5\r\n\r\n", false), 0);
+  EXPECT_TRUE(s.Served());
+  ASSERT_EQ(s.SendData("hello", 5), 0);
+
+  frames = peer.Frames();
+  ASSERT_EQ(frames.size(), 3u);
+  EXPECT_EQ(frames[0].type, 4);   // SETTINGS ACK
+  EXPECT_EQ(frames[0].flags, 1);
+  ASSERT_EQ(frames[1].type, 1);
+  EXPECT_EQ(frames[1].flags, 0x4);
+
+  XrdHttpHpack::Decoder dec;
+  XrdHttpHpack::HeaderList hdrs;
+  ASSERT_TRUE(dec.Decode(reinterpret_cast<const uint8_t *>(frames[1].payload.data()),
+                         frames[1].payload.size(), hdrs));
+  XrdHttpHpack::HeaderList want = {{":status", "200"}, {"server", "XRootD"}, {"content-length", "5"}};
+  EXPECT_EQ(hdrs, want);
+
+  EXPECT_EQ(frames[2].type, 0);
+  EXPECT_EQ(frames[2].flags, 1);  // END_STREAM once Content-Length is sent
+  EXPECT_EQ(frames[2].id, 1u);
+  EXPECT_EQ(frames[2].payload, "hello");
+  EXPECT_FALSE(s.Failed());
+}
+
+// A body without length is chunk encoded, and the response to it ends with
+// a trailer.
+TEST(XrdHttpH2Session, ChunkedUpload) {
+  Peer peer;
+  XrdHttpH2Session s(peer.Recv(), peer.Send());
+  ASSERT_EQ(s.Start(), 0);
+  peer.in.push_back(preface + headers(1, {{":method", "PUT"}, {":scheme", "https"},
+                                          {":path", "/up"}, {":authority", "h"}}, false) +
+                    frame(0, 0, 1, "abc") + frame(0, 0x9, 1, std::string("\x02xyz\0\0", 6)));
+  readAll(s);
+  ASSERT_TRUE(s.NextStream());
+  EXPECT_EQ(readAll(s), "PUT /up HTTP/1.1\r\nhost: h\r\ntransfer-encoding: chunked\r\n\r\n"
+                        "3\r\nabc\r\n3\r\nxyz\r\n0\r\n\r\n");
+  peer.Frames();
+
+  ASSERT_EQ(s.SendHeaders("HTTP/1.1 201 Created\r\nTransfer-Encoding: chunked\r\n\r\n", false), 0);
+  ASSERT_EQ(s.SendData("ok", 2), 0);
+  ASSERT_EQ(s.EndStream("X-Transfer-Status: 200: OK\r\n"), 0);
+
+  auto frames = peer.Frames();
+  ASSERT_EQ(frames.size(), 3u);
+  EXPECT_EQ(frames[0].flags, 0x4);
+  EXPECT_EQ(frames[1].flags, 0);
+  EXPECT_EQ(frames[2].type, 1);
+  EXPECT_EQ(frames[2].flags, 0x5);
+
+  XrdHttpHpack::Decoder dec;
+  XrdHttpHpack::HeaderList hdrs;
+  ASSERT_TRUE(dec.Decode(reinterpret_cast<const uint8_t *>(frames[0].payload.data()),
+                         frames[0].payload.size(), hdrs));
+  EXPECT_EQ(hdrs, XrdHttpHpack::HeaderList({{":status", "201"}}));
+  hdrs.clear();
+  ASSERT_TRUE(dec.Decode(reinterpret_cast<const uint8_t *>(frames[2].payload.data()),
+                         frames[2].payload.size(), hdrs));
+  EXPECT_EQ(hdrs, XrdHttpHpack::HeaderList({{"x-transfer-status", "200: OK"}}));
+}
+
+// Streams are served one after the other; refused and malformed ones reset.
+TEST(XrdHttpH2Session, Streams) {
+  Peer peer;
+  XrdHttpH2Session s(peer.Recv(), peer.Send(), 2);
+  ASSERT_EQ(s.Start(), 0);
+  peer.Frames();
+  peer.in.push_back(preface + get(1, "/a") + get(3, "/b") + get(5, "/c") +
+                    headers(7, {{":method", "GET"}, {":path", "/d e"}}, true));
+  readAll(s);
+
+  ASSERT_TRUE(s.NextStream());
+  EXPECT_EQ(s.StreamID(), 1u);
+  EXPECT_EQ(readAll(s).substr(0, 14), "GET /a HTTP/1.");
+  ASSERT_EQ(s.SendHeaders("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n", false), 0);
+
+  ASSERT_TRUE(s.NextStream());
+  EXPECT_EQ(s.StreamID(), 3u);
+  ASSERT_EQ(s.SendHeaders("HTTP/1.1 200 OK\r\n\r\n", true), 0);
+  EXPECT_FALSE(s.NextStream());
+
+  auto frames = peer.Frames();
+  ASSERT_EQ(frames.size(), 5u);
+  EXPECT_EQ(frames[0].type, 4);          // SETTINGS ACK
+  // Stream 5 is beyond the limit of 2, stream 7 has a space in its path
+  EXPECT_EQ(frames[1].type, 3);
+  EXPECT_EQ(frames[1].id, 5u);
+  EXPECT_EQ(frames[1].payload, u32(7));  // REFUSED_STREAM
+  EXPECT_EQ(frames[2].type, 3);
+  EXPECT_EQ(frames[2].id, 7u);
+  EXPECT_EQ(frames[2].payload, u32(1));  // PROTOCOL_ERROR
+  EXPECT_EQ(frames[3].id, 1u);
+  EXPECT_EQ(frames[3].flags, 0x5);
+  EXPECT_EQ(frames[4].id, 3u);
+  EXPECT_EQ(frames[4].flags, 0x5);
+  EXPECT_FALSE(s.Failed());
+}
+
+// By default a single stream may be open. A stream whose response is
+// complete makes room for the next one right away.
+TEST(XrdHttpH2Session, SingleStream) {
+  Peer peer;
+  XrdHttpH2Session s(peer.Recv(), peer.Send());
+  ASSERT_EQ(s.Start(), 0);
+  auto frames = peer.Frames();
+  ASSERT_FALSE(frames.empty());
+  ASSERT_EQ(frames[0].type, 4);
+  std::string maxStreams = std::string("\x00\x03", 2) + u32(1);
+  bool found = false;
+  for (size_t i = 0; i + 6 <= frames[0].payload.size(); i += 6)
+    if (frames[0].payload.substr(i, 6) == maxStreams) found = true;
+  EXPECT_TRUE(found) << "SETTINGS_MAX_CONCURRENT_STREAMS 1 not sent";
+
+  peer.in.push_back(preface + get(1, "/a") + get(3, "/b"));
+  readAll(s);
+  ASSERT_TRUE(s.NextStream());
+  EXPECT_EQ(s.StreamID(), 1u);
+  EXPECT_EQ(readAll(s).substr(0, 14), "GET /a HTTP/1.");
+  ASSERT_EQ(s.SendHeaders("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n", false), 0);
+
+  peer.in.push_back(get(5, "/c"));
+  readAll(s);
+  ASSERT_TRUE(s.NextStream());
+  EXPECT_EQ(s.StreamID(), 5u);
+  EXPECT_EQ(readAll(s).substr(0, 14), "GET /c HTTP/1.");
+
+  frames = peer.Frames();
+  ASSERT_EQ(frames.size(), 3u);
+  EXPECT_EQ(frames[0].type, 4);          // SETTINGS ACK
+  EXPECT_EQ(frames[1].type, 3);
+  EXPECT_EQ(frames[1].id, 3u);
+  EXPECT_EQ(frames[1].payload, u32(7));  // REFUSED_STREAM
+  EXPECT_EQ(frames[2].id, 1u);
+  EXPECT_EQ(frames[2].flags, 0x5);
+  EXPECT_FALSE(s.Failed());
+}
+
+// Data is held back until the client opens its window.
+TEST(XrdHttpH2Session, FlowControl) {
+  Peer peer;
+  XrdHttpH2Session s(peer.Recv(), peer.Send());
+  ASSERT_EQ(s.Start(), 0);
+  std::string settings = std::string("\x00\x04", 2) + u32(10);  // INITIAL_WINDOW_SIZE
+  peer.in.push_back(std::string("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n") + frame(4, 0, 0, settings) +
+                    get(1, "/"));
+  readAll(s);
+  ASSERT_TRUE(s.NextStream());
+  readAll(s);
+  peer.in.push_back(frame(8, 0, 1, u32(15)));
+  peer.in.push_back(frame(8, 0, 1, u32(100)));
+  peer.Frames();
+
+  ASSERT_EQ(s.SendHeaders("HTTP/1.1 200 OK\r\nContent-Length: 30\r\n\r\n", false), 0);
+  ASSERT_EQ(s.SendData("0123456789abcdefghijklmnopqrst", 30), 0);
+
+  std::vector<size_t> sizes;
+  for (auto &f : peer.Frames())
+    if (f.type == 0) sizes.push_back(f.payload.size());
+  EXPECT_EQ(sizes, std::vector<size_t>({10, 15, 5}));
+  EXPECT_FALSE(s.Failed());
+}
+
+TEST(XrdHttpH2Session, ConnectionErrors) {
+  {
+    Peer peer;
+    XrdHttpH2Session s(peer.Recv(), peer.Send());
+    peer.in.push_back("GET / HTTP/1.1\r\n\r\n");
+    EXPECT_EQ(s.Read(nullptr, 0, false), -1);
+    EXPECT_TRUE(s.Failed());
+    auto frames = peer.Frames();
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].type, 7);    // GOAWAY
+  }
+  {
+    Peer peer;
+    XrdHttpH2Session s(peer.Recv(), peer.Send());
+    peer.in.push_back(preface + frame(8, 0, 0, u32(0x7fffffff)));
+    EXPECT_EQ(s.Read(nullptr, 0, false), -1);
+    auto frames = peer.Frames();
+    ASSERT_FALSE(frames.empty());
+    EXPECT_EQ(frames.back().type, 7);
+    EXPECT_EQ(frames.back().payload.substr(4), u32(3));  // FLOW_CONTROL_ERROR
+  }
+}
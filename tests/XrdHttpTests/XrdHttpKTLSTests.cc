@@ -0,0 +1,180 @@
+#include "XrdHttp/XrdHttpKTLS.hh"
+
+#include "Xrd/XrdInet.hh"
+#include "Xrd/XrdLink.hh"
+#include "Xrd/XrdLinkCtl.hh"
+#include "XrdNet/XrdNetAddr.hh"
+#include "XrdSys/XrdSysError.hh"
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace XrdGlobal
+{
+extern XrdSysError  Log;
+extern XrdInet     *XrdNetTCP;
+}
+
+namespace {
+
+// A connected pair of TCP sockets on the loopback interface; kernel TLS only
+// attaches to TCP sockets.
+bool LoopbackPair(int &srvFD, int &cliFD) {
+  sockaddr_in addr = {};
+  socklen_t alen = sizeof(addr);
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  int lfd = socket(AF_INET, SOCK_STREAM, 0);
+  if (lfd < 0) return false;
+  if (bind(lfd, (sockaddr *)&addr, sizeof(addr)) || listen(lfd, 1)
+  ||  getsockname(lfd, (sockaddr *)&addr, &alen)) {
+    close(lfd);
+    return false;
+  }
+  cliFD = socket(AF_INET, SOCK_STREAM, 0);
+  if (cliFD < 0 || connect(cliFD, (sockaddr *)&addr, sizeof(addr))) {
+    close(lfd);
+    return false;
+  }
+  srvFD = accept(lfd, 0, 0);
+  close(lfd);
+  return srvFD >= 0;
+}
+
+// A server context with a throw-away self-signed certificate, asking
+// OpenSSL to hand the keys to the kernel.
+SSL_CTX *ServerContext() {
+  EVP_PKEY *pkey = nullptr;
+  EVP_PKEY_CTX *pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, nullptr);
+  if (!pctx || EVP_PKEY_keygen_init(pctx) <= 0
+  ||  EVP_PKEY_keygen(pctx, &pkey) <= 0) {
+    EVP_PKEY_CTX_free(pctx);
+    return nullptr;
+  }
+  EVP_PKEY_CTX_free(pctx);
+
+  X509 *x509 = X509_new();
+  ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+  X509_gmtime_adj(X509_getm_notBefore(x509), 0);
+  X509_gmtime_adj(X509_getm_notAfter(x509), 3600);
+  X509_set_pubkey(x509, pkey);
+  X509_NAME *name = X509_get_subject_name(x509);
+  X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                             (const unsigned char *)"localhost", -1, -1, 0);
+  X509_set_issuer_name(x509, name);
+  X509_sign(x509, pkey, nullptr);
+
+  SSL_CTX *ctx = SSL_CTX_new(TLS_server_method());
+  SSL_CTX_use_certificate(ctx, x509);
+  SSL_CTX_use_PrivateKey(ctx, pkey);
+#ifdef SSL_OP_ENABLE_KTLS
+  SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+#endif
+  X509_free(x509);
+  EVP_PKEY_free(pkey);
+  return ctx;
+}
+
+std::string Pattern(size_t len, int seed) {
+  std::string data(len, 0);
+  for (size_t i = 0; i < len; i++) data[i] = (char)(i * 31 + seed);
+  return data;
+}
+
+}
+
+// Runs a TLS session over loopback whose server side writes through the
+// kernel TLS write BIO. Without a kernel tls module OpenSSL encrypts in user
+// space; either way everything the server writes must go through the link.
+// With the module, the key update and the session tickets and alerts are
+// control records that take the socket BIO below.
+TEST(XrdHttpKTLS, LoopbackOffload) {
+  if (!XrdHttpKTLS::Available())
+    GTEST_SKIP() << "OpenSSL without kernel TLS control record support";
+
+  static bool linkSetup = false;
+  if (!linkSetup) {
+    XrdGlobal::XrdNetTCP = new XrdInet(&XrdGlobal::Log);
+    ASSERT_TRUE(XrdLinkCtl::Setup(1024, 0));
+    linkSetup = true;
+  }
+
+  int srvFD, cliFD;
+  ASSERT_TRUE(LoopbackPair(srvFD, cliFD));
+  ASSERT_LT(srvFD, 1024);
+
+  XrdNetAddr peer;
+  ASSERT_EQ(peer.Set(srvFD), nullptr);
+  XrdLink *lp = XrdLinkCtl::Alloc(peer, XRDLINK_NOCLOSE);
+  ASSERT_NE(lp, nullptr);
+
+  SSL_CTX *sctx = ServerContext();
+  ASSERT_NE(sctx, nullptr);
+  SSL *srv = SSL_new(sctx);
+  BIO *wbio = XrdHttpKTLS::CreateBIO(lp);
+  ASSERT_NE(wbio, nullptr);
+  SSL_set_bio(srv, BIO_new_socket(srvFD, BIO_NOCLOSE), wbio);
+
+  const std::string first = Pattern(256*1024, 1), second = Pattern(64*1024, 7);
+  std::string received;
+  bool cliOK = false;
+
+  std::thread client([&]() {
+    SSL_CTX *cctx = SSL_CTX_new(TLS_client_method());
+    SSL *cli = SSL_new(cctx);
+    SSL_set_fd(cli, cliFD);
+    if (SSL_connect(cli) == 1) {
+      char buff[16384];
+      int n;
+      while ((n = SSL_read(cli, buff, sizeof(buff))) > 0)
+        received.append(buff, n);
+      cliOK = SSL_get_error(cli, n) == SSL_ERROR_ZERO_RETURN;
+    }
+    SSL_free(cli);
+    SSL_CTX_free(cctx);
+  });
+
+  const int accepted = SSL_accept(srv);
+  if (accepted == 1) {
+    const bool offload = BIO_get_ktls_send(SSL_get_wbio(srv));
+    std::cerr << "Kernel TLS " << (offload ? "active" : "not active")
+              << " for sending" << std::endl;
+
+    EXPECT_EQ(SSL_write(srv, first.data(), first.size()), (int)first.size());
+    EXPECT_EQ(SSL_key_update(srv, SSL_KEY_UPDATE_NOT_REQUESTED), 1);
+    EXPECT_EQ(SSL_write(srv, second.data(), second.size()), (int)second.size());
+    SSL_shutdown(srv);
+  }
+  shutdown(srvFD, SHUT_WR);
+  client.join();
+
+  ASSERT_EQ(accepted, 1);
+  EXPECT_TRUE(cliOK);
+  EXPECT_TRUE(received == first + second);
+
+  // The link saw every byte written: the payload and, in user space, the
+  // record overhead; with the offload, the control records as well.
+  long long inBytes, outBytes;
+  int numStall, numTardy;
+  lp->getIOStats(inBytes, outBytes, numStall, numTardy);
+  EXPECT_GT(outBytes, (long long)(first.size() + second.size()));
+
+  SSL_free(srv);
+  SSL_CTX_free(sctx);
+  close(srvFD);
+  close(cliFD);
+}
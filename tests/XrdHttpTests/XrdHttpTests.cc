@@ -594,6 +594,55 @@ TEST(XrdHttpTests, xrdHttpReadRangeHandlerMultiChunksTwoRanges) {
   }
 }
 
+TEST(XrdHttpTests, xrdHttpReadRangeHandlerCoalesceNearbyRanges) {
+  long long filesize = 100;
+  int readvMaxChunkSize = 20;
+  int readvMaxChunks = 4;
+  int rReqMaxSize = 100;
+  int coalesceGap = 5;
+  bool start, finish;
+  size_t skip, used;
+  const XrdHttpReadRangeHandler::UserRange  *ur;
+  XrdHttpReadRangeHandler::Configuration cfg(readvMaxChunkSize, readvMaxChunks, rReqMaxSize, coalesceGap);
+  XrdHttpReadRangeHandler h(cfg);
+  h.ParseContentRange("bytes=0-3,6-9,30-39");
+  h.SetFilesize(filesize);
+  const XrdHttpReadRangeHandler::UserRangeList &ul = h.ListResolvedRanges();
+  ASSERT_EQ(3u, ul.size());
+  {
+    // we get 0-9 holding the first two ranges, and 30-39
+    const XrdHttpIOList &cl = h.NextReadList();
+    ASSERT_EQ(2u, cl.size());
+    ASSERT_EQ(0, cl[0].offset);
+    ASSERT_EQ(10, cl[0].size);
+    ASSERT_EQ(30, cl[1].offset);
+    ASSERT_EQ(10, cl[1].size);
+    ASSERT_EQ(0, h.NotifyReadResult(10, &ur, start, finish, skip, used));
+    ASSERT_EQ(0u, skip);
+    ASSERT_EQ(4u, used);
+    ASSERT_EQ(true, start);
+    ASSERT_EQ(0, ur->start);
+    ASSERT_EQ(0, h.NotifyReadResult(6, &ur, start, finish, skip, used));
+    ASSERT_EQ(2u, skip);
+    ASSERT_EQ(4u, used);
+    ASSERT_EQ(true, start);
+    ASSERT_EQ(false, finish);
+    ASSERT_EQ(6, ur->start);
+    ASSERT_EQ(0, h.NotifyReadResult(10, &ur, start, finish, skip, used));
+    ASSERT_EQ(0u, skip);
+    ASSERT_EQ(10u, used);
+    ASSERT_EQ(true, start);
+    ASSERT_EQ(true, finish);
+    ASSERT_EQ(30, ur->start);
+  }
+  {
+    const XrdHttpIOList &cl = h.NextReadList();
+    ASSERT_EQ(0u, cl.size());
+    const XrdHttpReadRangeHandler::Error &error = h.getError();
+    ASSERT_EQ(false, static_cast<bool>(error));
+  }
+}
+
 static inline const std::pair<std::string,std::string> encodedDecodedStrings [] {
   {"zteos64%3AMDAF5PGJ4Wa12g%3D","zteos64:MDAF5PGJ4Wa12g="},
   //"zteos64%3BAMDAF5PGJ4Wa12g%3B%3B",
@@ -0,0 +1,263 @@
+#include "XrdOssCsi/XrdOssCsiRanges.hh"
+#include "XrdOssCsi/XrdOssCsiPages.hh"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+// Ranges.cc refers to this for guards holding the tracking length; none of
+// the tests here do.
+void XrdOssCsiPages::TrackedSizeRelease() { }
+
+// Gives the tests access to the treap inside XrdOssCsiRanges.
+class XrdOssCsiTests : public ::testing::Test
+{
+protected:
+   using Node = XrdOssCsiRange_s;
+
+   static Node *&Root(XrdOssCsiRanges &r) { return r.root_; }
+
+   static void Insert(Node *&t, Node *n) { XrdOssCsiRanges::Insert(t, n); }
+   static void Erase(Node *&t, Node *n) { XrdOssCsiRanges::Erase(t, n); }
+   static Node *Merge(Node *a, Node *b) { return XrdOssCsiRanges::Merge(a, b); }
+
+   static std::set<Node*> Overlapping(Node *t, off_t start, off_t end)
+   {
+      std::set<Node*> res;
+      XrdOssCsiRanges::Overlapping(t, start, end, [&](Node *o) { res.insert(o); });
+      return res;
+   }
+
+   // A free-standing node, as AddRange would set it up.
+   Node *NewNode(off_t start, off_t end)
+   {
+      m_nodes.emplace_back(new Node());
+      Node *n = m_nodes.back().get();
+      n->start = start;
+      n->end = end;
+      n->maxend = end;
+      n->left = n->right = NULL;
+      n->seq = m_seq++;
+      n->prio = (uint32_t)m_rng();
+      return n;
+   }
+
+   // Checks search order, heap order and maxend throughout the tree and
+   // returns the nodes in order.
+   static void Check(const Node *t, std::vector<const Node*> &out)
+   {
+      if (!t) return;
+      off_t maxend = t->end;
+      if (t->left)
+      {
+         EXPECT_GE(t->prio, t->left->prio);
+         maxend = std::max(maxend, t->left->maxend);
+      }
+      if (t->right)
+      {
+         EXPECT_GE(t->prio, t->right->prio);
+         maxend = std::max(maxend, t->right->maxend);
+      }
+      EXPECT_EQ(t->maxend, maxend);
+      Check(t->left, out);
+      out.push_back(t);
+      Check(t->right, out);
+   }
+
+   static std::vector<const Node*> Check(const Node *t)
+   {
+      std::vector<const Node*> out;
+      Check(t, out);
+      for (size_t i = 1; i < out.size(); ++i)
+      {
+         EXPECT_TRUE(XrdOssCsiRanges::Before(out[i-1], out[i]));
+      }
+      return out;
+   }
+
+   std::vector<std::unique_ptr<Node>> m_nodes;
+   std::mt19937 m_rng{12345};
+   uint64_t m_seq{0};
+};
+
+// Ranges sharing no page do not see each other; the query is inclusive at
+// both ends.
+TEST_F(XrdOssCsiTests, TreapDisjointAndAdjacent)
+{
+   Node *root = NULL;
+   Node *a = NewNode(0, 4);
+   Node *b = NewNode(5, 9);
+   Node *c = NewNode(20, 29);
+   Insert(root, c);
+   Insert(root, a);
+   Insert(root, b);
+   EXPECT_EQ(Check(root).size(), 3u);
+
+   EXPECT_EQ(Overlapping(root, 10, 19), std::set<Node*>{});
+   EXPECT_EQ(Overlapping(root, 0, 4), std::set<Node*>{a});
+   EXPECT_EQ(Overlapping(root, 5, 5), std::set<Node*>{b});
+   EXPECT_EQ(Overlapping(root, 4, 5), (std::set<Node*>{a, b}));
+   EXPECT_EQ(Overlapping(root, 9, 20), (std::set<Node*>{b, c}));
+   EXPECT_EQ(Overlapping(root, 30, 100), std::set<Node*>{});
+}
+
+// A range inside another one, and one enclosing several, are found from
+// either side. Equal starts are kept in arrival order.
+TEST_F(XrdOssCsiTests, TreapNested)
+{
+   Node *root = NULL;
+   Node *outer = NewNode(0, 100);
+   Node *in1 = NewNode(10, 20);
+   Node *in2 = NewNode(30, 40);
+   Node *same = NewNode(10, 15);
+   for (Node *n : {in2, outer, same, in1}) Insert(root, n);
+
+   auto order = Check(root);
+   ASSERT_EQ(order.size(), 4u);
+   EXPECT_EQ(order[0], outer);
+   EXPECT_EQ(order[1], in1);
+   EXPECT_EQ(order[2], same);
+   EXPECT_EQ(order[3], in2);
+
+   EXPECT_EQ(Overlapping(root, 25, 28), std::set<Node*>{outer});
+   EXPECT_EQ(Overlapping(root, 12, 12), (std::set<Node*>{outer, in1, same}));
+   EXPECT_EQ(Overlapping(root, 16, 35), (std::set<Node*>{outer, in1, in2}));
+
+   Erase(root, outer);
+   Check(root);
+   EXPECT_EQ(Overlapping(root, 25, 28), std::set<Node*>{});
+   EXPECT_EQ(Overlapping(root, 0, 100), (std::set<Node*>{in1, in2, same}));
+
+   Erase(root, in1);
+   Check(root);
+   EXPECT_EQ(Overlapping(root, 0, 100), (std::set<Node*>{in2, same}));
+   EXPECT_EQ(in1->left, nullptr);
+   EXPECT_EQ(in1->right, nullptr);
+}
+
+// Merge joins two trees where every range of the first sorts first.
+TEST_F(XrdOssCsiTests, TreapMerge)
+{
+   Node *lo = NULL, *hi = NULL;
+   for (int i = 0; i < 50; ++i) Insert(lo, NewNode(i*2, i*2 + 500));
+   for (int i = 0; i < 50; ++i) Insert(hi, NewNode(100 + i, 101 + i));
+
+   Node *root = Merge(lo, hi);
+   auto order = Check(root);
+   ASSERT_EQ(order.size(), 100u);
+   EXPECT_EQ(root->maxend, 98 + 500);
+   EXPECT_EQ(Overlapping(root, 599, 1000).size(), 0u);
+   EXPECT_EQ(Overlapping(root, 149, 149).size(), 50u + 2u);
+
+   EXPECT_EQ(Merge(NULL, hi), hi);
+   EXPECT_EQ(Merge(hi, NULL), hi);
+}
+
+// Random inserts and erases agree with a linear scan.
+TEST_F(XrdOssCsiTests, TreapMatchesScan)
+{
+   Node *root = NULL;
+   std::vector<Node*> live;
+   std::uniform_int_distribution<int> pos(0, 999), len(0, 40);
+
+   for (int round = 0; round < 2000; ++round)
+   {
+      if (live.empty() || m_rng() % 3)
+      {
+         const off_t s = pos(m_rng);
+         Node *n = NewNode(s, s + len(m_rng));
+         Insert(root, n);
+         live.push_back(n);
+      }
+      else
+      {
+         const size_t i = m_rng() % live.size();
+         Erase(root, live[i]);
+         live.erase(live.begin() + i);
+      }
+
+      if (round % 50) continue;
+      EXPECT_EQ(Check(root).size(), live.size());
+      for (int q = 0; q < 20; ++q)
+      {
+         const off_t s = pos(m_rng), e = s + len(m_rng);
+         std::set<Node*> expect;
+         for (Node *n : live)
+         {
+            if (n->start <= e && s <= n->end) expect.insert(n);
+         }
+         ASSERT_EQ(Overlapping(root, s, e), expect);
+      }
+   }
+}
+
+// AddRange counts the ranges a new one has to wait for, read-only ranges
+// only wait for writers, and RemoveRange releases the waiters.
+TEST_F(XrdOssCsiTests, RangesBlocking)
+{
+   XrdOssCsiRanges r;
+   XrdOssCsiRangeGuard g1, g2, g3, g4, g5;
+
+   r.AddRange(0, 9, g1, true);
+   r.AddRange(5, 14, g2, true);
+   r.AddRange(10, 19, g3, false);
+   r.AddRange(20, 29, g4, false);
+   r.AddRange(0, 100, g5, true);
+
+   std::vector<const Node*> order = Check(Root(r));
+   ASSERT_EQ(order.size(), 5u);
+   auto blocked = [&](off_t start) {
+      for (const Node *n : order) if (n->start == start && n->end != 100) return n->nBlockedBy;
+      return -1;
+   };
+   EXPECT_EQ(blocked(0), 0);
+   EXPECT_EQ(blocked(5), 0);
+   EXPECT_EQ(blocked(10), 1);
+   EXPECT_EQ(blocked(20), 0);
+   const Node *all = NULL;
+   for (const Node *n : order) if (n->end == 100) all = n;
+   ASSERT_NE(all, nullptr);
+   EXPECT_EQ(all->nBlockedBy, 2);
+
+   g2.ReleaseAll();
+   EXPECT_EQ(blocked(10), 0);
+   EXPECT_EQ(all->nBlockedBy, 2);
+   g3.ReleaseAll();
+   g4.ReleaseAll();
+   EXPECT_EQ(all->nBlockedBy, 0);
+   g5.Wait();
+
+   g1.ReleaseAll();
+   g5.ReleaseAll();
+   EXPECT_EQ(Root(r), nullptr);
+}
+
+// A guard blocked by an overlapping writer waits until it is released.
+TEST_F(XrdOssCsiTests, RangesWait)
+{
+   XrdOssCsiRanges r;
+   XrdOssCsiRangeGuard first;
+   r.AddRange(3, 7, first, false);
+
+   std::atomic<bool> done{false};
+   std::thread t([&] {
+      XrdOssCsiRangeGuard second;
+      r.AddRange(7, 7, second, true);
+      second.Wait();
+      done = true;
+   });
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(50));
+   EXPECT_FALSE(done);
+   first.ReleaseAll();
+   t.join();
+   EXPECT_TRUE(done);
+   EXPECT_EQ(Root(r), nullptr);
+}
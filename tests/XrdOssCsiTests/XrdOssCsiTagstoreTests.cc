@@ -0,0 +1,310 @@
+#include "XrdOssCsi/XrdOssCsiTagstoreFile.hh"
+#include "XrdOuc/XrdOucCRC.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include "XrdOuc/XrdOucTrace.hh"
+#include "XrdSys/XrdSysError.hh"
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+XrdSysError OssCsiEroute(0, "csi_");
+XrdOucTrace OssCsiTrace(&OssCsiEroute);
+
+namespace
+{
+   // A tag file held in memory, which records the writes made to it.
+   struct MemFile
+   {
+      std::mutex mtx;
+      std::vector<uint8_t> data;
+      std::vector<std::pair<off_t, size_t>> writes;
+      int nreads = 0;
+      int readErr = 0;
+
+      uint32_t Raw(off_t off)
+      {
+         std::lock_guard<std::mutex> guard(mtx);
+         uint32_t v = 0;
+         if (off + 4 <= (off_t)data.size()) memcpy(&v, &data[off], 4);
+         return v;
+      }
+   };
+
+   class MemDF : public XrdOssDF
+   {
+   public:
+      explicit MemDF(MemFile &f) : m_f(f) { }
+
+      int Open(const char *, int, mode_t, XrdOucEnv &) override { return 0; }
+      int Close(long long * = 0) override { return 0; }
+      int Fsync() override { return 0; }
+
+      int Fstat(struct stat *buf) override
+      {
+         std::lock_guard<std::mutex> guard(m_f.mtx);
+         memset(buf, 0, sizeof(*buf));
+         buf->st_size = m_f.data.size();
+         return 0;
+      }
+
+      int Ftruncate(unsigned long long flen) override
+      {
+         std::lock_guard<std::mutex> guard(m_f.mtx);
+         m_f.data.resize(flen);
+         return 0;
+      }
+
+      ssize_t Read(void *buffer, off_t offset, size_t size) override
+      {
+         std::lock_guard<std::mutex> guard(m_f.mtx);
+         m_f.nreads++;
+         if (m_f.readErr) return -m_f.readErr;
+         if (offset >= (off_t)m_f.data.size()) return 0;
+         size = std::min(size, m_f.data.size() - offset);
+         memcpy(buffer, &m_f.data[offset], size);
+         return size;
+      }
+
+      ssize_t Write(const void *buffer, off_t offset, size_t size) override
+      {
+         std::lock_guard<std::mutex> guard(m_f.mtx);
+         m_f.writes.emplace_back(offset, size);
+         if (offset + size > m_f.data.size()) m_f.data.resize(offset + size);
+         memcpy(&m_f.data[offset], buffer, size);
+         return size;
+      }
+
+   private:
+      MemFile &m_f;
+   };
+
+   std::unique_ptr<XrdOssCsiTagstoreFile> OpenStore(MemFile &f, off_t dsize)
+   {
+      std::unique_ptr<XrdOssCsiTagstoreFile> ts(
+         new XrdOssCsiTagstoreFile("test", std::unique_ptr<XrdOssDF>(new MemDF(f)), "tid"));
+      XrdOucEnv env;
+      EXPECT_EQ(ts->Open("test", dsize, O_RDWR, env), 0);
+      return ts;
+   }
+
+   // Byte offset of tag i in the tag file.
+   off_t TagOff(off_t i) { return 20 + 4*i; }
+}
+
+// Tags reach the file only on WriteBack. Dirty bytes continuing across pages
+// are written with one call.
+TEST(OssCsiTagstore, WriteBackJoinsPages)
+{
+   MemFile f;
+   auto ts = OpenStore(f, 0);
+
+   const size_t n = 2048;
+   std::vector<uint32_t> tags(n);
+   for (size_t i = 0; i < n; ++i) tags[i] = 0x1000 + i;
+
+   f.writes.clear();
+   ASSERT_EQ(ts->WriteTags(tags.data(), 0, n), (ssize_t)n);
+   EXPECT_TRUE(f.writes.empty());
+
+   std::vector<uint32_t> back(n);
+   ASSERT_EQ(ts->ReadTags(back.data(), 0, n), (ssize_t)n);
+   EXPECT_EQ(back, tags);
+
+   ASSERT_EQ(ts->WriteBack(), 0);
+   ASSERT_EQ(f.writes.size(), 1u);
+   EXPECT_EQ(f.writes[0], std::make_pair((off_t)20, 4*n));
+   for (size_t i = 0; i < n; ++i) ASSERT_EQ(f.Raw(TagOff(i)), tags[i]);
+
+   f.writes.clear();
+   ASSERT_EQ(ts->WriteBack(), 0);
+   EXPECT_TRUE(f.writes.empty());
+   ASSERT_EQ(ts->Close(), 0);
+}
+
+// Once more pages are in use than the cache holds, the least recently used
+// dirty page is written out before it is dropped.
+TEST(OssCsiTagstore, EvictionWritesDirty)
+{
+   MemFile f;
+   auto ts = OpenStore(f, 0);
+
+   // tag 1024*k is in page k of the tagfile
+   for (uint32_t k = 0; k < 16; ++k)
+   {
+      const uint32_t v = 0xa0 + k;
+      ASSERT_EQ(ts->WriteTags(&v, 1024*k, 1), 1);
+   }
+   EXPECT_EQ(f.Raw(TagOff(0)), 0u);
+
+   // page 0 is touched again, so page 1 is now the oldest
+   uint32_t v;
+   ASSERT_EQ(ts->ReadTags(&v, 0, 1), 1);
+   EXPECT_EQ(v, 0xa0u);
+
+   f.writes.clear();
+   v = 0xb0;
+   ASSERT_EQ(ts->WriteTags(&v, 1024*16, 1), 1);
+   ASSERT_EQ(f.writes.size(), 1u);
+   EXPECT_EQ(f.writes[0], std::make_pair(TagOff(1024), (size_t)4));
+   EXPECT_EQ(f.Raw(TagOff(1024)), 0xa1u);
+   EXPECT_EQ(f.Raw(TagOff(0)), 0u);
+
+   // the evicted page is read back from the file
+   const int nreads = f.nreads;
+   ASSERT_EQ(ts->ReadTags(&v, 1024, 1), 1);
+   EXPECT_EQ(v, 0xa1u);
+   EXPECT_EQ(f.nreads, nreads + 1);
+
+   for (uint32_t k = 0; k <= 16; ++k)
+   {
+      ASSERT_EQ(ts->ReadTags(&v, 1024*k, 1), 1);
+      EXPECT_EQ(v, k < 16 ? 0xa0 + k : 0xb0u);
+   }
+   ASSERT_EQ(ts->Close(), 0);
+}
+
+// Flush and Close write pending tags.
+TEST(OssCsiTagstore, FlushAndCloseWriteDirty)
+{
+   MemFile f;
+   auto ts = OpenStore(f, 0);
+
+   uint32_t v = 0x1234;
+   ASSERT_EQ(ts->WriteTags(&v, 5, 1), 1);
+   EXPECT_EQ(f.Raw(TagOff(5)), 0u);
+   ts->Flush();
+   EXPECT_EQ(f.Raw(TagOff(5)), 0x1234u);
+
+   ASSERT_EQ(ts->SetTrackedSize(6001*XrdSys::PageSize), 0);
+   v = 0x5678;
+   ASSERT_EQ(ts->WriteTags(&v, 6000, 1), 1);
+   EXPECT_EQ(f.Raw(TagOff(6000)), 0u);
+   ASSERT_EQ(ts->Close(), 0);
+   EXPECT_EQ(f.Raw(TagOff(6000)), 0x5678u);
+
+   // header and tags are found again on reopen
+   ts = OpenStore(f, 6001*XrdSys::PageSize);
+   EXPECT_EQ(ts->GetTrackedTagSize(), 6001*XrdSys::PageSize);
+   ASSERT_EQ(ts->ReadTags(&v, 5, 1), 1);
+   EXPECT_EQ(v, 0x1234u);
+   ASSERT_EQ(ts->ReadTags(&v, 6000, 1), 1);
+   EXPECT_EQ(v, 0x5678u);
+}
+
+// A tagfile written on a machine of the other byte order is read and written
+// in that order.
+TEST(OssCsiTagstore, ByteSwapped)
+{
+   MemFile f;
+   const uint64_t tlen = 2*XrdSys::PageSize;
+   f.data.resize(TagOff(2));
+
+   uint32_t y = bswap_32(0x30544452U);
+   memcpy(&f.data[0], &y, 4);
+   uint64_t x = bswap_64(tlen);
+   memcpy(&f.data[4], &x, 8);
+   y = 0;
+   memcpy(&f.data[12], &y, 4);
+   y = bswap_32(XrdOucCRC::Calc32C(&f.data[0], 16, 0U));
+   memcpy(&f.data[16], &y, 4);
+   y = bswap_32(0x11223344U);
+   memcpy(&f.data[TagOff(0)], &y, 4);
+   y = bswap_32(0x55667788U);
+   memcpy(&f.data[TagOff(1)], &y, 4);
+
+   auto ts = OpenStore(f, tlen);
+   EXPECT_EQ(ts->GetTrackedTagSize(), (off_t)tlen);
+   EXPECT_FALSE(ts->IsVerified());
+
+   uint32_t tags[2];
+   ASSERT_EQ(ts->ReadTags(tags, 0, 2), 2);
+   EXPECT_EQ(tags[0], 0x11223344U);
+   EXPECT_EQ(tags[1], 0x55667788U);
+
+   tags[1] = 0xdeadbeefU;
+   ASSERT_EQ(ts->WriteTags(&tags[1], 1, 1), 1);
+   ASSERT_EQ(ts->WriteBack(), 0);
+   EXPECT_EQ(f.Raw(TagOff(1)), bswap_32(0xdeadbeefU));
+
+   // header updates keep the file's byte order
+   ASSERT_EQ(ts->Truncate(3*XrdSys::PageSize, true), 0);
+   EXPECT_EQ(f.Raw(0), bswap_32(0x30544452U));
+   ASSERT_EQ(ts->Close(), 0);
+
+   ts = OpenStore(f, 3*XrdSys::PageSize);
+   EXPECT_EQ(ts->GetTrackedTagSize(), 3*XrdSys::PageSize);
+   ASSERT_EQ(ts->ReadTags(tags, 0, 2), 2);
+   EXPECT_EQ(tags[1], 0xdeadbeefU);
+}
+
+// Reads past the end of the tagfile and headers with a bad checksum are
+// reported as EDOM. A failed page read is not cached.
+TEST(OssCsiTagstore, Errors)
+{
+   MemFile f;
+   auto ts = OpenStore(f, 0);
+
+   uint32_t v = 7;
+   ASSERT_EQ(ts->WriteTags(&v, 0, 1), 1);
+   uint32_t two[2];
+   EXPECT_EQ(ts->ReadTags(two, 0, 2), -EDOM);
+   EXPECT_EQ(ts->ReadTags(two, 0, 1), 1);
+   ASSERT_EQ(ts->Truncate(3000*XrdSys::PageSize, true), 0);
+
+   f.readErr = EIO;
+   EXPECT_EQ(ts->ReadTags(two, 2000, 2), -EIO);
+   f.readErr = 0;
+   ASSERT_EQ(ts->ReadTags(two, 2000, 2), 2);
+   EXPECT_EQ(two[0], 0u);
+   ASSERT_EQ(ts->Close(), 0);
+
+   f.data[17] ^= 0x01;
+   std::unique_ptr<XrdOssCsiTagstoreFile> bad(
+      new XrdOssCsiTagstoreFile("test", std::unique_ptr<XrdOssDF>(new MemDF(f)), "tid"));
+   XrdOucEnv env;
+   EXPECT_EQ(bad->Open("test", 3000*XrdSys::PageSize, O_RDWR, env), -EDOM);
+}
+
+// Threads sharing tag pages, each with its own tags, see their own updates
+// while pages are read in and evicted by the others.
+TEST(OssCsiTagstore, Concurrent)
+{
+   MemFile f;
+   auto ts = OpenStore(f, 0);
+   const int nthreads = 4, ntags = 40*1024;
+   ASSERT_EQ(ts->Truncate((off_t)ntags*XrdSys::PageSize, true), 0);
+
+   std::vector<std::thread> threads;
+   std::vector<int> failures(nthreads, 0);
+   for (int t = 0; t < nthreads; ++t)
+   {
+      threads.emplace_back([&, t] {
+         for (int round = 0; round < 2; ++round)
+         {
+            for (int i = t; i < ntags; i += nthreads)
+            {
+               const uint32_t v = i * 2654435761U + round;
+               if (ts->WriteTags(&v, i, 1) != 1) failures[t]++;
+               uint32_t r;
+               if (ts->ReadTags(&r, i, 1) != 1 || r != v) failures[t]++;
+            }
+         }
+      });
+   }
+   for (auto &th : threads) th.join();
+   for (int t = 0; t < nthreads; ++t) EXPECT_EQ(failures[t], 0);
+
+   ASSERT_EQ(ts->Close(), 0);
+   for (int i = 0; i < ntags; ++i)
+   {
+      ASSERT_EQ(f.Raw(TagOff(i)), i * 2654435761U + 1);
+   }
+}
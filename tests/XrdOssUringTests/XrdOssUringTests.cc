@@ -0,0 +1,223 @@
+#undef NDEBUG
+
+#include "XrdOss/XrdOssUring.hh"
+#include "XrdOuc/XrdOucIOVec.hh"
+#include "XrdSfs/XrdSfsAio.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern XrdSysError OssEroute;
+
+namespace {
+
+class TestAio : public XrdSfsAio {
+public:
+  XrdSysSemaphore   done{0};
+  std::atomic<int>  nRead{0}, nWrite{0};
+
+  void doneRead()  override { nRead++;  done.Post(); }
+  void doneWrite() override { nWrite++; done.Post(); }
+  void Recycle()   override { }
+
+  void Set(void *buff, size_t blen, off_t offs) {
+    sfsAio.aio_buf    = buff;
+    sfsAio.aio_nbytes = blen;
+    sfsAio.aio_offset = offs;
+  }
+};
+
+// The rings are set up once per process and never torn down.
+class XrdOssUringTest : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    OssEroute.logger(new XrdSysLogger(STDERR_FILENO, 0));
+    usable = XrdOssUring::Init(OssEroute, 1, 8);
+  }
+
+  void SetUp() override {
+    if (!usable) GTEST_SKIP() << "io_uring is not usable here";
+    char tmpl[] = "/tmp/xrdossuring-XXXXXX";
+    ASSERT_GE(fd = mkstemp(tmpl), 0);
+    unlink(tmpl);
+  }
+
+  void TearDown() override {
+    if (fd >= 0) close(fd);
+  }
+
+  static bool usable;
+  int fd = -1;
+};
+
+bool XrdOssUringTest::usable = false;
+
+std::string Pattern(size_t len, int seed) {
+  std::string data(len, 0);
+  for (size_t i = 0; i < len; i++) data[i] = (char)(i * 13 + seed);
+  return data;
+}
+
+// The ring's descriptor, there being a single ring.
+int RingFD() {
+  DIR *dP = opendir("/proc/self/fd");
+  struct dirent *eP;
+  char path[300], link[64];
+  int ringFD = -1;
+  ssize_t n;
+
+  if (!dP) return -1;
+  while ((eP = readdir(dP))) {
+    snprintf(path, sizeof(path), "/proc/self/fd/%s", eP->d_name);
+    if ((n = readlink(path, link, sizeof(link) - 1)) <= 0) continue;
+    link[n] = 0;
+    if (!strcmp(link, "anon_inode:[io_uring]")) ringFD = atoi(eP->d_name);
+  }
+  closedir(dP);
+  return ringFD;
+}
+
+}
+
+TEST_F(XrdOssUringTest, WriteReadFsync) {
+  std::string data = Pattern(64*1024, 1), back(data.size(), 0);
+  TestAio aio;
+
+  aio.Set((void *)data.data(), data.size(), 4096);
+  ASSERT_EQ(XrdOssUring::Write(&aio, fd), 0);
+  aio.done.Wait();
+  EXPECT_EQ(aio.nWrite, 1);
+  EXPECT_EQ(aio.Result, (ssize_t)data.size());
+
+  ASSERT_EQ(XrdOssUring::Fsync(&aio, fd), 0);
+  aio.done.Wait();
+  EXPECT_EQ(aio.nWrite, 2);
+  EXPECT_EQ(aio.Result, 0);
+
+  aio.Set((void *)back.data(), back.size(), 4096);
+  ASSERT_EQ(XrdOssUring::Read(&aio, fd), 0);
+  aio.done.Wait();
+  EXPECT_EQ(aio.nRead, 1);
+  EXPECT_EQ(aio.Result, (ssize_t)back.size());
+  EXPECT_TRUE(back == data);
+}
+
+// Many threads submitting at once get batched into one another's
+// io_uring_enter() calls; each request must still complete exactly once.
+TEST_F(XrdOssUringTest, ConcurrentSubmit) {
+  const int nThreads = 8, nReqs = 64, blen = 512;
+  std::string data = Pattern(nThreads * nReqs * blen, 3);
+  ASSERT_EQ(pwrite(fd, data.data(), data.size(), 0), (ssize_t)data.size());
+
+  std::atomic<int> bad{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nThreads; t++) {
+    threads.emplace_back([&, t]() {
+      std::vector<char> buff(blen);
+      TestAio aio;
+      for (int i = 0; i < nReqs; i++) {
+        off_t offs = (off_t)(t * nReqs + i) * blen;
+        aio.Set(buff.data(), blen, offs);
+        int rc;
+        while ((rc = XrdOssUring::Read(&aio, fd)) > 0) std::this_thread::yield();
+        if (rc < 0) { bad++; continue; }
+        aio.done.Wait();
+        if (aio.Result != blen || memcmp(buff.data(), data.data() + offs, blen))
+          bad++;
+      }
+      if (aio.nRead != nReqs) bad++;
+    });
+  }
+  for (auto &th : threads) th.join();
+  EXPECT_EQ(bad, 0);
+}
+
+// An I/O error is delivered through the completion, not by Read().
+TEST_F(XrdOssUringTest, CompletionError) {
+  char buff[512];
+  TestAio aio;
+  int wronly = open("/dev/null", O_WRONLY);
+  ASSERT_GE(wronly, 0);
+
+  aio.Set(buff, sizeof(buff), 0);
+  ASSERT_EQ(XrdOssUring::Read(&aio, wronly), 0);
+  aio.done.Wait();
+  EXPECT_EQ(aio.nRead, 1);
+  EXPECT_EQ(aio.Result, -EBADF);
+  close(wronly);
+}
+
+TEST_F(XrdOssUringTest, ReadV) {
+  std::string data = Pattern(16*1024, 5);
+  ASSERT_EQ(pwrite(fd, data.data(), data.size(), 0), (ssize_t)data.size());
+
+  char b0[100], b1[4096], b2[7];
+  XrdOucIOVec readV[3] = {{0, 100, 0, b0}, {8192, 4096, 0, b1},
+                          {16*1024 - 7, 7, 0, b2}};
+  ssize_t totBytes = 0;
+  ASSERT_TRUE(XrdOssUring::ReadV(fd, readV, 3, totBytes));
+  EXPECT_EQ(totBytes, 100 + 4096 + 7);
+  EXPECT_EQ(memcmp(b0, data.data(), 100), 0);
+  EXPECT_EQ(memcmp(b1, data.data() + 8192, 4096), 0);
+  EXPECT_EQ(memcmp(b2, data.data() + 16*1024 - 7, 7), 0);
+
+  // A segment past the end of the file is a short read
+  readV[2].offset = 16*1024 - 3;
+  ASSERT_TRUE(XrdOssUring::ReadV(fd, readV, 3, totBytes));
+  EXPECT_EQ(totBytes, -ESPIPE);
+}
+
+// When io_uring_enter() fails for good, the submitter gets the error and the
+// aio request is left for it to finish: no completion callback may run.
+TEST_F(XrdOssUringTest, SubmitFailure) {
+  int ringFD = RingFD();
+  ASSERT_GE(ringFD, 0);
+
+  // Make the ring's descriptor refer to something that is not a ring. The
+  // reaper keeps waiting on the ring itself.
+  int saved = dup(ringFD), devnull = open("/dev/null", O_RDWR);
+  ASSERT_GE(saved, 0);
+  ASSERT_GE(devnull, 0);
+  ASSERT_EQ(dup2(devnull, ringFD), ringFD);
+
+  char buff[512];
+  TestAio aio;
+  aio.Set(buff, sizeof(buff), 0);
+  int rc = XrdOssUring::Read(&aio, fd);
+
+  XrdOucIOVec readV[2] = {{0, 10, 0, buff}, {100, 10, 0, buff + 100}};
+  ssize_t totBytes = 0;
+  bool rvDone = XrdOssUring::ReadV(fd, readV, 2, totBytes);
+
+  ASSERT_EQ(dup2(saved, ringFD), ringFD);
+  close(saved);
+  close(devnull);
+
+  EXPECT_LT(rc, 0);
+  EXPECT_EQ(aio.done.CondWait(), 0);
+  EXPECT_EQ(aio.nRead, 0);
+  EXPECT_TRUE(rvDone);
+  EXPECT_LT(totBytes, 0);
+
+  // The ring is usable again
+  ASSERT_EQ(pwrite(fd, "x", 1, 0), 1);
+  aio.Set(buff, 1, 0);
+  ASSERT_EQ(XrdOssUring::Read(&aio, fd), 0);
+  aio.done.Wait();
+  EXPECT_EQ(aio.Result, 1);
+  EXPECT_EQ(aio.nRead, 1);
+}
@@ -0,0 +1,111 @@
+#undef NDEBUG
+
+#include "XrdOuc/XrdOucCRC.hh"
+#include "XrdOuc/XrdOucCRC32C.hh"
+#include "XrdOuc/XrdOucPgrwUtils.hh"
+
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+class XrdOucCRCTests : public ::testing::Test {
+protected:
+  void SetUp() override {
+    std::mt19937 gen(4321);
+    data.resize(70 * XrdSys::PageSize + 123);
+    for (auto &c : data) c = static_cast<char>(gen());
+  }
+
+  std::vector<uint32_t> perPage(const char *buf, size_t len) {
+    std::vector<uint32_t> cs;
+    for (size_t off = 0; off < len; off += XrdSys::PageSize)
+      cs.push_back(crc32c_sw(0, buf + off,
+                             std::min<size_t>(XrdSys::PageSize, len - off)));
+    return cs;
+  }
+
+  std::vector<char> data;
+};
+
+/*
+ * The multi-page kernels must produce the same value as the plain software
+ * calculation for every page, for any number of pages and a short last page.
+ */
+TEST_F(XrdOucCRCTests, PageChecksums) {
+  for (size_t pages : {0, 1, 2, 3, 4, 5, 7, 8, 12, 13, 64, 65, 70}) {
+    for (size_t tail : {0, 1, 100, 4095}) {
+      size_t len = pages * XrdSys::PageSize + tail;
+      std::vector<uint32_t> expect = perPage(data.data() + 1, len);
+      std::vector<uint32_t> csval(expect.size() + 1, 0xdeadbeef);
+      XrdOucCRC::Calc32C(data.data() + 1, len, csval.data());
+      ASSERT_EQ(csval.back(), 0xdeadbeef) << "overrun, len " << len;
+      csval.pop_back();
+      ASSERT_EQ(csval, expect) << "len " << len;
+    }
+  }
+}
+
+/*
+ * Pages other than the default page size go through the same kernels.
+ */
+TEST_F(XrdOucCRCTests, OtherPageSizes) {
+  for (size_t pgsz : {8, 64, 100, 512, 8192}) {
+    size_t len = data.size() - 7;
+    std::vector<uint32_t> csval((len + pgsz - 1) / pgsz);
+    crc32c_pages(data.data(), len, pgsz, csval.data());
+    for (size_t i = 0; i < csval.size(); i++) {
+      size_t n = std::min(pgsz, len - i * pgsz);
+      ASSERT_EQ(csval[i], crc32c_sw(0, data.data() + i * pgsz, n))
+          << "pgsz " << pgsz << " page " << i;
+    }
+  }
+}
+
+/*
+ * Verification must report the first bad page, even past the first batch.
+ */
+TEST_F(XrdOucCRCTests, VerifyPages) {
+  size_t len = 70 * XrdSys::PageSize + 123;
+  std::vector<uint32_t> csval = perPage(data.data(), len);
+  std::vector<uint32_t> valcs(csval.size());
+  std::vector<char> valok(csval.size());
+  uint32_t badcs = 0;
+
+  ASSERT_EQ(XrdOucCRC::Ver32C(data.data(), len, csval.data(), badcs), -1);
+  ASSERT_TRUE(XrdOucCRC::Ver32C(data.data(), len, csval.data(),
+                                valcs.data()));
+  ASSERT_EQ(valcs, csval);
+
+  for (int bad : {0, 5, 63, 64, 66, 70}) {
+    std::vector<uint32_t> cs = csval;
+    cs[bad] ^= 1;
+    ASSERT_EQ(XrdOucCRC::Ver32C(data.data(), len, cs.data(), badcs), bad);
+    ASSERT_EQ(badcs, csval[bad]);
+    ASSERT_FALSE(XrdOucCRC::Ver32C(data.data(), len, cs.data(),
+                                   reinterpret_cast<bool *>(valok.data())));
+    for (size_t i = 0; i < valok.size(); i++)
+      ASSERT_EQ(valok[i] != 0, (int)i != bad);
+  }
+}
+
+/*
+ * csCalc() handles a leading partial page before the aligned pages.
+ */
+TEST_F(XrdOucCRCTests, PgrwUnaligned) {
+  off_t offs = 1000;
+  size_t count = 10 * XrdSys::PageSize + 17;
+  std::vector<uint32_t> csvec;
+  XrdOucPgrwUtils::csCalc(data.data(), offs, count, csvec);
+
+  size_t first = XrdSys::PageSize - offs;
+  std::vector<uint32_t> expect = {crc32c_sw(0, data.data(), first)};
+  for (uint32_t cs : perPage(data.data() + first, count - first))
+    expect.push_back(cs);
+  ASSERT_EQ(csvec, expect);
+
+  off_t bado = -1;
+  int badc = 0;
+  XrdOucPgrwUtils::dataInfo dInfo(data.data(), csvec.data(), offs, count);
+  ASSERT_TRUE(XrdOucPgrwUtils::csVer(dInfo, bado, badc));
+}
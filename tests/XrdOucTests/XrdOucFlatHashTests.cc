@@ -0,0 +1,262 @@
+#undef NDEBUG
+
+#include "XrdOuc/XrdOucFlatHash.hh"
+#include "XrdOuc/XrdOucHash.hh"
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+struct Counted {
+  static int live;
+  int val;
+  Counted(int v) : val(v) { live++; }
+  ~Counted() { live--; }
+};
+int Counted::live = 0;
+
+// Paths of the shape seen by the authorization and namespace tables.
+std::vector<std::string> MakePaths(size_t n) {
+  std::mt19937 gen(1234);
+  std::vector<std::string> paths;
+  const char *vo[] = {"atlas", "cms", "lhcb", "alice", "dteam"};
+  for (size_t i = 0; i < n; i++) {
+    char buff[256];
+    snprintf(buff, sizeof(buff), "/store/%s/data%02u/run%06u/file_%u.root",
+             vo[gen() % 5], static_cast<unsigned>(gen() % 30),
+             static_cast<unsigned>(gen() % 1000000), static_cast<unsigned>(i));
+    paths.push_back(buff);
+  }
+  return paths;
+}
+
+int CountEm(const char *, Counted *, void *arg) {
+  (*static_cast<int *>(arg))++;
+  return 0;
+}
+
+int DropOdd(const char *, Counted *data, void *) {
+  return (data->val & 1) ? -1 : 0;
+}
+
+int FindVal(const char *, Counted *data, void *arg) {
+  return data->val == *static_cast<int *>(arg);
+}
+
+} // namespace
+
+/*
+ * Short (inlined) and long (allocated) keys must both be found, replaced and
+ * deleted, and the table must release the data it owns.
+ */
+TEST(XrdOucFlatHash, AddFindDel) {
+  {
+    XrdOucFlatHash<Counted> table;
+    std::string longkey(100, 'x');
+
+    EXPECT_EQ(table.Add("short", new Counted(1)), nullptr);
+    EXPECT_EQ(table.Add(longkey.c_str(), new Counted(2)), nullptr);
+    EXPECT_EQ(table.Num(), 2);
+    ASSERT_NE(table.Find("short"), nullptr);
+    EXPECT_EQ(table.Find("short")->val, 1);
+    EXPECT_EQ(table.Find(longkey.c_str())->val, 2);
+    EXPECT_EQ(table.Find("shorter"), nullptr);
+
+    // Adding an existing key returns the old entry and keeps it.
+    Counted *dup = new Counted(3);
+    EXPECT_EQ(table.Add("short", dup)->val, 1);
+    delete dup;
+
+    // Replacing it releases the old data.
+    EXPECT_EQ(table.Rep("short", new Counted(4)), nullptr);
+    EXPECT_EQ(table.Find("short")->val, 4);
+    EXPECT_EQ(Counted::live, 2);
+
+    EXPECT_EQ(table.Del("short"), 0);
+    EXPECT_EQ(table.Del("short"), -ENOENT);
+    EXPECT_EQ(table.Find("short"), nullptr);
+    EXPECT_EQ(table.Num(), 1);
+    EXPECT_EQ(Counted::live, 1);
+  }
+  EXPECT_EQ(Counted::live, 0);
+}
+
+/*
+ * The options behave as they do for XrdOucHash.
+ */
+TEST(XrdOucFlatHash, Options) {
+  XrdOucFlatHash<char> names;
+  char *np;
+
+  names.Add("group", 0, 0, Hash_data_is_key);
+  ASSERT_NE(np = names.Find("group"), nullptr);
+  EXPECT_STREQ(np, "group");
+
+  XrdOucFlatHash<Counted> table;
+  Counted kept(7);
+  table.Add("kept", &kept, 0, Hash_keepdata);
+  EXPECT_EQ(table.Del("kept"), 0);
+  EXPECT_EQ(kept.val, 7);
+
+  // Hash_count needs as many deletes as adds.
+  table.Add("counted", new Counted(1), 0, Hash_count);
+  Counted *dup = new Counted(2);
+  table.Add("counted", dup, 0, Hash_count);
+  delete dup;
+  EXPECT_EQ(table.Del("counted"), 0);
+  EXPECT_NE(table.Find("counted"), nullptr);
+  EXPECT_EQ(table.Del("counted"), 0);
+  EXPECT_EQ(table.Find("counted"), nullptr);
+
+  // An entry whose lifetime has passed is not found and may be replaced.
+  time_t ktime = 1;
+  table.Add("expired", new Counted(1), -10);
+  EXPECT_EQ(table.Find("expired", &ktime), nullptr);
+  EXPECT_EQ(ktime, 0);
+  table.Add("expired", new Counted(1), -10);
+  EXPECT_EQ(table.Add("expired", new Counted(2), 60), nullptr);
+  EXPECT_EQ(table.Find("expired", &ktime)->val, 2);
+  EXPECT_GT(ktime, time(0));
+  table.Purge();
+  EXPECT_EQ(table.Num(), 0);
+  EXPECT_EQ(Counted::live, 1);
+}
+
+/*
+ * Apply() visits every entry, deletes on a negative return and stops on a
+ * positive one.
+ */
+TEST(XrdOucFlatHash, Apply) {
+  XrdOucFlatHash<Counted> table(4);
+  std::vector<std::string> paths = MakePaths(500);
+
+  for (size_t i = 0; i < paths.size(); i++)
+    table.Add(paths[i].c_str(), new Counted(static_cast<int>(i)));
+
+  int count = 0;
+  EXPECT_EQ(table.Apply(CountEm, &count), nullptr);
+  EXPECT_EQ(count, 500);
+
+  table.Apply(DropOdd, 0);
+  EXPECT_EQ(table.Num(), 250);
+  EXPECT_EQ(Counted::live, 250);
+  EXPECT_EQ(table.Find(paths[3].c_str()), nullptr);
+  EXPECT_EQ(table.Find(paths[4].c_str())->val, 4);
+
+  int want = 42;
+  ASSERT_NE(table.Apply(FindVal, &want), nullptr);
+  EXPECT_EQ(table.Apply(FindVal, &want)->val, 42);
+  table.Purge();
+  EXPECT_EQ(Counted::live, 0);
+}
+
+/*
+ * Random adds and deletes checked against std::map. This exercises growth,
+ * tombstones and the rebuild that reclaims them.
+ */
+TEST(XrdOucFlatHash, MatchesReference) {
+  XrdOucFlatHash<Counted> table(1);
+  std::map<std::string, int> ref;
+  std::vector<std::string> paths = MakePaths(3000);
+  std::mt19937 gen(99);
+
+  for (int i = 0; i < 50000; i++) {
+    const std::string &key = paths[gen() % paths.size()];
+    if (gen() % 3) {
+      bool had = ref.count(key);
+      Counted *data = new Counted(i);
+      Counted *old = table.Add(key.c_str(), data);
+      ASSERT_EQ(old != nullptr, had) << key;
+      if (old) delete data;
+        else ref[key] = i;
+    } else {
+      ASSERT_EQ(table.Del(key.c_str()), ref.erase(key) ? 0 : -ENOENT) << key;
+    }
+    ASSERT_EQ(table.Num(), static_cast<int>(ref.size()));
+  }
+
+  for (const std::string &key : paths) {
+    Counted *data = table.Find(key.c_str(), table.HashKey(key.c_str()));
+    auto it = ref.find(key);
+    if (it == ref.end()) EXPECT_EQ(data, nullptr) << key;
+      else {ASSERT_NE(data, nullptr) << key; EXPECT_EQ(data->val, it->second);}
+  }
+  table.Purge();
+  EXPECT_EQ(Counted::live, 0);
+}
+
+/*
+ * The read-mostly variant allows concurrent lookups while a writer changes
+ * unrelated entries.
+ */
+TEST(XrdOucFlatHash, ReadMostly) {
+  XrdOucFlatHashRM<Counted> table;
+  std::vector<std::string> paths = MakePaths(1000);
+
+  for (size_t i = 0; i < 500; i++)
+    table.Add(paths[i].c_str(), new Counted(static_cast<int>(i)));
+
+  std::vector<std::thread> readers;
+  std::vector<int> misses(4, 0);
+  for (int t = 0; t < 4; t++)
+    readers.emplace_back([&, t]() {
+      for (int n = 0; n < 20; n++)
+        for (size_t i = 0; i < 500; i++) {
+          Counted *data = table.Find(paths[i].c_str());
+          if (!data || data->val != static_cast<int>(i)) misses[t]++;
+        }
+    });
+
+  for (size_t i = 500; i < paths.size(); i++)
+    table.Add(paths[i].c_str(), new Counted(static_cast<int>(i)));
+  for (size_t i = 500; i < paths.size(); i += 2)
+    table.Del(paths[i].c_str());
+
+  for (std::thread &t : readers) t.join();
+  for (int t = 0; t < 4; t++) EXPECT_EQ(misses[t], 0);
+  EXPECT_EQ(table.Num(), 750);
+  table.Purge();
+  EXPECT_EQ(Counted::live, 0);
+}
+
+/*
+ * Lookup throughput of both tables for realistic path keys, half of the
+ * lookups missing. Run with --gtest_also_run_disabled_tests.
+ */
+TEST(XrdOucFlatHash, DISABLED_Throughput) {
+  const size_t sizes[] = {64, 1024, 16384, 262144};
+  const size_t lookups = 20000000;
+
+  printf("%-8s %10s %12s %12s\n", "table", "entries", "Mlookup/s", "hits");
+
+  for (size_t n : sizes) {
+    std::vector<std::string> paths = MakePaths(2 * n);
+    XrdOucHash<char> oucHash;
+    XrdOucFlatHash<char> flatHash;
+    for (size_t i = 0; i < n; i++) {
+      oucHash.Add(paths[i].c_str(), 0, 0, Hash_data_is_key);
+      flatHash.Add(paths[i].c_str(), 0, 0, Hash_data_is_key);
+    }
+
+    for (int which = 0; which < 2; which++) {
+      size_t hits = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < lookups; i++) {
+        const char *key = paths[(i * 7919) % paths.size()].c_str();
+        if (which ? flatHash.Find(key) != 0 : oucHash.Find(key) != 0) hits++;
+      }
+      std::chrono::duration<double> secs =
+          std::chrono::steady_clock::now() - start;
+      printf("%-8s %10zu %12.2f %12zu\n", which ? "flat" : "ouc", n,
+             lookups / secs.count() / 1e6, hits);
+    }
+  }
+}
@@ -0,0 +1,256 @@
+#include "XrdPfc/XrdPfcPrefetch.hh"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace XrdPfc;
+
+namespace
+{
+const int       n_blocks   = 1000;
+const long long ival_us    = 1000;   // client reads one block per ms
+const long long latency_us = 5000;   // remote block read takes 5 ms
+const int       max_flight = 10;
+
+struct SimResult
+{
+   int hits = 0, misses = 0, issued = 0, wasted = 0;
+   PrefetchEngine::Pattern_e pattern = PrefetchEngine::kNone;
+
+   double HitFrac()   const { return double(hits) / (hits + misses); }
+   double WasteFrac() const { return issued ? double(wasted) / issued : 0; }
+};
+
+// Replay a trace of block reads. Before every read the engine may issue
+// blocks; a read is a hit if the block was prefetched earlier.
+SimResult simulate(const char *engine, const std::vector<int> &trace)
+{
+   std::unique_ptr<PrefetchEngine> pe(PrefetchEngine::Create(engine, 0, n_blocks));
+   std::vector<char> present(n_blocks, 0), prefetched(n_blocks, 0), used(n_blocks, 0);
+   SimResult r;
+
+   long long t = PrefetchEngine::NowUs();
+   for (int blk : trace)
+   {
+      std::vector<int> blks;
+      pe->Predict(max_flight, latency_us, blks, [&](int b) { return ! present[b]; });
+      for (int b : blks)
+      {
+         EXPECT_FALSE(present[b]);
+         present[b] = prefetched[b] = 1;
+         ++r.issued;
+      }
+      PrefetchEngine::Pattern_e p = pe->GetPattern();
+      if (p != PrefetchEngine::kNone)
+         r.pattern = p;
+
+      // Like File, hits are only queued and misses are recorded right away.
+      bool hit = present[blk];
+      if (prefetched[blk]) { ++r.hits; used[blk] = 1; }
+      else if ( ! present[blk]) ++r.misses;
+      present[blk] = 1;
+
+      if (hit) pe->QueueAccess(blk, blk, t);
+      else     pe->RecordAccess(blk, blk, t);
+      t += ival_us;
+   }
+   for (int b = 0; b < n_blocks; ++b)
+      if (prefetched[b] && ! used[b]) ++r.wasted;
+   return r;
+}
+
+std::vector<int> trace_stride(int start, int stride, int n)
+{
+   std::vector<int> v;
+   for (int i = 0; i < n; ++i) v.push_back(start + i * stride);
+   return v;
+}
+
+std::vector<int> trace_streams(int n_streams, int n_per_stream)
+{
+   // Baskets of several branches read in turn, each branch moving forward.
+   std::vector<int> v;
+   for (int i = 0; i < n_per_stream; ++i)
+      for (int s = 0; s < n_streams; ++s)
+         v.push_back(s * (n_blocks / n_streams) + i);
+   return v;
+}
+
+void report(const char *name, const SimResult &lin, const SimResult &ada)
+{
+   printf("%-10s linear hit %.2f waste %.2f | adaptive hit %.2f waste %.2f pattern %s\n", name,
+          lin.HitFrac(), lin.WasteFrac(), ada.HitFrac(), ada.WasteFrac(),
+          PrefetchEngine::PatternName(ada.pattern));
+}
+}
+
+TEST(PfcPrefetch, Names)
+{
+   EXPECT_TRUE(PrefetchEngine::IsKnown("linear"));
+   EXPECT_TRUE(PrefetchEngine::IsKnown("adaptive"));
+   EXPECT_FALSE(PrefetchEngine::IsKnown("random"));
+   std::unique_ptr<PrefetchEngine> pe(PrefetchEngine::Create("adaptive", 0, 10));
+   EXPECT_STREQ(pe->Name(), "adaptive");
+   EXPECT_TRUE(pe->IsPredictive());
+}
+
+// The linear engine hands out the lowest missing block.
+TEST(PfcPrefetch, Linear)
+{
+   std::unique_ptr<PrefetchEngine> pe(PrefetchEngine::Create("linear", 100, 10));
+   std::vector<int> blks;
+   pe->Predict(5, 0, blks, [](int b) { return b >= 103; });
+   ASSERT_EQ(blks, std::vector<int>({103}));
+   blks.clear();
+   pe->Predict(5, 0, blks, [](int) { return false; });
+   EXPECT_TRUE(blks.empty());
+}
+
+// Nothing is predicted before a stream is confirmed, nor past the file end.
+TEST(PfcPrefetch, AdaptiveBounds)
+{
+   std::unique_ptr<PrefetchEngine> pe(PrefetchEngine::Create("adaptive", 0, 10));
+   auto all = [](int) { return true; };
+   long long t = PrefetchEngine::NowUs();
+   std::vector<int> blks;
+
+   pe->RecordAccess(5, 5, t);
+   pe->RecordAccess(6, 6, t + 10);
+   pe->Predict(10, 0, blks, all);
+   EXPECT_TRUE(blks.empty());
+
+   EXPECT_TRUE(pe->RecordAccess(7, 7, t + 20));
+   pe->Predict(10, 1000, blks, all);
+   ASSERT_FALSE(blks.empty());
+   EXPECT_EQ(blks.front(), 8);
+   for (int b : blks)
+      EXPECT_LT(b, 10);
+}
+
+// Queued accesses are taken into account by the next Predict().
+TEST(PfcPrefetch, QueuedAccesses)
+{
+   std::unique_ptr<PrefetchEngine> pe(PrefetchEngine::Create("adaptive", 0, 100));
+   auto all = [](int) { return true; };
+   long long t = PrefetchEngine::NowUs();
+   std::vector<int> blks;
+
+   for (int b = 10; b < 13; ++b)
+      pe->QueueAccess(b, b, t + b);
+   pe->Predict(2, 0, blks, all);
+   EXPECT_EQ(blks, std::vector<int>({13, 14}));
+   EXPECT_EQ(pe->GetPattern(), PrefetchEngine::kSequential);
+}
+
+// A queued access asks for a resume only once it uses up half of what was
+// predicted for its stream, or when enough accesses have piled up.
+TEST(PfcPrefetch, QueuedResume)
+{
+   std::unique_ptr<PrefetchEngine> pe(PrefetchEngine::Create("adaptive", 0, 1000));
+   auto all = [](int) { return true; };
+   long long t = PrefetchEngine::NowUs();
+   std::vector<int> blks;
+
+   pe->RecordAccess(100, 100, t);
+   pe->RecordAccess(101, 101, t + 1);
+   pe->RecordAccess(102, 102, t + 2);
+   pe->Predict(4, 0, blks, all);       // default depth of two steps
+   ASSERT_EQ(blks, std::vector<int>({103, 104}));
+
+   EXPECT_FALSE(pe->QueueAccess(500, 500, t + 3));   // unrelated
+   EXPECT_TRUE (pe->QueueAccess(103, 103, t + 4));   // one of two steps left
+
+   // Random accesses alone eventually ask for the queue to be drained.
+   int resumes = 0;
+   for (int i = 0; i < PrefetchAdaptive::s_ring_size; ++i)
+      if (pe->QueueAccess(600 + 3 * i, 600 + 3 * i, t + 5 + i)) ++resumes;
+   EXPECT_GE(resumes, 1);
+   EXPECT_LE(resumes, 8);
+}
+
+// Readers queue accesses while another thread predicts.
+TEST(PfcPrefetch, QueuedConcurrent)
+{
+   std::unique_ptr<PrefetchEngine> pe(PrefetchEngine::Create("adaptive", 0, 100000));
+   long long t = PrefetchEngine::NowUs();
+   std::vector<std::thread> readers;
+
+   for (int r = 0; r < 4; ++r)
+      readers.emplace_back([&, r]() {
+         for (int i = 0; i < 5000; ++i)
+            pe->QueueAccess(r * 20000 + i, r * 20000 + i, t + i);
+      });
+   std::vector<int> blks;
+   for (int i = 0; i < 2000; ++i)
+   {
+      blks.clear();
+      pe->Predict(8, 0, blks, [](int) { return true; });
+      for (int b : blks)
+      {
+         ASSERT_GE(b, 0);
+         ASSERT_LT(b, 100000);
+      }
+   }
+   for (auto &th : readers) th.join();
+}
+
+TEST(PfcPrefetch, Sequential)
+{
+   SimResult lin = simulate("linear",   trace_stride(0, 1, n_blocks));
+   SimResult ada = simulate("adaptive", trace_stride(0, 1, n_blocks));
+   report("sequential", lin, ada);
+   EXPECT_EQ(ada.pattern, PrefetchEngine::kSequential);
+   EXPECT_GT(ada.HitFrac(), 0.95);
+   EXPECT_LT(ada.WasteFrac(), 0.02);
+}
+
+TEST(PfcPrefetch, Reverse)
+{
+   SimResult lin = simulate("linear",   trace_stride(n_blocks - 1, -1, n_blocks));
+   SimResult ada = simulate("adaptive", trace_stride(n_blocks - 1, -1, n_blocks));
+   report("reverse", lin, ada);
+   EXPECT_EQ(ada.pattern, PrefetchEngine::kReverse);
+   EXPECT_GT(ada.HitFrac(), 0.95);
+   EXPECT_GT(ada.HitFrac(), lin.HitFrac());
+   EXPECT_LT(ada.WasteFrac(), 0.02);
+}
+
+TEST(PfcPrefetch, Stride)
+{
+   SimResult lin = simulate("linear",   trace_stride(3, 4, n_blocks / 4));
+   SimResult ada = simulate("adaptive", trace_stride(3, 4, n_blocks / 4));
+   report("stride", lin, ada);
+   EXPECT_EQ(ada.pattern, PrefetchEngine::kStride);
+   EXPECT_GT(ada.HitFrac(), 0.95);
+   EXPECT_GT(ada.HitFrac(), lin.HitFrac());
+   EXPECT_LT(ada.WasteFrac(), lin.WasteFrac());
+}
+
+TEST(PfcPrefetch, Sparse)
+{
+   SimResult lin = simulate("linear",   trace_streams(4, 200));
+   SimResult ada = simulate("adaptive", trace_streams(4, 200));
+   report("sparse", lin, ada);
+   EXPECT_EQ(ada.pattern, PrefetchEngine::kSparse);
+   EXPECT_GT(ada.HitFrac(), 0.9);
+   EXPECT_GT(ada.HitFrac(), lin.HitFrac());
+   EXPECT_LT(ada.WasteFrac(), lin.WasteFrac());
+}
+
+// Random reads have no pattern; the adaptive engine should mostly stay quiet.
+TEST(PfcPrefetch, Random)
+{
+   std::mt19937 gen(7);
+   std::vector<int> trace;
+   for (int i = 0; i < 500; ++i) trace.push_back(gen() % n_blocks);
+
+   SimResult lin = simulate("linear",   trace);
+   SimResult ada = simulate("adaptive", trace);
+   report("random", lin, ada);
+   EXPECT_LT(ada.issued, lin.issued / 4);
+}
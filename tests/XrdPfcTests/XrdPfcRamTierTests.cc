@@ -0,0 +1,320 @@
+#include "XrdPfc/XrdPfcRamTier.hh"
+#include "XrdPfc/XrdPfcSlabAllocator.hh"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace XrdPfc;
+
+namespace
+{
+   const int s_bsize = 64 * 1024;
+
+   void FillBlock(std::vector<char> &b, long long fid, int blk)
+   {
+      for (size_t i = 0; i < b.size(); ++i)
+         b[i] = (char) (fid * 31 + blk * 7 + i);
+   }
+
+   // Reads block blk of file fid through the tier, inserting it on a miss
+   // the way File::ReadThroughRamTier() does. Contents are not checked.
+   bool ReadOrLoad(RamTier &rt, long long fid, int blk, std::vector<char> &buf)
+   {
+      char dst[128];
+      if (rt.Read(fid, blk, 0, sizeof(dst), dst))
+         return true;
+      if (rt.WantAdmit(fid, blk, s_bsize))
+         rt.Insert(fid, blk, buf.data(), s_bsize);
+      return false;
+   }
+}
+
+// A resident block returns the requested range; ranges beyond the stored
+// length and other files' blocks miss.
+TEST(PfcRamTier, ReadHitMiss)
+{
+   SlabAllocator alloc(SlabAllocator::Config{});
+   RamTier::Config cfg;
+   cfg.m_max_bytes = 1024 * 1024;
+   RamTier rt(cfg, &alloc);
+
+   long long fid = RamTier::NewFileId();
+   ASSERT_NE(fid, RamTier::NewFileId());
+
+   std::vector<char> blk(s_bsize);
+   FillBlock(blk, fid, 3);
+
+   char dst[4096];
+   EXPECT_FALSE(rt.Read(fid, 3, 0, sizeof(dst), dst));
+   ASSERT_TRUE(rt.WantAdmit(fid, 3, 1000));
+   ASSERT_TRUE(rt.Insert(fid, 3, blk.data(), 1000));
+   EXPECT_FALSE(rt.Insert(fid, 3, blk.data(), 1000));
+   EXPECT_FALSE(rt.WantAdmit(fid, 3, 1000));
+
+   ASSERT_TRUE(rt.Read(fid, 3, 100, 500, dst));
+   EXPECT_EQ(memcmp(dst, blk.data() + 100, 500), 0);
+   EXPECT_FALSE(rt.Read(fid, 3, 900, 200, dst));
+   EXPECT_FALSE(rt.Read(fid + 1, 3, 0, 100, dst));
+   EXPECT_FALSE(rt.Read(fid, 4, 0, 100, dst));
+
+   RamTier::Usage u;
+   rt.GetUsage(u);
+   EXPECT_EQ(u.m_n_blocks, 1);
+   EXPECT_EQ(u.m_bytes, 1000);
+   EXPECT_EQ(u.m_hits, 1);
+   EXPECT_EQ(u.m_misses, 4);
+   EXPECT_EQ(u.m_bytes_hit, 500);
+   EXPECT_DOUBLE_EQ(u.HitRatio(), 0.2);
+}
+
+// Without frequency admission the tier behaves as an LRU bounded by the
+// memory limit.
+TEST(PfcRamTier, LruWithinLimit)
+{
+   SlabAllocator alloc(SlabAllocator::Config{});
+   RamTier::Config cfg;
+   cfg.m_max_bytes = 16 * s_bsize;
+   cfg.m_tinylfu   = false;
+   RamTier rt(cfg, &alloc);
+
+   long long fid = RamTier::NewFileId();
+   std::vector<char> blk(s_bsize);
+   for (int i = 0; i < 32; ++i)
+   {
+      FillBlock(blk, fid, i);
+      ASSERT_TRUE(rt.Insert(fid, i, blk.data(), s_bsize));
+   }
+
+   RamTier::Usage u;
+   rt.GetUsage(u);
+   EXPECT_EQ(u.m_bytes, cfg.m_max_bytes);
+   EXPECT_EQ(u.m_n_blocks, 16);
+   EXPECT_EQ(u.m_evicted, 16);
+
+   char dst[64];
+   EXPECT_FALSE(rt.Read(fid, 0, 0, sizeof(dst), dst));
+   EXPECT_FALSE(rt.Read(fid, 15, 0, sizeof(dst), dst));
+   ASSERT_TRUE(rt.Read(fid, 16, 0, sizeof(dst), dst));
+   FillBlock(blk, fid, 16);
+   EXPECT_EQ(memcmp(dst, blk.data(), sizeof(dst)), 0);
+
+   // Blocks larger than the tier are never taken.
+   std::vector<char> big(cfg.m_max_bytes + 1);
+   EXPECT_FALSE(rt.WantAdmit(fid, 100, (int) big.size()));
+   EXPECT_FALSE(rt.Insert(fid, 100, big.data(), (int) big.size()));
+}
+
+// A one-pass scan must not push out a working set that is read repeatedly,
+// while plain LRU loses it.
+TEST(PfcRamTier, TinyLfuResistsScan)
+{
+   SlabAllocator alloc(SlabAllocator::Config{});
+   std::vector<char> buf(s_bsize);
+
+   for (int tinylfu = 0; tinylfu < 2; ++tinylfu)
+   {
+      RamTier::Config cfg;
+      cfg.m_max_bytes = 16 * s_bsize;
+      cfg.m_tinylfu   = tinylfu;
+      RamTier rt(cfg, &alloc);
+
+      long long hot  = RamTier::NewFileId();
+      long long scan = RamTier::NewFileId();
+
+      for (int pass = 0; pass < 8; ++pass)
+         for (int i = 0; i < 12; ++i)
+            ReadOrLoad(rt, hot, i, buf);
+
+      for (int i = 0; i < 1000; ++i)
+         ReadOrLoad(rt, scan, i, buf);
+
+      int hot_hits = 0;
+      for (int i = 0; i < 12; ++i)
+         hot_hits += ReadOrLoad(rt, hot, i, buf);
+
+      if (tinylfu)
+      {
+         EXPECT_EQ(hot_hits, 12);
+         RamTier::Usage u;
+         rt.GetUsage(u);
+         EXPECT_GT(u.m_rejected, 900);
+      }
+      else
+      {
+         EXPECT_EQ(hot_hits, 0);
+      }
+   }
+}
+
+// Dropping a file releases its blocks and leaves other files alone.
+TEST(PfcRamTier, Drop)
+{
+   SlabAllocator alloc(SlabAllocator::Config{});
+   RamTier::Config cfg;
+   cfg.m_max_bytes = 1024ll * 1024 * 1024;
+   RamTier rt(cfg, &alloc);
+
+   long long a = RamTier::NewFileId();
+   long long b = RamTier::NewFileId();
+   std::vector<char> blk(s_bsize);
+   for (int i = 0; i < 64; ++i)
+   {
+      ASSERT_TRUE(rt.Insert(a, i, blk.data(), s_bsize));
+      ASSERT_TRUE(rt.Insert(b, i, blk.data(), s_bsize));
+   }
+
+   rt.Drop(a);
+
+   RamTier::Usage u;
+   rt.GetUsage(u);
+   EXPECT_EQ(u.m_n_blocks, 64);
+   EXPECT_EQ(u.m_bytes, 64ll * s_bsize);
+
+   SlabAllocator::Usage au;
+   alloc.GetUsage(au);
+   EXPECT_EQ(au.m_requested, 64ll * s_bsize);
+
+   char dst[64];
+   for (int i = 0; i < 64; ++i)
+   {
+      ASSERT_FALSE(rt.Read(a, i, 0, sizeof(dst), dst));
+      ASSERT_TRUE (rt.Read(b, i, 0, sizeof(dst), dst));
+   }
+}
+
+// Evictions keep the per-file index consistent, so dropping every file
+// afterwards releases all remaining blocks.
+TEST(PfcRamTier, DropAfterEviction)
+{
+   SlabAllocator alloc(SlabAllocator::Config{});
+   RamTier::Config cfg;
+   cfg.m_max_bytes = 32ll * s_bsize;
+   cfg.m_tinylfu   = false;
+   RamTier rt(cfg, &alloc);
+
+   long long fids[3] = { RamTier::NewFileId(), RamTier::NewFileId(), RamTier::NewFileId() };
+   std::vector<char> blk(s_bsize);
+   for (int i = 0; i < 100; ++i)
+      for (long long f : fids)
+         ASSERT_TRUE(rt.Insert(f, i, blk.data(), s_bsize));
+
+   RamTier::Usage u;
+   rt.GetUsage(u);
+   EXPECT_EQ(u.m_n_blocks, 32);
+   EXPECT_GT(u.m_evicted, 0);
+
+   rt.Drop(fids[1]);
+   rt.GetUsage(u);
+   EXPECT_LT(u.m_n_blocks, 32);
+   char dst[64];
+   for (int i = 0; i < 100; ++i)
+      EXPECT_FALSE(rt.Read(fids[1], i, 0, sizeof(dst), dst));
+
+   rt.Drop(fids[0]);
+   rt.Drop(fids[2]);
+   rt.GetUsage(u);
+   EXPECT_EQ(u.m_n_blocks, 0);
+   EXPECT_EQ(u.m_bytes, 0);
+
+   SlabAllocator::Usage au;
+   alloc.GetUsage(au);
+   EXPECT_EQ(au.m_requested, 0);
+}
+
+// A File caching a file block starting at a non-zero offset: blocks written
+// from the remote, keyed the way File::WriteBlockToDisk() does, are found by
+// the absolute index File::ReadThroughRamTier() looks up, and the length of
+// the last block stops at the end of the file block.
+TEST(PfcRamTier, FileBlockOffset)
+{
+   SlabAllocator alloc(SlabAllocator::Config{});
+   RamTier::Config cfg;
+   cfg.m_max_bytes = 32ll * s_bsize;
+   cfg.m_tinylfu   = false;
+   RamTier rt(cfg, &alloc);
+
+   const long long m_offset    = 5ll * s_bsize;
+   const long long m_file_size = 2ll * s_bsize + 1000;
+   const long long fid         = RamTier::NewFileId();
+
+   EXPECT_EQ(RamTier::BlockLen(5, s_bsize, m_offset, m_file_size), s_bsize);
+   EXPECT_EQ(RamTier::BlockLen(6, s_bsize, m_offset, m_file_size), s_bsize);
+   EXPECT_EQ(RamTier::BlockLen(7, s_bsize, m_offset, m_file_size), 1000);
+   EXPECT_EQ(RamTier::BlockLen(2, s_bsize, 0, m_file_size), 1000);
+
+   std::vector<std::vector<char>> blks;
+   for (long long b_off = m_offset; b_off < m_offset + m_file_size; b_off += s_bsize)
+   {
+      const int idx = RamTier::BlockIdx(b_off, s_bsize);
+      const int len = RamTier::BlockLen(idx, s_bsize, m_offset, m_file_size);
+      blks.emplace_back(len);
+      FillBlock(blks.back(), fid, idx);
+      ASSERT_TRUE(rt.Insert(fid, idx, blks.back().data(), len));
+   }
+   ASSERT_EQ(blks.size(), 3u);
+
+   // A read crossing from the second into the third block.
+   const long long iov_off  = m_offset + 2ll * s_bsize - 100;
+   const int       iov_size = 600;
+   std::vector<char> dst(iov_size);
+   for (int idx = iov_off / s_bsize; idx <= (iov_off + iov_size - 1) / s_bsize; ++idx)
+   {
+      const long long blk_start = idx * (long long) s_bsize;
+      const long long beg = std::max(iov_off, blk_start);
+      const long long end = std::min(iov_off + iov_size, blk_start + s_bsize);
+      ASSERT_TRUE(rt.Read(fid, idx, beg - blk_start, end - beg, dst.data() + (beg - iov_off)))
+         << "block " << idx;
+   }
+   EXPECT_EQ(memcmp(dst.data(), blks[1].data() + s_bsize - 100, 100), 0);
+   EXPECT_EQ(memcmp(dst.data() + 100, blks[2].data(), 500), 0);
+
+   // Nothing is stored under the indices relative to the file block.
+   char buf[64];
+   for (int idx = 0; idx < 3; ++idx)
+      EXPECT_FALSE(rt.Read(fid, idx, 0, sizeof(buf), buf));
+}
+
+// Hit rate and lookup throughput for a Zipf-like access pattern over a data
+// set four times the size of the tier. Run with --gtest_also_run_disabled_tests.
+TEST(PfcRamTier, DISABLED_Throughput)
+{
+   SlabAllocator alloc(SlabAllocator::Config{});
+   std::vector<char> buf(s_bsize);
+   const int n_blocks = 4096;
+   const int n_reads  = 2000000;
+
+   std::mt19937 gen(7);
+   std::vector<int> seq(n_reads);
+   {
+      std::vector<double> w(n_blocks);
+      for (int i = 0; i < n_blocks; ++i) w[i] = 1.0 / (i + 1);
+      std::discrete_distribution<int> zipf(w.begin(), w.end());
+      for (int &s : seq) s = zipf(gen);
+   }
+
+   printf("%-8s %12s %10s\n", "admit", "Mreads/s", "hit-ratio");
+
+   for (int tinylfu = 0; tinylfu < 2; ++tinylfu)
+   {
+      RamTier::Config cfg;
+      cfg.m_max_bytes = (long long) n_blocks / 4 * s_bsize;
+      cfg.m_tinylfu   = tinylfu;
+      RamTier rt(cfg, &alloc);
+      long long fid = RamTier::NewFileId();
+
+      auto start = std::chrono::steady_clock::now();
+      for (int s : seq)
+         ReadOrLoad(rt, fid, s, buf);
+      std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+
+      RamTier::Usage u;
+      rt.GetUsage(u);
+      printf("%-8s %12.2f %10.4f\n", tinylfu ? "tinylfu" : "all",
+             n_reads / secs.count() / 1e6, u.HitRatio());
+   }
+}
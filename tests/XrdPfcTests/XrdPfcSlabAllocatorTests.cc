@@ -0,0 +1,188 @@
+#include "XrdPfc/XrdPfcSlabAllocator.hh"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace XrdPfc;
+
+// Every size maps to the smallest class that holds it and classes grow
+// monotonically up to the largest block size.
+TEST(PfcSlabAllocator, SizeClasses)
+{
+   long long prev = 0;
+   for (int c = 0; c < SlabAllocator::NumClasses(); ++c)
+   {
+      long long cs = SlabAllocator::ClassSize(c);
+      ASSERT_GT(cs, prev);
+      ASSERT_EQ(cs % 4096, 0);
+      ASSERT_EQ(SlabAllocator::SizeClass(cs), c);
+      ASSERT_EQ(SlabAllocator::SizeClass(prev + 1), c);
+      prev = cs;
+   }
+   EXPECT_EQ(prev, SlabAllocator::s_max_class_size);
+   EXPECT_EQ(SlabAllocator::SizeClass(SlabAllocator::s_max_class_size + 1), -1);
+   EXPECT_EQ(SlabAllocator::SizeClass(0), -1);
+
+   // Rounding above 64k wastes at most a quarter of the requested size.
+   for (long long sz = 65537; sz < 64ll * 1024 * 1024; sz = sz * 5 / 4 + 4095)
+      ASSERT_LE(SlabAllocator::ClassSize(SlabAllocator::SizeClass(sz)), sz + sz / 4);
+}
+
+// Live blocks must not overlap, must be page aligned and keep their data.
+TEST(PfcSlabAllocator, MixedSizes)
+{
+   SlabAllocator::Config cfg;
+   cfg.m_keep_bytes = 8 * 1024 * 1024;
+   SlabAllocator alloc(cfg);
+
+   std::mt19937 gen(42);
+   const long long sizes[] = { 4096, 12288, 65536, 100000, 128 * 1024, 1024 * 1024, 3 * 1024 * 1024 };
+
+   struct Blk { char *buf; long long size; unsigned char tag; };
+   std::vector<Blk> live;
+
+   for (int i = 0; i < 2000; ++i)
+   {
+      if (live.empty() || gen() % 3)
+      {
+         long long sz = sizes[gen() % (sizeof(sizes) / sizeof(sizes[0]))];
+         char *b = alloc.Allocate(sz);
+         ASSERT_NE(b, nullptr);
+         ASSERT_EQ((uintptr_t) b % 4096, 0u);
+         unsigned char tag = gen();
+         memset(b, tag, sz);
+         live.push_back({b, sz, tag});
+      }
+      else
+      {
+         size_t k = gen() % live.size();
+         Blk blk = live[k];
+         for (long long j = 0; j < blk.size; j += 511)
+            ASSERT_EQ((unsigned char) blk.buf[j], blk.tag);
+         alloc.Release(blk.buf, blk.size);
+         live[k] = live.back();
+         live.pop_back();
+      }
+   }
+
+   std::sort(live.begin(), live.end(), [](const Blk &a, const Blk &b) { return a.buf < b.buf; });
+   for (size_t k = 1; k < live.size(); ++k)
+      ASSERT_LE(live[k - 1].buf + live[k - 1].size, live[k].buf);
+
+   SlabAllocator::Usage u;
+   alloc.GetUsage(u);
+   long long req = 0;
+   for (auto &blk : live) req += blk.size;
+   EXPECT_EQ(u.m_requested, req);
+   EXPECT_GE(u.m_in_use, u.m_requested);
+   EXPECT_GE(u.m_mapped, u.m_in_use);
+   EXPECT_GE(u.m_mapped_hwm, u.m_mapped);
+
+   for (auto &blk : live) alloc.Release(blk.buf, blk.size);
+
+   alloc.GetUsage(u);
+   EXPECT_EQ(u.m_requested, 0);
+   EXPECT_EQ(u.m_in_use, 0);
+   EXPECT_GT(u.m_n_slabs_unmapped, 0);
+
+   // Once the per-cpu caches are flushed only the keep budget stays mapped.
+   alloc.Trim();
+   alloc.GetUsage(u);
+   EXPECT_LE(u.m_mapped, cfg.m_keep_bytes);
+}
+
+// Allocate and release from many threads at once.
+TEST(PfcSlabAllocator, Concurrent)
+{
+   SlabAllocator::Config cfg;
+   cfg.m_keep_bytes = 16 * 1024 * 1024;
+   SlabAllocator alloc(cfg);
+
+   std::vector<std::thread> threads;
+   for (int t = 0; t < 8; ++t)
+   {
+      threads.emplace_back([&alloc, t]() {
+         std::vector<char*> bufs;
+         long long sz = (t % 2) ? 128 * 1024 : 1024 * 1024;
+         for (int r = 0; r < 200; ++r)
+         {
+            for (int i = 0; i < 8; ++i)
+            {
+               char *b = alloc.Allocate(sz);
+               if (b) { b[0] = t; b[sz - 1] = t; bufs.push_back(b); }
+            }
+            for (char *b : bufs)
+            {
+               if (b[0] != t || b[sz - 1] != t) abort();
+               alloc.Release(b, sz);
+            }
+            bufs.clear();
+         }
+      });
+   }
+   for (auto &t : threads) t.join();
+
+   SlabAllocator::Usage u;
+   alloc.GetUsage(u);
+   EXPECT_EQ(u.m_in_use, 0);
+   EXPECT_GT(u.m_in_use_hwm, 0);
+}
+
+// Compare against posix_memalign / free for block-sized requests.
+// Run with --gtest_also_run_disabled_tests.
+TEST(PfcSlabAllocator, DISABLED_Throughput)
+{
+   const int n_iter = 200000;
+
+   SlabAllocator::Config cfg;
+   cfg.m_keep_bytes = 64 * 1024 * 1024;
+   SlabAllocator alloc(cfg);
+
+   printf("%-10s %8s %8s %12s\n", "alloc", "size", "threads", "Mop/s");
+   for (long long sz : { 128ll * 1024, 1024ll * 1024 })
+   {
+      for (int mode = 0; mode < 2; ++mode)
+      {
+         for (int n_threads : { 1, 4, 8 })
+         {
+            auto worker = [&]() {
+               char *b[4];
+               for (int i = 0; i < n_iter; ++i)
+               {
+                  for (int k = 0; k < 4; ++k)
+                  {
+                     if (mode) b[k] = alloc.Allocate(sz);
+                     else if (posix_memalign((void**) &b[k], 4096, sz)) b[k] = 0;
+                     if (b[k]) b[k][0] = k;
+                  }
+                  for (int k = 0; k < 4; ++k)
+                  {
+                     if (mode) alloc.Release(b[k], sz);
+                     else      free(b[k]);
+                  }
+               }
+            };
+            std::vector<std::thread> threads;
+            auto start = std::chrono::steady_clock::now();
+            for (int t = 0; t < n_threads; ++t) threads.emplace_back(worker);
+            for (auto &t : threads) t.join();
+            std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+            printf("%-10s %8lld %8d %12.2f\n", mode ? "slab" : "memalign", sz >> 10, n_threads,
+                   4.0 * n_iter * n_threads / secs.count() / 1e6);
+         }
+      }
+   }
+
+   SlabAllocator::Usage u;
+   alloc.GetUsage(u);
+   printf("mapped hwm %lld, slabs mapped %lld unmapped %lld\n",
+          u.m_mapped_hwm, u.m_n_slabs_mapped, u.m_n_slabs_unmapped);
+}
@@ -0,0 +1,510 @@
+
+#include "XrdThrottle/XrdThrottleConfig.hh"
+#include "XrdThrottle/XrdThrottleShaper.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+#include "XrdOuc/XrdOucTrace.hh"
+
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <fstream>
+#include <list>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Records whether and how a deferred request was admitted.
+class TestRequest : public XrdThrottleShaper::Request {
+public:
+    void Admit(bool ok) override {
+        m_admitted = true;
+        m_ok = ok;
+        if (m_counter) (*m_counter)++;
+    }
+
+    bool m_admitted{false};
+    bool m_ok{false};
+    int *m_counter{nullptr};
+};
+
+// Records how an asynchronous request was completed.
+class TestAio : public XrdSfsAio {
+public:
+    void doneRead() override {m_reads++;}
+    void doneWrite() override {m_writes++;}
+    void Recycle() override {}
+
+    int m_reads{0};
+    int m_writes{0};
+};
+
+XrdThrottle::ClassConfig MakeClass(const std::string &name, const std::string &match,
+                                   long long weight = 1, long long data = -1,
+                                   const std::string &parent = "") {
+    XrdThrottle::ClassConfig klass;
+    klass.m_name = name;
+    klass.m_parent = parent;
+    if (!match.empty()) klass.m_match.push_back(match);
+    klass.m_weight = weight;
+    klass.m_data_rate = data;
+    return klass;
+}
+
+}
+
+class XrdThrottleShaperTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_logger = new XrdSysLogger(STDERR_FILENO, 0);
+        m_log = new XrdSysError(m_logger, "ThrottleTest");
+        m_trace = new XrdOucTrace(m_log);
+        // The dispatcher thread is never started; the tests drive the
+        // scheduler with explicit timestamps instead.
+        m_shaper = new XrdThrottleShaper(m_log, m_trace);
+        m_now = std::chrono::steady_clock::now();
+    }
+
+    void TearDown() override {
+        delete m_shaper;
+        delete m_trace;
+        delete m_log;
+        delete m_logger;
+    }
+
+    std::string CreateTempConfig(const std::string& content) {
+        char template_path[] = "/tmp/throttle_test_XXXXXX";
+        int fd = mkstemp(template_path);
+        if (fd < 0) {
+            return "";
+        }
+        close(fd);
+
+        std::ofstream file(template_path);
+        file << content;
+        file.close();
+
+        // The config stream only returns directives once the server has set
+        // the instance name; outside of a server it looks for "set" only.
+        setenv("XRDINSTANCE", "xrootd throttletest@localhost", 1);
+
+        return std::string(template_path);
+    }
+
+    XrdSysLogger* m_logger;
+    XrdSysError* m_log;
+    XrdOucTrace* m_trace;
+    XrdThrottleShaper* m_shaper;
+    XrdThrottleShaper::time_point m_now;
+};
+
+TEST_F(XrdThrottleShaperTests, InactiveWithoutLimits) {
+    EXPECT_FALSE(m_shaper->IsActive());
+    EXPECT_EQ(m_shaper->Attach("user1"), nullptr);
+
+    TestRequest req;
+    EXPECT_TRUE(m_shaper->Submit(nullptr, 1024*1024, 1, req));
+    EXPECT_FALSE(req.m_admitted);
+}
+
+TEST_F(XrdThrottleShaperTests, BurstThenRate) {
+    // 1000 bytes/s with a burst of 500 bytes.
+    m_shaper->SetRoot(1000, -1, 500, -1);
+    ASSERT_TRUE(m_shaper->IsActive());
+    auto flow = m_shaper->Attach("user1", m_now);
+    ASSERT_NE(flow, nullptr);
+
+    // The burst allows five 100-byte requests right away.
+    TestRequest reqs[8];
+    for (int idx = 0; idx < 5; idx++) {
+        EXPECT_TRUE(m_shaper->Submit(flow, 100, 1, reqs[idx], m_now)) << "request " << idx;
+    }
+    // The bucket is empty now; the next request is queued.
+    EXPECT_FALSE(m_shaper->Submit(flow, 100, 1, reqs[5], m_now));
+    EXPECT_FALSE(m_shaper->Submit(flow, 100, 1, reqs[6], m_now));
+    EXPECT_FALSE(reqs[5].m_admitted);
+
+    // After 50ms, 50 bytes worth of tokens are back; one request goes and
+    // takes the bucket into debt.
+    m_shaper->Dispatch(m_now + 50ms);
+    EXPECT_TRUE(reqs[5].m_admitted);
+    EXPECT_TRUE(reqs[5].m_ok);
+    EXPECT_FALSE(reqs[6].m_admitted);
+
+    // The debt of 50 bytes is paid back after another 50ms.
+    m_shaper->Dispatch(m_now + 99ms);
+    EXPECT_FALSE(reqs[6].m_admitted);
+    m_shaper->Dispatch(m_now + 101ms);
+    EXPECT_TRUE(reqs[6].m_admitted);
+
+    m_shaper->Detach(flow);
+}
+
+TEST_F(XrdThrottleShaperTests, LargeRequestGoesIntoDebt) {
+    m_shaper->SetRoot(1000, -1, 100, -1);
+    auto flow = m_shaper->Attach("user1", m_now);
+
+    // A request larger than the burst is never starved.
+    TestRequest big, next;
+    EXPECT_TRUE(m_shaper->Submit(flow, 5000, 1, big, m_now));
+    EXPECT_FALSE(m_shaper->Submit(flow, 1, 1, next, m_now));
+    m_shaper->Dispatch(m_now + 4800ms);
+    EXPECT_FALSE(next.m_admitted);
+    m_shaper->Dispatch(m_now + 5100ms);
+    EXPECT_TRUE(next.m_admitted);
+
+    m_shaper->Detach(flow);
+}
+
+TEST_F(XrdThrottleShaperTests, IOPSLimit) {
+    m_shaper->SetRoot(-1, 10, -1, 2);
+    auto flow = m_shaper->Attach("user1", m_now);
+
+    TestRequest reqs[3];
+    EXPECT_TRUE(m_shaper->Submit(flow, 1 << 20, 1, reqs[0], m_now));
+    EXPECT_TRUE(m_shaper->Submit(flow, 1 << 20, 1, reqs[1], m_now));
+    EXPECT_FALSE(m_shaper->Submit(flow, 1 << 20, 1, reqs[2], m_now));
+    m_shaper->Dispatch(m_now + 110ms);
+    EXPECT_TRUE(reqs[2].m_admitted);
+
+    m_shaper->Detach(flow);
+}
+
+TEST_F(XrdThrottleShaperTests, ClassMatching) {
+    std::vector<XrdThrottle::ClassConfig> classes;
+    classes.push_back(MakeClass("default", "*"));
+    classes.push_back(MakeClass("cms", "cms:*"));
+    classes.push_back(MakeClass("cmsprod", "cms:prod*", 1, -1, "cms"));
+    classes.push_back(MakeClass("alice", "alice"));
+    ASSERT_EQ(m_shaper->SetClasses(classes), 0);
+    EXPECT_TRUE(m_shaper->IsActive());
+
+    EXPECT_EQ(m_shaper->ClassOf("alice"), "alice");
+    EXPECT_EQ(m_shaper->ClassOf("alice2"), "default");
+    EXPECT_EQ(m_shaper->ClassOf("cms:user1"), "cms");
+    EXPECT_EQ(m_shaper->ClassOf("cms:production"), "cmsprod");
+    EXPECT_EQ(m_shaper->ClassOf("atlas:user1"), "default");
+}
+
+TEST_F(XrdThrottleShaperTests, UnmatchedUsersGoBelowRoot) {
+    std::vector<XrdThrottle::ClassConfig> classes;
+    classes.push_back(MakeClass("cms", "cms:*"));
+    ASSERT_EQ(m_shaper->SetClasses(classes), 0);
+    EXPECT_EQ(m_shaper->ClassOf("atlas:user1"), "");
+}
+
+TEST_F(XrdThrottleShaperTests, UndefinedParent) {
+    std::vector<XrdThrottle::ClassConfig> classes;
+    classes.push_back(MakeClass("cmsprod", "cms:prod*", 1, -1, "cms"));
+    EXPECT_NE(m_shaper->SetClasses(classes), 0);
+}
+
+TEST_F(XrdThrottleShaperTests, WeightedSharing) {
+    // Two classes share a 100KB/s root with weights 3:1.
+    m_shaper->SetRoot(100*1024, -1, 1024, -1);
+    std::vector<XrdThrottle::ClassConfig> classes;
+    classes.push_back(MakeClass("gold", "gold*", 3));
+    classes.push_back(MakeClass("bronze", "bronze*", 1));
+    ASSERT_EQ(m_shaper->SetClasses(classes), 0);
+
+    auto gold = m_shaper->Attach("gold1", m_now);
+    auto bronze = m_shaper->Attach("bronze1", m_now);
+
+    // Both keep a deep queue of 1KB requests.
+    int gold_done = 0, bronze_done = 0;
+    std::list<TestRequest> reqs;
+    for (int idx = 0; idx < 400; idx++) {
+        reqs.emplace_back();
+        reqs.back().m_counter = &gold_done;
+        if (m_shaper->Submit(gold, 1024, 1, reqs.back(), m_now)) reqs.back().Admit(true);
+        reqs.emplace_back();
+        reqs.back().m_counter = &bronze_done;
+        if (m_shaper->Submit(bronze, 1024, 1, reqs.back(), m_now)) reqs.back().Admit(true);
+    }
+
+    for (int ms = 10; ms <= 2000; ms += 10) {
+        m_shaper->Dispatch(m_now + std::chrono::milliseconds(ms));
+    }
+
+    // Roughly 200 requests fit in two seconds; they are split 3:1.
+    int total = gold_done + bronze_done;
+    EXPECT_GE(total, 195);
+    EXPECT_LE(total, 205);
+    EXPECT_NEAR(static_cast<double>(gold_done) / total, 0.75, 0.03);
+
+    // Expire the remaining requests so they do not outlive the test.
+    m_shaper->SetMaxWait(1s);
+    m_shaper->Dispatch(m_now + 10s);
+    for (auto &req : reqs) {
+        EXPECT_TRUE(req.m_admitted);
+    }
+    m_shaper->Detach(gold);
+    m_shaper->Detach(bronze);
+}
+
+TEST_F(XrdThrottleShaperTests, PerUserLimit) {
+    // The class itself is unlimited but each of its users gets 1000 bytes/s.
+    auto klass = MakeClass("users", "*");
+    klass.m_user_data_rate = 1000;
+    ASSERT_EQ(m_shaper->SetClasses({klass}), 0);
+
+    auto slow1 = m_shaper->Attach("user1", m_now);
+    auto slow2 = m_shaper->Attach("user1", m_now);
+    auto other = m_shaper->Attach("user2", m_now);
+
+    // Two files of the same user share the user's bucket...
+    TestRequest reqs[4];
+    EXPECT_TRUE(m_shaper->Submit(slow1, 2000, 1, reqs[0], m_now));
+    EXPECT_FALSE(m_shaper->Submit(slow2, 1000, 1, reqs[1], m_now));
+    // ...while another user is not affected.
+    EXPECT_TRUE(m_shaper->Submit(other, 1000, 1, reqs[2], m_now));
+
+    m_shaper->Dispatch(m_now + 900ms);
+    EXPECT_FALSE(reqs[1].m_admitted);
+    m_shaper->Dispatch(m_now + 1100ms);
+    EXPECT_TRUE(reqs[1].m_admitted);
+
+    m_shaper->Detach(slow1);
+    m_shaper->Detach(slow2);
+    m_shaper->Detach(other);
+}
+
+TEST_F(XrdThrottleShaperTests, PerFileLimit) {
+    auto klass = MakeClass("files", "*");
+    klass.m_file_data_rate = 1000;
+    ASSERT_EQ(m_shaper->SetClasses({klass}), 0);
+
+    auto file1 = m_shaper->Attach("user1", m_now);
+    auto file2 = m_shaper->Attach("user1", m_now);
+
+    TestRequest reqs[3];
+    EXPECT_TRUE(m_shaper->Submit(file1, 1000, 1, reqs[0], m_now));
+    EXPECT_FALSE(m_shaper->Submit(file1, 1000, 1, reqs[1], m_now));
+    EXPECT_TRUE(m_shaper->Submit(file2, 1000, 1, reqs[2], m_now));
+
+    m_shaper->Dispatch(m_now + 1001ms);
+    EXPECT_TRUE(reqs[1].m_admitted);
+
+    m_shaper->Detach(file1);
+    m_shaper->Detach(file2);
+}
+
+TEST_F(XrdThrottleShaperTests, ExpiredRequestsFail) {
+    m_shaper->SetRoot(100, -1, 100, -1);
+    m_shaper->SetMaxWait(2s);
+    auto flow = m_shaper->Attach("user1", m_now);
+
+    TestRequest first, second;
+    EXPECT_TRUE(m_shaper->Submit(flow, 10000, 1, first, m_now));
+    EXPECT_FALSE(m_shaper->Submit(flow, 100, 1, second, m_now));
+
+    m_shaper->Dispatch(m_now + 1s);
+    EXPECT_FALSE(second.m_admitted);
+    m_shaper->Dispatch(m_now + 3s);
+    EXPECT_TRUE(second.m_admitted);
+    EXPECT_FALSE(second.m_ok);
+
+    std::vector<XrdThrottleShaper::ClassStats> stats;
+    m_shaper->GetStats(stats, false, m_now + 3s);
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].m_name, "all");
+    EXPECT_EQ(stats[0].m_expired, 1);
+    EXPECT_EQ(stats[0].m_queued, 0u);
+
+    m_shaper->Detach(flow);
+}
+
+TEST_F(XrdThrottleShaperTests, NoExpiryByDefault) {
+    m_shaper->SetRoot(100, -1, 100, -1);
+    auto flow = m_shaper->Attach("user1", m_now);
+
+    TestRequest first, second;
+    EXPECT_TRUE(m_shaper->Submit(flow, 100000, 1, first, m_now));
+    EXPECT_FALSE(m_shaper->Submit(flow, 100, 1, second, m_now));
+
+    // Without a maximum queue time the request waits out the whole debt.
+    m_shaper->Dispatch(m_now + 60s);
+    EXPECT_FALSE(second.m_admitted);
+    m_shaper->Dispatch(m_now + 1001s);
+    EXPECT_TRUE(second.m_admitted);
+    EXPECT_TRUE(second.m_ok);
+
+    m_shaper->Detach(flow);
+}
+
+TEST_F(XrdThrottleShaperTests, UnlimitedFilesSkipTheQueue) {
+    // The root is unlimited; only the "slow" class has a limit.
+    auto slow = MakeClass("slow", "slow*", 1, 100);
+    auto fast = MakeClass("fast", "fast*");
+    ASSERT_EQ(m_shaper->SetClasses({slow, fast}), 0);
+    ASSERT_TRUE(m_shaper->IsActive());
+
+    auto limited = m_shaper->Attach("slow1", m_now);
+    auto unlimited = m_shaper->Attach("fast1", m_now);
+
+    TestRequest reqs[4];
+    EXPECT_TRUE(m_shaper->Submit(limited, 1000, 1, reqs[0], m_now));
+    EXPECT_FALSE(m_shaper->Submit(limited, 1000, 1, reqs[1], m_now));
+    EXPECT_TRUE(m_shaper->Submit(unlimited, 1 << 20, 1, reqs[2], m_now));
+    EXPECT_TRUE(m_shaper->Submit(unlimited, 1 << 20, 2, reqs[3], m_now));
+
+    // Requests that skipped the queue still show up in the statistics.
+    std::vector<XrdThrottleShaper::ClassStats> stats;
+    m_shaper->GetStats(stats, true, m_now);
+    ASSERT_EQ(stats.size(), 3u);
+    EXPECT_EQ(stats[0].m_bytes, 1000 + (2 << 20));
+    EXPECT_EQ(stats[0].m_ops, 4);
+    EXPECT_EQ(stats[0].m_queued, 1u);
+    EXPECT_EQ(stats[2].m_name, "fast");
+    EXPECT_EQ(stats[2].m_bytes, 2 << 20);
+    EXPECT_EQ(stats[2].m_ops, 3);
+    EXPECT_EQ(stats[2].m_deferred, 0);
+    EXPECT_EQ(stats[2].m_delay[0], 2u);
+    EXPECT_EQ(stats[1].m_bytes, 1000);
+
+    m_shaper->Dispatch(m_now + 20s);
+    EXPECT_TRUE(reqs[1].m_admitted);
+    m_shaper->Detach(limited);
+    m_shaper->Detach(unlimited);
+}
+
+TEST_F(XrdThrottleShaperTests, AioJob) {
+    m_shaper->SetRoot(100, -1, 100, -1);
+    m_shaper->SetMaxWait(2s);
+    auto flow = m_shaper->Attach("user1", m_now);
+
+    // Admitted right away: the caller runs the job, which completes the aio.
+    TestAio read_aio;
+    int runs = 0;
+    auto run = [&] {runs++; return ssize_t(100);};
+    auto job = new XrdThrottleShaper::AioJob(nullptr, &read_aio, true, run);
+    ASSERT_TRUE(m_shaper->Submit(flow, 10000, 1, *job, m_now));
+    job->DoIt();
+    EXPECT_EQ(runs, 1);
+    EXPECT_EQ(read_aio.Result, 100);
+    EXPECT_EQ(read_aio.m_reads, 1);
+
+    // Queued behind the debt for longer than the maximum: completed with
+    // EMFILE and not run.
+    TestAio write_aio;
+    job = new XrdThrottleShaper::AioJob(nullptr, &write_aio, false, run);
+    ASSERT_FALSE(m_shaper->Submit(flow, 100, 1, *job, m_now));
+    m_shaper->Dispatch(m_now + 3s);
+    EXPECT_EQ(runs, 1);
+    EXPECT_EQ(write_aio.Result, -EMFILE);
+    EXPECT_EQ(write_aio.m_writes, 1);
+    EXPECT_EQ(write_aio.m_reads, 0);
+
+    m_shaper->Detach(flow);
+}
+
+TEST_F(XrdThrottleShaperTests, MaxQueueDirective) {
+    for (const auto &entry : {std::make_pair("", -1LL),
+                              std::make_pair("throttle.max_queue_time 90\n", 90LL)}) {
+        std::string config_file = CreateTempConfig(entry.first);
+        ASSERT_FALSE(config_file.empty());
+        XrdThrottle::Configuration config(*m_log, nullptr);
+        ASSERT_EQ(config.Configure(config_file), 0);
+        unlink(config_file.c_str());
+        EXPECT_EQ(config.GetMaxQueue(), entry.second);
+        EXPECT_EQ(config.GetMaxWait(), 30);
+    }
+}
+
+TEST_F(XrdThrottleShaperTests, DetachWithQueuedRequests) {
+    m_shaper->SetRoot(1000, -1, 100, -1);
+    auto flow = m_shaper->Attach("user1", m_now);
+
+    TestRequest first, second;
+    EXPECT_TRUE(m_shaper->Submit(flow, 1000, 1, first, m_now));
+    EXPECT_FALSE(m_shaper->Submit(flow, 100, 1, second, m_now));
+
+    // The queued request is still served after the file went away.
+    m_shaper->Detach(flow);
+    m_shaper->Dispatch(m_now + 1001ms);
+    EXPECT_TRUE(second.m_admitted);
+    EXPECT_TRUE(second.m_ok);
+}
+
+TEST_F(XrdThrottleShaperTests, Histograms) {
+    m_shaper->SetRoot(1000, -1, 1000, -1);
+    ASSERT_EQ(m_shaper->SetClasses({MakeClass("cms", "cms:*")}), 0);
+    auto flow = m_shaper->Attach("cms:user1", m_now);
+
+    TestRequest reqs[2];
+    EXPECT_TRUE(m_shaper->Submit(flow, 1000, 1, reqs[0], m_now));
+    EXPECT_FALSE(m_shaper->Submit(flow, 500, 1, reqs[1], m_now));
+    // Admitted after 500ms: in the [256, 512) ms bin.
+    m_shaper->Dispatch(m_now + 501ms);
+    EXPECT_TRUE(reqs[1].m_admitted);
+
+    std::vector<XrdThrottleShaper::ClassStats> stats;
+    m_shaper->GetStats(stats, true, m_now + 1000ms);
+    ASSERT_EQ(stats.size(), 2u);
+    for (const auto &entry : stats) {
+        SCOPED_TRACE(entry.m_name);
+        EXPECT_EQ(entry.m_bytes, 1500);
+        EXPECT_EQ(entry.m_ops, 2);
+        EXPECT_EQ(entry.m_deferred, 1);
+        EXPECT_EQ(entry.m_delay[0], 1u);
+        EXPECT_EQ(entry.m_delay[9], 1u);
+        unsigned slots = 0;
+        for (auto count : entry.m_tput) slots += count;
+        EXPECT_EQ(slots, 10u);
+    }
+    EXPECT_EQ(stats[1].m_name, "cms");
+
+    // The counters start over after a reset.
+    m_shaper->GetStats(stats, false, m_now + 1000ms);
+    EXPECT_EQ(stats[1].m_bytes, 0);
+    EXPECT_EQ(stats[1].m_name, "cms");
+
+    m_shaper->Detach(flow);
+}
+
+TEST_F(XrdThrottleShaperTests, ClassDirective) {
+    std::string config_content = R"(
+throttle.throttle data 100m burst 10m
+throttle.class cms match cms:*,cmsuser weight 3 data 50m userdata 10m
+throttle.class cmsprod parent cms match cms:prod* iops 1000 fileiops 10
+)";
+    std::string config_file = CreateTempConfig(config_content);
+    ASSERT_FALSE(config_file.empty());
+
+    XrdThrottle::Configuration config(*m_log, nullptr);
+    ASSERT_EQ(config.Configure(config_file), 0);
+    unlink(config_file.c_str());
+
+    EXPECT_EQ(config.GetThrottleDataRate(), 100LL*1024*1024);
+    EXPECT_EQ(config.GetThrottleDataBurst(), 10LL*1024*1024);
+    EXPECT_EQ(config.GetThrottleIOPSBurst(), -1);
+
+    const auto &classes = config.GetClasses();
+    ASSERT_EQ(classes.size(), 2u);
+    EXPECT_EQ(classes[0].m_name, "cms");
+    EXPECT_EQ(classes[0].m_match, (std::vector<std::string>{"cms:*", "cmsuser"}));
+    EXPECT_EQ(classes[0].m_weight, 3);
+    EXPECT_EQ(classes[0].m_data_rate, 50LL*1024*1024);
+    EXPECT_EQ(classes[0].m_user_data_rate, 10LL*1024*1024);
+    EXPECT_EQ(classes[1].m_parent, "cms");
+    EXPECT_EQ(classes[1].m_iops_rate, 1000);
+    EXPECT_EQ(classes[1].m_file_iops_rate, 10);
+
+    ASSERT_EQ(m_shaper->SetClasses(classes), 0);
+    EXPECT_EQ(m_shaper->ClassOf("cmsuser"), "cms");
+    EXPECT_EQ(m_shaper->ClassOf("cms:prod1"), "cmsprod");
+}
+
+TEST_F(XrdThrottleShaperTests, ClassDirectiveErrors) {
+    for (const auto &content : {"throttle.class cmsprod parent cms\n",
+                                "throttle.class cms\nthrottle.class cms\n",
+                                "throttle.class bad/name\n"}) {
+        SCOPED_TRACE(content);
+        std::string config_file = CreateTempConfig(content);
+        ASSERT_FALSE(config_file.empty());
+        XrdThrottle::Configuration config(*m_log, nullptr);
+        EXPECT_NE(config.Configure(config_file), 0);
+        unlink(config_file.c_str());
+    }
+}
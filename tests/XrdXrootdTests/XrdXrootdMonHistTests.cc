@@ -0,0 +1,333 @@
+#include "XrdXrootd/XrdXrootdFileStats.hh"
+#include "XrdXrootd/XrdXrootdGStream.hh"
+#include "XrdXrootd/XrdXrootdMonHist.hh"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+class XrdSysError;
+
+// XrdXrootdMonHist.cc is compiled into this test on its own, so supply what
+// it needs from the rest of the server: the monitor's error object and a
+// g-stream whose Insert() captures the lines instead of sending them.
+//
+namespace XrdXrootdMonInfo
+{
+XrdSysError *eDest = 0;
+}
+
+namespace
+{
+std::vector<std::string> s_lines;
+int                      s_flushes = 0;
+}
+
+bool XrdXrootdGStream::Insert(const char *data, int dlen)
+{
+   EXPECT_GT(dlen, 0);
+   EXPECT_EQ(data[dlen-1], '\0');
+   s_lines.emplace_back(data, dlen-1);
+   return true;
+}
+
+void XrdXrootdGStream::Flush() {s_flushes++;}
+
+namespace
+{
+class CaptureStream : public XrdXrootdGStream
+{
+public:
+   // The real stream is never touched as Insert() and Flush() are ours
+   CaptureStream()
+      : XrdXrootdGStream(*reinterpret_cast<XrdXrootdGSReal *>(this)) {}
+  ~CaptureStream() {}
+};
+
+const int s_maxlen = 2048;
+
+// What a collector gets out of one record
+struct Bins
+{
+   unsigned long long ops = 0, seq = 0;
+   std::map<int, unsigned long long> sz, of;
+};
+
+struct Record
+{
+   kXR_unt32          fileid = 0;
+   unsigned char      flags  = 0;
+   unsigned long long fsize  = 0;
+   Bins               rd, wr;
+};
+
+struct Batch
+{
+   int         nrec = -1, len = -1;
+   std::string raw;
+};
+
+// Independent decoder for the format documented in XrdXrootdMonHist.hh
+//
+std::string FromB64(const std::string &in)
+{
+   static const std::string b64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                  "abcdefghijklmnopqrstuvwxyz0123456789+/";
+   std::string out;
+   unsigned int acc = 0;
+   int bits = 0;
+
+   EXPECT_EQ(in.size() % 4, 0u);
+   for (char c : in)
+      {if (c == '=') break;
+       size_t v = b64.find(c);
+       EXPECT_NE(v, std::string::npos) << "bad base64 char " << c;
+       acc = (acc << 6) | static_cast<unsigned int>(v);
+       bits += 6;
+       if (bits >= 8) {bits -= 8; out += static_cast<char>(acc >> bits);}
+      }
+   return out;
+}
+
+long JsonNum(const std::string &line, const std::string &key)
+{
+   size_t p = line.find("\"" + key + "\":");
+   if (p == std::string::npos) return -1;
+   return strtol(line.c_str() + p + key.size() + 3, 0, 10);
+}
+
+Batch Decode(const std::string &line)
+{
+   Batch b;
+   const std::string zkey = "\"zlib\":\"";
+
+   EXPECT_EQ(line.rfind("{\"event\":\"iohist\",\"v\":1,", 0), 0u) << line;
+   EXPECT_EQ(line.substr(line.size()-2), "\"}");
+   b.nrec = JsonNum(line, "nrec");
+   b.len  = JsonNum(line, "len");
+
+   size_t zp = line.find(zkey);
+   EXPECT_NE(zp, std::string::npos);
+   if (zp == std::string::npos || b.len <= 0) return b;
+   zp += zkey.size();
+   std::string zip = FromB64(line.substr(zp, line.size()-2-zp));
+
+   uLongf rlen = b.len;
+   b.raw.resize(b.len);
+   EXPECT_EQ(uncompress((Bytef *)&b.raw[0], &rlen, (const Bytef *)zip.data(),
+                        zip.size()), Z_OK);
+   EXPECT_EQ(rlen, static_cast<uLongf>(b.len));
+   return b;
+}
+
+unsigned long long GetVar(const std::string &s, size_t &p)
+{
+   unsigned long long val = 0;
+   int shift = 0;
+   unsigned char c;
+
+   do {EXPECT_LT(p, s.size()); if (p >= s.size()) return val;
+       c = s[p++];
+       val |= static_cast<unsigned long long>(c & 0x7f) << shift;
+       shift += 7;
+      } while(c & 0x80);
+   return val;
+}
+
+void GetBins(const std::string &s, size_t &p, Bins &b)
+{
+   b.ops = GetVar(s, p);
+   b.seq = GetVar(s, p);
+   for (auto *m : {&b.sz, &b.of})
+       {unsigned int mask = (static_cast<unsigned char>(s[p]) << 8)
+                          |  static_cast<unsigned char>(s[p+1]);
+        p += 2;
+        for (int i = 0; i < 16; i++)
+            if (mask & (1u << i)) (*m)[i] = GetVar(s, p);
+       }
+}
+
+std::vector<Record> Parse(const Batch &b)
+{
+   std::vector<Record> recs;
+   const std::string &s = b.raw;
+   size_t p = 0;
+
+   while(p < s.size())
+      {Record r;
+       memcpy(&r.fileid, s.data()+p, sizeof(r.fileid));
+       p += sizeof(r.fileid);
+       r.flags = s[p++];
+       r.fsize = GetVar(s, p);
+       if (r.flags & 0x01) GetBins(s, p, r.rd);
+       if (r.flags & 0x02) GetBins(s, p, r.wr);
+       recs.push_back(r);
+      }
+   EXPECT_EQ(p, s.size());
+   EXPECT_EQ(static_cast<int>(recs.size()), b.nrec);
+   return recs;
+}
+
+// Flushes the batch and returns all records sent since the last call
+std::vector<Record> Collect()
+{
+   std::vector<Record> recs;
+
+   XrdXrootdMonHist::Flush();
+   for (auto &line : s_lines)
+       {EXPECT_LE(static_cast<int>(line.size()) + 1, s_maxlen);
+        auto part = Parse(Decode(line));
+        recs.insert(recs.end(), part.begin(), part.end());
+       }
+   s_lines.clear();
+   return recs;
+}
+
+struct OpenFile
+{
+   XrdXrootdFileStats stats;
+   XrdXrootdMonHist   hist;
+
+   OpenFile(kXR_unt32 id, long long fsz)
+           {stats.FileID = id; stats.fSize = fsz; stats.Hist = &hist;}
+};
+
+class MonHistTest : public ::testing::Test
+{
+protected:
+   static void SetUpTestSuite()
+   {
+      static CaptureStream gs;
+      XrdXrootdMonHist::SetStream(&gs, s_maxlen);
+      ASSERT_TRUE(XrdXrootdMonHist::Init());
+   }
+
+   void SetUp() override {Collect();}
+};
+}
+
+// Reads and writes come back with the size and offset bins, request and
+// sequential counts they were recorded with.
+TEST_F(MonHistTest, RoundTrip)
+{
+   const long long fsz = 16 << 20;
+   OpenFile f1(0x01020304, fsz), f2(7, 0);
+
+   f1.stats.rdHist(0, 4096);             // size bin 2, offset bin 0
+   f1.stats.rdHist(4096, 4096);          // sequential
+   f1.stats.rdHist(fsz/2, 2 << 20);      // size bin 11, offset bin 8
+   f1.stats.rdHist(fsz+100, 1);          // size bin 0, beyond the end
+   f1.stats.wrHist(fsz-1024, 1024);      // size bin 0, offset bin 15
+   f2.stats.wrHist(0, 100 << 20);        // largest size bin, empty file
+
+   XrdXrootdMonHist::Report(&f1.stats);
+   XrdXrootdMonHist::Report(&f2.stats);
+   EXPECT_TRUE(s_lines.empty());         // Nothing is sent before a flush
+   auto recs = Collect();
+   ASSERT_EQ(recs.size(), 2u);
+
+   const Record &r1 = recs[0];
+   EXPECT_EQ(r1.fileid, 0x01020304u);
+   EXPECT_EQ(r1.flags, 0x03);
+   EXPECT_EQ(r1.fsize, static_cast<unsigned long long>(fsz));
+   EXPECT_EQ(r1.rd.ops, 4u);
+   EXPECT_EQ(r1.rd.seq, 2u);             // A read at 0 follows "nothing"
+   EXPECT_EQ(r1.rd.sz, (std::map<int, unsigned long long>{{0,1},{2,2},{11,1}}));
+   EXPECT_EQ(r1.rd.of, (std::map<int, unsigned long long>{{0,2},{8,1},{15,1}}));
+   EXPECT_EQ(r1.wr.ops, 1u);
+   EXPECT_EQ(r1.wr.seq, 0u);
+   EXPECT_EQ(r1.wr.sz, (std::map<int, unsigned long long>{{0,1}}));
+   EXPECT_EQ(r1.wr.of, (std::map<int, unsigned long long>{{15,1}}));
+
+   const Record &r2 = recs[1];
+   EXPECT_EQ(r2.fileid, 7u);
+   EXPECT_EQ(r2.flags, 0x02);
+   EXPECT_EQ(r2.fsize, 0u);
+   EXPECT_EQ(r2.wr.ops, 1u);
+   EXPECT_EQ(r2.wr.seq, 1u);
+   EXPECT_EQ(r2.wr.sz, (std::map<int, unsigned long long>{{15,1}}));
+   EXPECT_EQ(r2.wr.of, (std::map<int, unsigned long long>{{0,1}}));
+}
+
+// Each report only carries what changed since the previous one; an idle
+// file is skipped and a close without new I/O still yields a flags-only
+// record. Counts needing multi-byte varints survive the round trip.
+TEST_F(MonHistTest, Deltas)
+{
+   const long long fsz = 1LL << 40;
+   OpenFile f(42, fsz);
+
+   for (int i = 0; i < 20000; i++) f.stats.rdHist(1024LL*i, 1024);
+   XrdXrootdMonHist::Report(&f.stats);
+   auto recs = Collect();
+   ASSERT_EQ(recs.size(), 1u);
+   EXPECT_EQ(recs[0].fsize, static_cast<unsigned long long>(fsz));
+   EXPECT_EQ(recs[0].rd.ops, 20000u);
+   EXPECT_EQ(recs[0].rd.seq, 20000u);
+   EXPECT_EQ(recs[0].rd.sz, (std::map<int, unsigned long long>{{0,20000}}));
+
+   XrdXrootdMonHist::Report(&f.stats);
+   EXPECT_TRUE(Collect().empty());
+
+   f.stats.rdHist(fsz-4096, 4096);
+   XrdXrootdMonHist::Report(&f.stats);
+   recs = Collect();
+   ASSERT_EQ(recs.size(), 1u);
+   EXPECT_EQ(recs[0].flags, 0x01);
+   EXPECT_EQ(recs[0].rd.ops, 1u);
+   EXPECT_EQ(recs[0].rd.seq, 0u);
+   EXPECT_EQ(recs[0].rd.sz, (std::map<int, unsigned long long>{{2,1}}));
+   EXPECT_EQ(recs[0].rd.of, (std::map<int, unsigned long long>{{15,1}}));
+
+   XrdXrootdMonHist::Report(&f.stats, true);
+   recs = Collect();
+   ASSERT_EQ(recs.size(), 1u);
+   EXPECT_EQ(recs[0].fileid, 42u);
+   EXPECT_EQ(recs[0].flags, 0x04);
+
+   OpenFile idle(43, fsz);
+   XrdXrootdMonHist::Report(&idle.stats, true);
+   EXPECT_TRUE(Collect().empty());
+}
+
+// A batch that would overflow the g-stream buffer is sent before the next
+// record is added, so no line exceeds maxlen and no record is lost.
+TEST_F(MonHistTest, FullBatches)
+{
+   const int nFiles = 64;
+   std::vector<OpenFile *> files;
+
+   for (int i = 0; i < nFiles; i++)
+       {OpenFile *f = new OpenFile(1000+i, 1 << 30);
+        for (int b = 0; b < 16; b++)
+            for (int n = 0; n <= b*11 + i; n++)
+                {f->stats.rdHist((1LL << 26)*b + n, (1 << 10) << b);
+                 f->stats.wrHist((1LL << 26)*(15-b), (1 << 10) << b);
+                }
+        files.push_back(f);
+        XrdXrootdMonHist::Report(&f->stats, true);
+       }
+   EXPECT_GT(s_lines.size(), 1u);
+
+   auto recs = Collect();
+   ASSERT_EQ(recs.size(), static_cast<size_t>(nFiles));
+   for (int i = 0; i < nFiles; i++)
+       {const Record &r = recs[i];
+        EXPECT_EQ(r.fileid, static_cast<kXR_unt32>(1000+i));
+        EXPECT_EQ(r.flags, 0x07);
+        ASSERT_EQ(r.rd.sz.size(), 16u);
+        ASSERT_EQ(r.wr.of.size(), 16u);
+        for (int b = 0; b < 16; b++)
+            {EXPECT_EQ(r.rd.sz.at(b), static_cast<unsigned long long>(b*11+i+1));
+             EXPECT_EQ(r.rd.of.at(b), static_cast<unsigned long long>(b*11+i+1));
+             EXPECT_EQ(r.wr.of.at(15-b), static_cast<unsigned long long>(b*11+i+1));
+            }
+        delete files[i];
+       }
+   EXPECT_GT(s_flushes, 0);
+}